@@ -50,6 +50,20 @@ if defined SL_SDK_PATH (
     set "SL_LIB_FULL=!SL_SDK_PATH!\lib\x64\sl.interposer.lib"
 )
 
+:: Precompile shaders into headers (obj\shaders\*.h); fall back to runtime compilation without fxc
+set "SHADERS_OK=0"
+where fxc.exe >nul 2>nul
+if %ERRORLEVEL% EQU 0 (
+    call "shaders\compile_shaders.bat" "obj" && set "SHADERS_OK=1"
+)
+if "%SHADERS_OK%"=="1" (
+    echo Embedding precompiled shaders
+    set "INCLUDE_SWITCHES=%INCLUDE_SWITCHES% /I""obj"""
+    set "CL_COMPILE_FLAGS=%CL_COMPILE_FLAGS% /DDLSS_EMBEDDED_SHADERS=1"
+) else (
+    echo [WARN] fxc not available; shaders will be compiled at runtime from Data\F4SE\Plugins\shaders
+)
+
 echo Final INCLUDE_SWITCHES: %INCLUDE_SWITCHES%
 echo Compiling source files...
 set "SL_INC="
@@ -64,15 +78,36 @@ if %ERRORLEVEL% NEQ 0 goto error
 cl.exe %CL_COMPILE_FLAGS% %INCLUDE_SWITCHES% %SL_INC% /Fo"obj\ImGui_Menu.obj" "src\ImGui_Menu.cpp"
 if %ERRORLEVEL% NEQ 0 goto error
 
+cl.exe %CL_COMPILE_FLAGS% %INCLUDE_SWITCHES% %SL_INC% /Fo"obj\dlss_camera.obj" "dlss_camera.cpp"
+if %ERRORLEVEL% NEQ 0 goto error
+
+cl.exe %CL_COMPILE_FLAGS% %INCLUDE_SWITCHES% %SL_INC% /Fo"obj\dlss_capture.obj" "dlss_capture.cpp"
+if %ERRORLEVEL% NEQ 0 goto error
+
 cl.exe %CL_COMPILE_FLAGS% %INCLUDE_SWITCHES% %SL_INC% /Fo"obj\dlss_config.obj" "dlss_config.cpp"
 if %ERRORLEVEL% NEQ 0 goto error
 
 cl.exe %CL_COMPILE_FLAGS% %INCLUDE_SWITCHES% %SL_INC% /Fo"obj\dlss_hooks.obj" "dlss_hooks.cpp"
 if %ERRORLEVEL% NEQ 0 goto error
 
+cl.exe %CL_COMPILE_FLAGS% %INCLUDE_SWITCHES% %SL_INC% /Fo"obj\dlss_input.obj" "dlss_input.cpp"
+if %ERRORLEVEL% NEQ 0 goto error
+
 cl.exe %CL_COMPILE_FLAGS% %INCLUDE_SWITCHES% %SL_INC% /Fo"obj\dlss_manager.obj" "dlss_manager.cpp"
 if %ERRORLEVEL% NEQ 0 goto error
 
+cl.exe %CL_COMPILE_FLAGS% %INCLUDE_SWITCHES% %SL_INC% /Fo"obj\dlss_shaders.obj" "dlss_shaders.cpp"
+if %ERRORLEVEL% NEQ 0 goto error
+
+cl.exe %CL_COMPILE_FLAGS% %INCLUDE_SWITCHES% %SL_INC% /Fo"obj\dlss_tagging.obj" "dlss_tagging.cpp"
+if %ERRORLEVEL% NEQ 0 goto error
+
+cl.exe %CL_COMPILE_FLAGS% %INCLUDE_SWITCHES% %SL_INC% /Fo"obj\dlss_telemetry.obj" "dlss_telemetry.cpp"
+if %ERRORLEVEL% NEQ 0 goto error
+
+cl.exe %CL_COMPILE_FLAGS% %INCLUDE_SWITCHES% %SL_INC% /Fo"obj\dlss_vram.obj" "dlss_vram.cpp"
+if %ERRORLEVEL% NEQ 0 goto error
+
 if exist "src\backends\SLBackend.cpp" (
     cl.exe %CL_COMPILE_FLAGS% %INCLUDE_SWITCHES% %SL_INC% /Fo"obj\SLBackend.obj" "src\backends\SLBackend.cpp"
     if %ERRORLEVEL% NEQ 0 goto error
@@ -122,9 +157,16 @@ link.exe /DLL /OUT:"%OUTDIR%\F4SEVR_DLSS.dll" /DEF:"exports.def" %_NGX_LIBPATH%
     "obj\main.obj" ^
     "obj\F4SEVR_Upscaler.obj" ^
     "obj\ImGui_Menu.obj" ^
+    "obj\dlss_camera.obj" ^
+    "obj\dlss_capture.obj" ^
     "obj\dlss_config.obj" ^
     "obj\dlss_hooks.obj" ^
+    "obj\dlss_input.obj" ^
     "obj\dlss_manager.obj" ^
+    "obj\dlss_shaders.obj" ^
+    "obj\dlss_tagging.obj" ^
+    "obj\dlss_telemetry.obj" ^
+    "obj\dlss_vram.obj" ^
     "obj\SLBackend.obj" ^
     "obj\imgui.obj" ^
     "obj\imgui_draw.obj" ^
@@ -147,6 +189,14 @@ echo Copying INI alongside the DLL...
 copy /Y "F4SEVR_DLSS.ini" "%OUTDIR%\F4SEVR_DLSS.ini" >nul 2>&1
 echo.
 
+echo Building dlss_telemetry_reader.exe...
+cl.exe /nologo /O2 /EHsc /std:c++17 /I"." /Fo"obj\\" /Fe"%OUTDIR%\dlss_telemetry_reader.exe" "tools\telemetry_reader.cpp" "dlss_telemetry.cpp"
+if %ERRORLEVEL% NEQ 0 goto error
+echo Building dlss_capture_reader.exe...
+cl.exe /nologo /O2 /EHsc /std:c++17 /I"." /Fo"obj\\" /Fe"%OUTDIR%\dlss_capture_reader.exe" "tools\capture_reader.cpp" "dlss_capture.cpp"
+if %ERRORLEVEL% NEQ 0 goto error
+echo.
+
 :: Packaging for MO2 (plugin) and Root (runtime)
 set "DIST=dist"
 set "DIST_MO2=%DIST%\MO2\Data\F4SE\Plugins"
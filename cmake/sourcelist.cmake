@@ -2,9 +2,16 @@ set(sources
     src/main.cpp
     src/F4SEVR_Upscaler.cpp
     src/ImGui_Menu.cpp
+    dlss_camera.cpp
+    dlss_capture.cpp
     dlss_config.cpp
     dlss_hooks.cpp
+    dlss_input.cpp
     dlss_manager.cpp
+    dlss_shaders.cpp
+    dlss_tagging.cpp
+    dlss_telemetry.cpp
+    dlss_vram.cpp
     src/backends/SLBackend.cpp
     third_party/imgui/imgui.cpp
     third_party/imgui/imgui_draw.cpp
@@ -0,0 +1,251 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Allocation-free storage for the context hooks, which run thousands of
+// times per frame.
+//
+// FrameArena: a bump allocator for data that lives until the next Present.
+// Reset() drops everything at once. A frame that outgrows the block spills
+// into heap chunks, and the next Reset() grows the block to that frame's
+// peak, so a warm arena never touches the heap.
+//
+// FrameMap: an open-addressing hash map over FrameArena storage for the
+// per-frame keyed state of the pass graph and the redirect binding table.
+// Once the arena has been reset, the map reads as empty (checked lazily
+// against the arena's epoch), so the order of the Present-time resets does
+// not matter.
+//
+// InlineArray / InlineString: fixed-capacity buffers for hook-local data
+// (D3D11 caps a bind at 16 viewports and 8 RTVs).
+//
+// Single-threaded: one arena per thread that uses it (the hooks use one,
+// owned by the immediate context's thread). Platform-free.
+namespace DLSSArena {
+
+    struct Stats {
+        size_t capacity = 0;  // bytes in the block
+        size_t used = 0;      // bytes handed out this frame (spills included)
+        size_t peak = 0;      // largest frame so far
+        uint64_t spills = 0;  // allocations that did not fit the block
+        uint64_t grows = 0;   // Resets that grew the block
+    };
+
+    class FrameArena {
+    public:
+        explicit FrameArena(size_t initialBytes = 256 * 1024) : m_capacity(initialBytes) {
+            if (m_capacity) m_block.reset(new uint8_t[m_capacity]);
+        }
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        // Uninitialised, aligned; never nullptr for bytes > 0
+        void* Allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+            if (bytes == 0) bytes = 1;
+            const size_t offset = AlignUp(m_offset, align);
+            m_used += bytes + (offset - m_offset);
+            if (m_used > m_peak) m_peak = m_used;
+            if (offset + bytes <= m_capacity) {
+                m_offset = offset + bytes;
+                return m_block.get() + offset;
+            }
+            // Cold path: this frame outgrew the block
+            ++m_spills;
+            m_spilled.emplace_back(new uint8_t[bytes + align]);
+            return reinterpret_cast<void*>(AlignUp(reinterpret_cast<uintptr_t>(m_spilled.back().get()), align));
+        }
+
+        // Arrays of trivial types only: nothing is destroyed at Reset
+        template <typename T>
+        T* AllocateArray(size_t count) {
+            static_assert(std::is_trivially_destructible<T>::value, "arena memory is dropped without destructors");
+            return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        // Present: forget this frame's allocations
+        void Reset() {
+            if (!m_spilled.empty()) {
+                m_spilled.clear();
+                m_capacity = AlignUp(m_peak + m_peak / 4, 4096);
+                m_block.reset(new uint8_t[m_capacity]);
+                ++m_grows;
+            }
+            m_offset = 0;
+            m_used = 0;
+            ++m_epoch;
+        }
+
+        // Bumped by every Reset; FrameMap compares it to drop stale storage
+        uint64_t Epoch() const { return m_epoch; }
+
+        Stats GetStats() const {
+            Stats s;
+            s.capacity = m_capacity;
+            s.used = m_used;
+            s.peak = m_peak;
+            s.spills = m_spills;
+            s.grows = m_grows;
+            return s;
+        }
+
+    private:
+        static size_t AlignUp(size_t value, size_t align) { return (value + align - 1) & ~(align - 1); }
+
+        std::unique_ptr<uint8_t[]> m_block;
+        size_t m_capacity = 0;
+        size_t m_offset = 0;
+        size_t m_used = 0;
+        size_t m_peak = 0;
+        uint64_t m_epoch = 1;
+        uint64_t m_spills = 0;
+        uint64_t m_grows = 0;
+        std::vector<std::unique_ptr<uint8_t[]>> m_spilled;
+    };
+
+    // Integer keys, trivially copyable values
+    template <typename K, typename V>
+    class FrameMap {
+        static_assert(std::is_integral<K>::value, "FrameMap keys are integers (pointers as uintptr_t)");
+        static_assert(std::is_trivially_copyable<V>::value && std::is_trivially_destructible<V>::value, "FrameMap values live in arena memory");
+
+    public:
+        explicit FrameMap(FrameArena& arena) : m_arena(arena) {}
+        FrameMap(const FrameMap&) = delete;
+        FrameMap& operator=(const FrameMap&) = delete;
+
+        V* Find(K key) {
+            if (!Live() || m_count == 0) return nullptr;
+            for (uint32_t i = Home(key);; i = (i + 1) & (m_capacity - 1)) {
+                Slot& s = m_slots[i];
+                if (!s.used) return nullptr;
+                if (s.key == key) return &s.value;
+            }
+        }
+        const V* Find(K key) const { return const_cast<FrameMap*>(this)->Find(key); }
+
+        // Value for the key, inserted as 'init' when absent
+        V& FindOrInsert(K key, const V& init, bool* inserted = nullptr) {
+            if (!Live() || (m_count + 1) * 2 > m_capacity) Grow();
+            for (uint32_t i = Home(key);; i = (i + 1) & (m_capacity - 1)) {
+                Slot& s = m_slots[i];
+                if (s.used && s.key == key) {
+                    if (inserted) *inserted = false;
+                    return s.value;
+                }
+                if (!s.used) {
+                    s.used = true;
+                    s.key = key;
+                    s.value = init;
+                    ++m_count;
+                    if (inserted) *inserted = true;
+                    return s.value;
+                }
+            }
+        }
+
+        void Set(K key, const V& value) { FindOrInsert(key, value) = value; }
+
+        uint32_t Size() const { return Live() ? m_count : 0; }
+
+        // Storage stays in the arena until its Reset
+        void Clear() {
+            if (!Live()) return;
+            for (uint32_t i = 0; i < m_capacity; ++i) m_slots[i].used = false;
+            m_count = 0;
+        }
+
+    private:
+        struct Slot {
+            K key;
+            V value;
+            bool used;
+        };
+
+        static constexpr uint32_t kMinCapacity = 64;
+
+        bool Live() const { return m_slots && m_epoch == m_arena.Epoch(); }
+
+        uint32_t Home(K key) const {
+            uint64_t h = static_cast<uint64_t>(key);  // splitmix64 finaliser
+            h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+            h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+            h ^= h >> 31;
+            return static_cast<uint32_t>(h) & (m_capacity - 1);
+        }
+
+        // Doubles the table (or starts one after a Reset); the old slots
+        // stay behind in the arena until the frame ends
+        void Grow() {
+            const bool live = Live();
+            Slot* old = live ? m_slots : nullptr;
+            const uint32_t oldCapacity = live ? m_capacity : 0;
+            m_capacity = live ? m_capacity * 2 : kMinCapacity;
+            m_slots = m_arena.AllocateArray<Slot>(m_capacity);
+            for (uint32_t i = 0; i < m_capacity; ++i) m_slots[i].used = false;
+            m_epoch = m_arena.Epoch();
+            m_count = 0;
+            for (uint32_t i = 0; i < oldCapacity; ++i) {
+                if (old[i].used) FindOrInsert(old[i].key, old[i].value);
+            }
+        }
+
+        FrameArena& m_arena;
+        Slot* m_slots = nullptr;
+        uint32_t m_capacity = 0;
+        uint32_t m_count = 0;
+        uint64_t m_epoch = 0;
+    };
+
+    // Fixed-capacity array on the stack; Push fails instead of growing
+    template <typename T, uint32_t N>
+    class InlineArray {
+    public:
+        bool Push(const T& value) {
+            if (m_size >= N) return false;
+            m_items[m_size++] = value;
+            return true;
+        }
+        // Copies at most N items; false when 'count' did not fit
+        bool Assign(const T* items, uint32_t count) {
+            m_size = 0;
+            if (!items || count > N) return false;
+            for (uint32_t i = 0; i < count; ++i) m_items[i] = items[i];
+            m_size = count;
+            return true;
+        }
+        void Clear() { m_size = 0; }
+
+        T& operator[](uint32_t i) { return m_items[i]; }
+        const T& operator[](uint32_t i) const { return m_items[i]; }
+        T* Data() { return m_items; }
+        const T* Data() const { return m_items; }
+        uint32_t Size() const { return m_size; }
+        bool Empty() const { return m_size == 0; }
+        static constexpr uint32_t Capacity() { return N; }
+
+    private:
+        T m_items[N];
+        uint32_t m_size = 0;
+    };
+
+    // Fixed-capacity, always terminated text for log lines; truncates
+    template <uint32_t N>
+    class InlineString {
+    public:
+        void Append(const char* text) {
+            if (!text) return;
+            while (*text && m_length + 1 < N) m_text[m_length++] = *text++;
+            m_text[m_length] = '\0';
+        }
+        const char* CStr() const { return m_text; }
+        bool Empty() const { return m_length == 0; }
+
+    private:
+        char m_text[N] = {};
+        uint32_t m_length = 0;
+    };
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+
+// Optional stereo atlas output: both upscaled eyes side by side in one
+// texture (one allocation, one SRV/UAV pair, one target for the sharpening
+// pass), submitted once per eye with that eye's VRTextureBounds_t.
+//
+// The left eye sits at x = 0, the right eye after a small gutter that keeps
+// the compositor's bilinear taps at the seam inside the atlas padding and
+// the right region aligned to the sharpening groups. Platform-free.
+namespace DLSSAtlas {
+
+    constexpr uint32_t kGutter = 8;  // DLSSSharpen::kGroupSize
+
+    struct Rect {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        bool operator==(const Rect& o) const {
+            return x == o.x && y == o.y && width == o.width && height == o.height;
+        }
+    };
+
+    struct Layout {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        Rect eyes[2];
+
+        bool IsValid() const { return width > 0 && height > 0; }
+        bool operator==(const Layout& o) const {
+            return width == o.width && height == o.height && eyes[0] == o.eyes[0] && eyes[1] == o.eyes[1];
+        }
+        bool operator!=(const Layout& o) const { return !(*this == o); }
+    };
+
+    constexpr uint32_t AlignUp(uint32_t value, uint32_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Per-eye output sizes -> atlas; an empty layout when either eye is unknown
+    inline Layout MakeLayout(uint32_t leftWidth, uint32_t leftHeight, uint32_t rightWidth, uint32_t rightHeight) {
+        Layout l{};
+        if (leftWidth == 0 || leftHeight == 0 || rightWidth == 0 || rightHeight == 0) return l;
+        l.eyes[0] = Rect{0, 0, leftWidth, leftHeight};
+        l.eyes[1] = Rect{AlignUp(leftWidth + kGutter, kGutter), 0, rightWidth, rightHeight};
+        l.width = l.eyes[1].x + rightWidth;
+        l.height = leftHeight > rightHeight ? leftHeight : rightHeight;
+        return l;
+    }
+
+    // Field order of vr::VRTextureBounds_t
+    struct Bounds {
+        float uMin = 0.0f;
+        float vMin = 0.0f;
+        float uMax = 1.0f;
+        float vMax = 1.0f;
+    };
+
+    // Bounds of the eye's region in the atlas. 'inner' is what the game
+    // submitted for its own eye texture (sub-rect or flipped, nullptr =
+    // whole texture); it is mapped into the region unchanged.
+    inline Bounds EyeBounds(const Layout& layout, int eye, const Bounds* inner) {
+        Bounds b{};
+        if (!layout.IsValid() || (eye != 0 && eye != 1)) return b;
+        const Rect& r = layout.eyes[eye];
+        const Bounds in = inner ? *inner : Bounds{};
+        const float w = static_cast<float>(layout.width);
+        const float h = static_cast<float>(layout.height);
+        b.uMin = (static_cast<float>(r.x) + in.uMin * static_cast<float>(r.width)) / w;
+        b.uMax = (static_cast<float>(r.x) + in.uMax * static_cast<float>(r.width)) / w;
+        b.vMin = (static_cast<float>(r.y) + in.vMin * static_cast<float>(r.height)) / h;
+        b.vMax = (static_cast<float>(r.y) + in.vMax * static_cast<float>(r.height)) / h;
+        return b;
+    }
+
+    // Output-side cost of one frame in the current mode: resources the
+    // upscaled eyes live in and the binds that touch them
+    struct OutputStats {
+        bool atlas = false;
+        uint32_t textures = 0;  // output textures plus sharpening intermediates
+        uint32_t views = 0;     // SRVs/UAVs over them
+        uint64_t bytes = 0;     // their VRAM
+        uint32_t binds = 0;     // per frame: DLSS output tags plus sharpening SRV/UAV binds
+    };
+}
@@ -0,0 +1,77 @@
+#include "dlss_camera.h"
+#include "common/IDebugLog.h"
+
+#include "openvr.h"
+
+#include <windows.h>
+
+namespace DLSSCamera {
+
+    namespace {
+        using PFN_VR_GetGenericInterface = void* (VR_CALLTYPE*)(const char*, vr::EVRInitError*);
+
+        void* GetVRInterface(const char* version) {
+            HMODULE openVRModule = GetModuleHandleW(L"openvr_api.dll");
+            if (!openVRModule) {
+                return nullptr;
+            }
+            auto getIface = reinterpret_cast<PFN_VR_GetGenericInterface>(GetProcAddress(openVRModule, "VR_GetGenericInterface"));
+            if (!getIface) {
+                return nullptr;
+            }
+            vr::EVRInitError err = vr::VRInitError_None;
+            void* ptr = getIface(version, &err);
+            return (err == vr::VRInitError_None) ? ptr : nullptr;
+        }
+
+        Float4x4 ToRowVector(const vr::HmdMatrix34_t& m) {
+            return FromPose34(m.m);
+        }
+    }
+
+    bool RefreshFromOpenVR(CameraConstantsProvider& provider) {
+        // Interfaces are stable for the lifetime of the runtime; resolve once.
+        static vr::IVRSystem* s_system = nullptr;
+        static vr::IVRCompositor* s_compositor = nullptr;
+        if (!s_system) {
+            s_system = reinterpret_cast<vr::IVRSystem*>(GetVRInterface(vr::IVRSystem_Version));
+        }
+        if (!s_compositor) {
+            s_compositor = reinterpret_cast<vr::IVRCompositor*>(GetVRInterface(vr::IVRCompositor_Version));
+        }
+        if (!s_system) {
+            return false;
+        }
+
+        Float4x4 headToWorld = Identity();
+        bool havePose = false;
+        if (s_compositor) {
+            vr::TrackedDevicePose_t hmdPose{};
+            if (s_compositor->GetLastPoses(&hmdPose, 1, nullptr, 0) == vr::VRCompositorError_None &&
+                hmdPose.bPoseIsValid) {
+                headToWorld = ToRowVector(hmdPose.mDeviceToAbsoluteTracking);
+                havePose = true;
+            }
+        }
+
+        for (int eye = 0; eye < CameraConstantsProvider::kMaxEyes; ++eye) {
+            const vr::EVREye vrEye = (eye == 0) ? vr::Eye_Left : vr::Eye_Right;
+            EyeInputs in{};
+            s_system->GetProjectionRaw(vrEye, &in.tanLeft, &in.tanRight, &in.tanTop, &in.tanBottom);
+            in.eyeToHead = ToRowVector(s_system->GetEyeToHeadTransform(vrEye));
+            in.headToWorld = headToWorld;
+            in.havePose = havePose;
+            provider.SetEyeInputs(eye, in);
+        }
+
+        static bool s_loggedOnce = false;
+        if (!s_loggedOnce) {
+            s_loggedOnce = true;
+            float l = 0, r = 0, t = 0, b = 0;
+            s_system->GetProjectionRaw(vr::Eye_Left, &l, &r, &t, &b);
+            _MESSAGE("[Camera] OpenVR projection L eye tangents l=%.3f r=%.3f t=%.3f b=%.3f pose=%d",
+                l, r, t, b, havePose ? 1 : 0);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,380 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+
+// Camera constants for the upscaler: sub-pixel jitter sequence and per-eye
+// view/clip matrices. Everything in this header is plain math with no D3D or
+// OpenVR dependency; the OpenVR polling lives in dlss_camera.cpp.
+//
+// Matrix convention matches Streamline: row-major storage, row vectors
+// (clip = view * M), D3D clip space (depth 0..1, +Y up).
+namespace DLSSCamera {
+
+    // View space is in game units: near/far planes come from the config in
+    // units, and OpenVR's metre translations are scaled by kGameUnitsPerMeter
+    // before they are composed with the projection.
+    constexpr float kGameUnitsPerMeter = 70.0f;
+    constexpr float kDefaultNearZ = 10.0f;
+    constexpr float kDefaultFarZ = 100000.0f;
+
+    struct Float4x4 {
+        float m[4][4];
+    };
+
+    inline Float4x4 Identity() {
+        Float4x4 r{};
+        r.m[0][0] = r.m[1][1] = r.m[2][2] = r.m[3][3] = 1.0f;
+        return r;
+    }
+
+    inline Float4x4 Multiply(const Float4x4& a, const Float4x4& b) {
+        Float4x4 r{};
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                r.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] +
+                            a.m[i][2] * b.m[2][j] + a.m[i][3] * b.m[3][j];
+            }
+        }
+        return r;
+    }
+
+    inline Float4x4 Transpose(const Float4x4& a) {
+        Float4x4 r{};
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                r.m[i][j] = a.m[j][i];
+            }
+        }
+        return r;
+    }
+
+    // General 4x4 inverse (Gauss-Jordan with partial pivoting). Returns false
+    // and leaves 'out' as identity when the matrix is singular.
+    inline bool Inverse(const Float4x4& a, Float4x4& out) {
+        double w[4][8];
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                w[i][j] = a.m[i][j];
+                w[i][j + 4] = (i == j) ? 1.0 : 0.0;
+            }
+        }
+        for (int col = 0; col < 4; ++col) {
+            int pivot = col;
+            for (int r = col + 1; r < 4; ++r) {
+                if (std::fabs(w[r][col]) > std::fabs(w[pivot][col])) pivot = r;
+            }
+            if (std::fabs(w[pivot][col]) < 1e-12) {
+                out = Identity();
+                return false;
+            }
+            if (pivot != col) {
+                for (int j = 0; j < 8; ++j) {
+                    const double t = w[col][j]; w[col][j] = w[pivot][j]; w[pivot][j] = t;
+                }
+            }
+            const double inv = 1.0 / w[col][col];
+            for (int j = 0; j < 8; ++j) w[col][j] *= inv;
+            for (int r = 0; r < 4; ++r) {
+                if (r == col) continue;
+                const double f = w[r][col];
+                if (f == 0.0) continue;
+                for (int j = 0; j < 8; ++j) w[r][j] -= f * w[col][j];
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                out.m[i][j] = static_cast<float>(w[i][j + 4]);
+            }
+        }
+        return true;
+    }
+
+    // Radical inverse of 'index' in 'base'. Index 0 maps to 0, so sequences
+    // start at index 1.
+    inline float Halton(uint32_t index, uint32_t base) {
+        float f = 1.0f;
+        float r = 0.0f;
+        while (index > 0) {
+            f /= static_cast<float>(base);
+            r += f * static_cast<float>(index % base);
+            index /= base;
+        }
+        return r;
+    }
+
+    // Number of jitter phases before the sequence repeats. DLSS wants at least
+    // 8 samples per output pixel, i.e. 8 * (output/render)^2 phases.
+    inline uint32_t JitterPhaseCount(uint32_t renderW, uint32_t renderH, uint32_t outW, uint32_t outH) {
+        constexpr uint32_t kBasePhases = 8;
+        constexpr uint32_t kMaxPhases = 128;
+        if (renderW == 0 || renderH == 0 || outW == 0 || outH == 0) {
+            return kBasePhases;
+        }
+        const double sx = static_cast<double>(outW) / static_cast<double>(renderW);
+        const double sy = static_cast<double>(outH) / static_cast<double>(renderH);
+        const double phases = std::ceil(static_cast<double>(kBasePhases) * sx * sy - 1e-6);
+        if (phases < kBasePhases) return kBasePhases;
+        if (phases > kMaxPhases) return kMaxPhases;
+        return static_cast<uint32_t>(phases);
+    }
+
+    struct JitterSample {
+        float pixelX = 0.0f;   // render-pixel offset in [-0.5, 0.5)
+        float pixelY = 0.0f;
+        float clipX = 0.0f;    // same offset expressed in clip space (NDC units)
+        float clipY = 0.0f;
+    };
+
+    // Per-eye Halton(2,3) sequence. The phase count follows the current
+    // upscale ratio; a ratio change restarts the sequence.
+    class JitterSequence {
+    public:
+        JitterSample Next(uint32_t renderW, uint32_t renderH, uint32_t outW, uint32_t outH) {
+            const uint32_t phases = JitterPhaseCount(renderW, renderH, outW, outH);
+            if (phases != m_phaseCount) {
+                m_phaseCount = phases;
+                m_index = 0;
+            }
+            const uint32_t haltonIndex = (m_index % m_phaseCount) + 1;
+            m_index = (m_index + 1) % m_phaseCount;
+
+            JitterSample s{};
+            s.pixelX = Halton(haltonIndex, 2) - 0.5f;
+            s.pixelY = Halton(haltonIndex, 3) - 0.5f;
+            s.clipX = renderW ? (2.0f * s.pixelX / static_cast<float>(renderW)) : 0.0f;
+            s.clipY = renderH ? (-2.0f * s.pixelY / static_cast<float>(renderH)) : 0.0f;
+            m_last = s;
+            return s;
+        }
+
+        const JitterSample& Last() const { return m_last; }
+        uint32_t PhaseCount() const { return m_phaseCount; }
+        void Reset() { m_index = 0; m_last = {}; }
+
+    private:
+        uint32_t m_phaseCount = 0;
+        uint32_t m_index = 0;
+        JitterSample m_last{};
+    };
+
+    // Builds a row-vector perspective projection from OpenVR raw tangents
+    // (IVRSystem::GetProjectionRaw). Same layout OpenVR's GetProjectionMatrix
+    // produces for D3D, transposed for row vectors.
+    inline Float4x4 ProjectionFromTangents(float left, float right, float top, float bottom, float zNear, float zFar) {
+        Float4x4 p{};
+        const float idx = 1.0f / (right - left);
+        const float idy = 1.0f / (bottom - top);
+        const float idz = 1.0f / (zFar - zNear);
+        const float sx = right + left;
+        const float sy = bottom + top;
+        p.m[0][0] = 2.0f * idx;
+        p.m[1][1] = 2.0f * idy;
+        p.m[2][0] = sx * idx;
+        p.m[2][1] = sy * idy;
+        p.m[2][2] = -zFar * idz;
+        p.m[2][3] = -1.0f;
+        p.m[3][2] = -zFar * zNear * idz;
+        return p;
+    }
+
+    // Vertical field of view (radians) covered by OpenVR raw tangents.
+    inline float VerticalFovFromTangents(float top, float bottom) {
+        return std::atan(std::fabs(top)) + std::atan(std::fabs(bottom));
+    }
+
+    // Adds a clip-space offset to a projection so that every transformed
+    // point moves by (clipX, clipY) after the perspective divide.
+    inline void ApplyClipJitterRowVector(Float4x4& proj, float clipX, float clipY) {
+        for (int r = 0; r < 4; ++r) {
+            proj.m[r][0] += clipX * proj.m[r][3];
+            proj.m[r][1] += clipY * proj.m[r][3];
+        }
+    }
+
+    // Same as above for matrices stored for column vectors (clip = M * v).
+    inline void ApplyClipJitterColumnVector(Float4x4& proj, float clipX, float clipY) {
+        for (int c = 0; c < 4; ++c) {
+            proj.m[0][c] += clipX * proj.m[3][c];
+            proj.m[1][c] += clipY * proj.m[3][c];
+        }
+    }
+
+    // OpenVR 3x4 poses are row-major for column vectors with translation in
+    // the last column; this returns the equivalent 4x4 for row vectors.
+    inline Float4x4 FromPose34(const float pose[3][4]) {
+        Float4x4 r = Identity();
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                r.m[j][i] = pose[i][j];
+            }
+            r.m[3][i] = pose[i][3];
+        }
+        return r;
+    }
+
+    // Rigid transform with its translation scaled (OpenVR metres to game units)
+    inline Float4x4 ScaleTranslation(Float4x4 m, float scale) {
+        for (int i = 0; i < 3; ++i) m.m[3][i] *= scale;
+        return m;
+    }
+
+    struct EyeConstants {
+        Float4x4 viewToClip = Identity();
+        Float4x4 clipToView = Identity();
+        Float4x4 clipToPrevClip = Identity();
+        Float4x4 prevClipToClip = Identity();
+        float jitterX = 0.0f;          // pixel space, render resolution
+        float jitterY = 0.0f;
+        float nearZ = kDefaultNearZ;   // game units
+        float farZ = kDefaultFarZ;
+        float fovY = 1.0f;
+        float aspect = 1.0f;
+        float position[3] = {0.0f, 0.0f, 0.0f};  // game units, OpenVR tracking space
+        float right[3] = {1.0f, 0.0f, 0.0f};
+        float up[3] = {0.0f, 1.0f, 0.0f};
+        float forward[3] = {0.0f, 0.0f, -1.0f};
+        bool valid = false;            // false until real projection/pose data arrived
+    };
+
+    // Raw per-eye inputs, filled from OpenVR (or synthetic data in tests).
+    // Translations are in metres, as OpenVR reports them.
+    struct EyeInputs {
+        float tanLeft = -1.0f, tanRight = 1.0f, tanTop = -1.0f, tanBottom = 1.0f;
+        Float4x4 eyeToHead = Identity();
+        Float4x4 headToWorld = Identity();
+        bool havePose = false;
+    };
+
+    // Turns per-eye projection/pose inputs into the constants DLSS needs,
+    // tracking the previous frame's matrices for clipToPrevClip.
+    class CameraConstantsProvider {
+    public:
+        static constexpr int kMaxEyes = 2;
+
+        void SetClipPlanes(float zNear, float zFar) {
+            if (zNear > 0.0f && zFar > zNear) {
+                m_near = zNear;
+                m_far = zFar;
+            }
+        }
+
+        void SetJitterEnabled(bool enabled) { m_jitterEnabled = enabled; }
+        bool IsJitterEnabled() const { return m_jitterEnabled; }
+
+        // The jitter is only reported to DLSS once something actually offsets
+        // the game's projection with it; otherwise DLSS would chase a shift
+        // that never happened.
+        void SetJitterInjectionActive(bool active) { m_injectionActive = active; }
+        bool IsJitterInjectionActive() const { return m_injectionActive; }
+
+        void SetEyeInputs(int eye, const EyeInputs& inputs) {
+            if (eye < 0 || eye >= kMaxEyes) return;
+            m_inputs[eye] = inputs;
+            m_haveInputs[eye] = true;
+        }
+
+        // HMD pose of the eye's last inputs; false while tracking is invalid
+        bool GetHeadPose(int eye, Float4x4& headToWorld) const {
+            if (eye < 0 || eye >= kMaxEyes || !m_haveInputs[eye] || !m_inputs[eye].havePose) return false;
+            headToWorld = m_inputs[eye].headToWorld;
+            return true;
+        }
+
+        // Advances the jitter sequence for 'eye' and returns the clip-space
+        // offset the projection patcher should apply this frame.
+        JitterSample AdvanceJitter(int eye, uint32_t renderW, uint32_t renderH, uint32_t outW, uint32_t outH) {
+            if (eye < 0 || eye >= kMaxEyes || !m_jitterEnabled) {
+                return JitterSample{};
+            }
+            return m_jitter[eye].Next(renderW, renderH, outW, outH);
+        }
+
+        const JitterSample& CurrentJitter(int eye) const {
+            static const JitterSample kNone{};
+            if (eye < 0 || eye >= kMaxEyes || !m_jitterEnabled) return kNone;
+            return m_jitter[eye].Last();
+        }
+
+        // Builds the constants for one eye. Call once per eye per frame; the
+        // result becomes the "previous" frame for the next call.
+        EyeConstants Build(int eye, uint32_t renderW, uint32_t renderH, bool resetHistory) {
+            EyeConstants c{};
+            c.nearZ = m_near;
+            c.farZ = m_far;
+            c.aspect = (renderH > 0) ? static_cast<float>(renderW) / static_cast<float>(renderH) : 1.0f;
+            if (eye < 0 || eye >= kMaxEyes || !m_haveInputs[eye]) {
+                return c;
+            }
+
+            const EyeInputs& in = m_inputs[eye];
+            c.viewToClip = ProjectionFromTangents(in.tanLeft, in.tanRight, in.tanTop, in.tanBottom, m_near, m_far);
+            Inverse(c.viewToClip, c.clipToView);
+            c.fovY = VerticalFovFromTangents(in.tanTop, in.tanBottom);
+            const float spanY = in.tanBottom - in.tanTop;
+            if (std::fabs(spanY) > 1e-6f) {
+                c.aspect = (in.tanRight - in.tanLeft) / spanY;
+            }
+
+            const Float4x4 viewToWorld = Multiply(ScaleTranslation(in.eyeToHead, kGameUnitsPerMeter),
+                                                  ScaleTranslation(in.headToWorld, kGameUnitsPerMeter));
+            for (int i = 0; i < 3; ++i) {
+                c.right[i] = viewToWorld.m[0][i];
+                c.up[i] = viewToWorld.m[1][i];
+                c.forward[i] = -viewToWorld.m[2][i];
+                c.position[i] = viewToWorld.m[3][i];
+            }
+
+            History& h = m_history[eye];
+            if (in.havePose && h.valid && !resetHistory) {
+                // clipToPrevClip = clipToView * viewToWorld * worldToPrevView * prevViewToClip
+                Float4x4 worldToPrevView{};
+                if (Inverse(h.viewToWorld, worldToPrevView)) {
+                    const Float4x4 viewToPrevView = Multiply(viewToWorld, worldToPrevView);
+                    c.clipToPrevClip = Multiply(Multiply(c.clipToView, viewToPrevView), h.viewToClip);
+                    Inverse(c.clipToPrevClip, c.prevClipToClip);
+                }
+            }
+            h.viewToWorld = viewToWorld;
+            h.viewToClip = c.viewToClip;
+            h.valid = in.havePose;
+
+            if (m_jitterEnabled && m_injectionActive) {
+                const JitterSample& j = m_jitter[eye].Last();
+                c.jitterX = j.pixelX;
+                c.jitterY = j.pixelY;
+            }
+            c.valid = true;
+            return c;
+        }
+
+        void Reset() {
+            for (int i = 0; i < kMaxEyes; ++i) {
+                m_jitter[i].Reset();
+                m_history[i] = {};
+                m_haveInputs[i] = false;
+            }
+        }
+
+    private:
+        struct History {
+            Float4x4 viewToWorld = Identity();
+            Float4x4 viewToClip = Identity();
+            bool valid = false;
+        };
+
+        float m_near = kDefaultNearZ;
+        float m_far = kDefaultFarZ;
+        bool m_jitterEnabled = true;
+        bool m_injectionActive = false;
+        JitterSequence m_jitter[kMaxEyes];
+        EyeInputs m_inputs[kMaxEyes];
+        bool m_haveInputs[kMaxEyes]{};
+        History m_history[kMaxEyes];
+    };
+
+    // Polls OpenVR for the per-eye raw projection, eye-to-head transforms and
+    // the HMD render pose of the current frame. Returns false if OpenVR is not
+    // available yet. Implemented in dlss_camera.cpp.
+    bool RefreshFromOpenVR(CameraConstantsProvider& provider);
+}
@@ -0,0 +1,254 @@
+#include "dlss_capture.h"
+
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+#include <cstring>
+
+namespace DLSSCapture {
+
+    namespace {
+        constexpr size_t kMaxSpareBuffers = kMaxSurfaces * 2;
+
+        bool WriteChunk(std::FILE* file, uint32_t tag, const void* header, size_t headerBytes, const void* data, size_t dataBytes) {
+            const uint64_t total = static_cast<uint64_t>(headerBytes) + dataBytes;
+            if (total > 0xFFFFFFFFull) return false;
+            ChunkHeader chunk;
+            chunk.tag = tag;
+            chunk.bytes = static_cast<uint32_t>(total);
+            if (std::fwrite(&chunk, sizeof(chunk), 1, file) != 1) return false;
+            if (headerBytes && std::fwrite(header, headerBytes, 1, file) != 1) return false;
+            return dataBytes == 0 || std::fwrite(data, dataBytes, 1, file) == 1;
+        }
+
+        // 64-bit offsets: a surface chunk can pass 2 GB, and long is 32-bit on Windows
+        bool Skip(std::FILE* file, uint64_t bytes) {
+            if (bytes == 0) return true;
+#ifdef _WIN32
+            return _fseeki64(file, static_cast<__int64>(bytes), SEEK_CUR) == 0;
+#else
+            return fseeko(file, static_cast<off_t>(bytes), SEEK_CUR) == 0;
+#endif
+        }
+    }
+
+    bool WriteFileHeader(std::FILE* file) {
+        const FileHeader header;
+        return file && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+
+    bool WriteFrame(std::FILE* file, const Frame& frame) {
+        if (!file || frame.info.surfaceCount > kMaxSurfaces) return false;
+        if (!WriteChunk(file, kTagFrame, &frame.info, sizeof(FrameInfo), nullptr, 0)) return false;
+        for (uint32_t i = 0; i < frame.info.surfaceCount; ++i) {
+            const SurfaceInfo& s = frame.surfaces[i];
+            if (frame.pixels[i].size() != static_cast<size_t>(s.rowBytes) * s.height) return false;
+            if (!WriteChunk(file, kTagSurface, &s, sizeof(SurfaceInfo), frame.pixels[i].data(), frame.pixels[i].size())) return false;
+        }
+        return true;
+    }
+
+    // ---- Reader ----------------------------------------------------------
+
+    bool Reader::Open(const char* path) {
+        Close();
+        m_file = std::fopen(path, "rb");
+        if (!m_file) return false;
+        FileHeader header;
+        if (std::fread(&header, sizeof(header), 1, m_file) != 1 || header.magic != kMagic || header.version != kVersion ||
+            header.headerBytes < sizeof(FileHeader) || !Skip(m_file, header.headerBytes - sizeof(FileHeader))) {
+            Close();
+            return false;
+        }
+        m_version = header.version;
+        return true;
+    }
+
+    void Reader::Close() {
+        if (m_file) std::fclose(m_file);
+        m_file = nullptr;
+        m_version = 0;
+    }
+
+    bool Reader::Next(Frame& out, bool loadPixels) {
+        if (!m_file) return false;
+        ChunkHeader chunk;
+        // Find the next frame
+        for (;;) {
+            if (std::fread(&chunk, sizeof(chunk), 1, m_file) != 1) return false;
+            if (chunk.tag == kTagFrame && chunk.bytes >= sizeof(FrameInfo)) break;
+            if (!Skip(m_file, chunk.bytes)) return false;
+        }
+        out = Frame{};
+        if (std::fread(&out.info, sizeof(FrameInfo), 1, m_file) != 1 || !Skip(m_file, chunk.bytes - sizeof(FrameInfo))) return false;
+        const uint32_t count = out.info.surfaceCount < kMaxSurfaces ? out.info.surfaceCount : kMaxSurfaces;
+        uint32_t loaded = 0;
+        while (loaded < count) {
+            if (std::fread(&chunk, sizeof(chunk), 1, m_file) != 1) return false;
+            if (chunk.tag != kTagSurface || chunk.bytes < sizeof(SurfaceInfo)) {
+                if (!Skip(m_file, chunk.bytes)) return false;
+                continue;
+            }
+            SurfaceInfo& s = out.surfaces[loaded];
+            if (std::fread(&s, sizeof(SurfaceInfo), 1, m_file) != 1) return false;
+            const uint64_t pixels = chunk.bytes - sizeof(SurfaceInfo);
+            if (pixels != static_cast<uint64_t>(s.rowBytes) * s.height) return false;
+            if (loadPixels) {
+                out.pixels[loaded].resize(static_cast<size_t>(pixels));
+                if (pixels && std::fread(out.pixels[loaded].data(), static_cast<size_t>(pixels), 1, m_file) != 1) return false;
+            } else if (!Skip(m_file, pixels)) {
+                return false;
+            }
+            ++loaded;
+        }
+        out.info.surfaceCount = loaded;
+        return true;
+    }
+
+    // ---- Writer ----------------------------------------------------------
+
+    Writer::~Writer() {
+        Close();
+        if (m_worker.joinable()) m_worker.join();
+    }
+
+    bool Writer::Open(const std::string& path) {
+        Close();
+        if (m_worker.joinable()) m_worker.join();
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+        if (!WriteFileHeader(file)) {
+            std::fclose(file);
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_file = file;
+            m_open = true;
+            m_closing = false;
+            m_pendingDrops[0] = m_pendingDrops[1] = 0;
+            m_stats = Stats{};
+            m_stats.open = true;
+            m_stats.path = path;
+            m_stats.bytesWritten = sizeof(FileHeader);
+        }
+        m_worker = std::thread([this]() { WorkerLoop(); });
+        return true;
+    }
+
+    void Writer::Close() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_open) return;
+            m_open = false;
+            m_closing = true;
+        }
+        m_wake.notify_all();
+    }
+
+    bool Writer::IsOpen() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_open;
+    }
+
+    bool Writer::IsDraining() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_closing;
+    }
+
+    void Writer::SetLimits(uint32_t maxFrames, uint64_t maxBytes) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxFrames = maxFrames ? maxFrames : 1;
+        m_maxBytes = maxBytes;
+    }
+
+    bool Writer::Push(Frame&& frame) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_open) {
+                RecycleLocked(frame);
+                return false;
+            }
+            const uint64_t bytes = frame.Bytes();
+            // Drop oldest until the new frame fits (a frame alone over the
+            // byte limit is still queued, so something is always written)
+            while (!m_queue.empty() && (m_queue.size() >= m_maxFrames || m_stats.queuedBytes + bytes > m_maxBytes)) {
+                Frame& oldest = m_queue.front();
+                m_pendingDrops[oldest.info.eye & 1] += 1 + oldest.info.droppedBefore;
+                m_stats.queuedBytes -= oldest.Bytes();
+                ++m_stats.dropped;
+                RecycleLocked(oldest);
+                m_queue.pop_front();
+            }
+            m_stats.queuedBytes += bytes;
+            m_queue.push_back(std::move(frame));
+        }
+        m_wake.notify_one();
+        return true;
+    }
+
+    std::vector<uint8_t> Writer::TakeBuffer() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_spare.empty()) return std::vector<uint8_t>();
+        std::vector<uint8_t> buffer = std::move(m_spare.back());
+        m_spare.pop_back();
+        buffer.clear();
+        return buffer;
+    }
+
+    Stats Writer::GetStats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats stats = m_stats;
+        stats.open = m_open;
+        stats.queued = static_cast<uint32_t>(m_queue.size());
+        return stats;
+    }
+
+    void Writer::RecycleLocked(Frame& frame) {
+        for (std::vector<uint8_t>& pixels : frame.pixels) {
+            if (pixels.capacity() == 0 || m_spare.size() >= kMaxSpareBuffers) continue;
+            m_spare.push_back(std::move(pixels));
+        }
+    }
+
+    void Writer::WorkerLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        std::FILE* file = m_file;
+        for (;;) {
+            m_wake.wait(lock, [this]() { return m_closing || !m_queue.empty(); });
+            if (m_queue.empty()) break;  // closing and drained
+            Frame frame = std::move(m_queue.front());
+            m_queue.pop_front();
+            const uint64_t bytes = frame.Bytes();
+            m_stats.queuedBytes -= bytes;
+            uint32_t& drops = m_pendingDrops[frame.info.eye & 1];
+            frame.info.droppedBefore += drops;
+            drops = 0;
+
+            lock.unlock();
+            const bool ok = WriteFrame(file, frame);
+            lock.lock();
+
+            RecycleLocked(frame);
+            if (!ok) {
+                // Disk full or similar: stop accepting frames and discard the queue
+                m_stats.failed = true;
+                m_open = false;
+                for (Frame& f : m_queue) RecycleLocked(f);
+                m_queue.clear();
+                m_stats.queuedBytes = 0;
+                break;
+            }
+            ++m_stats.written;
+            m_stats.bytesWritten += bytes + sizeof(ChunkHeader) * (1 + frame.info.surfaceCount);
+        }
+        m_file = nullptr;
+        m_closing = false;
+        // Capture frames are large: do not hold their buffers between files
+        m_spare.clear();
+        m_spare.shrink_to_fit();
+        lock.unlock();
+        std::fclose(file);
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Frame dumps of the upscaler's inputs and outputs for offline analysis.
+//
+// File format (.dlsscap, little-endian): a FileHeader, then chunks of
+// {ChunkHeader, payload}. A kTagFrame chunk (FrameInfo) opens one eye's
+// frame and is followed by FrameInfo::surfaceCount kTagSurface chunks: a
+// SurfaceInfo, then 'height' rows of 'rowBytes' each in the texture's own
+// DXGI format, unpadded. Readers skip chunks with unknown tags; bump
+// kVersion when FrameInfo or SurfaceInfo change.
+//
+// Writer: the render thread pushes frames into a bounded queue and a worker
+// thread streams them to disk. Push never waits: past the queue's frame or
+// byte limit the oldest frames are dropped, and the next frame written
+// records how many went missing.
+//
+// Platform-free (C stdio, std::thread): dlss_capture.cpp is shared with
+// tools/capture_reader, which reads captures back on any OS.
+namespace DLSSCapture {
+
+    constexpr uint32_t kMagic = 0x43534C44;        // "DLSC"
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kTagFrame = 0x454D5246;     // "FRME"
+    constexpr uint32_t kTagSurface = 0x46525553;   // "SURF"
+    constexpr uint32_t kMaxSurfaces = 4;
+    constexpr const char* kExtension = ".dlsscap";
+
+    enum class Surface : uint32_t { Color = 0, Depth, MotionVectors, Output };
+
+    constexpr const char* SurfaceName(uint32_t surface) {
+        switch (static_cast<Surface>(surface)) {
+            case Surface::Color: return "color";
+            case Surface::Depth: return "depth";
+            case Surface::MotionVectors: return "motion";
+            case Surface::Output: return "output";
+            default: return "?";
+        }
+    }
+
+    struct FileHeader {
+        uint32_t magic = kMagic;
+        uint32_t version = kVersion;
+        uint32_t headerBytes = 16;  // sizeof(FileHeader); data starts here
+        uint32_t reserved = 0;
+    };
+    static_assert(sizeof(FileHeader) == 16, "FileHeader is written as is");
+
+    struct ChunkHeader {
+        uint32_t tag = 0;
+        uint32_t bytes = 0;  // payload that follows
+    };
+    static_assert(sizeof(ChunkHeader) == 8, "ChunkHeader is written as is");
+
+    // One eye of one frame
+    struct FrameInfo {
+        uint64_t frame = 0;          // Present count
+        double timeMs = 0.0;         // plugin clock at capture
+        uint32_t eye = 0;            // 0 left, 1 right
+        uint32_t quality = 0;        // the eye's DLSSManager::Quality
+        uint32_t reset = 0;          // history reset this frame
+        uint32_t resetReasons = 0;   // DLSSHistory::Reason bits of that reset
+        float jitterX = 0.0f;        // render pixels
+        float jitterY = 0.0f;
+        uint32_t renderWidth = 0;
+        uint32_t renderHeight = 0;
+        uint32_t outputWidth = 0;
+        uint32_t outputHeight = 0;
+        float processMs = 0.0f;      // eye timings at capture (smoothed)
+        float gpuMs = 0.0f;
+        float submitMs = 0.0f;
+        float sharpness = 0.0f;      // 0 when sharpening is off
+        uint32_t preset = 0;         // DLSS preset
+        uint32_t downscaleFilter = 0;  // DLSSDownscale::Filter
+        uint32_t surfaceCount = 0;
+        uint32_t droppedBefore = 0;  // frames of this eye lost since the previous one written
+    };
+    static_assert(sizeof(FrameInfo) == 88, "FrameInfo is written as is; bump kVersion when it changes");
+
+    struct SurfaceInfo {
+        uint64_t frame = 0;
+        uint32_t eye = 0;
+        uint32_t surface = 0;   // Surface
+        uint32_t format = 0;    // DXGI_FORMAT
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t rowBytes = 0;  // bytes of one row in the file
+    };
+    static_assert(sizeof(SurfaceInfo) == 32, "SurfaceInfo is written as is; bump kVersion when it changes");
+
+    struct Frame {
+        FrameInfo info;
+        SurfaceInfo surfaces[kMaxSurfaces];
+        std::vector<uint8_t> pixels[kMaxSurfaces];  // rowBytes * height each
+
+        uint64_t Bytes() const {
+            uint64_t total = sizeof(FrameInfo);
+            for (uint32_t i = 0; i < info.surfaceCount && i < kMaxSurfaces; ++i) total += sizeof(SurfaceInfo) + pixels[i].size();
+            return total;
+        }
+    };
+
+    // Serialisation, shared by the writer and the reader tool
+    bool WriteFileHeader(std::FILE* file);
+    bool WriteFrame(std::FILE* file, const Frame& frame);
+
+    // Sequential reader of a capture file
+    class Reader {
+    public:
+        ~Reader() { Close(); }
+        // False when the file is missing or not a capture of this version
+        bool Open(const char* path);
+        void Close();
+        // Next frame; surface pixels are skipped unless loadPixels. False at
+        // the end of the file or on a truncated or malformed chunk.
+        bool Next(Frame& out, bool loadPixels);
+        uint32_t Version() const { return m_version; }
+
+    private:
+        std::FILE* m_file = nullptr;
+        uint32_t m_version = 0;
+    };
+
+    struct Stats {
+        bool open = false;
+        uint32_t queued = 0;         // frames waiting for the worker
+        uint64_t queuedBytes = 0;
+        uint64_t written = 0;        // frames written, this file
+        uint64_t bytesWritten = 0;
+        uint64_t dropped = 0;        // frames dropped from the full queue, this file
+        bool failed = false;         // a write failed; the file was closed
+        std::string path;
+    };
+
+    class Writer {
+    public:
+        Writer(uint32_t maxFrames = 16, uint64_t maxBytes = 512ull << 20) : m_maxFrames(maxFrames), m_maxBytes(maxBytes) {}
+        ~Writer();  // drains the queue
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        // Creates the file and starts the worker. Waits for a previous
+        // file's worker to finish draining first.
+        bool Open(const std::string& path);
+        // The worker drains the queue and closes the file; returns at once
+        void Close();
+        bool IsOpen() const;
+        // A closed file's queue is still being written; Open would wait for it
+        bool IsDraining() const;
+        void SetLimits(uint32_t maxFrames, uint64_t maxBytes);
+
+        // Render thread. False when no file is open (the frame is discarded).
+        bool Push(Frame&& frame);
+        // An empty buffer, reusing the storage of frames already written
+        std::vector<uint8_t> TakeBuffer();
+
+        Stats GetStats() const;
+
+    private:
+        void WorkerLoop();
+        void RecycleLocked(Frame& frame);
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::thread m_worker;
+        std::FILE* m_file = nullptr;  // worker-owned while it runs
+        bool m_open = false;
+        bool m_closing = false;
+        std::deque<Frame> m_queue;
+        std::vector<std::vector<uint8_t>> m_spare;
+        uint32_t m_maxFrames;
+        uint64_t m_maxBytes;
+        uint32_t m_pendingDrops[2] = {};  // per eye, added to that eye's next written frame
+        Stats m_stats;
+    };
+}
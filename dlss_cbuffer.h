@@ -0,0 +1,264 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "dlss_camera.h"
+
+// Constant-buffer projection detection. The game uploads its camera cbuffer
+// through UpdateSubresource or Map/Unmap; we look for a perspective matrix in
+// the raw bytes, remember where it sits per buffer, and patch a copy of the
+// upload (never the game's own memory or a write-combined mapping).
+// No D3D dependency here; the hooks live in dlss_hooks.cpp.
+namespace DLSSCBuffer {
+
+    // How the 16 floats are laid out in memory.
+    //  RowVector:    clip = v * M, M stored row-major (w term in column 3).
+    //  ColumnVector: clip = M * v, M stored row-major (w term in row 3).
+    // An HLSL column_major float4x4 used as mul(M, v) looks like RowVector in
+    // memory, which is why both are accepted.
+    enum class MatrixLayout : uint8_t { RowVector = 0, ColumnVector = 1 };
+
+    namespace detail {
+        inline bool IsZero(float v) { return std::fabs(v) < 1e-6f; }
+        inline bool IsUnit(float v) { return std::fabs(std::fabs(v) - 1.0f) < 1e-4f; }
+        inline bool IsScale(float v) { return std::isfinite(v) && v > 0.05f && v < 100.0f; }
+        inline bool IsOffset(float v) { return std::isfinite(v) && std::fabs(v) < 4.0f; }
+    }
+
+    // Perspective signature (row-vector form, transposed for column-vector):
+    //   [ sx  0   0   0 ]
+    //   [ 0   sy  0   0 ]
+    //   [ ox  oy  a  +-1]
+    //   [ 0   0   b   0 ]
+    // ox/oy are the off-center terms OpenVR eyes always have.
+    inline bool LooksLikeProjection(const float* f, MatrixLayout& layout) {
+        using namespace detail;
+        auto at = [f](int r, int c, bool transpose) { return transpose ? f[c * 4 + r] : f[r * 4 + c]; };
+        for (int t = 0; t < 2; ++t) {
+            const bool tr = (t == 1);
+            if (!IsScale(at(0, 0, tr)) || !IsScale(at(1, 1, tr))) continue;
+            if (!IsZero(at(0, 1, tr)) || !IsZero(at(0, 2, tr)) || !IsZero(at(0, 3, tr))) continue;
+            if (!IsZero(at(1, 0, tr)) || !IsZero(at(1, 2, tr)) || !IsZero(at(1, 3, tr))) continue;
+            if (!IsOffset(at(2, 0, tr)) || !IsOffset(at(2, 1, tr))) continue;
+            if (!IsUnit(at(2, 3, tr))) continue;
+            if (!IsZero(at(3, 0, tr)) || !IsZero(at(3, 1, tr)) || !IsZero(at(3, 3, tr))) continue;
+            const float a = at(2, 2, tr);
+            const float b = at(3, 2, tr);
+            if (!std::isfinite(a) || !std::isfinite(b) || IsZero(b)) continue;
+            layout = tr ? MatrixLayout::ColumnVector : MatrixLayout::RowVector;
+            return true;
+        }
+        return false;
+    }
+
+    struct Match {
+        bool found = false;
+        uint32_t offset = 0;  // byte offset of the matrix inside the buffer
+        MatrixLayout layout = MatrixLayout::RowVector;
+    };
+
+    // Scans 16-byte aligned slots (HLSL packing puts float4x4 on a register
+    // boundary) for the first perspective matrix. 'bytesScanned' is advanced
+    // by the amount of data touched.
+    inline Match FindProjection(const void* data, size_t size, uint64_t& bytesScanned) {
+        Match m{};
+        if (!data || size < 64) return m;
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t off = 0; off + 64 <= size; off += 16) {
+            float f[16];
+            std::memcpy(f, bytes + off, sizeof(f));
+            MatrixLayout layout;
+            if (LooksLikeProjection(f, layout)) {
+                m.found = true;
+                m.offset = static_cast<uint32_t>(off);
+                m.layout = layout;
+                bytesScanned += off + 64;
+                return m;
+            }
+        }
+        bytesScanned += size;
+        return m;
+    }
+
+    // Horizontal off-center term of the projection. OpenVR's left eye sees
+    // more to the left (|tanLeft| > |tanRight|), so the term is negative for
+    // the left eye and positive for the right one. Returns -1 if symmetric.
+    inline int EyeFromProjection(const float* f, MatrixLayout layout) {
+        const float ox = (layout == MatrixLayout::RowVector) ? f[2 * 4 + 0] : f[0 * 4 + 2];
+        const float w = (layout == MatrixLayout::RowVector) ? f[2 * 4 + 3] : f[3 * 4 + 2];
+        // Left-handed projections (w = +z) flip the sign of ox.
+        const float signedOx = (w > 0.0f) ? -ox : ox;
+        if (std::fabs(signedOx) < 1e-4f) return -1;
+        return (signedOx < 0.0f) ? 0 : 1;
+    }
+
+    // Adds a clip-space jitter to the matrix at 'f' in place.
+    inline void ApplyJitter(float* f, MatrixLayout layout, float clipX, float clipY) {
+        DLSSCamera::Float4x4 m;
+        std::memcpy(m.m, f, sizeof(m.m));
+        if (layout == MatrixLayout::RowVector) {
+            DLSSCamera::ApplyClipJitterRowVector(m, clipX, clipY);
+        } else {
+            DLSSCamera::ApplyClipJitterColumnVector(m, clipX, clipY);
+        }
+        std::memcpy(f, m.m, sizeof(m.m));
+    }
+
+    // Per-buffer classification cache. Each buffer is scanned on its first
+    // few updates; once classified, later updates only re-check the cached
+    // slot. Buffers that never match are rejected and skipped for good.
+    class Classifier {
+    public:
+        enum class State : uint8_t { Unknown = 0, Camera, Rejected };
+
+        struct Entry {
+            State state = State::Unknown;
+            uint8_t attempts = 0;
+            MatrixLayout layout = MatrixLayout::RowVector;
+            uint32_t offset = 0;
+            uint32_t size = 0;
+        };
+
+        struct FrameStats {
+            uint64_t bytesScanned = 0;
+            uint32_t buffersClassified = 0;
+            uint32_t fastPathHits = 0;
+            uint32_t patchesApplied = 0;
+        };
+
+        static constexpr uint8_t kClassifyAttempts = 4;
+
+        // Returns a pointer to the projection inside 'data' (or nullptr) and
+        // its layout. 'key' identifies the buffer (its COM pointer).
+        float* Locate(uintptr_t key, void* data, size_t size, MatrixLayout& layout) {
+            if (!data || size < 64) return nullptr;
+            Entry& e = m_entries[key];
+            if (e.size != size) {
+                // New buffer at a recycled address or a resized upload
+                e = Entry{};
+                e.size = static_cast<uint32_t>(size);
+            }
+            switch (e.state) {
+                case State::Rejected:
+                    return nullptr;
+                case State::Camera: {
+                    float* f = reinterpret_cast<float*>(static_cast<uint8_t*>(data) + e.offset);
+                    MatrixLayout l;
+                    m_stats.bytesScanned += 64;
+                    if (e.offset + 64 <= size && LooksLikeProjection(f, l) && l == e.layout) {
+                        ++m_stats.fastPathHits;
+                        layout = l;
+                        return f;
+                    }
+                    // Layout moved (different pass sharing the buffer); rescan below
+                    e.state = State::Unknown;
+                    e.attempts = 0;
+                    break;
+                }
+                case State::Unknown:
+                    break;
+            }
+            const Match m = FindProjection(data, size, m_stats.bytesScanned);
+            if (m.found) {
+                e.state = State::Camera;
+                e.offset = m.offset;
+                e.layout = m.layout;
+                ++m_stats.buffersClassified;
+                layout = m.layout;
+                return reinterpret_cast<float*>(static_cast<uint8_t*>(data) + m.offset);
+            }
+            if (++e.attempts >= kClassifyAttempts) {
+                e.state = State::Rejected;
+            }
+            return nullptr;
+        }
+
+        // Buffers that never held a projection are not worth shadowing
+        bool IsRejected(uintptr_t key, size_t size) const {
+            const auto it = m_entries.find(key);
+            return it != m_entries.end() && it->second.size == size && it->second.state == State::Rejected;
+        }
+
+        void NotePatch() { ++m_stats.patchesApplied; }
+
+        // Returns last frame's counters and starts a new frame.
+        FrameStats EndFrame() {
+            const FrameStats s = m_stats;
+            m_stats = {};
+            return s;
+        }
+
+        const FrameStats& Current() const { return m_stats; }
+        size_t TrackedBuffers() const { return m_entries.size(); }
+        void Clear() { m_entries.clear(); m_stats = {}; }
+
+    private:
+        std::unordered_map<uintptr_t, Entry> m_entries;
+        FrameStats m_stats{};
+    };
+
+    // Shadows of mapped constant buffers. A WRITE_DISCARD mapping is
+    // write-combined memory that must not be read back, so while the patch
+    // is on the game writes into a cached shadow instead; at Unmap the shadow
+    // is patched and streamed to the real mapping in one sequential write.
+    // Discard leaves the whole buffer undefined, so the shadow (all of it)
+    // is the written range. Keyed by (context, buffer) since deferred
+    // contexts map on their own threads. Not synchronised: the hooks hold
+    // their cbuffer lock around every call.
+    class MapShadows {
+    public:
+        static constexpr size_t kMaxMapped = 8;
+
+        struct Slot {
+            uintptr_t context = 0;
+            uintptr_t buffer = 0;
+            void* mapped = nullptr;     // the driver's pointer
+            uint32_t size = 0;
+            std::vector<uint8_t> shadow;  // storage kept across maps
+        };
+
+        // Shadow to hand to the game in place of 'mapped', or nullptr when
+        // every slot is in use (the map then goes through unpatched)
+        void* Begin(uintptr_t context, uintptr_t buffer, void* mapped, uint32_t size) {
+            Slot* slot = Find(context, buffer);  // re-mapped without an Unmap
+            for (size_t i = 0; !slot && i < kMaxMapped; ++i) {
+                if (!m_slots[i].buffer) slot = &m_slots[i];
+            }
+            if (!slot) return nullptr;
+            slot->context = context;
+            slot->buffer = buffer;
+            slot->mapped = mapped;
+            slot->size = size;
+            if (slot->shadow.size() < size) slot->shadow.resize(size);
+            return slot->shadow.data();
+        }
+
+        Slot* Find(uintptr_t context, uintptr_t buffer) {
+            for (Slot& s : m_slots) {
+                if (s.buffer == buffer && s.context == context) return &s;
+            }
+            return nullptr;
+        }
+
+        // Copies the shadow to the real mapping and frees the slot
+        void End(Slot& slot) {
+            std::memcpy(slot.mapped, slot.shadow.data(), slot.size);
+            slot.context = slot.buffer = 0;
+            slot.mapped = nullptr;
+            slot.size = 0;
+        }
+
+        size_t OpenCount() const {
+            size_t n = 0;
+            for (const Slot& s : m_slots) n += s.buffer ? 1 : 0;
+            return n;
+        }
+
+    private:
+        Slot m_slots[kMaxMapped];
+    };
+}
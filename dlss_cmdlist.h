@@ -0,0 +1,284 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// Pre-recorded plugin passes. The per-eye downscale and sharpening passes
+// are the same draw/dispatch every frame until a resource, size or setting
+// changes, so they can be encoded once into a command list on a worker
+// thread (a D3D11 deferred context) and replayed on the game's immediate
+// context with a single ExecuteCommandList.
+//
+// One slot per pass. A slot's list is replayed only while the caller's Key
+// matches the one it was recorded for; on a miss the caller encodes the pass
+// directly that frame and submits a job, which the worker records for the
+// next frame. Invalidate drops a slot's list and discards recordings already
+// in flight (the list holds references to what it binds, so a stale list
+// would also keep released resources alive).
+//
+// Platform-free: lists and jobs are opaque pointers handled by a Recorder,
+// which dlss_manager.cpp implements over a deferred context and tests can
+// fake.
+namespace DLSSCmdList {
+
+    enum class Pass : uint8_t { DownscaleLeft = 0, DownscaleRight, SharpenLeft, SharpenRight };
+    constexpr uint32_t kPassCount = 4;
+
+    constexpr const char* PassName(Pass pass) {
+        switch (pass) {
+            case Pass::DownscaleLeft: return "Downscale L";
+            case Pass::DownscaleRight: return "Downscale R";
+            case Pass::SharpenLeft: return "Sharpen L";
+            case Pass::SharpenRight: return "Sharpen R";
+            default: return "?";
+        }
+    }
+
+    // Everything a recorded pass depends on; any difference means re-recording
+    struct Key {
+        const void* source = nullptr;  // texture (or view) read
+        const void* target = nullptr;  // texture (or view) written
+        uint32_t sourceFormat = 0;
+        uint32_t sourceWidth = 0;
+        uint32_t sourceHeight = 0;
+        uint32_t regionX = 0;          // area written in the target
+        uint32_t regionY = 0;
+        uint32_t regionWidth = 0;
+        uint32_t regionHeight = 0;
+        uint32_t variant = 0;          // shader permutation and path
+        float scalar = 0.0f;           // pass constant (sharpness)
+
+        bool operator==(const Key& o) const {
+            return source == o.source && target == o.target && sourceFormat == o.sourceFormat &&
+                   sourceWidth == o.sourceWidth && sourceHeight == o.sourceHeight &&
+                   regionX == o.regionX && regionY == o.regionY && regionWidth == o.regionWidth &&
+                   regionHeight == o.regionHeight && variant == o.variant && scalar == o.scalar;
+        }
+        bool operator!=(const Key& o) const { return !(*this == o); }
+    };
+
+    class Recorder {
+    public:
+        virtual ~Recorder() = default;
+        // Worker thread: encode the job, return the list (nullptr on failure).
+        // Takes ownership of the job either way.
+        virtual void* Record(Pass pass, void* job) = 0;
+        // A job that will not be recorded (replaced, invalidated or stopped)
+        virtual void DropJob(void* job) = 0;
+        // Render thread
+        virtual void Execute(void* list) = 0;
+        // Any thread
+        virtual void ReleaseList(void* list) = 0;
+    };
+
+    struct Stats {
+        uint64_t executed = 0;      // passes replayed from a list
+        uint64_t misses = 0;        // passes encoded directly (no list for the key)
+        uint64_t recorded = 0;      // lists recorded
+        uint64_t failed = 0;        // recordings that returned no list
+        uint64_t stale = 0;         // recordings discarded by an invalidation or a newer key
+        uint64_t invalidations = 0;
+        uint32_t ready = 0;         // slots holding a list now
+    };
+
+    class Cache {
+    public:
+        explicit Cache(Recorder& recorder) : m_recorder(recorder) {}
+        ~Cache() { Stop(); }
+        Cache(const Cache&) = delete;
+        Cache& operator=(const Cache&) = delete;
+
+        // Worker thread; without it, RecordPending records on the calling thread
+        void Start() {
+            if (m_worker.joinable()) return;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = false;
+            }
+            m_worker = std::thread([this]() { WorkerLoop(); });
+        }
+
+        // Joins the worker, then releases every list and queued job
+        void Stop() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            if (m_worker.joinable()) m_worker.join();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (Slot& s : m_slots) {
+                if (s.job) m_recorder.DropJob(s.job);
+                if (s.list) m_recorder.ReleaseList(s.list);
+                s.job = s.list = nullptr;
+                s.queued = false;
+            }
+        }
+
+        bool IsRunning() const { return m_worker.joinable(); }
+
+        // Render thread: replays the pass when a list recorded for exactly
+        // this key is ready. False: encode it directly (and Submit a job
+        // when NeedsJob says so).
+        bool Execute(Pass pass, const Key& key) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Slot& s = m_slots[Index(pass)];
+            if (s.list && s.listKey == key) {
+                m_recorder.Execute(s.list);  // under the lock: the worker cannot swap the list meanwhile
+                ++m_stats.executed;
+                return true;
+            }
+            ++m_stats.misses;
+            return false;
+        }
+
+        // Render thread, after a miss: false while a recording for this key
+        // is already queued or in flight
+        bool NeedsJob(Pass pass, const Key& key) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const Slot& s = m_slots[Index(pass)];
+            if (s.failed && s.failedKey == key && s.failedGeneration == s.generation) return false;  // no retry loop
+            return !((s.queued || s.inFlight) && s.jobKey == key && s.jobGeneration == s.generation);
+        }
+
+        // Render thread: queue a recording for the key; replaces a job not yet started
+        void Submit(Pass pass, const Key& key, void* job) {
+            if (!job) return;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                Slot& s = m_slots[Index(pass)];
+                if (s.job) {
+                    m_recorder.DropJob(s.job);
+                    ++m_stats.stale;
+                }
+                s.job = job;
+                s.jobKey = key;
+                s.jobGeneration = s.generation;
+                s.queued = true;
+            }
+            m_wake.notify_one();
+        }
+
+        // A resource the pass binds was released or recreated
+        void Invalidate(Pass pass) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            InvalidateLocked(m_slots[Index(pass)]);
+        }
+
+        void InvalidateAll() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (Slot& s : m_slots) InvalidateLocked(s);
+        }
+
+        // Records every queued job on the calling thread (no worker, tests)
+        void RecordPending() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (uint32_t i = 0; i < kPassCount; ++i) {
+                if (m_slots[i].queued) RecordLocked(lock, i);
+            }
+        }
+
+        Stats GetStats() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Stats stats = m_stats;
+            stats.ready = 0;
+            for (const Slot& s : m_slots) stats.ready += s.list ? 1u : 0u;
+            return stats;
+        }
+
+    private:
+        struct Slot {
+            uint32_t generation = 0;     // bumped by Invalidate
+            void* list = nullptr;
+            Key listKey;
+            void* job = nullptr;         // queued, not started
+            Key jobKey;
+            uint32_t jobGeneration = 0;
+            bool queued = false;
+            bool inFlight = false;
+            bool failed = false;         // the recording for failedKey returned no list
+            Key failedKey;
+            uint32_t failedGeneration = 0;
+        };
+
+        static uint32_t Index(Pass pass) {
+            const uint32_t i = static_cast<uint32_t>(pass);
+            return i < kPassCount ? i : 0;
+        }
+
+        void InvalidateLocked(Slot& s) {
+            ++s.generation;
+            if (s.list) {
+                m_recorder.ReleaseList(s.list);
+                s.list = nullptr;
+            }
+            if (s.job) {
+                m_recorder.DropJob(s.job);
+                s.job = nullptr;
+                s.queued = false;
+            }
+            ++m_stats.invalidations;
+        }
+
+        // Lock held on entry and exit; released while the recorder encodes
+        void RecordLocked(std::unique_lock<std::mutex>& lock, uint32_t index) {
+            Slot& s = m_slots[index];
+            void* job = s.job;
+            const Key key = s.jobKey;
+            const uint32_t generation = s.jobGeneration;
+            s.job = nullptr;
+            s.queued = false;
+            s.inFlight = true;
+
+            lock.unlock();
+            void* list = m_recorder.Record(static_cast<Pass>(index), job);
+            lock.lock();
+
+            s.inFlight = false;
+            if (!list) {
+                s.failed = true;
+                s.failedKey = key;
+                s.failedGeneration = generation;
+                ++m_stats.failed;
+                return;
+            }
+            if (generation != s.generation || (s.queued && s.jobKey != key)) {
+                // Invalidated while recording, or a newer key is already queued
+                m_recorder.ReleaseList(list);
+                ++m_stats.stale;
+                return;
+            }
+            if (s.list) m_recorder.ReleaseList(s.list);
+            s.list = list;
+            s.listKey = key;
+            ++m_stats.recorded;
+        }
+
+        void WorkerLoop() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;) {
+                m_wake.wait(lock, [this]() { return m_stop || AnyQueued(); });
+                if (m_stop) return;
+                for (uint32_t i = 0; i < kPassCount && !m_stop; ++i) {
+                    if (m_slots[i].queued) RecordLocked(lock, i);
+                }
+            }
+        }
+
+        bool AnyQueued() const {
+            for (const Slot& s : m_slots) {
+                if (s.queued) return true;
+            }
+            return false;
+        }
+
+        Recorder& m_recorder;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::thread m_worker;
+        bool m_stop = false;
+        Slot m_slots[kPassCount];
+        Stats m_stats;
+    };
+}
@@ -1,4 +1,7 @@
 #include "dlss_config.h"
+#include "dlss_input.h"
+#include "dlss_frametiming.h"
+#include "dlss_vram.h"
 #include "common/IDebugLog.h"
 #include <windows.h>
 #include <shlobj.h>
@@ -82,6 +85,34 @@ int NormalizeHotkeyValue(int value) {
 	}
 }
 
+// "Ctrl+Shift+0x47" -> chord; a bare key code is a chord without modifiers.
+// 0 (the action keeps its default key) when the value does not parse.
+int ParseHotkey(const std::string& value) {
+	DLSSInput::ChordText text;
+	if (!DLSSInput::SplitChord(value, text)) {
+		_MESSAGE("Hotkey \"%s\": unknown modifier \"%.*s\", using the default key", value.c_str(),
+			static_cast<int>(text.badToken.size()), text.badToken.data());
+		return 0;
+	}
+	const int vk = NormalizeHotkeyValue(ParseInt(std::string(text.key)));
+	if (vk > 0 && vk <= 0xFF) {
+		return DLSSInput::MakeChord(vk, text.mods);
+	}
+	if (vk != 0) {
+		_MESSAGE("Hotkey \"%s\": key code out of range, using the default key", value.c_str());
+	}
+	return 0;
+}
+
+std::string FormatHotkey(int chord) {
+	const uint32_t mods = DLSSInput::ChordMods(chord);
+	std::string out;
+	if (mods & DLSSInput::ModCtrl) out += "Ctrl+";
+	if (mods & DLSSInput::ModShift) out += "Shift+";
+	if (mods & DLSSInput::ModAlt) out += "Alt+";
+	return out + FormatVirtualKey(DLSSInput::ChordKey(chord));
+}
+
 }
 DLSSConfig::DLSSConfig() {
     _MESSAGE("DLSSConfig constructor");
@@ -173,11 +204,29 @@ void DLSSConfig::Load() {
     }
 
     ParseIniFile(configPath);
-    
+    DLSSVram::Global().SetBudgetBytes(static_cast<uint64_t>(vramBudgetMB) << 20);
+
     // Apply settings to DLSS Manager
     if (g_dlssManager) {
+        DLSSFrameTiming::Global().Note(DLSSFrameTiming::Event::ConfigApply);
         g_dlssManager->SetEnabled(enableUpscaler);
         g_dlssManager->SetQuality(quality);
+        g_dlssManager->SetEyeQuality(0, qualityLeft);
+        g_dlssManager->SetEyeQuality(1, qualityRight);
+        g_dlssManager->SetEyeRenderScale(0, renderScaleLeft);
+        g_dlssManager->SetEyeRenderScale(1, renderScaleRight);
+        g_dlssManager->SetStereoAtlas(stereoAtlasOutput);
+        g_dlssManager->SetDeferredPasses(deferredPasses);
+        g_dlssManager->SetReadbackProbes(readbackProbes);
+        g_dlssManager->SetPersistentTags(persistentSLTags);
+        g_dlssManager->SetCaptureDirectory(captureDirectory);
+        g_dlssManager->SetCaptureQueueBytes(static_cast<uint64_t>(captureQueueMB) << 20);
+        // A reload must not restart a capture that is running or already over
+        const uint64_t captureEnd = static_cast<uint64_t>(captureStartFrame) + static_cast<uint64_t>(captureFrameCount);
+        if (captureStartFrame > 0 && !g_dlssManager->IsCapturing() &&
+            (captureFrameCount == 0 || DLSSVram::Global().Frame() < captureEnd)) {
+            g_dlssManager->ScheduleCapture(static_cast<uint64_t>(captureStartFrame), static_cast<uint32_t>(captureFrameCount));
+        }
         g_dlssManager->SetSharpeningEnabled(enableSharpening);
         g_dlssManager->SetSharpness(sharpness);
         g_dlssManager->SetUseOptimalMipLodBias(useOptimalMipLodBias);
@@ -186,6 +235,8 @@ void DLSSConfig::Load() {
         g_dlssManager->SetUpscaleDepthForReShade(upscaleDepthForReShade);
         g_dlssManager->SetUseTAAPeriphery(useTAAForPeriphery);
         g_dlssManager->SetDLSSPreset(dlssPreset);
+        g_dlssManager->SetDownscaleFilter(static_cast<DLSSDownscale::Filter>(downscaleFilter));
+        g_dlssManager->SetDownscaleCompute(downscaleCompute);
         g_dlssManager->SetFOV(fov);
         g_dlssManager->SetFixedFoveatedRendering(enableFixedFoveatedRendering);
         g_dlssManager->SetFoveatedRadii(foveatedInnerRadius, foveatedMiddleRadius, foveatedOuterRadius);
@@ -196,6 +247,8 @@ void DLSSConfig::Load() {
         g_dlssManager->SetFoveatedWiden(foveatedWiden);
         g_dlssManager->SetTransformerModel(enableTransformerModel);
         g_dlssManager->SetRayReconstruction(enableRayReconstruction);
+        g_dlssManager->SetJitterEnabled(enableJitter);
+        g_dlssManager->SetCameraClipPlanes(cameraNearPlane, cameraFarPlane);
     }
 }
 
@@ -261,6 +314,16 @@ void DLSSConfig::ParseIniFile(const std::string& path) {
             } else if (normalizedKey == "quality" || normalizedKey == "qualitylevel") {
                 int q = ClampValue(ParseInt(value), 0, 5);
                 quality = static_cast<DLSSManager::Quality>(q);
+            } else if (normalizedKey == "qualityleft") {
+                qualityLeft = ClampValue(ParseInt(value), -1, 5);
+            } else if (normalizedKey == "qualityright") {
+                qualityRight = ClampValue(ParseInt(value), -1, 5);
+            } else if (normalizedKey == "renderscaleleft") {
+                const float s = ParseFloat(value);
+                renderScaleLeft = s > 0.0f ? ClampValue(s, 0.33f, 1.0f) : 0.0f;
+            } else if (normalizedKey == "renderscaleright") {
+                const float s = ParseFloat(value);
+                renderScaleRight = s > 0.0f ? ClampValue(s, 0.33f, 1.0f) : 0.0f;
             } else if (normalizedKey == "sharpening" || normalizedKey == "enablesharpening") {
                 enableSharpening = StringToBool(value);
             } else if (normalizedKey == "sharpness") {
@@ -282,16 +345,24 @@ void DLSSConfig::ParseIniFile(const std::string& path) {
                 foveatedRenderingEnabled = StringToBool(value);
             } else if (normalizedKey == "debugearlydlss") {
                 debugEarlyDlss = StringToBool(value);
+            } else if (normalizedKey == "earlydlsspassgraph") {
+                earlyDlssPassGraph = StringToBool(value);
             } else if (normalizedKey == "upscaledepthforreshade" || normalizedKey == "upscaledeptforreshade") {
                 upscaleDepthForReShade = StringToBool(value);
             } else if (normalizedKey == "usetaaforperiphery") {
                 useTAAForPeriphery = StringToBool(value);
             } else if (normalizedKey == "dlsspreset") {
                 dlssPreset = ClampValue(ParseInt(value), 0, 6);
+            } else if (normalizedKey == "downscalefilter") {
+                downscaleFilter = ClampValue(ParseInt(value), 0, static_cast<int>(DLSSDownscale::kFilterCount) - 1);
+            } else if (normalizedKey == "downscalecompute") {
+                downscaleCompute = StringToBool(value);
             } else if (normalizedKey == "fov") {
                 fov = ParseFloat(value);
             } else if (normalizedKey == "uiscale" || normalizedKey == "menuscale") {
                 uiScale = ClampValue(ParseFloat(value), 0.5f, 3.0f);
+            } else if (normalizedKey == "menuredrawrate") {
+                menuRedrawRate = ClampValue(ParseInt(value), 0, 240);
             }
         } else if (lowerSection == "dlss4" || lowerSection == "dlss") {
             if (normalizedKey == "enabletransformermodel") {
@@ -340,16 +411,52 @@ void DLSSConfig::ParseIniFile(const std::string& path) {
                 enableLowLatencyMode = StringToBool(value);
             } else if (normalizedKey == "enablereflex") {
                 enableReflex = StringToBool(value);
+            } else if (normalizedKey == "telemetrysharedmemory") {
+                telemetrySharedMemory = StringToBool(value);
+            } else if (normalizedKey == "vrambudgetmb") {
+                vramBudgetMB = ClampValue(ParseInt(value), 0, 65536);
+            } else if (normalizedKey == "stereoatlasoutput") {
+                stereoAtlasOutput = StringToBool(value);
+            } else if (normalizedKey == "deferredpasses") {
+                deferredPasses = StringToBool(value);
+            } else if (normalizedKey == "readbackprobes") {
+                readbackProbes = StringToBool(value);
+            } else if (normalizedKey == "persistentsltags") {
+                persistentSLTags = StringToBool(value);
+            }
+        } else if (lowerSection == "camera") {
+            if (normalizedKey == "enablejitter") {
+                enableJitter = StringToBool(value);
+            } else if (normalizedKey == "nearplane") {
+                cameraNearPlane = ClampValue(ParseFloat(value), 0.01f, 1000.0f);
+            } else if (normalizedKey == "farplane") {
+                cameraFarPlane = ClampValue(ParseFloat(value), 100.0f, 10000000.0f);
+            } else if (normalizedKey == "patchprojection") {
+                cameraPatchProjection = StringToBool(value);
+            }
+        } else if (lowerSection == "capture") {
+            if (normalizedKey == "directory") {
+                captureDirectory = value;
+            } else if (normalizedKey == "startframe") {
+                captureStartFrame = ClampValue(ParseInt(value), 0, 0x7FFFFFFF);
+            } else if (normalizedKey == "framecount") {
+                captureFrameCount = ClampValue(ParseInt(value), 0, 100000);
+            } else if (normalizedKey == "queuemb") {
+                captureQueueMB = ClampValue(ParseInt(value), 64, 16384);
             }
         } else if (lowerSection == "hotkeys") {
             if (normalizedKey == "togglemenu") {
-                toggleMenuKey = NormalizeHotkeyValue(ParseInt(value));
+                toggleMenuKey = ParseHotkey(value);
             } else if (normalizedKey == "toggleupscaler") {
-                toggleUpscalerKey = NormalizeHotkeyValue(ParseInt(value));
+                toggleUpscalerKey = ParseHotkey(value);
             } else if (normalizedKey == "cyclequality") {
-                cycleQualityKey = NormalizeHotkeyValue(ParseInt(value));
+                cycleQualityKey = ParseHotkey(value);
             } else if (normalizedKey == "cycleupscaler") {
-                cycleUpscalerKey = NormalizeHotkeyValue(ParseInt(value));
+                cycleUpscalerKey = ParseHotkey(value);
+            } else if (normalizedKey == "capture") {
+                captureKey = ParseHotkey(value);
+            } else if (normalizedKey == "debouncems") {
+                hotkeyDebounceMs = ClampValue(ParseInt(value), 0, 2000);
             }
         }
     }
@@ -385,6 +492,10 @@ void DLSSConfig::Save() {
     file << "EnableUpscaler = " << boolToString(enableUpscaler) << std::endl;
     file << "UpscalerType = " << static_cast<int>(upscalerType) << std::endl;
     file << "QualityLevel = " << static_cast<int>(quality) << std::endl;
+    file << "QualityLeft = " << qualityLeft << std::endl;
+    file << "QualityRight = " << qualityRight << std::endl;
+    file << "RenderScaleLeft = " << renderScaleLeft << std::endl;
+    file << "RenderScaleRight = " << renderScaleRight << std::endl;
     file << "Sharpening = " << boolToString(enableSharpening) << std::endl;
     file << "Sharpness = " << sharpness << std::endl;
     file << "UseOptimalMipLodBias = " << boolToString(useOptimalMipLodBias) << std::endl;
@@ -398,10 +509,15 @@ void DLSSConfig::Save() {
     file << "PeripheryTAAEnabled = " << boolToString(peripheryTAAEnabled) << std::endl;
     file << "FoveatedRenderingEnabled = " << boolToString(foveatedRenderingEnabled) << std::endl;
     file << "DebugEarlyDlss = " << boolToString(debugEarlyDlss) << std::endl;
+    file << "EarlyDlssPassGraph = " << boolToString(earlyDlssPassGraph) << std::endl;
     file << "DLSSPreset = " << dlssPreset << std::endl;
+    file << "DownscaleFilter = " << downscaleFilter << std::endl;
+    file << "DownscaleCompute = " << boolToString(downscaleCompute) << std::endl;
     file << "FOV = " << fov << std::endl << std::endl;
     file << "; UI scale for ImGui menu (0.5 - 3.0). 1.5 is good for VR" << std::endl;
-    file << "UIScale = " << uiScale << std::endl << std::endl;
+    file << "UIScale = " << uiScale << std::endl;
+    file << "; Menu rebuilds per second while open (0 = every frame); the hidden menu costs nothing" << std::endl;
+    file << "MenuRedrawRate = " << menuRedrawRate << std::endl << std::endl;
 
     file << "[DLSS4]" << std::endl;
     file << "EnableTransformerModel = " << boolToString(enableTransformerModel) << std::endl;
@@ -424,14 +540,46 @@ void DLSSConfig::Save() {
 
     file << "[Performance]" << std::endl;
     file << "EnableLowLatencyMode = " << boolToString(enableLowLatencyMode) << std::endl;
-    file << "EnableReflex = " << boolToString(enableReflex) << std::endl << std::endl;
+    file << "EnableReflex = " << boolToString(enableReflex) << std::endl;
+    file << "; Live stats in shared memory for dlss_telemetry_reader (read on the same machine)" << std::endl;
+    file << "TelemetrySharedMemory = " << boolToString(telemetrySharedMemory) << std::endl;
+    file << "; Budget for the plugin's own textures and buffers in MB; above it idle caches are released (0 = off)" << std::endl;
+    file << "VramBudgetMB = " << vramBudgetMB << std::endl;
+    file << "; Streamline: both eyes in one output texture, submitted to the compositor with per-eye bounds" << std::endl;
+    file << "StereoAtlasOutput = " << boolToString(stereoAtlasOutput) << std::endl;
+    file << "; Record the per-eye downscale and sharpening passes on a worker thread and replay them as command lists" << std::endl;
+    file << "DeferredPasses = " << boolToString(deferredPasses) << std::endl;
+    file << "; Reduce each eye's output and motion vectors to min/max/mean/NaN count on the GPU, read back a few frames late" << std::endl;
+    file << "ReadbackProbes = " << boolToString(readbackProbes) << std::endl;
+    file << "; Streamline: keep resource tags across frames, rebuilding only changed ones (false = every frame; compare per-eye submit time)" << std::endl;
+    file << "PersistentSLTags = " << boolToString(persistentSLTags) << std::endl << std::endl;
+
+    file << "[Camera]" << std::endl;
+    file << "EnableJitter = " << boolToString(enableJitter) << std::endl;
+    file << "NearPlane = " << cameraNearPlane << std::endl;
+    file << "FarPlane = " << cameraFarPlane << std::endl;
+    file << "PatchProjection = " << boolToString(cameraPatchProjection) << std::endl << std::endl;
+
+    file << "[Capture]" << std::endl;
+    file << "; Frame dumps of each eye's color, depth, motion vectors and output for dlss_capture_reader" << std::endl;
+    file << "; Relative directories are created next to this file" << std::endl;
+    file << "Directory = " << captureDirectory << std::endl;
+    file << "; Present count of the first captured frame (0 = start with the Capture hotkey only)" << std::endl;
+    file << "StartFrame = " << captureStartFrame << std::endl;
+    file << "; Frames per capture (0 = until the hotkey stops it)" << std::endl;
+    file << "FrameCount = " << captureFrameCount << std::endl;
+    file << "; Memory for frames waiting to be written; when it is full the oldest are dropped" << std::endl;
+    file << "QueueMB = " << captureQueueMB << std::endl << std::endl;
 
     file << "[Hotkeys]" << std::endl;
-    file << "; Virtual-key codes. See: https://learn.microsoft.com/windows/win32/inputdev/virtual-key-codes" << std::endl;
-    file << "ToggleMenu = " << FormatVirtualKey(toggleMenuKey) << std::endl;
-    file << "ToggleUpscaler = " << FormatVirtualKey(toggleUpscalerKey) << std::endl;
-    file << "CycleQuality = " << FormatVirtualKey(cycleQualityKey) << std::endl;
-    file << "CycleUpscaler = " << FormatVirtualKey(cycleUpscalerKey) << std::endl;
+    file << "; Virtual-key codes, optionally prefixed with Ctrl+, Shift+ and/or Alt+ (e.g. Ctrl+0x47)." << std::endl;
+    file << "; See: https://learn.microsoft.com/windows/win32/inputdev/virtual-key-codes" << std::endl;
+    file << "ToggleMenu = " << FormatHotkey(toggleMenuKey) << std::endl;
+    file << "ToggleUpscaler = " << FormatHotkey(toggleUpscalerKey) << std::endl;
+    file << "CycleQuality = " << FormatHotkey(cycleQualityKey) << std::endl;
+    file << "CycleUpscaler = " << FormatHotkey(cycleUpscalerKey) << std::endl;
+    file << "Capture = " << FormatHotkey(captureKey) << std::endl;
+    file << "DebounceMs = " << hotkeyDebounceMs << std::endl;
 
     file.close();
     _MESSAGE("Config saved to: %s", configPath.c_str());
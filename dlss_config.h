@@ -30,6 +30,11 @@ public:
     bool enableUpscaler = true;
     UpscalerType upscalerType = UpscalerType::DLSS;
     DLSSManager::Quality quality = DLSSManager::Quality::Quality;
+    // Per-eye overrides: quality -1 follows QualityLevel, render scale 0 uses the quality's scale
+    int qualityLeft = -1;
+    int qualityRight = -1;
+    float renderScaleLeft = 0.0f;
+    float renderScaleRight = 0.0f;
     bool enableSharpening = true;
     float sharpness = 0.8f;
     bool useOptimalMipLodBias = true;
@@ -38,12 +43,16 @@ public:
     bool upscaleDepthForReShade = false;
     bool useTAAForPeriphery = false;
     int dlssPreset = 4;
+    int downscaleFilter = 2;  // eye color -> render size: 0=box, 1=bilinear, 2=catmull-rom, 3=lanczos
+    bool downscaleCompute = false;  // tiled compute shader instead of the fullscreen pass
     float fov = 90.0f;
 
     // UI
     // Global scale for ImGui menu in VR; 1.0 = default size
     // Typical comfortable range in VR is 1.2–2.0
     float uiScale = 1.5f;
+    // Upper bound on menu rebuilds per second while it is open (0 = every frame)
+    int menuRedrawRate = 30;
 
     // DLSS 4 specific (without frame generation)
     bool enableTransformerModel = true;  // New DLSS 4 transformer model
@@ -65,12 +74,32 @@ public:
     // Performance settings
     bool enableLowLatencyMode = true;
     bool enableReflex = false;  // NVIDIA Reflex
+    bool telemetrySharedMemory = true;  // Publish live stats for tools/telemetry_reader
+    int vramBudgetMB = 0;  // Plugin allocations above this trim idle caches (0 = no budget)
+    bool stereoAtlasOutput = false;  // Both upscaled eyes in one texture, submitted with per-eye bounds (Streamline)
+    bool deferredPasses = false;  // Record downscale/sharpening into command lists on a worker thread
+    bool readbackProbes = false;  // Min/max/mean/NaN probes of each eye's output and motion vectors (GPU readback)
+    bool persistentSLTags = true;  // Keep Streamline resource tags across frames (off: rebuild every frame, for A/B timing)
 
-    // Hotkeys (Windows virtual-key codes)
+    // Camera constants for DLSS (jitter + clip planes, game units)
+    bool enableJitter = true;
+    float cameraNearPlane = DLSSCamera::kDefaultNearZ;
+    float cameraFarPlane = DLSSCamera::kDefaultFarZ;
+    bool cameraPatchProjection = false;  // Apply jitter to the game's projection cbuffer (experimental)
+
+    // Frame capture for tools/capture_reader (relative directories sit next to the Documents INI)
+    std::string captureDirectory = "F4SEVR_DLSS_Captures";
+    int captureStartFrame = 0;   // Present count of the first captured frame (0 = hotkey only)
+    int captureFrameCount = 60;  // Frames per capture (0 = until stopped)
+    int captureQueueMB = 512;    // Writer queue; when it is full the oldest frames are dropped
+
+    // Hotkeys (DLSSInput chords: virtual-key code plus modifier bits)
     int toggleMenuKey = 0x47;      // 'G' key
     int toggleUpscalerKey = 0x6A;  // VK_MULTIPLY (NumPad *)
     int cycleQualityKey = 0x24;    // VK_HOME
     int cycleUpscalerKey = 0x2D;   // VK_INSERT
+    int captureKey = 0x79;         // VK_F10: start/stop a frame capture
+    int hotkeyDebounceMs = 150;    // Minimum interval between two firings of one hotkey
 
     // Early DLSS integration (render-time) flags
     bool earlyDlssEnabled = false;       // Faz 1/2 entegrasyonu aç/kapa
@@ -78,6 +107,7 @@ public:
     bool peripheryTAAEnabled = true;     // DLSS dikdörtgeni dışını TAA ile çöz
     bool foveatedRenderingEnabled = false; // FFR/FFU ana bayrak
     bool debugEarlyDlss = false;         // Geniş log
+    bool earlyDlssPassGraph = true;      // Pass grafiği ile gölge/HUD geçişlerini ayıkla
 
 private:
     void ParseIniFile(const std::string& path);
@@ -0,0 +1,340 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// Early-DLSS hook state per device context. The context hooks are vtable
+// patches, so they fire for every context of the device: the game's
+// immediate context and any deferred context (ENB-style overlays record on
+// their own threads). Scene detection, the viewport clamp's log budget and
+// the redirect binding state therefore live in one State per context.
+//
+// Contexts find their State in a fixed slot table without locks: a slot is
+// claimed by CAS on its key and afterwards only touched by the context's
+// own thread (D3D11 contexts are single-threaded by contract), through a
+// Lease that pins the slot for the hook call. A slot idle for kIdleFrames
+// can be retired for a new context, but only while nothing pins it: the
+// retiring thread parks the key on kRetiring, then checks the pin count,
+// and the owner pins, then re-checks the key, so one of them always backs
+// off and the old owner never runs on a State being reset. Per-frame
+// facts are stamped with the frame they belong to and cleared lazily by the
+// owner when Present has moved on. A deferred context's facts travel with
+// the command list it finishes and merge into the context that executes it.
+//
+// Platform-free: contexts and command lists are keys.
+namespace DLSSContextState {
+
+    constexpr uint32_t kMaxContexts = 16;
+    constexpr uint32_t kMaxLists = 64;       // finished command lists remembered for ExecuteCommandList
+    constexpr uint32_t kMaxViewports = 16;   // D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE
+    constexpr uint64_t kIdleFrames = 120;    // a slot unused this long can be taken by a new context
+    constexpr int kClampLogBudget = 4;       // viewport clamp log lines per context and frame
+
+    // D3D11_VIEWPORT layout
+    struct Viewport {
+        float x = 0.0f;
+        float y = 0.0f;
+        float width = 0.0f;
+        float height = 0.0f;
+        float minDepth = 0.0f;
+        float maxDepth = 0.0f;
+    };
+
+    // D3D11_RECT layout
+    struct ScissorRect {
+        int32_t left = 0;
+        int32_t top = 0;
+        int32_t right = 0;
+        int32_t bottom = 0;
+    };
+
+    // Scene color target seen this frame (the D3D11_TEXTURE2D_DESC fields the hooks test)
+    struct SceneTarget {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t format = 0;
+        uint32_t sampleCount = 0;
+        uint32_t bindFlags = 0;
+    };
+
+    // Per-frame facts of one context
+    struct FrameFlags {
+        bool sceneActive = false;
+        SceneTarget scene;
+        bool redirectUsed = false;
+        bool composited = false;
+        uint32_t clampedViewports = 0;
+
+        // Facts of work executed into this context (a command list)
+        void Merge(const FrameFlags& o) {
+            if (o.sceneActive && !sceneActive) {
+                sceneActive = true;
+                scene = o.scene;
+            }
+            redirectUsed |= o.redirectUsed;
+            composited |= o.composited;
+            clampedViewports += o.clampedViewports;
+        }
+    };
+
+    struct State {
+        uint64_t frame = 0;  // frame 'flags' and 'clampLogBudget' belong to
+        FrameFlags flags;
+        int clampLogBudget = kClampLogBudget;
+
+        // Pipeline state, kept across frames until the context's state is cleared
+        bool redirectBindActive = false;  // current OM binding uses twins
+        uint32_t redirectSmallWidth = 0;
+        uint32_t redirectSmallHeight = 0;
+        Viewport lastViewports[kMaxViewports];  // the game's, to re-issue after a (un)redirect
+        uint32_t lastViewportCount = 0;
+        ScissorRect lastScissors[kMaxViewports];  // same for the scissor rects
+        uint32_t lastScissorCount = 0;
+
+        void ResetPipeline() {
+            redirectBindActive = false;
+            redirectSmallWidth = redirectSmallHeight = 0;
+            lastViewportCount = 0;
+            lastScissorCount = 0;
+        }
+    };
+
+    struct Stats {
+        uint32_t contexts = 0;      // slots in use
+        uint64_t claims = 0;        // slots claimed (first use or reuse of an idle slot)
+        uint64_t retired = 0;       // idle slots taken over by another context
+        uint64_t tableFull = 0;     // hook calls that found no slot and passed through
+        uint64_t listsMerged = 0;   // ExecuteCommandList calls that merged a finished list
+    };
+
+    // A context's State, pinned until the lease is destroyed. Keep it for
+    // one hook call; empty when the table had no slot.
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& o) noexcept : m_pins(o.m_pins), m_state(o.m_state) { o.m_pins = nullptr; o.m_state = nullptr; }
+        Lease& operator=(Lease&& o) noexcept {
+            if (this != &o) {
+                Unpin();
+                m_pins = o.m_pins; m_state = o.m_state;
+                o.m_pins = nullptr; o.m_state = nullptr;
+            }
+            return *this;
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() { Unpin(); }
+
+        explicit operator bool() const { return m_state != nullptr; }
+        State* operator->() const { return m_state; }
+        State& operator*() const { return *m_state; }
+        State* get() const { return m_state; }
+
+    private:
+        friend class Table;
+        Lease(std::atomic<uint32_t>* pins, State* state) : m_pins(pins), m_state(state) {}
+        void Unpin() {
+            if (m_pins) m_pins->fetch_sub(1, std::memory_order_release);
+            m_pins = nullptr;
+            m_state = nullptr;
+        }
+
+        std::atomic<uint32_t>* m_pins = nullptr;
+        State* m_state = nullptr;
+    };
+
+    class Table {
+    public:
+        // Present: per-frame facts of every context start over (lazily)
+        void BeginFrame() { m_frame.fetch_add(1, std::memory_order_acq_rel); }
+        uint64_t Frame() const { return m_frame.load(std::memory_order_acquire); }
+
+        // Context's own thread. Empty when every slot is taken by a live
+        // context; the caller then passes the call through untouched.
+        Lease Acquire(uintptr_t context) {
+            if (!context || context == kRetiring) return Lease();
+            const uint64_t frame = Frame();
+            for (uint32_t i = 0; i < kMaxContexts; ++i) {
+                if (SettledKey(i) == context && Pin(i, context)) return Lease(&m_pins[i], Touch(i, frame));
+            }
+            for (uint32_t i = 0; i < kMaxContexts; ++i) {
+                uintptr_t expected = 0;
+                if (m_keys[i].compare_exchange_strong(expected, kRetiring, std::memory_order_seq_cst)) return Claim(i, context, frame);
+            }
+            // Contexts are never unregistered (their Release is not hooked):
+            // retire a slot whose context has been silent for kIdleFrames
+            for (uint32_t i = 0; i < kMaxContexts; ++i) {
+                if (frame < m_lastSeen[i].load(std::memory_order_acquire) + kIdleFrames) continue;
+                uintptr_t owner = m_keys[i].load(std::memory_order_acquire);
+                if (owner == 0 || owner == kRetiring || owner == context) continue;
+                if (!m_keys[i].compare_exchange_strong(owner, kRetiring, std::memory_order_seq_cst)) continue;
+                // The owner is inside a hook call, or touched the slot since
+                // the idle check: it keeps the slot
+                if (m_pins[i].load(std::memory_order_seq_cst) != 0 ||
+                    frame < m_lastSeen[i].load(std::memory_order_acquire) + kIdleFrames) {
+                    m_keys[i].store(owner, std::memory_order_seq_cst);
+                    continue;
+                }
+                m_retired.fetch_add(1, std::memory_order_relaxed);
+                return Claim(i, context, frame);
+            }
+            m_tableFull.fetch_add(1, std::memory_order_relaxed);
+            return Lease();
+        }
+
+        // FinishCommandList on 'context' produced 'list': the list carries
+        // the context's facts so far; they are cleared on the context, and so
+        // is its pipeline state unless the call restores it
+        void Finish(uintptr_t context, uintptr_t list, bool restoreState) {
+            Lease s = Acquire(context);
+            if (!s || !list) return;
+            const uint32_t index = m_listCursor.fetch_add(1, std::memory_order_relaxed) % kMaxLists;
+            ListEntry& e = m_lists[index];
+            const uint32_t seq = e.sequence.load(std::memory_order_relaxed);
+            e.sequence.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            e.list.store(list, std::memory_order_relaxed);
+            uint32_t words[kFlagWords];
+            Pack(s->flags, words);
+            for (uint32_t i = 0; i < kFlagWords; ++i) e.flags[i].store(words[i], std::memory_order_relaxed);
+            e.sequence.store(seq + 2, std::memory_order_release);
+
+            s->flags = FrameFlags{};
+            if (!restoreState) s->ResetPipeline();
+        }
+
+        // ExecuteCommandList of 'list' on 'context' (usually the immediate
+        // one): the list's work happens now, so its facts merge into this
+        // frame of the executing context, on every execution
+        bool Execute(uintptr_t context, uintptr_t list) {
+            Lease s = Acquire(context);
+            if (!s || !list) return false;
+            FrameFlags flags;
+            if (!FindList(list, flags)) return false;
+            s->flags.Merge(flags);
+            m_listsMerged.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        Stats GetStats() const {
+            Stats stats{};
+            for (uint32_t i = 0; i < kMaxContexts; ++i) {
+                if (m_keys[i].load(std::memory_order_relaxed)) ++stats.contexts;
+            }
+            stats.claims = m_claims.load(std::memory_order_relaxed);
+            stats.retired = m_retired.load(std::memory_order_relaxed);
+            stats.tableFull = m_tableFull.load(std::memory_order_relaxed);
+            stats.listsMerged = m_listsMerged.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+    private:
+        static constexpr uint32_t kFlagWords = 7;
+        static constexpr uintptr_t kRetiring = ~static_cast<uintptr_t>(0);  // key while a slot changes owner
+
+        // Key of slot i, waiting out a retirement in progress (a few stores)
+        uintptr_t SettledKey(uint32_t i) const {
+            uintptr_t key = m_keys[i].load(std::memory_order_acquire);
+            while (key == kRetiring) {
+                std::this_thread::yield();
+                key = m_keys[i].load(std::memory_order_acquire);
+            }
+            return key;
+        }
+
+        // Owner side of the handshake: pin, then confirm the slot is still ours
+        bool Pin(uint32_t i, uintptr_t context) {
+            m_pins[i].fetch_add(1, std::memory_order_seq_cst);
+            if (m_keys[i].load(std::memory_order_seq_cst) == context) return true;
+            m_pins[i].fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+
+        struct ListEntry {
+            std::atomic<uint32_t> sequence{0};  // odd while written
+            std::atomic<uintptr_t> list{0};
+            std::atomic<uint32_t> flags[kFlagWords] = {};
+        };
+
+        static void Pack(const FrameFlags& f, uint32_t (&w)[kFlagWords]) {
+            w[0] = (f.sceneActive ? 1u : 0u) | (f.redirectUsed ? 2u : 0u) | (f.composited ? 4u : 0u);
+            w[1] = f.scene.width;
+            w[2] = f.scene.height;
+            w[3] = f.scene.format;
+            w[4] = f.scene.sampleCount;
+            w[5] = f.scene.bindFlags;
+            w[6] = f.clampedViewports;
+        }
+
+        static FrameFlags Unpack(const uint32_t (&w)[kFlagWords]) {
+            FrameFlags f;
+            f.sceneActive = (w[0] & 1u) != 0;
+            f.redirectUsed = (w[0] & 2u) != 0;
+            f.composited = (w[0] & 4u) != 0;
+            f.scene.width = w[1];
+            f.scene.height = w[2];
+            f.scene.format = w[3];
+            f.scene.sampleCount = w[4];
+            f.scene.bindFlags = w[5];
+            f.clampedViewports = w[6];
+            return f;
+        }
+
+        // Newest entry for the list (a released list's pointer can come back
+        // for a new one); entries being rewritten are skipped and retried
+        bool FindList(uintptr_t list, FrameFlags& out) const {
+            for (int attempt = 0; attempt < 4; ++attempt) {
+                bool torn = false;
+                const uint32_t newest = m_listCursor.load(std::memory_order_acquire);
+                for (uint32_t n = 1; n <= kMaxLists; ++n) {
+                    const ListEntry& e = m_lists[(newest - n) % kMaxLists];
+                    const uint32_t before = e.sequence.load(std::memory_order_acquire);
+                    if (before & 1u) { torn = true; continue; }
+                    if (e.list.load(std::memory_order_relaxed) != list) continue;
+                    uint32_t words[kFlagWords];
+                    for (uint32_t i = 0; i < kFlagWords; ++i) words[i] = e.flags[i].load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (e.sequence.load(std::memory_order_relaxed) != before) { torn = true; continue; }
+                    out = Unpack(words);
+                    return true;
+                }
+                if (!torn) return false;
+            }
+            return false;
+        }
+
+        State* Touch(uint32_t i, uint64_t frame) {
+            if (m_lastSeen[i].load(std::memory_order_relaxed) != frame) m_lastSeen[i].store(frame, std::memory_order_release);
+            State& s = m_states[i];
+            if (s.frame != frame) {
+                s.frame = frame;
+                s.flags = FrameFlags{};
+                s.clampLogBudget = kClampLogBudget;
+            }
+            return &s;
+        }
+
+        // Slot i's key is kRetiring and nothing pins it: reset and publish
+        Lease Claim(uint32_t i, uintptr_t context, uint64_t frame) {
+            m_states[i] = State{};
+            m_states[i].frame = frame;
+            m_lastSeen[i].store(frame, std::memory_order_release);
+            m_pins[i].fetch_add(1, std::memory_order_relaxed);
+            m_keys[i].store(context, std::memory_order_seq_cst);
+            m_claims.fetch_add(1, std::memory_order_relaxed);
+            return Lease(&m_pins[i], &m_states[i]);
+        }
+
+        std::atomic<uint64_t> m_frame{1};
+        std::atomic<uintptr_t> m_keys[kMaxContexts] = {};
+        std::atomic<uint64_t> m_lastSeen[kMaxContexts] = {};
+        std::atomic<uint32_t> m_pins[kMaxContexts] = {};  // live Leases per slot
+        State m_states[kMaxContexts];
+        ListEntry m_lists[kMaxLists];
+        std::atomic<uint32_t> m_listCursor{0};
+        std::atomic<uint64_t> m_claims{0};
+        std::atomic<uint64_t> m_retired{0};
+        std::atomic<uint64_t> m_tableFull{0};
+        std::atomic<uint64_t> m_listsMerged{0};
+    };
+}
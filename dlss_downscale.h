@@ -0,0 +1,357 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Downscale filter permutations (filter x encoding x layout). Every
+// permutation is its own pixel shader compiled from shaders/Downscale.hlsl
+// with FILTER/ENCODING/STEREO defines, so the shader has no runtime branches
+// on them. The kernel constants and the CPU reference below mirror the HLSL
+// one-to-one; keep both in sync.
+namespace DLSSDownscale {
+
+    enum class Filter : uint32_t {
+        Box = 0,       // exact area average of the source footprint
+        Bilinear,      // one hardware sample (the old copy shader)
+        CatmullRom,    // bicubic, B=0 C=0.5
+        Lanczos,       // Lanczos-2, separable weights
+        Count
+    };
+
+    enum class Encoding : uint32_t {
+        Linear = 0,    // values are filtered as read
+        SRGB,          // sRGB-encoded data behind a UNORM view: decode, filter, encode
+        R11G11B10,     // unsigned float target: negative lobes clamped, alpha 1
+        Count
+    };
+
+    enum class Layout : uint32_t {
+        Mono = 0,
+        Stereo,        // side-by-side eyes; taps never cross the middle seam
+        Count
+    };
+
+    constexpr uint32_t kFilterCount = static_cast<uint32_t>(Filter::Count);
+    constexpr uint32_t kEncodingCount = static_cast<uint32_t>(Encoding::Count);
+    constexpr uint32_t kLayoutCount = static_cast<uint32_t>(Layout::Count);
+    constexpr uint32_t kPermutationCount = kFilterCount * kEncodingCount * kLayoutCount;
+
+    // Filter-major order; the shader table in dlss_shaders.cpp follows it.
+    constexpr uint32_t PermutationIndex(Filter f, Encoding e, Layout l) {
+        return (static_cast<uint32_t>(f) * kEncodingCount + static_cast<uint32_t>(e)) * kLayoutCount + static_cast<uint32_t>(l);
+    }
+
+    // Compute-shader variants (DOWNSCALE_CS): mono only, same filter/encoding axes
+    constexpr uint32_t kComputePermutationCount = kFilterCount * kEncodingCount;
+
+    constexpr uint32_t ComputePermutationIndex(Filter f, Encoding e) {
+        return static_cast<uint32_t>(f) * kEncodingCount + static_cast<uint32_t>(e);
+    }
+
+    inline const char* FilterName(Filter f) {
+        switch (f) {
+            case Filter::Box: return "box";
+            case Filter::Bilinear: return "bilinear";
+            case Filter::CatmullRom: return "catmull-rom";
+            case Filter::Lanczos: return "lanczos";
+            default: return "unknown";
+        }
+    }
+
+    // Kernel radius in kernel units, i.e. destination pixels once the kernel
+    // is stretched (FILTER_SUPPORT in shaders/Downscale.hlsl)
+    constexpr float Support(Filter f) {
+        return f == Filter::Box ? 0.5f : (f == Filter::Bilinear ? 1.0f : 2.0f);
+    }
+
+    // Source texels read per axis (FILTER_TAPS in the shader loop)
+    constexpr uint32_t Taps(Filter f) {
+        return f == Filter::Box ? 4u : (f == Filter::Bilinear ? 2u : 8u);
+    }
+
+    // Largest kernel stretch that still fits the tap window. Box covers
+    // ratios up to 3 exactly; the cubic kernels prefilter up to 2x and fall
+    // back to a narrower kernel beyond that.
+    constexpr float MaxStretch(Filter f) {
+        return f == Filter::Box ? static_cast<float>(Taps(f) - 1) : static_cast<float>(Taps(f)) / (2.0f * Support(f));
+    }
+
+    // src/dst ratio -> kernel scale in source texels. Upscaling keeps the
+    // unit kernel; bilinear never stretches (it is the hardware sample).
+    inline float KernelScale(Filter f, float ratio) {
+        if (f == Filter::Bilinear || ratio <= 1.0f) return 1.0f;
+        return ratio < MaxStretch(f) ? ratio : MaxStretch(f);
+    }
+
+    // Shader constants (register b0), 16-byte aligned
+    struct Params {
+        float srcSize[2];
+        float ratio[2];         // src / dst per axis
+        float kernelScale[2];
+        float dstSize[2];       // compute path bounds check
+    };
+    static_assert(sizeof(Params) == 32, "Params must match the HLSL cbuffer");
+
+    inline Params MakeParams(Filter f, uint32_t srcW, uint32_t srcH, uint32_t dstW, uint32_t dstH) {
+        Params p{};
+        p.srcSize[0] = static_cast<float>(srcW);
+        p.srcSize[1] = static_cast<float>(srcH);
+        p.ratio[0] = dstW ? static_cast<float>(srcW) / static_cast<float>(dstW) : 1.0f;
+        p.ratio[1] = dstH ? static_cast<float>(srcH) / static_cast<float>(dstH) : 1.0f;
+        p.kernelScale[0] = KernelScale(f, p.ratio[0]);
+        p.kernelScale[1] = KernelScale(f, p.ratio[1]);
+        p.dstSize[0] = static_cast<float>(dstW);
+        p.dstSize[1] = static_cast<float>(dstH);
+        return p;
+    }
+
+    // ---- CPU reference -------------------------------------------------
+
+    inline float Kernel(Filter f, float x) {
+        x = std::fabs(x);
+        switch (f) {
+            case Filter::CatmullRom:
+                if (x < 1.0f) return (1.5f * x - 2.5f) * x * x + 1.0f;
+                if (x < Support(f)) return ((-0.5f * x + 2.5f) * x - 4.0f) * x + 2.0f;
+                return 0.0f;
+            case Filter::Lanczos: {
+                if (x >= Support(f)) return 0.0f;
+                if (x < 1e-5f) return 1.0f;
+                const float pi = 3.14159265358979f;
+                const float a = pi * x;
+                const float b = a / Support(f);
+                return (std::sin(a) / a) * (std::sin(b) / b);
+            }
+            case Filter::Bilinear:
+                return x < Support(f) ? 1.0f - x / Support(f) : 0.0f;
+            default:
+                return x <= Support(f) ? 1.0f : 0.0f;
+        }
+    }
+
+    struct Tap {
+        int32_t texel;   // clamped into [lo, hi]
+        float weight;    // normalized: the taps of one output pixel sum to 1
+    };
+
+    // First source texel read for an output pixel centred at 'center'
+    inline int32_t FirstTap(Filter f, float center) {
+        return static_cast<int32_t>(std::floor(center - 0.5f)) - static_cast<int32_t>(Taps(f)) / 2 + 1;
+    }
+
+    // Taps of one output pixel along one axis. 'center' is the pixel centre
+    // in source texels; [lo, hi] is the readable texel range (one eye in the
+    // stereo layout). Same arithmetic as Weights() in Downscale.hlsl.
+    inline void ComputeTaps(Filter f, float center, float scale, int32_t lo, int32_t hi, std::vector<Tap>& out) {
+        out.clear();
+        const int32_t taps = static_cast<int32_t>(Taps(f));
+        const int32_t first = FirstTap(f, center);
+        float sum = 0.0f;
+        for (int32_t k = 0; k < taps; ++k) {
+            const int32_t i = first + k;
+            float w;
+            if (f == Filter::Box) {
+                // Overlap of texel [i, i+1) with the footprint [c - r, c + r)
+                const float r = Support(f) * scale;
+                const float a = (static_cast<float>(i) > center - r) ? static_cast<float>(i) : center - r;
+                const float b = (static_cast<float>(i + 1) < center + r) ? static_cast<float>(i + 1) : center + r;
+                w = (b > a) ? b - a : 0.0f;
+            } else {
+                w = Kernel(f, (static_cast<float>(i) + 0.5f - center) / scale);
+            }
+            const int32_t t = i < lo ? lo : (i > hi ? hi : i);
+            out.push_back({t, w});
+            sum += w;
+        }
+        if (sum != 0.0f) {
+            for (Tap& t : out) t.weight /= sum;
+        }
+    }
+
+    // Separable reference downscale of one channel. Stereo halves the source
+    // and destination widths into two independent eyes.
+    inline void Resample(Filter f, Layout layout, const float* src, uint32_t srcW, uint32_t srcH,
+                         float* dst, uint32_t dstW, uint32_t dstH) {
+        const Params p = MakeParams(f, srcW, srcH, dstW, dstH);
+        const uint32_t eyes = (layout == Layout::Stereo) ? 2u : 1u;
+        const uint32_t srcEyeW = srcW / eyes;
+        const uint32_t dstEyeW = dstW / eyes;
+        std::vector<Tap> tx, ty;
+        for (uint32_t y = 0; y < dstH; ++y) {
+            ComputeTaps(f, (static_cast<float>(y) + 0.5f) * p.ratio[1], p.kernelScale[1], 0, static_cast<int32_t>(srcH) - 1, ty);
+            for (uint32_t x = 0; x < dstW; ++x) {
+                const uint32_t eye = dstEyeW ? x / dstEyeW : 0;
+                const int32_t lo = static_cast<int32_t>(eye * srcEyeW);
+                const int32_t hi = lo + static_cast<int32_t>(srcEyeW) - 1;
+                ComputeTaps(f, (static_cast<float>(x) + 0.5f) * p.ratio[0], p.kernelScale[0], lo, hi, tx);
+                float acc = 0.0f;
+                for (const Tap& v : ty) {
+                    float row = 0.0f;
+                    for (const Tap& u : tx) row += u.weight * src[static_cast<size_t>(v.texel) * srcW + u.texel];
+                    acc += v.weight * row;
+                }
+                dst[static_cast<size_t>(y) * dstW + x] = acc;
+            }
+        }
+    }
+
+    // Total weight every source texel receives along one axis, scaled by
+    // dst/src. Exact coverage means every entry is 1: each texel contributes
+    // as much as its share of the output, no more and no less.
+    inline void Coverage(Filter f, uint32_t srcSize, uint32_t dstSize, std::vector<float>& out) {
+        out.assign(srcSize, 0.0f);
+        const float ratio = static_cast<float>(srcSize) / static_cast<float>(dstSize);
+        const float scale = KernelScale(f, ratio);
+        std::vector<Tap> taps;
+        for (uint32_t x = 0; x < dstSize; ++x) {
+            ComputeTaps(f, (static_cast<float>(x) + 0.5f) * ratio, scale, 0, static_cast<int32_t>(srcSize) - 1, taps);
+            for (const Tap& t : taps) out[t.texel] += t.weight;
+        }
+        for (float& c : out) c *= ratio;
+    }
+
+    // ---- Compute path tiling ------------------------------------------
+    //
+    // One 8x8 thread group writes an 8x8 output tile. It first loads a
+    // kTileSource x kTileSource block of source texels (the tile's footprint
+    // plus the filter apron) into groupshared memory, filters it
+    // horizontally into 8 columns, then vertically into the 8x8 outputs.
+
+    constexpr uint32_t kTileSize = 8;       // outputs per group and axis (numthreads)
+    constexpr uint32_t kTileSource = 32;    // groupshared texels per axis
+    constexpr uint32_t kTileLoads = (kTileSource * kTileSource) / (kTileSize * kTileSize);  // per thread
+    static_assert(kTileSource % kTileSize == 0, "horizontal pass gives each thread whole rows");
+
+    // Source texels a tile reads along one axis, before edge clamping
+    struct TileSpan {
+        int32_t first = 0;   // groupshared index 0 maps to this texel
+        uint32_t count = 0;
+    };
+
+    inline uint32_t TileCount(uint32_t dstSize) {
+        return (dstSize + kTileSize - 1) / kTileSize;
+    }
+
+    inline TileSpan SourceSpan(Filter f, uint32_t tile, uint32_t dstSize, float ratio) {
+        const uint32_t x0 = tile * kTileSize;
+        uint32_t x1 = x0 + kTileSize - 1;
+        if (x1 >= dstSize) x1 = dstSize - 1;
+        TileSpan span;
+        span.first = FirstTap(f, (static_cast<float>(x0) + 0.5f) * ratio);
+        const int32_t last = FirstTap(f, (static_cast<float>(x1) + 0.5f) * ratio) + static_cast<int32_t>(Taps(f)) - 1;
+        span.count = static_cast<uint32_t>(last - span.first + 1);
+        return span;
+    }
+
+    // Result of running the compute shader's indexing over a whole dispatch
+    struct TileCheck {
+        uint32_t groups = 0;
+        uint32_t maxSpan = 0;        // largest footprint + apron on either axis, must be <= kTileSource
+        uint32_t outputs = 0;        // output texels written exactly once
+        uint32_t wrongTaps = 0;      // groupshared reads that do not hold the reference tap's texel
+        bool ok = false;
+    };
+
+    // CPU simulator of DOWNSCALE_CS in Downscale.hlsl, thread by thread: the
+    // cooperative load (flat index i = SV_GroupIndex + k * 64, local texel
+    // (i % kTileSource, i / kTileSource), edge clamp), the horizontal pass
+    // over rows tid.y + 8r from the clamped offset lx, the vertical pass from
+    // ly and the partial-tile store. Every groupshared read of an output
+    // inside the target is checked against the texel ComputeTaps (the pixel
+    // shader) reads for that tap.
+    inline TileCheck SimulateTiles(Filter f, uint32_t srcW, uint32_t srcH, uint32_t dstW, uint32_t dstH) {
+        TileCheck c;
+        if (srcW == 0 || srcH == 0 || dstW == 0 || dstH == 0) return c;
+        const float ratioX = static_cast<float>(srcW) / static_cast<float>(dstW);
+        const float ratioY = static_cast<float>(srcH) / static_cast<float>(dstH);
+        const int32_t taps = static_cast<int32_t>(Taps(f));
+        const int32_t block = static_cast<int32_t>(kTileSource);
+        const uint32_t threads = kTileSize * kTileSize;
+        auto clampTo = [](int32_t v, int32_t hi) { return v < 0 ? 0 : (v > hi ? hi : v); };
+
+        // Source texel held by each groupshared cell; -1 = never loaded
+        std::vector<int32_t> gsX(kTileSource * kTileSource), gsY(kTileSource * kTileSource);
+        // Source row each gsRow row was filtered from; -1 = never written
+        std::vector<int32_t> rowY(kTileSource);
+        std::vector<uint32_t> writes(static_cast<size_t>(dstW) * dstH, 0);
+        const uint32_t groupsX = TileCount(dstW), groupsY = TileCount(dstH);
+        for (uint32_t gx = 0; gx < groupsX; ++gx) {
+            const uint32_t spanX = SourceSpan(f, gx, dstW, ratioX).count;
+            if (spanX > c.maxSpan) c.maxSpan = spanX;
+        }
+        for (uint32_t gy = 0; gy < groupsY; ++gy) {
+            const uint32_t spanY = SourceSpan(f, gy, dstH, ratioY).count;
+            if (spanY > c.maxSpan) c.maxSpan = spanY;
+        }
+        for (uint32_t gy = 0; gy < groupsY; ++gy) {
+            for (uint32_t gx = 0; gx < groupsX; ++gx) {
+                ++c.groups;
+                const uint32_t originX = gx * kTileSize, originY = gy * kTileSize;
+                const int32_t spanFirstX = FirstTap(f, (static_cast<float>(originX) + 0.5f) * ratioX);
+                const int32_t spanFirstY = FirstTap(f, (static_cast<float>(originY) + 0.5f) * ratioY);
+
+                // Cooperative load
+                std::fill(gsX.begin(), gsX.end(), -1);
+                std::fill(gsY.begin(), gsY.end(), -1);
+                for (uint32_t index = 0; index < threads; ++index) {
+                    for (uint32_t k = 0; k < kTileLoads; ++k) {
+                        const uint32_t i = index + k * threads;
+                        const uint32_t lx = i % kTileSource, ly = i / kTileSource;
+                        if (ly >= kTileSource) continue;  // out of gsSrc: would be a shader bug
+                        gsX[ly * kTileSource + lx] = clampTo(spanFirstX + static_cast<int32_t>(lx), static_cast<int32_t>(srcW) - 1);
+                        gsY[ly * kTileSource + lx] = clampTo(spanFirstY + static_cast<int32_t>(ly), static_cast<int32_t>(srcH) - 1);
+                    }
+                }
+
+                // Horizontal pass; rows are shared by the 8 columns, so one source row per gsRow row
+                std::fill(rowY.begin(), rowY.end(), -1);
+                for (uint32_t ty = 0; ty < kTileSize; ++ty) {
+                    for (uint32_t tx = 0; tx < kTileSize; ++tx) {
+                        const uint32_t px = originX + tx;
+                        const int32_t fx = FirstTap(f, (static_cast<float>(px) + 0.5f) * ratioX);
+                        const int32_t lx = clampTo(fx - spanFirstX, block - taps);
+                        for (uint32_t r = 0; r < kTileSource / kTileSize; ++r) {
+                            const uint32_t row = ty + r * kTileSize;
+                            for (int32_t x = 0; x < taps; ++x) {
+                                const int32_t held = gsX[row * kTileSource + lx + x];
+                                if (px < dstW && held != clampTo(fx + x, static_cast<int32_t>(srcW) - 1)) ++c.wrongTaps;
+                            }
+                            rowY[row] = gsY[row * kTileSource + lx];
+                        }
+                    }
+                }
+
+                // Vertical pass and store
+                for (uint32_t ty = 0; ty < kTileSize; ++ty) {
+                    for (uint32_t tx = 0; tx < kTileSize; ++tx) {
+                        const uint32_t px = originX + tx, py = originY + ty;
+                        const int32_t fy = FirstTap(f, (static_cast<float>(py) + 0.5f) * ratioY);
+                        const int32_t ly = clampTo(fy - spanFirstY, block - taps);
+                        for (int32_t y = 0; y < taps; ++y) {
+                            if (px < dstW && py < dstH && rowY[ly + y] != clampTo(fy + y, static_cast<int32_t>(srcH) - 1)) ++c.wrongTaps;
+                        }
+                        if (px < dstW && py < dstH) ++writes[static_cast<size_t>(py) * dstW + px];
+                    }
+                }
+            }
+        }
+        for (uint32_t w : writes) {
+            if (w == 1) ++c.outputs;
+        }
+        c.ok = c.outputs == dstW * dstH && c.wrongTaps == 0 && c.maxSpan <= kTileSource;
+        return c;
+    }
+
+    // Whether the compute path can filter this src -> dst size at all: the
+    // widest tile footprint must fit the groupshared block.
+    inline bool ComputeFits(Filter f, uint32_t srcSize, uint32_t dstSize) {
+        if (srcSize == 0 || dstSize == 0) return false;
+        const float ratio = static_cast<float>(srcSize) / static_cast<float>(dstSize);
+        for (uint32_t t = 0; t < TileCount(dstSize); ++t) {
+            if (SourceSpan(f, t, dstSize, ratio).count > kTileSource) return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,385 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Frame pacing telemetry for the menu. Present-to-Present and (left eye)
+// Submit-to-Submit intervals go into fixed-size log-linear histograms; each
+// second is rolled up into a small ring, and long stalls ("hitches") are
+// matched against recent plugin events (feature re-creation, resize, config
+// apply) so the menu can say what caused them.
+//
+// Per-frame cost is one bucket increment and a few compares. Intervals and
+// rollups are owned by the render thread; Note() may be called from any
+// thread. Platform-free so it can be exercised with synthetic timings.
+namespace DLSSFrameTiming {
+
+    // Monotonic milliseconds; every timestamp fed to this module must use it
+    inline double NowMs() {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // ---- Histogram -----------------------------------------------------
+    // Microsecond values with 1 us resolution below 32 us and 16 linear
+    // sub-buckets per power of two above (<= 6.25% relative error), capped
+    // at ~4.2 s. 304 counters, no allocation.
+    class Histogram {
+    public:
+        static constexpr uint32_t kSubBits = 4;
+        static constexpr uint32_t kSubCount = 1u << kSubBits;           // 16
+        static constexpr uint32_t kLinearCount = kSubCount * 2;         // exact buckets 0..31
+        static constexpr uint32_t kMaxLog2 = 21;                        // values < 2^22 us
+        static constexpr uint32_t kBucketCount = kLinearCount + (kMaxLog2 - kSubBits) * kSubCount;
+        static constexpr uint64_t kMaxValueUs = (1ull << (kMaxLog2 + 1)) - 1;
+
+        static uint32_t BucketOf(uint64_t us) {
+            if (us > kMaxValueUs) us = kMaxValueUs;
+            if (us < kLinearCount) return static_cast<uint32_t>(us);
+            uint32_t log2 = 0;
+            for (uint64_t v = us; v > 1; v >>= 1) ++log2;
+            const uint32_t shift = log2 - kSubBits;
+            const uint32_t top = static_cast<uint32_t>(us >> shift);  // 16..31
+            return kLinearCount + (log2 - kSubBits - 1) * kSubCount + (top - kSubCount);
+        }
+
+        static uint64_t LowerBound(uint32_t bucket) {
+            if (bucket < kLinearCount) return bucket;
+            const uint32_t rel = bucket - kLinearCount;
+            const uint32_t shift = rel / kSubCount + 1;
+            return static_cast<uint64_t>(kSubCount + rel % kSubCount) << shift;
+        }
+
+        static uint64_t UpperBound(uint32_t bucket) {
+            if (bucket < kLinearCount) return bucket;
+            const uint32_t shift = (bucket - kLinearCount) / kSubCount + 1;
+            return LowerBound(bucket) + (1ull << shift) - 1;
+        }
+
+        void Add(uint64_t us) {
+            ++m_counts[BucketOf(us)];
+            ++m_total;
+            m_sumUs += us;
+            if (us > m_maxUs) m_maxUs = us;
+        }
+
+        void Merge(const Histogram& other) {
+            for (uint32_t i = 0; i < kBucketCount; ++i) m_counts[i] += other.m_counts[i];
+            m_total += other.m_total;
+            m_sumUs += other.m_sumUs;
+            if (other.m_maxUs > m_maxUs) m_maxUs = other.m_maxUs;
+        }
+
+        void Clear() {
+            for (uint32_t& c : m_counts) c = 0;
+            m_total = 0;
+            m_sumUs = 0;
+            m_maxUs = 0;
+        }
+
+        uint64_t Count() const { return m_total; }
+        uint64_t MaxUs() const { return m_maxUs; }
+        double MeanUs() const { return m_total ? static_cast<double>(m_sumUs) / static_cast<double>(m_total) : 0.0; }
+
+        // Upper edge of the bucket holding the p-th percentile (p in 0..100),
+        // so tail figures err on the pessimistic side
+        uint64_t PercentileUs(double p) const {
+            if (m_total == 0) return 0;
+            if (p < 0.0) p = 0.0;
+            if (p > 100.0) p = 100.0;
+            uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(m_total) + 0.5);
+            if (rank == 0) rank = 1;
+            uint64_t seen = 0;
+            for (uint32_t i = 0; i < kBucketCount; ++i) {
+                seen += m_counts[i];
+                if (seen >= rank) {
+                    const uint64_t upper = UpperBound(i);
+                    return upper < m_maxUs ? upper : m_maxUs;
+                }
+            }
+            return m_maxUs;
+        }
+
+    private:
+        uint32_t m_counts[kBucketCount] = {};
+        uint64_t m_total = 0;
+        uint64_t m_sumUs = 0;
+        uint64_t m_maxUs = 0;
+    };
+
+    // ---- Per-stream intervals and per-second rollups ---------------------
+
+    // Intervals within this factor of the budget count as on time; frames
+    // paced by the compositor land slightly over the exact period.
+    constexpr double kOverBudgetSlack = 1.10;
+    // A hitch is at least three budgets long: two or more frames in a row
+    // were reprojected.
+    constexpr double kHitchBudgets = 3.0;
+    // Longer gaps are pauses (loading, alt-tab), not frames
+    constexpr double kMaxIntervalMs = 2000.0;
+
+    constexpr uint32_t kRollupSeconds = 60;
+
+    struct SecondRollup {
+        uint32_t frames = 0;
+        uint32_t overBudget = 0;
+        uint32_t hitches = 0;
+        float p50Ms = 0.0f;
+        float p99Ms = 0.0f;
+        float maxMs = 0.0f;
+    };
+
+    class Stream {
+    public:
+        void SetBudgetMs(double budgetMs) { m_budgetMs = budgetMs > 0.0 ? budgetMs : m_budgetMs; }
+        double BudgetMs() const { return m_budgetMs; }
+        double HitchThresholdMs() const { return m_budgetMs * kHitchBudgets; }
+
+        // Returns the interval since the previous tick, or a negative value
+        // when there is none (first tick, or a pause longer than kMaxIntervalMs)
+        double Tick(double nowMs) {
+            const double prev = m_lastMs;
+            m_lastMs = nowMs;
+            if (m_secondStartMs < 0.0) m_secondStartMs = nowMs;
+            if (nowMs - m_secondStartMs >= 1000.0) {
+                CloseSecond();
+                m_secondStartMs = nowMs;
+            }
+            if (prev < 0.0) return -1.0;
+            const double interval = nowMs - prev;
+            if (interval < 0.0 || interval > kMaxIntervalMs) return -1.0;
+
+            const uint64_t us = static_cast<uint64_t>(interval * 1000.0 + 0.5);
+            m_second.Add(us);
+            m_session.Add(us);
+            if (interval > m_budgetMs * kOverBudgetSlack) {
+                ++m_secondOverBudget;
+                ++m_sessionOverBudget;
+            }
+            if (interval >= HitchThresholdMs()) {
+                ++m_secondHitches;
+                ++m_sessionHitches;
+            }
+            return interval;
+        }
+
+        void Reset() {
+            const double budget = m_budgetMs;
+            *this = Stream{};
+            m_budgetMs = budget;
+        }
+
+        const Histogram& Session() const { return m_session; }
+        uint64_t SessionOverBudget() const { return m_sessionOverBudget; }
+        uint64_t SessionHitches() const { return m_sessionHitches; }
+
+        // Share of session frames over budget, 0..1 (the reprojection risk)
+        double OverBudgetRatio() const {
+            return m_session.Count() ? static_cast<double>(m_sessionOverBudget) / static_cast<double>(m_session.Count()) : 0.0;
+        }
+
+        // Completed seconds, newest first (index 0 = last full second)
+        uint32_t RollupCount() const { return m_rollupCount; }
+        const SecondRollup& Rollup(uint32_t age) const {
+            return m_rollups[(m_rollupHead + kRollupSeconds - 1 - age) % kRollupSeconds];
+        }
+
+    private:
+        void CloseSecond() {
+            SecondRollup& r = m_rollups[m_rollupHead];
+            r.frames = static_cast<uint32_t>(m_second.Count());
+            r.overBudget = m_secondOverBudget;
+            r.hitches = m_secondHitches;
+            r.p50Ms = static_cast<float>(m_second.PercentileUs(50.0) / 1000.0);
+            r.p99Ms = static_cast<float>(m_second.PercentileUs(99.0) / 1000.0);
+            r.maxMs = static_cast<float>(m_second.MaxUs() / 1000.0);
+            m_rollupHead = (m_rollupHead + 1) % kRollupSeconds;
+            if (m_rollupCount < kRollupSeconds) ++m_rollupCount;
+            m_second.Clear();
+            m_secondOverBudget = 0;
+            m_secondHitches = 0;
+        }
+
+        double m_budgetMs = 1000.0 / 90.0;
+        double m_lastMs = -1.0;
+        double m_secondStartMs = -1.0;
+
+        Histogram m_second;
+        uint32_t m_secondOverBudget = 0;
+        uint32_t m_secondHitches = 0;
+
+        Histogram m_session;
+        uint64_t m_sessionOverBudget = 0;
+        uint64_t m_sessionHitches = 0;
+
+        SecondRollup m_rollups[kRollupSeconds] = {};
+        uint32_t m_rollupHead = 0;
+        uint32_t m_rollupCount = 0;
+    };
+
+    // ---- Hitch correlation ------------------------------------------------
+
+    enum class Event : uint8_t {
+        FeatureCreate = 0,  // DLSS feature / SL viewport (re)allocated
+        Resize,             // swap chain ResizeBuffers
+        ConfigApply,        // settings pushed to the manager or INI reloaded
+        Initialize,         // runtime init completed on the Present thread
+        Count
+    };
+
+    inline const char* EventName(Event e) {
+        switch (e) {
+            case Event::FeatureCreate: return "feature create";
+            case Event::Resize: return "resize";
+            case Event::ConfigApply: return "config apply";
+            case Event::Initialize: return "initialize";
+            default: return "?";
+        }
+    }
+
+    enum class StreamId : uint8_t { Present = 0, Submit };
+
+    struct Hitch {
+        double endMs = 0.0;
+        float intervalMs = 0.0f;
+        StreamId stream = StreamId::Present;
+        bool attributed = false;
+        Event cause = Event::Count;
+        float causeLeadMs = 0.0f;  // event time relative to the start of the interval
+    };
+
+    class HitchCorrelator {
+    public:
+        static constexpr uint32_t kEventCapacity = 32;
+        static constexpr uint32_t kHitchCapacity = 16;
+        // An event shortly before the stalled interval began can still be what stalled it
+        static constexpr double kLeadMs = 50.0;
+
+        void Note(Event e, double nowMs) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_events[m_eventHead] = EventRecord{ e, nowMs, 0 };
+            m_eventHead = (m_eventHead + 1) % kEventCapacity;
+            if (m_eventCount < kEventCapacity) ++m_eventCount;
+            ++m_eventTotals[static_cast<size_t>(e)];
+        }
+
+        // Attributes the hitch to the latest event inside
+        // [start - kLeadMs, end]; each event explains at most one hitch per stream
+        const Hitch& OnHitch(StreamId stream, double endMs, double intervalMs) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Hitch& h = m_hitches[m_hitchHead];
+            h = Hitch{};
+            h.endMs = endMs;
+            h.intervalMs = static_cast<float>(intervalMs);
+            h.stream = stream;
+
+            const double windowStart = endMs - intervalMs - kLeadMs;
+            const uint8_t streamBit = static_cast<uint8_t>(1u << static_cast<uint32_t>(stream));
+            for (uint32_t i = 0; i < m_eventCount; ++i) {
+                EventRecord& ev = m_events[(m_eventHead + kEventCapacity - 1 - i) % kEventCapacity];
+                if (ev.timeMs > endMs) continue;
+                if (ev.timeMs < windowStart) break;
+                if (ev.consumedBy & streamBit) continue;
+                ev.consumedBy |= streamBit;
+                h.attributed = true;
+                h.cause = ev.kind;
+                h.causeLeadMs = static_cast<float>(ev.timeMs - (endMs - intervalMs));
+                break;
+            }
+            if (h.attributed) {
+                ++m_causeCounts[static_cast<size_t>(h.cause)];
+            } else {
+                ++m_unattributed;
+            }
+            m_hitchHead = (m_hitchHead + 1) % kHitchCapacity;
+            if (m_hitchCount < kHitchCapacity) ++m_hitchCount;
+            return h;
+        }
+
+        void Reset() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_eventHead = m_eventCount = 0;
+            m_hitchHead = m_hitchCount = 0;
+            for (uint64_t& c : m_causeCounts) c = 0;
+            for (uint64_t& c : m_eventTotals) c = 0;
+            m_unattributed = 0;
+        }
+
+        // Render-thread readers (the menu); hitches are only written there too
+        uint32_t HitchCount() const { return m_hitchCount; }
+        const Hitch& RecentHitch(uint32_t age) const {
+            return m_hitches[(m_hitchHead + kHitchCapacity - 1 - age) % kHitchCapacity];
+        }
+        uint64_t CauseCount(Event e) const { return m_causeCounts[static_cast<size_t>(e)]; }
+        uint64_t Unattributed() const { return m_unattributed; }
+        uint64_t EventCount(Event e) const { return m_eventTotals[static_cast<size_t>(e)]; }
+
+    private:
+        struct EventRecord {
+            Event kind = Event::Count;
+            double timeMs = 0.0;
+            uint8_t consumedBy = 0;  // StreamId bits
+        };
+
+        std::mutex m_mutex;
+        EventRecord m_events[kEventCapacity] = {};
+        uint32_t m_eventHead = 0;
+        uint32_t m_eventCount = 0;
+
+        Hitch m_hitches[kHitchCapacity] = {};
+        uint32_t m_hitchHead = 0;
+        uint32_t m_hitchCount = 0;
+        uint64_t m_causeCounts[static_cast<size_t>(Event::Count)] = {};
+        uint64_t m_unattributed = 0;
+        uint64_t m_eventTotals[static_cast<size_t>(Event::Count)] = {};
+    };
+
+    // ---- Tracker -------------------------------------------------------
+
+    class Tracker {
+    public:
+        void SetRefreshRate(float hz) {
+            if (hz < 30.0f || hz > 500.0f) return;
+            m_refreshHz = hz;
+            m_present.SetBudgetMs(1000.0 / hz);
+            m_submit.SetBudgetMs(1000.0 / hz);
+        }
+        float RefreshRate() const { return m_refreshHz; }
+
+        void OnPresent(double nowMs) { Tick(m_present, StreamId::Present, nowMs); }
+        void OnSubmit(double nowMs) { Tick(m_submit, StreamId::Submit, nowMs); }
+
+        void Note(Event e, double nowMs) { m_correlator.Note(e, nowMs); }
+        void Note(Event e) { Note(e, NowMs()); }
+
+        void Reset() {
+            m_present.Reset();
+            m_submit.Reset();
+            m_correlator.Reset();
+        }
+
+        const Stream& Present() const { return m_present; }
+        const Stream& Submit() const { return m_submit; }
+        const HitchCorrelator& Hitches() const { return m_correlator; }
+
+    private:
+        void Tick(Stream& stream, StreamId id, double nowMs) {
+            const double interval = stream.Tick(nowMs);
+            if (interval >= stream.HitchThresholdMs()) {
+                m_correlator.OnHitch(id, nowMs, interval);
+            }
+        }
+
+        float m_refreshHz = 90.0f;
+        Stream m_present;
+        Stream m_submit;
+        HitchCorrelator m_correlator;
+    };
+
+    // Process-wide tracker shared by the hooks, the manager and the menu
+    inline Tracker& Global() {
+        static Tracker tracker;
+        return tracker;
+    }
+}
@@ -0,0 +1,271 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "dlss_camera.h"
+
+// Whether DLSS history is still valid. Resets come from events that really
+// invalidate the accumulated frames: recreated resources, a render or output
+// size change, an HMD pose jump, a break in the scene's depth distribution
+// (cell transitions, fast travel), a game load, a long gap between frames
+// (loading screens hand the HMD to the compositor) and setting changes.
+// Every other frame accumulates.
+//
+// The depth signal is a log-depth histogram over a sparse sample grid, built
+// on the GPU by shaders/DepthHistogram.hlsl (mirrors the CPU reference below;
+// keep both in sync) and read back a few frames later through the
+// DLSSReadback ring, without stalling.
+namespace DLSSHistory {
+
+    // Reset reasons, one bit each
+    namespace Reason {
+        constexpr uint32_t ResourceRecreated = 1u << 0;  // feature, render color or output recreated
+        constexpr uint32_t SizeChanged = 1u << 1;        // render or output size
+        constexpr uint32_t PoseJump = 1u << 2;           // HMD moved/turned beyond one frame's reach, or tracking came back
+        constexpr uint32_t DepthCut = 1u << 3;           // depth histogram discontinuity
+        constexpr uint32_t Loading = 1u << 4;            // game load in progress or just finished
+        constexpr uint32_t FrameGap = 1u << 5;           // eye not evaluated for a while
+        constexpr uint32_t Settings = 1u << 6;           // quality or another history-invalidating option
+        constexpr uint32_t EvaluateFailed = 1u << 7;
+        constexpr uint32_t Forced = 1u << 8;             // caller request
+    }
+    constexpr uint32_t kReasonCount = 9;
+
+    constexpr const char* ReasonName(uint32_t bit) {
+        switch (bit) {
+            case 0: return "Resource recreated";
+            case 1: return "Size changed";
+            case 2: return "Pose jump";
+            case 3: return "Depth cut";
+            case 4: return "Loading";
+            case 5: return "Frame gap";
+            case 6: return "Settings";
+            case 7: return "Evaluate failed";
+            case 8: return "Forced";
+            default: return "?";
+        }
+    }
+
+    // ---- Depth histogram -------------------------------------------------
+
+    constexpr uint32_t kDepthBins = 32;
+    constexpr uint32_t kDepthGrid = 64;       // kDepthGrid x kDepthGrid samples per eye
+    constexpr uint32_t kDepthGroupSize = 8;   // numthreads(8, 8, 1)
+    constexpr uint32_t kDepthGroups = kDepthGrid / kDepthGroupSize;
+    constexpr float kDepthOctaves = 16.0f;    // bins span z = near .. near * 2^16
+    constexpr uint32_t kDepthReadbackSlots = 3;  // DLSSReadback slots; a histogram is read two frames late
+
+    // Shader constants (register b0)
+    struct DepthParams {
+        uint32_t size[2];   // depth texels
+        uint32_t inverted;  // 1: reversed Z (near = 1)
+        uint32_t pad;
+    };
+    static_assert(sizeof(DepthParams) == 16, "DepthParams must match the HLSL cbuffer");
+
+    // Texel sampled for grid cell i along an axis of 'size' texels
+    inline uint32_t DepthSampleCoord(uint32_t i, uint32_t size) {
+        if (size == 0) return 0;
+        const uint32_t c = static_cast<uint32_t>((2ull * i + 1) * size / (2ull * kDepthGrid));
+        return c < size ? c : size - 1;
+    }
+
+    // 1 - depth (or depth when reversed) is roughly near / z for a
+    // perspective projection, so -log2 of it is log2(z / near): the bins are
+    // octaves of view distance whatever the clip planes are
+    inline uint32_t DepthBin(float depth, bool inverted) {
+        float k = inverted ? depth : 1.0f - depth;
+        if (!(k > 1e-7f)) k = 1e-7f;
+        if (k > 1.0f) k = 1.0f;
+        const float bin = -std::log2(k) * (static_cast<float>(kDepthBins) / kDepthOctaves);
+        return bin >= static_cast<float>(kDepthBins - 1) ? kDepthBins - 1 : static_cast<uint32_t>(bin);
+    }
+
+    // CPU reference of the shader: row-major depth, one float per texel
+    inline void BuildDepthHistogram(const float* depth, uint32_t width, uint32_t height, bool inverted, uint32_t bins[kDepthBins]) {
+        std::memset(bins, 0, sizeof(uint32_t) * kDepthBins);
+        if (!depth || width == 0 || height == 0) return;
+        for (uint32_t gy = 0; gy < kDepthGrid; ++gy) {
+            const uint32_t y = DepthSampleCoord(gy, height);
+            for (uint32_t gx = 0; gx < kDepthGrid; ++gx) {
+                ++bins[DepthBin(depth[static_cast<size_t>(y) * width + DepthSampleCoord(gx, width)], inverted)];
+            }
+        }
+    }
+
+    inline uint64_t HistogramTotal(const uint32_t bins[kDepthBins]) {
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < kDepthBins; ++i) total += bins[i];
+        return total;
+    }
+
+    // Total variation distance of the normalised histograms: 0 identical,
+    // 1 disjoint; negative when either is empty
+    inline float HistogramDistance(const uint32_t a[kDepthBins], const uint32_t b[kDepthBins]) {
+        const uint64_t ta = HistogramTotal(a);
+        const uint64_t tb = HistogramTotal(b);
+        if (ta == 0 || tb == 0) return -1.0f;
+        double sum = 0.0;
+        for (uint32_t i = 0; i < kDepthBins; ++i) {
+            sum += std::fabs(static_cast<double>(a[i]) / ta - static_cast<double>(b[i]) / tb);
+        }
+        return static_cast<float>(sum * 0.5);
+    }
+
+    // ---- Pose ------------------------------------------------------------
+
+    // Rotation angle between the 3x3 parts of two rigid transforms, degrees
+    inline float RotationDeltaDeg(const DLSSCamera::Float4x4& a, const DLSSCamera::Float4x4& b) {
+        // trace(A * B^T) = 1 + 2 cos(angle)
+        float trace = 0.0f;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) trace += a.m[i][j] * b.m[i][j];
+        }
+        float c = (trace - 1.0f) * 0.5f;
+        c = c < -1.0f ? -1.0f : (c > 1.0f ? 1.0f : c);
+        return std::acos(c) * (180.0f / 3.14159265f);
+    }
+
+    inline float TranslationDelta(const DLSSCamera::Float4x4& a, const DLSSCamera::Float4x4& b) {
+        const float dx = a.m[3][0] - b.m[3][0];
+        const float dy = a.m[3][1] - b.m[3][1];
+        const float dz = a.m[3][2] - b.m[3][2];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    // ---- Tracker ---------------------------------------------------------
+
+    struct Thresholds {
+        float maxTranslation = 0.2f;        // HMD metres per frame
+        float maxRotationDeg = 15.0f;       // HMD degrees per frame
+        float depthCut = 0.4f;              // HistogramDistance that counts as a camera cut
+        uint32_t depthMinSamples = 1024;    // smaller histograms are ignored
+        uint32_t maxGapMs = 250;            // longer without an evaluate: history is stale
+        uint32_t loadingSettleFrames = 2;   // frames after a load that still reset
+    };
+
+    struct FrameInput {
+        uint32_t renderWidth = 0;
+        uint32_t renderHeight = 0;
+        uint32_t outputWidth = 0;
+        uint32_t outputHeight = 0;
+        uint64_t timeMs = 0;                  // monotonic
+        bool loading = false;
+        bool havePose = false;
+        DLSSCamera::Float4x4 headToWorld = DLSSCamera::Identity();
+        const uint32_t* depthBins = nullptr;  // histogram that arrived this frame (kDepthBins), or nullptr
+    };
+
+    struct Decision {
+        bool reset = false;
+        uint32_t reasons = 0;
+        float translation = 0.0f;     // HMD pose delta since the previous frame
+        float rotationDeg = 0.0f;
+        float depthDistance = -1.0f;  // negative: no histogram compared this frame
+    };
+
+    // One per eye. Update once per evaluated frame; Invalidate records events
+    // seen elsewhere (recreated resources, settings) for the next Update.
+    class Tracker {
+    public:
+        void SetThresholds(const Thresholds& thresholds) { m_thresholds = thresholds; }
+        const Thresholds& GetThresholds() const { return m_thresholds; }
+
+        void Invalidate(uint32_t reasons) { m_pending |= reasons; }
+
+        Decision Update(const FrameInput& in) {
+            Decision d{};
+            uint32_t reasons = m_pending;
+            m_pending = 0;
+
+            if (m_havePrev) {
+                if (in.renderWidth != m_renderWidth || in.renderHeight != m_renderHeight ||
+                    in.outputWidth != m_outputWidth || in.outputHeight != m_outputHeight) {
+                    reasons |= Reason::SizeChanged;
+                }
+                if (in.timeMs > m_lastTimeMs && in.timeMs - m_lastTimeMs > m_thresholds.maxGapMs) {
+                    reasons |= Reason::FrameGap;
+                }
+            } else {
+                reasons |= Reason::ResourceRecreated;  // nothing accumulated yet
+            }
+
+            if (in.loading) {
+                reasons |= Reason::Loading;
+                m_settleFrames = m_thresholds.loadingSettleFrames;
+            } else if (m_settleFrames > 0) {
+                --m_settleFrames;
+                reasons |= Reason::Loading;
+            }
+
+            if (in.havePose) {
+                if (m_prevPose) {
+                    d.translation = TranslationDelta(in.headToWorld, m_headToWorld);
+                    d.rotationDeg = RotationDeltaDeg(in.headToWorld, m_headToWorld);
+                    if (d.translation > m_thresholds.maxTranslation || d.rotationDeg > m_thresholds.maxRotationDeg) {
+                        reasons |= Reason::PoseJump;
+                    }
+                } else if (m_hadPose) {
+                    reasons |= Reason::PoseJump;  // tracking regained: the last known pose is stale
+                }
+                m_headToWorld = in.headToWorld;
+                m_hadPose = true;
+            }
+            m_prevPose = in.havePose;
+
+            if (in.depthBins && HistogramTotal(in.depthBins) >= m_thresholds.depthMinSamples) {
+                if (m_haveBins) {
+                    d.depthDistance = HistogramDistance(in.depthBins, m_bins);
+                    if (d.depthDistance > m_thresholds.depthCut) reasons |= Reason::DepthCut;
+                }
+                std::memcpy(m_bins, in.depthBins, sizeof(m_bins));
+                m_haveBins = true;
+            }
+
+            m_havePrev = true;
+            m_renderWidth = in.renderWidth;
+            m_renderHeight = in.renderHeight;
+            m_outputWidth = in.outputWidth;
+            m_outputHeight = in.outputHeight;
+            m_lastTimeMs = in.timeMs;
+
+            ++m_frames;
+            d.reasons = reasons;
+            d.reset = reasons != 0;
+            if (d.reset) {
+                ++m_resets;
+                m_lastReasons = reasons;
+                for (uint32_t i = 0; i < kReasonCount; ++i) {
+                    if (reasons & (1u << i)) ++m_reasonCounts[i];
+                }
+            }
+            return d;
+        }
+
+        uint64_t Frames() const { return m_frames; }
+        uint64_t Resets() const { return m_resets; }
+        uint64_t ResetCount(uint32_t bit) const { return bit < kReasonCount ? m_reasonCounts[bit] : 0; }
+        uint32_t LastResetReasons() const { return m_lastReasons; }
+
+    private:
+        Thresholds m_thresholds;
+        uint32_t m_pending = 0;
+        bool m_havePrev = false;
+        uint32_t m_renderWidth = 0;
+        uint32_t m_renderHeight = 0;
+        uint32_t m_outputWidth = 0;
+        uint32_t m_outputHeight = 0;
+        uint64_t m_lastTimeMs = 0;
+        uint32_t m_settleFrames = 0;
+        bool m_prevPose = false;
+        bool m_hadPose = false;
+        DLSSCamera::Float4x4 m_headToWorld = DLSSCamera::Identity();
+        uint32_t m_bins[kDepthBins] = {};
+        bool m_haveBins = false;
+        uint64_t m_frames = 0;
+        uint64_t m_resets = 0;
+        uint64_t m_reasonCounts[kReasonCount] = {};
+        uint32_t m_lastReasons = 0;
+    };
+}
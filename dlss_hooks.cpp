@@ -1,6 +1,17 @@
 #include "dlss_hooks.h"
 #include "dlss_manager.h"
 #include "dlss_config.h"
+#include "dlss_cbuffer.h"
+#include "dlss_redirect.h"
+#include "dlss_passgraph.h"
+#include "dlss_overlay.h"
+#include "dlss_input.h"
+#include "dlss_frametiming.h"
+#include "dlss_telemetry.h"
+#include "dlss_vram.h"
+#include "dlss_atlas.h"
+#include "dlss_ctxstate.h"
+#include "dlss_arena.h"
 #include "common/IDebugLog.h"
 
 #include "third_party/imgui/imgui.h"
@@ -30,6 +41,7 @@ extern "C" {
     void ProcessImGuiHotkeys();
     void UpdateImGuiMetrics(float deltaTime);
     void SyncImGuiMenuFromConfig();
+    bool IsImGuiMenuVisible();
 }
 
 extern LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
@@ -50,8 +62,17 @@ namespace {
     bool g_imguiBackendInitialized = false;
     bool g_imguiMenuInitialized = false;
     bool g_overlaySafeMode = false;
-
-    LARGE_INTEGER g_perfFrequency = {
+    std::atomic<bool> g_gameLoading{false};
+
+    LARGE_INTEGER g_perfFrequency = {};
+    DLSSOverlay::Scheduler g_overlayScheduler;
+    DLSSOverlay::CpuStats g_overlayStats;
+    // Set by the WndProc on window input; consumed by the overlay scheduler
+    std::atomic<bool> g_overlayInputPending{false};
+    // Shared-memory telemetry for external monitors, published once per Present
+    DLSSTelemetry::Channel g_telemetry;
+    bool g_telemetryAttempted = false;
+    uint64_t g_presentCount = 0;
     // Helper to fetch texture desc from RTV (if possible)
     static bool GetDescFromRTV(ID3D11RenderTargetView* rtv, D3D11_TEXTURE2D_DESC* outDesc) {
         if (!rtv || !outDesc) return false;
@@ -66,7 +87,6 @@ namespace {
         tex->Release();
         return true;
     }
-};
     LARGE_INTEGER g_lastFrameTime = {};
 
     bool g_initializedGlobals = false;
@@ -90,20 +110,50 @@ namespace {
     std::atomic<DlssState> g_state{DlssState::Cold};
     static ID3D11Texture2D* g_upscaledEyeTex[2] = { nullptr, nullptr };
     std::atomic<bool> g_lastEvaluateOk{false};
-    // Phase 1 (viewport clamp) state
-    std::atomic<bool> g_sceneActive{false};
-    D3D11_TEXTURE2D_DESC g_sceneRTDesc{};
-    int g_clampLogBudgetPerFrame = 4;\n    bool g_compositedThisFrame = false;
-    // Phase 2 (RT redirect) state and cache
-    std::atomic<bool> g_redirectUsedThisFrame{false};
+    // Phase 1 (viewport clamp) and phase 2 (RT redirect) state per device
+    // context: the context hooks also fire on deferred contexts (overlays,
+    // our own pass recorder) on other threads
+    DLSSContextState::Table g_contextStates;
+    DLSSContextState::FrameFlags g_lastFrameFlags{};  // immediate context, last completed frame
+    static_assert(sizeof(D3D11_VIEWPORT) == sizeof(DLSSContextState::Viewport), "viewports are stored as DLSSContextState::Viewport");
+    static_assert(sizeof(D3D11_RECT) == sizeof(DLSSContextState::ScissorRect), "scissors are stored as DLSSContextState::ScissorRect");
+    static_assert(sizeof(D3D11_RECT) == sizeof(DLSSRedirect::Rect), "scissors are scaled as DLSSRedirect::Rect");
+    // Phase 2 (RT redirect) cache
     struct RedirectEntry {
         ID3D11Texture2D* smallTex = nullptr;
         ID3D11RenderTargetView* smallRTV = nullptr;
+        ID3D11DepthStencilView* smallDSV = nullptr;
         UINT smallW = 0, smallH = 0;
-        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;      // the big texture's
+        DXGI_FORMAT viewFormat = DXGI_FORMAT_UNKNOWN;  // the game's RTV/DSV format
+        UINT slice = 0;           // array slice of the big texture the twin stands for (mip 0)
+        bool arrayView = false;   // the game binds it through a TEXTURE2DARRAY view
+        ID3D11RenderTargetView* bigRTV = nullptr;  // of that subresource, lazily created for composites
+        ID3D11DepthStencilView* bigDSV = nullptr;
+        uint64_t useFrame = 0;  // DLSSVram frame of the last bind
     };
     static std::unordered_map<ID3D11Texture2D*, RedirectEntry> g_redirectMap;
     static std::mutex g_redirectMutex;
+    // Per-frame storage of the immediate-context hooks (binding table, pass
+    // graph), reset in Present; declared before its users
+    DLSSArena::FrameArena g_frameArena;
+    DLSSRedirect::BindingTable g_bindingTable{g_frameArena};
+    thread_local bool g_inRedirectComposite = false;  // our own blit is running on this thread, hooks pass through
+    DLSSRedirect::PassStats g_lastRedirectStats{};
+    // Pass graph (scene/post/HUD classification), fed by the immediate-context hooks
+    DLSSPassGraph::FrameGraph g_passGraph{g_frameArena};
+    DLSSPassGraph::FrameStats g_lastPassGraphStats{};
+    bool g_passGraphEnabled = false;       // refreshed once per frame in Present
+
+    // Camera cbuffer detection/patching. Map/Unmap/UpdateSubresource also run
+    // on deferred contexts, so the classifier and the map shadows share a lock.
+    std::mutex g_cbMutex;
+    DLSSCBuffer::Classifier g_cbClassifier;
+    DLSSCBuffer::MapShadows g_cbMapShadows;
+    // Open shadows, refreshed under g_cbMutex: Unmap skips the lock while
+    // none is open (patching off, or no map in flight). A context's own
+    // Map and Unmap run on one thread, so it always sees its own shadow.
+    std::atomic<uint32_t> g_cbOpenShadows{0};
 
 
     void SafeAssignTexture(ID3D11Texture2D*& target, ID3D11Texture2D* source) {
@@ -123,7 +173,14 @@ namespace {
     }
 
     LRESULT CALLBACK ImGuiWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
-        if (ImGui_ImplWin32_WndProcHandler(hwnd, msg, wParam, lParam)) {
+        if ((msg >= WM_KEYFIRST && msg <= WM_KEYLAST) || (msg >= WM_MOUSEFIRST && msg <= WM_MOUSELAST) ||
+            msg == WM_SETFOCUS || msg == WM_KILLFOCUS) {
+            g_overlayInputPending.store(true, std::memory_order_relaxed);
+        }
+        DLSSInput::OnWindowMessage(msg, wParam, lParam);
+        // A hidden menu gets no input: ImGui only sees the events of the next
+        // frame it renders, so anything queued while hidden would pile up
+        if (IsImGuiMenuVisible() && ImGui_ImplWin32_WndProcHandler(hwnd, msg, wParam, lParam)) {
             return TRUE;
         }
 
@@ -178,7 +235,28 @@ namespace DLSSHooks {
     PFN_CreateTexture2D RealCreateTexture2D = nullptr;
     PFN_FactoryCreateSwapChain RealFactoryCreateSwapChain = nullptr;
     PFN_RSSetViewports RealRSSetViewports = nullptr;
+    PFN_RSSetScissorRects RealRSSetScissorRects = nullptr;
     PFN_OMSetRenderTargets RealOMSetRenderTargets = nullptr;
+    PFN_UpdateSubresource RealUpdateSubresource = nullptr;
+    PFN_Map RealMap = nullptr;
+    PFN_Unmap RealUnmap = nullptr;
+    PFN_ClearRenderTargetView RealClearRenderTargetView = nullptr;
+    PFN_ClearDepthStencilView RealClearDepthStencilView = nullptr;
+    PFN_CopyResource RealCopyResource = nullptr;
+    PFN_CopySubresourceRegion RealCopySubresourceRegion = nullptr;
+    PFN_ResolveSubresource RealResolveSubresource = nullptr;
+    PFN_PSSetShaderResources RealPSSetShaderResources = nullptr;
+    PFN_SetShaderResources RealVSSetShaderResources = nullptr;
+    PFN_SetShaderResources RealGSSetShaderResources = nullptr;
+    PFN_SetShaderResources RealHSSetShaderResources = nullptr;
+    PFN_SetShaderResources RealDSSetShaderResources = nullptr;
+    PFN_SetShaderResources RealCSSetShaderResources = nullptr;
+    PFN_DrawIndexed RealDrawIndexed = nullptr;
+    PFN_Draw RealDraw = nullptr;
+    PFN_DrawIndexedInstanced RealDrawIndexedInstanced = nullptr;
+    PFN_DrawInstanced RealDrawInstanced = nullptr;
+    PFN_ExecuteCommandList RealExecuteCommandList = nullptr;
+    PFN_FinishCommandList RealFinishCommandList = nullptr;
 
     static void InitializeImGuiBackend(IDXGISwapChain* swapChain) {
         if (g_imguiBackendInitialized || !swapChain || !g_device || !g_context) {
@@ -222,6 +300,10 @@ namespace DLSSHooks {
         if (!g_originalWndProc && !g_overlaySafeMode) {
             g_originalWndProc = reinterpret_cast<WNDPROC>(
                 SetWindowLongPtr(hwnd, GWLP_WNDPROC, reinterpret_cast<LONG_PTR>(ImGuiWndProc)));
+            DLSSInput::SetWindowSourceActive(g_originalWndProc != nullptr);
+        } else if (g_overlaySafeMode) {
+            // No WndProc hook: hotkeys come from raw input, or polling if the game owns it
+            DLSSInput::StartRawInputSink();
         }
 
         if (g_perfFrequency.QuadPart == 0) {
@@ -264,19 +346,146 @@ namespace DLSSHooks {
         }
 
         g_originalWndProc = nullptr;
+        DLSSInput::SetWindowSourceActive(false);
+        DLSSInput::StopRawInputSink();
         g_imguiWindow = nullptr;
         g_imguiBackendInitialized = false;
         g_imguiMenuInitialized = false;
+        g_overlayScheduler = DLSSOverlay::Scheduler{};  // cached draw data died with the context
         g_lastFrameTime.QuadPart = 0;
     }
 
+    static void PublishTelemetry() {
+        if (!g_telemetryAttempted) {
+            g_telemetryAttempted = true;
+            if (g_dlssConfig && g_dlssConfig->telemetrySharedMemory) {
+                if (g_telemetry.Create()) {
+                    _MESSAGE("[Telemetry] Shared-memory channel %s v%u (%u bytes)", DLSSTelemetry::kChannelName,
+                             DLSSTelemetry::kVersion, (unsigned)sizeof(DLSSTelemetry::SharedBlock));
+                } else {
+                    _MESSAGE("[Telemetry] Could not create shared-memory channel (err=%lu)", GetLastError());
+                }
+            }
+        }
+        if (!g_telemetry.Block()) {
+            return;
+        }
+
+        DLSSTelemetry::Payload payload{};
+        payload.frame = g_presentCount;
+        payload.writerTimeMs = DLSSFrameTiming::NowMs();
+        payload.state = static_cast<uint32_t>(g_state.load(std::memory_order_relaxed));
+        if (g_dlssManager) {
+            g_dlssManager->FillTelemetry(payload);
+        }
+        const DLSSFrameTiming::Tracker& timing = DLSSFrameTiming::Global();
+        const DLSSFrameTiming::Stream& present = timing.Present();
+        payload.presentP50Ms = static_cast<float>(present.Session().PercentileUs(50.0) / 1000.0);
+        payload.presentP99Ms = static_cast<float>(present.Session().PercentileUs(99.0) / 1000.0);
+        payload.overBudgetPercent = static_cast<float>(present.OverBudgetRatio() * 100.0);
+        payload.hitches = present.SessionHitches();
+        payload.featureCreates = timing.Hitches().EventCount(DLSSFrameTiming::Event::FeatureCreate);
+        const DLSSVram::Snapshot vram = DLSSVram::Global().Take();
+        payload.vramBytes = vram.currentBytes;
+        payload.vramPeakBytes = vram.peakBytes;
+        payload.vramBudgetBytes = vram.budgetBytes;
+        DLSSTelemetry::Publish(*g_telemetry.Block(), payload);
+    }
+
 HRESULT WINAPI HookedPresent(IDXGISwapChain* pSwapChain, UINT SyncInterval, UINT Flags) {
+        if (g_perfFrequency.QuadPart == 0) {
+            QueryPerformanceFrequency(&g_perfFrequency);
+        }
+        LARGE_INTEGER hookStart{};
+        QueryPerformanceCounter(&hookStart);
+        DLSSFrameTiming::Global().OnPresent(DLSSFrameTiming::NowMs());
         EnsureGlobalInstances();
         EnsureVRSubmitHookInstalled();
-        // Reset Phase 1 scene/clamp state per frame
-        g_sceneActive.store(false, std::memory_order_relaxed);
-        g_sceneRTDesc = {};
-        g_clampLogBudgetPerFrame = 4;`r`n        g_compositedThisFrame = false;`r`n        g_redirectUsedThisFrame.store(false, std::memory_order_relaxed);
+        // Close the frame's scene/clamp facts (command lists executed on the
+        // immediate context are merged in by now); every context starts over
+        if (DLSSContextState::Lease cs = g_contextStates.Acquire(reinterpret_cast<uintptr_t>(g_context))) {
+            g_lastFrameFlags = cs->flags;
+        }
+        g_contextStates.BeginFrame();
+        {
+            static uint32_t s_ctxLogCounter = 0;
+            const DLSSContextState::Stats cst = g_contextStates.GetStats();
+            if (cst.contexts > 1 && g_dlssConfig && g_dlssConfig->debugEarlyDlss && (++s_ctxLogCounter % 300) == 0) {
+                _MESSAGE("[EarlyDLSS][Contexts] contexts=%u claims=%llu full=%llu listsMerged=%llu | scene=%d redirect=%d composited=%d clamped=%u",
+                    cst.contexts, (unsigned long long)cst.claims, (unsigned long long)cst.tableFull, (unsigned long long)cst.listsMerged,
+                    g_lastFrameFlags.sceneActive ? 1 : 0, g_lastFrameFlags.redirectUsed ? 1 : 0,
+                    g_lastFrameFlags.composited ? 1 : 0, g_lastFrameFlags.clampedViewports);
+            }
+        }
+        {
+            const DLSSRedirect::PassStats& rs = g_bindingTable.Stats();
+            static uint32_t s_rdLogCounter = 0;
+            if (rs.redirectedBinds > 0 && g_dlssConfig && g_dlssConfig->debugEarlyDlss && (++s_rdLogCounter % 300) == 0) {
+                _MESSAGE("[EarlyDLSS][Passes] redirected=%u (%llu px) native=%u (%llu px) composites=%u clears=%u copies=%u saved=%.1f MB",
+                    rs.redirectedBinds, (unsigned long long)rs.redirectedPixels,
+                    rs.nativeBinds, (unsigned long long)rs.nativePixels, rs.composites,
+                    rs.translatedClears, rs.translatedCopies, (double)rs.bytesSaved / (1024.0 * 1024.0));
+            }
+            g_lastRedirectStats = rs;
+            g_bindingTable.BeginFrame();
+            if (DLSSContextState::Lease cs = g_contextStates.Acquire(reinterpret_cast<uintptr_t>(g_context))) {
+                cs->redirectBindActive = false;
+            }
+        }
+        {
+            // Classify the finished frame's passes; the next frame's binds reuse the result
+            if (g_perfFrequency.QuadPart == 0) {
+                QueryPerformanceFrequency(&g_perfFrequency);
+            }
+            LARGE_INTEGER t0{}, t1{};
+            QueryPerformanceCounter(&t0);
+            g_lastPassGraphStats = g_passGraph.EndFrame();
+            QueryPerformanceCounter(&t1);
+            static uint32_t s_pgLogCounter = 0;
+            if (g_passGraphEnabled && g_dlssConfig->debugEarlyDlss && (++s_pgLogCounter % 300) == 0) {
+                const DLSSPassGraph::FrameStats& ps = g_lastPassGraphStats;
+                _MESSAGE("[EarlyDLSS][Graph] passes=%u edges=%u draws=%u match idx=%u sig=%u new=%u | shadow=%u gbuf=%u light=%u post=%u hud=%u unk=%u | classify=%.1f us",
+                    ps.passes, ps.edges, ps.draws, ps.matchedByIndex, ps.matchedBySignature, ps.unmatched,
+                    ps.counts[(int)DLSSPassGraph::PassClass::Shadow], ps.counts[(int)DLSSPassGraph::PassClass::GBuffer],
+                    ps.counts[(int)DLSSPassGraph::PassClass::Lighting], ps.counts[(int)DLSSPassGraph::PassClass::Post],
+                    ps.counts[(int)DLSSPassGraph::PassClass::HUD], ps.counts[(int)DLSSPassGraph::PassClass::Unknown],
+                    (double)(t1.QuadPart - t0.QuadPart) * 1e6 / (double)g_perfFrequency.QuadPart);
+            }
+            const bool enable = g_dlssConfig && g_dlssConfig->earlyDlssEnabled && g_dlssConfig->earlyDlssPassGraph;
+            if (!enable && g_passGraphEnabled) {
+                g_passGraph.Clear();
+            }
+            g_passGraphEnabled = enable;
+        }
+        {
+            // Everything the hooks kept for the frame is done with
+            g_frameArena.Reset();
+            static uint32_t s_arenaLogCounter = 0;
+            if (g_dlssConfig && g_dlssConfig->debugEarlyDlss && (++s_arenaLogCounter % 300) == 0) {
+                const DLSSArena::Stats as = g_frameArena.GetStats();
+                _MESSAGE("[EarlyDLSS][Arena] capacity=%zu KB peak=%zu KB spills=%llu grows=%llu",
+                    as.capacity / 1024, as.peak / 1024, (unsigned long long)as.spills, (unsigned long long)as.grows);
+            }
+        }
+        {
+            // Close the cbuffer stats for the frame; patches of the next frame re-arm injection
+            DLSSCBuffer::Classifier::FrameStats cbStats;
+            size_t cbTracked = 0;
+            {
+                std::lock_guard<std::mutex> lock(g_cbMutex);
+                cbStats = g_cbClassifier.EndFrame();
+                cbTracked = g_cbClassifier.TrackedBuffers();
+            }
+            if (g_dlssManager) {
+                g_dlssManager->GetCameraProvider().SetJitterInjectionActive(false);
+            }
+            static uint32_t s_cbLogCounter = 0;
+            if (g_dlssConfig && g_dlssConfig->debugEarlyDlss && (++s_cbLogCounter % 300) == 0) {
+                _MESSAGE("[Camera][CB] scanned=%llu B classified=%u fast=%u patched=%u tracked=%zu",
+                    (unsigned long long)cbStats.bytesScanned, cbStats.buffersClassified,
+                    cbStats.fastPathHits, cbStats.patchesApplied, cbTracked);
+            }
+        }
         if (g_pendingResizeHook && pSwapChain && !g_resizeHookInstalled) {
             if (InstallResizeHook(pSwapChain)) {
                 _MESSAGE("Deferred IDXGISwapChain::ResizeBuffers hook installed");
@@ -300,7 +509,10 @@ HRESULT WINAPI HookedPresent(IDXGISwapChain* pSwapChain, UINT SyncInterval, UINT
         }
 
         if (g_dlssManager && g_device && g_context && !g_dlssRuntimeInitialized) {
-            if (g_dlssManager->Initialize()) {
+            // Runtime load/probing/shader compile run on a worker; the device-bound
+            // tail completes here once it is prepared. Submit passes native frames until then.
+            g_dlssManager->BeginAsyncInitialize();
+            if (g_dlssManager->PollInitialize()) {
                 _MESSAGE("DLSS features initialized from Present hook");
                 g_dlssRuntimeInitialized = true;
                 g_state.store(DlssState::HaveDlss, std::memory_order_relaxed);
@@ -317,28 +529,58 @@ HRESULT WINAPI HookedPresent(IDXGISwapChain* pSwapChain, UINT SyncInterval, UINT
             }
         }
 
+        DLSSOverlay::Action overlayAction = DLSSOverlay::Action::Skip;
         if (g_imguiBackendInitialized) {
             const float deltaMs = ComputeFrameDeltaMs();
-            const float deltaSeconds = deltaMs > 0.0f ? deltaMs / 1000.0f : 1.0f / 60.0f;
-
-            ImGui_ImplDX11_NewFrame();
-            ImGui_ImplWin32_NewFrame();
-            ImGuiIO& io = ImGui::GetIO();
-            io.DeltaTime = deltaSeconds;
-
-            ImGui::NewFrame();
+            LARGE_INTEGER now{};
+            QueryPerformanceCounter(&now);
+            const double nowMs = (double)now.QuadPart * 1000.0 / (double)g_perfFrequency.QuadPart;
 
+            // Hotkeys and metrics do not need an ImGui frame
             if (g_imguiMenuInitialized) {
                 ProcessImGuiHotkeys();
                 UpdateImGuiMetrics(deltaMs);
+            }
+
+            const double lastBuildMs = g_overlayScheduler.LastBuildMs();
+            g_overlayScheduler.SetRedrawRate(g_dlssConfig ? g_dlssConfig->menuRedrawRate : 30);
+            overlayAction = g_overlayScheduler.Next(g_imguiMenuInitialized && IsImGuiMenuVisible(),
+                g_overlayInputPending.exchange(false, std::memory_order_relaxed), nowMs);
+
+            if (overlayAction == DLSSOverlay::Action::Rebuild) {
+                const double sinceBuildMs = nowMs - lastBuildMs;
+                ImGui_ImplDX11_NewFrame();
+                ImGui_ImplWin32_NewFrame();
+                ImGuiIO& io = ImGui::GetIO();
+                io.DeltaTime = (lastBuildMs > 0.0 && sinceBuildMs > 0.0 && sinceBuildMs < 1000.0)
+                    ? static_cast<float>(sinceBuildMs / 1000.0) : 1.0f / 60.0f;
+
+                ImGui::NewFrame();
                 RenderImGuiMenu();
+                ImGui::Render();
+            }
+            // Draw data stays valid until the next NewFrame, so a replay is just the draw
+            if (overlayAction != DLSSOverlay::Action::Skip) {
+                if (ImDrawData* drawData = ImGui::GetDrawData()) {
+                    ImGui_ImplDX11_RenderDrawData(drawData);
+                }
             }
+        }
 
-            ImGui::Render();
-            if (ImDrawData* drawData = ImGui::GetDrawData()) {
-                ImGui_ImplDX11_RenderDrawData(drawData);
+        ++g_presentCount;
+        {
+            const DLSSVram::TrimResult trim = DLSSVram::Global().EndFrame();
+            if (trim.ran) {
+                _MESSAGE("[VRAM] Plugin allocations over budget (%.1f / %.1f MB); trimmed idle caches to %.1f MB",
+                         (double)trim.beforeBytes / (1024.0 * 1024.0), (double)trim.budgetBytes / (1024.0 * 1024.0),
+                         (double)trim.afterBytes / (1024.0 * 1024.0));
             }
         }
+        PublishTelemetry();
+
+        LARGE_INTEGER hookEnd{};
+        QueryPerformanceCounter(&hookEnd);
+        g_overlayStats.Add(overlayAction, (float)((double)(hookEnd.QuadPart - hookStart.QuadPart) * 1e6 / (double)g_perfFrequency.QuadPart));
 
         return RealPresent
             ? RealPresent(pSwapChain, SyncInterval, Flags)
@@ -352,6 +594,7 @@ HRESULT WINAPI HookedPresent(IDXGISwapChain* pSwapChain, UINT SyncInterval, UINT
         DXGI_FORMAT NewFormat,
         UINT SwapChainFlags) {
         _MESSAGE("ResizeBuffers called: %ux%u", Width, Height);
+        DLSSFrameTiming::Global().Note(DLSSFrameTiming::Event::Resize);
 
         if (g_imguiBackendInitialized) {
             ShutdownImGuiBackend();
@@ -372,12 +615,9 @@ HRESULT WINAPI HookedPresent(IDXGISwapChain* pSwapChain, UINT SyncInterval, UINT
         if (SUCCEEDED(result)) {
             g_swapChain = pSwapChain;
 
-            if (g_dlssManager && g_dlssManager->IsEnabled()) {
-                if (g_dlssManager->Initialize()) {
-                    _MESSAGE("DLSS features re-initialized after resize");
-                    g_dlssRuntimeInitialized = true;
-                    g_state.store(DlssState::HaveDlss, std::memory_order_relaxed);
-                }
+            if (g_dlssManager && g_dlssManager->IsEnabled() && g_dlssManager->BeginAsyncInitialize()) {
+                // Completed by PollInitialize from Present/Submit
+                _MESSAGE("DLSS re-initialization scheduled after resize");
             }
         }
 
@@ -544,6 +784,10 @@ namespace {
             return vr::VRCompositorError_RequestFailed;
         }
 
+        if (eye == vr::Eye_Left) {
+            DLSSFrameTiming::Global().OnSubmit(DLSSFrameTiming::NowMs());
+        }
+
         if (!texture) {
             return g_realVRSubmit(self, eye, texture, bounds, flags);
         }
@@ -564,7 +808,8 @@ namespace {
                 std::lock_guard<std::mutex> lock(g_redirectMutex);
                 // Look up by big color texture key
                 auto it = g_redirectMap.find(colorTexture);
-                if (it != g_redirectMap.end() && it->second.smallTex) {
+                if (it != g_redirectMap.end() && it->second.smallTex &&
+                    g_bindingTable.IsRedirected(reinterpret_cast<uintptr_t>(colorTexture))) {
                     candidateSmall = it->second.smallTex;
                     if (g_dlssConfig->debugEarlyDlss) {
                         _MESSAGE("[EarlyDLSS][Submit] Using small RT as DLSS input");
@@ -574,6 +819,14 @@ namespace {
             if (candidateSmall) {
                 colorTexture = candidateSmall;
             }
+            // Depth rendered into its twin this frame: hand DLSS the render-size depth as well
+            if (depthTexture && g_bindingTable.IsRedirected(reinterpret_cast<uintptr_t>(depthTexture))) {
+                std::lock_guard<std::mutex> lock(g_redirectMutex);
+                auto it = g_redirectMap.find(depthTexture);
+                if (it != g_redirectMap.end() && it->second.smallTex) {
+                    depthTexture = it->second.smallTex;
+                }
+            }
         }
         const bool dlssReady = EnsureDLSSRuntimeReady();
 
@@ -625,7 +878,7 @@ namespace {
                 // Log at a low rate to avoid spam
                 if ((s_dbgCounter % 300) == 1) {
                     uint32_t prW = 0, prH = 0;
-                    if (g_dlssManager && g_dlssManager->ComputeRenderSizeForOutput(recW, recH, prW, prH)) {
+                    if (g_dlssManager && g_dlssManager->ComputeRenderSizeForOutput(idx, recW, recH, prW, prH)) {
                         _MESSAGE("[EarlyDLSS][DBG] eye=%s out=%ux%u -> predicted render=%ux%u (mode=%d)",
                                  (eye==vr::Eye_Left?"L":"R"), recW, recH, prW, prH, (int)g_dlssConfig->earlyDlssMode);
                     } else {
@@ -677,32 +930,71 @@ namespace {
                               g_lastEvaluateOk.load(std::memory_order_relaxed) &&
                               processedTexture && (processedTexture != colorTexture);
 
+        // Stereo atlas: the processed texture holds both eyes; this eye's region is compared and submitted
+        const int eyeIdx = (eye == vr::Eye_Left) ? 0 : 1;
+        DLSSAtlas::Layout atlasLayout;
+        const bool fromAtlas = canUseUpscaled && g_dlssManager->GetAtlasLayout(processedTexture, atlasLayout);
         if (canUseUpscaled) {
             D3D11_TEXTURE2D_DESC inDesc{}; colorTexture->GetDesc(&inDesc);
             D3D11_TEXTURE2D_DESC outDesc{}; processedTexture->GetDesc(&outDesc);
+            const uint32_t outW = fromAtlas ? atlasLayout.eyes[eyeIdx].width : outDesc.Width;
+            const uint32_t outH = fromAtlas ? atlasLayout.eyes[eyeIdx].height : outDesc.Height;
             if (outDesc.SampleDesc.Count != 1 ||
-                outDesc.Width != inDesc.Width ||
-                outDesc.Height != inDesc.Height) {
+                outW != inDesc.Width ||
+                outH != inDesc.Height) {
                 canUseUpscaled = false;
             }
         }
 
         if (canUseUpscaled) {
+            vr::VRTextureBounds_t atlasBounds{};
+            const vr::VRTextureBounds_t* submitBounds = bounds;
+            if (fromAtlas) {
+                DLSSAtlas::Bounds inner{};
+                if (bounds) {
+                    inner.uMin = bounds->uMin; inner.vMin = bounds->vMin;
+                    inner.uMax = bounds->uMax; inner.vMax = bounds->vMax;
+                }
+                const DLSSAtlas::Bounds b = DLSSAtlas::EyeBounds(atlasLayout, eyeIdx, bounds ? &inner : nullptr);
+                atlasBounds.uMin = b.uMin; atlasBounds.vMin = b.vMin;
+                atlasBounds.uMax = b.uMax; atlasBounds.vMax = b.vMax;
+                submitBounds = &atlasBounds;
+            }
+
             if (flags & vr::Submit_TextureWithDepth) {
                 vr::VRTextureWithDepth_t textureCopy = *reinterpret_cast<const vr::VRTextureWithDepth_t*>(texture);
                 textureCopy.handle = processedTexture;
-                return g_realVRSubmit(self, eye, reinterpret_cast<const vr::Texture_t*>(&textureCopy), bounds, flags);
+                return g_realVRSubmit(self, eye, reinterpret_cast<const vr::Texture_t*>(&textureCopy), submitBounds, flags);
             }
 
             vr::Texture_t textureCopy = *texture;
             textureCopy.handle = processedTexture;
             textureCopy.eType = vr::TextureType_DirectX;
-            return g_realVRSubmit(self, eye, &textureCopy, bounds, flags);
+            return g_realVRSubmit(self, eye, &textureCopy, submitBounds, flags);
         }
 
         return g_realVRSubmit(self, eye, texture, bounds, flags);
     }
 
+    // Frame budget for the pacing stats follows the headset refresh rate (90 Hz if unknown)
+    void UpdateFrameBudgetFromHmd(HMODULE openVRModule) {
+        using PFN_VR_GetGenericInterface = void* (VR_CALLTYPE*)(const char*, vr::EVRInitError*);
+        auto getIface = reinterpret_cast<PFN_VR_GetGenericInterface>(GetProcAddress(openVRModule, "VR_GetGenericInterface"));
+        if (!getIface) {
+            return;
+        }
+        vr::EVRInitError err = vr::VRInitError_None;
+        auto* system = reinterpret_cast<vr::IVRSystem*>(getIface(vr::IVRSystem_Version, &err));
+        if (!system || err != vr::VRInitError_None) {
+            return;
+        }
+        const float hz = system->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DisplayFrequency_Float);
+        if (hz > 0.0f) {
+            DLSSFrameTiming::Global().SetRefreshRate(hz);
+            _MESSAGE("[Pacing] HMD refresh %.1f Hz, frame budget %.2f ms", hz, 1000.0f / hz);
+        }
+    }
+
     void EnsureVRSubmitHookInstalled() {
         if (g_vrSubmitHookInstalled) {
             return;
@@ -748,6 +1040,7 @@ namespace {
             g_vrSubmitHookInstalled = true;
             g_loggedSubmitFailure = false;
             _MESSAGE("OpenVR Submit hook installed successfully");
+            UpdateFrameBudgetFromHmd(openVRModule);
             g_state.store(DlssState::HaveCompositor, std::memory_order_relaxed);
         } else if (!g_loggedSubmitFailure) {
             _ERROR("Failed to install OpenVR Submit hook");
@@ -771,7 +1064,29 @@ namespace {
             if (ctx) {
                 HookVTableFunction(ctx, 33, DLSSHooks::HookedOMSetRenderTargets, &DLSSHooks::RealOMSetRenderTargets);
                 HookVTableFunction(ctx, 44, DLSSHooks::HookedRSSetViewports, &DLSSHooks::RealRSSetViewports);
-                _MESSAGE("Immediate context hooks installed (OMSetRenderTargets, RSSetViewports)");
+                HookVTableFunction(ctx, 45, DLSSHooks::HookedRSSetScissorRects, &DLSSHooks::RealRSSetScissorRects);
+                HookVTableFunction(ctx, 14, DLSSHooks::HookedMap, &DLSSHooks::RealMap);
+                HookVTableFunction(ctx, 15, DLSSHooks::HookedUnmap, &DLSSHooks::RealUnmap);
+                HookVTableFunction(ctx, 48, DLSSHooks::HookedUpdateSubresource, &DLSSHooks::RealUpdateSubresource);
+                HookVTableFunction(ctx, 46, DLSSHooks::HookedCopySubresourceRegion, &DLSSHooks::RealCopySubresourceRegion);
+                HookVTableFunction(ctx, 47, DLSSHooks::HookedCopyResource, &DLSSHooks::RealCopyResource);
+                HookVTableFunction(ctx, 50, DLSSHooks::HookedClearRenderTargetView, &DLSSHooks::RealClearRenderTargetView);
+                HookVTableFunction(ctx, 53, DLSSHooks::HookedClearDepthStencilView, &DLSSHooks::RealClearDepthStencilView);
+                HookVTableFunction(ctx, 57, DLSSHooks::HookedResolveSubresource, &DLSSHooks::RealResolveSubresource);
+                HookVTableFunction(ctx, 8, DLSSHooks::HookedPSSetShaderResources, &DLSSHooks::RealPSSetShaderResources);
+                HookVTableFunction(ctx, 25, DLSSHooks::HookedVSSetShaderResources, &DLSSHooks::RealVSSetShaderResources);
+                HookVTableFunction(ctx, 31, DLSSHooks::HookedGSSetShaderResources, &DLSSHooks::RealGSSetShaderResources);
+                HookVTableFunction(ctx, 59, DLSSHooks::HookedHSSetShaderResources, &DLSSHooks::RealHSSetShaderResources);
+                HookVTableFunction(ctx, 63, DLSSHooks::HookedDSSetShaderResources, &DLSSHooks::RealDSSetShaderResources);
+                HookVTableFunction(ctx, 67, DLSSHooks::HookedCSSetShaderResources, &DLSSHooks::RealCSSetShaderResources);
+                HookVTableFunction(ctx, 12, DLSSHooks::HookedDrawIndexed, &DLSSHooks::RealDrawIndexed);
+                HookVTableFunction(ctx, 13, DLSSHooks::HookedDraw, &DLSSHooks::RealDraw);
+                HookVTableFunction(ctx, 20, DLSSHooks::HookedDrawIndexedInstanced, &DLSSHooks::RealDrawIndexedInstanced);
+                HookVTableFunction(ctx, 21, DLSSHooks::HookedDrawInstanced, &DLSSHooks::RealDrawInstanced);
+                // Deferred contexts share the vtable: FinishCommandList only ever fires on them
+                HookVTableFunction(ctx, 58, DLSSHooks::HookedExecuteCommandList, &DLSSHooks::RealExecuteCommandList);
+                HookVTableFunction(ctx, 114, DLSSHooks::HookedFinishCommandList, &DLSSHooks::RealFinishCommandList);
+                _MESSAGE("Immediate context hooks installed (OMSetRenderTargets, RSSetViewports/ScissorRects, Map/Unmap, UpdateSubresource, Clear/Copy/Resolve, Draw, *SetShaderResources, Execute/FinishCommandList)");
                 ctx->Release();
             }
         } else {
@@ -893,13 +1208,20 @@ namespace {
         }
 
         if (!g_dlssRuntimeInitialized) {
-            if (g_dlssManager->Initialize()) {
+            // Never blocks: while the worker prepares the runtime, the eye passes through native
+            g_dlssManager->BeginAsyncInitialize();
+            if (g_dlssManager->PollInitialize()) {
                 g_dlssRuntimeInitialized = true;
                 g_loggedDLSSInitFailure = false;
                 _MESSAGE("DLSS runtime initialized from VR submit path");
-            } else if (!g_loggedDLSSInitFailure) {
-                g_loggedDLSSInitFailure = true;
-                _ERROR("Failed to initialize DLSS runtime from VR submit path");
+            } else if (g_dlssManager->GetInitStage() == DLSSManager::InitStage::Failed) {
+                if (!g_loggedDLSSInitFailure) {
+                    g_loggedDLSSInitFailure = true;
+                    _ERROR("Failed to initialize DLSS runtime from VR submit path");
+                }
+            } else {
+                // Retrying: a new failure is logged again
+                g_loggedDLSSInitFailure = false;
             }
         }
 
@@ -916,6 +1238,10 @@ namespace DLSSHooks {
         outW = w; outH = h;
         return true;
     }
+
+    bool IsGameLoading() {
+        return g_gameLoading.load(std::memory_order_acquire);
+    }
 }
 
 namespace DLSSHooks {
@@ -1201,6 +1527,12 @@ extern "C" void SetOverlaySafeMode(bool enabled) {
     }
 }
 
+extern "C" void SetGameLoading(bool loading) {
+    if (g_gameLoading.exchange(loading, std::memory_order_acq_rel) != loading) {
+        _MESSAGE("[HIST] Game %s", loading ? "loading" : "loaded");
+    }
+}
+
 
 
 
@@ -1213,105 +1545,578 @@ extern "C" void SetOverlaySafeMode(bool enabled) {
 
 
 
+namespace {
+    // Texture behind an RTV/DSV (AddRef'd), or nullptr
+    ID3D11Texture2D* GetTextureFromView(ID3D11View* view, D3D11_TEXTURE2D_DESC* outDesc) {
+        if (!view) return nullptr;
+        ID3D11Resource* res = nullptr;
+        view->GetResource(&res);
+        if (!res) return nullptr;
+        ID3D11Texture2D* tex = nullptr;
+        HRESULT hr = res->QueryInterface(__uuidof(ID3D11Texture2D), (void**)&tex);
+        res->Release();
+        if (FAILED(hr) || !tex) return nullptr;
+        if (outDesc) tex->GetDesc(outDesc);
+        return tex;
+    }
+
+    void ReleaseRedirectEntry(RedirectEntry& e) {
+        if (e.bigRTV) { e.bigRTV->Release(); e.bigRTV = nullptr; }
+        if (e.bigDSV) { e.bigDSV->Release(); e.bigDSV = nullptr; }
+        if (e.smallRTV) { e.smallRTV->Release(); e.smallRTV = nullptr; }
+        if (e.smallDSV) { e.smallDSV->Release(); e.smallDSV = nullptr; }
+        DLSSVram::ReleaseTexture(e.smallTex);
+    }
+
+    // DLSSVram trimmer: drop twins whose target has not been bound for a while.
+    // Registered once, with the first twin.
+    std::once_flag g_twinTrimmerOnce;
+    void TrimRedirectTwins(void*, uint64_t frame) {
+        if (frame <= DLSSVram::kIdleFrames) return;
+        const uint64_t idleBefore = frame - DLSSVram::kIdleFrames;
+        std::lock_guard<std::mutex> lock(g_redirectMutex);
+        for (auto it = g_redirectMap.begin(); it != g_redirectMap.end();) {
+            if (it->second.useFrame < idleBefore) {
+                ReleaseRedirectEntry(it->second);
+                it = g_redirectMap.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // The subresource a bound RTV/DSV writes
+    struct TargetView {
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        UINT slice = 0;
+        bool array = false;  // TEXTURE2DARRAY view of 'slice'
+    };
+
+    // False unless the view writes mip 0 of a single slice: a twin stands for
+    // one subresource. Read-only DSVs are not redirected either.
+    bool DescribeTargetView(ID3D11View* view, bool isDepth, TargetView& out) {
+        if (!view) return false;
+        UINT mip = 0, arraySize = 1;
+        if (isDepth) {
+            D3D11_DEPTH_STENCIL_VIEW_DESC vd{};
+            static_cast<ID3D11DepthStencilView*>(view)->GetDesc(&vd);
+            if (vd.Flags != 0) return false;
+            out.format = vd.Format;
+            if (vd.ViewDimension == D3D11_DSV_DIMENSION_TEXTURE2D) {
+                mip = vd.Texture2D.MipSlice;
+            } else if (vd.ViewDimension == D3D11_DSV_DIMENSION_TEXTURE2DARRAY) {
+                mip = vd.Texture2DArray.MipSlice;
+                out.slice = vd.Texture2DArray.FirstArraySlice;
+                arraySize = vd.Texture2DArray.ArraySize;
+                out.array = true;
+            } else {
+                return false;
+            }
+        } else {
+            D3D11_RENDER_TARGET_VIEW_DESC vd{};
+            static_cast<ID3D11RenderTargetView*>(view)->GetDesc(&vd);
+            out.format = vd.Format;
+            if (vd.ViewDimension == D3D11_RTV_DIMENSION_TEXTURE2D) {
+                mip = vd.Texture2D.MipSlice;
+            } else if (vd.ViewDimension == D3D11_RTV_DIMENSION_TEXTURE2DARRAY) {
+                mip = vd.Texture2DArray.MipSlice;
+                out.slice = vd.Texture2DArray.FirstArraySlice;
+                arraySize = vd.Texture2DArray.ArraySize;
+                out.array = true;
+            } else {
+                return false;
+            }
+        }
+        return mip == 0 && arraySize == 1;
+    }
+
+    // Render-size twin of one subresource of a scene-sized color or depth
+    // target. The view format follows the game's view so typeless resources
+    // get a usable RTV/DSV; depth twins are typeless so the composite can read
+    // them. Null while the twin holds this frame's content of another
+    // subresource (the bind goes native, which composites that first).
+    const RedirectEntry* GetOrCreateTwin(ID3D11Texture2D* bigTex, const D3D11_TEXTURE2D_DESC& d, const TargetView& view,
+                                         UINT prW, UINT prH, DLSSRedirect::Kind kind) {
+        if (!bigTex || !g_device) return nullptr;
+        const bool isDepth = (kind == DLSSRedirect::Kind::Depth);
+        DXGI_FORMAT texFormat = d.Format;
+        if (isDepth) {
+            texFormat = static_cast<DXGI_FORMAT>(DLSSRedirect::GetDepthTwinFormats(static_cast<uint32_t>(d.Format)).texture);
+            if (texFormat == DXGI_FORMAT_UNKNOWN) return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(g_redirectMutex);
+        RedirectEntry& e = g_redirectMap[bigTex];
+        e.useFrame = DLSSVram::Global().Frame();
+        const bool haveView = isDepth ? (e.smallDSV != nullptr) : (e.smallRTV != nullptr);
+        if (haveView && e.smallW == prW && e.smallH == prH && e.format == d.Format && e.viewFormat == view.format &&
+            e.slice == view.slice && e.arrayView == view.array) {
+            return &e;
+        }
+        if (e.smallTex && g_bindingTable.IsRedirected(reinterpret_cast<uintptr_t>(bigTex))) {
+            return nullptr;
+        }
+        ReleaseRedirectEntry(e);
+        D3D11_TEXTURE2D_DESC td = d;
+        td.Width = prW; td.Height = prH; td.MipLevels = 1; td.ArraySize = 1;
+        td.Format = texFormat;
+        td.SampleDesc.Count = 1; td.SampleDesc.Quality = 0;
+        td.Usage = D3D11_USAGE_DEFAULT; td.CPUAccessFlags = 0;
+        if (isDepth) {
+            td.BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
+        } else {
+            td.BindFlags |= D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+            td.BindFlags &= ~(D3D11_BIND_DEPTH_STENCIL);
+        }
+        td.MiscFlags &= ~(D3D11_RESOURCE_MISC_SHARED | D3D11_RESOURCE_MISC_GENERATE_MIPS | D3D11_RESOURCE_MISC_TEXTURECUBE);
+        HRESULT hr = g_device->CreateTexture2D(&td, nullptr, &e.smallTex);
+        if (SUCCEEDED(hr)) {
+            DLSSVram::TrackTexture(e.smallTex, DLSSVram::Pool::RedirectTwins);
+            std::call_once(g_twinTrimmerOnce, [] { DLSSVram::Global().AddTrimmer(&TrimRedirectTwins, nullptr); });
+            if (isDepth) {
+                D3D11_DEPTH_STENCIL_VIEW_DESC vd{};
+                vd.Format = view.format;
+                vd.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+                hr = g_device->CreateDepthStencilView(e.smallTex, &vd, &e.smallDSV);
+            } else {
+                D3D11_RENDER_TARGET_VIEW_DESC vd{};
+                vd.Format = view.format;
+                vd.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+                hr = g_device->CreateRenderTargetView(e.smallTex, &vd, &e.smallRTV);
+            }
+        }
+        if (FAILED(hr)) {
+            ReleaseRedirectEntry(e);
+            g_redirectMap.erase(bigTex);
+            if (g_dlssConfig && g_dlssConfig->debugEarlyDlss) {
+                _ERROR("[EarlyDLSS][RT] Twin creation failed (%s, fmt=%u, hr=0x%08X)", isDepth ? "depth" : "color", (unsigned)d.Format, (unsigned)hr);
+            }
+            return nullptr;
+        }
+        e.smallW = prW; e.smallH = prH; e.format = d.Format; e.viewFormat = view.format;
+        e.slice = view.slice; e.arrayView = view.array;
+        if (g_dlssConfig && g_dlssConfig->debugEarlyDlss) {
+            _MESSAGE("[EarlyDLSS][RT] Created small %s twin %ux%u for fmt=%u slice=%u", isDepth ? "depth" : "color", prW, prH,
+                (unsigned)d.Format, view.slice);
+        }
+        return &e;
+    }
+
+    // The view writes the subresource the twin stands for
+    bool ViewMatchesTwin(ID3D11View* view, bool isDepth, const RedirectEntry& twin) {
+        TargetView target;
+        return DescribeTargetView(view, isDepth, target) && target.slice == twin.slice && target.array == twin.arrayView;
+    }
+
+    // Whole-resource copies can only be translated for textures with one subresource
+    bool IsSingleSubresource(const D3D11_TEXTURE2D_DESC& d) {
+        return d.MipLevels == 1 && d.ArraySize == 1;
+    }
+
+    // Subresource of the big texture the twin stands for: mip 0 of its slice
+    UINT TwinSubresource(const D3D11_TEXTURE2D_DESC& d, const RedirectEntry& twin) {
+        return D3D11CalcSubresource(0, twin.slice, d.MipLevels);
+    }
+
+    // Full-size RTV/DSV of the twin's subresource (lock held)
+    bool EnsureBigView(ID3D11Texture2D* bigTex, RedirectEntry& e) {
+        if (!g_device) return false;
+        if (e.smallDSV) {
+            if (!e.bigDSV) {
+                D3D11_DEPTH_STENCIL_VIEW_DESC vd{};
+                vd.Format = e.viewFormat;
+                if (e.arrayView) {
+                    vd.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DARRAY;
+                    vd.Texture2DArray.FirstArraySlice = e.slice;
+                    vd.Texture2DArray.ArraySize = 1;
+                } else {
+                    vd.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+                }
+                g_device->CreateDepthStencilView(bigTex, &vd, &e.bigDSV);
+            }
+            return e.bigDSV != nullptr;
+        }
+        if (!e.bigRTV) {
+            D3D11_RENDER_TARGET_VIEW_DESC vd{};
+            vd.Format = e.viewFormat;
+            if (e.arrayView) {
+                vd.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DARRAY;
+                vd.Texture2DArray.FirstArraySlice = e.slice;
+                vd.Texture2DArray.ArraySize = 1;
+            } else {
+                vd.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2D;
+            }
+            g_device->CreateRenderTargetView(bigTex, &vd, &e.bigRTV);
+        }
+        return e.bigRTV != nullptr;
+    }
+
+    // A redirected target is about to be used at full size: copy the twin's
+    // content up so later passes see the scene. Depth twins go through the
+    // depth/stencil composite.
+    bool CompositeTwinToBig(ID3D11Texture2D* bigTex) {
+        if (!bigTex || !g_dlssManager) return false;
+        ID3D11Texture2D* smallTex = nullptr;
+        ID3D11RenderTargetView* bigRTV = nullptr;
+        ID3D11DepthStencilView* bigDSV = nullptr;
+        DXGI_FORMAT viewFormat = DXGI_FORMAT_UNKNOWN;
+        {
+            std::lock_guard<std::mutex> lock(g_redirectMutex);
+            auto it = g_redirectMap.find(bigTex);
+            if (it == g_redirectMap.end() || !it->second.smallTex || !EnsureBigView(bigTex, it->second)) return false;
+            const RedirectEntry& e = it->second;
+            smallTex = e.smallTex;
+            bigRTV = e.smallDSV ? nullptr : e.bigRTV;
+            bigDSV = e.smallDSV ? e.bigDSV : nullptr;
+            viewFormat = e.viewFormat;
+        }
+        D3D11_TEXTURE2D_DESC d{};
+        bigTex->GetDesc(&d);
+        g_inRedirectComposite = true;
+        const bool ok = bigDSV ? g_dlssManager->BlitDepthToDSV(smallTex, bigDSV, d.Width, d.Height)
+                               : g_dlssManager->BlitToRTV(smallTex, bigRTV, d.Width, d.Height, static_cast<uint32_t>(viewFormat));
+        g_inRedirectComposite = false;
+        if (ok) {
+            // Composites run on the immediate context (redirect never binds elsewhere)
+            if (DLSSContextState::Lease cs = g_contextStates.Acquire(reinterpret_cast<uintptr_t>(g_context))) {
+                cs->flags.composited = true;
+            }
+            if (g_dlssConfig && g_dlssConfig->debugEarlyDlss) {
+                _MESSAGE("[EarlyDLSS][Composite] small->big %s %ux%u", bigDSV ? "depth" : "color", d.Width, d.Height);
+            }
+        } else if (g_dlssConfig && g_dlssConfig->debugEarlyDlss) {
+            _ERROR("[EarlyDLSS][Composite] small->big %s %ux%u failed", bigDSV ? "depth" : "color", d.Width, d.Height);
+        }
+        return ok;
+    }
+    // Pass-graph updates only come from the immediate context outside our own blits
+    bool IsPassGraphFeed(ID3D11DeviceContext* ctx) {
+        return g_passGraphEnabled && ctx == g_context && !g_inRedirectComposite;
+    }
+
+    // Twins and the binding table follow one binding sequence: the immediate context's
+    bool IsRedirectModeActive(ID3D11DeviceContext* ctx) {
+        return g_dlssConfig && g_dlssConfig->earlyDlssEnabled && g_dlssConfig->earlyDlssMode == 1 && ctx == g_context && !g_inRedirectComposite;
+    }
+
+    uint64_t TwinBytesSaved(DXGI_FORMAT f, UINT bigW, UINT bigH, UINT smallW, UINT smallH) {
+        return DLSSRedirect::BytesSaved(DLSSVram::SurfaceBytes(f, bigW, bigH), DLSSVram::SurfaceBytes(f, smallW, smallH));
+    }
+
+    // Twin of a texture resource (copied out under the lock); false if the
+    // resource is not a redirected-capable Texture2D
+    bool LookupTwin(ID3D11Resource* res, RedirectEntry& out) {
+        if (!res) return false;
+        D3D11_RESOURCE_DIMENSION dim = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+        res->GetType(&dim);
+        if (dim != D3D11_RESOURCE_DIMENSION_TEXTURE2D) return false;
+        std::lock_guard<std::mutex> lock(g_redirectMutex);
+        auto it = g_redirectMap.find(static_cast<ID3D11Texture2D*>(res));
+        if (it == g_redirectMap.end() || !it->second.smallTex) return false;
+        out = it->second;
+        return true;
+    }
+
+    // A consumer needs the full-size content of a redirected color or depth
+    // target: composite the twin into it now. The resource is native for the
+    // rest of the frame either way, so it is never redirected again on top
+    // of a stale big copy.
+    void MaterializeBig(ID3D11Resource* res) {
+        if (CompositeTwinToBig(static_cast<ID3D11Texture2D*>(res))) {
+            g_bindingTable.NoteComposite();
+        }
+        g_bindingTable.MarkNative(reinterpret_cast<uintptr_t>(res));
+    }
+}
+
 namespace DLSSHooks {
-    // Heuristic: decide if an RTV looks like a scene color target
-    static bool IsSceneColorRTDesc(const D3D11_TEXTURE2D_DESC& d) {
-        if (d.SampleDesc.Count != 1) return false;
-        if ((d.BindFlags & D3D11_BIND_RENDER_TARGET) == 0) return false;
-        if (d.Width < 1024 || d.Height < 1024) return false;
+    static void ApplyViewports(ID3D11DeviceContext* ctx, DLSSContextState::State& cs, UINT count, const D3D11_VIEWPORT* viewports);
+    static void ApplyScissorRects(ID3D11DeviceContext* ctx, const DLSSContextState::State& cs, UINT count, const D3D11_RECT* rects);
+
+    static DLSSContextState::SceneTarget ToSceneTarget(const D3D11_TEXTURE2D_DESC& d) {
+        DLSSContextState::SceneTarget t;
+        t.width = d.Width;
+        t.height = d.Height;
+        t.format = (uint32_t)d.Format;
+        t.sampleCount = d.SampleDesc.Count;
+        t.bindFlags = d.BindFlags;
+        return t;
+    }
+
+    // Heuristic: decide if an RTV looks like a scene color target. With the
+    // pass graph enabled, passes it classifies as shadow/HUD are excluded first.
+    static bool IsSceneColorRTDesc(const DLSSContextState::SceneTarget& t) {
+        if (t.sampleCount != 1) return false;
+        if ((t.bindFlags & D3D11_BIND_RENDER_TARGET) == 0) return false;
+        if (t.width < 1024 || t.height < 1024) return false;
+        return true;
+    }
+
+    // Predicted render size for the current per-eye output (0 if unknown).
+    // Twins are shared by both eyes, so with per-eye overrides this is the
+    // larger eye's size.
+    static bool ComputeRedirectRenderSize(const DLSSContextState::SceneTarget& scene, UINT& prW, UINT& prH) {
+        uint32_t outLw=0, outLh=0, outRw=0, outRh=0;
+        (void)DLSSHooks::GetPerEyeDisplaySize(0, outLw, outLh);
+        (void)DLSSHooks::GetPerEyeDisplaySize(1, outRw, outRh);
+        uint32_t tgtOutW = outLw ? outLw : outRw;
+        uint32_t tgtOutH = outLh ? outLh : outRh;
+        if (tgtOutW == 0 || tgtOutH == 0) { tgtOutW = scene.width; tgtOutH = scene.height; }
+        uint32_t w = 0, h = 0;
+        if (!g_dlssManager || !g_dlssManager->ComputeRenderSizeForOutput(tgtOutW, tgtOutH, w, h) || w == 0 || h == 0) {
+            return false;
+        }
+        prW = w; prH = h;
         return true;
     }
 
-    void STDMETHODCALLTYPE HookedOMSetRenderTargets(ID3D11DeviceContext* ctx, UINT numRTVs, ID3D11RenderTargetView* const* ppRTVs, ID3D11DepthStencilView* pDSV) {`n        // Composite small->big if a post/HUD big RT is bound after redirect`n        if (ppRTVs && numRTVs>0 && ppRTVs[0]) { CompositeIfNeededOnBigBind(ppRTVs[0]); }
-        if (!ppRTVs || numRTVs == 0 || !ppRTVs[0]) {
+    void STDMETHODCALLTYPE HookedOMSetRenderTargets(ID3D11DeviceContext* ctx, UINT numRTVs, ID3D11RenderTargetView* const* ppRTVs, ID3D11DepthStencilView* pDSV) {
+        // Our own blits (composite) go straight through
+        if (g_inRedirectComposite) {
             if (RealOMSetRenderTargets) RealOMSetRenderTargets(ctx, numRTVs, ppRTVs, pDSV);
             return;
         }
-        // Detect scene begin on any mode
-        D3D11_TEXTURE2D_DESC d{};
-        if (GetDescFromRTV(ppRTVs[0], &d)) {
-            if (IsSceneColorRTDesc(d)) {
-                g_sceneRTDesc = d;
-                g_sceneActive.store(true, std::memory_order_relaxed);
-                if (g_dlssConfig && g_dlssConfig->debugEarlyDlss) {
-                    _MESSAGE("[EarlyDLSS][SceneBegin] RTV=%ux%u fmt=%u", d.Width, d.Height, (unsigned)d.Format);
-                }
+        // Slot table full: this context is left alone
+        DLSSContextState::Lease cs = g_contextStates.Acquire(reinterpret_cast<uintptr_t>(ctx));
+        if (!cs) {
+            if (RealOMSetRenderTargets) RealOMSetRenderTargets(ctx, numRTVs, ppRTVs, pDSV);
+            return;
+        }
+        DLSSContextState::FrameFlags& facts = cs->flags;
+        // Resolve every bound target (MRTs + DSV) once for the pass graph and the redirect
+        const UINT colorCount = (ppRTVs && numRTVs <= D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT) ? numRTVs : 0;
+        const UINT slotCount = colorCount + 1;
+        ID3D11Texture2D* bigTex[DLSSRedirect::kMaxSlots] = {};
+        D3D11_TEXTURE2D_DESC descs[DLSSRedirect::kMaxSlots] = {};
+        for (UINT i = 0; i < slotCount; ++i) {
+            ID3D11View* view = (i == colorCount) ? static_cast<ID3D11View*>(pDSV) : static_cast<ID3D11View*>(ppRTVs[i]);
+            if (view) bigTex[i] = GetTextureFromView(view, &descs[i]);
+        }
+        auto releaseTargets = [&]() {
+            for (UINT i = 0; i < slotCount; ++i) {
+                if (bigTex[i]) bigTex[i]->Release();
             }
+        };
+
+        // Cached class from the previous frames; shadow/HUD passes never count as scene
+        DLSSPassGraph::PassClass passClass = DLSSPassGraph::PassClass::Unknown;
+        if (IsPassGraphFeed(ctx)) {
+            DLSSPassGraph::Target targets[DLSSPassGraph::kMaxTargets];
+            for (UINT i = 0; i < slotCount; ++i) {
+                targets[i] = DLSSPassGraph::Target{};
+                if (!bigTex[i]) continue;
+                targets[i].key = reinterpret_cast<uintptr_t>(bigTex[i]);
+                targets[i].width = descs[i].Width;
+                targets[i].height = descs[i].Height;
+                targets[i].format = (uint32_t)descs[i].Format;
+                targets[i].depth = (i == colorCount);
+            }
+            passClass = g_passGraph.BeginPass(targets, slotCount);
         }
+        const bool excludedPass = (passClass == DLSSPassGraph::PassClass::Shadow || passClass == DLSSPassGraph::PassClass::HUD);
 
-        // Redirect only when enabled and mode == rt_redirect (1) and only once per frame
-        bool didRedirect = false;
-        if (g_dlssConfig && g_dlssConfig->earlyDlssEnabled && g_dlssConfig->earlyDlssMode == 1 && !g_redirectUsedThisFrame.load(std::memory_order_relaxed)) {
-            if (IsSceneColorRTDesc(g_sceneRTDesc)) {
-                // Compute target output and predicted render size
-                uint32_t outLw=0, outLh=0, outRw=0, outRh=0;
-                (void)DLSSHooks::GetPerEyeDisplaySize(0, outLw, outLh);
-                (void)DLSSHooks::GetPerEyeDisplaySize(1, outRw, outRh);
-                uint32_t tgtOutW = outLw ? outLw : outRw;
-                uint32_t tgtOutH = outLh ? outLh : outRh;
-                if (tgtOutW == 0 || tgtOutH == 0) { tgtOutW = g_sceneRTDesc.Width; tgtOutH = g_sceneRTDesc.Height; }
-                uint32_t prW=0, prH=0;
-                if (g_dlssManager && g_dlssManager->ComputeRenderSizeForOutput(tgtOutW, tgtOutH, prW, prH)) {
-                    if (prW > 0 && prH > 0 && (prW < g_sceneRTDesc.Width || prH < g_sceneRTDesc.Height)) {
-                        ID3D11RenderTargetView* smallRTV = GetOrCreateSmallRTVFor(ppRTVs[0], prW, prH);
-                        if (smallRTV) {
-                            // Build a local array replacing RTV[0]
-                            std::vector<ID3D11RenderTargetView*> rtvs(numRTVs);
-                            for (UINT i=0;i<numRTVs;++i) rtvs[i] = ppRTVs[i];
-                            rtvs[0] = smallRTV;
-                            if (g_dlssConfig->debugEarlyDlss) {
-                                _MESSAGE("[EarlyDLSS][Redirect] RTV old=%ux%u -> small=%ux%u", g_sceneRTDesc.Width, g_sceneRTDesc.Height, prW, prH);
-                            }
-                            if (RealOMSetRenderTargets) RealOMSetRenderTargets(ctx, numRTVs, rtvs.data(), pDSV);
-                            didRedirect = true;
-                            g_redirectUsedThisFrame.store(true, std::memory_order_relaxed);
-                            // Do not call Real again below
-                            return;
-                        }
-                    }
-                }
+        // Detect scene begin on any mode
+        if (colorCount > 0 && bigTex[0] && !excludedPass && IsSceneColorRTDesc(ToSceneTarget(descs[0]))) {
+            if (!facts.sceneActive && g_dlssConfig && g_dlssConfig->debugEarlyDlss) {
+                _MESSAGE("[EarlyDLSS][SceneBegin] ctx=%p RTV=%ux%u fmt=%u pass=%s", (void*)ctx, descs[0].Width, descs[0].Height,
+                    (unsigned)descs[0].Format, DLSSPassGraph::PassClassName(passClass));
             }
+            facts.scene = ToSceneTarget(descs[0]);
+            facts.sceneActive = true;
         }
+        const DLSSContextState::SceneTarget& scene = facts.scene;
 
-        if (!didRedirect) {
+        UINT prW = 0, prH = 0;
+        if (!IsRedirectModeActive(ctx) || !IsSceneColorRTDesc(scene) || !ComputeRedirectRenderSize(scene, prW, prH) ||
+            numRTVs > D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT) {
+            releaseTargets();
+            cs->redirectBindActive = false;
             if (RealOMSetRenderTargets) RealOMSetRenderTargets(ctx, numRTVs, ppRTVs, pDSV);
+            return;
+        }
+
+        // Collect every bound target with its twin; excluded passes still go through
+        // the table so redirected targets they touch get composited
+        DLSSRedirect::Slot slots[DLSSRedirect::kMaxSlots];
+        DLSSRedirect::Action actions[DLSSRedirect::kMaxSlots];
+        const RedirectEntry* twins[DLSSRedirect::kMaxSlots] = {};
+        bool twinsOk = !excludedPass;
+        for (UINT i = 0; i < slotCount; ++i) {
+            const bool isDepth = (i == colorCount);
+            slots[i] = DLSSRedirect::Slot{};
+            slots[i].kind = isDepth ? DLSSRedirect::Kind::Depth : DLSSRedirect::Kind::Color;
+            if (!bigTex[i]) continue;
+            const D3D11_TEXTURE2D_DESC& d = descs[i];
+            slots[i].key = reinterpret_cast<uintptr_t>(bigTex[i]);
+            // Views of another mip or of several slices keep size 0: the bind goes native
+            ID3D11View* view = isDepth ? static_cast<ID3D11View*>(pDSV) : static_cast<ID3D11View*>(ppRTVs[i]);
+            TargetView target;
+            if (d.SampleDesc.Count == 1 && DescribeTargetView(view, isDepth, target)) {
+                slots[i].width = d.Width;
+                slots[i].height = d.Height;
+            }
+            if (twinsOk && slots[i].width == scene.width && slots[i].height == scene.height) {
+                twins[i] = GetOrCreateTwin(bigTex[i], d, target, prW, prH, slots[i].kind);
+                if (!twins[i]) twinsOk = false;
+            }
+        }
+
+        const bool redirected = g_bindingTable.ResolveBind(slots, slotCount,
+            scene.width, scene.height, prW, prH, twinsOk, actions);
+
+        ID3D11RenderTargetView* rtvs[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT] = {};
+        for (UINT i = 0; i < colorCount; ++i) {
+            rtvs[i] = ppRTVs[i];
+            if (actions[i] == DLSSRedirect::Action::Redirect && twins[i]) {
+                rtvs[i] = twins[i]->smallRTV;
+            } else if (actions[i] == DLSSRedirect::Action::CompositeThenNative) {
+                CompositeTwinToBig(bigTex[i]);
+            }
+        }
+        ID3D11DepthStencilView* dsv = pDSV;
+        if (actions[colorCount] == DLSSRedirect::Action::Redirect && twins[colorCount]) {
+            dsv = twins[colorCount]->smallDSV;
+        } else if (actions[colorCount] == DLSSRedirect::Action::CompositeThenNative) {
+            CompositeTwinToBig(bigTex[colorCount]);
+        }
+        releaseTargets();
+
+        if (redirected && g_dlssConfig->debugEarlyDlss && !facts.redirectUsed) {
+            _MESSAGE("[EarlyDLSS][Redirect] %u RTV(s)%s %ux%u -> %ux%u", colorCount, pDSV ? " + DSV" : "",
+                scene.width, scene.height, prW, prH);
+        }
+        if (RealOMSetRenderTargets) RealOMSetRenderTargets(ctx, numRTVs, ppRTVs ? rtvs : nullptr, dsv);
+
+        const bool wasActive = cs->redirectBindActive;
+        cs->redirectBindActive = redirected;
+        if (redirected) {
+            facts.redirectUsed = true;
+            cs->redirectSmallWidth = prW;
+            cs->redirectSmallHeight = prH;
+        }
+        // Viewports and scissors are usually set before the targets: re-issue them for the new binding
+        if (wasActive != redirected && cs->lastViewportCount > 0) {
+            ApplyViewports(ctx, *cs, cs->lastViewportCount, reinterpret_cast<const D3D11_VIEWPORT*>(cs->lastViewports));
+        }
+        if (wasActive != redirected && cs->lastScissorCount > 0) {
+            ApplyScissorRects(ctx, *cs, cs->lastScissorCount, reinterpret_cast<const D3D11_RECT*>(cs->lastScissors));
         }
     }
 
     void STDMETHODCALLTYPE HookedRSSetViewports(ID3D11DeviceContext* ctx, UINT count, const D3D11_VIEWPORT* viewports) {
-        // Default: pass through
-        if (!g_dlssConfig || !g_dlssConfig->earlyDlssEnabled || g_dlssConfig->earlyDlssMode != 0 || !viewports || count == 0) {
+        if (g_inRedirectComposite) {
             if (RealRSSetViewports) RealRSSetViewports(ctx, count, viewports);
             return;
         }
-        // Only clamp inside a detected scene
-        if (!g_sceneActive.load(std::memory_order_relaxed)) {
+        DLSSContextState::Lease cs = g_contextStates.Acquire(reinterpret_cast<uintptr_t>(ctx));
+        if (!cs) {
             if (RealRSSetViewports) RealRSSetViewports(ctx, count, viewports);
             return;
         }
-        // Determine target per-eye output size (prefer left/right max)
-        uint32_t outLw=0, outLh=0, outRw=0, outRh=0;
-        (void)DLSSHooks::GetPerEyeDisplaySize(0, outLw, outLh);
-        (void)DLSSHooks::GetPerEyeDisplaySize(1, outRw, outRh);
-        uint32_t tgtOutW = outLw ? outLw : outRw;
-        uint32_t tgtOutH = outLh ? outLh : outRh;
-        if (tgtOutW == 0 || tgtOutH == 0) {
-            // Fallback to scene RT size (not ideal for SxS atlases)
-            tgtOutW = g_sceneRTDesc.Width;
-            tgtOutH = g_sceneRTDesc.Height;
-        }
-        // Compute predicted render size
-        uint32_t prW=0, prH=0;
-        if (!g_dlssManager || !g_dlssManager->ComputeRenderSizeForOutput(tgtOutW, tgtOutH, prW, prH)) {
+        // Remember the game's viewports so a later redirect/unredirect can re-issue them
+        if (viewports && count <= DLSSContextState::kMaxViewports) {
+            memcpy(cs->lastViewports, viewports, count * sizeof(D3D11_VIEWPORT));
+            cs->lastViewportCount = count;
+        }
+        if (viewports && count > 0 && IsPassGraphFeed(ctx)) {
+            g_passGraph.NoteViewport((uint32_t)viewports[0].Width, (uint32_t)viewports[0].Height);
+        }
+        ApplyViewports(ctx, *cs, count, viewports);
+    }
+
+    void STDMETHODCALLTYPE HookedRSSetScissorRects(ID3D11DeviceContext* ctx, UINT count, const D3D11_RECT* rects) {
+        if (g_inRedirectComposite) {
+            if (RealRSSetScissorRects) RealRSSetScissorRects(ctx, count, rects);
+            return;
+        }
+        DLSSContextState::Lease cs = g_contextStates.Acquire(reinterpret_cast<uintptr_t>(ctx));
+        if (!cs) {
+            if (RealRSSetScissorRects) RealRSSetScissorRects(ctx, count, rects);
+            return;
+        }
+        if (rects && count <= DLSSContextState::kMaxViewports) {
+            memcpy(cs->lastScissors, rects, count * sizeof(D3D11_RECT));
+            cs->lastScissorCount = count;
+        }
+        ApplyScissorRects(ctx, *cs, count, rects);
+    }
+
+    // Phase 2: scissors of a redirected bind are scaled like its viewports
+    static void ApplyScissorRects(ID3D11DeviceContext* ctx, const DLSSContextState::State& cs, UINT count, const D3D11_RECT* rects) {
+        const DLSSContextState::SceneTarget& scene = cs.flags.scene;
+        if (cs.redirectBindActive && rects && count > 0 && count <= D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE &&
+            scene.width > 0 && scene.height > 0) {
+            D3D11_RECT scaled[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+            for (UINT i = 0; i < count; ++i) {
+                DLSSRedirect::Rect r;
+                memcpy(&r, &rects[i], sizeof(r));
+                r = DLSSRedirect::ScaleScissor(r, scene.width, scene.height, cs.redirectSmallWidth, cs.redirectSmallHeight);
+                memcpy(&scaled[i], &r, sizeof(r));
+            }
+            if (RealRSSetScissorRects) RealRSSetScissorRects(ctx, count, scaled);
+            return;
+        }
+        if (RealRSSetScissorRects) RealRSSetScissorRects(ctx, count, rects);
+    }
+
+    static void ApplyViewports(ID3D11DeviceContext* ctx, DLSSContextState::State& cs, UINT count, const D3D11_VIEWPORT* viewports) {
+        const DLSSContextState::SceneTarget& scene = cs.flags.scene;
+        // Phase 2: the bound targets are render-size twins, scale scene-sized viewports to match
+        if (cs.redirectBindActive && viewports && count > 0 && count <= D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE &&
+            scene.width > 0 && scene.height > 0) {
+            const float sx = (float)cs.redirectSmallWidth / (float)scene.width;
+            const float sy = (float)cs.redirectSmallHeight / (float)scene.height;
+            D3D11_VIEWPORT vps[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+            for (UINT i = 0; i < count; ++i) {
+                vps[i] = viewports[i];
+                vps[i].TopLeftX *= sx; vps[i].Width *= sx;
+                vps[i].TopLeftY *= sy; vps[i].Height *= sy;
+            }
+            if (RealRSSetViewports) RealRSSetViewports(ctx, count, vps);
+            return;
+        }
+        // Default: pass through
+        if (!g_dlssConfig || !g_dlssConfig->earlyDlssEnabled || g_dlssConfig->earlyDlssMode != 0 || !viewports || count == 0) {
             if (RealRSSetViewports) RealRSSetViewports(ctx, count, viewports);
             return;
         }
-        if (prW == 0 || prH == 0) {
+        // Only clamp inside a detected scene
+        if (!cs.flags.sceneActive) {
             if (RealRSSetViewports) RealRSSetViewports(ctx, count, viewports);
             return;
         }
+        // Per-eye output sizes (one eye's size stands in for a missing other)
+        uint32_t outW[2] = {}, outH[2] = {};
+        (void)DLSSHooks::GetPerEyeDisplaySize(0, outW[0], outH[0]);
+        (void)DLSSHooks::GetPerEyeDisplaySize(1, outW[1], outH[1]);
+        for (int e = 0; e < 2; ++e) {
+            if (outW[e] == 0 || outH[e] == 0) { outW[e] = outW[1 - e]; outH[e] = outH[1 - e]; }
+            if (outW[e] == 0 || outH[e] == 0) {
+                // Fallback to scene RT size (not ideal for SxS atlases)
+                outW[e] = scene.width;
+                outH[e] = scene.height;
+            }
+        }
+        // Predicted render size per eye; eyes can differ with per-eye quality or scale
+        uint32_t prW[2] = {}, prH[2] = {};
+        for (int e = 0; e < 2; ++e) {
+            if (!g_dlssManager || !g_dlssManager->ComputeRenderSizeForOutput(e, outW[e], outH[e], prW[e], prH[e]) ||
+                prW[e] == 0 || prH[e] == 0) {
+                if (RealRSSetViewports) RealRSSetViewports(ctx, count, viewports);
+                return;
+            }
+        }
+        // A side-by-side target tells the eyes apart by viewport position; a
+        // target holding one eye at a time cannot, so it gets the larger size
+        const bool sideBySide = scene.width >= outW[0] + outW[1] - 2;
+        const uint32_t sharedW = std::max(prW[0], prW[1]);
+        const uint32_t sharedH = std::max(prH[0], prH[1]);
         // Prepare a modified copy of the viewport array
-        std::vector<D3D11_VIEWPORT> vps(viewports, viewports + count);
+        DLSSArena::InlineArray<D3D11_VIEWPORT, DLSSContextState::kMaxViewports> vps;
+        if (!vps.Assign(viewports, count)) {
+            if (RealRSSetViewports) RealRSSetViewports(ctx, count, viewports);
+            return;
+        }
         bool anyClamped = false;
         auto approxEq = [](float a, float b) {
             float diff = fabsf(a - b);
@@ -1320,92 +2125,374 @@ namespace DLSSHooks {
         };
         for (UINT i = 0; i < count; ++i) {
             D3D11_VIEWPORT& vp = vps[i];
-            if (approxEq(vp.Width, (float)tgtOutW) && approxEq(vp.Height, (float)tgtOutH)) {
-                if (!approxEq(vp.Width, (float)prW) || !approxEq(vp.Height, (float)prH)) {
-                    if (g_dlssConfig->debugEarlyDlss && g_clampLogBudgetPerFrame > 0) {
-                        _MESSAGE("[EarlyDLSS][CLAMP] vp old=(%.0fx%.0f) -> new=(%ux%u)", vp.Width, vp.Height, prW, prH);
-                        --g_clampLogBudgetPerFrame;
-                    }
-                    vp.Width  = (float)prW;
-                    vp.Height = (float)prH;
-                    anyClamped = true;
+            const int eye = (sideBySide && vp.TopLeftX >= outW[0] * 0.5f) ? 1 : 0;
+            if (!approxEq(vp.Width, (float)outW[eye]) || !approxEq(vp.Height, (float)outH[eye])) continue;
+            const uint32_t w = sideBySide ? prW[eye] : sharedW;
+            const uint32_t h = sideBySide ? prH[eye] : sharedH;
+            if (!approxEq(vp.Width, (float)w) || !approxEq(vp.Height, (float)h)) {
+                if (g_dlssConfig->debugEarlyDlss && cs.clampLogBudget > 0) {
+                    _MESSAGE("[EarlyDLSS][CLAMP] eye=%d vp old=(%.0fx%.0f) -> new=(%ux%u)", sideBySide ? eye : -1, vp.Width, vp.Height, w, h);
+                    --cs.clampLogBudget;
                 }
+                vp.Width  = (float)w;
+                vp.Height = (float)h;
+                ++cs.flags.clampedViewports;
+                anyClamped = true;
             }
         }
         if (RealRSSetViewports) {
-            RealRSSetViewports(ctx, count, vps.data());
+            RealRSSetViewports(ctx, count, vps.Data());
         }
         (void)anyClamped;
     }
-}
 
-static ID3D11RenderTargetView* GetOrCreateSmallRTVFor(ID3D11RenderTargetView* bigRTV, UINT prW, UINT prH) {
-    if (!bigRTV || !g_device) return nullptr;
-    ID3D11Resource* res = nullptr;
-    bigRTV->GetResource(&res);
-    if (!res) return nullptr;
-    ID3D11Texture2D* bigTex = nullptr;
-    HRESULT hr = res->QueryInterface(__uuidof(ID3D11Texture2D), (void**)&bigTex);
-    res->Release();
-    if (FAILED(hr) || !bigTex) return nullptr;
-
-    D3D11_TEXTURE2D_DESC d{};
-    bigTex->GetDesc(&d);
-    std::lock_guard<std::mutex> lock(g_redirectMutex);
-    RedirectEntry& e = g_redirectMap[bigTex];
-    // If no entry or mismatched size/format, (re)create
-    if (!e.smallTex || e.smallW != prW || e.smallH != prH || e.format != d.Format) {
-        if (e.smallRTV) { e.smallRTV->Release(); e.smallRTV = nullptr; }
-        if (e.smallTex) { e.smallTex->Release(); e.smallTex = nullptr; }
-        D3D11_TEXTURE2D_DESC td = d;
-        td.Width = prW; td.Height = prH; td.MipLevels = 1; td.ArraySize = 1;
-        td.SampleDesc.Count = 1;
-        td.BindFlags |= D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
-        td.BindFlags &= ~(D3D11_BIND_DEPTH_STENCIL);
-        td.MiscFlags &= ~(D3D11_RESOURCE_MISC_SHARED);
-        if (FAILED(g_device->CreateTexture2D(&td, nullptr, &e.smallTex))) {
-            bigTex->Release();
-            g_redirectMap.erase(bigTex);
-            return nullptr;
+    DLSSRedirect::PassStats GetLastRedirectStats() {
+        return g_lastRedirectStats;
+    }
+
+    DLSSPassGraph::FrameStats GetLastPassGraphStats() {
+        return g_lastPassGraphStats;
+    }
+
+    DLSSOverlay::CpuStats GetOverlayStats() {
+        return g_overlayStats;
+    }
+
+    // Shader-resource binds of any stage. Shaders sample the big texture:
+    // a redirected target's twin content goes up first. The pass graph
+    // only follows pixel-shader reads (passGraph false for other stages).
+    static void NoteShaderReads(ID3D11DeviceContext* ctx, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs, bool passGraph) {
+        const bool redirect = IsRedirectModeActive(ctx);
+        if (!ppSRVs || !(passGraph || redirect)) return;
+        for (UINT i = 0; i < numViews; ++i) {
+            if (!ppSRVs[i]) continue;
+            ID3D11Resource* res = nullptr;
+            ppSRVs[i]->GetResource(&res);
+            if (res) {
+                const uintptr_t key = reinterpret_cast<uintptr_t>(res);
+                if (passGraph) g_passGraph.NoteRead(key);
+                if (redirect && g_bindingTable.IsRedirected(key)) MaterializeBig(res);
+                res->Release();
+            }
         }
-        if (FAILED(g_device->CreateRenderTargetView(e.smallTex, nullptr, &e.smallRTV))) {
-            e.smallTex->Release(); e.smallTex = nullptr;
-            bigTex->Release();
-            g_redirectMap.erase(bigTex);
-            return nullptr;
+    }
+
+    void STDMETHODCALLTYPE HookedPSSetShaderResources(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs) {
+        NoteShaderReads(ctx, numViews, ppSRVs, IsPassGraphFeed(ctx));
+        if (RealPSSetShaderResources) RealPSSetShaderResources(ctx, startSlot, numViews, ppSRVs);
+    }
+
+    void STDMETHODCALLTYPE HookedVSSetShaderResources(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs) {
+        NoteShaderReads(ctx, numViews, ppSRVs, false);
+        if (RealVSSetShaderResources) RealVSSetShaderResources(ctx, startSlot, numViews, ppSRVs);
+    }
+
+    void STDMETHODCALLTYPE HookedGSSetShaderResources(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs) {
+        NoteShaderReads(ctx, numViews, ppSRVs, false);
+        if (RealGSSetShaderResources) RealGSSetShaderResources(ctx, startSlot, numViews, ppSRVs);
+    }
+
+    void STDMETHODCALLTYPE HookedHSSetShaderResources(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs) {
+        NoteShaderReads(ctx, numViews, ppSRVs, false);
+        if (RealHSSetShaderResources) RealHSSetShaderResources(ctx, startSlot, numViews, ppSRVs);
+    }
+
+    void STDMETHODCALLTYPE HookedDSSetShaderResources(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs) {
+        NoteShaderReads(ctx, numViews, ppSRVs, false);
+        if (RealDSSetShaderResources) RealDSSetShaderResources(ctx, startSlot, numViews, ppSRVs);
+    }
+
+    // Compute passes (SSAO, bloom) read the scene through CS SRVs
+    void STDMETHODCALLTYPE HookedCSSetShaderResources(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs) {
+        NoteShaderReads(ctx, numViews, ppSRVs, false);
+        if (RealCSSetShaderResources) RealCSSetShaderResources(ctx, startSlot, numViews, ppSRVs);
+    }
+
+    void STDMETHODCALLTYPE HookedDrawIndexed(ID3D11DeviceContext* ctx, UINT indexCount, UINT startIndex, INT baseVertex) {
+        if (IsPassGraphFeed(ctx)) g_passGraph.NoteDraw();
+        if (RealDrawIndexed) RealDrawIndexed(ctx, indexCount, startIndex, baseVertex);
+    }
+
+    void STDMETHODCALLTYPE HookedDraw(ID3D11DeviceContext* ctx, UINT vertexCount, UINT startVertex) {
+        if (IsPassGraphFeed(ctx)) g_passGraph.NoteDraw();
+        if (RealDraw) RealDraw(ctx, vertexCount, startVertex);
+    }
+
+    void STDMETHODCALLTYPE HookedDrawIndexedInstanced(ID3D11DeviceContext* ctx, UINT indexCountPerInstance, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance) {
+        if (IsPassGraphFeed(ctx)) g_passGraph.NoteDraw();
+        if (RealDrawIndexedInstanced) RealDrawIndexedInstanced(ctx, indexCountPerInstance, instanceCount, startIndex, baseVertex, startInstance);
+    }
+
+    void STDMETHODCALLTYPE HookedDrawInstanced(ID3D11DeviceContext* ctx, UINT vertexCountPerInstance, UINT instanceCount, UINT startVertex, UINT startInstance) {
+        if (IsPassGraphFeed(ctx)) g_passGraph.NoteDraw();
+        if (RealDrawInstanced) RealDrawInstanced(ctx, vertexCountPerInstance, instanceCount, startVertex, startInstance);
+    }
+
+    // The list's work runs on 'ctx' now: its scene/clamp facts become this context's
+    void STDMETHODCALLTYPE HookedExecuteCommandList(ID3D11DeviceContext* ctx, ID3D11CommandList* list, BOOL restoreState) {
+        g_contextStates.Execute(reinterpret_cast<uintptr_t>(ctx), reinterpret_cast<uintptr_t>(list));
+        if (RealExecuteCommandList) RealExecuteCommandList(ctx, list, restoreState);
+        // Without RestoreContextState the runtime clears the context's pipeline state
+        if (!restoreState && !g_inRedirectComposite) {
+            if (DLSSContextState::Lease cs = g_contextStates.Acquire(reinterpret_cast<uintptr_t>(ctx))) cs->ResetPipeline();
         }
-        e.smallW = prW; e.smallH = prH; e.format = d.Format;
-        if (g_dlssConfig && g_dlssConfig->debugEarlyDlss) {
-            _MESSAGE("[EarlyDLSS][RT] Created small RT %ux%u for fmt=%u", prW, prH, (unsigned)d.Format);
+    }
+
+    // A deferred context closes its list: the facts recorded so far travel with it
+    HRESULT STDMETHODCALLTYPE HookedFinishCommandList(ID3D11DeviceContext* ctx, BOOL restoreState, ID3D11CommandList** list) {
+        const HRESULT hr = RealFinishCommandList ? RealFinishCommandList(ctx, restoreState, list) : E_FAIL;
+        if (SUCCEEDED(hr) && list && *list) {
+            g_contextStates.Finish(reinterpret_cast<uintptr_t>(ctx), reinterpret_cast<uintptr_t>(*list), restoreState != FALSE);
         }
+        return hr;
     }
-    bigTex->Release();
-    return e.smallRTV;
-}
 
-    // If a big scene RT gets rebound after redirect, composite small->big once
-    static void CompositeIfNeededOnBigBind(ID3D11RenderTargetView* bigRTV) {
-        if (!g_dlssConfig || !g_dlssConfig->earlyDlssEnabled) return;
-        if (!g_redirectUsedThisFrame.load(std::memory_order_relaxed) || g_compositedThisFrame) return;
-        if (!bigRTV) return;
-        // Resolve big texture key
-        ID3D11Resource* res=nullptr; bigRTV->GetResource(&res); if(!res) return; ID3D11Texture2D* bigTex=nullptr; if(FAILED(res->QueryInterface(__uuidof(ID3D11Texture2D),(void**)&bigTex))){ res->Release(); return; } res->Release();
-        // Lookup mapping
-        RedirectEntry entry{};
+    void STDMETHODCALLTYPE HookedClearRenderTargetView(ID3D11DeviceContext* ctx, ID3D11RenderTargetView* rtv, const FLOAT color[4]) {
+        if (IsPassGraphFeed(ctx)) g_passGraph.NoteClear();
+        if (IsRedirectModeActive(ctx) && rtv) {
+            D3D11_TEXTURE2D_DESC d{};
+            if (ID3D11Texture2D* big = GetTextureFromView(rtv, &d)) {
+                const uintptr_t key = reinterpret_cast<uintptr_t>(big);
+                RedirectEntry twin{};
+                // Clears usually come before the bind; a known twin adopts the redirect early
+                const bool translate = LookupTwin(big, twin) && twin.smallRTV && ViewMatchesTwin(rtv, false, twin) &&
+                                       g_bindingTable.AdoptRedirect(key);
+                big->Release();
+                if (translate) {
+                    if (RealClearRenderTargetView) RealClearRenderTargetView(ctx, twin.smallRTV, color);
+                    g_bindingTable.NoteTranslatedClear(TwinBytesSaved(d.Format, d.Width, d.Height, twin.smallW, twin.smallH));
+                    return;
+                }
+            }
+        }
+        if (RealClearRenderTargetView) RealClearRenderTargetView(ctx, rtv, color);
+    }
+
+    void STDMETHODCALLTYPE HookedClearDepthStencilView(ID3D11DeviceContext* ctx, ID3D11DepthStencilView* dsv, UINT clearFlags, FLOAT depth, UINT8 stencil) {
+        if (IsPassGraphFeed(ctx)) g_passGraph.NoteClear();
+        if (IsRedirectModeActive(ctx) && dsv) {
+            D3D11_TEXTURE2D_DESC d{};
+            if (ID3D11Texture2D* big = GetTextureFromView(dsv, &d)) {
+                const uintptr_t key = reinterpret_cast<uintptr_t>(big);
+                RedirectEntry twin{};
+                const bool translate = LookupTwin(big, twin) && twin.smallDSV && ViewMatchesTwin(dsv, true, twin) &&
+                                       g_bindingTable.AdoptRedirect(key);
+                big->Release();
+                if (translate) {
+                    if (RealClearDepthStencilView) RealClearDepthStencilView(ctx, twin.smallDSV, clearFlags, depth, stencil);
+                    g_bindingTable.NoteTranslatedClear(TwinBytesSaved(d.Format, d.Width, d.Height, twin.smallW, twin.smallH));
+                    return;
+                }
+            }
+        }
+        if (RealClearDepthStencilView) RealClearDepthStencilView(ctx, dsv, clearFlags, depth, stencil);
+    }
+
+    void STDMETHODCALLTYPE HookedCopyResource(ID3D11DeviceContext* ctx, ID3D11Resource* dst, ID3D11Resource* src) {
+        if (IsPassGraphFeed(ctx)) g_passGraph.NoteCopy(reinterpret_cast<uintptr_t>(dst), reinterpret_cast<uintptr_t>(src));
+        if (IsRedirectModeActive(ctx) && dst && src) {
+            RedirectEntry srcTwin{}, dstTwin{};
+            const bool srcRedirected = LookupTwin(src, srcTwin) && g_bindingTable.IsRedirected(reinterpret_cast<uintptr_t>(src));
+            const bool dstHasTwin = LookupTwin(dst, dstTwin);
+            if (srcRedirected) {
+                D3D11_TEXTURE2D_DESC d{};
+                static_cast<ID3D11Texture2D*>(src)->GetDesc(&d);
+                if (dstHasTwin && IsSingleSubresource(d) && dstTwin.smallW == srcTwin.smallW && dstTwin.smallH == srcTwin.smallH &&
+                    dstTwin.format == srcTwin.format && g_bindingTable.AdoptRedirect(reinterpret_cast<uintptr_t>(dst))) {
+                    // small -> small
+                    if (RealCopyResource) RealCopyResource(ctx, dstTwin.smallTex, srcTwin.smallTex);
+                    g_bindingTable.NoteTranslatedCopy(2 * TwinBytesSaved(d.Format, d.Width, d.Height, srcTwin.smallW, srcTwin.smallH));
+                    return;
+                }
+                // The destination wants full-size data: composite on demand
+                MaterializeBig(src);
+            } else if (dstHasTwin && g_bindingTable.IsRedirected(reinterpret_cast<uintptr_t>(dst))) {
+                // Whole resource overwritten at full size; the twin is stale now
+                g_bindingTable.MarkNative(reinterpret_cast<uintptr_t>(dst));
+            }
+        }
+        if (RealCopyResource) RealCopyResource(ctx, dst, src);
+    }
+
+    void STDMETHODCALLTYPE HookedCopySubresourceRegion(ID3D11DeviceContext* ctx, ID3D11Resource* dst, UINT dstSubresource, UINT dstX, UINT dstY, UINT dstZ, ID3D11Resource* src, UINT srcSubresource, const D3D11_BOX* srcBox) {
+        if (IsPassGraphFeed(ctx)) g_passGraph.NoteCopy(reinterpret_cast<uintptr_t>(dst), reinterpret_cast<uintptr_t>(src));
+        if (IsRedirectModeActive(ctx) && dst && src) {
+            RedirectEntry srcTwin{}, dstTwin{};
+            const bool srcRedirected = LookupTwin(src, srcTwin) && g_bindingTable.IsRedirected(reinterpret_cast<uintptr_t>(src));
+            const bool dstRedirected = LookupTwin(dst, dstTwin) && g_bindingTable.IsRedirected(reinterpret_cast<uintptr_t>(dst));
+            D3D11_TEXTURE2D_DESC d{}, dd{};
+            if (srcRedirected) static_cast<ID3D11Texture2D*>(src)->GetDesc(&d);
+            if (dstRedirected) static_cast<ID3D11Texture2D*>(dst)->GetDesc(&dd);
+            // Only the subresources the twins stand for live at render size
+            if (srcRedirected && dstRedirected && srcSubresource == TwinSubresource(d, srcTwin) &&
+                dstSubresource == TwinSubresource(dd, dstTwin) &&
+                dstTwin.smallW == srcTwin.smallW && dstTwin.smallH == srcTwin.smallH) {
+                // Both live at render size: scale the region onto the twins
+                const float sx = (float)srcTwin.smallW / (float)d.Width;
+                const float sy = (float)srcTwin.smallH / (float)d.Height;
+                D3D11_BOX box{};
+                if (srcBox) {
+                    box = *srcBox;
+                } else {
+                    box.right = d.Width; box.bottom = d.Height; box.back = 1;
+                }
+                box.left = (UINT)(box.left * sx); box.right = (std::min)((UINT)(box.right * sx + 0.5f), srcTwin.smallW);
+                box.top = (UINT)(box.top * sy); box.bottom = (std::min)((UINT)(box.bottom * sy + 0.5f), srcTwin.smallH);
+                if (box.right > box.left && box.bottom > box.top) {
+                    if (RealCopySubresourceRegion) {
+                        RealCopySubresourceRegion(ctx, dstTwin.smallTex, 0, (UINT)(dstX * sx), (UINT)(dstY * sy), dstZ, srcTwin.smallTex, 0, &box);
+                    }
+                    const UINT fullW = srcBox ? (srcBox->right - srcBox->left) : d.Width;
+                    const UINT fullH = srcBox ? (srcBox->bottom - srcBox->top) : d.Height;
+                    g_bindingTable.NoteTranslatedCopy(2 * TwinBytesSaved(d.Format, fullW, fullH, box.right - box.left, box.bottom - box.top));
+                }
+                return;
+            }
+            // Any other subresource of a redirected texture (another slice or
+            // a mip) is touched at full size: the whole resource goes native
+            if (srcRedirected) {
+                MaterializeBig(src);
+            }
+            if (dstRedirected) {
+                // Partial overwrite: keep the rest of the twin's content
+                MaterializeBig(dst);
+            }
+        }
+        if (RealCopySubresourceRegion) RealCopySubresourceRegion(ctx, dst, dstSubresource, dstX, dstY, dstZ, src, srcSubresource, srcBox);
+    }
+
+    void STDMETHODCALLTYPE HookedResolveSubresource(ID3D11DeviceContext* ctx, ID3D11Resource* dst, UINT dstSubresource, ID3D11Resource* src, UINT srcSubresource, DXGI_FORMAT format) {
+        if (IsPassGraphFeed(ctx)) g_passGraph.NoteCopy(reinterpret_cast<uintptr_t>(dst), reinterpret_cast<uintptr_t>(src));
+        // MSAA sources are never redirected (twins are single-sampled), so a resolve
+        // always produces full-size data; a redirected destination goes native.
+        if (IsRedirectModeActive(ctx) && dst) {
+            RedirectEntry dstTwin{};
+            if (LookupTwin(dst, dstTwin) && g_bindingTable.IsRedirected(reinterpret_cast<uintptr_t>(dst))) {
+                D3D11_TEXTURE2D_DESC d{};
+                static_cast<ID3D11Texture2D*>(dst)->GetDesc(&d);
+                if (dstSubresource == TwinSubresource(d, dstTwin)) {
+                    // The twin's whole subresource is overwritten; it is stale now
+                    g_bindingTable.MarkNative(reinterpret_cast<uintptr_t>(dst));
+                } else {
+                    // Another subresource: keep the twin's content, drop the redirect
+                    MaterializeBig(dst);
+                }
+            }
+        }
+        if (RealResolveSubresource) RealResolveSubresource(ctx, dst, dstSubresource, src, srcSubresource, format);
+    }
+
+    // Returns the byte size if 'resource' is a constant buffer, 0 otherwise
+    static UINT GetConstantBufferSize(ID3D11Resource* resource) {
+        if (!resource) return 0;
+        D3D11_RESOURCE_DIMENSION dim = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+        resource->GetType(&dim);
+        if (dim != D3D11_RESOURCE_DIMENSION_BUFFER) return 0;
+        D3D11_BUFFER_DESC bd{};
+        static_cast<ID3D11Buffer*>(resource)->GetDesc(&bd);
+        return (bd.BindFlags & D3D11_BIND_CONSTANT_BUFFER) ? bd.ByteWidth : 0;
+    }
+
+    static bool IsProjectionPatchEnabled() {
+        return g_dlssConfig && g_dlssConfig->cameraPatchProjection && g_dlssConfig->enableJitter && g_dlssManager;
+    }
+
+    // Applies the current eye's jitter to the projection inside 'data', which
+    // must be our own cached copy of the upload. Caller holds g_cbMutex.
+    static bool PatchProjection(ID3D11Resource* resource, void* data, UINT size) {
+        DLSSCBuffer::MatrixLayout layout{};
+        float* proj = g_cbClassifier.Locate(reinterpret_cast<uintptr_t>(resource), data, size, layout);
+        if (!proj) return false;
+        const int eye = DLSSCBuffer::EyeFromProjection(proj, layout);
+        if (eye < 0) return false;
+        DLSSCamera::CameraConstantsProvider& camera = g_dlssManager->GetCameraProvider();
+        const DLSSCamera::JitterSample& j = camera.CurrentJitter(eye);
+        DLSSCBuffer::ApplyJitter(proj, layout, j.clipX, j.clipY);
+        camera.SetJitterInjectionActive(true);
+        g_cbClassifier.NotePatch();
+        return true;
+    }
+
+    void STDMETHODCALLTYPE HookedUpdateSubresource(ID3D11DeviceContext* ctx, ID3D11Resource* dst, UINT dstSubresource, const D3D11_BOX* dstBox, const void* srcData, UINT srcRowPitch, UINT srcDepthPitch) {
+        // CPU uploads into a redirected texture land at full size, like a copy
+        if (IsRedirectModeActive(ctx) && dst && g_bindingTable.IsRedirected(reinterpret_cast<uintptr_t>(dst))) {
+            RedirectEntry dstTwin{};
+            if (LookupTwin(dst, dstTwin)) {
+                D3D11_TEXTURE2D_DESC d{};
+                static_cast<ID3D11Texture2D*>(dst)->GetDesc(&d);
+                if (!dstBox && dstSubresource == TwinSubresource(d, dstTwin)) {
+                    g_bindingTable.MarkNative(reinterpret_cast<uintptr_t>(dst));
+                } else {
+                    MaterializeBig(dst);
+                }
+            }
+        }
+        // Whole-buffer uploads only; partial updates cannot be matched reliably
+        if (!IsProjectionPatchEnabled() || dstBox || dstSubresource != 0 || !srcData) {
+            if (RealUpdateSubresource) RealUpdateSubresource(ctx, dst, dstSubresource, dstBox, srcData, srcRowPitch, srcDepthPitch);
+            return;
+        }
+        const UINT size = GetConstantBufferSize(dst);
+        if (size == 0) {
+            if (RealUpdateSubresource) RealUpdateSubresource(ctx, dst, dstSubresource, dstBox, srcData, srcRowPitch, srcDepthPitch);
+            return;
+        }
+        // The source is the game's (possibly read-only, possibly shared)
+        // memory: patch a per-thread copy and upload that instead. The copy's
+        // storage is kept, so a warm thread does not allocate.
+        thread_local std::vector<uint8_t> t_upload;
+        bool patched = false;
         {
-            std::lock_guard<std::mutex> lock(g_redirectMutex);
-            auto it = g_redirectMap.find(bigTex);
-            if (it == g_redirectMap.end() || !it->second.smallTex) { bigTex->Release(); return; }
-            entry = it->second;
-        }
-        // Use DLSSManager blit helper to copy small->big
-        if (g_dlssManager && entry.smallTex) {
-            if (g_dlssManager->BlitToRTV(entry.smallTex, bigRTV, g_sceneRTDesc.Width, g_sceneRTDesc.Height)) {
-                g_compositedThisFrame = true;
-                if (g_dlssConfig->debugEarlyDlss) {
-                    _MESSAGE("[EarlyDLSS][Composite] small->big %ux%u", g_sceneRTDesc.Width, g_sceneRTDesc.Height);
+            std::lock_guard<std::mutex> lock(g_cbMutex);
+            if (!g_cbClassifier.IsRejected(reinterpret_cast<uintptr_t>(dst), size)) {
+                t_upload.assign(static_cast<const uint8_t*>(srcData), static_cast<const uint8_t*>(srcData) + size);
+                patched = PatchProjection(dst, t_upload.data(), size);
+            }
+        }
+        if (RealUpdateSubresource) RealUpdateSubresource(ctx, dst, dstSubresource, dstBox, patched ? t_upload.data() : srcData, srcRowPitch, srcDepthPitch);
+    }
+
+    HRESULT STDMETHODCALLTYPE HookedMap(ID3D11DeviceContext* ctx, ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mapped) {
+        HRESULT hr = RealMap ? RealMap(ctx, resource, subresource, mapType, mapFlags, mapped) : E_FAIL;
+        if (FAILED(hr) || !mapped || !mapped->pData || subresource != 0 || !IsProjectionPatchEnabled()) {
+            return hr;
+        }
+        // Only a discard leaves the whole buffer to the game; any other map
+        // keeps contents the shadow would not have
+        if (mapType != D3D11_MAP_WRITE_DISCARD) {
+            return hr;
+        }
+        const UINT size = GetConstantBufferSize(resource);
+        if (size == 0) {
+            return hr;
+        }
+        std::lock_guard<std::mutex> lock(g_cbMutex);
+        if (g_cbClassifier.IsRejected(reinterpret_cast<uintptr_t>(resource), size)) {
+            return hr;
+        }
+        void* shadow = g_cbMapShadows.Begin(reinterpret_cast<uintptr_t>(ctx), reinterpret_cast<uintptr_t>(resource), mapped->pData, size);
+        if (shadow) {
+            mapped->pData = shadow;
+            g_cbOpenShadows.store(static_cast<uint32_t>(g_cbMapShadows.OpenCount()), std::memory_order_relaxed);
+        }
+        return hr;
+    }
+
+    void STDMETHODCALLTYPE HookedUnmap(ID3D11DeviceContext* ctx, ID3D11Resource* resource, UINT subresource) {
+        if (subresource == 0 && resource && g_cbOpenShadows.load(std::memory_order_relaxed) != 0) {
+            std::lock_guard<std::mutex> lock(g_cbMutex);
+            DLSSCBuffer::MapShadows::Slot* slot = g_cbMapShadows.Find(reinterpret_cast<uintptr_t>(ctx), reinterpret_cast<uintptr_t>(resource));
+            if (slot) {
+                // The game wrote the shadow: patch it there (cached memory),
+                // then stream it to the real mapping before it closes. A patch
+                // toggled off mid-map still needs the copy.
+                if (IsProjectionPatchEnabled()) {
+                    PatchProjection(resource, slot->shadow.data(), slot->size);
                 }
+                g_cbMapShadows.End(*slot);
+                g_cbOpenShadows.store(static_cast<uint32_t>(g_cbMapShadows.OpenCount()), std::memory_order_relaxed);
             }
         }
-        bigTex->Release();
-    }
\ No newline at end of file
+        if (RealUnmap) RealUnmap(ctx, resource, subresource);
+    }
+}
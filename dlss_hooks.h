@@ -3,12 +3,18 @@
 #include <dxgi.h>
 #include <stdint.h>
 
+#include "dlss_redirect.h"
+#include "dlss_passgraph.h"
+#include "dlss_overlay.h"
+
 // Function to install all DLSS hooks
 #ifdef __cplusplus
 extern "C" {
 #endif
 bool InstallDLSSHooks();
 void SetOverlaySafeMode(bool enabled);
+// Game load in progress (F4SE PreLoadGame until PostLoadGame/NewGame); DLSS history resets meanwhile
+void SetGameLoading(bool loading);
 #ifdef __cplusplus
 }
 #endif
@@ -36,12 +42,88 @@ namespace DLSSHooks {
 
     // Context hooks for early DLSS (Phase 1, viewport clamp)
     typedef void (STDMETHODCALLTYPE* PFN_RSSetViewports)(ID3D11DeviceContext* ctx, UINT count, const D3D11_VIEWPORT* viewports);
+    typedef void (STDMETHODCALLTYPE* PFN_RSSetScissorRects)(ID3D11DeviceContext* ctx, UINT count, const D3D11_RECT* rects);
     typedef void (STDMETHODCALLTYPE* PFN_OMSetRenderTargets)(ID3D11DeviceContext* ctx, UINT numRTVs, ID3D11RenderTargetView* const* ppRTVs, ID3D11DepthStencilView* pDSV);
     extern PFN_RSSetViewports RealRSSetViewports;
+    extern PFN_RSSetScissorRects RealRSSetScissorRects;
     extern PFN_OMSetRenderTargets RealOMSetRenderTargets;
     void STDMETHODCALLTYPE HookedRSSetViewports(ID3D11DeviceContext* ctx, UINT count, const D3D11_VIEWPORT* viewports);
+    void STDMETHODCALLTYPE HookedRSSetScissorRects(ID3D11DeviceContext* ctx, UINT count, const D3D11_RECT* rects);
     void STDMETHODCALLTYPE HookedOMSetRenderTargets(ID3D11DeviceContext* ctx, UINT numRTVs, ID3D11RenderTargetView* const* ppRTVs, ID3D11DepthStencilView* pDSV);
 
+    // Constant-buffer hooks: locate the per-eye projection and apply the DLSS jitter in place
+    typedef void (STDMETHODCALLTYPE* PFN_UpdateSubresource)(ID3D11DeviceContext* ctx, ID3D11Resource* dst, UINT dstSubresource, const D3D11_BOX* dstBox, const void* srcData, UINT srcRowPitch, UINT srcDepthPitch);
+    typedef HRESULT (STDMETHODCALLTYPE* PFN_Map)(ID3D11DeviceContext* ctx, ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mapped);
+    typedef void (STDMETHODCALLTYPE* PFN_Unmap)(ID3D11DeviceContext* ctx, ID3D11Resource* resource, UINT subresource);
+    extern PFN_UpdateSubresource RealUpdateSubresource;
+    extern PFN_Map RealMap;
+    extern PFN_Unmap RealUnmap;
+    void STDMETHODCALLTYPE HookedUpdateSubresource(ID3D11DeviceContext* ctx, ID3D11Resource* dst, UINT dstSubresource, const D3D11_BOX* dstBox, const void* srcData, UINT srcRowPitch, UINT srcDepthPitch);
+    HRESULT STDMETHODCALLTYPE HookedMap(ID3D11DeviceContext* ctx, ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mapped);
+    void STDMETHODCALLTYPE HookedUnmap(ID3D11DeviceContext* ctx, ID3D11Resource* resource, UINT subresource);
+
+    // Redirect-aware clears/copies (early DLSS phase 2): run on the render-size twin when the big target is redirected
+    typedef void (STDMETHODCALLTYPE* PFN_ClearRenderTargetView)(ID3D11DeviceContext* ctx, ID3D11RenderTargetView* rtv, const FLOAT color[4]);
+    typedef void (STDMETHODCALLTYPE* PFN_ClearDepthStencilView)(ID3D11DeviceContext* ctx, ID3D11DepthStencilView* dsv, UINT clearFlags, FLOAT depth, UINT8 stencil);
+    typedef void (STDMETHODCALLTYPE* PFN_CopyResource)(ID3D11DeviceContext* ctx, ID3D11Resource* dst, ID3D11Resource* src);
+    typedef void (STDMETHODCALLTYPE* PFN_CopySubresourceRegion)(ID3D11DeviceContext* ctx, ID3D11Resource* dst, UINT dstSubresource, UINT dstX, UINT dstY, UINT dstZ, ID3D11Resource* src, UINT srcSubresource, const D3D11_BOX* srcBox);
+    typedef void (STDMETHODCALLTYPE* PFN_ResolveSubresource)(ID3D11DeviceContext* ctx, ID3D11Resource* dst, UINT dstSubresource, ID3D11Resource* src, UINT srcSubresource, DXGI_FORMAT format);
+    extern PFN_ClearRenderTargetView RealClearRenderTargetView;
+    extern PFN_ClearDepthStencilView RealClearDepthStencilView;
+    extern PFN_CopyResource RealCopyResource;
+    extern PFN_CopySubresourceRegion RealCopySubresourceRegion;
+    extern PFN_ResolveSubresource RealResolveSubresource;
+    void STDMETHODCALLTYPE HookedClearRenderTargetView(ID3D11DeviceContext* ctx, ID3D11RenderTargetView* rtv, const FLOAT color[4]);
+    void STDMETHODCALLTYPE HookedClearDepthStencilView(ID3D11DeviceContext* ctx, ID3D11DepthStencilView* dsv, UINT clearFlags, FLOAT depth, UINT8 stencil);
+    void STDMETHODCALLTYPE HookedCopyResource(ID3D11DeviceContext* ctx, ID3D11Resource* dst, ID3D11Resource* src);
+    void STDMETHODCALLTYPE HookedCopySubresourceRegion(ID3D11DeviceContext* ctx, ID3D11Resource* dst, UINT dstSubresource, UINT dstX, UINT dstY, UINT dstZ, ID3D11Resource* src, UINT srcSubresource, const D3D11_BOX* srcBox);
+    void STDMETHODCALLTYPE HookedResolveSubresource(ID3D11DeviceContext* ctx, ID3D11Resource* dst, UINT dstSubresource, ID3D11Resource* src, UINT srcSubresource, DXGI_FORMAT format);
+
+    // Pass-graph feed: draws and shader-resource binds (reads) of the immediate context
+    typedef void (STDMETHODCALLTYPE* PFN_PSSetShaderResources)(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs);
+    typedef void (STDMETHODCALLTYPE* PFN_DrawIndexed)(ID3D11DeviceContext* ctx, UINT indexCount, UINT startIndex, INT baseVertex);
+    typedef void (STDMETHODCALLTYPE* PFN_Draw)(ID3D11DeviceContext* ctx, UINT vertexCount, UINT startVertex);
+    typedef void (STDMETHODCALLTYPE* PFN_DrawIndexedInstanced)(ID3D11DeviceContext* ctx, UINT indexCountPerInstance, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance);
+    typedef void (STDMETHODCALLTYPE* PFN_DrawInstanced)(ID3D11DeviceContext* ctx, UINT vertexCountPerInstance, UINT instanceCount, UINT startVertex, UINT startInstance);
+    extern PFN_PSSetShaderResources RealPSSetShaderResources;
+    // The other stages' binds have the same signature; RT redirect composites
+    // twins read through them (the pass graph only follows PS reads)
+    typedef PFN_PSSetShaderResources PFN_SetShaderResources;
+    extern PFN_SetShaderResources RealVSSetShaderResources;
+    extern PFN_SetShaderResources RealGSSetShaderResources;
+    extern PFN_SetShaderResources RealHSSetShaderResources;
+    extern PFN_SetShaderResources RealDSSetShaderResources;
+    extern PFN_SetShaderResources RealCSSetShaderResources;
+    extern PFN_DrawIndexed RealDrawIndexed;
+    extern PFN_Draw RealDraw;
+    extern PFN_DrawIndexedInstanced RealDrawIndexedInstanced;
+    extern PFN_DrawInstanced RealDrawInstanced;
+    void STDMETHODCALLTYPE HookedPSSetShaderResources(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs);
+    void STDMETHODCALLTYPE HookedVSSetShaderResources(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs);
+    void STDMETHODCALLTYPE HookedGSSetShaderResources(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs);
+    void STDMETHODCALLTYPE HookedHSSetShaderResources(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs);
+    void STDMETHODCALLTYPE HookedDSSetShaderResources(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs);
+    void STDMETHODCALLTYPE HookedCSSetShaderResources(ID3D11DeviceContext* ctx, UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppSRVs);
+    void STDMETHODCALLTYPE HookedDrawIndexed(ID3D11DeviceContext* ctx, UINT indexCount, UINT startIndex, INT baseVertex);
+    void STDMETHODCALLTYPE HookedDraw(ID3D11DeviceContext* ctx, UINT vertexCount, UINT startVertex);
+    void STDMETHODCALLTYPE HookedDrawIndexedInstanced(ID3D11DeviceContext* ctx, UINT indexCountPerInstance, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance);
+    void STDMETHODCALLTYPE HookedDrawInstanced(ID3D11DeviceContext* ctx, UINT vertexCountPerInstance, UINT instanceCount, UINT startVertex, UINT startInstance);
+
+    // Command lists: deferred-context early-DLSS facts merge into the executing context
+    typedef void (STDMETHODCALLTYPE* PFN_ExecuteCommandList)(ID3D11DeviceContext* ctx, ID3D11CommandList* list, BOOL restoreState);
+    typedef HRESULT (STDMETHODCALLTYPE* PFN_FinishCommandList)(ID3D11DeviceContext* ctx, BOOL restoreState, ID3D11CommandList** list);
+    extern PFN_ExecuteCommandList RealExecuteCommandList;
+    extern PFN_FinishCommandList RealFinishCommandList;
+    void STDMETHODCALLTYPE HookedExecuteCommandList(ID3D11DeviceContext* ctx, ID3D11CommandList* list, BOOL restoreState);
+    HRESULT STDMETHODCALLTYPE HookedFinishCommandList(ID3D11DeviceContext* ctx, BOOL restoreState, ID3D11CommandList** list);
+
+    // Early DLSS redirect counters of the last completed frame
+    DLSSRedirect::PassStats GetLastRedirectStats();
+    // Pass-graph counters of the last completed frame
+    DLSSPassGraph::FrameStats GetLastPassGraphStats();
+    // Present-hook CPU time with the menu hidden vs open
+    DLSSOverlay::CpuStats GetOverlayStats();
+
     void RegisterMotionVectorTexture(ID3D11Texture2D* motionTexture);
     void RegisterFallbackDepthTexture(ID3D11Texture2D* depthTexture,
                                       const D3D11_TEXTURE2D_DESC* desc = nullptr,
@@ -57,6 +139,9 @@ namespace DLSSHooks {
 
     // Per-eye display size (output) detected from OpenVR Submit bounds (0=Left,1=Right)
     bool GetPerEyeDisplaySize(int eyeIndex, uint32_t& outW, uint32_t& outH);
+
+    // Set through SetGameLoading from the F4SE message listener
+    bool IsGameLoading();
 }
 
 
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+
+// Decisions of the staged runtime bring-up (DLSSManager::BeginAsyncInitialize
+// / PollInitialize) that do not need the device: the retry backoff after a
+// failed attempt, and which backend survives an attempt. Platform-free so
+// the retry path can be exercised without a GPU.
+namespace DLSSInit {
+
+    constexpr uint64_t kRetryFrames = 300;      // after the first failure
+    constexpr uint64_t kRetryMaxFrames = 9600;  // doubling per failure up to this
+
+    // Frames to wait after the 'failures'-th failed attempt
+    constexpr uint64_t RetryDelay(uint32_t failures) {
+        uint64_t delay = kRetryFrames;
+        for (uint32_t i = 1; i < failures && delay < kRetryMaxFrames; ++i) delay *= 2;
+        return delay < kRetryMaxFrames ? delay : kRetryMaxFrames;
+    }
+
+    // Backend handover on the render thread. A backend the worker prepared
+    // for this attempt replaces the current one, which can only be left over
+    // from an attempt that failed or never became ready. Returns the backend
+    // the caller has to shut down and delete (nullptr if none).
+    template <typename Backend>
+    Backend* AdoptPrepared(Backend*& current, Backend*& prepared) {
+        if (!prepared) return nullptr;
+        Backend* stale = current;
+        current = prepared;
+        prepared = nullptr;
+        return stale;
+    }
+}
@@ -0,0 +1,167 @@
+#include "dlss_input.h"
+#include "common/IDebugLog.h"
+
+#include <windows.h>
+
+#include <atomic>
+#include <thread>
+
+namespace DLSSInput {
+
+    namespace {
+        EventQueue g_events;
+
+        std::thread g_sinkThread;
+        std::atomic<DWORD> g_sinkThreadId{0};
+        std::atomic<bool> g_sinkActive{false};
+        std::atomic<bool> g_windowSourceActive{false};
+
+        bool g_polledDown[256] = {};
+
+        void PushKey(uint16_t vk, bool down) {
+            KeyEvent ev;
+            ev.vk = vk;
+            ev.down = down;
+            ev.timeMs = GetTickCount();
+            g_events.Push(ev);
+        }
+
+        // Registering keyboard raw input for our window would retarget the
+        // game's own registration, so only claim it when nobody has
+        bool KeyboardRawInputTaken() {
+            UINT count = 0;
+            GetRegisteredRawInputDevices(nullptr, &count, sizeof(RAWINPUTDEVICE));
+            if (count == 0) return false;
+            // Conservative when the list cannot be read
+            RAWINPUTDEVICE devices[16] = {};
+            if (count > 16 || GetRegisteredRawInputDevices(devices, &count, sizeof(RAWINPUTDEVICE)) == (UINT)-1) return true;
+            for (UINT i = 0; i < count; ++i) {
+                if (devices[i].usUsagePage == 0x01 && devices[i].usUsage == 0x06) return true;
+            }
+            return false;
+        }
+
+        LRESULT CALLBACK SinkWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+            if (msg == WM_INPUT) {
+                RAWINPUT input{};
+                UINT size = sizeof(input);
+                if (GetRawInputData(reinterpret_cast<HRAWINPUT>(lParam), RID_INPUT, &input, &size, sizeof(RAWINPUTHEADER)) != (UINT)-1 &&
+                    input.header.dwType == RIM_TYPEKEYBOARD && input.data.keyboard.VKey != 0xFF) {
+                    PushKey(input.data.keyboard.VKey, (input.data.keyboard.Flags & RI_KEY_BREAK) == 0);
+                }
+            }
+            return DefWindowProcW(hwnd, msg, wParam, lParam);
+        }
+
+        void SinkThread(HANDLE ready) {
+            g_sinkThreadId.store(GetCurrentThreadId(), std::memory_order_release);
+            WNDCLASSW wc{};
+            wc.lpfnWndProc = SinkWndProc;
+            wc.hInstance = GetModuleHandleW(nullptr);
+            wc.lpszClassName = L"F4SEVR_DLSS_InputSink";
+            RegisterClassW(&wc);
+            HWND hwnd = CreateWindowExW(0, wc.lpszClassName, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, wc.hInstance, nullptr);
+
+            RAWINPUTDEVICE rid{};
+            rid.usUsagePage = 0x01;  // generic desktop
+            rid.usUsage = 0x06;      // keyboard
+            rid.dwFlags = RIDEV_INPUTSINK;
+            rid.hwndTarget = hwnd;
+            const bool ok = hwnd && RegisterRawInputDevices(&rid, 1, sizeof(rid));
+            g_sinkActive.store(ok, std::memory_order_release);
+            SetEvent(ready);
+
+            if (ok) {
+                MSG msg;
+                while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+                    DispatchMessageW(&msg);
+                }
+                rid.dwFlags = RIDEV_REMOVE;
+                rid.hwndTarget = nullptr;
+                RegisterRawInputDevices(&rid, 1, sizeof(rid));
+            }
+            if (hwnd) DestroyWindow(hwnd);
+            UnregisterClassW(wc.lpszClassName, wc.hInstance);
+            g_sinkActive.store(false, std::memory_order_release);
+        }
+    }
+
+    EventQueue& Events() {
+        return g_events;
+    }
+
+    bool OnWindowMessage(unsigned msg, uintptr_t wParam, intptr_t lParam) {
+        switch (msg) {
+            case WM_KEYDOWN:
+            case WM_SYSKEYDOWN:
+                // Bit 30: key was already down (auto-repeat); the matcher ignores it anyway
+                if ((lParam & (1 << 30)) == 0) PushKey(static_cast<uint16_t>(wParam), true);
+                return true;
+            case WM_KEYUP:
+            case WM_SYSKEYUP:
+                PushKey(static_cast<uint16_t>(wParam), false);
+                return true;
+            case WM_KILLFOCUS:
+                // Key-ups go elsewhere from now on; drop held state
+                PushKey(0, false);
+                return false;
+            default:
+                return false;
+        }
+    }
+
+    void SetWindowSourceActive(bool active) {
+        g_windowSourceActive.store(active, std::memory_order_release);
+    }
+
+    bool HasEventSource() {
+        return g_windowSourceActive.load(std::memory_order_acquire) || g_sinkActive.load(std::memory_order_acquire);
+    }
+
+    bool StartRawInputSink() {
+        if (g_sinkThread.joinable()) {
+            return g_sinkActive.load(std::memory_order_acquire);
+        }
+        if (KeyboardRawInputTaken()) {
+            _MESSAGE("[Input] Keyboard raw input already registered by the game; polling hotkeys instead");
+            return false;
+        }
+        HANDLE ready = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!ready) return false;
+        g_sinkThread = std::thread(SinkThread, ready);
+        WaitForSingleObject(ready, 2000);
+        CloseHandle(ready);
+        const bool ok = g_sinkActive.load(std::memory_order_acquire);
+        if (!ok) {
+            StopRawInputSink();
+            _MESSAGE("[Input] Raw input sink unavailable; polling hotkeys instead");
+        } else {
+            _MESSAGE("[Input] Raw input sink active (overlay safe mode)");
+        }
+        return ok;
+    }
+
+    void StopRawInputSink() {
+        if (!g_sinkThread.joinable()) return;
+        const DWORD id = g_sinkThreadId.load(std::memory_order_acquire);
+        if (id) PostThreadMessageW(id, WM_QUIT, 0, 0);
+        g_sinkThread.join();
+        g_sinkThreadId.store(0, std::memory_order_release);
+    }
+
+    bool IsRawInputSinkActive() {
+        return g_sinkActive.load(std::memory_order_acquire);
+    }
+
+    void PollKeys(const uint16_t* keys, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            const uint16_t vk = keys[i];
+            if (vk == 0 || vk >= 256) continue;
+            const bool down = (GetAsyncKeyState(vk) & 0x8000) != 0;
+            if (down != g_polledDown[vk]) {
+                g_polledDown[vk] = down;
+                PushKey(vk, down);
+            }
+        }
+    }
+}
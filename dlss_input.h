@@ -0,0 +1,259 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Event-driven hotkeys. Key transitions are produced where Windows delivers
+// them (the hooked game WndProc, or a raw-input sink when overlay safe mode
+// leaves the WndProc alone) and pushed into a single-producer/single-consumer
+// ring. The render thread drains the ring once per Present and feeds a chord
+// matcher, so an idle keyboard costs one empty-queue check per frame.
+//
+// Everything in this header is platform-free; the Win32 producers live in
+// dlss_input.cpp.
+namespace DLSSInput {
+
+    // Lock-free ring for one producer thread and one consumer thread.
+    // Capacity must be a power of two; one slot is never used.
+    template <typename T, size_t Capacity>
+    class SpscQueue {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+    public:
+        // Producer side. Returns false (and counts a drop) when full.
+        bool Push(const T& value) {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            const size_t next = (head + 1) & (Capacity - 1);
+            if (next == m_tail.load(std::memory_order_acquire)) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            m_items[head] = value;
+            m_head.store(next, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side
+        bool Pop(T& out) {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_head.load(std::memory_order_acquire)) {
+                return false;
+            }
+            out = m_items[tail];
+            m_tail.store((tail + 1) & (Capacity - 1), std::memory_order_release);
+            return true;
+        }
+
+        bool Empty() const {
+            return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+        }
+
+        uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        // Producer and consumer indices on separate cache lines
+        alignas(64) std::atomic<size_t> m_head{0};
+        alignas(64) std::atomic<size_t> m_tail{0};
+        alignas(64) std::atomic<uint64_t> m_dropped{0};
+        T m_items[Capacity];
+    };
+
+    // Windows virtual-key codes the matcher needs (no windows.h here)
+    namespace Vk {
+        constexpr uint16_t Shift = 0x10, Control = 0x11, Menu = 0x12;
+        constexpr uint16_t LShift = 0xA0, RShift = 0xA1;
+        constexpr uint16_t LControl = 0xA2, RControl = 0xA3;
+        constexpr uint16_t LMenu = 0xA4, RMenu = 0xA5;
+    }
+
+    enum Modifier : uint32_t {
+        ModNone = 0,
+        ModCtrl = 1u << 0,
+        ModShift = 1u << 1,
+        ModAlt = 1u << 2,
+        ModMask = ModCtrl | ModShift | ModAlt
+    };
+
+    // A chord is the virtual key in the low 16 bits and the required
+    // modifiers above it; a plain virtual-key code is a chord without
+    // modifiers, so existing INI values keep working.
+    constexpr int MakeChord(int vk, uint32_t mods) {
+        return (vk & 0xFFFF) | static_cast<int>((mods & ModMask) << 16);
+    }
+    constexpr uint16_t ChordKey(int chord) { return static_cast<uint16_t>(chord & 0xFFFF); }
+    constexpr uint32_t ChordMods(int chord) { return (static_cast<uint32_t>(chord) >> 16) & ModMask; }
+
+    // Modifier named by a chord prefix: "Ctrl", "Control", "Shift" or "Alt",
+    // any case. ModNone for anything else.
+    inline uint32_t ParseModifier(std::string_view token) {
+        auto equals = [token](std::string_view name) {
+            if (token.size() != name.size()) return false;
+            for (size_t i = 0; i < name.size(); ++i) {
+                const char c = token[i];
+                if ((c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c) != name[i]) return false;
+            }
+            return true;
+        };
+        if (equals("ctrl") || equals("control")) return ModCtrl;
+        if (equals("shift")) return ModShift;
+        if (equals("alt")) return ModAlt;
+        return ModNone;
+    }
+
+    // "Ctrl+Shift+0x47" split into its modifiers and the key text after the
+    // last '+', spaces trimmed. A prefix that is not a modifier ("Win+0x47")
+    // fails and is returned in badToken: the binding is rejected rather than
+    // read as the bare key.
+    struct ChordText {
+        uint32_t mods = ModNone;
+        std::string_view key;
+        std::string_view badToken;
+    };
+
+    inline std::string_view TrimSpaces(std::string_view text) {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+        return text;
+    }
+
+    inline bool SplitChord(std::string_view value, ChordText& out) {
+        out = ChordText{};
+        for (size_t plus = value.find('+'); plus != std::string_view::npos; plus = value.find('+')) {
+            const std::string_view token = TrimSpaces(value.substr(0, plus));
+            const uint32_t mod = ParseModifier(token);
+            if (mod == ModNone) {
+                out.badToken = token;
+                return false;
+            }
+            out.mods |= mod;
+            value.remove_prefix(plus + 1);
+        }
+        out.key = TrimSpaces(value);
+        return true;
+    }
+
+    struct KeyEvent {
+        uint16_t vk = 0;        // 0 with down=false: release everything (focus lost)
+        bool down = false;
+        uint32_t timeMs = 0;    // producer timestamp, wraps
+    };
+
+    // Left/right variants collapse onto the generic modifier keys
+    constexpr uint16_t NormalizeKey(uint16_t vk) {
+        return (vk == Vk::LShift || vk == Vk::RShift) ? Vk::Shift
+             : (vk == Vk::LControl || vk == Vk::RControl) ? Vk::Control
+             : (vk == Vk::LMenu || vk == Vk::RMenu) ? Vk::Menu
+             : vk;
+    }
+
+    constexpr uint32_t ModifierOf(uint16_t vk) {
+        return vk == Vk::Control ? ModCtrl : vk == Vk::Shift ? ModShift : vk == Vk::Menu ? ModAlt : ModNone;
+    }
+
+    // Turns key transitions into action indices. An action fires on the
+    // press of its key while exactly its modifiers are held; auto-repeat
+    // presses are ignored and an action cannot fire again within the
+    // debounce window.
+    class ChordMatcher {
+    public:
+        static constexpr int kMaxActions = 8;
+        static constexpr int kNoAction = -1;
+
+        void SetDebounceMs(uint32_t ms) { m_debounceMs = ms; }
+
+        void Bind(int action, int chord) {
+            if (action < 0 || action >= kMaxActions) return;
+            m_chords[action] = chord;
+            m_hasFired[action] = false;
+        }
+
+        void ClearBindings() {
+            for (int i = 0; i < kMaxActions; ++i) {
+                m_chords[i] = 0;
+                m_hasFired[i] = false;
+            }
+        }
+
+        void ReleaseAll() {
+            for (uint32_t& word : m_down) word = 0;
+        }
+
+        bool IsDown(uint16_t vk) const {
+            vk = NormalizeKey(vk);
+            return vk < 256 && (m_down[vk >> 5] & (1u << (vk & 31))) != 0;
+        }
+
+        // Returns the action triggered by this event, or kNoAction
+        int Feed(const KeyEvent& ev) {
+            if (ev.vk == 0) {
+                ReleaseAll();
+                return kNoAction;
+            }
+            const uint16_t vk = NormalizeKey(ev.vk);
+            if (vk >= 256) return kNoAction;
+            const uint32_t bit = 1u << (vk & 31);
+            uint32_t& word = m_down[vk >> 5];
+            if (!ev.down) {
+                word &= ~bit;
+                return kNoAction;
+            }
+            if (word & bit) {
+                return kNoAction;  // auto-repeat
+            }
+            word |= bit;
+
+            // Held modifiers, not counting the key just pressed
+            const uint32_t held = CurrentModifiers() & ~ModifierOf(vk);
+            for (int action = 0; action < kMaxActions; ++action) {
+                const int chord = m_chords[action];
+                if (chord == 0 || NormalizeKey(ChordKey(chord)) != vk || ChordMods(chord) != held) continue;
+                if (m_hasFired[action] && static_cast<uint32_t>(ev.timeMs - m_lastFireMs[action]) < m_debounceMs) {
+                    return kNoAction;
+                }
+                m_hasFired[action] = true;
+                m_lastFireMs[action] = ev.timeMs;
+                return action;
+            }
+            return kNoAction;
+        }
+
+    private:
+        uint32_t CurrentModifiers() const {
+            return (IsDown(Vk::Control) ? ModCtrl : 0u) | (IsDown(Vk::Shift) ? ModShift : 0u) | (IsDown(Vk::Menu) ? ModAlt : 0u);
+        }
+
+        uint32_t m_down[8] = {};  // 256-key bitset
+        int m_chords[kMaxActions] = {};
+        uint32_t m_lastFireMs[kMaxActions] = {};
+        bool m_hasFired[kMaxActions] = {};
+        uint32_t m_debounceMs = 150;
+    };
+
+    // ---- Win32 producers (dlss_input.cpp) ------------------------------
+
+    using EventQueue = SpscQueue<KeyEvent, 256>;
+
+    // The queue drained by the render thread
+    EventQueue& Events();
+
+    // Feed from a window procedure; returns true for keyboard messages
+    bool OnWindowMessage(unsigned msg, uintptr_t wParam, intptr_t lParam);
+
+    // Set while a hooked window procedure calls OnWindowMessage
+    void SetWindowSourceActive(bool active);
+
+    // True when key events arrive without polling
+    bool HasEventSource();
+
+    // Safe-mode source: raw keyboard input delivered to a message-only window
+    // on a worker thread. Fails when the game already owns keyboard raw input
+    // (a second registration would steal it); callers then poll.
+    bool StartRawInputSink();
+    void StopRawInputSink();
+    bool IsRawInputSinkActive();
+
+    // Last resort when neither source is available: edge-detect the given
+    // keys with GetAsyncKeyState on the render thread and queue the edges.
+    void PollKeys(const uint16_t* keys, size_t count);
+}
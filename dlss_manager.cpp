@@ -1,6 +1,12 @@
 #include "dlss_manager.h"
 #include "dlss_config.h"
 #include "dlss_hooks.h"
+#include "dlss_shaders.h"
+#include "dlss_frametiming.h"
+#include "dlss_vram.h"
+#include "dlss_arena.h"
+#include "dlss_redirect.h"
+#include "dlss_tagging.h"
 #include "backends/IUpscaleBackend.h"
 #if USE_STREAMLINE
 #include "backends/SLBackend.h"
@@ -11,11 +17,12 @@
 #include "common/IDebugLog.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <windows.h>
 #include <shlobj.h>
-#include <d3dcompiler.h>
 
 #if __has_include(<nvsdk_ngx.h>) && __has_include(<nvsdk_ngx_params.h>)
 #include <nvsdk_ngx.h>
@@ -25,6 +32,22 @@
 #endif
 namespace {
     HMODULE g_ngxModule = nullptr;
+    bool g_ngxResolved = false;
+    // Textures created by the manager since load (telemetry)
+    uint64_t g_textureCreates = 0;
+
+    double ElapsedMs(const LARGE_INTEGER& start) {
+        LARGE_INTEGER now{}, freq{};
+        QueryPerformanceCounter(&now);
+        QueryPerformanceFrequency(&freq);
+        return freq.QuadPart ? (double)(now.QuadPart - start.QuadPart) * 1000.0 / (double)freq.QuadPart : 0.0;
+    }
+
+    LARGE_INTEGER StageStart() {
+        LARGE_INTEGER t{};
+        QueryPerformanceCounter(&t);
+        return t;
+    }
 
     std::string WideToUtf8(const std::wstring& value) {
         if (value.empty()) {
@@ -114,7 +137,7 @@ namespace {
         return path;
     }
 
-    bool LoadNGXLibrary() {
+    bool LoadNGXModule() {
         if (g_ngxModule) {
             return true;
         }
@@ -140,6 +163,16 @@ namespace {
             _ERROR("Failed to load nvngx_dlss.dll from plugin directory or process search path");
             return false;
         }
+        return true;
+    }
+
+    bool ResolveNGXEntryPoints() {
+        if (g_ngxResolved) {
+            return true;
+        }
+        if (!g_ngxModule) {
+            return false;
+        }
 
         // Try to resolve exports first (works with older NGX runtimes)
         LoadNGXFunctionOptional(g_pfnNGXInitProjectId, "NVSDK_NGX_D3D11_Init_with_ProjectID");
@@ -216,9 +249,33 @@ namespace {
             }
         }
 
+        g_ngxResolved = true;
         return true;
     }
 
+    bool LoadNGXLibrary() {
+        return LoadNGXModule() && ResolveNGXEntryPoints();
+    }
+
+    // How the downscale reads an input format: the shader encoding and the
+    // SRV format (UNKNOWN = the texture's own format). 8-bit typeless eye
+    // textures hold sRGB data and are read through a UNORM view.
+    struct FormatRoute {
+        DLSSDownscale::Encoding encoding;
+        DXGI_FORMAT view;
+    };
+
+    constexpr FormatRoute RouteFormat(DXGI_FORMAT format) {
+        switch (format) {
+            case DXGI_FORMAT_R8G8B8A8_TYPELESS: return { DLSSDownscale::Encoding::SRGB, DXGI_FORMAT_R8G8B8A8_UNORM };
+            case DXGI_FORMAT_B8G8R8A8_TYPELESS: return { DLSSDownscale::Encoding::SRGB, DXGI_FORMAT_B8G8R8A8_UNORM };
+            case DXGI_FORMAT_R11G11B10_FLOAT: return { DLSSDownscale::Encoding::R11G11B10, DXGI_FORMAT_UNKNOWN };
+            default: return { DLSSDownscale::Encoding::Linear, DXGI_FORMAT_UNKNOWN };  // *_SRGB views decode in hardware
+        }
+    }
+    static_assert(RouteFormat(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB).encoding == DLSSDownscale::Encoding::Linear, "sRGB views are decoded by the sampler");
+    static_assert(RouteFormat(DXGI_FORMAT_R8G8B8A8_TYPELESS).view == DXGI_FORMAT_R8G8B8A8_UNORM, "typeless color needs a typed view");
+
     NVSDK_NGX_PerfQuality_Value MapQuality(DLSSManager::Quality quality) {
         switch (quality) {
             case DLSSManager::Quality::Performance:
@@ -267,17 +324,31 @@ bool DLSSManager::Initialize() {
         return true;
     }
 
+    // The init worker owns the backend and NGX globals until it reports Prepared
+    if (m_initStage.load(std::memory_order_acquire) == InitStage::Preparing) {
+        return false;
+    }
+    JoinInitThread();
+
     if (!InitializeDevice()) {
         return false;
     }
 
     // Prefer Streamline backend when available
 #if USE_STREAMLINE
-    if (!m_backend) {
+    if (IUpscaleBackend* stale = DLSSInit::AdoptPrepared(m_backend, m_preparedBackend)) {
+        // Kept from an earlier attempt that failed or was not ready; this
+        // attempt's worker prepared a fresh one
+        _MESSAGE("[SL] Replacing backend left over from the previous attempt");
+        stale->Shutdown();
+        delete stale;
+    }
+    if (m_backend) {
+        m_slBackend = static_cast<SLBackend*>(m_backend);
+    } else if (!m_slPrepareFailed) {
+        // No background bring-up (or it was skipped): full SL init inline
         m_slBackend = new SLBackend();
         m_backend = m_slBackend;
-    } else {
-        m_slBackend = static_cast<SLBackend*>(m_backend);
     }
     if (m_backend && !m_backend->Init(m_device, m_context)) {
         _ERROR("[SL] Backend init failed; DLSS unavailable via SL");
@@ -286,6 +357,11 @@ bool DLSSManager::Initialize() {
         m_backend = nullptr;
         m_slBackend = nullptr;
     }
+    if (m_backend) {
+        // The config's level was set before the backend existed, and
+        // SetQuality skips an unchanged level
+        m_backend->SetQuality(static_cast<int>(m_quality));
+    }
 #else
     m_backend = nullptr;
 #endif
@@ -301,9 +377,120 @@ bool DLSSManager::Initialize() {
     }
 
     m_initialized = true;
+    m_initStage.store(InitStage::Ready, std::memory_order_release);
+    return true;
+}
+
+bool DLSSManager::BeginAsyncInitialize() {
+    if (m_initialized) {
+        return true;
+    }
+    InitStage stage = m_initStage.load(std::memory_order_acquire);
+    if (stage == InitStage::Failed) {
+        // Driver update, GPU reset or a missing DLL put back: try again after the backoff
+        const uint64_t frame = DLSSVram::Global().Frame();
+        if (frame - m_initFailedFrame < InitRetryDelay(m_initFailures)) {
+            return false;
+        }
+        _MESSAGE("[DLSS][Init] Retrying runtime bring-up (attempt %u)", m_initFailures + 1);
+        m_slPrepareFailed = false;
+        m_initStage.store(InitStage::Idle, std::memory_order_release);
+        stage = InitStage::Idle;
+    }
+    if (stage != InitStage::Idle) {
+        return true;
+    }
+    // Device handles are needed by the worker for the adapter query only
+    if (!InitializeDevice()) {
+        return false;
+    }
+    JoinInitThread();
+    m_initTimings = {};
+    m_initStage.store(InitStage::Preparing, std::memory_order_release);
+    m_initThread = std::thread([this]() { PrepareRuntime(); });
+    _MESSAGE("[DLSS][Init] Runtime bring-up started on worker thread");
     return true;
 }
 
+void DLSSManager::PrepareRuntime() {
+    // Streamline first: slInit loads the SL plugins and probes the adapter
+#if USE_STREAMLINE
+    // Built off to the side: the render thread reads m_backend concurrently
+    SLBackend* backend = new SLBackend();
+    LARGE_INTEGER t = StageStart();
+    const bool slPrepared = backend->Prepare(m_device);
+    m_initTimings.loadMs = ElapsedMs(t);
+    if (slPrepared) {
+        m_preparedBackend = backend;
+    } else {
+        backend->Shutdown();
+        delete backend;
+        m_slPrepareFailed = true;
+    }
+#else
+    const bool slPrepared = false;
+    LARGE_INTEGER t{};
+#endif
+
+    // NGX fallback: load and resolve nvngx_dlss.dll only when Streamline is out
+    if (!slPrepared) {
+        t = StageStart();
+        const bool loaded = LoadNGXModule();
+        m_initTimings.loadMs += ElapsedMs(t);
+        if (loaded) {
+            t = StageStart();
+            ResolveNGXEntryPoints();
+            m_initTimings.resolveMs = ElapsedMs(t);
+        }
+    }
+
+    // NGX capability parameters need NGX_Init with the device and stay on the
+    // render thread. Shader bytecode is device-free (embedded, or cached in dev builds).
+    t = StageStart();
+    if (!DLSSShaders::Prepare()) {
+        _MESSAGE("[DLSS][Init] Shader bytecode unavailable; downscale path disabled");
+    }
+    m_initTimings.shadersMs = ElapsedMs(t);
+
+    m_initStage.store(InitStage::Prepared, std::memory_order_release);
+}
+
+bool DLSSManager::PollInitialize() {
+    if (m_initialized) {
+        return true;
+    }
+    if (m_initStage.load(std::memory_order_acquire) != InitStage::Prepared) {
+        return false;
+    }
+    JoinInitThread();
+
+    LARGE_INTEGER t = StageStart();
+    const bool ok = Initialize();
+    m_initTimings.deviceMs = ElapsedMs(t);
+    if (ok) {
+        m_initFailures = 0;
+    } else {
+        ++m_initFailures;
+        m_initFailedFrame = DLSSVram::Global().Frame();
+        m_initStage.store(InitStage::Failed, std::memory_order_release);
+    }
+    DLSSFrameTiming::Global().Note(DLSSFrameTiming::Event::Initialize);
+    _MESSAGE("[DLSS][Init] %s: load=%.1f ms resolve=%.1f ms shaders=%.1f ms (worker) device=%.1f ms (render thread)",
+             ok ? "ready" : "failed",
+             m_initTimings.loadMs, m_initTimings.resolveMs,
+             m_initTimings.shadersMs, m_initTimings.deviceMs);
+    if (!ok) {
+        _MESSAGE("[DLSS][Init] Next attempt in %llu frames", (unsigned long long)InitRetryDelay(m_initFailures));
+    }
+    return ok;
+}
+
+void DLSSManager::JoinInitThread() {
+    if (m_initThread.joinable()) {
+        m_initThread.join();
+    }
+}
+
 bool DLSSManager::InitializeDevice() {
     if (m_device && m_context) {
         return true;
@@ -320,6 +507,7 @@ bool DLSSManager::InitializeDevice() {
 
     m_context = context;
     m_context->AddRef();
+    DLSSVram::Global().AddTrimmer(&DLSSManager::TrimVram, this);
     return true;
 }
 
@@ -442,22 +630,20 @@ void DLSSManager::GetOptimalSettings(uint32_t& renderWidth, uint32_t& renderHeig
     renderHeight = std::max(1u, renderHeight);
 }
 
-namespace {
-    void ReleaseTexture(ID3D11Texture2D*& texture) {
-        if (texture) {
-            texture->Release();
-            texture = nullptr;
-        }
-    }
-}
-
 bool DLSSManager::CreateDLSSFeatures() {
     // Actual feature creation happens on-demand when we process an eye.
     return true;
 }
 
 void DLSSManager::SetQuality(Quality quality) {
-    m_quality = quality;
+    // The menu re-applies the level with every per-eye change: only a new
+    // level may reset the history
+    if (m_quality == quality) return;
+    {
+        std::lock_guard<std::mutex> lock(m_renderSizeMutex);
+        m_quality = quality;
+        InvalidateRenderSizes();
+    }
     if (m_useOptimalMipLodBias) {
         m_manualMipLodBias = GetQualityInfo(quality).mipBias;
     }
@@ -466,11 +652,41 @@ void DLSSManager::SetQuality(Quality quality) {
         m_backend->SetQuality(static_cast<int>(quality));
     }
 #endif
-    m_leftEye.requiresReset = true;
-    m_rightEye.requiresReset = true;
+    m_leftEye.history.Invalidate(DLSSHistory::Reason::Settings);
+    m_rightEye.history.Invalidate(DLSSHistory::Reason::Settings);
     _MESSAGE("[CFG] Quality set to %d", static_cast<int>(quality));
 }
 
+void DLSSManager::SetEyeQuality(int eyeIndex, int quality) {
+    if (eyeIndex != 0 && eyeIndex != 1) return;
+    quality = (quality < 0 || quality > static_cast<int>(Quality::DLAA)) ? -1 : quality;
+    if (m_eyeQuality[eyeIndex] == quality) return;
+    {
+        std::lock_guard<std::mutex> lock(m_renderSizeMutex);
+        m_eyeQuality[eyeIndex] = quality;
+        InvalidateRenderSizes();
+    }
+    (eyeIndex == 0 ? m_leftEye : m_rightEye).history.Invalidate(DLSSHistory::Reason::Settings);
+    _MESSAGE("[CFG] Eye %d quality set to %d", eyeIndex, quality);
+}
+
+void DLSSManager::SetEyeRenderScale(int eyeIndex, float scale) {
+    if (eyeIndex != 0 && eyeIndex != 1) return;
+    scale = scale > 0.0f ? std::max(0.33f, std::min(scale, 1.0f)) : 0.0f;
+    if (m_eyeRenderScale[eyeIndex] == scale) return;
+    {
+        std::lock_guard<std::mutex> lock(m_renderSizeMutex);
+        m_eyeRenderScale[eyeIndex] = scale;
+        InvalidateRenderSizes();
+    }
+    _MESSAGE("[CFG] Eye %d render scale set to %.2f", eyeIndex, scale);
+}
+
+DLSSManager::Quality DLSSManager::GetEyeQuality(int eyeIndex) const {
+    const int q = GetEyeQualityOverride(eyeIndex);
+    return q >= 0 ? static_cast<Quality>(q) : m_quality;
+}
+
 void DLSSManager::SetSharpeningEnabled(bool enabled) {
     m_sharpeningEnabled = enabled;
 }
@@ -539,14 +755,56 @@ void DLSSManager::SetFoveatedWiden(float widen) {
     m_foveatedWiden = widen;
 }
 
-bool DLSSManager::ComputeRenderSizeForOutput(uint32_t outW, uint32_t outH, uint32_t& renderW, uint32_t& renderH) {
+bool DLSSManager::ComputeRenderSizeForOutput(int eyeIndex, uint32_t outW, uint32_t outH, uint32_t& renderW, uint32_t& renderH) {
     renderW = 0;
     renderH = 0;
-    if (outW == 0 || outH == 0) {
+    if (outW == 0 || outH == 0 || (eyeIndex != 0 && eyeIndex != 1)) {
         return false;
     }
+    // Streamline's answer replaces the table's once the backend is up
+    const bool ready = m_backend && m_backend->IsReady();
+    const bool cacheable = outW < 0x8000u && outH < 0x8000u;
+    const uint32_t key = outW | (outH << 15) | (ready ? 1u << 30 : 0u) | (1u << 31);
+    if (cacheable) {
+        for (uint32_t i = 0; i < kRenderSizeEntries; ++i) {
+            const uint64_t entry = m_renderSizeCache[eyeIndex][i].load(std::memory_order_acquire);
+            if (static_cast<uint32_t>(entry) == key) {
+                renderW = static_cast<uint32_t>(entry >> 32) & 0xFFFFu;
+                renderH = static_cast<uint32_t>(entry >> 48);
+                return true;
+            }
+        }
+    }
+    std::lock_guard<std::mutex> lock(m_renderSizeMutex);
+    ComputeRenderSizeUncached(eyeIndex, outW, outH, renderW, renderH);
+    if (cacheable) {
+        const uint64_t entry = key | (static_cast<uint64_t>(renderW) << 32) | (static_cast<uint64_t>(renderH) << 48);
+        m_renderSizeCache[eyeIndex][m_renderSizeNext[eyeIndex]].store(entry, std::memory_order_release);
+        m_renderSizeNext[eyeIndex] = (m_renderSizeNext[eyeIndex] + 1) % kRenderSizeEntries;
+    }
+    return true;
+}
+
+// Caller holds m_renderSizeMutex
+void DLSSManager::InvalidateRenderSizes() {
+    for (auto& eye : m_renderSizeCache) {
+        for (std::atomic<uint64_t>& entry : eye) entry.store(0, std::memory_order_release);
+    }
+}
+
+// Caller holds m_renderSizeMutex; outW and outH are non-zero
+void DLSSManager::ComputeRenderSizeUncached(int eyeIndex, uint32_t outW, uint32_t outH, uint32_t& renderW, uint32_t& renderH) {
+    renderW = 0;
+    renderH = 0;
+    const Quality quality = GetEyeQuality(eyeIndex);
+    const float scale = GetEyeRenderScale(eyeIndex);
+    if (scale > 0.0f) {
+        renderW = static_cast<uint32_t>(static_cast<float>(outW) * scale);
+        renderH = static_cast<uint32_t>(static_cast<float>(outH) * scale);
+    }
 #if USE_STREAMLINE
-    // Prefer Streamline's DLSS optimal settings when backend is ready
+    // Prefer Streamline's DLSS optimal settings when backend is ready; an
+    // explicit render scale only takes the mode's supported range from it
     if (m_backend && m_backend->IsReady()) {
         auto MapToSLMode = [&](Quality q)->sl::DLSSMode {
             switch (q) {
@@ -560,19 +818,26 @@ bool DLSSManager::ComputeRenderSizeForOutput(uint32_t outW, uint32_t outH, uint3
             }
         };
         sl::DLSSOptions opts{};
-        opts.mode = MapToSLMode(m_quality);
+        opts.mode = MapToSLMode(quality);
         opts.outputWidth = outW;
         opts.outputHeight = outH;
         sl::DLSSOptimalSettings os{};
         if (sl::Result::eOk == slDLSSGetOptimalSettings(opts, os)) {
-            renderW = os.optimalRenderWidth;
-            renderH = os.optimalRenderHeight;
+            if (scale <= 0.0f) {
+                renderW = os.optimalRenderWidth;
+                renderH = os.optimalRenderHeight;
+            } else {
+                if (os.renderWidthMin && renderW < os.renderWidthMin) renderW = os.renderWidthMin;
+                if (os.renderHeightMin && renderH < os.renderHeightMin) renderH = os.renderHeightMin;
+                if (os.renderWidthMax && renderW > os.renderWidthMax) renderW = os.renderWidthMax;
+                if (os.renderHeightMax && renderH > os.renderHeightMax) renderH = os.renderHeightMax;
+            }
         }
     }
 #endif
     if (renderW == 0 || renderH == 0) {
         // Fallback: uniform scale from the static quality table
-        const float s = GetQualityInfo(m_quality).scale;
+        const float s = GetQualityInfo(quality).scale;
         renderW = static_cast<uint32_t>(static_cast<float>(outW) * s);
         renderH = static_cast<uint32_t>(static_cast<float>(outH) * s);
     }
@@ -581,46 +846,81 @@ bool DLSSManager::ComputeRenderSizeForOutput(uint32_t outW, uint32_t outH, uint3
     if (renderW == 0) renderW = 2; if (renderH == 0) renderH = 2;
     if (renderW > outW)  renderW = outW;
     if (renderH > outH)  renderH = outH;
+}
+
+bool DLSSManager::ComputeRenderSizeForOutput(uint32_t outW, uint32_t outH, uint32_t& renderW, uint32_t& renderH) {
+    uint32_t leftW = 0, leftH = 0, rightW = 0, rightH = 0;
+    if (!ComputeRenderSizeForOutput(0, outW, outH, leftW, leftH) ||
+        !ComputeRenderSizeForOutput(1, outW, outH, rightW, rightH)) {
+        renderW = renderH = 0;
+        return false;
+    }
+    renderW = std::max(leftW, rightW);
+    renderH = std::max(leftH, rightH);
     return true;
 }
 
-bool DLSSManager::BlitToRTV(ID3D11Texture2D* src, ID3D11RenderTargetView* dstRTV, uint32_t dstW, uint32_t dstH) {
+bool DLSSManager::BlitToRTV(ID3D11Texture2D* src, ID3D11RenderTargetView* dstRTV, uint32_t dstW, uint32_t dstH,
+                            uint32_t srvFormat) {
     if (!m_device || !m_context || !src || !dstRTV || dstW == 0 || dstH == 0) {
         return false;
     }
     if (!EnsureDownscaleShaders()) {
         return false;
     }
+    // Twin -> big composite is an upscale: the hardware bilinear permutation is enough
+    ID3D11PixelShader* ps = GetDownscaleShader(DLSSDownscale::Filter::Bilinear, DLSSDownscale::Encoding::Linear, DLSSDownscale::Layout::Mono);
+    if (!ps) {
+        return false;
+    }
 
-    // Create SRV for src
+    // Create SRV for src (mip 0; typeless twins are read through srvFormat)
     ID3D11ShaderResourceView* srcSRV = nullptr;
-    HRESULT hr = m_device->CreateShaderResourceView(src, nullptr, &srcSRV);
+    D3D11_SHADER_RESOURCE_VIEW_DESC vd{};
+    vd.Format = static_cast<DXGI_FORMAT>(srvFormat);
+    vd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    vd.Texture2D.MipLevels = 1;
+    HRESULT hr = m_device->CreateShaderResourceView(src, srvFormat ? &vd : nullptr, &srcSRV);
     if (FAILED(hr) || !srcSRV) {
         return false;
     }
+    D3D11_TEXTURE2D_DESC sd{}; src->GetDesc(&sd);
+    const DLSSDownscale::Params params = DLSSDownscale::MakeParams(DLSSDownscale::Filter::Bilinear, sd.Width, sd.Height, dstW, dstH);
+    const bool ok = DrawFullscreen(srcSRV, dstRTV, ps, params, dstW, dstH);
+    srcSRV->Release();
+    return ok;
+}
+
+bool DLSSManager::DrawFullscreen(ID3D11ShaderResourceView* srv, ID3D11RenderTargetView* rtv, ID3D11PixelShader* ps,
+                                 const DLSSDownscale::Params& params, uint32_t dstW, uint32_t dstH) {
+    m_context->UpdateSubresource(m_downscaleCB, 0, nullptr, &params, 0, 0);
 
     // Save minimal state
     ID3D11RenderTargetView* oldRTV = nullptr; ID3D11DepthStencilView* oldDSV = nullptr;
     m_context->OMGetRenderTargets(1, &oldRTV, &oldDSV);
     D3D11_VIEWPORT oldVP{}; UINT vpCount = 1; m_context->RSGetViewports(&vpCount, &oldVP);
+    ID3D11RasterizerState* oldRS = nullptr; m_context->RSGetState(&oldRS);
     D3D11_PRIMITIVE_TOPOLOGY oldTopo; m_context->IAGetPrimitiveTopology(&oldTopo);
     ID3D11VertexShader* oldVS = nullptr; ID3D11PixelShader* oldPS = nullptr;
     m_context->VSGetShader(&oldVS, nullptr, nullptr);
     m_context->PSGetShader(&oldPS, nullptr, nullptr);
     ID3D11ShaderResourceView* oldSRV = nullptr; m_context->PSGetShaderResources(0, 1, &oldSRV);
     ID3D11SamplerState* oldSamp = nullptr; m_context->PSGetSamplers(0, 1, &oldSamp);
+    ID3D11Buffer* oldCB = nullptr; m_context->PSGetConstantBuffers(0, 1, &oldCB);
 
     // Set viewport and RT
     D3D11_VIEWPORT vp{}; vp.TopLeftX = 0; vp.TopLeftY = 0; vp.Width = (float)dstW; vp.Height = (float)dstH; vp.MinDepth = 0; vp.MaxDepth = 1;
     m_context->RSSetViewports(1, &vp);
-    m_context->OMSetRenderTargets(1, &dstRTV, nullptr);
+    m_context->RSSetState(m_blitRS);
+    m_context->OMSetRenderTargets(1, &rtv, nullptr);
 
     // Bind FS pipeline
     m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     m_context->VSSetShader(m_fsVS, nullptr, 0);
-    m_context->PSSetShader(m_fsPS, nullptr, 0);
-    m_context->PSSetShaderResources(0, 1, &srcSRV);
+    m_context->PSSetShader(ps, nullptr, 0);
+    m_context->PSSetShaderResources(0, 1, &srv);
     m_context->PSSetSamplers(0, 1, &m_linearSampler);
+    m_context->PSSetConstantBuffers(0, 1, &m_downscaleCB);
     m_context->Draw(3, 0);
 
     // Unbind and restore
@@ -630,13 +930,119 @@ bool DLSSManager::BlitToRTV(ID3D11Texture2D* src, ID3D11RenderTargetView* dstRTV
     m_context->OMSetRenderTargets(1, &oldRTV, oldDSV);
     if (oldRTV) oldRTV->Release(); if (oldDSV) oldDSV->Release();
     m_context->RSSetViewports(vpCount, &oldVP);
+    m_context->RSSetState(oldRS);
+    if (oldRS) oldRS->Release();
     m_context->IASetPrimitiveTopology(oldTopo);
     m_context->VSSetShader(oldVS, nullptr, 0);
     m_context->PSSetShader(oldPS, nullptr, 0);
     if (oldVS) oldVS->Release(); if (oldPS) oldPS->Release();
     if (oldSRV) { ID3D11ShaderResourceView* r[1] = { oldSRV }; m_context->PSSetShaderResources(0, 1, r); oldSRV->Release(); }
     if (oldSamp) { ID3D11SamplerState* s[1] = { oldSamp }; m_context->PSSetSamplers(0, 1, s); oldSamp->Release(); }
-    if (srcSRV) srcSRV->Release();
+    m_context->PSSetConstantBuffers(0, 1, &oldCB);
+    if (oldCB) oldCB->Release();
+    return true;
+}
+
+bool DLSSManager::BlitDepthToDSV(ID3D11Texture2D* src, ID3D11DepthStencilView* dstDSV, uint32_t dstW, uint32_t dstH) {
+    if (!m_device || !m_context || !src || !dstDSV || dstW == 0 || dstH == 0) {
+        return false;
+    }
+    if (!EnsureDownscaleShaders() || !EnsureCompositeShaders()) {
+        return false;
+    }
+    D3D11_TEXTURE2D_DESC sd{}; src->GetDesc(&sd);
+    const DLSSRedirect::DepthTwinFormats formats = DLSSRedirect::GetDepthTwinFormats(static_cast<uint32_t>(sd.Format));
+    if (!formats.texture) {
+        return false;
+    }
+    ID3D11ShaderResourceView* depthSRV = nullptr;
+    ID3D11ShaderResourceView* stencilSRV = nullptr;
+    D3D11_SHADER_RESOURCE_VIEW_DESC vd{};
+    vd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    vd.Texture2D.MipLevels = 1;
+    vd.Format = static_cast<DXGI_FORMAT>(formats.depthView);
+    if (FAILED(m_device->CreateShaderResourceView(src, &vd, &depthSRV))) {
+        return false;
+    }
+    if (formats.stencilView) {
+        vd.Format = static_cast<DXGI_FORMAT>(formats.stencilView);
+        if (FAILED(m_device->CreateShaderResourceView(src, &vd, &stencilSRV))) {
+            depthSRV->Release();
+            return false;
+        }
+    }
+
+    DLSSRedirect::CompositeParams params;
+    params.srcWidth = sd.Width;
+    params.srcHeight = sd.Height;
+    params.dstWidth = dstW;
+    params.dstHeight = dstH;
+    m_context->UpdateSubresource(m_compositeCB, 0, nullptr, &params, 0, 0);
+
+    // Save the state the passes touch
+    ID3D11RenderTargetView* oldRTVs[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT] = {}; ID3D11DepthStencilView* oldDSV = nullptr;
+    m_context->OMGetRenderTargets(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, oldRTVs, &oldDSV);
+    ID3D11DepthStencilState* oldDS = nullptr; UINT oldStencilRef = 0;
+    m_context->OMGetDepthStencilState(&oldDS, &oldStencilRef);
+    D3D11_VIEWPORT oldVPs[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE] = {};
+    UINT vpCount = D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE; m_context->RSGetViewports(&vpCount, oldVPs);
+    ID3D11RasterizerState* oldRS = nullptr; m_context->RSGetState(&oldRS);
+    D3D11_PRIMITIVE_TOPOLOGY oldTopo; m_context->IAGetPrimitiveTopology(&oldTopo);
+    ID3D11VertexShader* oldVS = nullptr; ID3D11PixelShader* oldPS = nullptr;
+    m_context->VSGetShader(&oldVS, nullptr, nullptr);
+    m_context->PSGetShader(&oldPS, nullptr, nullptr);
+    ID3D11ShaderResourceView* oldSRV = nullptr; m_context->PSGetShaderResources(0, 1, &oldSRV);
+    ID3D11Buffer* oldCB = nullptr; m_context->PSGetConstantBuffers(0, 1, &oldCB);
+
+    D3D11_VIEWPORT vp{}; vp.Width = (float)dstW; vp.Height = (float)dstH; vp.MinDepth = 0; vp.MaxDepth = 1;
+    m_context->RSSetViewports(1, &vp);
+    m_context->RSSetState(m_blitRS);
+    m_context->OMSetRenderTargets(0, nullptr, dstDSV);
+    m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    m_context->VSSetShader(m_fsVS, nullptr, 0);
+    m_context->PSSetConstantBuffers(0, 1, &m_compositeCB);
+
+    // Depth: every pixel, no test
+    m_context->OMSetDepthStencilState(m_depthCompositeDS, 0);
+    m_context->PSSetShader(m_depthCompositePS, nullptr, 0);
+    m_context->PSSetShaderResources(0, 1, &depthSRV);
+    m_context->Draw(3, 0);
+
+    // Stencil: cleared, then each bit set where the twin has it
+    if (stencilSRV) {
+        m_context->ClearDepthStencilView(dstDSV, D3D11_CLEAR_STENCIL, 0.0f, 0);
+        m_context->PSSetShader(m_stencilCompositePS, nullptr, 0);
+        m_context->PSSetShaderResources(0, 1, &stencilSRV);
+        for (uint32_t bit = 0; bit < 8; ++bit) {
+            params.stencilBit = 1u << bit;
+            m_context->UpdateSubresource(m_compositeCB, 0, nullptr, &params, 0, 0);
+            m_context->OMSetDepthStencilState(m_stencilCompositeDS[bit], 0xFF);
+            m_context->Draw(3, 0);
+        }
+    }
+
+    // Unbind and restore
+    ID3D11ShaderResourceView* nullSRV[1] = { nullptr };
+    m_context->PSSetShaderResources(0, 1, nullSRV);
+    depthSRV->Release();
+    if (stencilSRV) stencilSRV->Release();
+
+    m_context->OMSetRenderTargets(D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT, oldRTVs, oldDSV);
+    for (ID3D11RenderTargetView* rtv : oldRTVs) if (rtv) rtv->Release();
+    if (oldDSV) oldDSV->Release();
+    m_context->OMSetDepthStencilState(oldDS, oldStencilRef);
+    if (oldDS) oldDS->Release();
+    m_context->RSSetViewports(vpCount, oldVPs);
+    m_context->RSSetState(oldRS);
+    if (oldRS) oldRS->Release();
+    m_context->IASetPrimitiveTopology(oldTopo);
+    m_context->VSSetShader(oldVS, nullptr, 0);
+    m_context->PSSetShader(oldPS, nullptr, 0);
+    if (oldVS) oldVS->Release(); if (oldPS) oldPS->Release();
+    m_context->PSSetShaderResources(0, 1, &oldSRV);
+    if (oldSRV) oldSRV->Release();
+    m_context->PSSetConstantBuffers(0, 1, &oldCB);
+    if (oldCB) oldCB->Release();
     return true;
 }
 
@@ -645,12 +1051,14 @@ namespace {
                               const D3D11_TEXTURE2D_DESC& inputDesc,
                               uint32_t width,
                               uint32_t height,
+                              DLSSVram::Pool pool,
                               ID3D11Texture2D** outTexture) {
         if (!device || !outTexture) {
             return false;
         }
 
         D3D11_TEXTURE2D_DESC desc = inputDesc;
+        desc.Format = static_cast<DXGI_FORMAT>(DLSSTagging::OutputFormat(desc.Format, DLSSTagging::QueryDeviceCaps(device)));
         desc.Width = width;
         desc.Height = height;
         desc.MipLevels = 1;
@@ -665,6 +1073,8 @@ namespace {
             _ERROR("Failed to create DLSS output texture (%ux%u): HRESULT 0x%08X", width, height, hr);
             return false;
         }
+        ++g_textureCreates;
+        DLSSVram::TrackTexture(texture, pool);
 
         *outTexture = texture;
         return true;
@@ -694,12 +1104,13 @@ bool DLSSManager::EnsureEyeFeature(EyeContext& eye,
         eye.dlssHandle = nullptr;
     }
 
-    ReleaseTexture(eye.outputTexture);
+    ReleaseProbeView(eye, kProbeOutput);
+    DLSSVram::ReleaseTexture(eye.outputTexture);
 
     D3D11_TEXTURE2D_DESC inputDesc = {};
     inputTexture->GetDesc(&inputDesc);
 
-    if (!CreateOutputTexture(m_device, inputDesc, outputWidth, outputHeight, &eye.outputTexture)) {
+    if (!CreateOutputTexture(m_device, inputDesc, outputWidth, outputHeight, DLSSVram::Pool::EyeOutput, &eye.outputTexture)) {
         return false;
     }
 
@@ -709,7 +1120,7 @@ bool DLSSManager::EnsureEyeFeature(EyeContext& eye,
     m_ngxParameters->Set(NVSDK_NGX_Parameter_Height, renderHeight);
     m_ngxParameters->Set(NVSDK_NGX_Parameter_OutWidth, outputWidth);
     m_ngxParameters->Set(NVSDK_NGX_Parameter_OutHeight, outputHeight);
-    m_ngxParameters->Set(NVSDK_NGX_Parameter_PerfQualityValue, static_cast<unsigned int>(MapQuality(m_quality)));
+    m_ngxParameters->Set(NVSDK_NGX_Parameter_PerfQualityValue, static_cast<unsigned int>(MapQuality(GetEyeQuality(&eye == &m_rightEye ? 1 : 0))));
     m_ngxParameters->Set(NVSDK_NGX_Parameter_Sharpness, m_sharpness);
     m_ngxParameters->Set(NVSDK_NGX_Parameter_Reset, 1);
 
@@ -734,7 +1145,7 @@ bool DLSSManager::EnsureEyeFeature(EyeContext& eye,
     NVSDK_NGX_Result result = g_pfnNGXCreateFeature(m_context, NVSDK_NGX_Feature_SuperSampling, m_ngxParameters, &eye.dlssHandle);
     if (!NVSDK_NGX_SUCCEED(result)) {
         _ERROR("NVSDK_NGX_D3D11_CreateFeature failed: 0x%08X", result);
-        ReleaseTexture(eye.outputTexture);
+        DLSSVram::ReleaseTexture(eye.outputTexture);
         return false;
     }
 
@@ -742,7 +1153,8 @@ bool DLSSManager::EnsureEyeFeature(EyeContext& eye,
     eye.renderHeight = renderHeight;
     eye.outputWidth = outputWidth;
     eye.outputHeight = outputHeight;
-    eye.requiresReset = true;
+    eye.history.Invalidate(DLSSHistory::Reason::ResourceRecreated);
+    DLSSFrameTiming::Global().Note(DLSSFrameTiming::Event::FeatureCreate);
     return true;
 }
 
@@ -772,6 +1184,7 @@ bool DLSSManager::CreateScratchBuffer(size_t scratchSize) {
         return false;
     }
 
+    DLSSVram::TrackBuffer(buffer, DLSSVram::Pool::NgxScratch);
     m_scratchBuffer = buffer;
     m_scratchSize = scratchSize;
     return true;
@@ -779,6 +1192,7 @@ bool DLSSManager::CreateScratchBuffer(size_t scratchSize) {
 
 void DLSSManager::ReleaseScratchBuffer() {
     if (m_scratchBuffer) {
+        DLSSVram::Global().Untrack(m_scratchBuffer);
         m_scratchBuffer->Release();
         m_scratchBuffer = nullptr;
         m_scratchSize = 0;
@@ -787,8 +1201,7 @@ void DLSSManager::ReleaseScratchBuffer() {
 
 void DLSSManager::ReleaseZeroMotionVectors() {
     if (m_zeroMotionVectors) {
-        m_zeroMotionVectors->Release();
-        m_zeroMotionVectors = nullptr;
+        DLSSVram::ReleaseTexture(m_zeroMotionVectors);
         m_zeroMVWidth = m_zeroMVHeight = 0;
     }
 }
@@ -797,6 +1210,7 @@ bool DLSSManager::EnsureZeroMotionVectors(uint32_t width, uint32_t height) {
     if (!m_device || !m_context) {
         return false;
     }
+    m_zeroMVUseFrame = DLSSVram::Global().Frame();
     if (m_zeroMotionVectors && m_zeroMVWidth == width && m_zeroMVHeight == height) {
         return true;
     }
@@ -819,6 +1233,8 @@ bool DLSSManager::EnsureZeroMotionVectors(uint32_t width, uint32_t height) {
         _ERROR("Failed to allocate zero motion vector texture %ux%u: 0x%08X", width, height, hr);
         return false;
     }
+    ++g_textureCreates;
+    DLSSVram::TrackTexture(tex, DLSSVram::Pool::ZeroInputs);
 
     D3D11_MAPPED_SUBRESOURCE mapped = {};
     if (SUCCEEDED(m_context->Map(tex, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
@@ -838,8 +1254,7 @@ bool DLSSManager::EnsureZeroMotionVectors(uint32_t width, uint32_t height) {
 
 void DLSSManager::ReleaseZeroDepthTexture() {
     if (m_zeroDepthTexture) {
-        m_zeroDepthTexture->Release();
-        m_zeroDepthTexture = nullptr;
+        DLSSVram::ReleaseTexture(m_zeroDepthTexture);
         m_zeroDepthWidth = m_zeroDepthHeight = 0;
     }
 }
@@ -848,6 +1263,7 @@ bool DLSSManager::EnsureZeroDepthTexture(uint32_t width, uint32_t height) {
     if (!m_device || !m_context || width == 0 || height == 0) {
         return false;
     }
+    m_zeroDepthUseFrame = DLSSVram::Global().Frame();
     if (m_zeroDepthTexture && m_zeroDepthWidth == width && m_zeroDepthHeight == height) {
         return true;
     }
@@ -870,6 +1286,8 @@ bool DLSSManager::EnsureZeroDepthTexture(uint32_t width, uint32_t height) {
         _ERROR("Failed to allocate zero depth texture %ux%u: 0x%08X", width, height, hr);
         return false;
     }
+    ++g_textureCreates;
+    DLSSVram::TrackTexture(tex, DLSSVram::Pool::ZeroInputs);
 
     ID3D11RenderTargetView* rtv = nullptr;
     if (SUCCEEDED(m_device->CreateRenderTargetView(tex, nullptr, &rtv))) {
@@ -886,115 +1304,1368 @@ bool DLSSManager::EnsureZeroDepthTexture(uint32_t width, uint32_t height) {
 }
 
 void DLSSManager::ReleaseEyeRender(EyeContext& eye) {
+    InvalidatePass(&eye == &m_rightEye ? DLSSCmdList::Pass::DownscaleRight : DLSSCmdList::Pass::DownscaleLeft);
+    if (eye.renderColorUAV) { eye.renderColorUAV->Release(); eye.renderColorUAV = nullptr; }
     if (eye.renderColorRTV) { eye.renderColorRTV->Release(); eye.renderColorRTV = nullptr; }
-    if (eye.renderColor) { eye.renderColor->Release(); eye.renderColor = nullptr; }
+    DLSSVram::ReleaseTexture(eye.renderColor);
 }
 
 bool DLSSManager::EnsureDownscaleShaders() {
-    if (m_fsVS && m_fsPS && m_linearSampler) return true;
-    const char* vsSrc = R"(
-    struct VSOut { float4 pos:SV_Position; float2 uv:TEX; };
-    VSOut main(uint id:SV_VertexID){
-        float2 p = float2((id<<1)&2, id&2);
-        VSOut o;
-        o.pos = float4(p*float2(2,-2)+float2(-1,1),0,1);
-        o.uv = p; // no vertical flip; D3D texcoords origin at top-left
-        return o;
-    })";
-    const char* psSrc = R"(
-    Texture2D srcTex:register(t0);
-    SamplerState samLinear:register(s0);
-    float4 main(float4 pos:SV_Position, float2 uv:TEX):SV_Target{
-        return srcTex.Sample(samLinear, uv);
-    })";
-    ID3DBlob* vsBlob=nullptr; ID3DBlob* psBlob=nullptr; ID3DBlob* err=nullptr;
-    HRESULT hr = D3DCompile(vsSrc, strlen(vsSrc), nullptr, nullptr, nullptr, "main", "vs_5_0", 0, 0, &vsBlob, &err);
-    if (FAILED(hr) || !vsBlob) { if (err) err->Release(); return false; }
-    hr = D3DCompile(psSrc, strlen(psSrc), nullptr, nullptr, nullptr, "main", "ps_5_0", 0, 0, &psBlob, &err);
-    if (FAILED(hr) || !psBlob) { vsBlob->Release(); if (err) err->Release(); return false; }
-    if (FAILED(m_device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &m_fsVS))) { vsBlob->Release(); psBlob->Release(); return false; }
-    if (FAILED(m_device->CreatePixelShader(psBlob->GetBufferPointer(), psBlob->GetBufferSize(), nullptr, &m_fsPS))) { vsBlob->Release(); psBlob->Release(); return false; }
-    vsBlob->Release(); psBlob->Release(); if (err) err->Release();
-    D3D11_SAMPLER_DESC sd = {};
-    sd.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-    sd.AddressU = sd.AddressV = sd.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
-    sd.MaxLOD = D3D11_FLOAT32_MAX;
-    if (FAILED(m_device->CreateSamplerState(&sd, &m_linearSampler))) return false;
+    if (m_fsVS && m_linearSampler && m_downscaleCB && m_blitRS) return true;
+    DLSSShaders::Bytecode vs;
+    if (!DLSSShaders::Get(DLSSShaders::Id::FullscreenVS, vs)) return false;
+    if (!m_fsVS && FAILED(m_device->CreateVertexShader(vs.data, vs.size, nullptr, &m_fsVS))) return false;
+    if (!m_linearSampler) {
+        D3D11_SAMPLER_DESC sd = {};
+        sd.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+        sd.AddressU = sd.AddressV = sd.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+        sd.MaxLOD = D3D11_FLOAT32_MAX;
+        if (FAILED(m_device->CreateSamplerState(&sd, &m_linearSampler))) return false;
+    }
+    if (!m_downscaleCB) {
+        D3D11_BUFFER_DESC bd = {};
+        bd.ByteWidth = sizeof(DLSSDownscale::Params);
+        bd.Usage = D3D11_USAGE_DEFAULT;
+        bd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        if (FAILED(m_device->CreateBuffer(&bd, nullptr, &m_downscaleCB))) return false;
+        DLSSVram::TrackBuffer(m_downscaleCB, DLSSVram::Pool::Constants);
+    }
+    if (!m_blitRS) {
+        D3D11_RASTERIZER_DESC rd = {};
+        rd.FillMode = D3D11_FILL_SOLID;
+        rd.CullMode = D3D11_CULL_NONE;
+        rd.DepthClipEnable = TRUE;
+        if (FAILED(m_device->CreateRasterizerState(&rd, &m_blitRS))) return false;
+    }
+    return true;
+}
+
+bool DLSSManager::EnsureCompositeShaders() {
+    if (m_depthCompositePS && m_stencilCompositePS && m_compositeCB && m_depthCompositeDS && m_stencilCompositeDS[7]) return true;
+    DLSSShaders::Bytecode ps;
+    if (!m_depthCompositePS) {
+        if (!DLSSShaders::Get(DLSSShaders::Id::DepthComposite, ps)) return false;
+        if (FAILED(m_device->CreatePixelShader(ps.data, ps.size, nullptr, &m_depthCompositePS))) return false;
+    }
+    if (!m_stencilCompositePS) {
+        if (!DLSSShaders::Get(DLSSShaders::Id::StencilComposite, ps)) return false;
+        if (FAILED(m_device->CreatePixelShader(ps.data, ps.size, nullptr, &m_stencilCompositePS))) return false;
+    }
+    if (!m_compositeCB) {
+        D3D11_BUFFER_DESC bd = {};
+        bd.ByteWidth = sizeof(DLSSRedirect::CompositeParams);
+        bd.Usage = D3D11_USAGE_DEFAULT;
+        bd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        if (FAILED(m_device->CreateBuffer(&bd, nullptr, &m_compositeCB))) return false;
+        DLSSVram::TrackBuffer(m_compositeCB, DLSSVram::Pool::Constants);
+    }
+    if (!m_depthCompositeDS) {
+        D3D11_DEPTH_STENCIL_DESC dd = {};
+        dd.DepthEnable = TRUE;
+        dd.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+        dd.DepthFunc = D3D11_COMPARISON_ALWAYS;
+        if (FAILED(m_device->CreateDepthStencilState(&dd, &m_depthCompositeDS))) return false;
+    }
+    for (uint32_t bit = 0; bit < 8; ++bit) {
+        if (m_stencilCompositeDS[bit]) continue;
+        D3D11_DEPTH_STENCIL_DESC dd = {};
+        dd.DepthEnable = FALSE;
+        dd.StencilEnable = TRUE;
+        dd.StencilReadMask = 0xFF;
+        dd.StencilWriteMask = static_cast<UINT8>(1u << bit);
+        dd.FrontFace.StencilFailOp = dd.FrontFace.StencilDepthFailOp = D3D11_STENCIL_OP_KEEP;
+        dd.FrontFace.StencilPassOp = D3D11_STENCIL_OP_REPLACE;
+        dd.FrontFace.StencilFunc = D3D11_COMPARISON_ALWAYS;
+        dd.BackFace = dd.FrontFace;
+        if (FAILED(m_device->CreateDepthStencilState(&dd, &m_stencilCompositeDS[bit]))) return false;
+    }
+    return true;
+}
+
+ID3D11PixelShader* DLSSManager::GetDownscaleShader(DLSSDownscale::Filter filter, DLSSDownscale::Encoding encoding, DLSSDownscale::Layout layout) {
+    const uint32_t index = DLSSDownscale::PermutationIndex(filter, encoding, layout);
+    if (index >= DLSSDownscale::kPermutationCount) return nullptr;
+    if (!m_downscalePS[index]) {
+        DLSSShaders::Bytecode ps;
+        if (!DLSSShaders::Get(DLSSShaders::DownscaleId(filter, encoding, layout), ps) ||
+            FAILED(m_device->CreatePixelShader(ps.data, ps.size, nullptr, &m_downscalePS[index]))) {
+            _MESSAGE("[DLSS] Downscale permutation %u (%s) unavailable", index, DLSSDownscale::FilterName(filter));
+            return nullptr;
+        }
+    }
+    return m_downscalePS[index];
+}
+
+ID3D11ComputeShader* DLSSManager::GetDownscaleComputeShader(DLSSDownscale::Filter filter, DLSSDownscale::Encoding encoding) {
+    const uint32_t index = DLSSDownscale::ComputePermutationIndex(filter, encoding);
+    if (index >= DLSSDownscale::kComputePermutationCount) return nullptr;
+    if (!m_downscaleCS[index]) {
+        DLSSShaders::Bytecode cs;
+        if (!DLSSShaders::Get(DLSSShaders::DownscaleCSId(filter, encoding), cs) ||
+            FAILED(m_device->CreateComputeShader(cs.data, cs.size, nullptr, &m_downscaleCS[index]))) {
+            _MESSAGE("[DLSS] Downscale compute permutation %u (%s) unavailable", index, DLSSDownscale::FilterName(filter));
+            return nullptr;
+        }
+    }
+    return m_downscaleCS[index];
+}
+
+namespace {
+    // A pass for the DLSSCmdList worker to record: what it binds (AddRef'd
+    // on the render thread) and its constants
+    struct PassJob {
+        ID3D11Buffer* cb = nullptr;
+        uint8_t constants[32] = {};
+        ID3D11ShaderResourceView* srv = nullptr;
+        // Compute: cs into uav
+        ID3D11ComputeShader* cs = nullptr;
+        ID3D11UnorderedAccessView* uav = nullptr;
+        uint32_t groupsX = 0;
+        uint32_t groupsY = 0;
+        // Graphics: fullscreen triangle into rtv
+        ID3D11VertexShader* vs = nullptr;
+        ID3D11PixelShader* ps = nullptr;
+        ID3D11SamplerState* sampler = nullptr;
+        ID3D11RenderTargetView* rtv = nullptr;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+    static_assert(sizeof(DLSSDownscale::Params) == sizeof(PassJob::constants) &&
+                  sizeof(DLSSSharpen::Params) == sizeof(PassJob::constants), "UpdateSubresource writes the whole constant buffer");
+
+    template <typename T>
+    T* Retain(T* object) {
+        if (object) object->AddRef();
+        return object;
+    }
+
+    template <typename T>
+    void ReleaseRef(T*& object) {
+        if (object) { object->Release(); object = nullptr; }
+    }
+
+    template <typename P>
+    PassJob* NewPassJob(ID3D11Buffer* cb, const P& params, ID3D11ShaderResourceView* srv) {
+        PassJob* job = new PassJob{};
+        job->cb = Retain(cb);
+        std::memcpy(job->constants, &params, sizeof(P));
+        job->srv = Retain(srv);
+        return job;
+    }
+
+    void FreePassJob(PassJob* job) {
+        if (!job) return;
+        ReleaseRef(job->cb); ReleaseRef(job->srv);
+        ReleaseRef(job->cs); ReleaseRef(job->uav);
+        ReleaseRef(job->vs); ReleaseRef(job->ps); ReleaseRef(job->sampler); ReleaseRef(job->rtv);
+        delete job;
+    }
+
+    // The commands of DispatchCompute/DrawFullscreen on a deferred context.
+    // It starts from default state and ExecuteCommandList restores the
+    // immediate context afterwards, so nothing is saved or unbound here.
+    void EncodePassJob(ID3D11DeviceContext* ctx, const PassJob& job) {
+        ctx->UpdateSubresource(job.cb, 0, nullptr, job.constants, 0, 0);
+        if (job.cs) {
+            ctx->CSSetShader(job.cs, nullptr, 0);
+            ctx->CSSetShaderResources(0, 1, &job.srv);
+            ctx->CSSetUnorderedAccessViews(0, 1, &job.uav, nullptr);
+            ctx->CSSetConstantBuffers(0, 1, &job.cb);
+            ctx->Dispatch(job.groupsX, job.groupsY, 1);
+            return;
+        }
+        D3D11_VIEWPORT vp{}; vp.Width = (float)job.width; vp.Height = (float)job.height; vp.MaxDepth = 1;
+        ctx->RSSetViewports(1, &vp);
+        ctx->OMSetRenderTargets(1, &job.rtv, nullptr);
+        ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        ctx->VSSetShader(job.vs, nullptr, 0);
+        ctx->PSSetShader(job.ps, nullptr, 0);
+        ctx->PSSetShaderResources(0, 1, &job.srv);
+        ctx->PSSetSamplers(0, 1, &job.sampler);
+        ctx->PSSetConstantBuffers(0, 1, &job.cb);
+        ctx->Draw(3, 0);
+    }
+
+    // DLSSCmdList::Recorder over one deferred context, used by the worker only
+    class DeferredRecorder final : public DLSSCmdList::Recorder {
+    public:
+        DeferredRecorder(ID3D11DeviceContext* immediate, ID3D11DeviceContext* deferred)
+            : m_immediate(immediate), m_deferred(deferred) {}
+        ~DeferredRecorder() override { ReleaseRef(m_deferred); }
+
+        void* Record(DLSSCmdList::Pass pass, void* job) override {
+            PassJob* j = static_cast<PassJob*>(job);
+            EncodePassJob(m_deferred, *j);
+            ID3D11CommandList* list = nullptr;
+            const HRESULT hr = m_deferred->FinishCommandList(FALSE, &list);
+            FreePassJob(j);
+            if (FAILED(hr)) {
+                _MESSAGE("[DLSS] Recording %s failed: 0x%08X", DLSSCmdList::PassName(pass), hr);
+                return nullptr;
+            }
+            return list;
+        }
+        void DropJob(void* job) override { FreePassJob(static_cast<PassJob*>(job)); }
+        void Execute(void* list) override { m_immediate->ExecuteCommandList(static_cast<ID3D11CommandList*>(list), TRUE); }
+        void ReleaseList(void* list) override { static_cast<ID3D11CommandList*>(list)->Release(); }
+
+    private:
+        ID3D11DeviceContext* m_immediate;  // the manager's
+        ID3D11DeviceContext* m_deferred;   // owned
+    };
+
+    DLSSCmdList::Pass DownscalePass(int eyeIndex) {
+        return eyeIndex == 1 ? DLSSCmdList::Pass::DownscaleRight : DLSSCmdList::Pass::DownscaleLeft;
+    }
+    DLSSCmdList::Pass SharpenPass(int eyeIndex) {
+        return eyeIndex == 1 ? DLSSCmdList::Pass::SharpenRight : DLSSCmdList::Pass::SharpenLeft;
+    }
+}
+
+bool DLSSManager::EnsurePassCache() {
+    if (m_passCache) return true;
+    if (!m_device || !m_context) return false;
+    ID3D11DeviceContext* deferred = nullptr;
+    const HRESULT hr = m_device->CreateDeferredContext(0, &deferred);
+    if (FAILED(hr) || !deferred) {
+        _MESSAGE("[DLSS] Deferred passes unavailable: CreateDeferredContext 0x%08X", hr);
+        m_deferredPassesEnabled = false;
+        return false;
+    }
+    D3D11_FEATURE_DATA_THREADING threading{};
+    m_device->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading));
+    m_passRecorder = new DeferredRecorder(m_context, deferred);
+    m_passCache = new DLSSCmdList::Cache(*m_passRecorder);
+    m_passCache->Start();
+    _MESSAGE("[DLSS] Deferred passes: recording on a worker thread (driver command lists: %s)",
+             threading.DriverCommandLists ? "yes" : "emulated");
+    return true;
+}
+
+void DLSSManager::ReleasePassCache() {
+    delete m_passCache;  // joins the worker and releases the lists
+    m_passCache = nullptr;
+    delete m_passRecorder;
+    m_passRecorder = nullptr;
+}
+
+void DLSSManager::InvalidatePass(DLSSCmdList::Pass pass) {
+    if (m_passCache) m_passCache->Invalidate(pass);
+}
+
+void DLSSManager::SetDeferredPasses(bool enabled) {
+    if (m_deferredPassesEnabled == enabled) return;
+    m_deferredPassesEnabled = enabled;
+    if (!enabled) ReleasePassCache();
+    _MESSAGE("[CFG] Deferred passes %s", enabled ? "enabled" : "disabled");
+}
+
+void DLSSManager::SetPersistentTags(bool enabled) {
+    if (m_persistentTagsEnabled == enabled) return;
+    m_persistentTagsEnabled = enabled;
+    _MESSAGE("[CFG] Persistent SL tags %s", enabled ? "enabled" : "disabled");
+}
+
+DLSSCmdList::Stats DLSSManager::GetDeferredPassStats() const {
+    return m_passCache ? m_passCache->GetStats() : DLSSCmdList::Stats{};
+}
+
+bool DLSSManager::DispatchCompute(ID3D11ComputeShader* cs, ID3D11ShaderResourceView* srv, ID3D11UnorderedAccessView* uav,
+                                  ID3D11Buffer* cb, uint32_t groupsX, uint32_t groupsY) {
+    // Compute stage only: slot 0 of shader, SRV, UAV and constant buffer
+    ID3D11ComputeShader* oldCS = nullptr; m_context->CSGetShader(&oldCS, nullptr, nullptr);
+    ID3D11ShaderResourceView* oldSRV = nullptr; m_context->CSGetShaderResources(0, 1, &oldSRV);
+    ID3D11UnorderedAccessView* oldUAV = nullptr; m_context->CSGetUnorderedAccessViews(0, 1, &oldUAV);
+    ID3D11Buffer* oldCB = nullptr; m_context->CSGetConstantBuffers(0, 1, &oldCB);
+
+    m_context->CSSetShader(cs, nullptr, 0);
+    m_context->CSSetShaderResources(0, 1, &srv);
+    m_context->CSSetUnorderedAccessViews(0, 1, &uav, nullptr);
+    m_context->CSSetConstantBuffers(0, 1, &cb);
+    m_context->Dispatch(groupsX, groupsY, 1);
+
+    // Unbind so the target can be read as an SRV afterwards, then restore
+    ID3D11ShaderResourceView* nullSRV[1] = { nullptr };
+    ID3D11UnorderedAccessView* nullUAV[1] = { nullptr };
+    m_context->CSSetShaderResources(0, 1, nullSRV);
+    m_context->CSSetUnorderedAccessViews(0, 1, nullUAV, nullptr);
+
+    m_context->CSSetShader(oldCS, nullptr, 0);
+    m_context->CSSetShaderResources(0, 1, &oldSRV);
+    m_context->CSSetUnorderedAccessViews(0, 1, &oldUAV, nullptr);
+    m_context->CSSetConstantBuffers(0, 1, &oldCB);
+    if (oldCS) oldCS->Release(); if (oldSRV) oldSRV->Release();
+    if (oldUAV) oldUAV->Release(); if (oldCB) oldCB->Release();
     return true;
 }
 
+void DLSSManager::CollectGpuTimer(GpuTimer& timer) {
+    for (GpuTimerSlot& t : timer.slots) {
+        if (!t.pending) continue;
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT dj{};
+        if (m_context->GetData(t.disjoint, &dj, sizeof(dj), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) continue;
+        UINT64 begin = 0, end = 0;
+        if (m_context->GetData(t.begin, &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            m_context->GetData(t.end, &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+            continue;
+        }
+        t.pending = false;
+        if (dj.Disjoint || dj.Frequency == 0 || end < begin) continue;
+        const float ms = static_cast<float>(static_cast<double>(end - begin) * 1000.0 / static_cast<double>(dj.Frequency));
+        timer.ms = (timer.ms > 0.0f) ? timer.ms * 0.9f + ms * 0.1f : ms;
+    }
+}
+
+int DLSSManager::BeginGpuTimer(GpuTimer& timer) {
+    if (!m_device || !m_context) return -1;
+    CollectGpuTimer(timer);
+    const uint32_t index = timer.next;
+    GpuTimerSlot& t = timer.slots[index];
+    if (t.pending) return -1;  // GPU is behind; skip this sample
+    if (!t.disjoint) {
+        D3D11_QUERY_DESC qd{};
+        qd.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+        if (FAILED(m_device->CreateQuery(&qd, &t.disjoint))) return -1;
+        qd.Query = D3D11_QUERY_TIMESTAMP;
+        if (FAILED(m_device->CreateQuery(&qd, &t.begin)) || FAILED(m_device->CreateQuery(&qd, &t.end))) return -1;
+    }
+    m_context->Begin(t.disjoint);
+    m_context->End(t.begin);
+    return static_cast<int>(index);
+}
+
+void DLSSManager::EndGpuTimer(GpuTimer& timer, int slot) {
+    if (slot < 0 || !m_context) return;
+    GpuTimerSlot& t = timer.slots[slot];
+    m_context->End(t.end);
+    m_context->End(t.disjoint);
+    t.pending = true;
+    timer.next = (timer.next + 1) % kGpuTimerSlots;
+}
+
+void DLSSManager::ReleaseGpuTimer(GpuTimer& timer) {
+    for (GpuTimerSlot& t : timer.slots) {
+        if (t.disjoint) t.disjoint->Release();
+        if (t.begin) t.begin->Release();
+        if (t.end) t.end->Release();
+        t = GpuTimerSlot{};
+    }
+    timer.next = 0;
+    timer.ms = 0.0f;
+}
+
 bool DLSSManager::DownscaleToRender(EyeContext& eye, ID3D11Texture2D* inputTexture, uint32_t renderWidth, uint32_t renderHeight) {
     if (!EnsureDownscaleShaders()) return false;
     if (!inputTexture) return false;
     D3D11_TEXTURE2D_DESC inDesc{}; inputTexture->GetDesc(&inDesc);
+    const FormatRoute route = RouteFormat(inDesc.Format);
+    const DXGI_FORMAT renderFormat = (route.view != DXGI_FORMAT_UNKNOWN) ? route.view : inDesc.Format;
+    ID3D11PixelShader* ps = GetDownscaleShader(m_downscaleFilter, route.encoding, DLSSDownscale::Layout::Mono);
+    if (!ps) return false;
+
     // Ensure render target
-    if (!eye.renderColor || eye.renderWidth != renderWidth || eye.renderHeight != renderHeight) {
+    D3D11_TEXTURE2D_DESC curDesc{};
+    if (eye.renderColor) eye.renderColor->GetDesc(&curDesc);
+    if (!eye.renderColor || eye.renderWidth != renderWidth || eye.renderHeight != renderHeight || curDesc.Format != renderFormat) {
         ReleaseEyeRender(eye);
         D3D11_TEXTURE2D_DESC td = {};
         td.Width = renderWidth; td.Height = renderHeight; td.MipLevels = 1; td.ArraySize = 1;
-        td.Format = inDesc.Format;
+        td.Format = renderFormat;
         td.SampleDesc.Count = 1; td.Usage = D3D11_USAGE_DEFAULT;
         td.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+        UINT support = 0;
+        const bool uavCapable = SUCCEEDED(m_device->CheckFormatSupport(renderFormat, &support)) &&
+                                (support & D3D11_FORMAT_SUPPORT_TYPED_UNORDERED_ACCESS_VIEW);
+        if (uavCapable) td.BindFlags |= D3D11_BIND_UNORDERED_ACCESS;
         if (FAILED(m_device->CreateTexture2D(&td, nullptr, &eye.renderColor))) return false;
+        ++g_textureCreates;
+        DLSSVram::TrackTexture(eye.renderColor, DLSSVram::Pool::RenderColor);
         if (FAILED(m_device->CreateRenderTargetView(eye.renderColor, nullptr, &eye.renderColorRTV))) return false;
+        if (uavCapable && FAILED(m_device->CreateUnorderedAccessView(eye.renderColor, nullptr, &eye.renderColorUAV))) {
+            eye.renderColorUAV = nullptr;
+        }
         eye.renderWidth = renderWidth; eye.renderHeight = renderHeight;
-        eye.requiresReset = true;
+        eye.history.Invalidate(DLSSHistory::Reason::ResourceRecreated);
+    }
+
+    // Compute path when selected and possible: typed UAV on the target and a
+    // tile footprint that fits groupshared memory; otherwise the graphics pass
+    ID3D11ComputeShader* cs = nullptr;
+    if (m_downscaleCompute && eye.renderColorUAV &&
+        DLSSDownscale::ComputeFits(m_downscaleFilter, inDesc.Width, renderWidth) &&
+        DLSSDownscale::ComputeFits(m_downscaleFilter, inDesc.Height, renderHeight)) {
+        cs = GetDownscaleComputeShader(m_downscaleFilter, route.encoding);
+    }
+    m_lastDownscaleCompute = (cs != nullptr);
+
+    // Recorded pass: one ExecuteCommandList instead of the view, state and draw calls below
+    const DLSSCmdList::Pass pass = DownscalePass(&eye == &m_rightEye ? 1 : 0);
+    DLSSCmdList::Key key{};
+    key.source = inputTexture;
+    key.target = eye.renderColor;
+    key.sourceFormat = static_cast<uint32_t>(inDesc.Format);
+    key.sourceWidth = inDesc.Width; key.sourceHeight = inDesc.Height;
+    key.regionWidth = renderWidth; key.regionHeight = renderHeight;
+    key.variant = static_cast<uint32_t>(m_downscaleFilter) | (static_cast<uint32_t>(route.encoding) << 4) | (cs ? 0x100u : 0u);
+    const int timer = BeginGpuTimer(m_downscaleTimer);
+    if (m_passCache && m_passCache->Execute(pass, key)) {
+        EndGpuTimer(m_downscaleTimer, timer);
+        return true;
     }
 
     // Create SRV for input (or copied input if not SRV-bindable)
+    D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc{};
+    viewDesc.Format = route.view;
+    viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    viewDesc.Texture2D.MipLevels = 1;
+    const D3D11_SHADER_RESOURCE_VIEW_DESC* pViewDesc = (route.view != DXGI_FORMAT_UNKNOWN) ? &viewDesc : nullptr;
     ID3D11ShaderResourceView* inSRV = nullptr;
-    HRESULT hr = m_device->CreateShaderResourceView(inputTexture, nullptr, &inSRV);
+    HRESULT hr = m_device->CreateShaderResourceView(inputTexture, pViewDesc, &inSRV);
     ID3D11Texture2D* tempCopy = nullptr;
     if (FAILED(hr) || !inSRV) {
         // Make a copy with SRV bind
         D3D11_TEXTURE2D_DESC cd = inDesc; cd.BindFlags |= D3D11_BIND_SHADER_RESOURCE; cd.Usage = D3D11_USAGE_DEFAULT; cd.MipLevels = 1; cd.ArraySize = 1;
-        if (FAILED(m_device->CreateTexture2D(&cd, nullptr, &tempCopy))) return false;
+        if (FAILED(m_device->CreateTexture2D(&cd, nullptr, &tempCopy))) { EndGpuTimer(m_downscaleTimer, timer); return false; }
+        ++g_textureCreates;
+        DLSSVram::TrackTexture(tempCopy, DLSSVram::Pool::RenderColor);
         m_context->CopyResource(tempCopy, inputTexture);
-        if (FAILED(m_device->CreateShaderResourceView(tempCopy, nullptr, &inSRV))) { tempCopy->Release(); return false; }
+        if (FAILED(m_device->CreateShaderResourceView(tempCopy, pViewDesc, &inSRV))) {
+            EndGpuTimer(m_downscaleTimer, timer);
+            DLSSVram::ReleaseTexture(tempCopy);
+            return false;
+        }
     }
 
-    // Save state (minimal)
-    ID3D11RenderTargetView* oldRTV = nullptr; ID3D11DepthStencilView* oldDSV = nullptr;
-    m_context->OMGetRenderTargets(1, &oldRTV, &oldDSV);
-    D3D11_VIEWPORT oldVP{}; UINT vpCount = 1; m_context->RSGetViewports(&vpCount, &oldVP);
-    D3D11_PRIMITIVE_TOPOLOGY oldTopo; m_context->IAGetPrimitiveTopology(&oldTopo);
-    ID3D11VertexShader* oldVS = nullptr; ID3D11PixelShader* oldPS = nullptr;
-    m_context->VSGetShader(&oldVS, nullptr, nullptr);
-    m_context->PSGetShader(&oldPS, nullptr, nullptr);
-    ID3D11ShaderResourceView* oldSRV = nullptr; m_context->PSGetShaderResources(0, 1, &oldSRV);
-    ID3D11SamplerState* oldSamp = nullptr; m_context->PSGetSamplers(0, 1, &oldSamp);
+    const DLSSDownscale::Params params = DLSSDownscale::MakeParams(m_downscaleFilter, inDesc.Width, inDesc.Height, renderWidth, renderHeight);
+    bool ok;
+    if (cs) {
+        m_context->UpdateSubresource(m_downscaleCB, 0, nullptr, &params, 0, 0);
+        ok = DispatchCompute(cs, inSRV, eye.renderColorUAV, m_downscaleCB,
+                             DLSSDownscale::TileCount(renderWidth), DLSSDownscale::TileCount(renderHeight));
+    } else {
+        ok = DrawFullscreen(inSRV, eye.renderColorRTV, ps, params, renderWidth, renderHeight);
+    }
+    EndGpuTimer(m_downscaleTimer, timer);
+    // A per-frame copy of an unreadable input cannot be recorded
+    if (ok && !tempCopy && m_passCache && m_passCache->NeedsJob(pass, key)) {
+        PassJob* job = NewPassJob(m_downscaleCB, params, inSRV);
+        if (cs) {
+            job->cs = Retain(cs);
+            job->uav = Retain(eye.renderColorUAV);
+            job->groupsX = DLSSDownscale::TileCount(renderWidth);
+            job->groupsY = DLSSDownscale::TileCount(renderHeight);
+        } else {
+            job->vs = Retain(m_fsVS);
+            job->ps = Retain(ps);
+            job->sampler = Retain(m_linearSampler);
+            job->rtv = Retain(eye.renderColorRTV);
+            job->width = renderWidth;
+            job->height = renderHeight;
+        }
+        m_passCache->Submit(pass, key, job);
+    }
+    if (inSRV) inSRV->Release();
+    DLSSVram::ReleaseTexture(tempCopy);
+    return ok;
+}
 
-    // Set viewport and render target
-    D3D11_VIEWPORT vp{}; vp.TopLeftX = 0; vp.TopLeftY = 0; vp.Width = (float)renderWidth; vp.Height = (float)renderHeight; vp.MinDepth = 0; vp.MaxDepth = 1;
-    m_context->RSSetViewports(1, &vp);
-    m_context->OMSetRenderTargets(1, &eye.renderColorRTV, nullptr);
+ID3D11ComputeShader* DLSSManager::GetSharpenShader(DLSSDownscale::Encoding encoding) {
+    const uint32_t index = static_cast<uint32_t>(encoding);
+    if (index >= DLSSSharpen::kPermutationCount) return nullptr;
+    if (!m_sharpenCS[index]) {
+        DLSSShaders::Bytecode cs;
+        if (!DLSSShaders::Get(DLSSShaders::SharpenId(encoding), cs) ||
+            FAILED(m_device->CreateComputeShader(cs.data, cs.size, nullptr, &m_sharpenCS[index]))) {
+            _MESSAGE("[DLSS] Sharpen permutation %u unavailable", index);
+            return nullptr;
+        }
+    }
+    return m_sharpenCS[index];
+}
 
-    // Bind pipeline
-    m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    m_context->VSSetShader(m_fsVS, nullptr, 0);
-    m_context->PSSetShader(m_fsPS, nullptr, 0);
-    m_context->PSSetShaderResources(0, 1, &inSRV);
-    m_context->PSSetSamplers(0, 1, &m_linearSampler);
-    m_context->Draw(3, 0);
+void DLSSManager::ReleaseEyeSharpen(EyeContext& eye) {
+    InvalidatePass(SharpenPass(&eye == &m_rightEye ? 1 : 0));
+    if (eye.outputUAV) { eye.outputUAV->Release(); eye.outputUAV = nullptr; }
+    if (eye.upscaledSRV) { eye.upscaledSRV->Release(); eye.upscaledSRV = nullptr; }
+    DLSSVram::ReleaseTexture(eye.upscaledTexture);
+}
 
-    // Unbind
-    ID3D11ShaderResourceView* nullSRV[1] = { nullptr };
-    m_context->PSSetShaderResources(0, 1, nullSRV);
+bool DLSSManager::EnsureSharpenTarget(EyeContext& eye) {
+    if (!eye.outputTexture) return false;
+    // The views belong to one output texture; rebuild when it was recreated
+    if (eye.outputUAV) {
+        ID3D11Resource* bound = nullptr;
+        eye.outputUAV->GetResource(&bound);
+        if (bound) bound->Release();
+        if (bound == eye.outputTexture) return true;
+        ReleaseEyeSharpen(eye);
+    }
 
-    // Restore state
-    m_context->OMSetRenderTargets(1, &oldRTV, oldDSV);
-    if (oldRTV) oldRTV->Release(); if (oldDSV) oldDSV->Release();
-    m_context->RSSetViewports(vpCount, &oldVP);
-    m_context->IASetPrimitiveTopology(oldTopo);
-    m_context->VSSetShader(oldVS, nullptr, 0);
-    m_context->PSSetShader(oldPS, nullptr, 0);
-    if (oldVS) oldVS->Release(); if (oldPS) oldPS->Release();
-    if (oldSRV) { ID3D11ShaderResourceView* r[1] = { oldSRV }; m_context->PSSetShaderResources(0, 1, r); oldSRV->Release(); }
-    if (oldSamp) { ID3D11SamplerState* s[1] = { oldSamp }; m_context->PSSetSamplers(0, 1, s); oldSamp->Release(); }
-    if (inSRV) inSRV->Release(); if (tempCopy) tempCopy->Release();
+    return CreateSharpenViews(eye.outputTexture, eye.upscaledTexture, eye.upscaledSRV, eye.outputUAV, eye.outputEncoding);
+}
+
+bool DLSSManager::CreateSharpenViews(ID3D11Texture2D* target, ID3D11Texture2D*& upscaled, ID3D11ShaderResourceView*& srv,
+                                     ID3D11UnorderedAccessView*& uav, DLSSDownscale::Encoding& encoding) {
+    D3D11_TEXTURE2D_DESC desc{};
+    target->GetDesc(&desc);
+    // The device refused these views before; do not allocate and fail every frame
+    if (static_cast<uint32_t>(desc.Format) < m_sharpenViewFailed.size() && m_sharpenViewFailed.test(desc.Format)) return false;
+
+    if (!m_sharpenCB) {
+        D3D11_BUFFER_DESC bd = {};
+        bd.ByteWidth = sizeof(DLSSSharpen::Params);
+        bd.Usage = D3D11_USAGE_DEFAULT;
+        bd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        if (FAILED(m_device->CreateBuffer(&bd, nullptr, &m_sharpenCB))) return false;
+        DLSSVram::TrackBuffer(m_sharpenCB, DLSSVram::Pool::Constants);
+    }
+
+    const FormatRoute route = RouteFormat(desc.Format);
+    if (!GetSharpenShader(route.encoding)) return false;
+    if (!CreateOutputTexture(m_device, desc, desc.Width, desc.Height, DLSSVram::Pool::Sharpen, &upscaled)) return false;
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+    srvDesc.Format = route.view;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MipLevels = 1;
+    D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc{};
+    uavDesc.Format = route.view;
+    uavDesc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
+    const bool typed = (route.view != DXGI_FORMAT_UNKNOWN);
+    if (FAILED(m_device->CreateShaderResourceView(upscaled, typed ? &srvDesc : nullptr, &srv)) ||
+        FAILED(m_device->CreateUnorderedAccessView(target, typed ? &uavDesc : nullptr, &uav))) {
+        _MESSAGE("[DLSS] Sharpening unavailable for output format %u", (unsigned)desc.Format);
+        if (static_cast<uint32_t>(desc.Format) < m_sharpenViewFailed.size()) m_sharpenViewFailed.set(desc.Format);
+        if (uav) { uav->Release(); uav = nullptr; }
+        if (srv) { srv->Release(); srv = nullptr; }
+        DLSSVram::ReleaseTexture(upscaled);
+        return false;
+    }
+    encoding = route.encoding;
+    return true;
+}
+
+bool DLSSManager::SharpenToOutput(EyeContext& eye) {
+    return DispatchSharpen(&eye == &m_rightEye ? 1 : 0, eye.upscaledSRV, eye.outputUAV, eye.outputEncoding,
+                           DLSSAtlas::Rect{0, 0, eye.outputWidth, eye.outputHeight});
+}
+
+bool DLSSManager::DispatchSharpen(int eyeIndex, ID3D11ShaderResourceView* srv, ID3D11UnorderedAccessView* uav,
+                                  DLSSDownscale::Encoding encoding, const DLSSAtlas::Rect& region) {
+    ID3D11ComputeShader* cs = GetSharpenShader(encoding);
+    if (!cs || !srv || !uav || !m_sharpenCB) return false;
+    m_outputBinds += 2;
+
+    const DLSSCmdList::Pass pass = SharpenPass(eyeIndex);
+    DLSSCmdList::Key key{};
+    key.source = srv;
+    key.target = uav;
+    key.regionX = region.x; key.regionY = region.y;
+    key.regionWidth = region.width; key.regionHeight = region.height;
+    key.variant = static_cast<uint32_t>(encoding);
+    key.scalar = m_sharpness;
+    if (m_passCache && m_passCache->Execute(pass, key)) return true;
+
+    const DLSSSharpen::Params params = DLSSSharpen::MakeParams(region.width, region.height, m_sharpness, region.x, region.y);
+    const uint32_t groupsX = DLSSSharpen::GroupCount(region.width);
+    const uint32_t groupsY = DLSSSharpen::GroupCount(region.height);
+    m_context->UpdateSubresource(m_sharpenCB, 0, nullptr, &params, 0, 0);
+    const bool ok = DispatchCompute(cs, srv, uav, m_sharpenCB, groupsX, groupsY);
+    if (ok && m_passCache && m_passCache->NeedsJob(pass, key)) {
+        PassJob* job = NewPassJob(m_sharpenCB, params, srv);
+        job->cs = Retain(cs);
+        job->uav = Retain(uav);
+        job->groupsX = groupsX;
+        job->groupsY = groupsY;
+        m_passCache->Submit(pass, key, job);
+    }
+    return ok;
+}
+
+void DLSSManager::SetStereoAtlas(bool enabled) {
+    if (m_stereoAtlasEnabled == enabled) return;
+    m_stereoAtlasEnabled = enabled;
+    _MESSAGE("[CFG] Stereo atlas output %s", enabled ? "enabled" : "disabled");
+}
+
+bool DLSSManager::GetAtlasLayout(ID3D11Texture2D* texture, DLSSAtlas::Layout& layout) const {
+    if (!texture || texture != m_atlas.texture) return false;
+    layout = m_atlas.layout;
+    return true;
+}
+
+DLSSAtlas::OutputStats DLSSManager::GetOutputStats() const {
+    DLSSAtlas::OutputStats stats{};
+    auto add = [&stats](ID3D11Texture2D* texture) {
+        if (!texture) return;
+        D3D11_TEXTURE2D_DESC desc{};
+        texture->GetDesc(&desc);
+        ++stats.textures;
+        stats.bytes += DLSSVram::TextureBytes(desc.Format, desc.Width, desc.Height, desc.MipLevels, desc.ArraySize, desc.SampleDesc.Count);
+    };
+    stats.atlas = m_atlas.texture != nullptr;
+    if (stats.atlas) {
+        add(m_atlas.texture);
+        add(m_atlas.upscaled);
+        stats.views = (m_atlas.textureUAV ? 1u : 0u) + (m_atlas.upscaledSRV ? 1u : 0u);
+    } else {
+        for (const EyeContext* eye : { &m_leftEye, &m_rightEye }) {
+            add(eye->outputTexture);
+            add(eye->upscaledTexture);
+            stats.views += (eye->outputUAV ? 1u : 0u) + (eye->upscaledSRV ? 1u : 0u);
+        }
+    }
+    stats.binds = m_lastOutputBinds;
+    return stats;
+}
+
+bool DLSSManager::EnsureStereoAtlas(const D3D11_TEXTURE2D_DESC& inputDesc, const DLSSAtlas::Layout& layout) {
+    if (!layout.IsValid() || layout.width > 16384u || layout.height > 16384u) return false;
+    if (m_atlas.texture && m_atlas.layout == layout && m_atlas.format == inputDesc.Format) return true;
+
+    ReleaseStereoAtlas();
+    if (!CreateOutputTexture(m_device, inputDesc, layout.width, layout.height, DLSSVram::Pool::EyeOutput, &m_atlas.texture)) {
+        return false;
+    }
+    m_atlas.layout = layout;
+    m_atlas.format = inputDesc.Format;
+    // Both eyes now write new memory
+    m_leftEye.history.Invalidate(DLSSHistory::Reason::ResourceRecreated);
+    m_rightEye.history.Invalidate(DLSSHistory::Reason::ResourceRecreated);
+    _MESSAGE("[DLSS] Stereo atlas %ux%u: left %ux%u at x=0, right %ux%u at x=%u",
+             layout.width, layout.height, layout.eyes[0].width, layout.eyes[0].height,
+             layout.eyes[1].width, layout.eyes[1].height, layout.eyes[1].x);
     return true;
 }
 
+bool DLSSManager::EnsureAtlasSharpen() {
+    if (!m_atlas.texture) return false;
+    if (m_atlas.textureUAV) return true;
+    return CreateSharpenViews(m_atlas.texture, m_atlas.upscaled, m_atlas.upscaledSRV, m_atlas.textureUAV, m_atlas.encoding);
+}
+
+void DLSSManager::ReleaseAtlasSharpen() {
+    InvalidatePass(DLSSCmdList::Pass::SharpenLeft);
+    InvalidatePass(DLSSCmdList::Pass::SharpenRight);
+    if (m_atlas.textureUAV) { m_atlas.textureUAV->Release(); m_atlas.textureUAV = nullptr; }
+    if (m_atlas.upscaledSRV) { m_atlas.upscaledSRV->Release(); m_atlas.upscaledSRV = nullptr; }
+    DLSSVram::ReleaseTexture(m_atlas.upscaled);
+}
+
+void DLSSManager::ReleaseStereoAtlas() {
+    ReleaseAtlasSharpen();
+    ReleaseProbeView(m_leftEye, kProbeOutput);
+    ReleaseProbeView(m_rightEye, kProbeOutput);
+    DLSSVram::ReleaseTexture(m_atlas.texture);
+    m_atlas = StereoAtlas{};
+}
+
+namespace {
+    constexpr uint32_t kProbeReadbackSlots = 3;
+
+    // DLSSReadback::Device over staging buffers and event queries, one pair
+    // per stream and slot
+    class D3DReadback final : public DLSSReadback::Device {
+    public:
+        D3DReadback(ID3D11Device* device, ID3D11DeviceContext* context) : m_device(device), m_context(context) {}
+        ~D3DReadback() override {
+            for (auto& stream : m_slots) {
+                for (Slot& s : stream) {
+                    DLSSVram::ReleaseBuffer(s.staging);
+                    ReleaseRef(s.fence);
+                }
+            }
+        }
+
+        bool CreateStream(uint32_t stream, uint32_t bytes, uint32_t slots) {
+            if (stream >= DLSSReadback::kMaxStreams || slots > DLSSReadback::kMaxSlots) return false;
+            D3D11_BUFFER_DESC bd = {};
+            bd.ByteWidth = bytes;
+            bd.Usage = D3D11_USAGE_STAGING;
+            bd.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+            D3D11_QUERY_DESC qd = {};
+            qd.Query = D3D11_QUERY_EVENT;
+            for (uint32_t i = 0; i < slots; ++i) {
+                Slot& s = m_slots[stream][i];
+                if (FAILED(m_device->CreateBuffer(&bd, nullptr, &s.staging))) return false;
+                DLSSVram::TrackBuffer(s.staging, DLSSVram::Pool::Readback);
+                if (FAILED(m_device->CreateQuery(&qd, &s.fence))) return false;
+            }
+            return true;
+        }
+
+        // Render thread: copy 'source' (same size as the stream) and fence it
+        bool Issue(uint32_t stream, uint32_t slot, ID3D11Buffer* source) {
+            Slot* s = Find(stream, slot);
+            if (!s || !s->staging || !s->fence || !source) return false;
+            m_context->CopyResource(s->staging, source);
+            m_context->End(s->fence);
+            return true;
+        }
+
+        bool Signaled(uint32_t stream, uint32_t slot) override {
+            Slot* s = Find(stream, slot);
+            return s && s->fence && m_context->GetData(s->fence, nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK;
+        }
+
+        bool Read(uint32_t stream, uint32_t slot, void* dst, uint32_t bytes) override {
+            Slot* s = Find(stream, slot);
+            if (!s || !s->staging) return false;
+            D3D11_MAPPED_SUBRESOURCE mapped{};
+            if (FAILED(m_context->Map(s->staging, 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped))) return false;
+            std::memcpy(dst, mapped.pData, bytes);
+            m_context->Unmap(s->staging, 0);
+            return true;
+        }
+
+    private:
+        struct Slot {
+            ID3D11Buffer* staging = nullptr;
+            ID3D11Query* fence = nullptr;
+        };
+
+        Slot* Find(uint32_t stream, uint32_t slot) {
+            return (stream < DLSSReadback::kMaxStreams && slot < DLSSReadback::kMaxSlots) ? &m_slots[stream][slot] : nullptr;
+        }
+
+        ID3D11Device* m_device;
+        ID3D11DeviceContext* m_context;
+        Slot m_slots[DLSSReadback::kMaxStreams][DLSSReadback::kMaxSlots];
+    };
+}
+
+bool DLSSManager::EnsureReadback() {
+    if (m_readback) return true;
+    if (m_readbackUnavailable || !m_device || !m_context) return false;
+    D3DReadback* device = new D3DReadback(m_device, m_context);
+    m_readbackDevice = device;
+    m_readback = new DLSSReadback::Ring(*device);
+
+    static const char* const kNames[2][3] = { { "Depth L", "Output L", "Motion L" }, { "Depth R", "Output R", "Motion R" } };
+    EyeContext* eyes[2] = { &m_leftEye, &m_rightEye };
+    auto add = [&](const char* name, uint32_t bytes, uint32_t slots) {
+        const int stream = m_readback->AddStream(name, bytes, slots, &DLSSManager::OnReadback, this);
+        return (stream >= 0 && device->CreateStream(static_cast<uint32_t>(stream), bytes, slots)) ? stream : -1;
+    };
+    bool ok = true;
+    for (int i = 0; i < 2 && ok; ++i) {
+        EyeContext& eye = *eyes[i];
+        eye.depthStream = add(kNames[i][0], DLSSHistory::kDepthBins * sizeof(uint32_t), DLSSHistory::kDepthReadbackSlots);
+        eye.probeStreams[kProbeOutput] = add(kNames[i][1], DLSSReadback::kProbeBytes, kProbeReadbackSlots);
+        eye.probeStreams[kProbeMotion] = add(kNames[i][2], DLSSReadback::kProbeBytes, kProbeReadbackSlots);
+        ok = eye.depthStream >= 0 && eye.probeStreams[kProbeOutput] >= 0 && eye.probeStreams[kProbeMotion] >= 0;
+    }
+    if (!ok) {
+        _MESSAGE("[READBACK] Staging buffers or queries could not be created; depth histogram and probes disabled");
+        ReleaseReadback();
+        m_readbackUnavailable = true;
+        return false;
+    }
+    return true;
+}
+
+void DLSSManager::ReleaseReadback() {
+    ReleaseEyeProbes(m_leftEye);
+    ReleaseEyeProbes(m_rightEye);
+    delete m_readback;
+    m_readback = nullptr;
+    delete m_readbackDevice;  // releases the staging copies and fences
+    m_readbackDevice = nullptr;
+    for (EyeContext* eye : { &m_leftEye, &m_rightEye }) {
+        eye->depthStream = -1;
+        eye->depthArrivedValid = false;
+        eye->probeStreams[kProbeOutput] = eye->probeStreams[kProbeMotion] = -1;
+    }
+    m_readbackCollectFrame = 0;
+    ReleaseRef(m_probeCS);
+    DLSSVram::ReleaseBuffer(m_probeCB);
+    ReleaseRef(m_probePartialsUAV);
+    DLSSVram::ReleaseBuffer(m_probePartials);
+}
+
+void DLSSManager::CollectReadback() {
+    const uint64_t frame = DLSSVram::Global().Frame();
+    if (!m_readback || frame == m_readbackCollectFrame) return;
+    m_readbackCollectFrame = frame;
+    m_readback->Collect(frame);
+}
+
+int DLSSManager::BeginReadback(int stream) {
+    if (!m_readback || stream < 0) return -1;
+    return m_readback->Acquire(static_cast<uint32_t>(stream), DLSSVram::Global().Frame());
+}
+
+void DLSSManager::EndReadback(int stream, int slot, ID3D11Buffer* source) {
+    if (!m_readback || stream < 0 || slot < 0) return;
+    if (static_cast<D3DReadback*>(m_readbackDevice)->Issue(static_cast<uint32_t>(stream), static_cast<uint32_t>(slot), source)) {
+        m_readback->Commit(static_cast<uint32_t>(stream), slot);
+    } else {
+        m_readback->Cancel(static_cast<uint32_t>(stream), slot);
+    }
+}
+
+void DLSSManager::OnReadback(void* self, const DLSSReadback::Result& result) {
+    static_cast<DLSSManager*>(self)->HandleReadback(result);
+}
+
+void DLSSManager::HandleReadback(const DLSSReadback::Result& result) {
+    const int stream = static_cast<int>(result.stream);
+    EyeContext* eyes[2] = { &m_leftEye, &m_rightEye };
+    for (int i = 0; i < 2; ++i) {
+        EyeContext& eye = *eyes[i];
+        if (stream == eye.depthStream) {
+            if (result.bytes != sizeof(eye.depthArrived)) return;
+            std::memcpy(eye.depthArrived, result.data, sizeof(eye.depthArrived));
+            eye.depthArrivedValid = true;
+            return;
+        }
+        for (int p = kProbeOutput; p <= kProbeMotion; ++p) {
+            if (stream != eye.probeStreams[p]) continue;
+            eye.probes[p] = DLSSReadback::ReduceProbe(result.data, result.bytes);
+            eye.probeFrames[p] = result.frame;
+            if (p == kProbeOutput) {
+                const bool nonFinite = eye.probes[p].nonFinite != 0;
+                if (nonFinite != eye.outputNonFinite) {
+                    if (nonFinite) {
+                        _MESSAGE("[READBACK] Eye %d output has NaN/Inf: %u of %u probe samples (frame %llu)", i,
+                                 eye.probes[p].nonFinite, eye.probes[p].nonFinite + eye.probes[p].samples,
+                                 (unsigned long long)result.frame);
+                    } else {
+                        _MESSAGE("[READBACK] Eye %d output finite again (frame %llu)", i, (unsigned long long)result.frame);
+                    }
+                }
+                eye.outputNonFinite = nonFinite;
+            }
+            return;
+        }
+    }
+}
+
+// The view holds a reference: drop it before its texture is released
+void DLSSManager::ReleaseProbeView(EyeContext& eye, int probe) {
+    ReleaseRef(eye.probeSRVs[probe]);
+    eye.probeSources[probe] = nullptr;
+}
+
+void DLSSManager::ReleaseEyeProbes(EyeContext& eye) {
+    for (int p = kProbeOutput; p <= kProbeMotion; ++p) {
+        ReleaseProbeView(eye, p);
+        eye.probeFrames[p] = 0;
+        if (m_readback && eye.probeStreams[p] >= 0) m_readback->Reset(static_cast<uint32_t>(eye.probeStreams[p]));
+    }
+    eye.outputNonFinite = false;
+}
+
+void DLSSManager::RecordProbes(EyeContext& eye, ID3D11Texture2D* output, const DLSSAtlas::Rect& region,
+                               ID3D11Texture2D* motionVectors) {
+    if (!m_readbackProbesEnabled) return;
+    RecordProbe(eye, kProbeOutput, output, region, DLSSReadback::Channel::Luma);
+    // The zero stand-in is not worth a readback
+    if (motionVectors && motionVectors != m_zeroMotionVectors) {
+        RecordProbe(eye, kProbeMotion, motionVectors, DLSSAtlas::Rect{}, DLSSReadback::Channel::Length);
+    }
+}
+
+bool DLSSManager::RecordProbe(EyeContext& eye, int probe, ID3D11Texture2D* source, const DLSSAtlas::Rect& region,
+                              DLSSReadback::Channel channel) {
+    const int stream = eye.probeStreams[probe];
+    if (!source || stream < 0) return false;
+    if (!m_probeCS) {
+        DLSSShaders::Bytecode cs;
+        if (!DLSSShaders::Get(DLSSShaders::Id::Probe, cs) ||
+            FAILED(m_device->CreateComputeShader(cs.data, cs.size, nullptr, &m_probeCS))) {
+            return false;
+        }
+    }
+    if (!m_probeCB) {
+        D3D11_BUFFER_DESC bd = {};
+        bd.ByteWidth = sizeof(DLSSReadback::ProbeParams);
+        bd.Usage = D3D11_USAGE_DEFAULT;
+        bd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        if (FAILED(m_device->CreateBuffer(&bd, nullptr, &m_probeCB))) return false;
+        DLSSVram::TrackBuffer(m_probeCB, DLSSVram::Pool::Constants);
+    }
+    if (!m_probePartials) {
+        D3D11_BUFFER_DESC bd = {};
+        bd.ByteWidth = DLSSReadback::kProbeBytes;
+        bd.Usage = D3D11_USAGE_DEFAULT;
+        bd.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+        bd.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+        if (FAILED(m_device->CreateBuffer(&bd, nullptr, &m_probePartials))) return false;
+        DLSSVram::TrackBuffer(m_probePartials, DLSSVram::Pool::Readback);
+        D3D11_UNORDERED_ACCESS_VIEW_DESC ud = {};
+        ud.Format = DXGI_FORMAT_R32_TYPELESS;
+        ud.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+        ud.Buffer.NumElements = DLSSReadback::kProbeBytes / sizeof(uint32_t);
+        ud.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_RAW;
+        if (FAILED(m_device->CreateUnorderedAccessView(m_probePartials, &ud, &m_probePartialsUAV))) {
+            DLSSVram::ReleaseBuffer(m_probePartials);
+            return false;
+        }
+    }
+
+    // Typeless 8-bit color is read through its UNORM view (encoded values);
+    // textures without SRV binding are remembered with a null view and skipped
+    D3D11_TEXTURE2D_DESC sd{};
+    source->GetDesc(&sd);
+    if (eye.probeSources[probe] != source) {
+        ReleaseRef(eye.probeSRVs[probe]);
+        eye.probeSources[probe] = source;
+        if ((sd.BindFlags & D3D11_BIND_SHADER_RESOURCE) && sd.SampleDesc.Count == 1) {
+            const DXGI_FORMAT view = RouteFormat(sd.Format).view;
+            D3D11_SHADER_RESOURCE_VIEW_DESC vd{};
+            vd.Format = view != DXGI_FORMAT_UNKNOWN ? view : sd.Format;
+            vd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+            vd.Texture2D.MipLevels = 1;
+            if (FAILED(m_device->CreateShaderResourceView(source, &vd, &eye.probeSRVs[probe]))) eye.probeSRVs[probe] = nullptr;
+        }
+        if (!eye.probeSRVs[probe]) {
+            _MESSAGE("[READBACK] %s: format %u not readable; probe skipped", m_readback->Name(static_cast<uint32_t>(stream)), (unsigned)sd.Format);
+        }
+    }
+    if (!eye.probeSRVs[probe]) return false;
+
+    const int slot = BeginReadback(stream);
+    if (slot < 0) return false;  // every copy still in flight: skip this frame
+    DLSSReadback::ProbeParams params{};
+    const bool whole = region.width == 0 || region.height == 0;
+    params.origin[0] = whole ? 0 : region.x;
+    params.origin[1] = whole ? 0 : region.y;
+    params.size[0] = whole ? sd.Width : region.width;
+    params.size[1] = whole ? sd.Height : region.height;
+    params.channel = static_cast<uint32_t>(channel);
+    m_context->UpdateSubresource(m_probeCB, 0, nullptr, &params, 0, 0);
+    DispatchCompute(m_probeCS, eye.probeSRVs[probe], m_probePartialsUAV, m_probeCB,
+                    DLSSReadback::kProbeGroups, DLSSReadback::kProbeGroups);
+    EndReadback(stream, slot, m_probePartials);
+    return true;
+}
+
+void DLSSManager::SetReadbackProbes(bool enabled) {
+    if (m_readbackProbesEnabled == enabled) return;
+    m_readbackProbesEnabled = enabled;
+    if (!enabled) {
+        ReleaseEyeProbes(m_leftEye);
+        ReleaseEyeProbes(m_rightEye);
+        ReleaseRef(m_probePartialsUAV);
+        DLSSVram::ReleaseBuffer(m_probePartials);
+    }
+    _MESSAGE("[CFG] Readback probes %s", enabled ? "enabled" : "disabled");
+}
+
+bool DLSSManager::GetEyeProbe(int eyeIndex, bool motion, DLSSReadback::ProbeStats& out) const {
+    const EyeContext& eye = eyeIndex == 1 ? m_rightEye : m_leftEye;
+    const int p = motion ? kProbeMotion : kProbeOutput;
+    if (!m_readbackProbesEnabled || !eye.probeFrames[p]) return false;
+    out = eye.probes[p];
+    return true;
+}
+
+DLSSReadback::StreamStats DLSSManager::GetReadbackStats(uint32_t stream) const {
+    return m_readback ? m_readback->GetStats(stream) : DLSSReadback::StreamStats{};
+}
+
+namespace {
+    // Staging copies of depth-stencil textures take the typeless format of their family
+    DXGI_FORMAT CaptureStagingFormat(DXGI_FORMAT format) {
+        switch (format) {
+            case DXGI_FORMAT_D32_FLOAT_S8X24_UINT: return DXGI_FORMAT_R32G8X24_TYPELESS;
+            case DXGI_FORMAT_D32_FLOAT: return DXGI_FORMAT_R32_TYPELESS;
+            case DXGI_FORMAT_D24_UNORM_S8_UINT: return DXGI_FORMAT_R24G8_TYPELESS;
+            case DXGI_FORMAT_D16_UNORM: return DXGI_FORMAT_R16_TYPELESS;
+            default: return format;
+        }
+    }
+
+    // Relative capture directories sit next to the INI in Documents
+    std::string ResolveCaptureDirectory(const std::string& directory) {
+        std::string path = directory;
+        const bool absolute = path.size() > 1 && (path[1] == ':' || path[0] == '\\' || path[0] == '/');
+        if (!absolute) {
+            char docs[MAX_PATH] = {};
+            if (SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_MYDOCUMENTS, NULL, 0, docs))) {
+                path = std::string(docs) + "\\My Games\\Fallout4VR\\F4SE\\Plugins\\" + path;
+            }
+        }
+        while (!path.empty() && (path.back() == '\\' || path.back() == '/')) path.pop_back();
+        return path;
+    }
+}
+
+void DLSSManager::ScheduleCapture(uint64_t firstFrame, uint32_t frameCount) {
+    if (m_captureActive) FinishCapture();
+    m_captureFirstFrame = firstFrame ? firstFrame : 1;
+    m_captureEndFrame = frameCount ? m_captureFirstFrame + frameCount : UINT64_MAX;
+    if (frameCount) {
+        _MESSAGE("[CAPTURE] Scheduled frames %llu-%llu", (unsigned long long)m_captureFirstFrame,
+                 (unsigned long long)(m_captureEndFrame - 1));
+    } else {
+        _MESSAGE("[CAPTURE] Scheduled from frame %llu until stopped", (unsigned long long)m_captureFirstFrame);
+    }
+}
+
+void DLSSManager::StartCapture(uint32_t frameCount) {
+    ScheduleCapture(DLSSVram::Global().Frame() + 1, frameCount);
+}
+
+void DLSSManager::StopCapture() {
+    if (!m_captureFirstFrame) return;
+    if (!m_captureActive) {
+        m_captureFirstFrame = 0;
+        _MESSAGE("[CAPTURE] Scheduled capture cancelled");
+        return;
+    }
+    // Copies already issued are still collected; UpdateCapture closes the file after them
+    m_captureEndFrame = std::min(m_captureEndFrame, DLSSVram::Global().Frame() + 1);
+}
+
+// Once per frame, before the eyes: reads back the copies that have landed
+// and opens or closes the file at the range's edges
+void DLSSManager::UpdateCapture() {
+    const uint64_t frame = DLSSVram::Global().Frame();
+    if (!m_captureFirstFrame || frame == m_captureUpdateFrame) return;
+    m_captureUpdateFrame = frame;
+
+    if (m_captureActive && !m_captureWriter.IsOpen()) {
+        _MESSAGE("[CAPTURE] Writing %s failed; capture stopped", m_captureWriter.GetStats().path.c_str());
+        FinishCapture();
+        return;
+    }
+
+    // In issue order per eye: a copy not readable yet holds back the ones behind it
+    bool pending = false;
+    for (int i = 0; i < 2; ++i) {
+        while (m_captureCount[i] > 0) {
+            const uint64_t age = frame - m_captureSlots[i][m_captureHead[i]].issueFrame;
+            if (age < DLSSReadback::kMinLatency) break;
+            if (!ReadCaptureSlot(i)) {
+                if (age < DLSSReadback::kStaleFrames) break;
+                ++m_captureSkipped[i];
+                ++m_captureSkippedTotal;
+            }
+            m_captureHead[i] = (m_captureHead[i] + 1) % kCaptureSlots;
+            --m_captureCount[i];
+        }
+        pending = pending || m_captureCount[i] > 0;
+    }
+
+    if (m_captureActive) {
+        if (frame >= m_captureEndFrame && !pending) FinishCapture();
+        return;
+    }
+    // The previous file is still being written: start once it is closed
+    if (frame < m_captureFirstFrame || m_captureWriter.IsDraining()) return;
+    if (frame >= m_captureEndFrame) {
+        _MESSAGE("[CAPTURE] Frames %llu-%llu passed before the capture could start",
+                 (unsigned long long)m_captureFirstFrame, (unsigned long long)(m_captureEndFrame - 1));
+        m_captureFirstFrame = 0;
+        return;
+    }
+
+    const std::string directory = ResolveCaptureDirectory(m_captureDirectory);
+    SHCreateDirectoryExA(NULL, directory.c_str(), NULL);
+    char name[64];
+    snprintf(name, sizeof(name), "\\F4SEVR_DLSS_capture_%llu", (unsigned long long)frame);
+    const std::string path = directory + name + DLSSCapture::kExtension;
+    if (!m_captureWriter.Open(path)) {
+        _MESSAGE("[CAPTURE] Cannot create %s", path.c_str());
+        m_captureFirstFrame = 0;
+        return;
+    }
+    m_captureActive = true;
+    m_captureStart = StageStart();
+    m_captureSkipped[0] = m_captureSkipped[1] = 0;
+    m_captureSkippedTotal = 0;
+    _MESSAGE("[CAPTURE] Writing %s", path.c_str());
+}
+
+bool DLSSManager::ReadCaptureSlot(int eyeIndex) {
+    CaptureSlot& slot = m_captureSlots[eyeIndex][m_captureHead[eyeIndex]];
+    if (m_context->GetData(slot.fence, nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) return false;
+    DLSSCapture::Frame& f = slot.frame;
+    for (uint32_t s = 0; s < f.info.surfaceCount; ++s) {
+        const DLSSCapture::SurfaceInfo& info = f.surfaces[s];
+        ID3D11Texture2D* staging = slot.staging[info.surface];
+        D3D11_MAPPED_SUBRESOURCE mapped{};
+        if (!staging || FAILED(m_context->Map(staging, 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped))) return false;
+        std::vector<uint8_t>& pixels = f.pixels[s];
+        if (pixels.capacity() == 0) pixels = m_captureWriter.TakeBuffer();
+        pixels.resize(static_cast<size_t>(info.rowBytes) * info.height);
+        for (uint32_t y = 0; y < info.height; ++y) {
+            std::memcpy(pixels.data() + static_cast<size_t>(y) * info.rowBytes,
+                        static_cast<const uint8_t*>(mapped.pData) + static_cast<size_t>(y) * mapped.RowPitch, info.rowBytes);
+        }
+        m_context->Unmap(staging, 0);
+    }
+    f.info.droppedBefore = m_captureSkipped[eyeIndex];
+    m_captureSkipped[eyeIndex] = 0;
+    m_captureWriter.Push(std::move(f));
+    f = DLSSCapture::Frame{};
+    return true;
+}
+
+// After a successful evaluate: copies the eye's surfaces into its next free
+// slot. sources are indexed by DLSSCapture::Surface; only the output is
+// cropped (to the eye's atlas region).
+void DLSSManager::CaptureEye(int eyeIndex, DLSSCapture::FrameInfo info, ID3D11Texture2D* const sources[DLSSCapture::kMaxSurfaces],
+                             const DLSSAtlas::Rect& outputRegion) {
+    const uint64_t frame = DLSSVram::Global().Frame();
+    if (!m_captureActive || frame < m_captureFirstFrame || frame >= m_captureEndFrame) return;
+    if (m_captureCount[eyeIndex] >= kCaptureSlots) {
+        ++m_captureSkipped[eyeIndex];
+        ++m_captureSkippedTotal;
+        return;
+    }
+    CaptureSlot& slot = m_captureSlots[eyeIndex][(m_captureHead[eyeIndex] + m_captureCount[eyeIndex]) % kCaptureSlots];
+    if (!slot.fence) {
+        D3D11_QUERY_DESC qd = {};
+        qd.Query = D3D11_QUERY_EVENT;
+        if (FAILED(m_device->CreateQuery(&qd, &slot.fence))) {
+            ++m_captureSkipped[eyeIndex];
+            ++m_captureSkippedTotal;
+            return;
+        }
+    }
+
+    info.frame = frame;
+    info.timeMs = ElapsedMs(m_captureStart);
+    info.eye = static_cast<uint32_t>(eyeIndex);
+    info.quality = static_cast<uint32_t>(GetEyeQuality(eyeIndex));
+    info.resetReasons = info.reset ? GetEyeHistory(eyeIndex).LastResetReasons() : 0;
+    info.processMs = m_eyeStats[eyeIndex].processMs;
+    info.gpuMs = m_eyeTimers[eyeIndex].ms;
+    info.submitMs = m_eyeStats[eyeIndex].submitMs;
+    info.preset = static_cast<uint32_t>(m_dlssPreset);
+    info.downscaleFilter = static_cast<uint32_t>(m_downscaleFilter);
+    info.surfaceCount = 0;
+    info.droppedBefore = 0;
+
+    for (uint32_t s = 0; s < DLSSCapture::kMaxSurfaces; ++s) {
+        ID3D11Texture2D* source = sources[s];
+        if (!source) continue;
+        D3D11_TEXTURE2D_DESC sd{};
+        source->GetDesc(&sd);
+        if (sd.SampleDesc.Count != 1) continue;
+        const bool output = s == static_cast<uint32_t>(DLSSCapture::Surface::Output);
+        const uint32_t width = output ? outputRegion.width : sd.Width;
+        const uint32_t height = output ? outputRegion.height : sd.Height;
+        if (width == 0 || height == 0 || (output && (outputRegion.x + width > sd.Width || outputRegion.y + height > sd.Height))) continue;
+        const DXGI_FORMAT format = CaptureStagingFormat(sd.Format);
+        const uint32_t rowBytes = static_cast<uint32_t>(DLSSVram::SurfaceBytes(format, width, 1));
+        if (rowBytes == 0) continue;
+
+        ID3D11Texture2D*& staging = slot.staging[s];
+        if (staging) {
+            D3D11_TEXTURE2D_DESC cd{};
+            staging->GetDesc(&cd);
+            if (cd.Width != width || cd.Height != height || cd.Format != format) DLSSVram::ReleaseTexture(staging);
+        }
+        if (!staging) {
+            D3D11_TEXTURE2D_DESC desc = {};
+            desc.Width = width;
+            desc.Height = height;
+            desc.MipLevels = 1;
+            desc.ArraySize = 1;
+            desc.Format = format;
+            desc.SampleDesc.Count = 1;
+            desc.Usage = D3D11_USAGE_STAGING;
+            desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+            if (FAILED(m_device->CreateTexture2D(&desc, nullptr, &staging))) {
+                staging = nullptr;
+                continue;
+            }
+            DLSSVram::TrackTexture(staging, DLSSVram::Pool::Capture);
+        }
+        if (output) {
+            const D3D11_BOX box{outputRegion.x, outputRegion.y, 0, outputRegion.x + width, outputRegion.y + height, 1};
+            m_context->CopySubresourceRegion(staging, 0, 0, 0, 0, source, 0, &box);
+        } else {
+            // Whole subresource: depth-stencil copies cannot take a box
+            m_context->CopySubresourceRegion(staging, 0, 0, 0, 0, source, 0, nullptr);
+        }
+        DLSSCapture::SurfaceInfo& si = slot.frame.surfaces[info.surfaceCount++];
+        si.frame = frame;
+        si.eye = info.eye;
+        si.surface = s;
+        si.format = static_cast<uint32_t>(format);
+        si.width = width;
+        si.height = height;
+        si.rowBytes = rowBytes;
+    }
+    if (info.surfaceCount == 0) return;
+    m_context->End(slot.fence);
+    slot.frame.info = info;
+    slot.issueFrame = frame;
+    ++m_captureCount[eyeIndex];
+}
+
+void DLSSManager::FinishCapture() {
+    if (m_captureActive) {
+        const DLSSCapture::Stats stats = m_captureWriter.GetStats();
+        _MESSAGE("[CAPTURE] Closing %s: %llu eye frames, %llu dropped by the writer, %llu skipped",
+                 stats.path.c_str(), (unsigned long long)(stats.written + stats.queued),
+                 (unsigned long long)stats.dropped, (unsigned long long)m_captureSkippedTotal);
+        // The writer thread finishes the queue
+        m_captureWriter.Close();
+    }
+    m_captureActive = false;
+    m_captureFirstFrame = 0;
+    m_captureEndFrame = 0;
+    ReleaseCaptureSlots();
+}
+
+void DLSSManager::ReleaseCaptureSlots() {
+    for (int i = 0; i < 2; ++i) {
+        for (CaptureSlot& slot : m_captureSlots[i]) {
+            for (ID3D11Texture2D*& staging : slot.staging) DLSSVram::ReleaseTexture(staging);
+            ReleaseRef(slot.fence);
+            slot.frame = DLSSCapture::Frame{};
+            slot.issueFrame = 0;
+        }
+        m_captureHead[i] = 0;
+        m_captureCount[i] = 0;
+        m_captureSkipped[i] = 0;
+    }
+}
+
+void DLSSManager::ReleaseDepthHistogram(EyeContext& eye) {
+    if (eye.depthSRV) { eye.depthSRV->Release(); eye.depthSRV = nullptr; }
+    eye.depthSource = nullptr;
+    if (eye.depthBinsUAV) { eye.depthBinsUAV->Release(); eye.depthBinsUAV = nullptr; }
+    DLSSVram::ReleaseBuffer(eye.depthBins);
+    if (m_readback && eye.depthStream >= 0) m_readback->Reset(static_cast<uint32_t>(eye.depthStream));
+    eye.depthArrivedValid = false;
+}
+
+bool DLSSManager::RecordDepthHistogram(EyeContext& eye, ID3D11Texture2D* depthTexture) {
+    if (!m_depthHistogramCS) {
+        DLSSShaders::Bytecode cs;
+        if (!DLSSShaders::Get(DLSSShaders::Id::DepthHistogram, cs) ||
+            FAILED(m_device->CreateComputeShader(cs.data, cs.size, nullptr, &m_depthHistogramCS))) {
+            return false;
+        }
+    }
+    if (!m_depthHistogramCB) {
+        D3D11_BUFFER_DESC bd = {};
+        bd.ByteWidth = sizeof(DLSSHistory::DepthParams);
+        bd.Usage = D3D11_USAGE_DEFAULT;
+        bd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        if (FAILED(m_device->CreateBuffer(&bd, nullptr, &m_depthHistogramCB))) return false;
+        DLSSVram::TrackBuffer(m_depthHistogramCB, DLSSVram::Pool::Constants);
+    }
+    if (!eye.depthBins) {
+        D3D11_BUFFER_DESC bd = {};
+        bd.ByteWidth = DLSSHistory::kDepthBins * sizeof(uint32_t);
+        bd.Usage = D3D11_USAGE_DEFAULT;
+        bd.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+        bd.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+        if (FAILED(m_device->CreateBuffer(&bd, nullptr, &eye.depthBins))) return false;
+        DLSSVram::TrackBuffer(eye.depthBins, DLSSVram::Pool::History);
+        D3D11_UNORDERED_ACCESS_VIEW_DESC ud = {};
+        ud.Format = DXGI_FORMAT_R32_TYPELESS;
+        ud.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+        ud.Buffer.NumElements = DLSSHistory::kDepthBins;
+        ud.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_RAW;
+        if (FAILED(m_device->CreateUnorderedAccessView(eye.depthBins, &ud, &eye.depthBinsUAV))) {
+            ReleaseDepthHistogram(eye);
+            return false;
+        }
+    }
+
+    // Depth is read through a typed view of its typeless format; textures
+    // without SRV binding are remembered with a null view and skipped
+    D3D11_TEXTURE2D_DESC dd{};
+    depthTexture->GetDesc(&dd);
+    if (eye.depthSource != depthTexture) {
+        if (eye.depthSRV) { eye.depthSRV->Release(); eye.depthSRV = nullptr; }
+        eye.depthSource = depthTexture;
+        DXGI_FORMAT view = DXGI_FORMAT_UNKNOWN;
+        switch (dd.Format) {
+            case DXGI_FORMAT_R24G8_TYPELESS: view = DXGI_FORMAT_R24_UNORM_X8_TYPELESS; break;
+            case DXGI_FORMAT_R32_TYPELESS: case DXGI_FORMAT_R32_FLOAT: view = DXGI_FORMAT_R32_FLOAT; break;
+            case DXGI_FORMAT_R32G8X24_TYPELESS: view = DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS; break;
+            case DXGI_FORMAT_R16_TYPELESS: case DXGI_FORMAT_R16_UNORM: view = DXGI_FORMAT_R16_UNORM; break;
+            default: break;
+        }
+        if (view != DXGI_FORMAT_UNKNOWN && (dd.BindFlags & D3D11_BIND_SHADER_RESOURCE) && dd.SampleDesc.Count == 1) {
+            D3D11_SHADER_RESOURCE_VIEW_DESC sd{};
+            sd.Format = view;
+            sd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+            sd.Texture2D.MipLevels = 1;
+            if (FAILED(m_device->CreateShaderResourceView(depthTexture, &sd, &eye.depthSRV))) eye.depthSRV = nullptr;
+        }
+        if (!eye.depthSRV) {
+            _MESSAGE("[HIST] Depth format %u not readable; camera cuts rely on pose and events", (unsigned)dd.Format);
+        }
+    }
+    if (!eye.depthSRV) return false;
+
+    const int slot = BeginReadback(eye.depthStream);
+    if (slot < 0) return false;  // every copy still in flight (or no ring): skip this frame
+    const UINT zeros[4] = { 0, 0, 0, 0 };
+    m_context->ClearUnorderedAccessViewUint(eye.depthBinsUAV, zeros);
+    DLSSHistory::DepthParams params{};
+    params.size[0] = dd.Width;
+    params.size[1] = dd.Height;
+    params.inverted = 0;  // the game renders standard depth (SL constants say the same)
+    m_context->UpdateSubresource(m_depthHistogramCB, 0, nullptr, &params, 0, 0);
+    DispatchCompute(m_depthHistogramCS, eye.depthSRV, eye.depthBinsUAV, m_depthHistogramCB,
+                    DLSSHistory::kDepthGroups, DLSSHistory::kDepthGroups);
+    EndReadback(eye.depthStream, slot, eye.depthBins);
+    return true;
+}
+
+bool DLSSManager::UpdateHistory(EyeContext& eye, int eyeIndex, ID3D11Texture2D* depthTexture, bool forceReset) {
+    DLSSHistory::FrameInput in;
+    in.renderWidth = eye.renderWidth;
+    in.renderHeight = eye.renderHeight;
+    in.outputWidth = eye.outputWidth;
+    in.outputHeight = eye.outputHeight;
+    in.timeMs = GetTickCount64();
+    in.loading = DLSSHooks::IsGameLoading();
+    in.havePose = m_camera.GetHeadPose(eyeIndex, in.headToWorld);
+    // Newest histogram the readback ring delivered this frame (a few frames old)
+    if (eye.depthArrivedValid) {
+        in.depthBins = eye.depthArrived;
+        eye.depthArrivedValid = false;
+    }
+    // The zero stand-in says nothing about the scene
+    if (depthTexture && depthTexture != m_zeroDepthTexture) RecordDepthHistogram(eye, depthTexture);
+    if (forceReset) eye.history.Invalidate(DLSSHistory::Reason::Forced);
+
+    const DLSSHistory::Decision d = eye.history.Update(in);
+    // Loading resets every frame until the game is back; log the rest
+    if (d.reset && d.reasons != DLSSHistory::Reason::Loading) {
+        DLSSArena::InlineString<128> reasons;
+        for (uint32_t i = 0; i < DLSSHistory::kReasonCount; ++i) {
+            if (!(d.reasons & (1u << i))) continue;
+            if (!reasons.Empty()) reasons.Append(", ");
+            reasons.Append(DLSSHistory::ReasonName(i));
+        }
+        _MESSAGE("[HIST] Eye %d reset: %s (move %.3f, turn %.1f deg, depth %.2f)",
+                 eyeIndex, reasons.CStr(), d.translation, d.rotationDeg, d.depthDistance);
+    }
+    return d.reset;
+}
+
+void DLSSManager::GetEyeOutputSize(int eyeIndex, const D3D11_TEXTURE2D_DESC& inputDesc, uint32_t& width, uint32_t& height) const {
+    // Per-eye display size from VR Submit (preferred), fallback to simple atlas split
+    width = height = 0;
+    if (!DLSSHooks::GetPerEyeDisplaySize(eyeIndex, width, height)) {
+        if (inputDesc.Width >= inputDesc.Height) { // side-by-side fallback
+            width = inputDesc.Width / 2u;
+            height = inputDesc.Height;
+        } else { // top-bottom fallback
+            width = inputDesc.Width;
+            height = inputDesc.Height / 2u;
+        }
+    }
+    // Align and clamp output
+    width &= ~1u; height &= ~1u;
+    if (width == 0) width = 2; if (height == 0) height = 2;
+    if (width > 8192u) width = 8192u; if (height > 8192u) height = 8192u;
+}
+
 ID3D11Texture2D* DLSSManager::ProcessEye(EyeContext& eye,
                                          ID3D11Texture2D* inputTexture,
                                          ID3D11Texture2D* depthTexture,
@@ -1007,86 +2678,53 @@ ID3D11Texture2D* DLSSManager::ProcessEye(EyeContext& eye,
     if (!Initialize()) {
         return inputTexture;
     }
+    eye.useFrame = DLSSVram::Global().Frame();
+    if (m_deferredPassesEnabled && !m_passCache) {
+        EnsurePassCache();
+    }
+    if (EnsureReadback()) {
+        CollectReadback();
+    }
+    UpdateCapture();
 
     D3D11_TEXTURE2D_DESC inputDesc = {};
     inputTexture->GetDesc(&inputDesc);
 
-    // Determine per-eye display size from VR Submit (preferred), fallback to simple atlas split
     const bool isLeftEye = (&eye == &m_leftEye);
     uint32_t perEyeOutW = 0, perEyeOutH = 0;
-    if (!DLSSHooks::GetPerEyeDisplaySize(isLeftEye ? 0 : 1, perEyeOutW, perEyeOutH)) {
-        if (inputDesc.Width >= inputDesc.Height) { // side-by-side fallback
-            perEyeOutW = inputDesc.Width / 2u;
-            perEyeOutH = inputDesc.Height;
-        } else { // top-bottom fallback
-            perEyeOutW = inputDesc.Width;
-            perEyeOutH = inputDesc.Height / 2u;
-        }
-    }
-    // Align and clamp output
-    perEyeOutW &= ~1u; perEyeOutH &= ~1u;
-    if (perEyeOutW == 0) perEyeOutW = 2; if (perEyeOutH == 0) perEyeOutH = 2;
-    if (perEyeOutW > 8192u) perEyeOutW = 8192u; if (perEyeOutH > 8192u) perEyeOutH = 8192u;
+    GetEyeOutputSize(isLeftEye ? 0 : 1, inputDesc, perEyeOutW, perEyeOutH);
 
-    // Derive render size from output via SL OptimalSettings (preferred) or uniform scale fallback
+    // Derive render size from output for this eye's quality and render scale
+    const int eyeIndex = isLeftEye ? 0 : 1;
     uint32_t renderWidth = 0;
     uint32_t renderHeight = 0;
-#if USE_STREAMLINE
-    auto MapToSLMode = [&](Quality q)->sl::DLSSMode {
-        switch (q) {
-            case Quality::Performance: return sl::DLSSMode::eMaxPerformance;
-            case Quality::Balanced:   return sl::DLSSMode::eBalanced;
-            case Quality::Quality:    return sl::DLSSMode::eMaxQuality;
-            case Quality::UltraPerformance: return sl::DLSSMode::eUltraPerformance;
-            case Quality::UltraQuality:     return sl::DLSSMode::eUltraQuality;
-            case Quality::DLAA:             return sl::DLSSMode::eDLAA;
-            default:                        return sl::DLSSMode::eMaxQuality;
-        }
-    };
-    sl::DLSSOptions slOpts{};
-    slOpts.mode = MapToSLMode(m_quality);
-    slOpts.outputWidth = perEyeOutW;
-    slOpts.outputHeight = perEyeOutH;
-    _MESSAGE("[SL] OptimalSettings query: mode=%u out=%ux%u", (unsigned)slOpts.mode, perEyeOutW, perEyeOutH);
-    sl::DLSSOptimalSettings slSet{};
-    if (sl::Result::eOk == slDLSSGetOptimalSettings(slOpts, slSet)) {
-        renderWidth = slSet.optimalRenderWidth;
-        renderHeight = slSet.optimalRenderHeight;
-        _MESSAGE("[SL] OptimalSettings result: render=%ux%u", renderWidth, renderHeight);
-    }
-#endif
-    if (renderWidth == 0 || renderHeight == 0) {
-        // Fallback: uniform scale from output using our quality table
-        const float s = GetQualityInfo(m_quality).scale;
-        renderWidth  = static_cast<uint32_t>(static_cast<float>(perEyeOutW) * s);
-        renderHeight = static_cast<uint32_t>(static_cast<float>(perEyeOutH) * s);
-    }
-    // Even align and clamp
-    renderWidth &= ~1u; renderHeight &= ~1u;
-    if (renderWidth == 0) renderWidth = 2; if (renderHeight == 0) renderHeight = 2;
-    if (renderWidth > perEyeOutW)  renderWidth = perEyeOutW;
-    if (renderHeight > perEyeOutH) renderHeight = perEyeOutH;
+    ComputeRenderSizeForOutput(eyeIndex, perEyeOutW, perEyeOutH, renderWidth, renderHeight);
 
     // Streamline path (no NGX params required)
     if (m_backend && m_backend->IsReady()) {
 #if USE_STREAMLINE
         if (m_slBackend) {
-            m_slBackend->SetCurrentEyeIndex(isLeftEye ? 0 : 1);
+            m_slBackend->SetCurrentEyeIndex(eyeIndex);
             if (isLeftEye) {
                 m_slBackend->BeginFrame();
             }
         }
 #endif
-        _MESSAGE("[SL] ProcessEye: rw=%u rh=%u ow=%u oh=%u depth=%d mv=%d reset=%d",
+        m_backend->SetEyeQuality(eyeIndex, m_eyeQuality[eyeIndex]);
+        m_backend->SetPersistentTags(m_persistentTagsEnabled);
+        if (isLeftEye) {
+            m_lastOutputBinds = m_outputBinds;
+            m_outputBinds = 0;
+        }
+        _MESSAGE("[SL] ProcessEye: rw=%u rh=%u ow=%u oh=%u depth=%d mv=%d",
                  renderWidth, renderHeight, perEyeOutW, perEyeOutH,
-                 depthTexture?1:0, motionVectors?1:0, (eye.requiresReset||forceReset)?1:0);
+                 depthTexture?1:0, motionVectors?1:0);
         // If input already matches render size, skip downscale pass and use it directly
         bool useInputDirect = false;
         if (inputDesc.Width == renderWidth && inputDesc.Height == renderHeight) {
             useInputDirect = true;
             eye.renderWidth = renderWidth;
             eye.renderHeight = renderHeight;
-            eye.requiresReset = true; // first time with direct-path
         } else {
             // Downscale input color to render size
             if (!DownscaleToRender(eye, inputTexture, renderWidth, renderHeight)) {
@@ -1094,20 +2732,52 @@ ID3D11Texture2D* DLSSManager::ProcessEye(EyeContext& eye,
             }
         }
 
+        // Stereo atlas: the eye's region of the shared output, when the backend can target it
+        bool atlas = false;
+        DLSSAtlas::Rect region{0, 0, perEyeOutW, perEyeOutH};
+        if (m_stereoAtlasEnabled) {
+            uint32_t otherW = 0, otherH = 0;
+            GetEyeOutputSize(1 - eyeIndex, inputDesc, otherW, otherH);
+            const DLSSAtlas::Layout layout = isLeftEye ? DLSSAtlas::MakeLayout(perEyeOutW, perEyeOutH, otherW, otherH)
+                                                       : DLSSAtlas::MakeLayout(otherW, otherH, perEyeOutW, perEyeOutH);
+            atlas = EnsureStereoAtlas(inputDesc, layout) &&
+                    m_backend->SetOutputOrigin(eyeIndex, layout.eyes[eyeIndex].x, layout.eyes[eyeIndex].y);
+            if (atlas) {
+                region = layout.eyes[eyeIndex];
+                m_atlas.useFrame = eye.useFrame;
+            }
+        } else if (m_atlas.texture) {
+            ReleaseStereoAtlas();
+        }
+        if (!atlas) {
+            m_backend->SetOutputOrigin(eyeIndex, 0, 0);
+        }
+
         // Ensure output texture for the desired per-eye output dimensions
-        bool needOutput = (eye.outputTexture == nullptr) ||
-                          (eye.outputWidth != perEyeOutW) ||
-                          (eye.outputHeight != perEyeOutH);
+        bool needOutput = !atlas && ((eye.outputTexture == nullptr) ||
+                                     (eye.outputWidth != perEyeOutW) ||
+                                     (eye.outputHeight != perEyeOutH));
+        if (atlas) {
+            // The eye's own target is unused while it renders into the atlas
+            if (eye.outputTexture) {
+                ReleaseEyeSharpen(eye);
+                ReleaseProbeView(eye, kProbeOutput);
+                DLSSVram::ReleaseTexture(eye.outputTexture);
+            }
+            eye.outputWidth = perEyeOutW;
+            eye.outputHeight = perEyeOutH;
+        }
         if (needOutput) {
-            ReleaseTexture(eye.outputTexture);
-            if (!CreateOutputTexture(m_device, inputDesc, perEyeOutW, perEyeOutH, &eye.outputTexture)) {
+            ReleaseProbeView(eye, kProbeOutput);
+            DLSSVram::ReleaseTexture(eye.outputTexture);
+            if (!CreateOutputTexture(m_device, inputDesc, perEyeOutW, perEyeOutH, DLSSVram::Pool::EyeOutput, &eye.outputTexture)) {
                 return inputTexture;
             }
             eye.outputWidth = perEyeOutW;
             eye.outputHeight = perEyeOutH;
             eye.renderWidth = renderWidth;
             eye.renderHeight = renderHeight;
-            eye.requiresReset = true;
+            eye.history.Invalidate(DLSSHistory::Reason::ResourceRecreated);
         }
 
         // Provide motion vectors (fallback to zero-MV if missing)
@@ -1132,14 +2802,67 @@ ID3D11Texture2D* DLSSManager::ProcessEye(EyeContext& eye,
             }
         }
 
+        // Camera constants: poll OpenVR once per frame (left eye). The jitter reported here is
+        // the one the cbuffer hooks applied while this frame rendered; advance it afterwards
+        // so the next frame's projection patch picks up the new phase.
+        if (isLeftEye) {
+            DLSSCamera::RefreshFromOpenVR(m_camera);
+        }
+        const bool resetHistory = UpdateHistory(eye, eyeIndex, depthForDlss, forceReset);
+        m_backend->SetCameraConstants(eyeIndex, m_camera.Build(eyeIndex, renderWidth, renderHeight, resetHistory));
+        const DLSSCamera::JitterSample jitter = m_camera.CurrentJitter(eyeIndex);
+        m_camera.AdvanceJitter(eyeIndex, renderWidth, renderHeight, perEyeOutW, perEyeOutH);
+
+        // DLSS 4 ignores the sharpness option, so sharpening runs here: DLSS
+        // writes an intermediate and the CAS pass is the copy into the output
+        // (CAS cannot run in place, so this adds a full-size write and read)
+        const bool sharpen = m_sharpeningEnabled && m_sharpness > 0.0f && (atlas ? EnsureAtlasSharpen() : EnsureSharpenTarget(eye));
+        ID3D11Texture2D* outputTexture = atlas ? m_atlas.texture : eye.outputTexture;
+        ID3D11Texture2D* dlssTarget = sharpen ? (atlas ? m_atlas.upscaled : eye.upscaledTexture) : outputTexture;
+
         ID3D11Texture2D* colorForBackend = useInputDirect ? inputTexture : eye.renderColor;
-        ID3D11Texture2D* out = m_backend->ProcessEye(colorForBackend, depthForDlss, mv, eye.outputTexture,
+        ID3D11Texture2D* out = m_backend->ProcessEye(colorForBackend, depthForDlss, mv, dlssTarget,
                                                      renderWidth, renderHeight,
                                                      perEyeOutW, perEyeOutH,
-                                                     (eye.requiresReset || forceReset));
-        eye.requiresReset = false;
+                                                     resetHistory);
+        ++m_outputBinds;
+        EyeStats& stats = m_eyeStats[eyeIndex];
+        stats.copiedBytes = m_backend->LastCopyBytes(eyeIndex);
+        stats.submitMs = m_backend->LastSubmitMs(eyeIndex);
         // Treat success only when backend returns the designated output texture
-        ID3D11Texture2D* result = (out == eye.outputTexture) ? out : inputTexture;
+        ID3D11Texture2D* result = inputTexture;
+        if (out == dlssTarget) {
+            ++stats.evaluations;
+            if (resetHistory) ++stats.resets;
+            if (sharpen && atlas) {
+                if (!DispatchSharpen(eyeIndex, m_atlas.upscaledSRV, m_atlas.textureUAV, m_atlas.encoding, region)) {
+                    const D3D11_BOX box{region.x, region.y, 0, region.x + region.width, region.y + region.height, 1};
+                    m_context->CopySubresourceRegion(m_atlas.texture, 0, region.x, region.y, 0, m_atlas.upscaled, 0, &box);
+                }
+            } else if (sharpen && !SharpenToOutput(eye)) {
+                m_context->CopyResource(eye.outputTexture, eye.upscaledTexture);
+            }
+            RecordProbes(eye, outputTexture, region, mv);
+            if (m_captureActive) {
+                DLSSCapture::FrameInfo info;
+                info.reset = resetHistory ? 1 : 0;
+                info.jitterX = jitter.pixelX;
+                info.jitterY = jitter.pixelY;
+                info.renderWidth = renderWidth;
+                info.renderHeight = renderHeight;
+                info.outputWidth = perEyeOutW;
+                info.outputHeight = perEyeOutH;
+                info.sharpness = sharpen ? m_sharpness : 0.0f;
+                // The zero stand-ins carry nothing worth dumping
+                ID3D11Texture2D* const sources[DLSSCapture::kMaxSurfaces] = {
+                    colorForBackend, depthForDlss != m_zeroDepthTexture ? depthForDlss : nullptr,
+                    mv != m_zeroMotionVectors ? mv : nullptr, outputTexture };
+                CaptureEye(eyeIndex, info, sources, region);
+            }
+            result = outputTexture;
+        } else {
+            eye.history.Invalidate(DLSSHistory::Reason::EvaluateFailed);
+        }
 #if USE_STREAMLINE
         if (m_slBackend && !isLeftEye) {
             m_slBackend->EndFrame();
@@ -1154,14 +2877,16 @@ ID3D11Texture2D* DLSSManager::ProcessEye(EyeContext& eye,
         return inputTexture;
     }
 
+    const bool resetHistory = UpdateHistory(eye, eyeIndex, depthTexture, forceReset);
+
     m_ngxParameters->Reset();
     m_ngxParameters->Set(NVSDK_NGX_Parameter_Width, renderWidth);
     m_ngxParameters->Set(NVSDK_NGX_Parameter_Height, renderHeight);
     m_ngxParameters->Set(NVSDK_NGX_Parameter_OutWidth, inputDesc.Width);
     m_ngxParameters->Set(NVSDK_NGX_Parameter_OutHeight, inputDesc.Height);
-    m_ngxParameters->Set(NVSDK_NGX_Parameter_PerfQualityValue, static_cast<unsigned int>(MapQuality(m_quality)));
+    m_ngxParameters->Set(NVSDK_NGX_Parameter_PerfQualityValue, static_cast<unsigned int>(MapQuality(GetEyeQuality(eyeIndex))));
     m_ngxParameters->Set(NVSDK_NGX_Parameter_Sharpness, m_sharpeningEnabled ? m_sharpness : 0.0f);
-    m_ngxParameters->Set(NVSDK_NGX_Parameter_Reset, (eye.requiresReset || forceReset) ? 1 : 0);
+    m_ngxParameters->Set(NVSDK_NGX_Parameter_Reset, resetHistory ? 1 : 0);
 
     m_ngxParameters->Set(NVSDK_NGX_Parameter_Color, static_cast<ID3D11Resource*>(inputTexture));
     m_ngxParameters->Set(NVSDK_NGX_Parameter_Output, static_cast<ID3D11Resource*>(eye.outputTexture));
@@ -1187,31 +2912,148 @@ ID3D11Texture2D* DLSSManager::ProcessEye(EyeContext& eye,
     }
 
     _MESSAGE("[NGX] Evaluate: rw=%u rh=%u ow=%u oh=%u depth=%d mv=%d reset=%d",
-             renderWidth, renderHeight, inputDesc.Width, inputDesc.Height, depthTexture?1:0, motionVectors?1:0, (eye.requiresReset||forceReset)?1:0);
+             renderWidth, renderHeight, inputDesc.Width, inputDesc.Height, depthTexture?1:0, motionVectors?1:0, resetHistory?1:0);
     NVSDK_NGX_Result result = g_pfnNGXEvaluateFeature(m_context, eye.dlssHandle, m_ngxParameters, nullptr);
     if (!NVSDK_NGX_SUCCEED(result)) {
         _ERROR("NVSDK_NGX_D3D11_EvaluateFeature failed: 0x%08X", result);
-        eye.requiresReset = true;
+        eye.history.Invalidate(DLSSHistory::Reason::EvaluateFailed);
         return inputTexture;
     }
 
-    eye.requiresReset = false;
+    EyeStats& stats = m_eyeStats[eyeIndex];
+    ++stats.evaluations;
+    if (resetHistory) ++stats.resets;
+    RecordProbes(eye, eye.outputTexture, DLSSAtlas::Rect{}, motionVectors);
+    if (m_captureActive) {
+        DLSSCapture::FrameInfo info;
+        info.reset = resetHistory ? 1 : 0;
+        info.renderWidth = renderWidth;
+        info.renderHeight = renderHeight;
+        info.outputWidth = inputDesc.Width;
+        info.outputHeight = inputDesc.Height;
+        info.sharpness = m_sharpeningEnabled ? m_sharpness : 0.0f;
+        ID3D11Texture2D* const sources[DLSSCapture::kMaxSurfaces] = { inputTexture, depthTexture, motionVectors, eye.outputTexture };
+        CaptureEye(eyeIndex, info, sources, DLSSAtlas::Rect{0, 0, inputDesc.Width, inputDesc.Height});
+    }
     return eye.outputTexture ? eye.outputTexture : inputTexture;
 }
 
 ID3D11Texture2D* DLSSManager::ProcessLeftEye(ID3D11Texture2D* inputTexture,
     ID3D11Texture2D* depthTexture,
     ID3D11Texture2D* motionVectors) {
-    return ProcessEye(m_leftEye, inputTexture, depthTexture, motionVectors, false);
+    const LARGE_INTEGER t = StageStart();
+    const int timer = m_enabled ? BeginGpuTimer(m_eyeTimers[0]) : -1;
+    ID3D11Texture2D* result = ProcessEye(m_leftEye, inputTexture, depthTexture, motionVectors, false);
+    EndGpuTimer(m_eyeTimers[0], timer);
+    RecordProcessTime(m_eyeStats[0], ElapsedMs(t));
+    return result;
 }
 
 ID3D11Texture2D* DLSSManager::ProcessRightEye(ID3D11Texture2D* inputTexture,
     ID3D11Texture2D* depthTexture,
     ID3D11Texture2D* motionVectors) {
-    return ProcessEye(m_rightEye, inputTexture, depthTexture, motionVectors, false);
+    const LARGE_INTEGER t = StageStart();
+    const int timer = m_enabled ? BeginGpuTimer(m_eyeTimers[1]) : -1;
+    ID3D11Texture2D* result = ProcessEye(m_rightEye, inputTexture, depthTexture, motionVectors, false);
+    EndGpuTimer(m_eyeTimers[1], timer);
+    RecordProcessTime(m_eyeStats[1], ElapsedMs(t));
+    return result;
+}
+
+void DLSSManager::RecordProcessTime(EyeStats& stats, double ms) {
+    stats.processMs = stats.processMs > 0.0f ? stats.processMs * 0.9f + static_cast<float>(ms) * 0.1f
+                                             : static_cast<float>(ms);
+}
+
+void DLSSManager::FillTelemetry(DLSSTelemetry::Payload& out) const {
+    out.backend = static_cast<uint32_t>(
+        (m_backend && m_backend->IsReady()) ? DLSSTelemetry::Backend::Streamline
+        : m_initialized ? DLSSTelemetry::Backend::NGX : DLSSTelemetry::Backend::None);
+    out.quality = static_cast<uint32_t>(m_quality);
+    out.enabled = m_enabled ? 1u : 0u;
+    const EyeContext* eyes[2] = { &m_leftEye, &m_rightEye };
+    for (int i = 0; i < 2; ++i) {
+        DLSSTelemetry::EyePayload& e = out.eyes[i];
+        e.renderWidth = eyes[i]->renderWidth;
+        e.renderHeight = eyes[i]->renderHeight;
+        e.outputWidth = eyes[i]->outputWidth;
+        e.outputHeight = eyes[i]->outputHeight;
+        e.evaluations = m_eyeStats[i].evaluations;
+        e.resets = m_eyeStats[i].resets;
+        e.processMs = m_eyeStats[i].processMs;
+        e.copiedKB = static_cast<uint32_t>(m_eyeStats[i].copiedBytes / 1024);
+        e.submitMs = m_eyeStats[i].submitMs;
+        e.resetReasons = eyes[i]->history.LastResetReasons();
+        e.gpuMs = m_eyeTimers[i].ms;
+        e.quality = static_cast<uint32_t>(GetEyeQuality(i));
+    }
+    out.initLoadMs = static_cast<float>(m_initTimings.loadMs);
+    out.initResolveMs = static_cast<float>(m_initTimings.resolveMs);
+    out.initShadersMs = static_cast<float>(m_initTimings.shadersMs);
+    out.initDeviceMs = static_cast<float>(m_initTimings.deviceMs);
+    out.downscaleGpuMs = m_downscaleTimer.ms;
+    out.textureCreates = g_textureCreates;
+}
+
+void DLSSManager::ReleaseEyeFeature(EyeContext& eye) {
+    if (eye.dlssHandle) {
+        g_pfnNGXReleaseFeature(eye.dlssHandle);
+        eye.dlssHandle = nullptr;
+    }
+    ReleaseEyeSharpen(eye);
+    ReleaseEyeRender(eye);
+    DLSSVram::ReleaseTexture(eye.outputTexture);
+    ReleaseDepthHistogram(eye);
+    ReleaseEyeProbes(eye);
+    eye.renderWidth = eye.renderHeight = 0;
+    eye.outputWidth = eye.outputHeight = 0;
+    eye.history.Invalidate(DLSSHistory::Reason::ResourceRecreated);
+}
+
+void DLSSManager::TrimVram(void* self, uint64_t frame) {
+    static_cast<DLSSManager*>(self)->TrimIdleResources(frame);
+}
+
+void DLSSManager::TrimIdleResources(uint64_t frame) {
+    const uint64_t idleBefore = frame > DLSSVram::kIdleFrames ? frame - DLSSVram::kIdleFrames : 0;
+    if (m_zeroMotionVectors && m_zeroMVUseFrame < idleBefore) ReleaseZeroMotionVectors();
+    if (m_zeroDepthTexture && m_zeroDepthUseFrame < idleBefore) ReleaseZeroDepthTexture();
+    if (!m_sharpeningEnabled) {
+        ReleaseEyeSharpen(m_leftEye);
+        ReleaseEyeSharpen(m_rightEye);
+        ReleaseAtlasSharpen();
+    }
+    if (m_atlas.texture && m_atlas.useFrame < idleBefore) ReleaseStereoAtlas();
+    // Upscaler off (or the eye no longer submitted): the features and their
+    // targets are recreated on the next ProcessEye
+    bool releasedFeature = false;
+    for (EyeContext* eye : { &m_leftEye, &m_rightEye }) {
+        if (eye->useFrame < idleBefore && (eye->dlssHandle || eye->outputTexture || eye->renderColor)) {
+            ReleaseEyeFeature(*eye);
+            releasedFeature = true;
+        }
+    }
+    if (releasedFeature && !m_leftEye.dlssHandle && !m_rightEye.dlssHandle) {
+        ReleaseScratchBuffer();
+    }
+    if (m_backend) {
+        m_backend->ReleaseIdleResources(idleBefore);
+    }
 }
 
 void DLSSManager::Shutdown() {
+    JoinInitThread();
+    ReleasePassCache();
+    DLSSVram::Global().RemoveTrimmer(&DLSSManager::TrimVram, this);
+    m_initStage.store(InitStage::Idle, std::memory_order_release);
+    m_initFailures = 0;
+    m_initFailedFrame = 0;
+    m_slPrepareFailed = false;
+    if (m_preparedBackend) {
+        m_preparedBackend->Shutdown();
+        delete m_preparedBackend;
+        m_preparedBackend = nullptr;
+    }
     if (m_backend) {
         m_backend->Shutdown();
         delete m_backend;
@@ -1224,19 +3066,51 @@ void DLSSManager::Shutdown() {
         g_pfnNGXReleaseFeature(m_leftEye.dlssHandle);
         m_leftEye.dlssHandle = nullptr;
     }
-    ReleaseTexture(m_leftEye.outputTexture);
+    ReleaseEyeSharpen(m_leftEye);
+    DLSSVram::ReleaseTexture(m_leftEye.outputTexture);
+    ReleaseDepthHistogram(m_leftEye);
+    ReleaseReadback();
+    m_readbackUnavailable = false;
+    FinishCapture();
     m_leftEye = {};
 
     if (m_rightEye.dlssHandle) {
         g_pfnNGXReleaseFeature(m_rightEye.dlssHandle);
         m_rightEye.dlssHandle = nullptr;
     }
-    ReleaseTexture(m_rightEye.outputTexture);
+    ReleaseEyeSharpen(m_rightEye);
+    DLSSVram::ReleaseTexture(m_rightEye.outputTexture);
+    ReleaseDepthHistogram(m_rightEye);
     m_rightEye = {};
+    ReleaseStereoAtlas();
 
     ReleaseScratchBuffer();
     ReleaseZeroMotionVectors();
     ReleaseZeroDepthTexture();
+    for (ID3D11PixelShader*& ps : m_downscalePS) {
+        if (ps) { ps->Release(); ps = nullptr; }
+    }
+    for (ID3D11ComputeShader*& cs : m_downscaleCS) {
+        if (cs) { cs->Release(); cs = nullptr; }
+    }
+    ReleaseGpuTimer(m_downscaleTimer);
+    for (GpuTimer& t : m_eyeTimers) ReleaseGpuTimer(t);
+    DLSSVram::ReleaseBuffer(m_downscaleCB);
+    if (m_blitRS) { m_blitRS->Release(); m_blitRS = nullptr; }
+    if (m_depthCompositePS) { m_depthCompositePS->Release(); m_depthCompositePS = nullptr; }
+    if (m_stencilCompositePS) { m_stencilCompositePS->Release(); m_stencilCompositePS = nullptr; }
+    DLSSVram::ReleaseBuffer(m_compositeCB);
+    if (m_depthCompositeDS) { m_depthCompositeDS->Release(); m_depthCompositeDS = nullptr; }
+    for (ID3D11DepthStencilState*& ds : m_stencilCompositeDS) {
+        if (ds) { ds->Release(); ds = nullptr; }
+    }
+    for (ID3D11ComputeShader*& cs : m_sharpenCS) {
+        if (cs) { cs->Release(); cs = nullptr; }
+    }
+    DLSSVram::ReleaseBuffer(m_sharpenCB);
+    m_sharpenViewFailed.reset();
+    if (m_depthHistogramCS) { m_depthHistogramCS->Release(); m_depthHistogramCS = nullptr; }
+    DLSSVram::ReleaseBuffer(m_depthHistogramCB);
 
     if (m_ngxParameters) {
         g_pfnNGXDestroyParameters(m_ngxParameters);
@@ -1250,6 +3124,7 @@ void DLSSManager::Shutdown() {
     if (g_ngxModule) {
         FreeLibrary(g_ngxModule);
         g_ngxModule = nullptr;
+        g_ngxResolved = false;
     }
 
     if (m_context) {
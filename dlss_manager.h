@@ -2,6 +2,22 @@
 #include <d3d11.h>
 #include <windows.h>
 #include <cstdint>
+#include <atomic>
+#include <bitset>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "dlss_atlas.h"
+#include "dlss_camera.h"
+#include "dlss_capture.h"
+#include "dlss_cmdlist.h"
+#include "dlss_downscale.h"
+#include "dlss_history.h"
+#include "dlss_init.h"
+#include "dlss_readback.h"
+#include "dlss_sharpen.h"
+#include "dlss_telemetry.h"
 
 // Forward declarations
 struct ID3D11Device;
@@ -27,6 +43,19 @@ public:
     
     bool Initialize();
     void Shutdown();
+
+    // Staged runtime bring-up. BeginAsyncInitialize starts a worker for the
+    // device-independent part (runtime DLL load, entry-point resolution,
+    // capability probing, shader compilation); PollInitialize runs the
+    // device-bound remainder on the calling (render) thread once the worker
+    // is done. Both return immediately. A failed bring-up is retried:
+    // BeginAsyncInitialize moves Failed back to Idle once InitRetryDelay
+    // frames have passed.
+    enum class InitStage : uint8_t { Idle = 0, Preparing, Prepared, Ready, Failed };
+    static constexpr uint64_t InitRetryDelay(uint32_t failures) { return DLSSInit::RetryDelay(failures); }
+    bool BeginAsyncInitialize();
+    bool PollInitialize();
+    InitStage GetInitStage() const { return m_initStage.load(std::memory_order_acquire); }
     
     // VR specific - process each eye separately
     ID3D11Texture2D* ProcessLeftEye(ID3D11Texture2D* inputTexture, ID3D11Texture2D* depthTexture, ID3D11Texture2D* motionVectors);
@@ -44,6 +73,15 @@ public:
     
     void SetQuality(Quality quality);
     Quality GetQuality() const { return m_quality; }
+
+    // Per-eye overrides for asymmetric rendering. Quality -1 follows
+    // SetQuality; render scale 0 uses the quality's scale, otherwise it is
+    // the per-axis fraction of the eye's output (0.33 - 1.0).
+    void SetEyeQuality(int eyeIndex, int quality);
+    void SetEyeRenderScale(int eyeIndex, float scale);
+    int GetEyeQualityOverride(int eyeIndex) const { return (eyeIndex == 0 || eyeIndex == 1) ? m_eyeQuality[eyeIndex] : -1; }
+    float GetEyeRenderScale(int eyeIndex) const { return (eyeIndex == 0 || eyeIndex == 1) ? m_eyeRenderScale[eyeIndex] : 0.0f; }
+    Quality GetEyeQuality(int eyeIndex) const;
     
     void SetSharpness(float sharpness);
     float GetSharpness() const { return m_sharpness; }
@@ -62,6 +100,66 @@ public:
     void SetUpscaleDepthForReShade(bool value);
     void SetUseTAAPeriphery(bool value);
     void SetDLSSPreset(int preset);
+    // Filter used to bring the eye color down to render size
+    void SetDownscaleFilter(DLSSDownscale::Filter filter) { m_downscaleFilter = filter; }
+    DLSSDownscale::Filter GetDownscaleFilter() const { return m_downscaleFilter; }
+    // Tiled compute-shader downscale instead of the fullscreen-triangle pass (A/B)
+    void SetDownscaleCompute(bool enabled) { m_downscaleCompute = enabled; }
+    bool GetDownscaleCompute() const { return m_downscaleCompute; }
+    // Smoothed GPU time of one eye's downscale and whether it ran on the compute path
+    float GetDownscaleGpuMs() const { return m_downscaleTimer.ms; }
+    bool IsLastDownscaleCompute() const { return m_lastDownscaleCompute; }
+    // Bytes the backend copied into scratch textures for the eye's last evaluate
+    uint64_t GetEyeCopyBytes(int eyeIndex) const { return (eyeIndex == 0 || eyeIndex == 1) ? m_eyeStats[eyeIndex].copiedBytes : 0; }
+    // Smoothed GPU time of the eye's whole ProcessEye (downscale, DLSS, sharpening)
+    float GetEyeGpuMs(int eyeIndex) const { return (eyeIndex == 0 || eyeIndex == 1) ? m_eyeTimers[eyeIndex].ms : 0.0f; }
+    // Smoothed CPU time of the backend's submission for the eye
+    float GetEyeSubmitMs(int eyeIndex) const { return (eyeIndex == 0 || eyeIndex == 1) ? m_eyeStats[eyeIndex].submitMs : 0.0f; }
+    // History resets of the eye by reason
+    const DLSSHistory::Tracker& GetEyeHistory(int eyeIndex) const { return eyeIndex == 1 ? m_rightEye.history : m_leftEye.history; }
+    // Stereo atlas output: both eyes upscaled into one side-by-side texture,
+    // submitted per eye with bounds (Streamline path; NGX keeps per-eye outputs)
+    void SetStereoAtlas(bool enabled);
+    bool GetStereoAtlas() const { return m_stereoAtlasEnabled; }
+    // True when texture is the stereo atlas; layout gives each eye's region
+    bool GetAtlasLayout(ID3D11Texture2D* texture, DLSSAtlas::Layout& layout) const;
+    // Output textures, views, VRAM and per-frame binds of the current mode
+    DLSSAtlas::OutputStats GetOutputStats() const;
+    // Per-eye downscale and sharpening recorded into command lists on a
+    // worker thread (deferred context) and replayed on the immediate
+    // context; a pass is encoded directly until its list is ready
+    void SetDeferredPasses(bool enabled);
+    bool GetDeferredPasses() const { return m_deferredPassesEnabled; }
+    // Streamline resource tags kept across frames (default) or rebuilt every
+    // frame; compare GetEyeSubmitMs between the two
+    void SetPersistentTags(bool enabled);
+    bool GetPersistentTags() const { return m_persistentTagsEnabled; }
+    DLSSCmdList::Stats GetDeferredPassStats() const;
+    // GPU readback probes: min/max/mean and NaN/Inf count of each eye's
+    // output and motion vectors, reduced on the GPU and read back a few
+    // frames late through the readback ring (which also carries the depth
+    // histogram)
+    void SetReadbackProbes(bool enabled);
+    bool GetReadbackProbes() const { return m_readbackProbesEnabled; }
+    // The eye's last probe result; false until one has arrived
+    bool GetEyeProbe(int eyeIndex, bool motion, DLSSReadback::ProbeStats& out) const;
+    uint32_t GetReadbackStreamCount() const { return m_readback ? m_readback->StreamCount() : 0; }
+    const char* GetReadbackStreamName(uint32_t stream) const { return m_readback ? m_readback->Name(stream) : "?"; }
+    DLSSReadback::StreamStats GetReadbackStats(uint32_t stream) const;
+    // Frame capture: each eye's color, depth and motion vectors at render
+    // size and its output, copied into staging textures and streamed by a
+    // writer thread to a .dlsscap file (DLSSCapture) in the capture
+    // directory. A frame count of 0 captures until StopCapture.
+    void SetCaptureDirectory(const std::string& directory) { m_captureDirectory = directory; }
+    void SetCaptureQueueBytes(uint64_t bytes) { m_captureWriter.SetLimits(kCaptureQueueFrames, bytes); }
+    void ScheduleCapture(uint64_t firstFrame, uint32_t frameCount);
+    void StartCapture(uint32_t frameCount);
+    void StopCapture();
+    // Scheduled, running, or still collecting its last copies
+    bool IsCapturing() const { return m_captureFirstFrame != 0; }
+    DLSSCapture::Stats GetCaptureStats() const { return m_captureWriter.GetStats(); }
+    // Eye frames not captured since the file was opened: no free staging slot, or a copy went stale
+    uint64_t GetCaptureSkipped() const { return m_captureSkippedTotal; }
     void SetFOV(float value);
     void SetFixedFoveatedRendering(bool enabled);
     void SetFixedFoveatedUpscaling(bool enabled);
@@ -72,13 +170,34 @@ public:
     void SetFoveatedWiden(float widen);
 
     // Compute the DLSS render size for a given per-eye output size according to
-    // current quality/mode. Uses Streamline OptimalSettings when available; falls
-    // back to the static quality scale table otherwise. Returns true on success.
+    // the eye's quality/mode and render scale. Uses Streamline OptimalSettings
+    // when available; falls back to the static quality scale table otherwise.
+    // Returns true on success.
+    bool ComputeRenderSizeForOutput(int eyeIndex, uint32_t outW, uint32_t outH, uint32_t& renderW, uint32_t& renderH);
+    // Same for targets shared by both eyes: the larger of the two eyes' sizes
     bool ComputeRenderSizeForOutput(uint32_t outW, uint32_t outH, uint32_t& renderW, uint32_t& renderH);
+    // Both are cached per eye for the last output sizes seen (the hooks ask
+    // on every viewport bind); SetQuality, SetEyeQuality and
+    // SetEyeRenderScale clear the cache
 
     // Utility: blit a source texture into a destination RTV at given size using
     // the internal fullscreen VS/PS (linear sampling). Saves/restores minimal state.
-    bool BlitToRTV(ID3D11Texture2D* src, ID3D11RenderTargetView* dstRTV, uint32_t dstW, uint32_t dstH);
+    // srvFormat reads a typeless src through that format (0 = the texture's own).
+    bool BlitToRTV(ID3D11Texture2D* src, ID3D11RenderTargetView* dstRTV, uint32_t dstW, uint32_t dstH,
+                   uint32_t srvFormat = 0);
+    // Same for a depth src (typeless, DLSSRedirect::GetDepthTwinFormats):
+    // nearest depth, then stencil one bit per draw. Saves/restores the OM,
+    // RS and PS state it touches.
+    bool BlitDepthToDSV(ID3D11Texture2D* src, ID3D11DepthStencilView* dstDSV, uint32_t dstW, uint32_t dstH);
+
+    // Camera constants (projection, pose, jitter) handed to the backend per eye.
+    void SetJitterEnabled(bool enabled) { m_camera.SetJitterEnabled(enabled); }
+    void SetCameraClipPlanes(float nearZ, float farZ) { m_camera.SetClipPlanes(nearZ, farZ); }
+    DLSSCamera::CameraConstantsProvider& GetCameraProvider() { return m_camera; }
+
+    // Manager-owned fields of the shared-memory telemetry block (sizes,
+    // backend, counters, init and downscale timings)
+    void FillTelemetry(DLSSTelemetry::Payload& out) const;
 
 private:
     // Per-eye DLSS contexts for VR
@@ -88,19 +207,83 @@ private:
         // Render-size color (downscaled from eye input) used as DLSS input
         ID3D11Texture2D* renderColor = nullptr;
         ID3D11RenderTargetView* renderColorRTV = nullptr;
+        ID3D11UnorderedAccessView* renderColorUAV = nullptr;  // only when the format allows typed UAV stores
+        // Post-upscale sharpening: DLSS writes upscaledTexture and the CAS pass
+        // copies it into outputTexture (the submitted texture). CAS reads
+        // neighbours, so the intermediate is needed: one extra full-size
+        // write and read per eye while sharpening is on.
+        ID3D11Texture2D* upscaledTexture = nullptr;
+        ID3D11ShaderResourceView* upscaledSRV = nullptr;
+        ID3D11UnorderedAccessView* outputUAV = nullptr;
+        DLSSDownscale::Encoding outputEncoding = DLSSDownscale::Encoding::Linear;
         uint32_t renderWidth = 0;
         uint32_t renderHeight = 0;
         uint32_t outputWidth = 0;
         uint32_t outputHeight = 0;
-        bool requiresReset = true;
+        uint64_t useFrame = 0;  // DLSSVram frame of the last ProcessEye while enabled
+        // History validity, plus the depth histogram feeding its camera-cut check
+        DLSSHistory::Tracker history;
+        ID3D11Buffer* depthBins = nullptr;  // DLSSHistory::kDepthBins uints, rebuilt each frame
+        ID3D11UnorderedAccessView* depthBinsUAV = nullptr;
+        int depthStream = -1;  // DLSSReadback stream of the histogram copies
+        uint32_t depthArrived[DLSSHistory::kDepthBins] = {};  // newest histogram read back, until UpdateHistory takes it
+        bool depthArrivedValid = false;
+        ID3D11Texture2D* depthSource = nullptr;  // texture depthSRV views; set with a null view when unreadable
+        ID3D11ShaderResourceView* depthSRV = nullptr;
+        // Readback probes, indexed by kProbeOutput / kProbeMotion
+        int probeStreams[2] = { -1, -1 };
+        DLSSReadback::ProbeStats probes[2];
+        uint64_t probeFrames[2] = {};  // frame the result was recorded in, 0 = none yet
+        ID3D11Texture2D* probeSources[2] = {};  // textures probeSRVs view; set with a null view when unreadable
+        ID3D11ShaderResourceView* probeSRVs[2] = {};
+        bool outputNonFinite = false;  // last output probe saw NaN/Inf (logged on the change)
     };
+    static constexpr int kProbeOutput = 0;
+    static constexpr int kProbeMotion = 1;
     
+    // Per-stage durations of the last bring-up, in milliseconds
+    struct InitTimings {
+        double loadMs = 0.0;      // runtime load: slInit + SL adapter probe, or nvngx_dlss.dll
+        double resolveMs = 0.0;   // NGX entry-point resolution
+        double shadersMs = 0.0;   // shader bytecode (embedded, cache or compile)
+        double deviceMs = 0.0;    // device-bound steps on the render thread
+    };
+
+    // Per-eye counters since load; Shutdown does not clear them
+    struct EyeStats {
+        uint64_t evaluations = 0;
+        uint64_t resets = 0;
+        float processMs = 0.0f;  // ProcessLeft/RightEye CPU time, smoothed
+        uint64_t copiedBytes = 0;  // backend scratch copies of the last evaluate
+        float submitMs = 0.0f;     // backend submission CPU time, smoothed
+    };
+
+    // Timestamp queries around a GPU stage, read back a few calls later without stalling
+    struct GpuTimerSlot {
+        ID3D11Query* disjoint = nullptr;
+        ID3D11Query* begin = nullptr;
+        ID3D11Query* end = nullptr;
+        bool pending = false;
+    };
+    static constexpr uint32_t kGpuTimerSlots = 4;
+    struct GpuTimer {
+        GpuTimerSlot slots[kGpuTimerSlots];
+        uint32_t next = 0;
+        float ms = 0.0f;  // smoothed
+    };
+
+    static void RecordProcessTime(EyeStats& stats, double ms);
     bool InitializeDevice();
     bool InitializeNGX();
+    void PrepareRuntime();
+    void JoinInitThread();
     bool CreateDLSSFeatures();
     void GetOptimalSettings(uint32_t& renderWidth, uint32_t& renderHeight);
+    void ComputeRenderSizeUncached(int eyeIndex, uint32_t outW, uint32_t outH, uint32_t& renderW, uint32_t& renderH);
+    void InvalidateRenderSizes();
     bool EnsureEyeFeature(EyeContext& eye, ID3D11Texture2D* inputTexture, uint32_t renderWidth, uint32_t renderHeight, uint32_t outputWidth, uint32_t outputHeight);
     ID3D11Texture2D* ProcessEye(EyeContext& eye, ID3D11Texture2D* inputTexture, ID3D11Texture2D* depthTexture, ID3D11Texture2D* motionVectors, bool forceReset);
+    void GetEyeOutputSize(int eyeIndex, const D3D11_TEXTURE2D_DESC& inputDesc, uint32_t& width, uint32_t& height) const;
     bool CreateScratchBuffer(size_t scratchSize);
     void ReleaseScratchBuffer();
     void ReleaseZeroMotionVectors();
@@ -109,10 +292,68 @@ private:
     void ReleaseZeroDepthTexture();
     void ReleaseEyeRender(EyeContext& eye);
     bool EnsureDownscaleShaders();
+    bool EnsureCompositeShaders();
+    ID3D11PixelShader* GetDownscaleShader(DLSSDownscale::Filter filter, DLSSDownscale::Encoding encoding, DLSSDownscale::Layout layout);
+    bool DrawFullscreen(ID3D11ShaderResourceView* srv, ID3D11RenderTargetView* rtv, ID3D11PixelShader* ps,
+                        const DLSSDownscale::Params& params, uint32_t dstW, uint32_t dstH);
+    ID3D11ComputeShader* GetDownscaleComputeShader(DLSSDownscale::Filter filter, DLSSDownscale::Encoding encoding);
+    bool DispatchCompute(ID3D11ComputeShader* cs, ID3D11ShaderResourceView* srv, ID3D11UnorderedAccessView* uav,
+                         ID3D11Buffer* cb, uint32_t groupsX, uint32_t groupsY);
+    int BeginGpuTimer(GpuTimer& timer);
+    void EndGpuTimer(GpuTimer& timer, int slot);
+    void CollectGpuTimer(GpuTimer& timer);
+    void ReleaseGpuTimer(GpuTimer& timer);
     bool DownscaleToRender(EyeContext& eye, ID3D11Texture2D* inputTexture, uint32_t renderWidth, uint32_t renderHeight);
+    ID3D11ComputeShader* GetSharpenShader(DLSSDownscale::Encoding encoding);
+    bool EnsureSharpenTarget(EyeContext& eye);
+    // Sharpening of one output target: a same-size copy the upscaler writes
+    // (upscaled, read through srv) and target's UAV. Shared by the per-eye
+    // and atlas paths; creates m_sharpenCB on first use.
+    bool CreateSharpenViews(ID3D11Texture2D* target, ID3D11Texture2D*& upscaled, ID3D11ShaderResourceView*& srv,
+                            ID3D11UnorderedAccessView*& uav, DLSSDownscale::Encoding& encoding);
+    bool SharpenToOutput(EyeContext& eye);
+    bool DispatchSharpen(int eyeIndex, ID3D11ShaderResourceView* srv, ID3D11UnorderedAccessView* uav,
+                         DLSSDownscale::Encoding encoding, const DLSSAtlas::Rect& region);
+    bool EnsureStereoAtlas(const D3D11_TEXTURE2D_DESC& inputDesc, const DLSSAtlas::Layout& layout);
+    bool EnsureAtlasSharpen();
+    void ReleaseAtlasSharpen();
+    void ReleaseStereoAtlas();
+    void ReleaseEyeSharpen(EyeContext& eye);
+    bool EnsurePassCache();
+    void ReleasePassCache();
+    void InvalidatePass(DLSSCmdList::Pass pass);
+    void ReleaseEyeFeature(EyeContext& eye);
+    bool UpdateHistory(EyeContext& eye, int eyeIndex, ID3D11Texture2D* depthTexture, bool forceReset);
+    bool RecordDepthHistogram(EyeContext& eye, ID3D11Texture2D* depthTexture);
+    void ReleaseDepthHistogram(EyeContext& eye);
+    bool EnsureReadback();
+    void ReleaseReadback();
+    void CollectReadback();
+    int BeginReadback(int stream);
+    void EndReadback(int stream, int slot, ID3D11Buffer* source);
+    static void OnReadback(void* self, const DLSSReadback::Result& result);
+    void HandleReadback(const DLSSReadback::Result& result);
+    void RecordProbes(EyeContext& eye, ID3D11Texture2D* output, const DLSSAtlas::Rect& region, ID3D11Texture2D* motionVectors);
+    bool RecordProbe(EyeContext& eye, int probe, ID3D11Texture2D* source, const DLSSAtlas::Rect& region, DLSSReadback::Channel channel);
+    void ReleaseProbeView(EyeContext& eye, int probe);
+    void ReleaseEyeProbes(EyeContext& eye);
+    void UpdateCapture();
+    void CaptureEye(int eyeIndex, DLSSCapture::FrameInfo info, ID3D11Texture2D* const sources[DLSSCapture::kMaxSurfaces],
+                    const DLSSAtlas::Rect& outputRegion);
+    bool ReadCaptureSlot(int eyeIndex);
+    void FinishCapture();
+    void ReleaseCaptureSlots();
+
+    // DLSSVram trimmer: drops zero inputs and eye features that have been
+    // idle for DLSSVram::kIdleFrames, and sharpening targets while sharpening
+    // is off
+    static void TrimVram(void* self, uint64_t frame);
+    void TrimIdleResources(uint64_t frame);
 
     EyeContext m_leftEye;
     EyeContext m_rightEye;
+    EyeStats m_eyeStats[2];
+    DLSSCamera::CameraConstantsProvider m_camera;
     
     // D3D11 resources
     ID3D11Device* m_device = nullptr;
@@ -125,6 +366,16 @@ private:
     bool m_enabled = true;
     bool m_initialized = false;
     Quality m_quality = Quality::Quality;
+    int m_eyeQuality[2] = { -1, -1 };          // -1: m_quality
+    float m_eyeRenderScale[2] = { 0.0f, 0.0f };  // 0: quality scale
+    // ComputeRenderSizeForOutput results: two per eye, each packed as
+    // {outW:15, outH:15, backend ready:1, valid:1} low, {renderW:16,
+    // renderH:16} high, so the hooks read one without a lock. Misses and
+    // the setters' invalidation serialise on m_renderSizeMutex.
+    static constexpr uint32_t kRenderSizeEntries = 2;
+    std::atomic<uint64_t> m_renderSizeCache[2][kRenderSizeEntries] = {};
+    uint32_t m_renderSizeNext[2] = {};  // entry the next miss replaces
+    std::mutex m_renderSizeMutex;
     float m_sharpness = 0.5f;
     
     // DLSS 4 features
@@ -143,11 +394,106 @@ private:
     ID3D11Texture2D* m_zeroDepthTexture = nullptr;
     uint32_t m_zeroDepthWidth = 0;
     uint32_t m_zeroDepthHeight = 0;
+    uint64_t m_zeroMVUseFrame = 0;
+    uint64_t m_zeroDepthUseFrame = 0;
 
     // Simple downscale pipeline (fullscreen triangle)
     ID3D11VertexShader* m_fsVS = nullptr;
-    ID3D11PixelShader* m_fsPS = nullptr;
     ID3D11SamplerState* m_linearSampler = nullptr;
+    ID3D11Buffer* m_downscaleCB = nullptr;
+    // One pixel shader per DLSSDownscale permutation, created on first use
+    ID3D11PixelShader* m_downscalePS[DLSSDownscale::kPermutationCount] = {};
+    ID3D11ComputeShader* m_downscaleCS[DLSSDownscale::kComputePermutationCount] = {};
+    DLSSDownscale::Filter m_downscaleFilter = DLSSDownscale::Filter::CatmullRom;
+    bool m_downscaleCompute = false;
+    // No scissor, no culling: the blits must cover the whole target
+    ID3D11RasterizerState* m_blitRS = nullptr;
+    // Depth twin composite (BlitDepthToDSV), created on first use
+    ID3D11PixelShader* m_depthCompositePS = nullptr;
+    ID3D11PixelShader* m_stencilCompositePS = nullptr;
+    ID3D11Buffer* m_compositeCB = nullptr;
+    ID3D11DepthStencilState* m_depthCompositeDS = nullptr;
+    ID3D11DepthStencilState* m_stencilCompositeDS[8] = {};  // one per stencil bit
+    bool m_lastDownscaleCompute = false;
+
+    // GPU time of one eye's downscale, and of each eye's whole ProcessEye
+    GpuTimer m_downscaleTimer;
+    GpuTimer m_eyeTimers[2];
+
+    // Stereo atlas output: one texture for both eyes, plus its sharpening
+    // intermediate (DLSS writes it, CAS copies each eye's region out)
+    struct StereoAtlas {
+        ID3D11Texture2D* texture = nullptr;  // submitted texture
+        ID3D11UnorderedAccessView* textureUAV = nullptr;
+        ID3D11Texture2D* upscaled = nullptr;
+        ID3D11ShaderResourceView* upscaledSRV = nullptr;
+        DLSSDownscale::Encoding encoding = DLSSDownscale::Encoding::Linear;
+        DLSSAtlas::Layout layout;
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        uint64_t useFrame = 0;
+    };
+    StereoAtlas m_atlas;
+    bool m_stereoAtlasEnabled = false;
+    uint32_t m_outputBinds = 0;      // this frame so far
+    uint32_t m_lastOutputBinds = 0;  // last complete frame
+
+    // Pre-recorded passes (DLSSCmdList); the recorder owns the deferred context
+    DLSSCmdList::Recorder* m_passRecorder = nullptr;
+    DLSSCmdList::Cache* m_passCache = nullptr;
+    bool m_deferredPassesEnabled = false;
+    bool m_persistentTagsEnabled = true;
+
+    // Contrast-adaptive sharpening, one compute shader per output encoding
+    ID3D11ComputeShader* m_sharpenCS[DLSSSharpen::kPermutationCount] = {};
+    ID3D11Buffer* m_sharpenCB = nullptr;
+    std::bitset<256> m_sharpenViewFailed;  // output DXGI formats whose sharpening views the device refused
+
+    // Depth histogram for camera-cut detection (DLSSHistory)
+    ID3D11ComputeShader* m_depthHistogramCS = nullptr;
+    ID3D11Buffer* m_depthHistogramCB = nullptr;
+
+    // Asynchronous GPU readback (DLSSReadback); the device owns the staging copies and fences
+    DLSSReadback::Device* m_readbackDevice = nullptr;
+    DLSSReadback::Ring* m_readback = nullptr;
+    bool m_readbackUnavailable = false;  // creation failed; not retried until Shutdown
+    uint64_t m_readbackCollectFrame = 0;
+    bool m_readbackProbesEnabled = false;
+    ID3D11ComputeShader* m_probeCS = nullptr;
+    ID3D11Buffer* m_probeCB = nullptr;
+    ID3D11Buffer* m_probePartials = nullptr;  // per-group results, copied into the ring after each dispatch
+    ID3D11UnorderedAccessView* m_probePartialsUAV = nullptr;
+
+    // Frame capture: per eye, a ring of staging copies fenced like the
+    // readback ring and read back on the render thread once they land
+    struct CaptureSlot {
+        ID3D11Texture2D* staging[DLSSCapture::kMaxSurfaces] = {};
+        ID3D11Query* fence = nullptr;
+        DLSSCapture::Frame frame;  // metadata; pixels are filled when the copy is read
+        uint64_t issueFrame = 0;
+    };
+    static constexpr uint32_t kCaptureSlots = 3;
+    static constexpr uint32_t kCaptureQueueFrames = 16;
+    CaptureSlot m_captureSlots[2][kCaptureSlots];
+    uint32_t m_captureHead[2] = {};
+    uint32_t m_captureCount[2] = {};
+    DLSSCapture::Writer m_captureWriter;
+    std::string m_captureDirectory = "F4SEVR_DLSS_Captures";
+    uint64_t m_captureFirstFrame = 0;  // 0: no capture
+    uint64_t m_captureEndFrame = 0;    // first frame not captured
+    bool m_captureActive = false;      // the file is open
+    LARGE_INTEGER m_captureStart{};
+    uint32_t m_captureSkipped[2] = {}; // since the eye's last frame pushed
+    uint64_t m_captureSkippedTotal = 0;
+    uint64_t m_captureUpdateFrame = 0;
+
+    // Background bring-up
+    std::thread m_initThread;
+    std::atomic<InitStage> m_initStage{InitStage::Idle};
+    uint32_t m_initFailures = 0;       // consecutive failed bring-ups
+    uint64_t m_initFailedFrame = 0;    // DLSSVram frame of the last one
+    InitTimings m_initTimings{};
+    bool m_slPrepareFailed = false;
+    IUpscaleBackend* m_preparedBackend = nullptr;  // handed over to m_backend on the render thread
 
     // Extended configuration state
     bool m_sharpeningEnabled = true;
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+
+// Present-hook scheduling of the ImGui overlay. While the menu is hidden no
+// ImGui frame is built or drawn at all (hotkeys stay on their own cheap
+// path). While it is open a new frame is built only when input arrived or
+// the live readouts are due, and never faster than the redraw cap; in
+// between, the draw data of the last built frame is replayed onto the new
+// back buffer, which skips NewFrame and the whole widget pass.
+namespace DLSSOverlay {
+
+    enum class Action : uint8_t {
+        Skip = 0,   // menu hidden: no ImGui work this Present
+        Replay,     // draw the cached ImDrawData again
+        Rebuild     // NewFrame + widgets + Render, then draw
+    };
+
+    // Readouts (fps, GPU timings) refresh at least this often with an idle menu
+    constexpr double kIdleRefreshMs = 250.0;
+
+    class Scheduler {
+    public:
+        // redrawHz <= 0 removes the cap (rebuild on every Present that wants one)
+        void SetRedrawRate(int redrawHz) {
+            m_minIntervalMs = redrawHz > 0 ? 1000.0 / static_cast<double>(redrawHz) : 0.0;
+        }
+
+        // nowMs: monotonic time; inputPending: window input arrived since the last call
+        Action Next(bool visible, bool inputPending, double nowMs) {
+            if (!visible) {
+                m_wasVisible = false;
+                m_inputPending = false;
+                return Action::Skip;
+            }
+            m_inputPending = m_inputPending || inputPending;
+            const double sinceBuild = nowMs - m_lastBuildMs;
+            // First frame after opening always builds; nothing is cached yet
+            const bool due = !m_wasVisible ||
+                             (sinceBuild >= m_minIntervalMs && (m_inputPending || sinceBuild >= kIdleRefreshMs));
+            m_wasVisible = true;
+            if (!due) {
+                return Action::Replay;
+            }
+            m_lastBuildMs = nowMs;
+            m_inputPending = false;
+            return Action::Rebuild;
+        }
+
+        // Time since the previous build, for ImGuiIO::DeltaTime
+        double LastBuildMs() const { return m_lastBuildMs; }
+
+    private:
+        double m_minIntervalMs = 1000.0 / 30.0;
+        double m_lastBuildMs = 0.0;
+        bool m_wasVisible = false;
+        bool m_inputPending = false;
+    };
+
+    // Present-hook CPU time (hook entry to the real Present), smoothed, split
+    // by menu state so the cost of an open menu can be compared to a hidden one.
+    struct CpuStats {
+        float hiddenUs = 0.0f;
+        float visibleUs = 0.0f;
+        uint64_t hiddenFrames = 0;
+        uint64_t visibleFrames = 0;
+        uint64_t rebuilds = 0;
+        uint64_t replays = 0;
+
+        void Add(Action action, float us) {
+            float& avg = (action == Action::Skip) ? hiddenUs : visibleUs;
+            uint64_t& frames = (action == Action::Skip) ? hiddenFrames : visibleFrames;
+            avg = frames ? avg * 0.95f + us * 0.05f : us;
+            ++frames;
+            if (action == Action::Rebuild) ++rebuilds;
+            if (action == Action::Replay) ++replays;
+        }
+    };
+}
@@ -0,0 +1,290 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "dlss_arena.h"
+
+// Per-frame pass graph for early DLSS. Every OMSetRenderTargets call opens a
+// pass (node); shader-resource binds and copies add read-after-write edges
+// from the pass that last wrote a resource. At the end of the frame the
+// passes are classified from their shape and their inputs, and the result is
+// cached so the next frame's hooks only look up a pass index.
+//
+// Resources are opaque keys (the D3D texture pointer in the hooks), so the
+// graph can be fed from a recorded call stream as well. The per-frame lookups
+// (last writer, shape ordinals) live in the caller's frame arena; the pass
+// and edge arrays keep their capacity, so a warm frame does not allocate.
+namespace DLSSPassGraph {
+
+    enum class PassClass : uint8_t {
+        Unknown = 0,
+        Shadow,     // depth-only, off-screen (shadow maps, cascades)
+        GBuffer,    // scene-sized geometry (MRT or depth prepass)
+        Lighting,   // scene-sized, reads the G-buffer
+        Post,       // reads lit scene color
+        HUD         // late, no scene inputs (menus, pip-boy, overlays)
+    };
+
+    inline const char* PassClassName(PassClass c) {
+        switch (c) {
+            case PassClass::Shadow: return "shadow";
+            case PassClass::GBuffer: return "gbuffer";
+            case PassClass::Lighting: return "lighting";
+            case PassClass::Post: return "post";
+            case PassClass::HUD: return "hud";
+            default: return "unknown";
+        }
+    }
+
+    struct Target {
+        uintptr_t key = 0;    // 0 = empty slot
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t format = 0;  // DXGI_FORMAT
+        bool depth = false;
+    };
+
+    // 8 RTVs + 1 DSV
+    constexpr uint32_t kMaxTargets = 9;
+
+    struct Pass {
+        uint64_t signature = 0;
+        Target targets[kMaxTargets];
+        uint8_t targetCount = 0;
+        uint8_t colorCount = 0;
+        bool hasDepth = false;
+        uint32_t width = 0;           // size of the first bound target
+        uint32_t height = 0;
+        uint32_t viewportW = 0;       // largest viewport set while the pass was open
+        uint32_t viewportH = 0;
+        uint32_t draws = 0;
+        uint32_t clears = 0;
+        uint32_t firstEdge = 0;       // producers of this pass: m_edges[firstEdge, firstEdge + edgeCount)
+        uint32_t edgeCount = 0;
+        int32_t overwrites = -1;      // pass that wrote one of these targets earlier this frame
+        PassClass cls = PassClass::Unknown;
+    };
+
+    struct FrameStats {
+        uint32_t passes = 0;
+        uint32_t edges = 0;
+        uint32_t draws = 0;
+        uint32_t matchedByIndex = 0;      // same signature at the same position as last frame
+        uint32_t matchedBySignature = 0;  // found in the signature cache
+        uint32_t unmatched = 0;
+        uint32_t counts[6] = {};          // passes per PassClass
+    };
+
+    class FrameGraph {
+    public:
+        static constexpr uint32_t kMaxPasses = 1024;
+
+        explicit FrameGraph(DLSSArena::FrameArena& arena) : m_lastWriter(arena), m_shapeOrdinal(arena) {}
+
+        // Opens a new pass for the bound targets and returns its cached class
+        // (Unknown on a first sighting). Cheap enough for the bind hook.
+        PassClass BeginPass(const Target* targets, uint32_t count) {
+            if (m_passes.size() >= kMaxPasses) {
+                m_current = -1;
+                return PassClass::Unknown;
+            }
+            if (count > kMaxTargets) count = kMaxTargets;
+            Pass p{};
+            uint64_t h = 1469598103934665603ull;  // FNV-1a over the target shapes
+            auto mix = [&h](uint64_t v) { h = (h ^ v) * 1099511628211ull; };
+            for (uint32_t i = 0; i < count; ++i) {
+                const Target& t = targets[i];
+                if (!t.key) continue;
+                p.targets[p.targetCount++] = t;
+                if (t.depth) p.hasDepth = true; else ++p.colorCount;
+                if (p.width == 0) { p.width = t.width; p.height = t.height; }
+                mix((static_cast<uint64_t>(t.width) << 32) | t.height);
+                mix((static_cast<uint64_t>(t.format) << 1) | (t.depth ? 1u : 0u));
+            }
+            if (p.targetCount == 0) {
+                m_current = -1;
+                return PassClass::Unknown;
+            }
+            mix(p.targetCount);
+            // Identical shapes repeat (cascades, ping-pong blurs): the ordinal keeps them apart
+            const uint32_t ordinal = m_shapeOrdinal.FindOrInsert(h, 0)++;
+            mix(ordinal);
+            p.signature = h;
+            p.firstEdge = static_cast<uint32_t>(m_edges.size());
+
+            const size_t index = m_passes.size();
+            if (index < m_prev.size() && m_prev[index].signature == p.signature) {
+                p.cls = m_prev[index].cls;
+                ++m_stats.matchedByIndex;
+            } else {
+                auto it = m_cache.find(p.signature);
+                if (it != m_cache.end()) {
+                    p.cls = it->second;
+                    ++m_stats.matchedBySignature;
+                } else {
+                    ++m_stats.unmatched;
+                }
+            }
+            for (uint32_t i = 0; i < p.targetCount && p.overwrites < 0; ++i) {
+                if (const uint32_t* writer = m_lastWriter.Find(p.targets[i].key)) p.overwrites = static_cast<int32_t>(*writer);
+            }
+            for (uint32_t i = 0; i < p.targetCount; ++i) {
+                m_lastWriter.Set(p.targets[i].key, static_cast<uint32_t>(index));
+            }
+            m_passes.push_back(p);
+            m_current = static_cast<int32_t>(index);
+            return p.cls;
+        }
+
+        void NoteViewport(uint32_t w, uint32_t h) {
+            if (m_current < 0) return;
+            Pass& p = m_passes[m_current];
+            if (w > p.viewportW) p.viewportW = w;
+            if (h > p.viewportH) p.viewportH = h;
+        }
+
+        void NoteDraw() {
+            ++m_stats.draws;
+            if (m_current >= 0) ++m_passes[m_current].draws;
+        }
+
+        void NoteClear() {
+            if (m_current >= 0) ++m_passes[m_current].clears;
+        }
+
+        // The current pass samples 'key': add an edge from its last writer.
+        void NoteRead(uintptr_t key) {
+            if (m_current < 0 || !key) return;
+            const uint32_t* writer = m_lastWriter.Find(key);
+            if (!writer || *writer == static_cast<uint32_t>(m_current)) return;
+            Pass& p = m_passes[m_current];
+            for (uint32_t i = 0; i < p.edgeCount; ++i) {
+                if (m_edges[p.firstEdge + i] == *writer) return;
+            }
+            // Edges of a pass stay contiguous as long as only the current pass adds them
+            if (p.firstEdge + p.edgeCount != m_edges.size()) return;
+            m_edges.push_back(*writer);
+            ++p.edgeCount;
+        }
+
+        // A copy/resolve: the destination inherits the source as a producer.
+        void NoteCopy(uintptr_t dst, uintptr_t src) {
+            if (!dst || !src) return;
+            if (const uint32_t* writer = m_lastWriter.Find(src)) {
+                const uint32_t index = *writer;  // Set can move the table
+                m_lastWriter.Set(dst, index);
+            }
+        }
+
+        PassClass CurrentClass() const {
+            return (m_current >= 0) ? m_passes[m_current].cls : PassClass::Unknown;
+        }
+
+        int32_t CurrentIndex() const { return m_current; }
+
+        // Classifies the frame, refreshes the cache and starts a new frame.
+        // Returns the finished frame's counters.
+        FrameStats EndFrame() {
+            Classify();
+            for (const Pass& p : m_passes) {
+                if (p.cls != PassClass::Unknown) m_cache[p.signature] = p.cls;
+                ++m_stats.counts[static_cast<uint32_t>(p.cls)];
+            }
+            // Drop stale signatures now and then (resolution change, new scene)
+            if (m_cache.size() > 4 * kMaxPasses) m_cache.clear();
+            m_stats.passes = static_cast<uint32_t>(m_passes.size());
+            m_stats.edges = static_cast<uint32_t>(m_edges.size());
+            const FrameStats s = m_stats;
+            m_prev.swap(m_passes);
+            m_passes.clear();
+            m_edges.clear();
+            m_lastWriter.Clear();
+            m_shapeOrdinal.Clear();
+            m_stats = {};
+            m_current = -1;
+            return s;
+        }
+
+        // Last completed frame, classified
+        const std::vector<Pass>& PreviousFrame() const { return m_prev; }
+
+        void Clear() {
+            m_passes.clear();
+            m_prev.clear();
+            m_edges.clear();
+            m_lastWriter.Clear();
+            m_shapeOrdinal.Clear();
+            m_cache.clear();
+            m_stats = {};
+            m_current = -1;
+        }
+
+    private:
+        // Scene size: the color target of the geometry pass with the most
+        // draws (ties go to the larger area).
+        bool FindSceneSize(uint32_t& w, uint32_t& h) const {
+            uint64_t best = 0;
+            for (const Pass& p : m_passes) {
+                if (!p.hasDepth || p.colorCount == 0) continue;
+                const uint64_t score = (static_cast<uint64_t>(p.draws) << 32) | (static_cast<uint64_t>(p.width) * p.height & 0xffffffffull);
+                if (score > best) { best = score; w = p.width; h = p.height; }
+            }
+            return best != 0;
+        }
+
+        bool ReadsFrom(const Pass& p, PassClass a, PassClass b = PassClass::Unknown) const {
+            for (uint32_t i = 0; i < p.edgeCount; ++i) {
+                const PassClass c = m_passes[m_edges[p.firstEdge + i]].cls;
+                if (c == a || (b != PassClass::Unknown && c == b)) return true;
+            }
+            return false;
+        }
+
+        void Classify() {
+            uint32_t sceneW = 0, sceneH = 0;
+            if (!FindSceneSize(sceneW, sceneH)) {
+                for (Pass& p : m_passes) p.cls = PassClass::Unknown;
+                return;
+            }
+            bool seenLighting = false;
+            bool seenPost = false;
+            for (Pass& p : m_passes) {
+                const bool sceneSized = (p.width == sceneW && p.height == sceneH);
+                const bool fullViewport = (p.viewportW == 0) || (p.viewportW >= p.width && p.viewportH >= p.height);
+                PassClass c = PassClass::Unknown;
+                if (p.colorCount == 0) {
+                    // Depth-only: a scene-sized full-screen one is the depth prepass
+                    c = (sceneSized && fullViewport) ? PassClass::GBuffer : PassClass::Shadow;
+                } else if (sceneSized && p.hasDepth && !seenLighting && (p.colorCount >= 2 || !ReadsFrom(p, PassClass::GBuffer))) {
+                    c = PassClass::GBuffer;
+                } else if (ReadsFrom(p, PassClass::GBuffer) && !seenPost) {
+                    // Deferred lighting, AO, decals on top of the G-buffer
+                    c = PassClass::Lighting;
+                    seenLighting = true;
+                } else if (ReadsFrom(p, PassClass::Lighting, PassClass::Post)) {
+                    c = PassClass::Post;
+                    seenPost = true;
+                } else if (seenLighting || seenPost) {
+                    // Late pass without scene inputs: HUD, unless it draws on
+                    // top of lit or post-processed content without clearing
+                    // it (forward transparencies, particles, decals)
+                    const PassClass prior = (p.overwrites >= 0 && p.clears == 0) ? m_passes[p.overwrites].cls : PassClass::Unknown;
+                    c = (prior == PassClass::Lighting || prior == PassClass::Post) ? prior : PassClass::HUD;
+                } else if (sceneSized && p.hasDepth) {
+                    c = PassClass::GBuffer;
+                }
+                p.cls = c;
+            }
+        }
+
+        std::vector<Pass> m_passes;
+        std::vector<Pass> m_prev;
+        std::vector<uint32_t> m_edges;                        // producer pass index per edge
+        DLSSArena::FrameMap<uintptr_t, uint32_t> m_lastWriter; // resource -> pass index
+        DLSSArena::FrameMap<uint64_t, uint32_t> m_shapeOrdinal;
+        std::unordered_map<uint64_t, PassClass> m_cache;      // signature -> class
+        FrameStats m_stats{};
+        int32_t m_current = -1;
+    };
+}
@@ -0,0 +1,298 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Asynchronous GPU readback. A stream is a small ring of staging copies of
+// one GPU buffer (a reduction result, never a full image). Each frame the
+// render thread copies into a free slot and ends the slot's fence (an event
+// query); a few frames later Collect finds the fence passed, maps the copy
+// without waiting and hands the bytes to the stream's callback. When every
+// slot is still in flight the frame's copy is skipped: the render thread
+// never blocks on the GPU.
+//
+// Results arrive in issue order, at least kMinLatency frames after their
+// copy. A copy whose fence has not passed after kStaleFrames is dropped.
+//
+// The probe reduction below runs on the GPU first: a 64x64 sample grid of
+// a texture is reduced per thread group to min/max/sum/non-finite, so a
+// probe reads back 1 KB whatever the texture size.
+//
+// Platform-free: fences and staging copies sit behind Device, which
+// dlss_manager.cpp implements over D3D11 and tests can fake.
+namespace DLSSReadback {
+
+    constexpr uint32_t kMaxStreams = 8;
+    constexpr uint32_t kMaxSlots = 4;
+    constexpr uint32_t kMaxBytes = 1024;    // per readback
+    constexpr uint64_t kMinLatency = 2;     // frames before a slot is polled
+    constexpr uint64_t kStaleFrames = 16;   // frames after which an unfinished copy is dropped
+
+    struct Result {
+        uint32_t stream = 0;
+        uint64_t frame = 0;     // frame the copy was issued in
+        uint32_t latency = 0;   // frames between copy and delivery
+        const void* data = nullptr;
+        uint32_t bytes = 0;
+    };
+    // Render thread, inside Collect
+    typedef void (*Callback)(void* user, const Result& result);
+
+    class Device {
+    public:
+        virtual ~Device() = default;
+        // The slot's fence has passed (never waits)
+        virtual bool Signaled(uint32_t stream, uint32_t slot) = 0;
+        // Copies the slot's staging data out; false when it cannot be mapped without waiting
+        virtual bool Read(uint32_t stream, uint32_t slot, void* dst, uint32_t bytes) = 0;
+    };
+
+    struct StreamStats {
+        uint64_t issued = 0;      // copies committed
+        uint64_t delivered = 0;   // callbacks made
+        uint64_t skipped = 0;     // frames without a free slot
+        uint64_t stale = 0;       // copies dropped after kStaleFrames
+        uint32_t inFlight = 0;
+        uint32_t lastLatency = 0; // frames, last delivery
+    };
+
+    class Ring {
+    public:
+        explicit Ring(Device& device) : m_device(device) {}
+        Ring(const Ring&) = delete;
+        Ring& operator=(const Ring&) = delete;
+
+        // Stream id, or -1 when the table is full or the sizes are out of range
+        int AddStream(const char* name, uint32_t bytes, uint32_t slots, Callback callback, void* user) {
+            if (m_streamCount >= kMaxStreams || bytes == 0 || bytes > kMaxBytes || slots == 0 || slots > kMaxSlots || !callback) return -1;
+            Stream& s = m_streams[m_streamCount];
+            s = Stream{};
+            s.name = name;
+            s.bytes = bytes;
+            s.slots = slots;
+            s.callback = callback;
+            s.user = user;
+            return static_cast<int>(m_streamCount++);
+        }
+
+        // Render thread: slot to copy this frame's data into, or -1 (every
+        // slot in flight: skip the copy). Follow with Commit or Cancel.
+        int Acquire(uint32_t stream, uint64_t frame) {
+            Stream* s = Get(stream);
+            if (!s) return -1;
+            if (s->count >= s->slots) {
+                ++s->stats.skipped;
+                return -1;
+            }
+            const uint32_t slot = (s->head + s->count) % s->slots;
+            s->frames[slot] = frame;
+            s->reserved = static_cast<int>(slot);
+            return s->reserved;
+        }
+
+        // The copy into 'slot' and its fence were issued
+        void Commit(uint32_t stream, int slot) {
+            Stream* s = Get(stream);
+            if (!s || slot < 0 || slot != s->reserved) return;
+            s->reserved = -1;
+            ++s->count;
+            ++s->stats.issued;
+        }
+
+        void Cancel(uint32_t stream, int slot) {
+            Stream* s = Get(stream);
+            if (s && slot == s->reserved) s->reserved = -1;
+        }
+
+        // Render thread, once per frame: delivers every finished copy,
+        // oldest first per stream. Returns the number of callbacks made.
+        uint32_t Collect(uint64_t frame) {
+            uint32_t delivered = 0;
+            uint8_t buffer[kMaxBytes];
+            for (uint32_t i = 0; i < m_streamCount; ++i) {
+                Stream& s = m_streams[i];
+                while (s.count > 0) {
+                    const uint32_t slot = s.head;
+                    const uint64_t age = frame >= s.frames[slot] ? frame - s.frames[slot] : 0;
+                    if (age < kMinLatency) break;
+                    if (m_device.Signaled(i, slot) && m_device.Read(i, slot, buffer, s.bytes)) {
+                        Result r;
+                        r.stream = i;
+                        r.frame = s.frames[slot];
+                        r.latency = static_cast<uint32_t>(age);
+                        r.data = buffer;
+                        r.bytes = s.bytes;
+                        s.callback(s.user, r);
+                        ++s.stats.delivered;
+                        s.stats.lastLatency = r.latency;
+                        ++delivered;
+                    } else if (age >= kStaleFrames) {
+                        ++s.stats.stale;
+                    } else {
+                        break;  // in order: later copies wait behind this one
+                    }
+                    s.head = (s.head + 1) % s.slots;
+                    --s.count;
+                }
+            }
+            return delivered;
+        }
+
+        // The stream's source was released or recreated: copies in flight are dropped
+        void Reset(uint32_t stream) {
+            Stream* s = Get(stream);
+            if (!s) return;
+            s->head = 0;
+            s->count = 0;
+            s->reserved = -1;
+        }
+
+        StreamStats GetStats(uint32_t stream) const {
+            const Stream* s = stream < m_streamCount ? &m_streams[stream] : nullptr;
+            if (!s) return StreamStats{};
+            StreamStats stats = s->stats;
+            stats.inFlight = s->count;
+            return stats;
+        }
+
+        const char* Name(uint32_t stream) const { return stream < m_streamCount ? m_streams[stream].name : "?"; }
+        uint32_t StreamCount() const { return m_streamCount; }
+
+    private:
+        struct Stream {
+            const char* name = "";
+            uint32_t bytes = 0;
+            uint32_t slots = 0;
+            Callback callback = nullptr;
+            void* user = nullptr;
+            uint32_t head = 0;    // oldest copy in flight
+            uint32_t count = 0;   // copies in flight
+            int reserved = -1;    // acquired, not committed yet
+            uint64_t frames[kMaxSlots] = {};
+            StreamStats stats;
+        };
+
+        Stream* Get(uint32_t stream) { return stream < m_streamCount ? &m_streams[stream] : nullptr; }
+
+        Device& m_device;
+        Stream m_streams[kMaxStreams];
+        uint32_t m_streamCount = 0;
+    };
+
+    // ---- Probe reduction ---------------------------------------------------
+
+    constexpr uint32_t kProbeGrid = 64;        // kProbeGrid x kProbeGrid samples
+    constexpr uint32_t kProbeGroupSize = 8;    // numthreads(8, 8, 1)
+    constexpr uint32_t kProbeGroups = kProbeGrid / kProbeGroupSize;
+    constexpr uint32_t kProbeGroupCount = kProbeGroups * kProbeGroups;
+    constexpr uint32_t kProbeBytes = kProbeGroupCount * 4 * sizeof(uint32_t);  // per group: min, max, sum, non-finite
+    static_assert(kProbeBytes <= kMaxBytes, "a probe must fit one readback");
+
+    // Value probed per sample
+    enum class Channel : uint32_t {
+        Luma = 0,    // Rec.709 luminance of rgb (exposure, output sanity)
+        Red = 1,     // .x (depth range)
+        Length = 2   // length(.xy) (motion vector magnitude)
+    };
+
+    // Shader constants (register b0)
+    struct ProbeParams {
+        uint32_t origin[2];  // region probed (an eye of the stereo atlas, or the whole texture)
+        uint32_t size[2];
+        uint32_t channel;    // Channel
+        uint32_t pad[3];
+    };
+    static_assert(sizeof(ProbeParams) == 32, "ProbeParams must match the HLSL cbuffer");
+
+    struct ProbeStats {
+        float minValue = 0.0f;   // over finite samples
+        float maxValue = 0.0f;
+        float mean = 0.0f;
+        uint32_t nonFinite = 0;  // NaN/Inf samples
+        uint32_t samples = 0;    // finite samples
+    };
+
+    // Texel sampled for grid cell i along an axis of 'size' texels
+    inline uint32_t ProbeSampleCoord(uint32_t i, uint32_t size) {
+        if (size == 0) return 0;
+        const uint32_t c = static_cast<uint32_t>((2ull * i + 1) * size / (2ull * kProbeGrid));
+        return c < size ? c : size - 1;
+    }
+
+    inline float ProbeValue(const float texel[4], Channel channel) {
+        switch (channel) {
+            case Channel::Red: return texel[0];
+            case Channel::Length: {
+                const float x = texel[0], y = texel[1];
+                const float sq = x * x + y * y;
+                return sq > 0.0f ? std::sqrt(sq) : (sq == 0.0f ? 0.0f : sq);
+            }
+            default: return 0.2126f * texel[0] + 0.7152f * texel[1] + 0.0722f * texel[2];
+        }
+    }
+
+    // Same bit test as the shader (the exponent is not all ones)
+    inline bool IsFinite(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return (bits & 0x7FFFFFFFu) < 0x7F800000u;
+    }
+
+    // CPU reference of the shader's output: RGBA float texels, 'pitch' texels
+    // per row, probed over the params' region -> kProbeGroupCount x
+    // {min, max, sum (float bits), non-finite count}
+    inline void BuildProbePartials(const float* texels, uint32_t pitch, const ProbeParams& params, uint32_t out[kProbeGroupCount * 4]) {
+        const uint32_t width = params.size[0], height = params.size[1];
+        const Channel channel = static_cast<Channel>(params.channel);
+        for (uint32_t g = 0; g < kProbeGroupCount; ++g) {
+            float mn = 3.4e38f, mx = -3.4e38f, sum = 0.0f;
+            uint32_t bad = 0;
+            const uint32_t gx = g % kProbeGroups, gy = g / kProbeGroups;
+            for (uint32_t t = 0; t < kProbeGroupSize * kProbeGroupSize; ++t) {
+                const uint32_t x = params.origin[0] + ProbeSampleCoord(gx * kProbeGroupSize + t % kProbeGroupSize, width);
+                const uint32_t y = params.origin[1] + ProbeSampleCoord(gy * kProbeGroupSize + t / kProbeGroupSize, height);
+                const float v = (texels && width && height) ? ProbeValue(texels + (static_cast<size_t>(y) * pitch + x) * 4, channel) : 0.0f;
+                if (!IsFinite(v)) { ++bad; continue; }
+                if (v < mn) mn = v;
+                if (v > mx) mx = v;
+                sum += v;
+            }
+            std::memcpy(&out[g * 4 + 0], &mn, sizeof(float));
+            std::memcpy(&out[g * 4 + 1], &mx, sizeof(float));
+            std::memcpy(&out[g * 4 + 2], &sum, sizeof(float));
+            out[g * 4 + 3] = bad;
+        }
+    }
+
+    // Final reduction of the per-group partials read back from the GPU
+    inline ProbeStats ReduceProbe(const void* data, uint32_t bytes) {
+        ProbeStats s{};
+        if (!data || bytes < kProbeBytes) return s;
+        uint32_t words[kProbeGroupCount * 4];
+        std::memcpy(words, data, kProbeBytes);
+        constexpr uint32_t kGroupSamples = kProbeGroupSize * kProbeGroupSize;
+        double sum = 0.0;
+        uint32_t summed = 0;  // finite samples in 'sum'
+        bool any = false;
+        for (uint32_t g = 0; g < kProbeGroupCount; ++g) {
+            float mn, mx, gs;
+            std::memcpy(&mn, &words[g * 4 + 0], sizeof(float));
+            std::memcpy(&mx, &words[g * 4 + 1], sizeof(float));
+            std::memcpy(&gs, &words[g * 4 + 2], sizeof(float));
+            const uint32_t bad = words[g * 4 + 3] < kGroupSamples ? words[g * 4 + 3] : kGroupSamples;
+            s.nonFinite += bad;
+            if (bad == kGroupSamples) continue;
+            s.samples += kGroupSamples - bad;
+            if (!any || mn < s.minValue) s.minValue = mn;
+            if (!any || mx > s.maxValue) s.maxValue = mx;
+            any = true;
+            // A group whose finite samples overflowed the float sum leaves the mean
+            if (IsFinite(gs)) {
+                sum += gs;
+                summed += kGroupSamples - bad;
+            }
+        }
+        s.mean = summed ? static_cast<float>(sum / summed) : 0.0f;
+        return s;
+    }
+}
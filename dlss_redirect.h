@@ -0,0 +1,249 @@
+#pragma once
+#include <cstdint>
+#include "dlss_arena.h"
+
+// Binding table for early DLSS phase 2 (rt_redirect). Decides, per
+// OMSetRenderTargets call, which bound targets get swapped for their
+// render-size twins. Resources are identified by opaque keys (the D3D
+// texture pointer in the hooks, plain integers in a replayed call stream).
+//
+// Invariant kept within a frame: a big resource is either always redirected
+// or always native. The first bind that cannot be redirected as a whole
+// (mixed sizes, redirect turned off) makes every resource in it native for
+// the rest of the frame; resources that were redirected before are flagged
+// for a small->big composite so later passes see the scene content. Depth
+// twins are composited too (depth, then stencil bit by bit), since later
+// full-size passes depth-test against the big target.
+//
+// A twin stands for one subresource: the hooks only redirect views of mip 0
+// of a single slice, and the scissor rects of a redirected bind are scaled
+// like its viewports.
+//
+// The per-frame resource states live in the caller's frame arena.
+// Formats are DXGI_FORMAT values as integers.
+namespace DLSSRedirect {
+
+    enum class Kind : uint8_t { Color = 0, Depth = 1 };
+
+    enum class Action : uint8_t {
+        Native = 0,           // bind the original view
+        Redirect,             // bind the render-size twin
+        CompositeThenNative   // blit twin -> big first, then bind the original
+    };
+
+    struct Slot {
+        uintptr_t key = 0;    // 0 = empty slot
+        uint32_t width = 0;
+        uint32_t height = 0;
+        Kind kind = Kind::Color;
+    };
+
+    // Target area per bind, used as a proxy for pixel writes of the pass,
+    // plus the clears/copies that were moved onto the twins.
+    struct PassStats {
+        uint32_t redirectedBinds = 0;
+        uint32_t nativeBinds = 0;
+        uint64_t redirectedPixels = 0;
+        uint64_t nativePixels = 0;
+        uint32_t composites = 0;
+        uint32_t translatedClears = 0;
+        uint32_t translatedCopies = 0;
+        uint64_t bytesSaved = 0;      // full-size minus twin-size traffic avoided
+    };
+
+    // Bytes not touched when an operation runs on the twin instead of the
+    // big resource (surface sizes as DLSSVram::SurfaceBytes gives them)
+    inline uint64_t BytesSaved(uint64_t bigBytes, uint64_t smallBytes) {
+        return (bigBytes > smallBytes) ? bigBytes - smallBytes : 0;
+    }
+
+    // Upper bound of slots per bind: 8 RTVs + 1 DSV.
+    constexpr uint32_t kMaxSlots = 9;
+
+    // ---- Depth twins ------------------------------------------------------
+
+    // A depth twin is created typeless so the composite can read it back
+    // through SRVs; 'depthView'/'stencilView' are 0 for a plane it lacks
+    struct DepthTwinFormats {
+        uint32_t texture = 0;       // 0 = not a depth format
+        uint32_t depthView = 0;
+        uint32_t stencilView = 0;
+    };
+
+    constexpr DepthTwinFormats MakeDepthTwin(uint32_t texture, uint32_t depthView, uint32_t stencilView) {
+        DepthTwinFormats f{};
+        f.texture = texture;
+        f.depthView = depthView;
+        f.stencilView = stencilView;
+        return f;
+    }
+
+    // From the big texture's format (typeless or a D* format)
+    constexpr DepthTwinFormats GetDepthTwinFormats(uint32_t format) {
+        switch (format) {
+            case 19: case 20: return MakeDepthTwin(19, 21, 22);  // R32G8X24_TYPELESS / D32_FLOAT_S8X24_UINT
+            case 39: case 40: return MakeDepthTwin(39, 41, 0);   // R32_TYPELESS / D32_FLOAT
+            case 44: case 45: return MakeDepthTwin(44, 46, 47);  // R24G8_TYPELESS / D24_UNORM_S8_UINT
+            case 53: case 55: return MakeDepthTwin(53, 56, 0);   // R16_TYPELESS / D16_UNORM
+            default: return DepthTwinFormats{};
+        }
+    }
+
+    // Constants of the depth/stencil composite shaders (shaders/DepthComposite.hlsl)
+    struct CompositeParams {
+        uint32_t srcWidth = 0;
+        uint32_t srcHeight = 0;
+        uint32_t dstWidth = 0;
+        uint32_t dstHeight = 0;
+        uint32_t stencilBit = 0;   // StencilComposite: mask of the one bit this draw writes
+        uint32_t pad[3] = {};
+    };
+    static_assert(sizeof(CompositeParams) == 32, "matches the HLSL cbuffer");
+
+    // Twin texel a big pixel takes its depth from (nearest; the shaders'
+    // min(pixel * src / dst, src - 1))
+    constexpr uint32_t CompositeSourceTexel(uint32_t dstPixel, uint32_t srcSize, uint32_t dstSize) {
+        const uint32_t t = dstSize ? static_cast<uint32_t>(static_cast<uint64_t>(dstPixel) * srcSize / dstSize) : 0;
+        return t < srcSize ? t : (srcSize ? srcSize - 1 : 0);
+    }
+
+    // ---- Scissors ---------------------------------------------------------
+
+    // D3D11_RECT layout
+    struct Rect {
+        int32_t left = 0;
+        int32_t top = 0;
+        int32_t right = 0;
+        int32_t bottom = 0;
+    };
+
+    // A scissor rect of a scene-sized pass moved onto its twin: edges are
+    // rounded outwards so no pixel the big pass would draw is clipped
+    inline Rect ScaleScissor(const Rect& r, uint32_t sceneW, uint32_t sceneH, uint32_t smallW, uint32_t smallH) {
+        if (sceneW == 0 || sceneH == 0) return r;
+        auto down = [](int32_t v, uint32_t num, uint32_t den) {
+            const int64_t p = static_cast<int64_t>(v) * num;
+            return static_cast<int32_t>(p >= 0 ? p / den : -((-p + den - 1) / den));
+        };
+        auto up = [](int32_t v, uint32_t num, uint32_t den) {
+            const int64_t p = static_cast<int64_t>(v) * num;
+            return static_cast<int32_t>(p >= 0 ? (p + den - 1) / den : -(-p / den));
+        };
+        Rect s;
+        s.left = down(r.left, smallW, sceneW);
+        s.top = down(r.top, smallH, sceneH);
+        s.right = up(r.right, smallW, sceneW);
+        s.bottom = up(r.bottom, smallH, sceneH);
+        return s;
+    }
+
+    class BindingTable {
+    public:
+        explicit BindingTable(DLSSArena::FrameArena& arena) : m_state(arena) {}
+
+        void BeginFrame() {
+            m_state.Clear();
+            m_stats = {};
+        }
+
+        // sceneW/H: size of the big scene targets; smallW/H: twin size.
+        // Writes one action per slot into 'outActions'. Returns true when the
+        // bind was redirected.
+        bool ResolveBind(const Slot* slots, uint32_t count,
+                         uint32_t sceneW, uint32_t sceneH,
+                         uint32_t smallW, uint32_t smallH,
+                         bool redirectEnabled, Action* outActions) {
+            if (count > kMaxSlots) count = kMaxSlots;
+            bool redirectable = redirectEnabled && sceneW > 0 && sceneH > 0 &&
+                                smallW > 0 && smallH > 0 && (smallW < sceneW || smallH < sceneH);
+            uint32_t bound = 0;
+            for (uint32_t i = 0; i < count && redirectable; ++i) {
+                const Slot& s = slots[i];
+                if (!s.key) continue;
+                ++bound;
+                if (s.width != sceneW || s.height != sceneH) {
+                    redirectable = false;
+                    break;
+                }
+                const State* state = m_state.Find(s.key);
+                if (state && *state == State::Native) {
+                    redirectable = false;
+                }
+            }
+            if (bound == 0) redirectable = false;
+
+            if (redirectable) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (!slots[i].key) { outActions[i] = Action::Native; continue; }
+                    m_state.Set(slots[i].key, State::Redirected);
+                    outActions[i] = Action::Redirect;
+                    if (slots[i].kind == Kind::Color) {
+                        m_stats.redirectedPixels += static_cast<uint64_t>(smallW) * smallH;
+                    }
+                }
+                ++m_stats.redirectedBinds;
+                return true;
+            }
+
+            for (uint32_t i = 0; i < count; ++i) {
+                const Slot& s = slots[i];
+                outActions[i] = Action::Native;
+                if (!s.key) continue;
+                State* state = m_state.Find(s.key);
+                if (state && *state == State::Redirected) {
+                    outActions[i] = Action::CompositeThenNative;
+                    ++m_stats.composites;
+                    *state = State::Native;
+                } else if (!state && s.width == sceneW && s.height == sceneH) {
+                    // Scene-sized resource written at full size: keep it native this frame
+                    m_state.Set(s.key, State::Native);
+                }
+                if (s.kind == Kind::Color) {
+                    m_stats.nativePixels += static_cast<uint64_t>(s.width) * s.height;
+                }
+            }
+            ++m_stats.nativeBinds;
+            return false;
+        }
+
+        bool IsRedirected(uintptr_t key) const {
+            const State* state = m_state.Find(key);
+            return state && *state == State::Redirected;
+        }
+
+        bool IsNative(uintptr_t key) const {
+            const State* state = m_state.Find(key);
+            return state && *state == State::Native;
+        }
+
+        // A copy wrote twin content into a resource that was not bound yet:
+        // it joins the redirected set. Fails if it already went native.
+        bool AdoptRedirect(uintptr_t key) {
+            bool inserted = false;
+            const State state = m_state.FindOrInsert(key, State::Redirected, &inserted);
+            return inserted || state == State::Redirected;
+        }
+
+        // Full-size data was written into the big resource (copy/resolve).
+        void MarkNative(uintptr_t key) { m_state.Set(key, State::Native); }
+
+        void NoteTranslatedClear(uint64_t bytesSaved) {
+            ++m_stats.translatedClears;
+            m_stats.bytesSaved += bytesSaved;
+        }
+
+        void NoteTranslatedCopy(uint64_t bytesSaved) {
+            ++m_stats.translatedCopies;
+            m_stats.bytesSaved += bytesSaved;
+        }
+
+        void NoteComposite() { ++m_stats.composites; }
+
+        const PassStats& Stats() const { return m_stats; }
+
+    private:
+        enum class State : uint8_t { Redirected, Native };
+        DLSSArena::FrameMap<uintptr_t, State> m_state;
+        PassStats m_stats{};
+    };
+}
@@ -0,0 +1,335 @@
+#include "dlss_shaders.h"
+#include "common/IDebugLog.h"
+
+#include <windows.h>
+#include <shlobj.h>
+#include <d3dcompiler.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef DLSS_EMBEDDED_SHADERS
+#define DLSS_EMBEDDED_SHADERS 0
+#endif
+
+#if DLSS_EMBEDDED_SHADERS
+// Generated by the build (fxc /Fh /Vn g_<Name>) from shaders/*.hlsl;
+// Downscale_<Filter>_<Encoding>_<Layout> and DownscaleCS_<Filter>_<Encoding>
+// come from shaders/Downscale.hlsl, Sharpen_<Encoding> from shaders/Sharpen.hlsl
+#include "shaders/FullscreenVS.h"
+#include "shaders/Downscale_Box_Linear_Mono.h"
+#include "shaders/Downscale_Box_Linear_Stereo.h"
+#include "shaders/Downscale_Box_SRGB_Mono.h"
+#include "shaders/Downscale_Box_SRGB_Stereo.h"
+#include "shaders/Downscale_Box_R11G11B10_Mono.h"
+#include "shaders/Downscale_Box_R11G11B10_Stereo.h"
+#include "shaders/Downscale_Bilinear_Linear_Mono.h"
+#include "shaders/Downscale_Bilinear_Linear_Stereo.h"
+#include "shaders/Downscale_Bilinear_SRGB_Mono.h"
+#include "shaders/Downscale_Bilinear_SRGB_Stereo.h"
+#include "shaders/Downscale_Bilinear_R11G11B10_Mono.h"
+#include "shaders/Downscale_Bilinear_R11G11B10_Stereo.h"
+#include "shaders/Downscale_CatmullRom_Linear_Mono.h"
+#include "shaders/Downscale_CatmullRom_Linear_Stereo.h"
+#include "shaders/Downscale_CatmullRom_SRGB_Mono.h"
+#include "shaders/Downscale_CatmullRom_SRGB_Stereo.h"
+#include "shaders/Downscale_CatmullRom_R11G11B10_Mono.h"
+#include "shaders/Downscale_CatmullRom_R11G11B10_Stereo.h"
+#include "shaders/Downscale_Lanczos_Linear_Mono.h"
+#include "shaders/Downscale_Lanczos_Linear_Stereo.h"
+#include "shaders/Downscale_Lanczos_SRGB_Mono.h"
+#include "shaders/Downscale_Lanczos_SRGB_Stereo.h"
+#include "shaders/Downscale_Lanczos_R11G11B10_Mono.h"
+#include "shaders/Downscale_Lanczos_R11G11B10_Stereo.h"
+#include "shaders/DownscaleCS_Box_Linear.h"
+#include "shaders/DownscaleCS_Box_SRGB.h"
+#include "shaders/DownscaleCS_Box_R11G11B10.h"
+#include "shaders/DownscaleCS_Bilinear_Linear.h"
+#include "shaders/DownscaleCS_Bilinear_SRGB.h"
+#include "shaders/DownscaleCS_Bilinear_R11G11B10.h"
+#include "shaders/DownscaleCS_CatmullRom_Linear.h"
+#include "shaders/DownscaleCS_CatmullRom_SRGB.h"
+#include "shaders/DownscaleCS_CatmullRom_R11G11B10.h"
+#include "shaders/DownscaleCS_Lanczos_Linear.h"
+#include "shaders/DownscaleCS_Lanczos_SRGB.h"
+#include "shaders/DownscaleCS_Lanczos_R11G11B10.h"
+#include "shaders/Sharpen_Linear.h"
+#include "shaders/Sharpen_SRGB.h"
+#include "shaders/Sharpen_R11G11B10.h"
+#include "shaders/DepthHistogram.h"
+#include "shaders/Probe.h"
+#include "shaders/DepthComposite.h"
+#include "shaders/StencilComposite.h"
+#endif
+
+namespace DLSSShaders {
+
+    namespace {
+        struct ShaderInfo {
+            const char* name;
+            const char* file;     // shaders/<file>.hlsl
+            const char* target;
+            const char* filter;   // FILTER/ENCODING/STEREO/DOWNSCALE_CS defines; nullptr when unused
+            const char* encoding;
+            const char* stereo;
+            const char* compute;
+#if DLSS_EMBEDDED_SHADERS
+            const void* data;
+            size_t size;
+#endif
+        };
+
+#if DLSS_EMBEDDED_SHADERS
+#define DLSS_SHADER(name, target) { #name, #name, target, nullptr, nullptr, nullptr, nullptr, g_##name, sizeof(g_##name) }
+#define DLSS_DOWNSCALE(f, e, l, fd, ed, ld) { "Downscale_" #f "_" #e "_" #l, "Downscale", "ps_5_0", fd, ed, ld, "0", \
+                                              g_Downscale_##f##_##e##_##l, sizeof(g_Downscale_##f##_##e##_##l) }
+#define DLSS_DOWNSCALE_CS(f, e, fd, ed) { "DownscaleCS_" #f "_" #e, "Downscale", "cs_5_0", fd, ed, "0", "1", \
+                                          g_DownscaleCS_##f##_##e, sizeof(g_DownscaleCS_##f##_##e) }
+#define DLSS_SHARPEN(e, ed) { "Sharpen_" #e, "Sharpen", "cs_5_0", nullptr, ed, nullptr, nullptr, \
+                              g_Sharpen_##e, sizeof(g_Sharpen_##e) }
+#else
+#define DLSS_SHADER(name, target) { #name, #name, target, nullptr, nullptr, nullptr, nullptr }
+#define DLSS_DOWNSCALE(f, e, l, fd, ed, ld) { "Downscale_" #f "_" #e "_" #l, "Downscale", "ps_5_0", fd, ed, ld, "0" }
+#define DLSS_DOWNSCALE_CS(f, e, fd, ed) { "DownscaleCS_" #f "_" #e, "Downscale", "cs_5_0", fd, ed, "0", "1" }
+#define DLSS_SHARPEN(e, ed) { "Sharpen_" #e, "Sharpen", "cs_5_0", nullptr, ed, nullptr, nullptr }
+#endif
+        // Order matches Id; downscale entries follow DLSSDownscale::PermutationIndex
+        const ShaderInfo kShaders[] = {
+            DLSS_SHADER(FullscreenVS, "vs_5_0"),
+            DLSS_DOWNSCALE(Box, Linear, Mono, "0", "0", "0"),
+            DLSS_DOWNSCALE(Box, Linear, Stereo, "0", "0", "1"),
+            DLSS_DOWNSCALE(Box, SRGB, Mono, "0", "1", "0"),
+            DLSS_DOWNSCALE(Box, SRGB, Stereo, "0", "1", "1"),
+            DLSS_DOWNSCALE(Box, R11G11B10, Mono, "0", "2", "0"),
+            DLSS_DOWNSCALE(Box, R11G11B10, Stereo, "0", "2", "1"),
+            DLSS_DOWNSCALE(Bilinear, Linear, Mono, "1", "0", "0"),
+            DLSS_DOWNSCALE(Bilinear, Linear, Stereo, "1", "0", "1"),
+            DLSS_DOWNSCALE(Bilinear, SRGB, Mono, "1", "1", "0"),
+            DLSS_DOWNSCALE(Bilinear, SRGB, Stereo, "1", "1", "1"),
+            DLSS_DOWNSCALE(Bilinear, R11G11B10, Mono, "1", "2", "0"),
+            DLSS_DOWNSCALE(Bilinear, R11G11B10, Stereo, "1", "2", "1"),
+            DLSS_DOWNSCALE(CatmullRom, Linear, Mono, "2", "0", "0"),
+            DLSS_DOWNSCALE(CatmullRom, Linear, Stereo, "2", "0", "1"),
+            DLSS_DOWNSCALE(CatmullRom, SRGB, Mono, "2", "1", "0"),
+            DLSS_DOWNSCALE(CatmullRom, SRGB, Stereo, "2", "1", "1"),
+            DLSS_DOWNSCALE(CatmullRom, R11G11B10, Mono, "2", "2", "0"),
+            DLSS_DOWNSCALE(CatmullRom, R11G11B10, Stereo, "2", "2", "1"),
+            DLSS_DOWNSCALE(Lanczos, Linear, Mono, "3", "0", "0"),
+            DLSS_DOWNSCALE(Lanczos, Linear, Stereo, "3", "0", "1"),
+            DLSS_DOWNSCALE(Lanczos, SRGB, Mono, "3", "1", "0"),
+            DLSS_DOWNSCALE(Lanczos, SRGB, Stereo, "3", "1", "1"),
+            DLSS_DOWNSCALE(Lanczos, R11G11B10, Mono, "3", "2", "0"),
+            DLSS_DOWNSCALE(Lanczos, R11G11B10, Stereo, "3", "2", "1"),
+            DLSS_DOWNSCALE_CS(Box, Linear, "0", "0"),
+            DLSS_DOWNSCALE_CS(Box, SRGB, "0", "1"),
+            DLSS_DOWNSCALE_CS(Box, R11G11B10, "0", "2"),
+            DLSS_DOWNSCALE_CS(Bilinear, Linear, "1", "0"),
+            DLSS_DOWNSCALE_CS(Bilinear, SRGB, "1", "1"),
+            DLSS_DOWNSCALE_CS(Bilinear, R11G11B10, "1", "2"),
+            DLSS_DOWNSCALE_CS(CatmullRom, Linear, "2", "0"),
+            DLSS_DOWNSCALE_CS(CatmullRom, SRGB, "2", "1"),
+            DLSS_DOWNSCALE_CS(CatmullRom, R11G11B10, "2", "2"),
+            DLSS_DOWNSCALE_CS(Lanczos, Linear, "3", "0"),
+            DLSS_DOWNSCALE_CS(Lanczos, SRGB, "3", "1"),
+            DLSS_DOWNSCALE_CS(Lanczos, R11G11B10, "3", "2"),
+            DLSS_SHARPEN(Linear, "0"),
+            DLSS_SHARPEN(SRGB, "1"),
+            DLSS_SHARPEN(R11G11B10, "2"),
+            DLSS_SHADER(DepthHistogram, "cs_5_0"),
+            DLSS_SHADER(Probe, "cs_5_0"),
+            DLSS_SHADER(DepthComposite, "ps_5_0"),
+            DLSS_SHADER(StencilComposite, "ps_5_0"),
+        };
+#undef DLSS_SHADER
+#undef DLSS_DOWNSCALE
+#undef DLSS_DOWNSCALE_CS
+#undef DLSS_SHARPEN
+        static_assert(sizeof(kShaders) / sizeof(kShaders[0]) == static_cast<size_t>(Id::Count), "shader table out of sync with Id");
+
+        std::once_flag g_prepareOnce;
+        bool g_prepared = false;
+        Bytecode g_bytecode[static_cast<size_t>(Id::Count)];
+
+        double ElapsedMs(const LARGE_INTEGER& start) {
+            LARGE_INTEGER now{}, freq{};
+            QueryPerformanceCounter(&now);
+            QueryPerformanceFrequency(&freq);
+            return freq.QuadPart ? (double)(now.QuadPart - start.QuadPart) * 1000.0 / (double)freq.QuadPart : 0.0;
+        }
+
+#if !DLSS_EMBEDDED_SHADERS
+        // Dev builds own the compiled bytecode here
+        std::vector<uint8_t> g_storage[static_cast<size_t>(Id::Count)];
+
+        std::wstring GetShaderSourceDir() {
+#ifdef DLSS_SHADER_SOURCE_DIR
+            // Narrow literal from the build system, e.g. "C:/src/F4SEVR_DLSS/shaders/"
+            return L"" DLSS_SHADER_SOURCE_DIR;
+#else
+            HMODULE module = nullptr;
+            if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                                    reinterpret_cast<LPCWSTR>(&GetShaderSourceDir), &module)) {
+                return L"shaders\\";
+            }
+            wchar_t buffer[MAX_PATH];
+            const DWORD length = GetModuleFileNameW(module, buffer, MAX_PATH);
+            std::wstring path(buffer, buffer + length);
+            const size_t slash = path.find_last_of(L"/\\");
+            path.erase(slash == std::wstring::npos ? 0 : slash + 1);
+            return path + L"shaders\\";
+#endif
+        }
+
+        // Next to the NGX data under Documents, which is known to be writable
+        std::wstring GetShaderCacheDir() {
+            wchar_t docs[MAX_PATH] = {};
+            if (!SUCCEEDED(SHGetFolderPathW(NULL, CSIDL_MYDOCUMENTS, NULL, 0, docs))) {
+                return {};
+            }
+            std::wstring path = std::wstring(docs) + L"\\My Games\\Fallout4VR\\F4SE\\Plugins\\NGX\\ShaderCache\\";
+            SHCreateDirectoryExW(NULL, path.c_str(), NULL);
+            return path;
+        }
+
+        bool ReadFileBytes(const std::wstring& path, std::vector<uint8_t>& out) {
+            HANDLE f = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (f == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER size{};
+            bool ok = GetFileSizeEx(f, &size) && size.QuadPart > 0 && size.QuadPart < (64ll << 20);
+            if (ok) {
+                out.resize(static_cast<size_t>(size.QuadPart));
+                DWORD read = 0;
+                ok = ReadFile(f, out.data(), static_cast<DWORD>(out.size()), &read, nullptr) && read == out.size();
+            }
+            CloseHandle(f);
+            return ok;
+        }
+
+        bool WriteFileBytes(const std::wstring& path, const void* data, size_t size) {
+            // Write to a temp name first so a crash never leaves a truncated cache entry
+            const std::wstring tmp = path + L".tmp";
+            HANDLE f = CreateFileW(tmp.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (f == INVALID_HANDLE_VALUE) return false;
+            DWORD written = 0;
+            const bool ok = WriteFile(f, data, static_cast<DWORD>(size), &written, nullptr) && written == size;
+            CloseHandle(f);
+            return ok && MoveFileExW(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING);
+        }
+
+        uint64_t HashSource(const std::vector<uint8_t>& src, const ShaderInfo& info) {
+            uint64_t h = 1469598103934665603ull;  // FNV-1a
+            auto mixText = [&h](const char* p) {
+                for (; p && *p; ++p) h = (h ^ static_cast<uint8_t>(*p)) * 1099511628211ull;
+                h = (h ^ 0xffu) * 1099511628211ull;
+            };
+            for (uint8_t b : src) h = (h ^ b) * 1099511628211ull;
+            mixText(info.target);
+            mixText(info.filter);
+            mixText(info.encoding);
+            mixText(info.stereo);
+            mixText(info.compute);
+            return h;
+        }
+
+        // cached: 1 = loaded from the cache, 0 = compiled now
+        bool LoadOrCompile(const ShaderInfo& info, std::vector<uint8_t>& out, bool& cached) {
+            const std::wstring wname(info.name, info.name + strlen(info.name));
+            const std::wstring wfile(info.file, info.file + strlen(info.file));
+            std::vector<uint8_t> source;
+            if (!ReadFileBytes(GetShaderSourceDir() + wfile + L".hlsl", source)) {
+                _ERROR("[Shaders] Source not found for %s", info.name);
+                return false;
+            }
+            wchar_t hashText[17];
+            swprintf_s(hashText, L"%016llx", (unsigned long long)HashSource(source, info));
+            const std::wstring cacheDir = GetShaderCacheDir();
+            const std::wstring cachePath = cacheDir.empty() ? std::wstring() : cacheDir + wname + L"_" + hashText + L".cso";
+
+            if (!cachePath.empty() && ReadFileBytes(cachePath, out)) {
+                cached = true;
+                return true;
+            }
+
+            ID3DBlob* blob = nullptr;
+            ID3DBlob* err = nullptr;
+            // Only the defines the permutation sets; the list ends at the first null name
+            D3D_SHADER_MACRO defines[5] = {};
+            size_t defineCount = 0;
+            const D3D_SHADER_MACRO candidates[] = {
+                { "FILTER", info.filter }, { "ENCODING", info.encoding }, { "STEREO", info.stereo },
+                { "DOWNSCALE_CS", info.compute }
+            };
+            for (const D3D_SHADER_MACRO& m : candidates) {
+                if (m.Definition) defines[defineCount++] = m;
+            }
+            const HRESULT hr = D3DCompile(source.data(), source.size(), info.file, defineCount ? defines : nullptr, nullptr,
+                                          "main", info.target, D3DCOMPILE_OPTIMIZATION_LEVEL3, 0, &blob, &err);
+            if (FAILED(hr) || !blob) {
+                _ERROR("[Shaders] %s failed to compile: %s", info.name,
+                       err ? static_cast<const char*>(err->GetBufferPointer()) : "unknown error");
+                if (err) err->Release();
+                if (blob) blob->Release();
+                return false;
+            }
+            if (err) err->Release();
+            const uint8_t* bytes = static_cast<const uint8_t*>(blob->GetBufferPointer());
+            out.assign(bytes, bytes + blob->GetBufferSize());
+            blob->Release();
+            if (!cachePath.empty() && !WriteFileBytes(cachePath, out.data(), out.size())) {
+                _MESSAGE("[Shaders] Could not write cache entry for %s", info.name);
+            }
+            cached = false;
+            return true;
+        }
+#endif
+
+        void PrepareOnce() {
+            LARGE_INTEGER start{};
+            QueryPerformanceCounter(&start);
+            bool ok = true;
+#if DLSS_EMBEDDED_SHADERS
+            for (size_t i = 0; i < static_cast<size_t>(Id::Count); ++i) {
+                g_bytecode[i].data = kShaders[i].data;
+                g_bytecode[i].size = kShaders[i].size;
+            }
+            _MESSAGE("[Shaders] %zu shaders ready in %.2f ms (embedded bytecode)",
+                     static_cast<size_t>(Id::Count), ElapsedMs(start));
+#else
+            uint32_t hits = 0, compiled = 0;
+            for (size_t i = 0; i < static_cast<size_t>(Id::Count); ++i) {
+                bool cached = false;
+                if (!LoadOrCompile(kShaders[i], g_storage[i], cached)) {
+                    ok = false;
+                    continue;
+                }
+                g_bytecode[i].data = g_storage[i].data();
+                g_bytecode[i].size = g_storage[i].size();
+                (cached ? hits : compiled)++;
+            }
+            _MESSAGE("[Shaders] %zu shaders ready in %.2f ms (runtime: %u from cache, %u compiled)%s",
+                     static_cast<size_t>(Id::Count), ElapsedMs(start), hits, compiled, ok ? "" : " - some missing");
+#endif
+            g_prepared = ok;
+        }
+    }
+
+    bool Prepare() {
+        std::call_once(g_prepareOnce, PrepareOnce);
+        return g_prepared;
+    }
+
+    bool Get(Id id, Bytecode& out) {
+        Prepare();
+        const size_t i = static_cast<size_t>(id);
+        if (i >= static_cast<size_t>(Id::Count) || !g_bytecode[i].data) {
+            return false;
+        }
+        out = g_bytecode[i];
+        return true;
+    }
+
+    bool IsEmbedded() {
+        return DLSS_EMBEDDED_SHADERS != 0;
+    }
+}
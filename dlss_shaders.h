@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "dlss_downscale.h"
+#include "dlss_sharpen.h"
+
+// Internal shader bytecode. Release builds link the bytecode compiled at
+// build time from shaders/*.hlsl (fxc /Fh, DLSS_EMBEDDED_SHADERS=1); the
+// downscale permutations are one source compiled with different defines.
+// Development builds compile the .hlsl sources at runtime and keep the
+// result in an on-disk cache keyed by a hash of the source, so d3dcompiler
+// only runs when a shader actually changed.
+namespace DLSSShaders {
+
+    enum class Id : uint32_t {
+        FullscreenVS = 0,
+        DownscaleFirst,  // DLSSDownscale permutations, PermutationIndex order
+        DownscaleLast = DownscaleFirst + DLSSDownscale::kPermutationCount - 1,
+        DownscaleCSFirst,  // tiled compute variants, ComputePermutationIndex order
+        DownscaleCSLast = DownscaleCSFirst + DLSSDownscale::kComputePermutationCount - 1,
+        SharpenFirst,  // CAS compute shader per output encoding, DLSSDownscale::Encoding order
+        SharpenLast = SharpenFirst + DLSSSharpen::kPermutationCount - 1,
+        DepthHistogram,  // camera-cut detection, DLSSHistory
+        Probe,  // min/max/mean reduction for GPU readback, DLSSReadback
+        DepthComposite,    // redirect depth twin -> full-size target, DLSSRedirect
+        StencilComposite,  // same, one stencil bit per draw
+        Count
+    };
+
+    constexpr Id DownscaleId(DLSSDownscale::Filter f, DLSSDownscale::Encoding e, DLSSDownscale::Layout l) {
+        return static_cast<Id>(static_cast<uint32_t>(Id::DownscaleFirst) + DLSSDownscale::PermutationIndex(f, e, l));
+    }
+
+    constexpr Id DownscaleCSId(DLSSDownscale::Filter f, DLSSDownscale::Encoding e) {
+        return static_cast<Id>(static_cast<uint32_t>(Id::DownscaleCSFirst) + DLSSDownscale::ComputePermutationIndex(f, e));
+    }
+
+    constexpr Id SharpenId(DLSSDownscale::Encoding e) {
+        return static_cast<Id>(static_cast<uint32_t>(Id::SharpenFirst) + static_cast<uint32_t>(e));
+    }
+
+    struct Bytecode {
+        const void* data = nullptr;
+        size_t size = 0;
+    };
+
+    // Resolves every shader once. Safe to call from the init worker; later
+    // calls return immediately. Returns false if any shader is unavailable.
+    bool Prepare();
+
+    // Bytecode of one shader (calls Prepare on first use).
+    bool Get(Id id, Bytecode& out);
+
+    // True when the DLL carries build-time bytecode.
+    bool IsEmbedded();
+}
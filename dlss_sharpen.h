@@ -0,0 +1,218 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define DLSS_SHARPEN_SSE 1
+#else
+#define DLSS_SHARPEN_SSE 0
+#endif
+
+#include "dlss_downscale.h"
+
+// Contrast-adaptive sharpening (AMD FidelityFX CAS, no-scaling variant)
+// applied to the upscaled eye while it is copied into the texture that is
+// submitted to the compositor. DLSS 4 ignores the old sharpness parameter,
+// so this is what the Sharpness setting drives on the Streamline path.
+// CAS reads a 3x3 neighbourhood, so it cannot run in place: DLSS writes a
+// full-size intermediate (DLSSVram::Pool::Sharpen) and sharpening costs one
+// extra full-resolution write and read per eye over unsharpened output.
+// shaders/Sharpen.hlsl (one compute permutation per DLSSDownscale::Encoding)
+// mirrors the CPU reference below; keep both in sync.
+namespace DLSSSharpen {
+
+    constexpr uint32_t kPermutationCount = DLSSDownscale::kEncodingCount;
+    constexpr uint32_t kGroupSize = 8;  // numthreads(8, 8, 1)
+
+    constexpr uint32_t GroupCount(uint32_t size) {
+        return (size + kGroupSize - 1) / kGroupSize;
+    }
+
+    // Negative lobe weight: sharpness 0 -> -1/8 (mild), 1 -> -1/5 (maximum)
+    inline float Peak(float sharpness) {
+        const float s = sharpness < 0.0f ? 0.0f : (sharpness > 1.0f ? 1.0f : sharpness);
+        return -1.0f / (8.0f - 3.0f * s);
+    }
+
+    // Shader constants (register b0). The pass covers one region of the
+    // textures (a whole eye, or its half of a stereo atlas); reads clamp to
+    // the region, so each atlas eye is sharpened as if it were alone.
+    struct Params {
+        float size[2];       // region texels, bounds check for partial groups
+        float peak;
+        float pad;
+        uint32_t offset[2];  // region origin in both textures
+        uint32_t pad2[2];
+    };
+    static_assert(sizeof(Params) == 32, "Params must match the HLSL cbuffer");
+
+    inline Params MakeParams(uint32_t width, uint32_t height, float sharpness, uint32_t offsetX = 0, uint32_t offsetY = 0) {
+        Params p{};
+        p.size[0] = static_cast<float>(width);
+        p.size[1] = static_cast<float>(height);
+        p.peak = Peak(sharpness);
+        p.offset[0] = offsetX;
+        p.offset[1] = offsetY;
+        return p;
+    }
+
+    // ---- CPU reference -------------------------------------------------
+    // RGBA float images, row-major, 4 floats per texel; edges replicate.
+    // Alpha is passed through from the centre texel.
+
+    inline float Clamp01(float v) {
+        return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+    }
+
+    inline const float* Texel(const float* src, uint32_t w, uint32_t h, int32_t x, int32_t y) {
+        x = x < 0 ? 0 : (x >= static_cast<int32_t>(w) ? static_cast<int32_t>(w) - 1 : x);
+        y = y < 0 ? 0 : (y >= static_cast<int32_t>(h) ? static_cast<int32_t>(h) - 1 : y);
+        return src + (static_cast<size_t>(y) * w + static_cast<size_t>(x)) * 4;
+    }
+
+    // a b c
+    // d e f
+    // g h i
+    inline void SharpenTexel(const float* src, uint32_t w, uint32_t h, int32_t x, int32_t y, float peak, float* out) {
+        const float* a = Texel(src, w, h, x - 1, y - 1);
+        const float* b = Texel(src, w, h, x,     y - 1);
+        const float* c = Texel(src, w, h, x + 1, y - 1);
+        const float* d = Texel(src, w, h, x - 1, y);
+        const float* e = Texel(src, w, h, x,     y);
+        const float* f = Texel(src, w, h, x + 1, y);
+        const float* g = Texel(src, w, h, x - 1, y + 1);
+        const float* hh = Texel(src, w, h, x,    y + 1);
+        const float* i = Texel(src, w, h, x + 1, y + 1);
+        for (int ch = 0; ch < 3; ++ch) {
+            // Soft min/max: cross plus the full 3x3 ring
+            const float mnCross = std::fmin(std::fmin(std::fmin(b[ch], d[ch]), std::fmin(e[ch], f[ch])), hh[ch]);
+            const float mxCross = std::fmax(std::fmax(std::fmax(b[ch], d[ch]), std::fmax(e[ch], f[ch])), hh[ch]);
+            const float mnRing = std::fmin(mnCross, std::fmin(std::fmin(a[ch], c[ch]), std::fmin(g[ch], i[ch])));
+            const float mxRing = std::fmax(mxCross, std::fmax(std::fmax(a[ch], c[ch]), std::fmax(g[ch], i[ch])));
+            const float mn = mnCross + mnRing;
+            const float mx = mxCross + mxRing;
+            // Less sharpening where the neighbourhood is already near 0 or 1
+            const float amp = mx > 0.0f ? std::sqrt(Clamp01(std::fmin(mn, 2.0f - mx) / mx)) : 0.0f;
+            const float wgt = amp * peak;
+            const float v = ((b[ch] + d[ch] + f[ch] + hh[ch]) * wgt + e[ch]) / (1.0f + 4.0f * wgt);
+            out[ch] = v < 0.0f ? 0.0f : v;
+        }
+        out[3] = e[3];
+    }
+
+    inline void Sharpen(const float* src, uint32_t w, uint32_t h, float sharpness, float* dst) {
+        const float peak = Peak(sharpness);
+        for (uint32_t y = 0; y < h; ++y) {
+            for (uint32_t x = 0; x < w; ++x) {
+                SharpenTexel(src, w, h, static_cast<int32_t>(x), static_cast<int32_t>(y), peak,
+                             dst + (static_cast<size_t>(y) * w + x) * 4);
+            }
+        }
+    }
+
+    // The compute pass over one region of an RGBA float texture, group by
+    // group as shaders/Sharpen.hlsl runs it: each 8x8 group loads its 10x10
+    // block (apron included) with the region-clamped Fetch, then every
+    // thread filters from that block with the shader's arithmetic and
+    // stores if inside the region. Texels outside the region are untouched.
+    inline void SimulateDispatch(const float* src, uint32_t texWidth, uint32_t texHeight, uint32_t x0, uint32_t y0,
+                                 uint32_t width, uint32_t height, float sharpness, float* dst) {
+        constexpr uint32_t kTile = kGroupSize + 2;
+        (void)texHeight;
+        const float peak = Peak(sharpness);
+        float tile[kTile * kTile][4];
+        for (uint32_t gy = 0; gy < GroupCount(height); ++gy) {
+            for (uint32_t gx = 0; gx < GroupCount(width); ++gx) {
+                const int32_t originX = static_cast<int32_t>(gx * kGroupSize) - 1;
+                const int32_t originY = static_cast<int32_t>(gy * kGroupSize) - 1;
+                for (uint32_t index = 0; index < kGroupSize * kGroupSize; ++index) {
+                    for (uint32_t i = index; i < kTile * kTile; i += kGroupSize * kGroupSize) {
+                        int32_t tx = originX + static_cast<int32_t>(i % kTile);
+                        int32_t ty = originY + static_cast<int32_t>(i / kTile);
+                        tx = tx < 0 ? 0 : (tx > static_cast<int32_t>(width) - 1 ? static_cast<int32_t>(width) - 1 : tx);
+                        ty = ty < 0 ? 0 : (ty > static_cast<int32_t>(height) - 1 ? static_cast<int32_t>(height) - 1 : ty);
+                        const float* texel = src + ((static_cast<size_t>(y0) + ty) * texWidth + x0 + tx) * 4;
+                        for (int ch = 0; ch < 4; ++ch) tile[(i / kTile) * kTile + i % kTile][ch] = texel[ch];
+                    }
+                }
+                for (uint32_t ty = 0; ty < kGroupSize; ++ty) {
+                    for (uint32_t tx = 0; tx < kGroupSize; ++tx) {
+                        const uint32_t px = gx * kGroupSize + tx;
+                        const uint32_t py = gy * kGroupSize + ty;
+                        if (px >= width || py >= height) continue;
+                        const float* row0 = tile[ty * kTile + tx];
+                        const float* row1 = tile[(ty + 1) * kTile + tx];
+                        const float* row2 = tile[(ty + 2) * kTile + tx];
+                        float* out = dst + ((static_cast<size_t>(y0) + py) * texWidth + x0 + px) * 4;
+                        for (int ch = 0; ch < 3; ++ch) {
+                            const float a = row0[ch], b = row0[4 + ch], c = row0[8 + ch];
+                            const float d = row1[ch], e = row1[4 + ch], f = row1[8 + ch];
+                            const float g = row2[ch], h = row2[4 + ch], k = row2[8 + ch];
+                            const float mnCross = std::fmin(std::fmin(std::fmin(b, d), std::fmin(e, f)), h);
+                            const float mxCross = std::fmax(std::fmax(std::fmax(b, d), std::fmax(e, f)), h);
+                            const float mn = mnCross + std::fmin(mnCross, std::fmin(std::fmin(a, c), std::fmin(g, k)));
+                            const float mx = mxCross + std::fmax(mxCross, std::fmax(std::fmax(a, c), std::fmax(g, k)));
+                            const float amp = mx > 0.0f ? std::sqrt(Clamp01(std::fmin(mn, 2.0f - mx) / std::fmax(mx, 1e-20f))) : 0.0f;
+                            const float w = amp * peak;
+                            out[ch] = std::fmax(((b + d + f + h) * w + e) / (1.0f + 4.0f * w), 0.0f);
+                        }
+                        out[3] = row1[4 + 3];
+                    }
+                }
+            }
+        }
+    }
+
+#if DLSS_SHARPEN_SSE
+    // Same arithmetic with one RGBA texel per SSE register; used to check
+    // results against captured frames without a GPU. Results match Sharpen
+    // to within float rounding of the division.
+    inline void SharpenSSE(const float* src, uint32_t w, uint32_t h, float sharpness, float* dst) {
+        const __m128 peak = _mm_set1_ps(Peak(sharpness));
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 four = _mm_set1_ps(4.0f);
+        for (uint32_t y = 0; y < h; ++y) {
+            const int32_t yi = static_cast<int32_t>(y);
+            for (uint32_t x = 0; x < w; ++x) {
+                const int32_t xi = static_cast<int32_t>(x);
+                const __m128 a = _mm_loadu_ps(Texel(src, w, h, xi - 1, yi - 1));
+                const __m128 b = _mm_loadu_ps(Texel(src, w, h, xi,     yi - 1));
+                const __m128 c = _mm_loadu_ps(Texel(src, w, h, xi + 1, yi - 1));
+                const __m128 d = _mm_loadu_ps(Texel(src, w, h, xi - 1, yi));
+                const __m128 e = _mm_loadu_ps(Texel(src, w, h, xi,     yi));
+                const __m128 f = _mm_loadu_ps(Texel(src, w, h, xi + 1, yi));
+                const __m128 g = _mm_loadu_ps(Texel(src, w, h, xi - 1, yi + 1));
+                const __m128 hh = _mm_loadu_ps(Texel(src, w, h, xi,    yi + 1));
+                const __m128 i = _mm_loadu_ps(Texel(src, w, h, xi + 1, yi + 1));
+
+                const __m128 mnCross = _mm_min_ps(_mm_min_ps(_mm_min_ps(b, d), _mm_min_ps(e, f)), hh);
+                const __m128 mxCross = _mm_max_ps(_mm_max_ps(_mm_max_ps(b, d), _mm_max_ps(e, f)), hh);
+                const __m128 mnRing = _mm_min_ps(mnCross, _mm_min_ps(_mm_min_ps(a, c), _mm_min_ps(g, i)));
+                const __m128 mxRing = _mm_max_ps(mxCross, _mm_max_ps(_mm_max_ps(a, c), _mm_max_ps(g, i)));
+                const __m128 mn = _mm_add_ps(mnCross, mnRing);
+                const __m128 mx = _mm_add_ps(mxCross, mxRing);
+
+                // mx <= 0 gives amp 0 (the division result is masked off)
+                const __m128 positive = _mm_cmpgt_ps(mx, zero);
+                const __m128 denom = _mm_or_ps(_mm_and_ps(positive, mx), _mm_andnot_ps(positive, one));
+                __m128 amp = _mm_div_ps(_mm_min_ps(mn, _mm_sub_ps(two, mx)), denom);
+                amp = _mm_sqrt_ps(_mm_min_ps(_mm_max_ps(amp, zero), one));
+                amp = _mm_and_ps(amp, positive);
+                const __m128 wgt = _mm_mul_ps(amp, peak);
+
+                const __m128 cross = _mm_add_ps(_mm_add_ps(b, d), _mm_add_ps(f, hh));
+                __m128 v = _mm_div_ps(_mm_add_ps(_mm_mul_ps(cross, wgt), e), _mm_add_ps(one, _mm_mul_ps(four, wgt)));
+                v = _mm_max_ps(v, zero);
+
+                float* o = dst + (static_cast<size_t>(y) * w + x) * 4;
+                _mm_storeu_ps(o, v);
+                o[3] = src[(static_cast<size_t>(y) * w + x) * 4 + 3];  // alpha from the centre
+            }
+        }
+    }
+#endif
+}
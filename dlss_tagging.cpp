@@ -0,0 +1,20 @@
+#include "dlss_tagging.h"
+
+#include <d3d11.h>
+
+namespace DLSSTagging {
+
+    DeviceCaps QueryDeviceCaps(ID3D11Device* device) {
+        DeviceCaps caps;
+        if (!device) return caps;
+        UINT support = 0;
+        D3D11_FEATURE_DATA_FORMAT_SUPPORT2 support2{};
+        support2.InFormat = DXGI_FORMAT_B8G8R8A8_UNORM;
+        caps.bgraTypedStore =
+            SUCCEEDED(device->CheckFormatSupport(DXGI_FORMAT_B8G8R8A8_UNORM, &support)) &&
+            (support & D3D11_FORMAT_SUPPORT_TYPED_UNORDERED_ACCESS_VIEW) != 0 &&
+            SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_FORMAT_SUPPORT2, &support2, sizeof(support2))) &&
+            (support2.OutFormatSupport2 & D3D11_FORMAT_SUPPORT2_UAV_TYPED_STORE) != 0;
+        return caps;
+    }
+}
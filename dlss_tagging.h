@@ -0,0 +1,293 @@
+#pragma once
+#include <cstdint>
+
+#include "dlss_vram.h"
+
+// Resource compatibility for Streamline color tags. Decides, once per
+// texture, whether DLSS can read the input color (or write the output)
+// straight from the texture through an sl::Extent subrect, or whether a
+// scratch copy (or an MSAA resolve) is needed, and what that costs per
+// frame. Decisions are cached by texture pointer and description.
+//
+// Platform-free: formats, usages and bind flags are the D3D11/DXGI values
+// as integers; dlss_tagging.cpp queries the device caps.
+struct ID3D11Device;
+
+namespace DLSSTagging {
+
+    // D3D11_BIND_* and D3D11_USAGE values used by the rules
+    namespace Bind {
+        constexpr uint32_t ShaderResource = 0x8;
+        constexpr uint32_t RenderTarget = 0x20;
+        constexpr uint32_t DepthStencil = 0x40;
+        constexpr uint32_t UnorderedAccess = 0x80;
+    }
+    namespace Usage {
+        constexpr uint32_t Default = 0, Immutable = 1, Dynamic = 2, Staging = 3;
+    }
+
+    // Optional format support of the device. Typed UAV stores to the
+    // B8G8R8A8 formats are optional in D3D11 (D3D11_FORMAT_SUPPORT2_UAV_TYPED_STORE);
+    // every other store format below is required at feature level 11_0.
+    struct DeviceCaps {
+        bool bgraTypedStore = false;
+
+        bool operator==(const DeviceCaps& o) const { return bgraTypedStore == o.bgraTypedStore; }
+        bool operator!=(const DeviceCaps& o) const { return !(*this == o); }
+    };
+
+    // What DLSS can do with a color format
+    struct FormatCaps {
+        uint32_t view = 0;      // typed format to tag (typeless resolved), 0 = not a DLSS color format
+        bool store = false;     // typed UAV stores on the view format
+        uint32_t storeAs = 0;   // copy-compatible format with UAV stores for an output scratch, 0 = none
+    };
+
+    constexpr FormatCaps MakeCaps(uint32_t view, bool store, uint32_t storeAs) {
+        FormatCaps c{};
+        c.view = view;
+        c.store = store;
+        c.storeAs = storeAs;
+        return c;
+    }
+
+    constexpr FormatCaps GetFormatCaps(uint32_t format, const DeviceCaps& device = DeviceCaps{}) {
+        const bool bgra = device.bgraTypedStore;
+        switch (format) {
+            case 1: case 2: return MakeCaps(2, true, 2);        // R32G32B32A32_TYPELESS/FLOAT
+            case 9: case 10: return MakeCaps(10, true, 10);     // R16G16B16A16_TYPELESS/FLOAT
+            case 11: return MakeCaps(11, true, 11);             // R16G16B16A16_UNORM
+            case 23: case 24: return MakeCaps(24, true, 24);    // R10G10B10A2_TYPELESS/UNORM
+            case 26: return MakeCaps(26, true, 26);             // R11G11B10_FLOAT
+            case 27: case 28: return MakeCaps(28, true, 28);    // R8G8B8A8_TYPELESS/UNORM
+            case 29: return MakeCaps(29, false, 28);            // R8G8B8A8_UNORM_SRGB
+            case 67: return MakeCaps(67, false, 0);             // R9G9B9E5_SHAREDEXP (read only)
+            case 87: case 90: return MakeCaps(87, bgra, bgra ? 87 : 0);  // B8G8R8A8_UNORM/TYPELESS
+            case 91: return MakeCaps(91, false, bgra ? 87 : 0);          // B8G8R8A8_UNORM_SRGB
+            case 88: case 92: return MakeCaps(88, false, 0);    // B8G8R8X8_UNORM/TYPELESS
+            case 93: return MakeCaps(93, false, 0);             // B8G8R8X8_UNORM_SRGB
+            default: return FormatCaps{};                       // depth, integer, compressed, video
+        }
+    }
+
+    // Format for a texture the plugin creates as a DLSS output (typed UAV
+    // stores required): the B8G8R8A8 formats fall back to their R8G8B8A8
+    // counterparts when the device cannot store to them. The compositor
+    // takes either; only the channel order in memory differs.
+    constexpr uint32_t OutputFormat(uint32_t format, const DeviceCaps& device) {
+        if (device.bgraTypedStore) return format;
+        switch (format) {
+            case 87: return 28;  // B8G8R8A8_UNORM -> R8G8B8A8_UNORM
+            case 90: return 27;  // B8G8R8A8_TYPELESS -> R8G8B8A8_TYPELESS
+            case 91: return 29;  // B8G8R8A8_UNORM_SRGB -> R8G8B8A8_UNORM_SRGB
+            default: return format;
+        }
+    }
+
+    // Device caps of the D3D11 device (dlss_tagging.cpp)
+    DeviceCaps QueryDeviceCaps(ID3D11Device* device);
+
+    struct TextureInfo {
+        uint32_t format = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t sampleCount = 1;
+        uint32_t usage = Usage::Default;
+        uint32_t bindFlags = 0;
+
+        bool operator==(const TextureInfo& o) const {
+            return format == o.format && width == o.width && height == o.height && sampleCount == o.sampleCount &&
+                   usage == o.usage && bindFlags == o.bindFlags;
+        }
+    };
+
+    struct Rect {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        bool operator==(const Rect& o) const {
+            return x == o.x && y == o.y && width == o.width && height == o.height;
+        }
+    };
+
+    enum class Role : uint8_t { Input = 0, Output };
+
+    enum class Action : uint8_t {
+        Direct = 0,    // tag the texture itself with the extent
+        Copy,          // input: copy the extent into a scratch; output: write a scratch, copy it back
+        Resolve,       // input: resolve the MSAA texture into a scratch of the same size
+        Unsupported    // DLSS cannot use this texture
+    };
+
+    constexpr const char* ActionName(Action action) {
+        switch (action) {
+            case Action::Direct: return "direct";
+            case Action::Copy: return "copy";
+            case Action::Resolve: return "resolve";
+            default: return "unsupported";
+        }
+    }
+
+    struct Decision {
+        Action action = Action::Unsupported;
+        uint32_t tagFormat = 0;      // format of the tagged resource (typed)
+        uint32_t scratchWidth = 0;   // Copy/Resolve: scratch size and format
+        uint32_t scratchHeight = 0;
+        uint32_t scratchFormat = 0;
+        Rect area;                   // wanted area clipped to the texture
+        Rect extent;                 // tag extent on the tagged resource (texture or scratch)
+        uint64_t bytesPerFrame = 0;  // copy/resolve traffic per evaluation
+    };
+
+    // Wanted area clipped to the texture; an empty rect means the whole texture
+    constexpr Rect ClipRect(const TextureInfo& tex, Rect wanted) {
+        if (wanted.width == 0 || wanted.height == 0) {
+            wanted.x = wanted.y = 0;
+            wanted.width = tex.width;
+            wanted.height = tex.height;
+        }
+        if (wanted.x >= tex.width || wanted.y >= tex.height) return Rect{};
+        if (wanted.width > tex.width - wanted.x) wanted.width = tex.width - wanted.x;
+        if (wanted.height > tex.height - wanted.y) wanted.height = tex.height - wanted.y;
+        return wanted;
+    }
+
+    constexpr Decision Analyze(const TextureInfo& tex, Role role, Rect wanted, const DeviceCaps& device = DeviceCaps{}) {
+        Decision d{};
+        const FormatCaps caps = GetFormatCaps(tex.format, device);
+        const Rect area = ClipRect(tex, wanted);
+        if (caps.view == 0 || area.width == 0 || area.height == 0 || tex.sampleCount == 0) return d;
+        d.area = area;
+
+        if (role == Role::Input) {
+            const bool readable = (tex.bindFlags & Bind::ShaderResource) != 0 && tex.usage != Usage::Staging;
+            if (tex.sampleCount > 1) {
+                // DLSS reads single-sampled textures; a resolve keeps the texture size
+                d.action = Action::Resolve;
+                d.tagFormat = d.scratchFormat = caps.view;
+                d.scratchWidth = tex.width;
+                d.scratchHeight = tex.height;
+                d.extent = area;
+                d.bytesPerFrame = DLSSVram::SurfaceBytes(caps.view, tex.width, tex.height);
+                return d;
+            }
+            d.tagFormat = caps.view;
+            if (readable) {
+                d.action = Action::Direct;
+                d.extent = area;
+                return d;
+            }
+            d.action = Action::Copy;
+            d.scratchFormat = caps.view;
+            d.scratchWidth = area.width;
+            d.scratchHeight = area.height;
+            d.extent = Rect{0, 0, area.width, area.height};
+            d.bytesPerFrame = DLSSVram::SurfaceBytes(caps.view, area.width, area.height);
+            return d;
+        }
+
+        // Output: the copy back needs a DEFAULT or STAGING single-sampled destination
+        if (tex.sampleCount > 1 || tex.usage == Usage::Dynamic || tex.usage == Usage::Immutable) return d;
+        if (caps.store && tex.usage == Usage::Default && (tex.bindFlags & Bind::UnorderedAccess) != 0) {
+            d.action = Action::Direct;
+            d.tagFormat = caps.view;
+            d.extent = area;
+            return d;
+        }
+        if (caps.storeAs == 0) return d;
+        d.action = Action::Copy;
+        d.tagFormat = d.scratchFormat = caps.storeAs;
+        d.scratchWidth = area.width;
+        d.scratchHeight = area.height;
+        d.extent = Rect{0, 0, area.width, area.height};
+        d.bytesPerFrame = DLSSVram::SurfaceBytes(caps.storeAs, area.width, area.height);
+        return d;
+    }
+
+    // What a persistent tag slot was built from. A texture is identified by
+    // its pointer and a creation serial: a texture released and another
+    // created at the same address (ABA) carries a new serial.
+    struct SlotKey {
+        const void* texture = nullptr;
+        uint64_t serial = 0;
+        uint32_t width = 0;   // requested extent
+        uint32_t height = 0;
+
+        constexpr bool operator==(const SlotKey& o) const {
+            return texture == o.texture && serial == o.serial && width == o.width && height == o.height;
+        }
+        constexpr bool operator!=(const SlotKey& o) const { return !(*this == o); }
+    };
+
+    // Stores key in the slot; true when the slot must be rebuilt
+    inline bool UpdateSlot(SlotKey& slot, const SlotKey& key) {
+        if (slot == key) return false;
+        slot = key;
+        return true;
+    }
+
+    // Last decisions by texture pointer; a changed description or extent
+    // (or a pointer reused for a new texture) re-runs Analyze
+    class DecisionCache {
+    public:
+        static constexpr int kEntries = 8;
+
+        // New caps drop every cached decision
+        void SetDeviceCaps(const DeviceCaps& device) {
+            if (device == m_device) return;
+            m_device = device;
+            Clear();
+        }
+        const DeviceCaps& GetDeviceCaps() const { return m_device; }
+
+        // analyzed (optional) is set when this call ran Analyze
+        const Decision& Get(const void* texture, const TextureInfo& info, Role role, const Rect& wanted, bool* analyzed = nullptr) {
+            ++m_tick;
+            if (analyzed) *analyzed = false;
+            int victim = 0;
+            for (int i = 0; i < kEntries; ++i) {
+                Entry& e = m_entries[i];
+                if (e.texture == texture && e.role == role && e.info == info && e.wanted == wanted) {
+                    e.lastUse = m_tick;
+                    ++m_hits;
+                    return e.decision;
+                }
+                if (e.lastUse < m_entries[victim].lastUse) victim = i;
+            }
+            Entry& e = m_entries[victim];
+            e.texture = texture;
+            e.info = info;
+            e.role = role;
+            e.wanted = wanted;
+            e.decision = Analyze(info, role, wanted, m_device);
+            e.lastUse = m_tick;
+            ++m_misses;
+            if (analyzed) *analyzed = true;
+            return e.decision;
+        }
+
+        void Clear() {
+            for (Entry& e : m_entries) e = Entry{};
+        }
+
+        uint64_t Hits() const { return m_hits; }
+        uint64_t Misses() const { return m_misses; }
+
+    private:
+        struct Entry {
+            const void* texture = nullptr;
+            TextureInfo info;
+            Role role = Role::Input;
+            Rect wanted;
+            Decision decision;
+            uint64_t lastUse = 0;
+        };
+        Entry m_entries[kEntries];
+        DeviceCaps m_device;
+        uint64_t m_tick = 0;
+        uint64_t m_hits = 0;
+        uint64_t m_misses = 0;
+    };
+}
@@ -0,0 +1,114 @@
+#include "dlss_telemetry.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <new>
+
+namespace DLSSTelemetry {
+
+#ifdef _WIN32
+    const char* const kChannelName = "Local\\F4SEVR_DLSS_Telemetry";
+
+    bool Channel::Create(const char* name) {
+        Close();
+        HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+                                            static_cast<DWORD>(sizeof(SharedBlock)), name);
+        if (!mapping) return false;
+        void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedBlock));
+        if (!view) {
+            CloseHandle(mapping);
+            return false;
+        }
+        m_handle = mapping;
+        m_block = new (view) SharedBlock;
+        m_owner = true;
+        InitBlock(*m_block, static_cast<uint32_t>(GetCurrentProcessId()));
+        return true;
+    }
+
+    bool Channel::Open(const char* name) {
+        Close();
+        HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name);
+        if (!mapping) return false;
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(SharedBlock));
+        if (!view) {
+            CloseHandle(mapping);
+            return false;
+        }
+        m_handle = mapping;
+        m_block = static_cast<SharedBlock*>(view);
+        m_owner = false;
+        return true;
+    }
+
+    void Channel::Close() {
+        if (m_block) {
+            UnmapViewOfFile(m_block);
+            m_block = nullptr;
+        }
+        if (m_handle) {
+            CloseHandle(static_cast<HANDLE>(m_handle));
+            m_handle = nullptr;
+        }
+        m_owner = false;
+    }
+#else
+    const char* const kChannelName = "/f4sevr_dlss_telemetry";
+
+    bool Channel::Create(const char* name) {
+        Close();
+        const int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+        if (fd < 0) return false;
+        if (ftruncate(fd, static_cast<off_t>(sizeof(SharedBlock))) != 0) {
+            close(fd);
+            return false;
+        }
+        void* view = mmap(nullptr, sizeof(SharedBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED) return false;
+        m_block = new (view) SharedBlock;
+        m_owner = true;
+        std::snprintf(m_name, sizeof(m_name), "%s", name);
+        InitBlock(*m_block, static_cast<uint32_t>(getpid()));
+        return true;
+    }
+
+    bool Channel::Open(const char* name) {
+        Close();
+        const int fd = shm_open(name, O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SharedBlock)) {
+            close(fd);
+            return false;
+        }
+        void* view = mmap(nullptr, sizeof(SharedBlock), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED) return false;
+        m_block = static_cast<SharedBlock*>(view);
+        m_owner = false;
+        return true;
+    }
+
+    void Channel::Close() {
+        if (m_block) {
+            munmap(m_block, sizeof(SharedBlock));
+            m_block = nullptr;
+        }
+        // The writer removes the name; readers still mapped keep their view
+        if (m_owner && m_name[0]) {
+            shm_unlink(m_name);
+        }
+        m_name[0] = '\0';
+        m_owner = false;
+    }
+#endif
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Live telemetry for external monitors. The plugin publishes one Payload per
+// Present into a named shared-memory block; readers (tools/telemetry_reader)
+// map the same block read-only and copy it out under a sequence lock, so the
+// writer never waits on a reader and a reader never sees a half-written frame.
+//
+// The block is stored as 32-bit atomics and copied word by word, which keeps
+// the seqlock free of data races across processes. Bump kVersion whenever
+// Payload changes; readers refuse blocks of another version.
+namespace DLSSTelemetry {
+
+    constexpr uint32_t kMagic = 0x54534C44;  // "DLST"
+    constexpr uint32_t kVersion = 6;
+
+    // Windows: "Local\F4SEVR_DLSS_Telemetry"; POSIX: "/f4sevr_dlss_telemetry"
+    extern const char* const kChannelName;
+
+    // Mirrors DlssState in dlss_hooks.cpp
+    enum class State : uint32_t { Cold = 0, HaveCompositor, HaveSwapChain, HaveDlss, Ready };
+    enum class Backend : uint32_t { None = 0, NGX, Streamline };
+
+    struct EyePayload {
+        uint32_t renderWidth;
+        uint32_t renderHeight;
+        uint32_t outputWidth;
+        uint32_t outputHeight;
+        uint64_t evaluations;   // successful upscales
+        uint64_t resets;        // evaluations that reset the history
+        float processMs;        // CPU time of the eye's ProcessEye, smoothed
+        uint32_t copiedKB;      // backend scratch copies of the last evaluate
+        float submitMs;         // backend submission CPU time, smoothed
+        uint32_t resetReasons;  // DLSSHistory::Reason bits of the last history reset
+        float gpuMs;            // GPU time of the eye's ProcessEye, smoothed
+        uint32_t quality;       // the eye's DLSSManager::Quality (per-eye override or global)
+    };
+
+    struct Payload {
+        uint64_t frame;             // Present count
+        double writerTimeMs;        // writer's monotonic clock at publish
+        uint32_t state;             // State
+        uint32_t backend;           // Backend
+        uint32_t quality;           // DLSSManager::Quality, global level
+        uint32_t enabled;
+        EyePayload eyes[2];
+
+        // Last runtime bring-up, milliseconds
+        float initLoadMs;
+        float initResolveMs;
+        float initShadersMs;
+        float initDeviceMs;
+
+        // Per-frame stages
+        float downscaleGpuMs;
+        float presentP50Ms;
+        float presentP99Ms;
+        float overBudgetPercent;
+
+        // Allocation and event counters since load
+        uint64_t textureCreates;
+        uint64_t featureCreates;
+        uint64_t hitches;
+
+        // Plugin-owned VRAM (DLSSVram), bytes
+        uint64_t vramBytes;
+        uint64_t vramPeakBytes;
+        uint64_t vramBudgetBytes;   // 0: no budget
+    };
+    static_assert(sizeof(Payload) % sizeof(uint32_t) == 0, "Payload is copied in 32-bit words");
+
+    constexpr size_t kPayloadWords = sizeof(Payload) / sizeof(uint32_t);
+
+    struct SharedBlock {
+        std::atomic<uint32_t> magic;      // set last, once the header is valid
+        uint32_t version;
+        uint32_t payloadSize;
+        uint32_t writerPid;
+        std::atomic<uint32_t> sequence;  // odd while a write is in progress
+        uint32_t pad[3];
+        std::atomic<uint32_t> words[kPayloadWords];
+    };
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+
+    inline void InitBlock(SharedBlock& block, uint32_t writerPid) {
+        block.sequence.store(0, std::memory_order_relaxed);
+        for (std::atomic<uint32_t>& w : block.words) w.store(0, std::memory_order_relaxed);
+        block.payloadSize = static_cast<uint32_t>(sizeof(Payload));
+        block.writerPid = writerPid;
+        block.version = kVersion;
+        block.magic.store(kMagic, std::memory_order_release);
+    }
+
+    // Single writer
+    inline void Publish(SharedBlock& block, const Payload& payload) {
+        uint32_t src[kPayloadWords];
+        std::memcpy(src, &payload, sizeof(Payload));
+        const uint32_t seq = block.sequence.load(std::memory_order_relaxed);
+        block.sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kPayloadWords; ++i) {
+            block.words[i].store(src[i], std::memory_order_relaxed);
+        }
+        block.sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    inline bool IsCompatible(const SharedBlock& block) {
+        return block.magic.load(std::memory_order_acquire) == kMagic && block.version == kVersion && block.payloadSize == sizeof(Payload);
+    }
+
+    // One attempt; false when the writer was mid-update (or the block is
+    // not a compatible channel)
+    inline bool TryRead(const SharedBlock& block, Payload& out) {
+        if (!IsCompatible(block)) return false;
+        const uint32_t before = block.sequence.load(std::memory_order_acquire);
+        if (before & 1u) return false;
+        uint32_t dst[kPayloadWords];
+        for (size_t i = 0; i < kPayloadWords; ++i) {
+            dst[i] = block.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (block.sequence.load(std::memory_order_relaxed) != before) return false;
+        std::memcpy(&out, dst, sizeof(Payload));
+        return true;
+    }
+
+    inline bool Read(const SharedBlock& block, Payload& out, int attempts = 64) {
+        for (int i = 0; i < attempts; ++i) {
+            if (TryRead(block, out)) return true;
+        }
+        return false;
+    }
+
+    // Named mapping of one SharedBlock. The writer creates it, readers open
+    // it; dlss_telemetry.cpp implements it with CreateFileMapping on Windows
+    // and shm_open elsewhere.
+    class Channel {
+    public:
+        Channel() = default;
+        ~Channel() { Close(); }
+        Channel(const Channel&) = delete;
+        Channel& operator=(const Channel&) = delete;
+
+        bool Create(const char* name = kChannelName);  // writer: create (or reuse) and initialise
+        bool Open(const char* name = kChannelName);    // reader: map an existing block
+        void Close();
+
+        SharedBlock* Block() const { return m_block; }
+        bool IsOwner() const { return m_owner; }
+
+    private:
+        SharedBlock* m_block = nullptr;
+        void* m_handle = nullptr;  // Windows mapping handle
+        bool m_owner = false;
+        char m_name[64] = {};
+    };
+}
@@ -0,0 +1,35 @@
+#include "dlss_vram.h"
+
+#include <d3d11.h>
+
+namespace DLSSVram {
+
+    void TrackTexture(ID3D11Texture2D* texture, Pool pool) {
+        if (!texture) return;
+        D3D11_TEXTURE2D_DESC desc{};
+        texture->GetDesc(&desc);
+        Global().Track(texture, pool, TextureBytes(static_cast<uint32_t>(desc.Format), desc.Width, desc.Height,
+                                                   desc.MipLevels, desc.ArraySize, desc.SampleDesc.Count));
+    }
+
+    void TrackBuffer(ID3D11Buffer* buffer, Pool pool) {
+        if (!buffer) return;
+        D3D11_BUFFER_DESC desc{};
+        buffer->GetDesc(&desc);
+        Global().Track(buffer, pool, desc.ByteWidth);
+    }
+
+    void ReleaseTexture(ID3D11Texture2D*& texture) {
+        if (!texture) return;
+        Global().Untrack(texture);
+        texture->Release();
+        texture = nullptr;
+    }
+
+    void ReleaseBuffer(ID3D11Buffer*& buffer) {
+        if (!buffer) return;
+        Global().Untrack(buffer);
+        buffer->Release();
+        buffer = nullptr;
+    }
+}
@@ -0,0 +1,374 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+// VRAM accounting for every texture and buffer the plugin creates. Sizes are
+// computed from the resource description (format x extent x mips x slices x
+// samples), not queried from the driver, so they are a lower bound: row and
+// placement alignment are not included. Allocations are grouped by pool with
+// current and peak values; an optional budget runs the registered trimmers
+// (idle caches first) when the plugin's total goes over it.
+//
+// Everything in this header is platform-free (formats are DXGI_FORMAT values
+// as integers); dlss_vram.cpp adds the D3D11 helpers.
+struct ID3D11Texture2D;
+struct ID3D11Buffer;
+
+namespace DLSSVram {
+
+    // ---- Format sizes ----------------------------------------------------
+
+    // How one subresource of a format is laid out in memory
+    struct FormatLayout {
+        enum class Kind : uint8_t {
+            Unknown = 0,  // DXGI_FORMAT_UNKNOWN and opaque formats: no size
+            Block,        // blockWidth x blockHeight texels per bytesPerBlock
+            Planar        // luma plane plus a subsampled chroma plane
+        };
+        Kind kind = Kind::Unknown;
+        uint8_t blockWidth = 1;
+        uint8_t blockHeight = 1;
+        uint8_t bytesPerBlock = 0;   // Block: bytes per block; Planar: bytes per luma sample
+        uint8_t chromaShiftX = 0;    // Planar: chroma plane width = ceil(w / 2^shift)
+        uint8_t chromaShiftY = 0;
+        uint8_t chromaBytes = 0;     // Planar: bytes per chroma position (all chroma planes)
+    };
+
+    constexpr FormatLayout MakeBlock(uint8_t width, uint8_t height, uint8_t bytes) {
+        FormatLayout l{};
+        l.kind = FormatLayout::Kind::Block;
+        l.blockWidth = width;
+        l.blockHeight = height;
+        l.bytesPerBlock = bytes;
+        return l;
+    }
+
+    constexpr FormatLayout MakePlanar(uint8_t lumaBytes, uint8_t shiftX, uint8_t shiftY, uint8_t chromaBytes) {
+        FormatLayout l{};
+        l.kind = FormatLayout::Kind::Planar;
+        l.bytesPerBlock = lumaBytes;
+        l.chromaShiftX = shiftX;
+        l.chromaShiftY = shiftY;
+        l.chromaBytes = chromaBytes;
+        return l;
+    }
+
+    // Covers every DXGI_FORMAT value up to DXGI_FORMAT_A4B4G4R4_UNORM (191)
+    constexpr FormatLayout GetFormatLayout(uint32_t format) {
+        if (format >= 1 && format <= 4) return MakeBlock(1, 1, 16);    // R32G32B32A32
+        if (format >= 5 && format <= 8) return MakeBlock(1, 1, 12);    // R32G32B32
+        if (format >= 9 && format <= 22) return MakeBlock(1, 1, 8);    // R16G16B16A16, R32G32, R32G8X24
+        if (format >= 23 && format <= 47) return MakeBlock(1, 1, 4);   // R10G10B10A2 .. X24_TYPELESS_G8_UINT
+        if (format >= 48 && format <= 59) return MakeBlock(1, 1, 2);   // R8G8, R16
+        if (format >= 60 && format <= 65) return MakeBlock(1, 1, 1);   // R8, A8
+        switch (format) {
+            case 66: return MakeBlock(8, 1, 1);                        // R1_UNORM
+            case 67: return MakeBlock(1, 1, 4);                        // R9G9B9E5_SHAREDEXP
+            case 68: case 69: return MakeBlock(2, 1, 4);               // R8G8_B8G8, G8R8_G8B8
+            case 70: case 71: case 72: return MakeBlock(4, 4, 8);      // BC1
+            case 73: case 74: case 75: return MakeBlock(4, 4, 16);     // BC2
+            case 76: case 77: case 78: return MakeBlock(4, 4, 16);     // BC3
+            case 79: case 80: case 81: return MakeBlock(4, 4, 8);      // BC4
+            case 82: case 83: case 84: return MakeBlock(4, 4, 16);     // BC5
+            case 85: case 86: return MakeBlock(1, 1, 2);               // B5G6R5, B5G5R5A1
+            case 87: case 88: case 89: case 90:
+            case 91: case 92: case 93: return MakeBlock(1, 1, 4);      // B8G8R8A8/X8, R10G10B10_XR_BIAS_A2
+            case 94: case 95: case 96: return MakeBlock(4, 4, 16);     // BC6H
+            case 97: case 98: case 99: return MakeBlock(4, 4, 16);     // BC7
+            case 100: case 101: return MakeBlock(1, 1, 4);             // AYUV, Y410
+            case 102: return MakeBlock(1, 1, 8);                       // Y416
+            case 103: return MakePlanar(1, 1, 1, 2);                   // NV12
+            case 104: case 105: return MakePlanar(2, 1, 1, 4);         // P010, P016
+            case 106: return MakePlanar(1, 1, 1, 2);                   // 420_OPAQUE
+            case 107: return MakeBlock(2, 1, 4);                       // YUY2
+            case 108: case 109: return MakeBlock(2, 1, 8);             // Y210, Y216
+            case 110: return MakePlanar(1, 2, 0, 2);                   // NV11
+            case 111: case 112: case 113: return MakeBlock(1, 1, 1);   // AI44, IA44, P8
+            case 114: case 115: return MakeBlock(1, 1, 2);             // A8P8, B4G4R4A4
+            case 130: return MakePlanar(1, 1, 0, 2);                   // P208
+            case 131: return MakePlanar(1, 0, 1, 2);                   // V208
+            case 132: return MakePlanar(1, 0, 0, 2);                   // V408
+            case 191: return MakeBlock(1, 1, 2);                       // A4B4G4R4
+            default: return FormatLayout{};                            // UNKNOWN, sampler-feedback opaque, gaps
+        }
+    }
+
+    // Bytes of one subresource of the given extent
+    constexpr uint64_t SurfaceBytes(uint32_t format, uint32_t width, uint32_t height) {
+        const FormatLayout l = GetFormatLayout(format);
+        if (l.kind == FormatLayout::Kind::Unknown || width == 0 || height == 0) return 0;
+        if (l.kind == FormatLayout::Kind::Planar) {
+            const uint64_t chromaW = (static_cast<uint64_t>(width) + (1u << l.chromaShiftX) - 1) >> l.chromaShiftX;
+            const uint64_t chromaH = (static_cast<uint64_t>(height) + (1u << l.chromaShiftY) - 1) >> l.chromaShiftY;
+            return static_cast<uint64_t>(width) * height * l.bytesPerBlock + chromaW * chromaH * l.chromaBytes;
+        }
+        const uint64_t blocksX = (static_cast<uint64_t>(width) + l.blockWidth - 1) / l.blockWidth;
+        const uint64_t blocksY = (static_cast<uint64_t>(height) + l.blockHeight - 1) / l.blockHeight;
+        return blocksX * blocksY * l.bytesPerBlock;
+    }
+
+    // Length of the full mip chain (what MipLevels = 0 creates)
+    constexpr uint32_t FullMipCount(uint32_t width, uint32_t height) {
+        uint32_t largest = width > height ? width : height;
+        uint32_t count = 1;
+        while (largest > 1) {
+            largest >>= 1;
+            ++count;
+        }
+        return count;
+    }
+
+    // Bytes of a 2D texture (array) with all its mips and samples
+    constexpr uint64_t TextureBytes(uint32_t format, uint32_t width, uint32_t height,
+                                    uint32_t mipLevels = 1, uint32_t arraySize = 1, uint32_t sampleCount = 1) {
+        const uint32_t mips = mipLevels ? (mipLevels < 32 ? mipLevels : 32) : FullMipCount(width, height);
+        uint64_t total = 0;
+        for (uint32_t mip = 0; mip < mips; ++mip) {
+            const uint32_t w = (width >> mip) ? (width >> mip) : 1;
+            const uint32_t h = (height >> mip) ? (height >> mip) : 1;
+            total += SurfaceBytes(format, w, h);
+        }
+        return total * (arraySize ? arraySize : 1) * (sampleCount ? sampleCount : 1);
+    }
+
+    // ---- Allocation tracking ---------------------------------------------
+
+    enum class Pool : uint8_t {
+        EyeOutput = 0,   // per-eye upscaled output submitted to the compositor
+        RenderColor,     // render-size color fed to DLSS (and its transient copies)
+        Sharpen,         // DLSS target read by the CAS pass
+        NgxScratch,      // NGX scratch buffer
+        SlScratch,       // Streamline scratch in/out
+        ZeroInputs,      // zero motion vectors and depth stand-ins
+        RedirectTwins,   // render-size twins of redirected scene targets
+        Constants,       // constant buffers
+        History,         // depth histogram buffers
+        Readback,        // GPU readback ring: staging copies and probe partials
+        Capture,         // frame capture staging copies
+        Count
+    };
+
+    constexpr const char* PoolName(Pool pool) {
+        switch (pool) {
+            case Pool::EyeOutput: return "Eye output";
+            case Pool::RenderColor: return "Render color";
+            case Pool::Sharpen: return "Sharpen";
+            case Pool::NgxScratch: return "NGX scratch";
+            case Pool::SlScratch: return "SL scratch";
+            case Pool::ZeroInputs: return "Zero inputs";
+            case Pool::RedirectTwins: return "Redirect twins";
+            case Pool::Constants: return "Constants";
+            case Pool::History: return "History";
+            case Pool::Readback: return "Readback";
+            case Pool::Capture: return "Capture";
+            default: return "?";
+        }
+    }
+
+    constexpr size_t kPoolCount = static_cast<size_t>(Pool::Count);
+
+    // Caches idle for this many frames may be dropped by a trimmer
+    constexpr uint64_t kIdleFrames = 90;
+    // Minimum frames between two trims, so a budget that cannot be met does
+    // not release and recreate the same resources every frame
+    constexpr uint64_t kTrimIntervalFrames = 120;
+
+    struct PoolStats {
+        uint64_t currentBytes = 0;
+        uint64_t peakBytes = 0;
+        uint32_t liveCount = 0;
+        uint64_t allocations = 0;  // since load
+    };
+
+    struct Snapshot {
+        PoolStats pools[kPoolCount];
+        uint64_t currentBytes = 0;
+        uint64_t peakBytes = 0;
+        uint64_t budgetBytes = 0;  // 0: no budget
+        uint64_t trims = 0;
+        uint64_t trimmedBytes = 0;
+    };
+
+    // Result of one EndFrame; bytes are the plugin total around the trim
+    struct TrimResult {
+        bool ran = false;
+        uint64_t beforeBytes = 0;
+        uint64_t afterBytes = 0;
+        uint64_t budgetBytes = 0;
+    };
+
+    // Releases what it can spare. frame is Tracker::Frame(); a resource last
+    // used before frame - kIdleFrames counts as idle.
+    using TrimFn = void (*)(void* user, uint64_t frame);
+
+    class Tracker {
+    public:
+        static constexpr int kMaxTrimmers = 4;
+
+        // Keyed by resource so Untrack needs no size; tracking the same key
+        // again replaces the old entry
+        void Track(const void* resource, Pool pool, uint64_t bytes) {
+            if (!resource || pool >= Pool::Count) return;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_live.find(resource);
+            if (it != m_live.end()) {
+                RemoveLocked(it->second);
+                m_live.erase(it);
+            }
+            m_live.emplace(resource, Entry{pool, bytes});
+            PoolStats& s = m_pools[static_cast<size_t>(pool)];
+            s.currentBytes += bytes;
+            ++s.liveCount;
+            ++s.allocations;
+            if (s.currentBytes > s.peakBytes) s.peakBytes = s.currentBytes;
+            m_currentBytes += bytes;
+            if (m_currentBytes > m_peakBytes) m_peakBytes = m_currentBytes;
+        }
+
+        // Call before the last Release: the pointer may be reused afterwards.
+        // Unknown resources are ignored.
+        void Untrack(const void* resource) {
+            if (!resource) return;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_live.find(resource);
+            if (it == m_live.end()) return;
+            RemoveLocked(it->second);
+            m_live.erase(it);
+        }
+
+        void SetBudgetBytes(uint64_t bytes) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_budgetBytes = bytes;
+        }
+
+        // Trimmers run in registration order until the total fits the budget
+        bool AddTrimmer(TrimFn fn, void* user) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (int i = 0; i < m_trimmerCount; ++i) {
+                if (m_trimmers[i].fn == fn && m_trimmers[i].user == user) return true;
+            }
+            if (!fn || m_trimmerCount >= kMaxTrimmers) return false;
+            m_trimmers[m_trimmerCount++] = {fn, user};
+            return true;
+        }
+
+        void RemoveTrimmer(TrimFn fn, void* user) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (int i = 0; i < m_trimmerCount; ++i) {
+                if (m_trimmers[i].fn == fn && m_trimmers[i].user == user) {
+                    for (int j = i + 1; j < m_trimmerCount; ++j) m_trimmers[j - 1] = m_trimmers[j];
+                    --m_trimmerCount;
+                    return;
+                }
+            }
+        }
+
+        // Render-thread frame counter used for idle checks
+        uint64_t Frame() const { return m_frame.load(std::memory_order_relaxed); }
+
+        // Once per Present on the render thread: advance the frame and trim
+        // when over budget (at most every kTrimIntervalFrames). Trimmers are
+        // called without the lock held so they can Untrack.
+        TrimResult EndFrame() {
+            TrimResult result;
+            const uint64_t frame = m_frame.fetch_add(1, std::memory_order_relaxed) + 1;
+            Trimmer trimmers[kMaxTrimmers];
+            int count = 0;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_budgetBytes == 0 || m_currentBytes <= m_budgetBytes) return result;
+                if (m_hasTrimmed && frame - m_lastTrimFrame < kTrimIntervalFrames) return result;
+                m_hasTrimmed = true;
+                m_lastTrimFrame = frame;
+                result.beforeBytes = m_currentBytes;
+                result.budgetBytes = m_budgetBytes;
+                count = m_trimmerCount;
+                for (int i = 0; i < count; ++i) trimmers[i] = m_trimmers[i];
+            }
+            for (int i = 0; i < count; ++i) {
+                trimmers[i].fn(trimmers[i].user, frame);
+                if (CurrentBytes() <= result.budgetBytes) break;
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            result.ran = true;
+            result.afterBytes = m_currentBytes;
+            ++m_trims;
+            if (result.beforeBytes > m_currentBytes) m_trimmedBytes += result.beforeBytes - m_currentBytes;
+            return result;
+        }
+
+        uint64_t CurrentBytes() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_currentBytes;
+        }
+
+        Snapshot Take() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Snapshot s;
+            for (size_t i = 0; i < kPoolCount; ++i) s.pools[i] = m_pools[i];
+            s.currentBytes = m_currentBytes;
+            s.peakBytes = m_peakBytes;
+            s.budgetBytes = m_budgetBytes;
+            s.trims = m_trims;
+            s.trimmedBytes = m_trimmedBytes;
+            return s;
+        }
+
+        // Peaks restart from the current values
+        void ResetPeaks() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (PoolStats& s : m_pools) s.peakBytes = s.currentBytes;
+            m_peakBytes = m_currentBytes;
+        }
+
+    private:
+        struct Entry {
+            Pool pool;
+            uint64_t bytes;
+        };
+        struct Trimmer {
+            TrimFn fn = nullptr;
+            void* user = nullptr;
+        };
+
+        void RemoveLocked(const Entry& e) {
+            PoolStats& s = m_pools[static_cast<size_t>(e.pool)];
+            s.currentBytes -= e.bytes;
+            --s.liveCount;
+            m_currentBytes -= e.bytes;
+        }
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<const void*, Entry> m_live;
+        PoolStats m_pools[kPoolCount];
+        uint64_t m_currentBytes = 0;
+        uint64_t m_peakBytes = 0;
+        uint64_t m_budgetBytes = 0;
+        Trimmer m_trimmers[kMaxTrimmers];
+        int m_trimmerCount = 0;
+        std::atomic<uint64_t> m_frame{0};
+        uint64_t m_lastTrimFrame = 0;
+        bool m_hasTrimmed = false;
+        uint64_t m_trims = 0;
+        uint64_t m_trimmedBytes = 0;
+    };
+
+    // Process-wide tracker shared by the manager, the backends and the hooks
+    inline Tracker& Global() {
+        static Tracker tracker;
+        return tracker;
+    }
+
+    // ---- D3D11 helpers (dlss_vram.cpp) -----------------------------------
+
+    // Track a freshly created resource under its described size
+    void TrackTexture(ID3D11Texture2D* texture, Pool pool);
+    void TrackBuffer(ID3D11Buffer* buffer, Pool pool);
+
+    // Untrack, Release and clear
+    void ReleaseTexture(ID3D11Texture2D*& texture);
+    void ReleaseBuffer(ID3D11Buffer*& buffer);
+}
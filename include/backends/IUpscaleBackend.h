@@ -1,11 +1,21 @@
 #pragma once
 
 #include <d3d11.h>
+#include <cstdint>
+
+#include "dlss_camera.h"
 
 class IUpscaleBackend {
 public:
     virtual ~IUpscaleBackend() = default;
 
+    // Device-independent setup (runtime load, capability probing) that may run
+    // on a worker thread before Init. Init must still work without it.
+    virtual bool Prepare(ID3D11Device* device) {
+        (void)device;
+        return true;
+    }
+
     virtual bool Init(ID3D11Device* device, ID3D11DeviceContext* context) = 0;
     virtual void Shutdown() = 0;
     virtual bool IsReady() const = 0;
@@ -13,6 +23,51 @@ public:
     virtual void SetQuality(int qualityEnum /* engine-specific */) = 0;
     virtual void SetSharpness(float value) = 0;
 
+    // Per-eye quality for asymmetric rendering (-1 = SetQuality's). Backends
+    // with one quality for both eyes can ignore it.
+    virtual void SetEyeQuality(int eyeIndex, int qualityEnum) {
+        (void)eyeIndex; (void)qualityEnum;
+    }
+
+    // Origin of the eye's output inside the next ProcessEye output target
+    // (stereo atlas). Backends that only write whole targets refuse a
+    // non-zero origin; the caller then keeps one output per eye.
+    virtual bool SetOutputOrigin(int eyeIndex, uint32_t x, uint32_t y) {
+        (void)eyeIndex;
+        return x == 0 && y == 0;
+    }
+
+    // Keep resource tags across frames and rebuild only what changed (on by
+    // default); off rebuilds every tag each frame, for A/B timing of submitMs
+    virtual void SetPersistentTags(bool enabled) {
+        (void)enabled;
+    }
+
+    // Per-eye camera matrices/jitter for the next ProcessEye call. Backends
+    // that do not consume camera data can ignore it.
+    virtual void SetCameraConstants(int eyeIndex, const DLSSCamera::EyeConstants& constants) {
+        (void)eyeIndex; (void)constants;
+    }
+
+    // VRAM budget trim: release per-eye resources (scratch copies, feature
+    // allocations) not used since the given DLSSVram frame
+    virtual void ReleaseIdleResources(uint64_t idleBefore) {
+        (void)idleBefore;
+    }
+
+    // Bytes the eye's last ProcessEye copied into scratch textures (inputs
+    // or outputs DLSS could not use directly)
+    virtual uint64_t LastCopyBytes(int eyeIndex) const {
+        (void)eyeIndex;
+        return 0;
+    }
+
+    // CPU time the eye's ProcessEye spends submitting to the runtime, smoothed
+    virtual float LastSubmitMs(int eyeIndex) const {
+        (void)eyeIndex;
+        return 0.0f;
+    }
+
     virtual ID3D11Texture2D* ProcessEye(ID3D11Texture2D* inputColor,
                                         ID3D11Texture2D* inputDepth,
                                         ID3D11Texture2D* inputMotionVectors,
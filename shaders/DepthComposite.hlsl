@@ -0,0 +1,17 @@
+// Writes a render-size depth twin back into its full-size depth target
+// (early DLSS redirect composite). Nearest texel: filtered depth would
+// invent surfaces along edges. Mirrors DLSSRedirect::CompositeSourceTexel.
+
+Texture2D<float> srcDepth : register(t0);
+
+cbuffer CompositeParams : register(b0) {   // DLSSRedirect::CompositeParams
+    uint2 srcSize;
+    uint2 dstSize;
+    uint stencilBit;
+    uint3 pad;
+};
+
+float main(float4 pos : SV_Position) : SV_Depth {
+    const uint2 texel = min(uint2(pos.xy) * srcSize / dstSize, srcSize - 1);
+    return srcDepth.Load(int3(texel, 0));
+}
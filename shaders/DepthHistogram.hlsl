@@ -0,0 +1,35 @@
+// Log-depth histogram of a sparse sample grid, read back a few frames late
+// by the history tracker to spot camera cuts. Mirrors the CPU reference in
+// dlss_history.h (DepthSampleCoord, DepthBin).
+
+#define GRID 64         // DLSSHistory::kDepthGrid
+#define GROUP 8         // DLSSHistory::kDepthGroupSize
+#define BINS 32         // DLSSHistory::kDepthBins
+#define OCTAVES 16.0    // DLSSHistory::kDepthOctaves
+
+Texture2D<float> depthTex : register(t0);
+RWByteAddressBuffer bins : register(u0);
+
+cbuffer DepthParams : register(b0) {
+    uint2 size;
+    uint inverted;
+    uint pad;
+};
+
+groupshared uint gsBins[BINS];
+
+[numthreads(GROUP, GROUP, 1)]
+void main(uint3 id : SV_DispatchThreadID, uint index : SV_GroupIndex) {
+    if (index < BINS) gsBins[index] = 0;
+    GroupMemoryBarrierWithGroupSync();
+
+    const uint2 texel = min((id.xy * 2 + 1) * size / (2 * GRID), size - 1);
+    const float d = depthTex.Load(int3(texel, 0));
+    const float k = clamp(inverted ? d : 1.0 - d, 1e-7, 1.0);
+    const uint bin = min((uint)(-log2(k) * (BINS / OCTAVES)), BINS - 1);
+    InterlockedAdd(gsBins[bin], 1);
+    GroupMemoryBarrierWithGroupSync();
+
+    // One global add per bin and group
+    if (index < BINS && gsBins[index] != 0) bins.InterlockedAdd(index * 4, gsBins[index]);
+}
@@ -0,0 +1,221 @@
+// Downscale/blit shaders, one permutation per FILTER x ENCODING x STEREO.
+// DOWNSCALE_CS=1 builds the tiled compute variant (mono only) instead of the
+// pixel shader. Kernel constants, tap placement and tiling mirror
+// dlss_downscale.h (CPU reference and tile simulator).
+
+#define FILTER_BOX 0
+#define FILTER_BILINEAR 1
+#define FILTER_CATMULLROM 2
+#define FILTER_LANCZOS 3
+
+#define ENCODING_LINEAR 0
+#define ENCODING_SRGB 1
+#define ENCODING_R11G11B10 2
+
+#ifndef FILTER
+#define FILTER FILTER_BILINEAR
+#endif
+#ifndef ENCODING
+#define ENCODING ENCODING_LINEAR
+#endif
+#ifndef STEREO
+#define STEREO 0
+#endif
+#ifndef DOWNSCALE_CS
+#define DOWNSCALE_CS 0
+#endif
+
+// FILTER_SUPPORT: kernel radius in kernel units (DLSSDownscale::Support);
+// FILTER_TAPS: source texels read per axis (DLSSDownscale::Taps)
+#if FILTER == FILTER_BOX
+#define FILTER_SUPPORT 0.5
+#define FILTER_TAPS 4
+#elif FILTER == FILTER_BILINEAR
+#define FILTER_SUPPORT 1.0
+#define FILTER_TAPS 2
+#else
+#define FILTER_SUPPORT 2.0
+#define FILTER_TAPS 8
+#endif
+
+Texture2D<float4> srcTex : register(t0);
+SamplerState samLinear : register(s0);
+
+cbuffer DownscaleParams : register(b0) {
+    float2 srcSize;
+    float2 ratio;        // src / dst per axis
+    float2 kernelScale;  // kernel stretch in source texels
+    float2 dstSize;
+};
+
+float3 SrgbToLinear(float3 c) {
+    return c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+}
+
+float3 LinearToSrgb(float3 c) {
+    c = saturate(c);
+    return c <= 0.0031308 ? c * 12.92 : 1.055 * pow(c, 1.0 / 2.4) - 0.055;
+}
+
+float Kernel(float x) {
+    x = abs(x);
+#if FILTER == FILTER_CATMULLROM
+    const float inner = (1.5 * x - 2.5) * x * x + 1.0;
+    const float outer = ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+    return x < 1.0 ? inner : (x < FILTER_SUPPORT ? outer : 0.0);
+#elif FILTER == FILTER_LANCZOS
+    const float pi = 3.14159265;
+    const float a = max(pi * x, 1e-5);
+    const float b = a / FILTER_SUPPORT;
+    return x < FILTER_SUPPORT ? (sin(a) / a) * (sin(b) / b) : 0.0;
+#else
+    return saturate(1.0 - x / FILTER_SUPPORT);  // tent: bilinear through Load
+#endif
+}
+
+// Weights of the FILTER_TAPS texels starting at 'first' around 'center'
+void Weights(float center, float scale, out int first, out float w[FILTER_TAPS]) {
+    first = (int)floor(center - 0.5) - FILTER_TAPS / 2 + 1;
+    float sum = 0.0;
+    [unroll]
+    for (int k = 0; k < FILTER_TAPS; ++k) {
+        const float i = (float)(first + k);
+#if FILTER == FILTER_BOX
+        const float r = FILTER_SUPPORT * scale;
+        w[k] = max(min(i + 1.0, center + r) - max(i, center - r), 0.0);
+#else
+        w[k] = Kernel((i + 0.5 - center) / scale);
+#endif
+        sum += w[k];
+    }
+    [unroll]
+    for (int n = 0; n < FILTER_TAPS; ++n) {
+        w[n] /= sum;
+    }
+}
+
+float4 Fetch(int2 texel) {
+    float4 c = srcTex.Load(int3(texel, 0));
+#if ENCODING == ENCODING_SRGB
+    c.rgb = SrgbToLinear(c.rgb);
+#endif
+    return c;
+}
+
+float4 Encode(float4 c) {
+#if ENCODING == ENCODING_SRGB
+    c.rgb = LinearToSrgb(c.rgb);
+    c.a = saturate(c.a);
+#elif ENCODING == ENCODING_R11G11B10
+    c = float4(max(c.rgb, 0.0), 1.0);
+#endif
+    return c;
+}
+
+#if DOWNSCALE_CS
+
+#define TILE 8          // DLSSDownscale::kTileSize
+#define TILE_SRC 32     // DLSSDownscale::kTileSource
+
+RWTexture2D<float4> dstTex : register(u0);
+
+groupshared float4 gsSrc[TILE_SRC][TILE_SRC];  // tile footprint + apron, 16 KB
+groupshared float4 gsRow[TILE_SRC][TILE];      // after the horizontal pass, 4 KB
+
+int FirstTap(float center) {
+    return (int)floor(center - 0.5) - FILTER_TAPS / 2 + 1;
+}
+
+[numthreads(TILE, TILE, 1)]
+void main(uint3 groupId : SV_GroupID, uint3 tid : SV_GroupThreadID, uint index : SV_GroupIndex) {
+    const uint2 tileOrigin = groupId.xy * TILE;
+    const int2 spanFirst = int2(FirstTap((tileOrigin.x + 0.5) * ratio.x), FirstTap((tileOrigin.y + 0.5) * ratio.y));
+    const int2 srcMax = int2(srcSize) - 1;
+
+    // Cooperative load of the whole block; edges replicate like the pixel shader
+    [unroll]
+    for (uint k = 0; k < (TILE_SRC * TILE_SRC) / (TILE * TILE); ++k) {
+        const uint i = index + k * TILE * TILE;
+        const uint2 local = uint2(i % TILE_SRC, i / TILE_SRC);
+        gsSrc[local.y][local.x] = Fetch(clamp(spanFirst + int2(local), int2(0, 0), srcMax));
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    // Horizontal: thread column tid.x filters rows tid.y, tid.y + 8, ...
+    const uint2 pixel = tileOrigin + tid.xy;
+    int fx;
+    float wx[FILTER_TAPS];
+    Weights((pixel.x + 0.5) * ratio.x, kernelScale.x, fx, wx);
+    // Clamped only for the idle threads of a partial tile; in-range pixels fit (see SimulateTiles)
+    const int lx = clamp(fx - spanFirst.x, 0, TILE_SRC - FILTER_TAPS);
+    [unroll]
+    for (uint r = 0; r < TILE_SRC / TILE; ++r) {
+        const uint row = tid.y + r * TILE;
+        float4 acc = 0.0;
+        [unroll]
+        for (int x = 0; x < FILTER_TAPS; ++x) {
+            acc += wx[x] * gsSrc[row][lx + x];
+        }
+        gsRow[row][tid.x] = acc;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    // Vertical
+    int fy;
+    float wy[FILTER_TAPS];
+    Weights((pixel.y + 0.5) * ratio.y, kernelScale.y, fy, wy);
+    const int ly = clamp(fy - spanFirst.y, 0, TILE_SRC - FILTER_TAPS);
+    float4 c = 0.0;
+    [unroll]
+    for (int y = 0; y < FILTER_TAPS; ++y) {
+        c += wy[y] * gsRow[ly + y][tid.x];
+    }
+    // Partial tiles at odd render sizes
+    if (pixel.x < (uint)dstSize.x && pixel.y < (uint)dstSize.y) {
+        dstTex[pixel] = Encode(c);
+    }
+}
+
+#else
+
+float4 main(float4 pos : SV_Position, float2 uv : TEX) : SV_Target {
+    // Readable texel columns: one eye in the side-by-side layout
+#if STEREO
+    const float eyeW = srcSize.x * 0.5;
+    const float lo = (pos.x * ratio.x >= eyeW) ? eyeW : 0.0;
+    const float hi = lo + eyeW - 1.0;
+#else
+    const float lo = 0.0;
+    const float hi = srcSize.x - 1.0;
+#endif
+
+#if FILTER == FILTER_BILINEAR && ENCODING != ENCODING_SRGB
+    // Hardware sample; clamp the centre half a texel inside the eye.
+    // sRGB data takes the Load path so the taps are decoded before blending.
+    const float2 src = float2(clamp(pos.x * ratio.x, lo + 0.5, hi + 0.5), pos.y * ratio.y);
+    float4 c = srcTex.SampleLevel(samLinear, src / srcSize, 0);
+#else
+    const float2 center = pos.xy * ratio;
+    int fx, fy;
+    float wx[FILTER_TAPS];
+    float wy[FILTER_TAPS];
+    Weights(center.x, kernelScale.x, fx, wx);
+    Weights(center.y, kernelScale.y, fy, wy);
+
+    float4 c = 0.0;
+    [unroll]
+    for (int y = 0; y < FILTER_TAPS; ++y) {
+        const int ty = clamp(fy + y, 0, (int)srcSize.y - 1);
+        float4 row = 0.0;
+        [unroll]
+        for (int x = 0; x < FILTER_TAPS; ++x) {
+            row += wx[x] * Fetch(int2(clamp(fx + x, (int)lo, (int)hi), ty));
+        }
+        c += wy[y] * row;
+    }
+#endif
+
+    return Encode(c);
+}
+
+#endif
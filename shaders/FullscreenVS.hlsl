@@ -0,0 +1,10 @@
+// Fullscreen triangle from SV_VertexID; no vertex buffer bound.
+struct VSOut { float4 pos:SV_Position; float2 uv:TEX; };
+
+VSOut main(uint id:SV_VertexID) {
+    float2 p = float2((id<<1)&2, id&2);
+    VSOut o;
+    o.pos = float4(p*float2(2,-2)+float2(-1,1),0,1);
+    o.uv = p; // no vertical flip; D3D texcoords origin at top-left
+    return o;
+}
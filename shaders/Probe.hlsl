@@ -0,0 +1,55 @@
+// Min/max/mean/non-finite of a sparse sample grid, reduced per thread group
+// and read back a few frames late through the readback ring (diagnostics).
+// Mirrors the CPU reference in dlss_readback.h (ProbeSampleCoord,
+// ProbeValue, BuildProbePartials).
+
+#define GRID 64         // DLSSReadback::kProbeGrid
+#define GROUP 8         // DLSSReadback::kProbeGroupSize
+#define GROUPS 8        // DLSSReadback::kProbeGroups
+#define THREADS (GROUP * GROUP)
+
+Texture2D<float4> source : register(t0);
+RWByteAddressBuffer partials : register(u0);
+
+cbuffer ProbeParams : register(b0) {
+    uint2 origin;   // region probed
+    uint2 size;
+    uint channel;   // 0 luma, 1 red, 2 length(rg)
+    uint3 pad;
+};
+
+groupshared float gsMin[THREADS];
+groupshared float gsMax[THREADS];
+groupshared float gsSum[THREADS];
+groupshared uint gsBad[THREADS];
+
+[numthreads(GROUP, GROUP, 1)]
+void main(uint3 id : SV_DispatchThreadID, uint3 group : SV_GroupID, uint index : SV_GroupIndex) {
+    const uint2 texel = origin + min((id.xy * 2 + 1) * size / (2 * GRID), size - 1);
+    const float4 c = source.Load(int3(texel, 0));
+    const float v = channel == 1 ? c.r : (channel == 2 ? length(c.rg) : dot(c.rgb, float3(0.2126, 0.7152, 0.0722)));
+    // Exponent bits below all-ones: neither NaN nor Inf. isnan/isinf may be
+    // folded away by the compiler's float optimisations; integer bits are not
+    const bool finite = (asuint(v) & 0x7FFFFFFF) < 0x7F800000;
+    gsMin[index] = finite ? v : 3.4e38;
+    gsMax[index] = finite ? v : -3.4e38;
+    gsSum[index] = finite ? v : 0.0;
+    gsBad[index] = finite ? 0 : 1;
+    GroupMemoryBarrierWithGroupSync();
+
+    [unroll]
+    for (uint stride = THREADS / 2; stride > 0; stride >>= 1) {
+        if (index < stride) {
+            gsMin[index] = min(gsMin[index], gsMin[index + stride]);
+            gsMax[index] = max(gsMax[index], gsMax[index + stride]);
+            gsSum[index] += gsSum[index + stride];
+            gsBad[index] += gsBad[index + stride];
+        }
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    if (index == 0) {
+        const uint g = group.y * GROUPS + group.x;
+        partials.Store4(g * 16, uint4(asuint(gsMin[0]), asuint(gsMax[0]), asuint(gsSum[0]), gsBad[0]));
+    }
+}
@@ -0,0 +1,93 @@
+// Contrast-adaptive sharpening fused with the copy of the upscaled eye into
+// the submitted texture; one permutation per ENCODING. Mirrors the CPU
+// reference in dlss_sharpen.h.
+
+#define ENCODING_LINEAR 0
+#define ENCODING_SRGB 1
+#define ENCODING_R11G11B10 2
+
+#ifndef ENCODING
+#define ENCODING ENCODING_LINEAR
+#endif
+
+#define GROUP 8     // DLSSSharpen::kGroupSize
+#define TILE 10     // group plus a one-texel apron
+
+Texture2D<float4> srcTex : register(t0);
+RWTexture2D<float4> dstTex : register(u0);
+
+cbuffer SharpenParams : register(b0) {
+    float2 size;    // region texels
+    float peak;     // DLSSSharpen::Peak(sharpness)
+    float pad;
+    uint2 offset;   // region origin (stereo atlas eye), both textures
+    uint2 pad2;
+};
+
+groupshared float4 gsTile[TILE][TILE];
+
+float3 SrgbToLinear(float3 c) {
+    return c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+}
+
+float3 LinearToSrgb(float3 c) {
+    c = saturate(c);
+    return c <= 0.0031308 ? c * 12.92 : 1.055 * pow(c, 1.0 / 2.4) - 0.055;
+}
+
+float4 Fetch(int2 texel) {
+    float4 c = srcTex.Load(int3(int2(offset) + clamp(texel, int2(0, 0), int2(size) - 1), 0));
+#if ENCODING == ENCODING_SRGB
+    c.rgb = SrgbToLinear(c.rgb);
+#endif
+    return c;
+}
+
+float4 Encode(float4 c) {
+#if ENCODING == ENCODING_SRGB
+    c.rgb = LinearToSrgb(c.rgb);
+    c.a = saturate(c.a);
+#elif ENCODING == ENCODING_R11G11B10
+    c.a = 1.0;
+#endif
+    return c;
+}
+
+[numthreads(GROUP, GROUP, 1)]
+void main(uint3 groupId : SV_GroupID, uint3 tid : SV_GroupThreadID, uint index : SV_GroupIndex) {
+    // Each source texel of the 10x10 block is read once per group
+    const int2 origin = int2(groupId.xy * GROUP) - 1;
+    for (uint i = index; i < TILE * TILE; i += GROUP * GROUP) {
+        gsTile[i / TILE][i % TILE] = Fetch(origin + int2(i % TILE, i / TILE));
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    // a b c
+    // d e f
+    // g h i
+    const uint2 t = tid.xy + 1;
+    const float3 a = gsTile[t.y - 1][t.x - 1].rgb;
+    const float3 b = gsTile[t.y - 1][t.x].rgb;
+    const float3 c = gsTile[t.y - 1][t.x + 1].rgb;
+    const float3 d = gsTile[t.y][t.x - 1].rgb;
+    const float4 e = gsTile[t.y][t.x];
+    const float3 f = gsTile[t.y][t.x + 1].rgb;
+    const float3 g = gsTile[t.y + 1][t.x - 1].rgb;
+    const float3 h = gsTile[t.y + 1][t.x].rgb;
+    const float3 k = gsTile[t.y + 1][t.x + 1].rgb;
+
+    // Soft min/max: cross plus the full 3x3 ring
+    const float3 mnCross = min(min(min(b, d), min(e.rgb, f)), h);
+    const float3 mxCross = max(max(max(b, d), max(e.rgb, f)), h);
+    const float3 mn = mnCross + min(mnCross, min(min(a, c), min(g, k)));
+    const float3 mx = mxCross + max(mxCross, max(max(a, c), max(g, k)));
+
+    const float3 amp = mx > 0.0 ? sqrt(saturate(min(mn, 2.0 - mx) / max(mx, 1e-20))) : 0.0;
+    const float3 w = amp * peak;
+    const float3 rgb = max(((b + d + f + h) * w + e.rgb) / (1.0 + 4.0 * w), 0.0);
+
+    const uint2 pixel = groupId.xy * GROUP + tid.xy;
+    if (pixel.x < (uint)size.x && pixel.y < (uint)size.y) {
+        dstTex[offset + pixel] = Encode(float4(rgb, e.a));
+    }
+}
@@ -0,0 +1,17 @@
+// Stencil half of the depth composite: one draw per stencil bit. The
+// pipeline writes 'stencilBit' (write mask, REPLACE with 0xFF) wherever the
+// twin has that bit set; the target's stencil was cleared to 0 first.
+
+Texture2D<uint2> srcStencil : register(t0);   // X24_TYPELESS_G8_UINT / X32_TYPELESS_G8X24_UINT
+
+cbuffer CompositeParams : register(b0) {   // DLSSRedirect::CompositeParams
+    uint2 srcSize;
+    uint2 dstSize;
+    uint stencilBit;
+    uint3 pad;
+};
+
+void main(float4 pos : SV_Position) {
+    const uint2 texel = min(uint2(pos.xy) * srcSize / dstSize, srcSize - 1);
+    if ((srcStencil.Load(int3(texel, 0)).y & stencilBit) == 0) discard;
+}
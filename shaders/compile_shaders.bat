@@ -0,0 +1,56 @@
+@echo off
+:: Compiles the internal shaders into C headers for embedding (DLSS_EMBEDDED_SHADERS).
+:: Usage: compile_shaders.bat <output dir>   (headers land in <output dir>\shaders\)
+:: Downscale permutations follow DLSSDownscale::PermutationIndex naming; DownscaleCS_*
+:: are the tiled compute variants, Sharpen_* the CAS pass per output encoding,
+:: DepthHistogram the history tracker's camera-cut probe, Probe the readback ring's
+:: min/max/mean reduction, Depth/StencilComposite the redirect's depth twin write-back.
+setlocal EnableDelayedExpansion
+
+if "%~1"=="" (
+    echo Usage: %~nx0 ^<output dir^>
+    exit /b 1
+)
+set "SRC=%~dp0"
+set "OUT=%~1\shaders"
+if not exist "%OUT%" mkdir "%OUT%"
+
+fxc.exe /nologo /O3 /T vs_5_0 /E main /Vn g_FullscreenVS /Fh "%OUT%\FullscreenVS.h" "%SRC%FullscreenVS.hlsl" >nul
+if errorlevel 1 exit /b 1
+
+set F=0
+for %%f in (Box Bilinear CatmullRom Lanczos) do (
+    set E=0
+    for %%e in (Linear SRGB R11G11B10) do (
+        set L=0
+        for %%l in (Mono Stereo) do (
+            fxc.exe /nologo /O3 /T ps_5_0 /E main /DFILTER=!F! /DENCODING=!E! /DSTEREO=!L! /Vn g_Downscale_%%f_%%e_%%l /Fh "%OUT%\Downscale_%%f_%%e_%%l.h" "%SRC%Downscale.hlsl" >nul
+            if errorlevel 1 exit /b 1
+            set /a L+=1
+        )
+        fxc.exe /nologo /O3 /T cs_5_0 /E main /DFILTER=!F! /DENCODING=!E! /DDOWNSCALE_CS=1 /Vn g_DownscaleCS_%%f_%%e /Fh "%OUT%\DownscaleCS_%%f_%%e.h" "%SRC%Downscale.hlsl" >nul
+        if errorlevel 1 exit /b 1
+        set /a E+=1
+    )
+    set /a F+=1
+)
+
+set E=0
+for %%e in (Linear SRGB R11G11B10) do (
+    fxc.exe /nologo /O3 /T cs_5_0 /E main /DENCODING=!E! /Vn g_Sharpen_%%e /Fh "%OUT%\Sharpen_%%e.h" "%SRC%Sharpen.hlsl" >nul
+    if errorlevel 1 exit /b 1
+    set /a E+=1
+)
+
+fxc.exe /nologo /O3 /T cs_5_0 /E main /Vn g_DepthHistogram /Fh "%OUT%\DepthHistogram.h" "%SRC%DepthHistogram.hlsl" >nul
+if errorlevel 1 exit /b 1
+
+fxc.exe /nologo /O3 /T cs_5_0 /E main /Vn g_Probe /Fh "%OUT%\Probe.h" "%SRC%Probe.hlsl" >nul
+if errorlevel 1 exit /b 1
+
+fxc.exe /nologo /O3 /T ps_5_0 /E main /Vn g_DepthComposite /Fh "%OUT%\DepthComposite.h" "%SRC%DepthComposite.hlsl" >nul
+if errorlevel 1 exit /b 1
+
+fxc.exe /nologo /O3 /T ps_5_0 /E main /Vn g_StencilComposite /Fh "%OUT%\StencilComposite.h" "%SRC%StencilComposite.hlsl" >nul
+if errorlevel 1 exit /b 1
+exit /b 0
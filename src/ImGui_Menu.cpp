@@ -1,7 +1,6 @@
 #include <windows.h>
 #include <d3d11.h>
 #include <algorithm>
-#include <functional>
 #include <string>
 #include <vector>
 #include <cstdio>
@@ -13,15 +12,23 @@
 #include "F4SEVR_Upscaler.h"
 #include "dlss_manager.h"
 #include "dlss_config.h"
+#include "dlss_hooks.h"
+#include "dlss_input.h"
+#include "dlss_frametiming.h"
+#include "dlss_vram.h"
 
 extern DLSSManager* g_dlssManager;
 extern DLSSConfig* g_dlssConfig;
 
 class ImGuiMenu {
 private:
-    struct HotkeyBinding {
-        int virtualKey = 0;
-        bool latched = false;
+    enum HotkeyAction {
+        HotkeyToggleMenu = 0,
+        HotkeyToggleUpscaler,
+        HotkeyCycleQuality,
+        HotkeyCycleUpscaler,
+        HotkeyCapture,
+        HotkeyCount
     };
 
     bool menuVisible = false;
@@ -37,14 +44,23 @@ private:
     bool upscaleDepthForReShadeSetting = false;
     bool useTAAForPeripherySetting = false;
     int dlssPresetSetting = 4;
+    int downscaleFilterSetting = 2;
+    bool downscaleComputeSetting = false;
     float fovSetting = 90.0f;
+    bool enableJitterSetting = true;
+    bool patchProjectionSetting = false;
+    int vramBudgetSetting = 0;  // MB, 0 = no budget
+    bool stereoAtlasSetting = false;
+    bool deferredPassesSetting = false;
+    bool readbackProbesSetting = false;
 
     float fps = 0.0f;
     float frameTime = 0.0f;
-    float gpuUsage = 0.0f;
 
     int currentUpscaler = 0;
     int currentQuality = 2;
+    int eyeQualitySetting[2] = { -1, -1 };        // -1 = same as Quality Level
+    float eyeRenderScaleSetting[2] = { 0.0f, 0.0f };  // 0 = from quality
     float sharpness = 0.8f;
     bool enableFrameGen = true;
     int frameGenMode = 2;
@@ -66,10 +82,10 @@ private:
     int  earlyDlssModeSetting = 0; // 0=viewport clamp, 1=rt_redirect
     bool debugEarlyDlssSetting = false;
 
-    HotkeyBinding menuHotkey{VK_END, false};
-    HotkeyBinding toggleHotkey{VK_MULTIPLY, false};
-    HotkeyBinding cycleQualityHotkey{VK_HOME, false};
-    HotkeyBinding cycleUpscalerHotkey{VK_INSERT, false};
+    DLSSInput::ChordMatcher hotkeyMatcher;
+    // Keys and modifiers to edge-detect when no event source is active
+    uint16_t polledKeys[HotkeyCount + 3] = {};
+    size_t polledKeyCount = 0;
     bool hotkeysDirty = true;
 
     const ImVec4 colorGreen = ImVec4(0.0f, 1.0f, 0.0f, 1.0f);
@@ -109,6 +125,10 @@ public:
         enableUpscalerSetting = g_dlssConfig->enableUpscaler;
         currentUpscaler = static_cast<int>(g_dlssConfig->upscalerType);
         currentQuality = static_cast<int>(g_dlssConfig->quality);
+        eyeQualitySetting[0] = g_dlssConfig->qualityLeft;
+        eyeQualitySetting[1] = g_dlssConfig->qualityRight;
+        eyeRenderScaleSetting[0] = g_dlssConfig->renderScaleLeft;
+        eyeRenderScaleSetting[1] = g_dlssConfig->renderScaleRight;
         sharpeningEnabled = g_dlssConfig->enableSharpening;
         sharpness = g_dlssConfig->sharpness;
         useOptimalMip = g_dlssConfig->useOptimalMipLodBias;
@@ -117,7 +137,15 @@ public:
         upscaleDepthForReShadeSetting = g_dlssConfig->upscaleDepthForReShade;
         useTAAForPeripherySetting = g_dlssConfig->useTAAForPeriphery;
         dlssPresetSetting = g_dlssConfig->dlssPreset;
+        downscaleFilterSetting = g_dlssConfig->downscaleFilter;
+        downscaleComputeSetting = g_dlssConfig->downscaleCompute;
         fovSetting = g_dlssConfig->fov;
+        enableJitterSetting = g_dlssConfig->enableJitter;
+        patchProjectionSetting = g_dlssConfig->cameraPatchProjection;
+        vramBudgetSetting = g_dlssConfig->vramBudgetMB;
+        stereoAtlasSetting = g_dlssConfig->stereoAtlasOutput;
+        deferredPassesSetting = g_dlssConfig->deferredPasses;
+        readbackProbesSetting = g_dlssConfig->readbackProbes;
         enableFixedFoveated = g_dlssConfig->enableFixedFoveatedRendering;
         enableFixedFoveatedUpscaling = g_dlssConfig->enableFixedFoveatedUpscaling;
         foveatedInnerRadius = g_dlssConfig->foveatedInnerRadius;
@@ -141,7 +169,13 @@ public:
     void ToggleMenu() {
         menuVisible = !menuVisible;
         if (ImGui::GetCurrentContext()) {
-            ImGui::GetIO().MouseDrawCursor = menuVisible;
+            ImGuiIO& io = ImGui::GetIO();
+            io.MouseDrawCursor = menuVisible;
+            // Input is not forwarded while hidden: start each opening with no
+            // stale events and no keys or buttons held from the last one
+            io.ClearEventsQueue();
+            io.ClearInputKeys();
+            io.ClearInputMouse();
         }
 
         if (FILE* log = fopen("F4SEVR_DLSS.log", "a")) {
@@ -172,7 +206,10 @@ public:
             if (showPerformanceMetrics && ImGui::CollapsingHeader("Performance Metrics", ImGuiTreeNodeFlags_DefaultOpen)) {
                 ImGui::Text("FPS: %.1f", fps);
                 ImGui::Text("Frame Time: %.2f ms", frameTime);
-                ImGui::Text("GPU Usage: %.1f%%", gpuUsage);
+                const DLSSOverlay::CpuStats overlay = DLSSHooks::GetOverlayStats();
+                ImGui::Text("Present hook CPU: %.1f us hidden / %.1f us open (%llu rebuilds, %llu replays)",
+                    overlay.hiddenUs, overlay.visibleUs,
+                    (unsigned long long)overlay.rebuilds, (unsigned long long)overlay.replays);
 
                 if (F4SEVR_Upscaler* upscaler = F4SEVR_Upscaler::GetSingleton()) {
                     ImGui::Text("Display: %dx%d", upscaler->GetDisplayWidth(), upscaler->GetDisplayHeight());
@@ -181,6 +218,12 @@ public:
                         static_cast<int>(upscaler->GetDisplayHeight() * 0.75f));
                 }
 
+                RenderFramePacing();
+                RenderVram();
+                RenderOutput();
+                RenderHistory();
+                RenderReadback();
+                RenderCapture();
                 ImGui::Separator();
             }
 
@@ -214,6 +257,7 @@ public:
                 if (ImGui::Combo("Quality Level", &currentQuality, qualityLevels, IM_ARRAYSIZE(qualityLevels))) {
                     ApplyQualityChange();
                 }
+                RenderEyeOverrides(qualityLevels, IM_ARRAYSIZE(qualityLevels));
 
                 if (ImGui::Checkbox("Enable Sharpening", &sharpeningEnabled)) {
                     ApplySharpnessChange();
@@ -247,6 +291,21 @@ public:
                 if (ImGui::Checkbox("Debug logs (low rate)", &debugEarlyDlssSetting)) {
                     WriteSettingsToConfig(false);
                 }
+                if (earlyDlssEnabledSetting && earlyDlssModeSetting == 1) {
+                    const DLSSRedirect::PassStats rs = DLSSHooks::GetLastRedirectStats();
+                    ImGui::Text("Binds: %u redirected / %u native, composites: %u",
+                                rs.redirectedBinds, rs.nativeBinds, rs.composites);
+                    ImGui::Text("Clears: %u, copies: %u on twins (%.1f MB saved)",
+                                rs.translatedClears, rs.translatedCopies,
+                                (double)rs.bytesSaved / (1024.0 * 1024.0));
+                }
+                if (earlyDlssEnabledSetting && g_dlssConfig && g_dlssConfig->earlyDlssPassGraph) {
+                    const DLSSPassGraph::FrameStats ps = DLSSHooks::GetLastPassGraphStats();
+                    ImGui::Text("Passes: %u (shadow %u, gbuffer %u, lighting %u, post %u, hud %u)", ps.passes,
+                                ps.counts[(int)DLSSPassGraph::PassClass::Shadow], ps.counts[(int)DLSSPassGraph::PassClass::GBuffer],
+                                ps.counts[(int)DLSSPassGraph::PassClass::Lighting], ps.counts[(int)DLSSPassGraph::PassClass::Post],
+                                ps.counts[(int)DLSSPassGraph::PassClass::HUD]);
+                }
                 ImGui::Separator();
                 ImGui::TextDisabled("Note: Phase 0 instrumentation only (no behavior change).");
             }
@@ -264,9 +323,41 @@ public:
                 if (ImGui::SliderInt("DLSS Preset", &dlssPresetSetting, 0, 7)) {
                     ApplyAdvancedSettings();
                 }
+                const char* downscaleFilters[] = { "Box", "Bilinear", "Catmull-Rom", "Lanczos" };
+                if (ImGui::Combo("Downscale Filter", &downscaleFilterSetting, downscaleFilters, IM_ARRAYSIZE(downscaleFilters))) {
+                    ApplyAdvancedSettings();
+                }
+                if (ImGui::Checkbox("Compute Downscale (A/B)", &downscaleComputeSetting)) {
+                    ApplyAdvancedSettings();
+                }
+                if (ImGui::Checkbox("Pre-recorded Passes (worker thread)", &deferredPassesSetting)) {
+                    ApplyAdvancedSettings();
+                }
+                if (g_dlssManager && g_dlssManager->GetDeferredPasses()) {
+                    const DLSSCmdList::Stats passes = g_dlssManager->GetDeferredPassStats();
+                    ImGui::Text("Replayed %llu, encoded %llu, recorded %llu (%llu stale, %llu failed), %u ready",
+                                (unsigned long long)passes.executed, (unsigned long long)passes.misses,
+                                (unsigned long long)passes.recorded, (unsigned long long)passes.stale,
+                                (unsigned long long)passes.failed, passes.ready);
+                }
+                if (g_dlssManager) {
+                    ImGui::Text("Downscale GPU: %.3f ms (%s)", g_dlssManager->GetDownscaleGpuMs(),
+                                g_dlssManager->IsLastDownscaleCompute() ? "compute" : "graphics");
+                    ImGui::Text("SL scratch copies: L %.2f MB  R %.2f MB per frame",
+                                g_dlssManager->GetEyeCopyBytes(0) / (1024.0 * 1024.0),
+                                g_dlssManager->GetEyeCopyBytes(1) / (1024.0 * 1024.0));
+                    ImGui::Text("Backend submit CPU: L %.3f ms  R %.3f ms",
+                                g_dlssManager->GetEyeSubmitMs(0), g_dlssManager->GetEyeSubmitMs(1));
+                }
                 if (ImGui::SliderFloat("Field of View", &fovSetting, 70.0f, 120.0f, "%.1f")) {
                     ApplyAdvancedSettings();
                 }
+                if (ImGui::Checkbox("Sub-pixel Jitter (Halton)", &enableJitterSetting)) {
+                    ApplyAdvancedSettings();
+                }
+                if (ImGui::Checkbox("Patch Projection (Experimental)", &patchProjectionSetting)) {
+                    ApplyAdvancedSettings();
+                }
             }
 
             if (ImGui::CollapsingHeader("Fixed Foveated Rendering", ImGuiTreeNodeFlags_DefaultOpen)) {
@@ -329,8 +420,6 @@ public:
             fps = 1000.0f / deltaTimeMs;
             frameTime = deltaTimeMs;
         }
-
-        gpuUsage = 75.0f;
     }
 
     void ProcessHotkeys() {
@@ -338,13 +427,229 @@ public:
             UpdateHotkeyBindings();
         }
 
-        HandleHotkey(menuHotkey, [this]() { ToggleMenu(); });
-        HandleHotkey(toggleHotkey, [this]() { ToggleUpscaler(); });
-        HandleHotkey(cycleQualityHotkey, [this]() { CycleQuality(); });
-        HandleHotkey(cycleUpscalerHotkey, [this]() { CycleUpscaler(); });
+        if (!DLSSInput::HasEventSource()) {
+            DLSSInput::PollKeys(polledKeys, polledKeyCount);
+        }
+
+        DLSSInput::KeyEvent ev;
+        while (DLSSInput::Events().Pop(ev)) {
+            switch (hotkeyMatcher.Feed(ev)) {
+                case HotkeyToggleMenu: ToggleMenu(); break;
+                case HotkeyToggleUpscaler: ToggleUpscaler(); break;
+                case HotkeyCycleQuality: CycleQuality(); break;
+                case HotkeyCycleUpscaler: CycleUpscaler(); break;
+                case HotkeyCapture: ToggleCapture(); break;
+                default: break;
+            }
+        }
     }
 
 private:
+    void RenderStreamPacing(const char* label, const DLSSFrameTiming::Stream& stream) {
+        const DLSSFrameTiming::Histogram& h = stream.Session();
+        if (h.Count() == 0) {
+            ImGui::Text("%s: no samples", label);
+            return;
+        }
+        const double risk = stream.OverBudgetRatio() * 100.0;
+        const ImVec4 riskColor = risk < 1.0 ? colorGreen : (risk < 5.0 ? colorYellow : colorRed);
+        ImGui::Text("%s: p50 %.2f  p99 %.2f  p99.9 %.2f  max %.2f ms", label,
+            h.PercentileUs(50.0) / 1000.0, h.PercentileUs(99.0) / 1000.0,
+            h.PercentileUs(99.9) / 1000.0, h.MaxUs() / 1000.0);
+        ImGui::TextColored(riskColor, "  Reprojection risk: %.2f%% over budget (%llu / %llu), %llu hitches",
+            risk, (unsigned long long)stream.SessionOverBudget(), (unsigned long long)h.Count(),
+            (unsigned long long)stream.SessionHitches());
+        if (stream.RollupCount() > 0) {
+            const DLSSFrameTiming::SecondRollup& last = stream.Rollup(0);
+            ImGui::Text("  Last second: %u frames, %u over budget, p99 %.2f ms",
+                last.frames, last.overBudget, last.p99Ms);
+        }
+    }
+
+    void RenderFramePacing() {
+        if (!ImGui::TreeNode("Frame Pacing")) {
+            return;
+        }
+        DLSSFrameTiming::Tracker& timing = DLSSFrameTiming::Global();
+        const double budgetMs = timing.Present().BudgetMs();
+        ImGui::Text("Budget: %.2f ms (%.0f Hz), hitch >= %.1f ms", budgetMs, timing.RefreshRate(),
+            timing.Present().HitchThresholdMs());
+        RenderStreamPacing("Present", timing.Present());
+        RenderStreamPacing("Submit", timing.Submit());
+
+        // Over-budget frames per second, oldest on the left
+        const DLSSFrameTiming::Stream& present = timing.Present();
+        float overBudget[DLSSFrameTiming::kRollupSeconds] = {};
+        const uint32_t seconds = present.RollupCount();
+        for (uint32_t i = 0; i < seconds; ++i) {
+            overBudget[seconds - 1 - i] = static_cast<float>(present.Rollup(i).overBudget);
+        }
+        if (seconds > 0) {
+            ImGui::PlotHistogram("##overbudget", overBudget, static_cast<int>(seconds), 0,
+                "Over-budget frames / s (60 s)", 0.0f, FLT_MAX, ImVec2(0.0f, 50.0f));
+        }
+
+        const DLSSFrameTiming::HitchCorrelator& hitches = timing.Hitches();
+        ImGui::Text("Hitch causes: feature %llu, resize %llu, config %llu, init %llu, unknown %llu",
+            (unsigned long long)hitches.CauseCount(DLSSFrameTiming::Event::FeatureCreate),
+            (unsigned long long)hitches.CauseCount(DLSSFrameTiming::Event::Resize),
+            (unsigned long long)hitches.CauseCount(DLSSFrameTiming::Event::ConfigApply),
+            (unsigned long long)hitches.CauseCount(DLSSFrameTiming::Event::Initialize),
+            (unsigned long long)hitches.Unattributed());
+        const double nowMs = DLSSFrameTiming::NowMs();
+        const uint32_t shown = std::min<uint32_t>(hitches.HitchCount(), 5);
+        for (uint32_t i = 0; i < shown; ++i) {
+            const DLSSFrameTiming::Hitch& hitch = hitches.RecentHitch(i);
+            ImGui::BulletText("%.1f s ago: %.1f ms %s%s%s", (nowMs - hitch.endMs) / 1000.0, hitch.intervalMs,
+                hitch.stream == DLSSFrameTiming::StreamId::Present ? "Present" : "Submit",
+                hitch.attributed ? " after " : "",
+                hitch.attributed ? DLSSFrameTiming::EventName(hitch.cause) : "");
+        }
+        if (ImGui::SmallButton("Reset pacing stats")) {
+            timing.Reset();
+        }
+        ImGui::TreePop();
+    }
+
+    void RenderVram() {
+        if (!ImGui::TreeNode("Plugin VRAM")) {
+            return;
+        }
+        const double mb = 1.0 / (1024.0 * 1024.0);
+        const DLSSVram::Snapshot vram = DLSSVram::Global().Take();
+        ImGui::Text("Total: %.1f MB (peak %.1f MB)", vram.currentBytes * mb, vram.peakBytes * mb);
+        for (size_t i = 0; i < DLSSVram::kPoolCount; ++i) {
+            const DLSSVram::PoolStats& pool = vram.pools[i];
+            if (pool.allocations == 0) continue;
+            ImGui::BulletText("%s: %.1f MB (peak %.1f MB), %u live, %llu created",
+                DLSSVram::PoolName(static_cast<DLSSVram::Pool>(i)), pool.currentBytes * mb, pool.peakBytes * mb,
+                pool.liveCount, (unsigned long long)pool.allocations);
+        }
+        if (ImGui::SliderInt("Budget (MB, 0 = off)", &vramBudgetSetting, 0, 8192)) {
+            ApplyAdvancedSettings();
+        }
+        if (vram.budgetBytes > 0) {
+            ImGui::TextColored(vram.currentBytes > vram.budgetBytes ? colorYellow : colorGreen,
+                "%.0f%% of budget, %llu trims released %.1f MB", 100.0 * vram.currentBytes / vram.budgetBytes,
+                (unsigned long long)vram.trims, vram.trimmedBytes * mb);
+        }
+        if (ImGui::SmallButton("Reset peaks")) {
+            DLSSVram::Global().ResetPeaks();
+        }
+        ImGui::TreePop();
+    }
+
+    void RenderOutput() {
+        if (!g_dlssManager || !ImGui::TreeNode("Output")) {
+            return;
+        }
+        if (ImGui::Checkbox("Stereo atlas (Streamline)", &stereoAtlasSetting)) {
+            ApplyAdvancedSettings();
+        }
+        const DLSSAtlas::OutputStats stats = g_dlssManager->GetOutputStats();
+        ImGui::Text("Mode: %s", stats.atlas ? "stereo atlas" : "per-eye textures");
+        ImGui::Text("%u textures, %u views, %.1f MB", stats.textures, stats.views, stats.bytes / (1024.0 * 1024.0));
+        ImGui::Text("Output binds: %u per frame", stats.binds);
+        ImGui::TreePop();
+    }
+
+    void RenderHistory() {
+        if (!g_dlssManager || !ImGui::TreeNode("History resets")) {
+            return;
+        }
+        for (int eye = 0; eye < 2; ++eye) {
+            const DLSSHistory::Tracker& history = g_dlssManager->GetEyeHistory(eye);
+            ImGui::Text("%s: %llu of %llu frames", eye == 0 ? "Left" : "Right",
+                (unsigned long long)history.Resets(), (unsigned long long)history.Frames());
+            for (uint32_t i = 0; i < DLSSHistory::kReasonCount; ++i) {
+                if (history.ResetCount(i) == 0) continue;
+                ImGui::BulletText("%s: %llu%s", DLSSHistory::ReasonName(i), (unsigned long long)history.ResetCount(i),
+                    (history.LastResetReasons() & (1u << i)) ? " (last)" : "");
+            }
+        }
+        ImGui::TreePop();
+    }
+
+    void RenderReadback() {
+        if (!g_dlssManager || !ImGui::TreeNode("GPU readback")) {
+            return;
+        }
+        if (ImGui::Checkbox("Output and motion probes", &readbackProbesSetting)) {
+            ApplyAdvancedSettings();
+        }
+        for (int eye = 0; eye < 2; ++eye) {
+            for (int motion = 0; motion < 2; ++motion) {
+                DLSSReadback::ProbeStats probe;
+                if (!g_dlssManager->GetEyeProbe(eye, motion != 0, probe)) continue;
+                const char* label = motion ? (eye == 0 ? "Motion L" : "Motion R") : (eye == 0 ? "Output L" : "Output R");
+                ImGui::TextColored(probe.nonFinite ? colorYellow : colorGreen, "%s: min %.3f  max %.3f  mean %.3f  NaN/Inf %u",
+                    label, probe.minValue, probe.maxValue, probe.mean, probe.nonFinite);
+            }
+        }
+        for (uint32_t i = 0; i < g_dlssManager->GetReadbackStreamCount(); ++i) {
+            const DLSSReadback::StreamStats stream = g_dlssManager->GetReadbackStats(i);
+            if (stream.issued == 0) continue;
+            ImGui::BulletText("%s: %llu read, %u frames late, %llu skipped, %llu stale, %u in flight",
+                g_dlssManager->GetReadbackStreamName(i), (unsigned long long)stream.delivered, stream.lastLatency,
+                (unsigned long long)stream.skipped, (unsigned long long)stream.stale, stream.inFlight);
+        }
+        ImGui::TreePop();
+    }
+
+    void RenderCapture() {
+        if (!g_dlssManager || !ImGui::TreeNode("Frame capture")) {
+            return;
+        }
+        const bool capturing = g_dlssManager->IsCapturing();
+        if (ImGui::Button(capturing ? "Stop capture" : "Start capture")) {
+            ToggleCapture();
+        }
+        const DLSSCapture::Stats stats = g_dlssManager->GetCaptureStats();
+        if (!stats.path.empty()) {
+            ImGui::TextWrapped("%s", stats.path.c_str());
+            const ImVec4 color = stats.failed ? colorRed : ((stats.dropped || g_dlssManager->GetCaptureSkipped()) ? colorYellow : colorGreen);
+            ImGui::TextColored(color, "%llu eye frames, %.1f MB written%s", (unsigned long long)stats.written,
+                stats.bytesWritten / (1024.0 * 1024.0), stats.failed ? " (write failed)" : "");
+            ImGui::Text("Queue: %u frames, %.1f MB  dropped %llu  skipped %llu", stats.queued, stats.queuedBytes / (1024.0 * 1024.0),
+                (unsigned long long)stats.dropped, (unsigned long long)g_dlssManager->GetCaptureSkipped());
+        }
+        ImGui::TreePop();
+    }
+
+    void RenderEyeOverrides(const char* const* qualityLevels, int levelCount) {
+        if (!ImGui::TreeNode("Per-eye overrides")) {
+            return;
+        }
+        // Combo index 0 is "Same as global", level i is index i + 1
+        const char* items[8] = { "Same as global" };
+        const int itemCount = std::min(levelCount, 7) + 1;
+        for (int i = 1; i < itemCount; ++i) items[i] = qualityLevels[i - 1];
+        // Only the eye that changed is touched; the slider applies while
+        // dragging and goes to the config once released
+        for (int eye = 0; eye < 2; ++eye) {
+            ImGui::PushID(eye);
+            ImGui::TextUnformatted(eye == 0 ? "Left eye" : "Right eye");
+            int item = eyeQualitySetting[eye] + 1;
+            if (ImGui::Combo("Quality", &item, items, itemCount)) {
+                eyeQualitySetting[eye] = item - 1;
+                if (g_dlssManager) g_dlssManager->SetEyeQuality(eye, eyeQualitySetting[eye]);
+                WriteSettingsToConfig(false);
+            }
+            if (ImGui::SliderFloat("Render scale (0 = auto)", &eyeRenderScaleSetting[eye], 0.0f, 1.0f, "%.2f")) {
+                if (eyeRenderScaleSetting[eye] > 0.0f && eyeRenderScaleSetting[eye] < 0.33f) eyeRenderScaleSetting[eye] = 0.33f;
+                if (g_dlssManager) g_dlssManager->SetEyeRenderScale(eye, eyeRenderScaleSetting[eye]);
+            }
+            if (ImGui::IsItemDeactivatedAfterEdit()) {
+                WriteSettingsToConfig(false);
+            }
+            if (g_dlssManager) {
+                ImGui::Text("GPU %.3f ms per frame", g_dlssManager->GetEyeGpuMs(eye));
+            }
+            ImGui::PopID();
+        }
+        ImGui::TreePop();
+    }
+
     void ApplyUpscalerChange() {
         if (g_dlssManager) {
             g_dlssManager->SetEnabled(enableUpscalerSetting);
@@ -356,6 +661,10 @@ private:
     void ApplyQualityChange() {
         if (g_dlssManager) {
             g_dlssManager->SetQuality(static_cast<DLSSManager::Quality>(currentQuality));
+            for (int eye = 0; eye < 2; ++eye) {
+                g_dlssManager->SetEyeQuality(eye, eyeQualitySetting[eye]);
+                g_dlssManager->SetEyeRenderScale(eye, eyeRenderScaleSetting[eye]);
+            }
         }
         WriteSettingsToConfig(false);
     }
@@ -376,8 +685,15 @@ private:
             g_dlssManager->SetUpscaleDepthForReShade(upscaleDepthForReShadeSetting);
             g_dlssManager->SetUseTAAPeriphery(useTAAForPeripherySetting);
             g_dlssManager->SetDLSSPreset(dlssPresetSetting);
+            g_dlssManager->SetDownscaleFilter(static_cast<DLSSDownscale::Filter>(downscaleFilterSetting));
+            g_dlssManager->SetDownscaleCompute(downscaleComputeSetting);
             g_dlssManager->SetFOV(fovSetting);
+            g_dlssManager->SetJitterEnabled(enableJitterSetting);
+            g_dlssManager->SetStereoAtlas(stereoAtlasSetting);
+            g_dlssManager->SetDeferredPasses(deferredPassesSetting);
+            g_dlssManager->SetReadbackProbes(readbackProbesSetting);
         }
+        DLSSVram::Global().SetBudgetBytes(static_cast<uint64_t>(vramBudgetSetting) << 20);
         WriteSettingsToConfig(false);
     }
 
@@ -406,6 +722,10 @@ private:
         enableUpscalerSetting = defaults.enableUpscaler;
         currentUpscaler = static_cast<int>(defaults.upscalerType);
         currentQuality = static_cast<int>(defaults.quality);
+        eyeQualitySetting[0] = defaults.qualityLeft;
+        eyeQualitySetting[1] = defaults.qualityRight;
+        eyeRenderScaleSetting[0] = defaults.renderScaleLeft;
+        eyeRenderScaleSetting[1] = defaults.renderScaleRight;
         sharpeningEnabled = defaults.enableSharpening;
         sharpness = defaults.sharpness;
         useOptimalMip = defaults.useOptimalMipLodBias;
@@ -414,7 +734,15 @@ private:
         upscaleDepthForReShadeSetting = defaults.upscaleDepthForReShade;
         useTAAForPeripherySetting = defaults.useTAAForPeriphery;
         dlssPresetSetting = defaults.dlssPreset;
+        downscaleFilterSetting = defaults.downscaleFilter;
+        downscaleComputeSetting = defaults.downscaleCompute;
         fovSetting = defaults.fov;
+        enableJitterSetting = defaults.enableJitter;
+        patchProjectionSetting = defaults.cameraPatchProjection;
+        vramBudgetSetting = defaults.vramBudgetMB;
+        stereoAtlasSetting = defaults.stereoAtlasOutput;
+        deferredPassesSetting = defaults.deferredPasses;
+        readbackProbesSetting = defaults.readbackProbes;
         enableFixedFoveated = defaults.enableFixedFoveatedRendering;
         enableFixedFoveatedUpscaling = defaults.enableFixedFoveatedUpscaling;
         foveatedInnerRadius = defaults.foveatedInnerRadius;
@@ -448,6 +776,17 @@ private:
         }
     }
 
+    void ToggleCapture() {
+        if (!g_dlssManager) {
+            return;
+        }
+        if (g_dlssManager->IsCapturing()) {
+            g_dlssManager->StopCapture();
+        } else {
+            g_dlssManager->StartCapture(g_dlssConfig ? static_cast<uint32_t>(g_dlssConfig->captureFrameCount) : 0);
+        }
+    }
+
     void CycleQuality() {
         currentQuality = (currentQuality + 1) % 6;
         ApplyQualityChange();
@@ -471,42 +810,32 @@ private:
             return value != 0 ? value : fallbackKey;
         };
 
+        int chords[HotkeyCount] = {0x47, VK_MULTIPLY, VK_HOME, VK_INSERT, VK_F10};
         if (g_dlssConfig) {
-            menuHotkey.virtualKey = fallback(g_dlssConfig->toggleMenuKey, 0x47);
-            toggleHotkey.virtualKey = fallback(g_dlssConfig->toggleUpscalerKey, VK_MULTIPLY);
-            cycleQualityHotkey.virtualKey = fallback(g_dlssConfig->cycleQualityKey, VK_HOME);
-            cycleUpscalerHotkey.virtualKey = fallback(g_dlssConfig->cycleUpscalerKey, VK_INSERT);
-        } else {
-            menuHotkey.virtualKey = 0x47;
-            toggleHotkey.virtualKey = VK_MULTIPLY;
-            cycleQualityHotkey.virtualKey = VK_HOME;
-            cycleUpscalerHotkey.virtualKey = VK_INSERT;
+            chords[HotkeyToggleMenu] = fallback(g_dlssConfig->toggleMenuKey, chords[HotkeyToggleMenu]);
+            chords[HotkeyToggleUpscaler] = fallback(g_dlssConfig->toggleUpscalerKey, chords[HotkeyToggleUpscaler]);
+            chords[HotkeyCycleQuality] = fallback(g_dlssConfig->cycleQualityKey, chords[HotkeyCycleQuality]);
+            chords[HotkeyCycleUpscaler] = fallback(g_dlssConfig->cycleUpscalerKey, chords[HotkeyCycleUpscaler]);
+            chords[HotkeyCapture] = fallback(g_dlssConfig->captureKey, chords[HotkeyCapture]);
+            hotkeyMatcher.SetDebounceMs(static_cast<uint32_t>(g_dlssConfig->hotkeyDebounceMs));
         }
 
-        menuHotkey.latched = false;
-        toggleHotkey.latched = false;
-        cycleQualityHotkey.latched = false;
-        cycleUpscalerHotkey.latched = false;
-        hotkeysDirty = false;
-    }
-
-    void HandleHotkey(HotkeyBinding& binding, const std::function<void()>& action) {
-        if (binding.virtualKey == 0) {
-            binding.latched = false;
-            return;
-        }
-
-        SHORT state = GetAsyncKeyState(binding.virtualKey);
-        bool pressed = (state & 0x8000) != 0;
-        if (pressed && !binding.latched) {
-            action();
-            binding.latched = true;
-        } else if (!pressed) {
-            binding.latched = false;
+        hotkeyMatcher.ClearBindings();
+        uint32_t mods = DLSSInput::ModNone;
+        polledKeyCount = 0;
+        for (int action = 0; action < HotkeyCount; ++action) {
+            hotkeyMatcher.Bind(action, chords[action]);
+            polledKeys[polledKeyCount++] = DLSSInput::ChordKey(chords[action]);
+            mods |= DLSSInput::ChordMods(chords[action]);
         }
+        if (mods & DLSSInput::ModCtrl) polledKeys[polledKeyCount++] = VK_CONTROL;
+        if (mods & DLSSInput::ModShift) polledKeys[polledKeyCount++] = VK_SHIFT;
+        if (mods & DLSSInput::ModAlt) polledKeys[polledKeyCount++] = VK_MENU;
+        hotkeysDirty = false;
     }
 
     void WriteSettingsToConfig(bool persist) {
+        DLSSFrameTiming::Global().Note(DLSSFrameTiming::Event::ConfigApply);
         if (!g_dlssConfig) {
             return;
         }
@@ -514,6 +843,10 @@ private:
         g_dlssConfig->enableUpscaler = enableUpscalerSetting;
         g_dlssConfig->upscalerType = static_cast<DLSSConfig::UpscalerType>(currentUpscaler);
         g_dlssConfig->quality = static_cast<DLSSManager::Quality>(currentQuality);
+        g_dlssConfig->qualityLeft = eyeQualitySetting[0];
+        g_dlssConfig->qualityRight = eyeQualitySetting[1];
+        g_dlssConfig->renderScaleLeft = eyeRenderScaleSetting[0];
+        g_dlssConfig->renderScaleRight = eyeRenderScaleSetting[1];
         g_dlssConfig->enableSharpening = sharpeningEnabled;
         g_dlssConfig->sharpness = sharpness;
         g_dlssConfig->useOptimalMipLodBias = useOptimalMip;
@@ -522,7 +855,15 @@ private:
         g_dlssConfig->upscaleDepthForReShade = upscaleDepthForReShadeSetting;
         g_dlssConfig->useTAAForPeriphery = useTAAForPeripherySetting;
         g_dlssConfig->dlssPreset = dlssPresetSetting;
+        g_dlssConfig->downscaleFilter = downscaleFilterSetting;
+        g_dlssConfig->downscaleCompute = downscaleComputeSetting;
         g_dlssConfig->fov = fovSetting;
+        g_dlssConfig->enableJitter = enableJitterSetting;
+        g_dlssConfig->cameraPatchProjection = patchProjectionSetting;
+        g_dlssConfig->vramBudgetMB = vramBudgetSetting;
+        g_dlssConfig->stereoAtlasOutput = stereoAtlasSetting;
+        g_dlssConfig->deferredPasses = deferredPassesSetting;
+        g_dlssConfig->readbackProbes = readbackProbesSetting;
         g_dlssConfig->enableFixedFoveatedRendering = enableFixedFoveated;
         g_dlssConfig->enableFixedFoveatedUpscaling = enableFixedFoveatedUpscaling;
         g_dlssConfig->foveatedInnerRadius = foveatedInnerRadius;
@@ -4,6 +4,9 @@
 
 #include "SLBackend.h"
 #include "common/IDebugLog.h"
+#include "dlss_frametiming.h"
+#include "dlss_tagging.h"
+#include "dlss_vram.h"
 
 #include <windows.h>
 #include <shlobj.h>
@@ -41,6 +44,9 @@ namespace {
         return p;
     }
 
+    // Private data of textures the tag sets have seen: their creation serial
+    const GUID kTextureSerialGuid = { 0x5b8e2f41, 0x93c7, 0x4d0a, { 0xa6, 0x1e, 0x7c, 0x24, 0xd9, 0x58, 0x0b, 0x3f } };
+
     DXGI_FORMAT ResolveDepthFormat(DXGI_FORMAT format) {
         switch (format) {
             case DXGI_FORMAT_R24G8_TYPELESS: return DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
@@ -48,15 +54,78 @@ namespace {
             default: return format;
         }
     }
+
+    DLSSTagging::TextureInfo ToTextureInfo(const D3D11_TEXTURE2D_DESC& desc) {
+        DLSSTagging::TextureInfo info;
+        info.format = static_cast<uint32_t>(desc.Format);
+        info.width = desc.Width;
+        info.height = desc.Height;
+        info.sampleCount = desc.SampleDesc.Count;
+        info.usage = static_cast<uint32_t>(desc.Usage);
+        info.bindFlags = desc.BindFlags;
+        return info;
+    }
+
+    // DLSSManager::Quality -> DLSS mode
+    sl::DLSSMode ToDLSSMode(int qualityEnum) {
+        switch (qualityEnum) {
+            case 0: return sl::DLSSMode::eMaxPerformance;
+            case 1: return sl::DLSSMode::eBalanced;
+            case 2: return sl::DLSSMode::eMaxQuality;
+            case 3: return sl::DLSSMode::eUltraPerformance;
+            case 4: return sl::DLSSMode::eUltraQuality;
+            case 5: return sl::DLSSMode::eDLAA;
+            default: return sl::DLSSMode::eMaxQuality;
+        }
+    }
+
+    sl::Extent ToExtent(const DLSSTagging::Rect& rect) {
+        sl::Extent e{};
+        e.left = rect.x; e.top = rect.y; e.width = rect.width; e.height = rect.height;
+        return e;
+    }
+
+    // Wanted size clamped to the resource; 0 means the full resource
+    sl::Extent ClampExtent(uint32_t wantW, uint32_t wantH, uint32_t resW, uint32_t resH) {
+        sl::Extent e{};
+        e.left = 0; e.top = 0;
+        e.width = (wantW == 0 || wantW > resW) ? resW : wantW;
+        e.height = (wantH == 0 || wantH > resH) ? resH : wantH;
+        return e;
+    }
+
+    // Smoothed CPU time of one ProcessEye, from eye selection to return
+    class SubmitTimer {
+    public:
+        explicit SubmitTimer(float& smoothedMs) : m_out(smoothedMs) { QueryPerformanceCounter(&m_start); }
+        ~SubmitTimer() {
+            LARGE_INTEGER now{}, freq{};
+            QueryPerformanceCounter(&now);
+            QueryPerformanceFrequency(&freq);
+            const float ms = static_cast<float>(static_cast<double>(now.QuadPart - m_start.QuadPart) * 1000.0 / static_cast<double>(freq.QuadPart));
+            m_out = m_out > 0.0f ? m_out * 0.9f + ms * 0.1f : ms;
+        }
+        SubmitTimer(const SubmitTimer&) = delete;
+        SubmitTimer& operator=(const SubmitTimer&) = delete;
+
+    private:
+        float& m_out;
+        LARGE_INTEGER m_start{};
+    };
+
+    void LogTagDecision(int eyeIndex, const char* role, const D3D11_TEXTURE2D_DESC& desc, const DLSSTagging::Decision& decision) {
+        _MESSAGE("[SL] Eye %d %s color: %s (fmt=%u %ux%u samples=%u bind=0x%X usage=%u), %.2f MB/frame copied",
+                 eyeIndex, role, DLSSTagging::ActionName(decision.action), (unsigned)desc.Format, desc.Width, desc.Height,
+                 desc.SampleDesc.Count, desc.BindFlags, (unsigned)desc.Usage, decision.bytesPerFrame / (1024.0 * 1024.0));
+    }
 }
 
 SLBackend::SLBackend() = default;
 SLBackend::~SLBackend() { Shutdown(); }
 
-bool SLBackend::Init(ID3D11Device* device, ID3D11DeviceContext* context) {
-    m_device = device;
-    m_context = context;
-    if (!m_device || !m_context) return false;
+bool SLBackend::Prepare(ID3D11Device* device) {
+    if (m_prepared) return true;
+    if (!device) return false;
 
 #ifndef USE_STREAMLINE
     return false;
@@ -98,16 +167,10 @@ bool SLBackend::Init(ID3D11Device* device, ID3D11DeviceContext* context) {
         return false;
     }
 
-    if (sl::Result rr = slSetD3DDevice((void*)m_device); rr != sl::Result::eOk) {
-        _ERROR("[SL] slSetD3DDevice failed: %d", (int)rr);
-        return false;
-    }
-
-    // Check DLSS support on current adapter
-    bool loaded = false;
+    // Check DLSS support on current adapter (DXGI only, no device work)
     do {
         IDXGIDevice* dxgiDevice = nullptr;
-        if (SUCCEEDED(m_device->QueryInterface(__uuidof(IDXGIDevice), (void**)&dxgiDevice)) && dxgiDevice) {
+        if (SUCCEEDED(device->QueryInterface(__uuidof(IDXGIDevice), (void**)&dxgiDevice)) && dxgiDevice) {
             IDXGIAdapter* adapter = nullptr;
             if (SUCCEEDED(dxgiDevice->GetAdapter(&adapter)) && adapter) {
                 DXGI_ADAPTER_DESC1 ad{};
@@ -128,6 +191,30 @@ bool SLBackend::Init(ID3D11Device* device, ID3D11DeviceContext* context) {
         }
     } while (0);
 
+    m_prepared = true;
+    return true;
+#endif
+}
+
+bool SLBackend::Init(ID3D11Device* device, ID3D11DeviceContext* context) {
+    m_device = device;
+    m_context = context;
+    if (!m_device || !m_context) return false;
+
+#ifndef USE_STREAMLINE
+    return false;
+#else
+    // Runs inline when the background bring-up did not prepare us
+    if (!Prepare(m_device)) {
+        return false;
+    }
+
+    if (sl::Result rr = slSetD3DDevice((void*)m_device); rr != sl::Result::eOk) {
+        _ERROR("[SL] slSetD3DDevice failed: %d", (int)rr);
+        return false;
+    }
+
+    bool loaded = false;
     if (sl::Result lr = slIsFeatureLoaded(sl::kFeatureDLSS, loaded); lr == sl::Result::eOk) {
         _MESSAGE("[SL] DLSS loaded=%d", (int)loaded);
     }
@@ -157,6 +244,7 @@ bool SLBackend::Init(ID3D11Device* device, ID3D11DeviceContext* context) {
     m_options.mode = sl::DLSSMode::eMaxQuality;
     m_options.outputWidth = 0;  // set per-frame
     m_options.outputHeight = 0; // set per-frame
+    ++m_optionsSerial;
     m_ready = true;
 #ifdef USE_STREAMLINE
     for (int i = 0; i < kMaxEyes; ++i) {
@@ -166,9 +254,11 @@ bool SLBackend::Init(ID3D11Device* device, ID3D11DeviceContext* context) {
         m_vpOutW[i] = m_vpOutH[i] = 0;
     }
     m_currentEye = 0;
-    m_frameToken = nullptr;
-    m_frameActive = false;
-    m_frameEyeCount = 0;
+    m_stereo.token = nullptr;
+    m_stereo.evaluated = 0;
+    const DLSSTagging::DeviceCaps caps = DLSSTagging::QueryDeviceCaps(m_device);
+    for (int i = 0; i < kMaxEyes; ++i) m_tagCache[i].SetDeviceCaps(caps);
+    _MESSAGE("[SL] B8G8R8A8 typed UAV stores: %s", caps.bgraTypedStore ? "supported" : "unsupported, outputs use R8G8B8A8");
 #endif
     return true;
 #endif
@@ -178,10 +268,9 @@ void SLBackend::Shutdown() {
 #ifdef USE_STREAMLINE
     if (m_ready) {
         for (int i = 0; i < kMaxEyes; ++i) {
-            if (m_scratchIn[i]) { m_scratchIn[i]->Release(); m_scratchIn[i] = nullptr; }
-            if (m_scratchOut[i]) { m_scratchOut[i]->Release(); m_scratchOut[i] = nullptr; }
-            m_scratchInW[i] = m_scratchInH[i] = 0; m_scratchInFmt[i] = DXGI_FORMAT_UNKNOWN;
-            m_scratchOutW[i] = m_scratchOutH[i] = 0; m_scratchOutFmt[i] = DXGI_FORMAT_UNKNOWN;
+            ReleaseEyeScratch(i);
+            m_tagCache[i].Clear();
+            m_copyBytes[i] = 0;
         }
         for (int i = 0; i < kMaxEyes; ++i) {
             if (m_vpAllocated[i] && m_viewports[i] != 0) {
@@ -191,11 +280,13 @@ void SLBackend::Shutdown() {
             m_viewports[i] = sl::ViewportHandle(0);
             m_vpInW[i] = m_vpInH[i] = m_vpOutW[i] = m_vpOutH[i] = 0;
         }
-        m_frameToken = nullptr;
-        m_frameActive = false;
-        m_frameEyeCount = 0;
+        m_stereo.token = nullptr;
+        m_stereo.evaluated = 0;
         slSetFeatureLoaded(sl::kFeatureDLSS, false);
+    }
+    if (m_prepared) {
         slShutdown();
+        m_prepared = false;
     }
 #endif
     m_ready = false;
@@ -203,53 +294,166 @@ void SLBackend::Shutdown() {
     m_context = nullptr;
 }
 
+#ifdef USE_STREAMLINE
+void SLBackend::ReleaseEyeScratch(int eyeIndex) {
+    DLSSVram::ReleaseTexture(m_scratchIn[eyeIndex]);
+    DLSSVram::ReleaseTexture(m_scratchOut[eyeIndex]);
+    m_scratchInW[eyeIndex] = m_scratchInH[eyeIndex] = 0; m_scratchInFmt[eyeIndex] = DXGI_FORMAT_UNKNOWN;
+    m_scratchOutW[eyeIndex] = m_scratchOutH[eyeIndex] = 0; m_scratchOutFmt[eyeIndex] = DXGI_FORMAT_UNKNOWN;
+    // The tag set may point at the released scratch
+    m_stereo.eyes[eyeIndex] = EyeTagSet{};
+}
+
+bool SLBackend::EnsureScratch(int eyeIndex, bool output, const DLSSTagging::Decision& decision) {
+    ID3D11Texture2D*& tex = output ? m_scratchOut[eyeIndex] : m_scratchIn[eyeIndex];
+    unsigned int& w = output ? m_scratchOutW[eyeIndex] : m_scratchInW[eyeIndex];
+    unsigned int& h = output ? m_scratchOutH[eyeIndex] : m_scratchInH[eyeIndex];
+    DXGI_FORMAT& fmt = output ? m_scratchOutFmt[eyeIndex] : m_scratchInFmt[eyeIndex];
+    const DXGI_FORMAT wantFmt = static_cast<DXGI_FORMAT>(decision.scratchFormat);
+    if (tex && w == decision.scratchWidth && h == decision.scratchHeight && fmt == wantFmt) {
+        return true;
+    }
+    DLSSVram::ReleaseTexture(tex);
+    w = h = 0; fmt = DXGI_FORMAT_UNKNOWN;
+    D3D11_TEXTURE2D_DESC s{};
+    s.Width = decision.scratchWidth; s.Height = decision.scratchHeight; s.MipLevels = 1; s.ArraySize = 1;
+    s.Format = wantFmt; s.SampleDesc.Count = 1; s.SampleDesc.Quality = 0;
+    s.Usage = D3D11_USAGE_DEFAULT; s.CPUAccessFlags = 0; s.MiscFlags = 0;
+    s.BindFlags = output ? (D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE) : D3D11_BIND_SHADER_RESOURCE;
+    HRESULT hr = m_device->CreateTexture2D(&s, nullptr, &tex);
+    if (FAILED(hr)) {
+        _ERROR("[SL] Failed to create scratch %s texture (hr=0x%08X)", output ? "output" : "input", (unsigned)hr);
+        tex = nullptr;
+        return false;
+    }
+    DLSSVram::TrackTexture(tex, DLSSVram::Pool::SlScratch);
+    w = decision.scratchWidth; h = decision.scratchHeight; fmt = wantFmt;
+    return true;
+}
+#endif
+
+uint64_t SLBackend::LastCopyBytes(int eyeIndex) const {
+#ifdef USE_STREAMLINE
+    if (eyeIndex < 0 || eyeIndex >= kMaxEyes) return 0;
+    return m_copyBytes[eyeIndex];
+#else
+    (void)eyeIndex;
+    return 0;
+#endif
+}
+
+float SLBackend::LastSubmitMs(int eyeIndex) const {
+#ifdef USE_STREAMLINE
+    if (eyeIndex < 0 || eyeIndex >= kMaxEyes) return 0.0f;
+    return m_submitMs[eyeIndex];
+#else
+    (void)eyeIndex;
+    return 0.0f;
+#endif
+}
+
+void SLBackend::SetPersistentTags(bool enabled) {
+#ifdef USE_STREAMLINE
+    if (m_persistentTags == enabled) return;
+    m_persistentTags = enabled;
+    _MESSAGE("[SL] Persistent resource tags %s", enabled ? "enabled" : "disabled (rebuilt every frame)");
+#else
+    (void)enabled;
+#endif
+}
+
+void SLBackend::ReleaseIdleResources(uint64_t idleBefore) {
+#ifdef USE_STREAMLINE
+    if (!m_ready) return;
+    for (int i = 0; i < kMaxEyes; ++i) {
+        if (m_eyeUseFrame[i] >= idleBefore) continue;
+        ReleaseEyeScratch(i);
+        // Streamline re-allocates the viewport's DLSS resources on the next evaluate
+        if (m_vpAllocated[i] && m_viewports[i] != 0) {
+            slFreeResources(sl::kFeatureDLSS, m_viewports[i]);
+            m_vpAllocated[i] = false;
+        }
+        m_vpInW[i] = m_vpInH[i] = m_vpOutW[i] = m_vpOutH[i] = 0;
+    }
+#else
+    (void)idleBefore;
+#endif
+}
+
 void SLBackend::SetQuality(int qualityEnum) {
 #ifdef USE_STREAMLINE
     m_quality = qualityEnum;
-    switch (qualityEnum) {
-        case 0: m_options.mode = sl::DLSSMode::eMaxPerformance; break; // Perf
-        case 1: m_options.mode = sl::DLSSMode::eBalanced; break;       // Balanced
-        case 2: m_options.mode = sl::DLSSMode::eMaxQuality; break;     // Quality
-        case 3: m_options.mode = sl::DLSSMode::eUltraPerformance; break;
-        case 4: m_options.mode = sl::DLSSMode::eUltraQuality; break;
-        case 5: m_options.mode = sl::DLSSMode::eDLAA; break;
-        default: m_options.mode = sl::DLSSMode::eMaxQuality; break;
-    }
+    m_options.mode = ToDLSSMode(qualityEnum);
+    ++m_optionsSerial;
     _MESSAGE("[SL] Backend quality set: %d -> DLSSMode=%u", qualityEnum, (unsigned)m_options.mode);
 #endif
 }
 
+void SLBackend::SetEyeQuality(int eyeIndex, int qualityEnum) {
+#ifdef USE_STREAMLINE
+    if (eyeIndex < 0 || eyeIndex >= kMaxEyes || m_eyeQuality[eyeIndex] == qualityEnum) return;
+    m_eyeQuality[eyeIndex] = qualityEnum;
+    // Only this eye's viewport resends its options
+    m_stereo.eyes[eyeIndex].optionsSerial = 0;
+    _MESSAGE("[SL] Eye %d quality set: %d", eyeIndex, qualityEnum);
+#else
+    (void)eyeIndex; (void)qualityEnum;
+#endif
+}
+
+bool SLBackend::SetOutputOrigin(int eyeIndex, uint32_t x, uint32_t y) {
+#ifdef USE_STREAMLINE
+    if (eyeIndex < 0 || eyeIndex >= kMaxEyes) return false;
+    m_outputOrigin[eyeIndex][0] = x;
+    m_outputOrigin[eyeIndex][1] = y;
+    return true;
+#else
+    (void)eyeIndex;
+    return x == 0 && y == 0;
+#endif
+}
+
 void SLBackend::SetSharpness(float value) {
 #ifdef USE_STREAMLINE
     m_sharpness = value;
-    m_options.sharpness = value; // deprecated in 2.9 but accepted
+    // Deprecated in 2.9 and ignored by DLSS 4 presets; DLSSManager runs its
+    // own CAS pass on the output, this only keeps older presets consistent
+    m_options.sharpness = value;
+    ++m_optionsSerial;
+#endif
+}
+
+void SLBackend::SetCameraConstants(int eyeIndex, const DLSSCamera::EyeConstants& constants) {
+#ifdef USE_STREAMLINE
+    if (eyeIndex < 0 || eyeIndex >= kMaxEyes) return;
+    m_camera[eyeIndex] = constants;
+#else
+    (void)eyeIndex; (void)constants;
 #endif
 }
 
 void SLBackend::BeginFrame() {
 #ifdef USE_STREAMLINE
-    if (m_frameActive) {
+    // A token nothing was evaluated under yet is still this frame's
+    if (m_stereo.token && m_stereo.evaluated == 0) {
         return;
     }
     sl::FrameToken* token = nullptr;
     if (sl::Result fr = slGetNewFrameToken(token, nullptr); fr != sl::Result::eOk || !token) {
         _ERROR("[SL] slGetNewFrameToken failed: %d", (int)fr);
-        m_frameToken = nullptr;
-        m_frameActive = false;
-        m_frameEyeCount = 0;
+        m_stereo.token = nullptr;
+        m_stereo.evaluated = 0;
         return;
     }
-    m_frameToken = token;
-    m_frameActive = true;
-    m_frameEyeCount = 0;
+    m_stereo.token = token;
+    m_stereo.evaluated = 0;
 #endif
 }
 
 void SLBackend::EndFrame() {
 #ifdef USE_STREAMLINE
-    m_frameToken = nullptr;
-    m_frameActive = false;
-    m_frameEyeCount = 0;
+    m_stereo.token = nullptr;
+    m_stereo.evaluated = 0;
 #endif
 }
 
@@ -261,6 +465,153 @@ void SLBackend::SetCurrentEyeIndex(int eyeIndex) {
 #endif
 }
 
+#ifdef USE_STREAMLINE
+uint64_t SLBackend::TextureSerial(ID3D11Texture2D* texture) {
+    if (!texture) return 0;
+    uint64_t serial = 0;
+    UINT size = sizeof(serial);
+    if (SUCCEEDED(texture->GetPrivateData(kTextureSerialGuid, &size, &serial)) && size == sizeof(serial)) {
+        return serial;
+    }
+    // First sight of this texture (or a new one at a released one's address)
+    serial = ++m_nextTextureSerial;
+    texture->SetPrivateData(kTextureSerialGuid, sizeof(serial), &serial);
+    return serial;
+}
+
+bool SLBackend::RefreshTags(int eyeIndex, ID3D11Texture2D* color, ID3D11Texture2D* depth, ID3D11Texture2D* motion,
+                            ID3D11Texture2D* output, uint32_t renderWidth, uint32_t renderHeight,
+                            uint32_t outputWidth, uint32_t outputHeight) {
+    EyeTagSet& set = m_stereo.eyes[eyeIndex];
+    auto mark = [this, &set](TagSlot slot, ID3D11Texture2D* tex, uint32_t w, uint32_t h) {
+        if (DLSSTagging::UpdateSlot(set.source[slot], DLSSTagging::SlotKey{ tex, TextureSerial(tex), w, h })) {
+            set.dirty |= 1u << slot;
+        }
+    };
+    mark(SlotColor, color, renderWidth, renderHeight);
+    mark(SlotDepth, depth, renderWidth, renderHeight);
+    mark(SlotMotion, motion, renderWidth, renderHeight);
+    mark(SlotOutput, output, outputWidth, outputHeight);
+    if (set.outputX != m_outputOrigin[eyeIndex][0] || set.outputY != m_outputOrigin[eyeIndex][1]) {
+        set.outputX = m_outputOrigin[eyeIndex][0];
+        set.outputY = m_outputOrigin[eyeIndex][1];
+        set.dirty |= 1u << SlotOutput;
+    }
+    if (!m_persistentTags) set.dirty = (1u << kTagSlots) - 1;
+    const uint32_t rebuilt = set.dirty;
+    if (rebuilt == 0) {
+        return set.usable;
+    }
+
+    bool analyzed = false;
+    if (rebuilt & (1u << SlotColor)) {
+        D3D11_TEXTURE2D_DESC desc{};
+        color->GetDesc(&desc);
+        set.input = m_tagCache[eyeIndex].Get(color, ToTextureInfo(desc), DLSSTagging::Role::Input,
+                                             DLSSTagging::Rect{0, 0, renderWidth, renderHeight}, &analyzed);
+        if (analyzed) LogTagDecision(eyeIndex, "input", desc, set.input);
+        set.tagInput = nullptr;
+        if (set.input.action == DLSSTagging::Action::Direct) {
+            set.tagInput = color;
+        } else if (set.input.action != DLSSTagging::Action::Unsupported && EnsureScratch(eyeIndex, false, set.input)) {
+            set.tagInput = m_scratchIn[eyeIndex];
+        }
+        // A failed scratch allocation is retried next frame
+        if (set.tagInput || set.input.action == DLSSTagging::Action::Unsupported) set.dirty &= ~(1u << SlotColor);
+        sl::Resource& r = set.resources[SlotColor];
+        r = sl::Resource{};
+        r.native = static_cast<void*>(static_cast<ID3D11Resource*>(set.tagInput));
+        r.type = sl::ResourceType::eTex2d;
+        r.width = (set.tagInput == color) ? desc.Width : set.input.scratchWidth;
+        r.height = (set.tagInput == color) ? desc.Height : set.input.scratchHeight;
+        r.nativeFormat = set.input.tagFormat;
+        set.extents[SlotColor] = ToExtent(set.input.extent);
+    }
+
+    if (rebuilt & (1u << SlotDepth)) {
+        set.dirty &= ~(1u << SlotDepth);
+        sl::Resource& r = set.resources[SlotDepth];
+        r = sl::Resource{};
+        if (depth) {
+            D3D11_TEXTURE2D_DESC d{};
+            depth->GetDesc(&d);
+            r.native = static_cast<void*>(static_cast<ID3D11Resource*>(depth));
+            r.type = sl::ResourceType::eTex2d;
+            r.width = d.Width; r.height = d.Height;
+            r.nativeFormat = static_cast<uint32_t>(ResolveDepthFormat(d.Format));
+            set.extents[SlotDepth] = ClampExtent(renderWidth, renderHeight, d.Width, d.Height);
+        }
+    }
+
+    if (rebuilt & (1u << SlotMotion)) {
+        set.dirty &= ~(1u << SlotMotion);
+        sl::Resource& r = set.resources[SlotMotion];
+        r = sl::Resource{};
+        if (motion) {
+            D3D11_TEXTURE2D_DESC m{};
+            motion->GetDesc(&m);
+            r.native = static_cast<void*>(static_cast<ID3D11Resource*>(motion));
+            r.type = sl::ResourceType::eTex2d;
+            r.width = m.Width; r.height = m.Height;
+            r.nativeFormat = static_cast<uint32_t>(m.Format);
+            set.extents[SlotMotion] = ClampExtent(renderWidth, renderHeight, m.Width, m.Height);
+        }
+    }
+
+    if (rebuilt & (1u << SlotOutput)) {
+        const DLSSTagging::Rect outputRect{output ? set.outputX : 0, output ? set.outputY : 0, outputWidth, outputHeight};
+        D3D11_TEXTURE2D_DESC o{};
+        if (output) {
+            output->GetDesc(&o);
+            set.output = m_tagCache[eyeIndex].Get(output, ToTextureInfo(o), DLSSTagging::Role::Output, outputRect, &analyzed);
+            if (analyzed) LogTagDecision(eyeIndex, "output", o, set.output);
+        } else {
+            // No target: DLSS writes a scratch that is returned as the result
+            set.output = DLSSTagging::Decision{};
+            set.output.action = DLSSTagging::Action::Copy;
+            set.output.tagFormat = set.output.scratchFormat = static_cast<uint32_t>(DXGI_FORMAT_R8G8B8A8_UNORM);
+            set.output.scratchWidth = outputWidth;
+            set.output.scratchHeight = outputHeight;
+            set.output.area = set.output.extent = outputRect;
+        }
+        set.tagOutput = nullptr;
+        if (set.output.action == DLSSTagging::Action::Direct) {
+            set.tagOutput = output;
+        } else if (set.output.action != DLSSTagging::Action::Unsupported && EnsureScratch(eyeIndex, true, set.output)) {
+            set.tagOutput = m_scratchOut[eyeIndex];
+        }
+        if (set.tagOutput || set.output.action == DLSSTagging::Action::Unsupported) set.dirty &= ~(1u << SlotOutput);
+        sl::Resource& r = set.resources[SlotOutput];
+        r = sl::Resource{};
+        r.native = static_cast<void*>(static_cast<ID3D11Resource*>(set.tagOutput));
+        r.type = sl::ResourceType::eTex2d;
+        r.width = (set.tagOutput == output) ? o.Width : set.output.scratchWidth;
+        r.height = (set.tagOutput == output) ? o.Height : set.output.scratchHeight;
+        r.nativeFormat = set.output.tagFormat;
+        set.extents[SlotOutput] = ToExtent(set.output.extent);
+    }
+
+    // Tags point into the set, so the array stays valid across frames
+    set.numTags = 0;
+    auto add = [&set](TagSlot slot, sl::BufferType type) {
+        set.tags[set.numTags++] = sl::ResourceTag(&set.resources[slot], type, sl::ResourceLifecycle::eValidUntilEvaluate, &set.extents[slot]);
+    };
+    if (set.tagInput) add(SlotColor, sl::kBufferTypeScalingInputColor);
+    if (depth) add(SlotDepth, sl::kBufferTypeDepth);
+    if (motion) add(SlotMotion, sl::kBufferTypeMotionVectors);
+    if (set.tagOutput) add(SlotOutput, sl::kBufferTypeScalingOutputColor);
+    set.usable = set.tagInput && set.tagOutput;
+
+    if (m_persistentTags) {
+        _MESSAGE("[SL] Eye %d tags rebuilt (slots 0x%X): in=%ux%u(tex=%ux%u) out=%ux%u(tex=%ux%u) depth=%d mv=%d",
+                 eyeIndex, rebuilt, renderWidth, renderHeight, set.resources[SlotColor].width, set.resources[SlotColor].height,
+                 outputWidth, outputHeight, set.resources[SlotOutput].width, set.resources[SlotOutput].height,
+                 depth ? 1 : 0, motion ? 1 : 0);
+    }
+    return set.usable;
+}
+#endif
+
 ID3D11Texture2D* SLBackend::ProcessEye(ID3D11Texture2D* inputColor,
                                        ID3D11Texture2D* inputDepth,
                                        ID3D11Texture2D* inputMotionVectors,
@@ -277,24 +628,30 @@ ID3D11Texture2D* SLBackend::ProcessEye(ID3D11Texture2D* inputColor,
         return inputColor;
     }
 
-    if (!m_frameActive || !m_frameToken) {
-        BeginFrame();
-        if (!m_frameActive || !m_frameToken) {
-            return inputColor;
-        }
-    }
-
     int eyeIndex = m_currentEye;
     if (eyeIndex < 0 || eyeIndex >= kMaxEyes) {
         eyeIndex = 0;
     }
+    SubmitTimer timer(m_submitMs[eyeIndex]);
 
+    // An eye already evaluated under the current token starts the next
+    // stereo frame (the other eye was skipped or failed)
+    const uint32_t eyeBit = 1u << eyeIndex;
+    if (!m_stereo.token || (m_stereo.evaluated & eyeBit)) {
+        BeginFrame();
+        if (!m_stereo.token) {
+            return inputColor;
+        }
+    }
+
+    m_eyeUseFrame[eyeIndex] = DLSSVram::Global().Frame();
     sl::ViewportHandle& viewport = m_viewports[eyeIndex];
     bool& vpAllocated = m_vpAllocated[eyeIndex];
     unsigned int& vpInW = m_vpInW[eyeIndex];
     unsigned int& vpInH = m_vpInH[eyeIndex];
     unsigned int& vpOutW = m_vpOutW[eyeIndex];
     unsigned int& vpOutH = m_vpOutH[eyeIndex];
+    EyeTagSet& set = m_stereo.eyes[eyeIndex];
 
     if (!vpAllocated) {
         viewport = sl::ViewportHandle(eyeIndex + 1);
@@ -310,156 +667,61 @@ ID3D11Texture2D* SLBackend::ProcessEye(ID3D11Texture2D* inputColor,
         // Free any previous allocations for this viewport; Streamline will re-allocate lazily on evaluate
         slFreeResources(sl::kFeatureDLSS, viewport);
         vpAllocated = false;
+        set.optionsSerial = 0;
+        DLSSFrameTiming::Global().Note(DLSSFrameTiming::Event::FeatureCreate);
     }
 
-    // Wrap resources
-    D3D11_TEXTURE2D_DESC inDesc{};
-    inputColor->GetDesc(&inDesc);
-
-    // Decide on scratch fallback for input
-    const bool needScratchIn = (inDesc.Usage != D3D11_USAGE_DEFAULT) || (inDesc.SampleDesc.Count > 1) || ((inDesc.BindFlags & D3D11_BIND_SHADER_RESOURCE) == 0);
-
-    ID3D11Texture2D* tagInput = inputColor;
-    if (needScratchIn) {
-        // Create or resize scratch input (SRV-capable)
-        bool create = (m_scratchIn[eyeIndex] == nullptr) || m_scratchInW[eyeIndex] != renderWidth || m_scratchInH[eyeIndex] != renderHeight || m_scratchInFmt[eyeIndex] != inDesc.Format;
-        if (create) {
-            if (m_scratchIn[eyeIndex]) { m_scratchIn[eyeIndex]->Release(); m_scratchIn[eyeIndex] = nullptr; }
-            D3D11_TEXTURE2D_DESC s{};
-            s.Width = renderWidth; s.Height = renderHeight; s.MipLevels = 1; s.ArraySize = 1;
-            s.Format = inDesc.Format; s.SampleDesc.Count = 1; s.SampleDesc.Quality = 0;
-            s.Usage = D3D11_USAGE_DEFAULT; s.BindFlags = D3D11_BIND_SHADER_RESOURCE; s.CPUAccessFlags = 0; s.MiscFlags = 0;
-            HRESULT hr = m_device->CreateTexture2D(&s, nullptr, &m_scratchIn[eyeIndex]);
-            if (FAILED(hr)) {
-                _ERROR("[SL] Failed to create scratch input texture (hr=0x%08X)", (unsigned)hr);
-            } else {
-                m_scratchInW[eyeIndex] = renderWidth; m_scratchInH[eyeIndex] = renderHeight; m_scratchInFmt[eyeIndex] = inDesc.Format;
-            }
-        }
-        if (m_scratchIn[eyeIndex]) {
-            // Copy region from source to scratch
-            D3D11_BOX srcBox{}; srcBox.left = 0; srcBox.top = 0; srcBox.front = 0; srcBox.right = renderWidth; srcBox.bottom = renderHeight; srcBox.back = 1;
-            m_context->CopySubresourceRegion(m_scratchIn[eyeIndex], 0, 0, 0, 0, inputColor, 0, &srcBox);
-            tagInput = m_scratchIn[eyeIndex];
-        } else {
-            tagInput = inputColor; // fallback to original
-        }
+    // Tag set: only slots whose texture or size changed are rebuilt
+    if (!RefreshTags(eyeIndex, inputColor, inputDepth, inputMotionVectors, outputTarget,
+                     renderWidth, renderHeight, outputWidth, outputHeight)) {
+        return inputColor;
     }
 
-    sl::Resource color{};
-    color.native = static_cast<void*>(static_cast<ID3D11Resource*>(tagInput));
-    color.type = sl::ResourceType::eTex2d;
-    color.width = needScratchIn ? renderWidth : inDesc.Width;
-    color.height = needScratchIn ? renderHeight : inDesc.Height;
-    color.nativeFormat = static_cast<uint32_t>(inDesc.Format);
-
-    // Build extents as full-rects (left=0, top=0) and clamp to resource sizes
-    auto clampTo = [](uint32_t wantW, uint32_t wantH, uint32_t resW, uint32_t resH) -> sl::Extent {
-        sl::Extent e{};
-        e.left = 0; e.top = 0;
-        e.width = (wantW > resW) ? resW : wantW;
-        e.height = (wantH > resH) ? resH : wantH;
-        if (e.width == 0) e.width = resW; // fall back to full size if caller passed 0
-        if (e.height == 0) e.height = resH;
-        return e;
-    };
-
-    const sl::Extent inExtent = clampTo(renderWidth, renderHeight, color.width, color.height);
-
-    sl::ResourceTag tags[5] = {
-        sl::ResourceTag(&color, sl::kBufferTypeScalingInputColor, sl::ResourceLifecycle::eValidUntilEvaluate, &inExtent)
-    };
-    uint32_t numTags = 1;
-
-    sl::Resource depth{};
-    if (inputDepth) {
-        D3D11_TEXTURE2D_DESC d{}; inputDepth->GetDesc(&d);
-        depth.native = static_cast<void*>(static_cast<ID3D11Resource*>(inputDepth));
-        depth.type = sl::ResourceType::eTex2d;
-        depth.width = d.Width; depth.height = d.Height;
-        depth.nativeFormat = static_cast<uint32_t>(ResolveDepthFormat(d.Format));
-        const sl::Extent dpExtent = clampTo(renderWidth, renderHeight, d.Width, d.Height);
-        tags[numTags++] = sl::ResourceTag(&depth, sl::kBufferTypeDepth, sl::ResourceLifecycle::eValidUntilEvaluate, &dpExtent);
-    }
-
-    sl::Resource mv{};
-    if (inputMotionVectors) {
-        D3D11_TEXTURE2D_DESC m{}; inputMotionVectors->GetDesc(&m);
-        mv.native = static_cast<void*>(static_cast<ID3D11Resource*>(inputMotionVectors));
-        mv.type = sl::ResourceType::eTex2d;
-        mv.width = m.Width; mv.height = m.Height; mv.nativeFormat = static_cast<uint32_t>(m.Format);
-        const sl::Extent mvExtent = clampTo(renderWidth, renderHeight, m.Width, m.Height);
-        tags[numTags++] = sl::ResourceTag(&mv, sl::kBufferTypeMotionVectors, sl::ResourceLifecycle::eValidUntilEvaluate, &mvExtent);
-    }
-
-    // Output: prefer provided target if UAV-capable; else use scratch output
-    sl::Resource out{};
-    ID3D11Texture2D* tagOutput = outputTarget;
-    D3D11_TEXTURE2D_DESC o{};
-    bool usingScratchOut = false;
-    if (outputTarget) { outputTarget->GetDesc(&o); }
-    const bool needScratchOut = (!outputTarget) || (o.Usage != D3D11_USAGE_DEFAULT) || (o.SampleDesc.Count > 1) || ((o.BindFlags & D3D11_BIND_UNORDERED_ACCESS) == 0);
-    if (needScratchOut) {
-        DXGI_FORMAT outFmt = outputTarget ? o.Format : DXGI_FORMAT_R8G8B8A8_UNORM;
-        bool create = (m_scratchOut[eyeIndex] == nullptr) || m_scratchOutW[eyeIndex] != outputWidth || m_scratchOutH[eyeIndex] != outputHeight || m_scratchOutFmt[eyeIndex] != outFmt;
-        if (create) {
-            if (m_scratchOut[eyeIndex]) { m_scratchOut[eyeIndex]->Release(); m_scratchOut[eyeIndex] = nullptr; }
-            D3D11_TEXTURE2D_DESC s{};
-            s.Width = outputWidth; s.Height = outputHeight; s.MipLevels = 1; s.ArraySize = 1;
-            s.Format = outFmt; s.SampleDesc.Count = 1; s.SampleDesc.Quality = 0;
-            s.Usage = D3D11_USAGE_DEFAULT; s.BindFlags = D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE; s.CPUAccessFlags = 0; s.MiscFlags = 0;
-            HRESULT hr = m_device->CreateTexture2D(&s, nullptr, &m_scratchOut[eyeIndex]);
-            if (FAILED(hr)) {
-                _ERROR("[SL] Failed to create scratch output texture (hr=0x%08X)", (unsigned)hr);
-            } else {
-                m_scratchOutW[eyeIndex] = outputWidth; m_scratchOutH[eyeIndex] = outputHeight; m_scratchOutFmt[eyeIndex] = outFmt;
-            }
-        }
-        if (m_scratchOut[eyeIndex]) {
-            tagOutput = m_scratchOut[eyeIndex];
-            usingScratchOut = true;
-            // refresh desc 'o' to point to scratch dims
-            o.Width = outputWidth; o.Height = outputHeight; o.Format = m_scratchOutFmt[eyeIndex];
+    // Input color DLSS cannot read in place is copied (or the MSAA texture
+    // resolved) into the tagged scratch
+    uint64_t copiedBytes = 0;
+    if (set.tagInput != inputColor) {
+        if (set.input.action == DLSSTagging::Action::Resolve) {
+            m_context->ResolveSubresource(set.tagInput, 0, inputColor, 0, static_cast<DXGI_FORMAT>(set.input.scratchFormat));
+        } else {
+            const DLSSTagging::Rect& a = set.input.area;
+            const D3D11_BOX box{a.x, a.y, 0, a.x + a.width, a.y + a.height, 1};
+            m_context->CopySubresourceRegion(set.tagInput, 0, 0, 0, 0, inputColor, 0, &box);
         }
-    }
-    if (tagOutput) {
-        out.native = static_cast<void*>(static_cast<ID3D11Resource*>(tagOutput));
-        out.type = sl::ResourceType::eTex2d;
-        out.width = o.Width; out.height = o.Height; out.nativeFormat = static_cast<uint32_t>(o.Format);
-        const sl::Extent clampedOutExtent = clampTo(outputWidth, outputHeight, out.width, out.height);
-        tags[numTags++] = sl::ResourceTag(&out, sl::kBufferTypeScalingOutputColor, sl::ResourceLifecycle::eValidUntilEvaluate, &clampedOutExtent);
+        copiedBytes += set.input.bytesPerFrame;
     }
 
-    m_options.outputWidth = outputWidth;
-    m_options.outputHeight = outputHeight;
     sl::Constants consts{};
     consts.mvecScale.x = (renderWidth > 0) ? (1.0f / (float)renderWidth) : 1.0f;
     consts.mvecScale.y = (renderHeight > 0) ? (1.0f / (float)renderHeight) : 1.0f;
-    consts.jitterOffset.x = 0.0f; consts.jitterOffset.y = 0.0f;
-    // Provide sane defaults for validation (will be refined when camera data is available)
-    // Matrices: set to identity (row-major) to avoid 'invalid' warnings until real values are wired
-    auto setIdentity = [](sl::float4x4& m) {
-        m.setRow(0, sl::float4(1.f, 0.f, 0.f, 0.f));
-        m.setRow(1, sl::float4(0.f, 1.f, 0.f, 0.f));
-        m.setRow(2, sl::float4(0.f, 0.f, 1.f, 0.f));
-        m.setRow(3, sl::float4(0.f, 0.f, 0.f, 1.f));
+    // Camera data comes from DLSSCamera::CameraConstantsProvider (OpenVR projection + HMD pose).
+    // Until the first valid set arrives the defaults below keep SL validation quiet.
+    const DLSSCamera::EyeConstants& cam = m_camera[eyeIndex];
+    auto toSL = [](sl::float4x4& dst, const DLSSCamera::Float4x4& src) {
+        for (int r = 0; r < 4; ++r) {
+            dst.setRow(r, sl::float4(src.m[r][0], src.m[r][1], src.m[r][2], src.m[r][3]));
+        }
     };
-    setIdentity(consts.cameraViewToClip);
-    setIdentity(consts.clipToCameraView);
-    setIdentity(consts.clipToPrevClip);
-    setIdentity(consts.prevClipToClip);
-    consts.cameraNear = 0.1f;
-    consts.cameraFar  = 10000.0f;
-    // Rough aspect from output (fallback)
-    const float outAspect = (outputHeight > 0) ? (float)outputWidth / (float)outputHeight : 1.0f;
-    consts.cameraAspectRatio = outAspect;
-    // Provide a plausible FOV placeholder (radians)
-    consts.cameraFOV = 1.0f;
-    // Camera basis defaults
-    consts.cameraPos = sl::float3(0.f, 0.f, 0.f);
-    consts.cameraUp = sl::float3(0.f, 1.f, 0.f);
-    consts.cameraRight = sl::float3(1.f, 0.f, 0.f);
-    consts.cameraFwd = sl::float3(0.f, 0.f, 1.f);
+    consts.jitterOffset.x = cam.jitterX;
+    consts.jitterOffset.y = cam.jitterY;
+    toSL(consts.cameraViewToClip, cam.viewToClip);
+    toSL(consts.clipToCameraView, cam.clipToView);
+    toSL(consts.clipToPrevClip, cam.clipToPrevClip);
+    toSL(consts.prevClipToClip, cam.prevClipToClip);
+    consts.cameraNear = cam.nearZ;
+    consts.cameraFar  = cam.farZ;
+    if (cam.valid) {
+        consts.cameraAspectRatio = cam.aspect;
+        consts.cameraFOV = cam.fovY;
+    } else {
+        // Rough aspect from output (fallback)
+        consts.cameraAspectRatio = (outputHeight > 0) ? (float)outputWidth / (float)outputHeight : 1.0f;
+        consts.cameraFOV = 1.0f;
+    }
+    consts.cameraPos = sl::float3(cam.position[0], cam.position[1], cam.position[2]);
+    consts.cameraUp = sl::float3(cam.up[0], cam.up[1], cam.up[2]);
+    consts.cameraRight = sl::float3(cam.right[0], cam.right[1], cam.right[2]);
+    consts.cameraFwd = sl::float3(cam.forward[0], cam.forward[1], cam.forward[2]);
     consts.cameraPinholeOffset = sl::float2(0.f, 0.f);
     // Assume 2D pixel-space motion vectors by default
     consts.motionVectorsInvalidValue = 0.0f;
@@ -470,32 +732,32 @@ ID3D11Texture2D* SLBackend::ProcessEye(ID3D11Texture2D* inputColor,
     // Per-eye tagging order:
     // 1) Tags -> 2) Constants -> 3) Options -> 4) Evaluate
     // D3D11: pass immediate context as command buffer to SL
-    sl::Result rt = slSetTagForFrame(*m_frameToken, viewport, tags, numTags, reinterpret_cast<sl::CommandBuffer*>(m_context));
+    sl::Result rt = slSetTagForFrame(*m_stereo.token, viewport, set.tags, set.numTags, reinterpret_cast<sl::CommandBuffer*>(m_context));
     if (rt != sl::Result::eOk) {
-        _ERROR("[SL] slSetTagForFrame failed: %d (tags=%u)", (int)rt, numTags);
+        _ERROR("[SL] Eye %d: slSetTagForFrame failed: %d (tags=%u)", eyeIndex, (int)rt, set.numTags);
+    }
+
+    (void)slSetConstants(consts, *m_stereo.token, viewport);
+    // Options persist per viewport; resend only when they or the output size changed
+    if (set.optionsSerial != m_optionsSerial || set.optionsOutW != outputWidth || set.optionsOutH != outputHeight) {
+        sl::DLSSOptions options = m_options;
+        if (m_eyeQuality[eyeIndex] >= 0) options.mode = ToDLSSMode(m_eyeQuality[eyeIndex]);
+        options.outputWidth = outputWidth;
+        options.outputHeight = outputHeight;
+        if (slDLSSSetOptions(viewport, options) == sl::Result::eOk) {
+            set.optionsSerial = m_optionsSerial;
+            set.optionsOutW = outputWidth;
+            set.optionsOutH = outputHeight;
+        }
     }
 
-    (void)slSetConstants(consts, *m_frameToken, viewport);
-    (void)slDLSSSetOptions(viewport, m_options);
-
-    _MESSAGE("[SL] ProcessEye: eye=%d", eyeIndex);
-    _MESSAGE("[SL] Evaluate: in=%ux%u(outTex=%ux%u) out=%ux%u(outTex=%ux%u) depth=%d mv=%d",
-             renderWidth, renderHeight, inDesc.Width, inDesc.Height,
-             outputWidth, outputHeight, out.width, out.height,
-             inputDepth?1:0, inputMotionVectors?1:0);
     const sl::BaseStructure* inputs[] = { reinterpret_cast<const sl::BaseStructure*>(&viewport) };
-    sl::Result rEval = slEvaluateFeature(sl::kFeatureDLSS, *m_frameToken, inputs, 1, reinterpret_cast<sl::CommandBuffer*>(m_context));
+    sl::Result rEval = slEvaluateFeature(sl::kFeatureDLSS, *m_stereo.token, inputs, 1, reinterpret_cast<sl::CommandBuffer*>(m_context));
     if (rEval != sl::Result::eOk) {
-        _ERROR("[SL] slEvaluateFeature failed: %d", (int)rEval);
-        
         // Error recovery mechanism
         static int errorCount = 0;
         errorCount++;
-        
-        // Log first occurrence with details
-        if (errorCount == 1) {
-            _ERROR("[SL] First error occurrence - eye:%d", eyeIndex);
-        }
+        _ERROR("[SL] Eye %d: slEvaluateFeature failed: %d (failure %d)", eyeIndex, (int)rEval, errorCount);
         
         // Attempt recovery after 10 failures
         if (errorCount == 10) {
@@ -529,22 +791,23 @@ ID3D11Texture2D* SLBackend::ProcessEye(ID3D11Texture2D* inputColor,
         // Clear any error state after consistent success
     }
 
-    // If we used scratch output and a real output target exists with same format/size, copy result back
-    if (usingScratchOut && outputTarget && m_scratchOut[eyeIndex]) {
-        // Only copy if formats and dimensions match exactly
-        if (o.Format == m_scratchOutFmt[eyeIndex] && o.Width == m_scratchOutW[eyeIndex] && o.Height == m_scratchOutH[eyeIndex]) {
-            m_context->CopyResource(outputTarget, m_scratchOut[eyeIndex]);
-        }
+    // Scratch output goes into the target's extent; the target is the result
+    ID3D11Texture2D* result = set.tagOutput;
+    if (outputTarget && result != outputTarget) {
+        const DLSSTagging::Rect& a = set.output.area;
+        const D3D11_BOX box{0, 0, 0, a.width, a.height, 1};
+        m_context->CopySubresourceRegion(outputTarget, 0, a.x, a.y, 0, result, 0, &box);
+        copiedBytes += set.output.bytesPerFrame;
+        result = outputTarget;
     }
+    m_copyBytes[eyeIndex] = copiedBytes;
 
-    ++m_frameEyeCount;
-    if (m_frameEyeCount >= kMaxEyes) {
+    m_stereo.evaluated |= eyeBit;
+    if (m_stereo.evaluated == (1u << kMaxEyes) - 1) {
         EndFrame();
     }
 
-    // Return chosen output if available; otherwise return input
-    if (tagOutput) return tagOutput;
-    return tagInput ? tagInput : inputColor;
+    return result;
 #endif
 }
 
@@ -12,18 +12,27 @@
 
 #include "common/IDebugLog.h"
 #include "backends/IUpscaleBackend.h"
+#include "dlss_tagging.h"
 
 class SLBackend : public IUpscaleBackend {
 public:
     SLBackend();
     ~SLBackend() override;
 
+    bool Prepare(ID3D11Device* device) override;
     bool Init(ID3D11Device* device, ID3D11DeviceContext* context) override;
     void Shutdown() override;
     bool IsReady() const override { return m_ready; }
 
     void SetQuality(int qualityEnum) override;
     void SetSharpness(float value) override;
+    void SetEyeQuality(int eyeIndex, int qualityEnum) override;
+    bool SetOutputOrigin(int eyeIndex, uint32_t x, uint32_t y) override;
+    void SetCameraConstants(int eyeIndex, const DLSSCamera::EyeConstants& constants) override;
+    void ReleaseIdleResources(uint64_t idleBefore) override;
+    uint64_t LastCopyBytes(int eyeIndex) const override;
+    float LastSubmitMs(int eyeIndex) const override;
+    void SetPersistentTags(bool enabled) override;
 
     ID3D11Texture2D* ProcessEye(ID3D11Texture2D* inputColor,
                                 ID3D11Texture2D* inputDepth,
@@ -43,6 +52,7 @@ public:
 
 private:
     bool m_ready = false;
+    bool m_prepared = false;   // slInit done and adapter probed (may have run off-thread)
     ID3D11Device* m_device = nullptr;
     ID3D11DeviceContext* m_context = nullptr;
 
@@ -51,6 +61,8 @@ private:
     sl::ViewportHandle m_viewports[kMaxEyes]{};
     sl::DLSSOptions m_options{};
     int m_quality = 2; // default Quality
+    int m_eyeQuality[kMaxEyes] = { -1, -1 };  // per-eye override of m_options.mode, -1 = none
+    uint32_t m_outputOrigin[kMaxEyes][2]{};   // SetOutputOrigin, applied by RefreshTags
     float m_sharpness = 0.0f;
     bool m_vpAllocated[kMaxEyes]{};
     unsigned int m_vpInW[kMaxEyes]{};
@@ -58,11 +70,53 @@ private:
     unsigned int m_vpOutW[kMaxEyes]{};
     unsigned int m_vpOutH[kMaxEyes]{};
     int m_currentEye = 0;
-    sl::FrameToken* m_frameToken = nullptr;
-    bool m_frameActive = false;
-    uint32_t m_frameEyeCount = 0;
+    DLSSCamera::EyeConstants m_camera[kMaxEyes]{};
 
-    // Scratch fallback resources to ensure DLSS gets clonable SRV/UAV textures
+    // Per-eye tagging decisions (direct, copy or resolve) by texture
+    DLSSTagging::DecisionCache m_tagCache[kMaxEyes];
+    uint64_t m_copyBytes[kMaxEyes]{};  // scratch copy/resolve bytes of the eye's last evaluate
+    float m_submitMs[kMaxEyes]{};      // ProcessEye CPU time (tags, constants, options, evaluate), smoothed
+
+    // An eye's resource tags, kept across frames. Each slot is rebuilt only
+    // when its texture (pointer and creation serial) or requested size
+    // changes (dirty bit per slot); the tags point into the set, so it must
+    // not move. With persistent tags off every slot is rebuilt each frame.
+    enum TagSlot : uint32_t { SlotColor = 0, SlotDepth, SlotMotion, SlotOutput, kTagSlots };
+    struct EyeTagSet {
+        DLSSTagging::SlotKey source[kTagSlots];  // texture and size each slot was built from
+        uint32_t dirty = (1u << kTagSlots) - 1;
+        bool usable = false;                   // color and output are tagged
+        sl::Resource resources[kTagSlots]{};
+        sl::Extent extents[kTagSlots]{};
+        sl::ResourceTag tags[kTagSlots]{};
+        uint32_t numTags = 0;
+        DLSSTagging::Decision input;           // color: direct, copy or resolve
+        DLSSTagging::Decision output;
+        ID3D11Texture2D* tagInput = nullptr;   // color texture or input scratch
+        ID3D11Texture2D* tagOutput = nullptr;  // output target or output scratch
+        uint32_t outputX = 0;                  // origin of the eye in the output target (stereo atlas)
+        uint32_t outputY = 0;
+        uint32_t optionsSerial = 0;            // m_optionsSerial last sent to the viewport
+        uint32_t optionsOutW = 0;
+        uint32_t optionsOutH = 0;
+    };
+
+    // Both eyes' tag sets and the frame token they are evaluated under. The
+    // frame ends once every eye evaluated, or when an eye comes round again.
+    struct StereoFrame {
+        sl::FrameToken* token = nullptr;
+        uint32_t evaluated = 0;  // eye bits evaluated under token
+        EyeTagSet eyes[kMaxEyes];
+    };
+    StereoFrame m_stereo;
+    uint32_t m_optionsSerial = 1;  // bumped when m_options changes
+    bool m_persistentTags = true;
+    uint64_t m_nextTextureSerial = 0;
+
+    // Creation serial of a texture, stored in its private data on first sight
+    uint64_t TextureSerial(ID3D11Texture2D* texture);
+
+    // Scratch fallback resources for textures DLSS cannot tag directly
     ID3D11Texture2D* m_scratchIn[kMaxEyes]{};
     ID3D11Texture2D* m_scratchOut[kMaxEyes]{};
     unsigned int m_scratchInW[kMaxEyes]{};
@@ -71,6 +125,13 @@ private:
     unsigned int m_scratchOutW[kMaxEyes]{};
     unsigned int m_scratchOutH[kMaxEyes]{};
     DXGI_FORMAT m_scratchOutFmt[kMaxEyes]{};
+    uint64_t m_eyeUseFrame[kMaxEyes]{};  // DLSSVram frame of the eye's last ProcessEye
+
+    void ReleaseEyeScratch(int eyeIndex);
+    bool EnsureScratch(int eyeIndex, bool output, const DLSSTagging::Decision& decision);
+    bool RefreshTags(int eyeIndex, ID3D11Texture2D* color, ID3D11Texture2D* depth, ID3D11Texture2D* motion,
+                     ID3D11Texture2D* output, uint32_t renderWidth, uint32_t renderHeight,
+                     uint32_t outputWidth, uint32_t outputHeight);
 #endif
 };
 
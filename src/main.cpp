@@ -13,6 +13,7 @@
 
 // Plugin handle
 static PluginHandle g_pluginHandle = kPluginHandle_Invalid;
+static F4SEMessagingInterface* g_messaging = nullptr;
 
 // Version info
 #define PLUGIN_VERSION_MAJOR 1
@@ -118,6 +119,22 @@ static bool DetectExternalOverlays() {
     return detected;
 }
 
+// Game loads invalidate the upscaler history; see DLSSHistory
+static void OnF4SEMessage(F4SEMessagingInterface::Message* msg) {
+    if (!msg) return;
+    switch (msg->type) {
+        case F4SEMessagingInterface::kMessage_PreLoadGame:
+            SetGameLoading(true);
+            break;
+        case F4SEMessagingInterface::kMessage_PostLoadGame:
+        case F4SEMessagingInterface::kMessage_NewGame:
+            SetGameLoading(false);
+            break;
+        default:
+            break;
+    }
+}
+
 // F4SE Plugin API functions
 extern "C" {
     
@@ -230,6 +247,15 @@ __declspec(dllexport) bool F4SEPlugin_Load(const F4SEInterface* f4se) {
         g_pluginHandle = f4se->GetPluginHandle();
         Log("Plugin Handle: %u", g_pluginHandle);
     }
+
+    if (f4se->QueryInterface) {
+        g_messaging = static_cast<F4SEMessagingInterface*>(f4se->QueryInterface(kInterface_Messaging));
+    }
+    if (g_messaging && g_pluginHandle != kPluginHandle_Invalid && g_messaging->RegisterListener(g_pluginHandle, "F4SE", OnF4SEMessage)) {
+        Log("F4SE message listener registered");
+    } else {
+        Log("WARNING: F4SE messaging unavailable; game loads will not reset DLSS history");
+    }
     
     // Install D3D11 hooks
     if (!InstallDLSSHooks()) {
@@ -0,0 +1,166 @@
+#include "dlss_arena.h"
+#include "dlss_ctxstate.h"
+#include "dlss_passgraph.h"
+#include "dlss_redirect.h"
+#include "test_common.h"
+
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+
+// Every heap allocation in the process goes through these, so a test can
+// count what a stretch of code allocated
+namespace {
+    size_t g_allocations = 0;
+
+    void* CountedAlloc(size_t bytes) {
+        ++g_allocations;
+        if (void* p = std::malloc(bytes ? bytes : 1)) return p;
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(size_t bytes) { return CountedAlloc(bytes); }
+void* operator new[](size_t bytes) { return CountedAlloc(bytes); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+using namespace DLSSArena;
+
+namespace {
+    // FrameMap against std::unordered_map, across Clear() and arena Resets
+    void TestFrameMap() {
+        FrameArena arena(1024);
+        FrameMap<uintptr_t, uint32_t> map(arena);
+        std::unordered_map<uintptr_t, uint32_t> ref;
+        std::mt19937 rng(1);
+        for (int frame = 0; frame < 50; ++frame) {
+            for (int i = 0; i < 3000; ++i) {
+                const uintptr_t key = rng() % 2000;
+                if (rng() % 2) {
+                    const uint32_t value = rng();
+                    map.Set(key, value);
+                    ref[key] = value;
+                } else {
+                    const uint32_t* found = map.Find(key);
+                    const auto it = ref.find(key);
+                    CHECK((found != nullptr) == (it != ref.end()));
+                    if (found && it != ref.end()) CHECK(*found == it->second);
+                }
+            }
+            CHECK(map.Size() == ref.size());
+            if (frame % 2) map.Clear(); else arena.Reset();
+            ref.clear();
+            CHECK(map.Size() == 0 && !map.Find(5));
+        }
+    }
+
+    // A frame that outgrows the block spills once; the next Reset grows the
+    // block to the peak and the same frame then fits without the heap
+    void TestSpillAndGrow() {
+        FrameArena arena(1024);
+        for (int i = 0; i < 64; ++i) CHECK(arena.Allocate(100) != nullptr);
+        const Stats spilled = arena.GetStats();
+        CHECK(spilled.spills > 0 && spilled.used >= 6400);
+        arena.Reset();
+        CHECK(arena.GetStats().grows == 1 && arena.GetStats().capacity >= spilled.peak);
+
+        const size_t before = g_allocations;
+        for (int frame = 0; frame < 10; ++frame) {
+            for (int i = 0; i < 64; ++i) {
+                double* d = arena.AllocateArray<double>(12);
+                CHECK(reinterpret_cast<uintptr_t>(d) % alignof(double) == 0);
+                d[11] = 1.0;
+            }
+            arena.Reset();
+        }
+        CHECK(g_allocations == before);
+        CHECK(arena.GetStats().spills == spilled.spills && arena.GetStats().grows == 1);
+    }
+
+    // The hooks' per-frame work: redirect binding table and pass graph over
+    // one arena, context-state leases and the stack buffers. Frames alternate
+    // between three shapes, like a game loop; once warm, a whole frame makes
+    // no heap allocation.
+    size_t RunFrame(FrameArena& arena, DLSSRedirect::BindingTable& table, DLSSPassGraph::FrameGraph& graph,
+                    DLSSContextState::Table& contexts, int frame) {
+        const size_t before = g_allocations;
+        std::mt19937 rng(1234 + frame % 3);
+        auto key = [&rng]() { return static_cast<uintptr_t>(rng() % 700) * 64 + 64; };
+        for (int bind = 0; bind < 1500; ++bind) {
+            const uint32_t count = 1 + rng() % 4;
+            DLSSRedirect::Slot slots[DLSSRedirect::kMaxSlots];
+            DLSSPassGraph::Target targets[DLSSPassGraph::kMaxTargets];
+            for (uint32_t i = 0; i < count; ++i) {
+                const bool scene = rng() % 3 != 0;
+                slots[i].key = targets[i].key = key();
+                slots[i].width = targets[i].width = scene ? 2000 : 1000;
+                slots[i].height = targets[i].height = scene ? 2000 : 500;
+                slots[i].kind = (i == count - 1) ? DLSSRedirect::Kind::Depth : DLSSRedirect::Kind::Color;
+                targets[i].depth = (i == count - 1);
+            }
+            DLSSRedirect::Action actions[DLSSRedirect::kMaxSlots];
+            table.ResolveBind(slots, count, 2000, 2000, 1300, 1300, rng() % 5 != 0, actions);
+            graph.BeginPass(targets, count);
+            for (int i = 0; i < 3; ++i) {
+                graph.NoteRead(key());
+                graph.NoteDraw();
+            }
+            if (rng() % 7 == 0) {
+                const uintptr_t dst = key();
+                graph.NoteCopy(dst, key());
+                table.AdoptRedirect(dst);
+            }
+            if (rng() % 11 == 0) table.MarkNative(key());
+
+            DLSSContextState::Lease cs = contexts.Acquire(1);
+            DLSSContextState::Viewport vp[3] = {};
+            InlineArray<DLSSContextState::Viewport, DLSSContextState::kMaxViewports> vps;
+            CHECK(vps.Assign(vp, 3));
+            cs->flags.clampedViewports += vps.Size();
+            InlineString<64> reasons;
+            reasons.Append("motion");
+            reasons.Append(", camera cut");
+            CHECK(!reasons.Empty());
+        }
+        graph.EndFrame();
+        table.BeginFrame();
+        arena.Reset();
+        contexts.BeginFrame();
+        return g_allocations - before;
+    }
+
+    void TestWarmFrameDoesNotAllocate() {
+        FrameArena arena(4096);  // small on purpose: it has to grow to the peak
+        DLSSRedirect::BindingTable table(arena);
+        DLSSPassGraph::FrameGraph graph(arena);
+        DLSSContextState::Table contexts;
+        size_t cold = 0;
+        for (int frame = 0; frame < 10; ++frame) cold += RunFrame(arena, table, graph, contexts, frame);
+        CHECK(cold > 0);  // the counter does see the warm-up
+        size_t warm = 0;
+        for (int frame = 10; frame < 200; ++frame) warm += RunFrame(arena, table, graph, contexts, frame);
+        CHECK(warm == 0);
+        CHECK(arena.GetStats().capacity >= arena.GetStats().peak);
+
+        // The stack buffers refuse instead of growing
+        InlineArray<int, 2> a;
+        CHECK(a.Push(1) && a.Push(2) && !a.Push(3));
+        const int three[3] = { 1, 2, 3 };
+        CHECK(!a.Assign(three, 3) && a.Empty());
+        InlineString<8> s;
+        s.Append("truncated");
+        CHECK(std::string_view(s.CStr()) == "truncat");
+    }
+}
+
+int main() {
+    TestFrameMap();
+    TestSpillAndGrow();
+    TestWarmFrameDoesNotAllocate();
+    return DLSSTest::Result();
+}
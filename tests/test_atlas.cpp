@@ -0,0 +1,118 @@
+#include "dlss_atlas.h"
+#include "dlss_sharpen.h"
+#include "test_common.h"
+
+#include <cmath>
+
+using namespace DLSSAtlas;
+
+namespace {
+    struct EyeSizes {
+        uint32_t lw, lh, rw, rh;
+    };
+
+    // Index, Pimax-style wide, odd sizes and asymmetric (per-eye quality) outputs
+    const EyeSizes kSizes[] = {
+        { 2016, 2240, 2016, 2240 },
+        { 3200, 2880, 3200, 2880 },
+        { 1921, 1081, 1921, 1081 },
+        { 2016, 2240, 1512, 1680 },
+        { 1, 1, 1, 1 },
+        { 7, 3, 9, 5 },
+    };
+
+    void TestLayout() {
+        for (const EyeSizes& s : kSizes) {
+            const Layout l = MakeLayout(s.lw, s.lh, s.rw, s.rh);
+            CHECK(l.IsValid());
+            CHECK(l.eyes[0] == (Rect{ 0, 0, s.lw, s.lh }));
+            CHECK(l.eyes[1].y == 0 && l.eyes[1].width == s.rw && l.eyes[1].height == s.rh);
+            // Both regions inside the atlas
+            CHECK(l.eyes[0].x + l.eyes[0].width <= l.width && l.eyes[1].x + l.eyes[1].width <= l.width);
+            CHECK(l.eyes[0].height <= l.height && l.eyes[1].height <= l.height);
+            CHECK(l.height == (s.lh > s.rh ? s.lh : s.rh));
+            // No wider than needed: the right eye ends the atlas
+            CHECK(l.width == l.eyes[1].x + s.rw);
+            // Gutter of at least kGutter texels, and no more than one extra group
+            const uint32_t gutter = l.eyes[1].x - s.lw;
+            CHECK(gutter >= kGutter && gutter < kGutter + DLSSSharpen::kGroupSize);
+            // The right eye starts on a sharpening group boundary, and the left
+            // eye's last (partial) group ends before it
+            CHECK(l.eyes[1].x % DLSSSharpen::kGroupSize == 0);
+            CHECK(DLSSSharpen::GroupCount(s.lw) * DLSSSharpen::kGroupSize <= l.eyes[1].x);
+        }
+        // Equal layouts compare equal; any changed eye does not
+        CHECK(MakeLayout(2016, 2240, 2016, 2240) == MakeLayout(2016, 2240, 2016, 2240));
+        CHECK(MakeLayout(2016, 2240, 2016, 2240) != MakeLayout(2016, 2240, 2016, 2232));
+        // Unknown eyes give no atlas
+        CHECK(!MakeLayout(0, 2240, 2016, 2240).IsValid());
+        CHECK(!MakeLayout(2016, 0, 2016, 2240).IsValid());
+        CHECK(!MakeLayout(2016, 2240, 0, 2240).IsValid());
+        CHECK(!MakeLayout(2016, 2240, 2016, 0).IsValid());
+        CHECK(AlignUp(0, 8) == 0 && AlignUp(1, 8) == 8 && AlignUp(8, 8) == 8 && AlignUp(9, 8) == 16);
+    }
+
+    void TestBounds() {
+        for (const EyeSizes& s : kSizes) {
+            const Layout l = MakeLayout(s.lw, s.lh, s.rw, s.rh);
+            const Bounds left = EyeBounds(l, 0, nullptr);
+            const Bounds right = EyeBounds(l, 1, nullptr);
+            // Mapped back to texels, the bounds are exactly the eye regions
+            for (int eye = 0; eye < 2; ++eye) {
+                const Bounds& b = eye ? right : left;
+                const Rect& r = l.eyes[eye];
+                CHECK_NEAR(b.uMin * l.width, r.x, 1e-2);
+                CHECK_NEAR(b.uMax * l.width, r.x + r.width, 1e-2);
+                CHECK_NEAR(b.vMin * l.height, r.y, 1e-2);
+                CHECK_NEAR(b.vMax * l.height, r.y + r.height, 1e-2);
+                CHECK(b.uMin >= 0.0f && b.uMax <= 1.0f && b.vMin >= 0.0f && b.vMax <= 1.0f);
+            }
+            // The compositor's bilinear footprint at the inner edges (half a
+            // texel outside the bounds) lands in the gutter, never in the other eye
+            const float halfTexel = 0.5f / static_cast<float>(l.width);
+            CHECK((left.uMax + halfTexel) * l.width <= static_cast<float>(l.eyes[1].x));
+            CHECK((right.uMin - halfTexel) * l.width >= static_cast<float>(s.lw));
+            CHECK(left.uMax < right.uMin);
+        }
+
+        // The game's own bounds (a vertically flipped sub-rect) map into the region unchanged
+        const Layout l = MakeLayout(2016, 2240, 2016, 2240);
+        const Bounds inner{ 0.25f, 1.0f, 0.75f, 0.0f };
+        const Bounds r = EyeBounds(l, 1, &inner);
+        CHECK_NEAR(r.uMin * l.width, l.eyes[1].x + 504, 1e-2);
+        CHECK_NEAR(r.uMax * l.width, l.eyes[1].x + 1512, 1e-2);
+        CHECK(r.vMin == 1.0f && r.vMax == 0.0f);
+
+        // A shorter right eye covers only its rows of the atlas
+        const Layout a = MakeLayout(2016, 2240, 1512, 1680);
+        CHECK_NEAR(EyeBounds(a, 1, nullptr).vMax, 1680.0f / 2240.0f, 1e-6);
+        CHECK(EyeBounds(a, 0, nullptr).vMax == 1.0f);
+
+        // Unknown layout or eye: whole texture
+        const Bounds whole = EyeBounds(Layout{}, 0, nullptr);
+        CHECK(whole.uMin == 0.0f && whole.vMin == 0.0f && whole.uMax == 1.0f && whole.vMax == 1.0f);
+        const Bounds bad = EyeBounds(l, 2, nullptr);
+        CHECK(bad.uMin == 0.0f && bad.uMax == 1.0f);
+    }
+
+    // The groups of one eye's atlas sharpening dispatch never reach into
+    // the other eye's region (partial groups end in the gutter)
+    void TestSharpenRegions() {
+        const Layout l = MakeLayout(1921, 1081, 1921, 1081);
+        for (int eye = 0; eye < 2; ++eye) {
+            const Rect& r = l.eyes[eye];
+            const DLSSSharpen::Params p = DLSSSharpen::MakeParams(r.width, r.height, 0.5f, r.x, r.y);
+            CHECK(p.offset[0] == r.x && p.offset[1] == r.y);
+            const uint32_t lastX = r.x + DLSSSharpen::GroupCount(r.width) * DLSSSharpen::kGroupSize;
+            CHECK(eye == 1 || lastX <= l.eyes[1].x);
+            CHECK(eye == 0 || r.x >= DLSSSharpen::GroupCount(l.eyes[0].width) * DLSSSharpen::kGroupSize);
+        }
+    }
+}
+
+int main() {
+    TestLayout();
+    TestBounds();
+    TestSharpenRegions();
+    return DLSSTest::Result();
+}
@@ -0,0 +1,179 @@
+#include "dlss_camera.h"
+#include "test_common.h"
+
+using namespace DLSSCamera;
+
+namespace {
+    struct Vec4 {
+        float v[4];
+    };
+
+    Vec4 Transform(const Vec4& p, const Float4x4& m) {
+        Vec4 r{};
+        for (int j = 0; j < 4; ++j) {
+            r.v[j] = p.v[0] * m.m[0][j] + p.v[1] * m.m[1][j] + p.v[2] * m.m[2][j] + p.v[3] * m.m[3][j];
+        }
+        return r;
+    }
+
+    Float4x4 Translation(float x, float y, float z) {
+        Float4x4 m = Identity();
+        m.m[3][0] = x;
+        m.m[3][1] = y;
+        m.m[3][2] = z;
+        return m;
+    }
+
+    void TestHalton() {
+        CHECK(Halton(0, 2) == 0.0f);
+        CHECK_NEAR(Halton(1, 2), 0.5, 1e-7);
+        CHECK_NEAR(Halton(2, 2), 0.25, 1e-7);
+        CHECK_NEAR(Halton(3, 2), 0.75, 1e-7);
+        CHECK_NEAR(Halton(1, 3), 1.0 / 3.0, 1e-7);
+        CHECK_NEAR(Halton(5, 3), 7.0 / 9.0, 1e-6);
+
+        CHECK(JitterPhaseCount(0, 0, 0, 0) == 8);
+        CHECK(JitterPhaseCount(1000, 1000, 1000, 1000) == 8);
+        CHECK(JitterPhaseCount(1000, 1000, 2000, 2000) == 32);
+        CHECK(JitterPhaseCount(100, 100, 2000, 2000) == 128);
+
+        // One full cycle stays in [-0.5, 0.5), is roughly centred and repeats
+        JitterSequence seq;
+        double sumX = 0.0, sumY = 0.0;
+        JitterSample first{};
+        for (uint32_t i = 0; i < 32; ++i) {
+            const JitterSample s = seq.Next(1000, 800, 2000, 1600);
+            if (i == 0) first = s;
+            CHECK(s.pixelX >= -0.5f && s.pixelX < 0.5f);
+            CHECK(s.pixelY >= -0.5f && s.pixelY < 0.5f);
+            CHECK_NEAR(s.clipX, 2.0 * s.pixelX / 1000.0, 1e-7);
+            CHECK_NEAR(s.clipY, -2.0 * s.pixelY / 800.0, 1e-7);
+            sumX += s.pixelX;
+            sumY += s.pixelY;
+        }
+        CHECK(seq.PhaseCount() == 32);
+        CHECK(std::fabs(sumX / 32.0) < 0.05 && std::fabs(sumY / 32.0) < 0.05);
+        const JitterSample again = seq.Next(1000, 800, 2000, 1600);
+        CHECK(again.pixelX == first.pixelX && again.pixelY == first.pixelY);
+    }
+
+    void TestProjection() {
+        const float n = kDefaultNearZ, f = kDefaultFarZ;
+        const Float4x4 p = ProjectionFromTangents(-1.2f, 1.0f, -1.1f, 1.3f, n, f);
+        const Vec4 nearPoint = Transform(Vec4{ { 0.0f, 0.0f, -n, 1.0f } }, p);
+        const Vec4 farPoint = Transform(Vec4{ { 0.0f, 0.0f, -f, 1.0f } }, p);
+        CHECK_NEAR(nearPoint.v[2] / nearPoint.v[3], 0.0, 1e-5);
+        CHECK_NEAR(farPoint.v[2] / farPoint.v[3], 1.0, 1e-5);
+        // The frustum edges land on the NDC edges
+        const Vec4 rightEdge = Transform(Vec4{ { 1.0f * 100.0f, 0.0f, -100.0f, 1.0f } }, p);
+        CHECK_NEAR(rightEdge.v[0] / rightEdge.v[3], 1.0, 1e-5);
+
+        Float4x4 inv{};
+        CHECK(Inverse(p, inv));
+        const Float4x4 id = Multiply(p, inv);
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) CHECK_NEAR(id.m[i][j], i == j ? 1.0 : 0.0, 1e-4);
+        }
+        Float4x4 singular{};
+        CHECK(!Inverse(singular, inv));
+
+        // Row- and column-vector jitter move the projected point by the same offset
+        Float4x4 rowJ = p;
+        ApplyClipJitterRowVector(rowJ, 0.01f, -0.02f);
+        Float4x4 colJ = Transpose(p);
+        ApplyClipJitterColumnVector(colJ, 0.01f, -0.02f);
+        const Vec4 pt{ { 3.0f, -2.0f, -50.0f, 1.0f } };
+        const Vec4 a = Transform(pt, p);
+        const Vec4 b = Transform(pt, rowJ);
+        const Vec4 c = Transform(pt, Transpose(colJ));
+        CHECK_NEAR(b.v[0] / b.v[3] - a.v[0] / a.v[3], 0.01, 1e-5);
+        CHECK_NEAR(b.v[1] / b.v[3] - a.v[1] / a.v[3], -0.02, 1e-5);
+        CHECK_NEAR(c.v[0] / c.v[3], b.v[0] / b.v[3], 1e-6);
+        CHECK_NEAR(c.v[1] / c.v[3], b.v[1] / b.v[3], 1e-6);
+    }
+
+    void TestDefaults() {
+        CameraConstantsProvider provider;
+        const EyeConstants unset = provider.Build(0, 100, 100, false);
+        CHECK(!unset.valid);
+        CHECK(unset.nearZ == EyeConstants{}.nearZ && unset.farZ == EyeConstants{}.farZ);
+        CHECK(unset.nearZ == kDefaultNearZ && unset.farZ == kDefaultFarZ);
+        provider.SetClipPlanes(5.0f, 1.0f);  // rejected
+        CHECK(provider.Build(0, 100, 100, false).nearZ == kDefaultNearZ);
+    }
+
+    // clipToPrevClip must carry a world point's current clip position to its
+    // previous one; OpenVR metres are composed with game-unit clip planes.
+    void TestReprojection() {
+        CameraConstantsProvider provider;
+        EyeInputs in{};
+        in.tanLeft = -1.1f;
+        in.tanRight = 0.9f;
+        in.tanTop = -1.0f;
+        in.tanBottom = 1.05f;
+        in.eyeToHead = Translation(-0.032f, 0.0f, 0.0f);  // metres
+        in.havePose = true;
+
+        in.headToWorld = Translation(0.0f, 1.6f, 0.0f);
+        provider.SetEyeInputs(0, in);
+        const EyeConstants prev = provider.Build(0, 1000, 1000, false);
+        CHECK(prev.valid);
+        CHECK_NEAR(prev.position[0], -0.032 * kGameUnitsPerMeter, 1e-3);
+        CHECK_NEAR(prev.position[1], 1.6 * kGameUnitsPerMeter, 1e-3);
+
+        in.headToWorld = Translation(0.05f, 1.6f, -0.02f);  // 5 cm sideways
+        provider.SetEyeInputs(0, in);
+        const EyeConstants cur = provider.Build(0, 1000, 1000, false);
+        CHECK_NEAR(cur.position[0], (0.05 - 0.032) * kGameUnitsPerMeter, 1e-3);
+
+        // A world point 3 m in front, in game units
+        const Vec4 world{ { 0.0f, 1.6f * kGameUnitsPerMeter, -3.0f * kGameUnitsPerMeter, 1.0f } };
+        auto project = [&](const float* pos, const Float4x4& viewToClip) {
+            Float4x4 worldToView{};
+            Inverse(Translation(pos[0], pos[1], pos[2]), worldToView);
+            return Transform(Transform(world, worldToView), viewToClip);
+        };
+        const Vec4 curClip = project(cur.position, cur.viewToClip);
+        const Vec4 prevClip = project(prev.position, prev.viewToClip);
+        const Vec4 reprojected = Transform(curClip, cur.clipToPrevClip);
+        for (int i = 0; i < 3; ++i) {
+            CHECK_NEAR(reprojected.v[i] / reprojected.v[3], prevClip.v[i] / prevClip.v[3], 1e-4);
+        }
+        // The point is well inside the clip range rather than clipped by a metre/unit mix-up
+        const float depth = curClip.v[2] / curClip.v[3];
+        CHECK(depth > 0.0f && depth < 1.0f);
+        CHECK(curClip.v[0] / curClip.v[3] != prevClip.v[0] / prevClip.v[3]);
+
+        const Vec4 back = Transform(reprojected, cur.prevClipToClip);
+        CHECK_NEAR(back.v[0] / back.v[3], curClip.v[0] / curClip.v[3], 1e-4);
+
+        // A history reset drops the reprojection
+        const EyeConstants reset = provider.Build(0, 1000, 1000, true);
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) CHECK(reset.clipToPrevClip.m[i][j] == (i == j ? 1.0f : 0.0f));
+        }
+    }
+
+    void TestJitterReporting() {
+        CameraConstantsProvider provider;
+        provider.SetEyeInputs(1, EyeInputs{});
+        provider.AdvanceJitter(1, 1000, 1000, 1500, 1500);
+        CHECK(provider.Build(1, 1000, 1000, false).jitterX == 0.0f);  // nothing injects it yet
+        provider.SetJitterInjectionActive(true);
+        const JitterSample j = provider.AdvanceJitter(1, 1000, 1000, 1500, 1500);
+        const EyeConstants c = provider.Build(1, 1000, 1000, false);
+        CHECK(c.jitterX == j.pixelX && c.jitterY == j.pixelY);
+        provider.SetJitterEnabled(false);
+        CHECK(provider.AdvanceJitter(1, 1000, 1000, 1500, 1500).pixelX == 0.0f);
+        CHECK(provider.CurrentJitter(1).pixelX == 0.0f);
+    }
+}
+
+int main() {
+    TestHalton();
+    TestProjection();
+    TestDefaults();
+    TestReprojection();
+    TestJitterReporting();
+    return DLSSTest::Result();
+}
@@ -0,0 +1,255 @@
+#include "dlss_capture.h"
+#include "test_common.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace DLSSCapture;
+
+namespace {
+    // Files go to the test's working directory and are removed afterwards
+    const char* const kRoundTrip = "test_capture_roundtrip.dlsscap";
+    const char* const kDrops = "test_capture_drops.dlsscap";
+    const char* const kEdited = "test_capture_edited.dlsscap";
+
+    uint8_t Pixel(uint64_t frame, uint32_t eye, uint32_t surface, size_t i) {
+        return static_cast<uint8_t>(frame * 7 + eye * 31 + surface * 13 + i * 3);
+    }
+
+    // One eye's frame: an RGBA8 color surface and an R32 depth surface of
+    // an odd size, filled with a pattern that identifies frame, eye and byte
+    Frame MakeFrame(Writer& writer, uint64_t frame, uint32_t eye, uint32_t width, uint32_t height) {
+        Frame f;
+        f.info.frame = frame;
+        f.info.eye = eye;
+        f.info.timeMs = frame * 11.1;
+        f.info.quality = 2;
+        f.info.jitterX = 0.25f;
+        f.info.jitterY = -0.125f;
+        f.info.renderWidth = width;
+        f.info.renderHeight = height;
+        f.info.outputWidth = width * 3 / 2;
+        f.info.outputHeight = height * 3 / 2;
+        f.info.surfaceCount = 2;
+        const uint32_t formats[2] = { 28, 41 };  // R8G8B8A8_UNORM, R32_FLOAT
+        for (uint32_t s = 0; s < 2; ++s) {
+            SurfaceInfo& si = f.surfaces[s];
+            si.frame = frame;
+            si.eye = eye;
+            si.surface = s == 0 ? static_cast<uint32_t>(Surface::Color) : static_cast<uint32_t>(Surface::Depth);
+            si.format = formats[s];
+            si.width = width;
+            si.height = height;
+            si.rowBytes = width * 4;
+            f.pixels[s] = writer.TakeBuffer();
+            f.pixels[s].resize(static_cast<size_t>(si.rowBytes) * height);
+            for (size_t i = 0; i < f.pixels[s].size(); ++i) f.pixels[s][i] = Pixel(frame, eye, s, i);
+        }
+        return f;
+    }
+
+    // Spins until the worker has closed the file; false after a few seconds
+    bool WaitDrained(const Writer& writer) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (writer.IsDraining()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    // Everything pushed to a roomy queue comes back as written, pixels
+    // included; a metadata pass skips the pixels and stays in step
+    void TestRoundTrip() {
+        {
+            Writer writer(1000, 1ull << 30);
+            CHECK(writer.Open(kRoundTrip));
+            CHECK(writer.IsOpen());
+            for (uint64_t frame = 0; frame < 50; ++frame) {
+                for (uint32_t eye = 0; eye < 2; ++eye) CHECK(writer.Push(MakeFrame(writer, frame, eye, 37 + eye, 21)));
+            }
+            writer.Close();
+            CHECK(!writer.Push(MakeFrame(writer, 50, 0, 4, 4)));  // closed: discarded
+            CHECK(WaitDrained(writer));
+            const Stats s = writer.GetStats();
+            CHECK(!s.open && !s.failed && s.written == 100 && s.dropped == 0 && s.queued == 0 && s.queuedBytes == 0);
+            CHECK(s.path == kRoundTrip);
+        }
+
+        Reader reader;
+        CHECK(reader.Open(kRoundTrip));
+        CHECK(reader.Version() == kVersion);
+        Frame f;
+        uint32_t n = 0;
+        while (reader.Next(f, true)) {
+            const uint64_t frame = n / 2;
+            const uint32_t eye = n % 2;
+            CHECK(f.info.frame == frame && f.info.eye == eye && f.info.droppedBefore == 0);
+            CHECK(f.info.jitterX == 0.25f && f.info.jitterY == -0.125f && f.info.quality == 2);
+            CHECK(f.info.renderWidth == 37 + eye && f.info.outputHeight == 31);
+            CHECK(f.info.surfaceCount == 2);
+            bool intact = true;
+            for (uint32_t s = 0; s < 2 && s < f.info.surfaceCount; ++s) {
+                CHECK(f.surfaces[s].frame == frame && f.surfaces[s].eye == eye && f.surfaces[s].width == 37 + eye);
+                CHECK(f.pixels[s].size() == static_cast<size_t>(f.surfaces[s].rowBytes) * f.surfaces[s].height);
+                for (size_t i = 0; i < f.pixels[s].size(); ++i) intact = intact && f.pixels[s][i] == Pixel(frame, eye, s, i);
+            }
+            CHECK(intact);
+            ++n;
+        }
+        CHECK(n == 100);
+
+        CHECK(reader.Open(kRoundTrip));
+        n = 0;
+        while (reader.Next(f, false)) {
+            CHECK(f.info.frame == n / 2 && f.info.surfaceCount == 2);
+            CHECK(f.surfaces[1].surface == static_cast<uint32_t>(Surface::Depth) && f.surfaces[1].format == 41);
+            CHECK(f.pixels[0].empty() && f.pixels[1].empty());
+            ++n;
+        }
+        CHECK(n == 100);
+        reader.Close();
+    }
+
+    // Readers step over a longer file header and chunks with unknown tags,
+    // and stop cleanly at a truncated chunk
+    void TestSkipAndTruncate() {
+        std::vector<uint8_t> original;
+        {
+            std::FILE* in = std::fopen(kRoundTrip, "rb");
+            CHECK(in != nullptr);
+            if (!in) return;
+            uint8_t buffer[4096];
+            size_t got;
+            while ((got = std::fread(buffer, 1, sizeof(buffer), in)) > 0) original.insert(original.end(), buffer, buffer + got);
+            std::fclose(in);
+        }
+        CHECK(original.size() > sizeof(FileHeader));
+
+        // A newer writer's header with 8 extra bytes, and a foreign chunk before the frames
+        {
+            std::FILE* out = std::fopen(kEdited, "wb");
+            FileHeader header;
+            header.headerBytes = sizeof(FileHeader) + 8;
+            const uint64_t extra = 0x1122334455667788ull;
+            ChunkHeader unknown;
+            unknown.tag = 0x4B4E554A;  // "JUNK"
+            unknown.bytes = 1000;
+            const std::vector<uint8_t> junk(unknown.bytes, 0xAB);
+            std::fwrite(&header, sizeof(header), 1, out);
+            std::fwrite(&extra, sizeof(extra), 1, out);
+            std::fwrite(&unknown, sizeof(unknown), 1, out);
+            std::fwrite(junk.data(), junk.size(), 1, out);
+            std::fwrite(original.data() + sizeof(FileHeader), original.size() - sizeof(FileHeader), 1, out);
+            std::fclose(out);
+        }
+        Reader reader;
+        CHECK(reader.Open(kEdited));
+        Frame f;
+        uint32_t n = 0;
+        while (reader.Next(f, false)) {
+            CHECK(f.info.frame == n / 2 && f.info.eye == n % 2);
+            ++n;
+        }
+        CHECK(n == 100);
+
+        // Cut in the middle of the third frame's depth surface
+        const size_t frameBytes = (original.size() - sizeof(FileHeader)) / 100;
+        {
+            std::FILE* out = std::fopen(kEdited, "wb");
+            std::fwrite(original.data(), sizeof(FileHeader) + frameBytes * 2 + frameBytes * 3 / 4, 1, out);
+            std::fclose(out);
+        }
+        CHECK(reader.Open(kEdited));
+        n = 0;
+        while (reader.Next(f, true)) ++n;
+        CHECK(n == 2);
+
+        // Not a capture
+        {
+            std::FILE* out = std::fopen(kEdited, "wb");
+            std::fputs("not a capture file", out);
+            std::fclose(out);
+        }
+        CHECK(!reader.Open(kEdited));
+        CHECK(!reader.Open("test_capture_missing.dlsscap"));
+        CHECK(!reader.Next(f, false));
+    }
+
+    // A short queue under a burst: the oldest frames are dropped, and the
+    // file accounts for every frame. Stats.dropped counts the frames dropped
+    // from the queue; droppedBefore in the file adds the frames the caller
+    // reported missing itself (carried over when their successor is dropped too).
+    void TestDropAccounting() {
+        constexpr uint64_t kFrames = 400;
+        uint64_t callerSkips = 0;
+        uint64_t pushed = 0;
+        Stats stats;
+        {
+            Writer writer(4, 1ull << 30);
+            CHECK(writer.Open(kDrops));
+            uint32_t skipped[2] = {};
+            for (uint64_t frame = 0; frame < kFrames; ++frame) {
+                for (uint32_t eye = 0; eye < 2; ++eye) {
+                    // The caller loses every tenth left-eye frame before it reaches the queue
+                    if (eye == 0 && frame % 10 == 5) {
+                        ++skipped[eye];
+                        ++callerSkips;
+                        continue;
+                    }
+                    Frame f = MakeFrame(writer, frame, eye, 256, 256);
+                    f.info.droppedBefore = skipped[eye];
+                    skipped[eye] = 0;
+                    CHECK(writer.Push(std::move(f)));
+                    ++pushed;
+                }
+            }
+            writer.Close();
+            CHECK(WaitDrained(writer));
+            stats = writer.GetStats();
+        }
+        CHECK(!stats.failed);
+        CHECK(stats.dropped > 0);  // the burst did outrun the worker
+        CHECK(stats.written + stats.dropped == pushed);
+
+        Reader reader;
+        CHECK(reader.Open(kDrops));
+        Frame f;
+        uint64_t written = 0, droppedBefore = 0;
+        uint64_t next[2] = {};  // frame expected next, per eye
+        while (reader.Next(f, true)) {
+            const uint32_t eye = f.info.eye & 1;
+            // Every gap in an eye's frame numbers is reported, exactly
+            CHECK(f.info.frame - next[eye] == f.info.droppedBefore);
+            next[eye] = f.info.frame + 1;
+            CHECK(f.pixels[0].size() == 256 * 256 * 4 && f.pixels[0][1234] == Pixel(f.info.frame, eye, 0, 1234));
+            droppedBefore += f.info.droppedBefore;
+            ++written;
+        }
+        CHECK(written == stats.written);
+        // The last frame of each eye is never dropped (nothing is pushed after it)
+        CHECK(next[0] == kFrames && next[1] == kFrames);
+        CHECK(droppedBefore == stats.dropped + callerSkips);
+    }
+
+    // A file that cannot be created leaves the writer closed
+    void TestOpenFailure() {
+        Writer writer;
+        CHECK(!writer.Open("test_capture_missing_dir/x.dlsscap"));
+        CHECK(!writer.IsOpen() && !writer.IsDraining());
+        CHECK(!writer.Push(Frame{}));
+    }
+}
+
+int main() {
+    TestRoundTrip();
+    TestSkipAndTruncate();
+    TestDropAccounting();
+    TestOpenFailure();
+    std::remove(kRoundTrip);
+    std::remove(kDrops);
+    std::remove(kEdited);
+    return DLSSTest::Result();
+}
@@ -0,0 +1,148 @@
+#include "dlss_cbuffer.h"
+#include "test_common.h"
+
+#include <vector>
+
+using namespace DLSSCBuffer;
+
+namespace {
+    // A camera cbuffer: some leading constants, then an off-center eye projection
+    std::vector<uint8_t> MakeCameraBuffer(size_t size, size_t offset, bool leftEye, MatrixLayout layout) {
+        std::vector<uint8_t> bytes(size, 0);
+        for (size_t i = 0; i < offset / 4; ++i) {
+            const float v = 0.25f * static_cast<float>(i + 3);
+            std::memcpy(bytes.data() + i * 4, &v, 4);
+        }
+        const float l = leftEye ? -1.4f : -1.0f, r = leftEye ? 1.0f : 1.4f;
+        DLSSCamera::Float4x4 p = DLSSCamera::ProjectionFromTangents(l, r, -1.2f, 1.2f, 10.0f, 100000.0f);
+        if (layout == MatrixLayout::ColumnVector) p = DLSSCamera::Transpose(p);
+        std::memcpy(bytes.data() + offset, p.m, 64);
+        return bytes;
+    }
+
+    void TestDetection() {
+        for (int l = 0; l < 2; ++l) {
+            const MatrixLayout layout = static_cast<MatrixLayout>(l);
+            for (int eye = 0; eye < 2; ++eye) {
+                const std::vector<uint8_t> buf = MakeCameraBuffer(256, 96, eye == 0, layout);
+                uint64_t scanned = 0;
+                const Match m = FindProjection(buf.data(), buf.size(), scanned);
+                CHECK(m.found);
+                CHECK(m.offset == 96);
+                CHECK(m.layout == layout);
+                CHECK(scanned == 96 + 64);
+                float f[16];
+                std::memcpy(f, buf.data() + m.offset, 64);
+                CHECK(EyeFromProjection(f, m.layout) == eye);
+            }
+        }
+        // Identity and junk are not projections
+        DLSSCamera::Float4x4 id = DLSSCamera::Identity();
+        MatrixLayout layout;
+        CHECK(!LooksLikeProjection(&id.m[0][0], layout));
+        std::vector<uint8_t> zeros(512, 0);
+        uint64_t scanned = 0;
+        CHECK(!FindProjection(zeros.data(), zeros.size(), scanned).found);
+        CHECK(scanned == 512);
+        CHECK(!FindProjection(zeros.data(), 32, scanned).found);
+    }
+
+    void TestClassifier() {
+        Classifier c;
+        std::vector<uint8_t> cam = MakeCameraBuffer(192, 64, true, MatrixLayout::RowVector);
+        MatrixLayout layout;
+        CHECK(c.Locate(1, cam.data(), cam.size(), layout) != nullptr);
+        CHECK(c.Current().buffersClassified == 1);
+        CHECK(c.Locate(1, cam.data(), cam.size(), layout) != nullptr);
+        CHECK(c.Current().fastPathHits == 1);
+
+        // Never a projection: rejected after the classify attempts
+        std::vector<uint8_t> other(128, 0);
+        for (uint8_t i = 0; i < Classifier::kClassifyAttempts; ++i) {
+            CHECK(!c.IsRejected(2, other.size()));
+            CHECK(c.Locate(2, other.data(), other.size(), layout) == nullptr);
+        }
+        CHECK(c.IsRejected(2, other.size()));
+        // A different size at the same address is a new buffer
+        CHECK(!c.IsRejected(2, 256));
+        CHECK(!c.IsRejected(3, 128));
+
+        // The projection moved inside a classified buffer: found again by a rescan
+        std::vector<uint8_t> moved = MakeCameraBuffer(192, 112, true, MatrixLayout::RowVector);
+        float* f = c.Locate(1, moved.data(), moved.size(), layout);
+        CHECK(f == reinterpret_cast<float*>(moved.data() + 112));
+
+        const Classifier::FrameStats stats = c.EndFrame();
+        CHECK(stats.buffersClassified == 2);
+        CHECK(c.Current().bytesScanned == 0);
+        CHECK(c.TrackedBuffers() == 2);
+    }
+
+    // The UpdateSubresource hook patches a copy; the game's source stays as it was
+    void TestPatchCopy() {
+        const std::vector<uint8_t> source = MakeCameraBuffer(256, 128, false, MatrixLayout::ColumnVector);
+        const std::vector<uint8_t> original = source;
+        Classifier c;
+        std::vector<uint8_t> upload(source.begin(), source.end());
+        MatrixLayout layout;
+        float* proj = c.Locate(7, upload.data(), upload.size(), layout);
+        CHECK(proj != nullptr);
+        ApplyJitter(proj, layout, 0.002f, -0.001f);
+        CHECK(source == original);
+        CHECK(upload != original);
+        CHECK(std::memcmp(upload.data(), original.data(), 128) == 0);
+
+        // The patch shifts a projected point by the jitter
+        DLSSCamera::Float4x4 before, after;
+        std::memcpy(before.m, original.data() + 128, 64);
+        std::memcpy(after.m, proj, 64);
+        const float v[4] = { 2.0f, 1.0f, -40.0f, 1.0f };
+        auto ndcX = [&v](const DLSSCamera::Float4x4& m) {
+            const float x = m.m[0][0] * v[0] + m.m[0][1] * v[1] + m.m[0][2] * v[2] + m.m[0][3] * v[3];
+            const float w = m.m[3][0] * v[0] + m.m[3][1] * v[1] + m.m[3][2] * v[2] + m.m[3][3] * v[3];
+            return x / w;
+        };
+        CHECK_NEAR(ndcX(after) - ndcX(before), 0.002, 1e-5);
+    }
+
+    void TestMapShadows() {
+        MapShadows shadows;
+        std::vector<uint8_t> mappedA(256, 0xCD), mappedB(64, 0xCD);
+
+        uint8_t* a = static_cast<uint8_t*>(shadows.Begin(100, 1, mappedA.data(), 256));
+        CHECK(a != nullptr && a != mappedA.data());
+        // The same buffer mapped on another context gets its own shadow
+        uint8_t* b = static_cast<uint8_t*>(shadows.Begin(200, 1, mappedB.data(), 64));
+        CHECK(b != nullptr && b != a);
+        CHECK(shadows.OpenCount() == 2);
+
+        std::memset(a, 0x11, 256);
+        std::memset(b, 0x22, 64);
+        MapShadows::Slot* slotA = shadows.Find(100, 1);
+        CHECK(slotA != nullptr && slotA->mapped == mappedA.data() && slotA->size == 256);
+        CHECK(mappedA[0] == 0xCD);  // nothing reaches the mapping before Unmap
+        shadows.End(*slotA);
+        CHECK(mappedA == std::vector<uint8_t>(256, 0x11));
+        CHECK(shadows.Find(100, 1) == nullptr);
+        CHECK(mappedB[0] == 0xCD);
+        shadows.End(*shadows.Find(200, 1));
+        CHECK(mappedB == std::vector<uint8_t>(64, 0x22));
+        CHECK(shadows.OpenCount() == 0);
+
+        // Full table: further maps go through unshadowed
+        std::vector<uint8_t> target(64);
+        for (uintptr_t i = 0; i < MapShadows::kMaxMapped; ++i) CHECK(shadows.Begin(1, 10 + i, target.data(), 64) != nullptr);
+        CHECK(shadows.Begin(1, 99, target.data(), 64) == nullptr);
+        // A re-map of an open buffer reuses its slot
+        CHECK(shadows.Begin(1, 10, target.data(), 64) != nullptr);
+        CHECK(shadows.OpenCount() == MapShadows::kMaxMapped);
+    }
+}
+
+int main() {
+    TestDetection();
+    TestClassifier();
+    TestPatchCopy();
+    TestMapShadows();
+    return DLSSTest::Result();
+}
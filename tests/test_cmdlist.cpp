@@ -0,0 +1,300 @@
+#include "dlss_cmdlist.h"
+#include "test_common.h"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+using namespace DLSSCmdList;
+
+namespace {
+    // A fake device: resources are refcounted handles; a job is the command
+    // the render thread would have encoded directly, and a recorded list is
+    // that command plus the references a D3D11 command list keeps on what it
+    // binds. The immediate context logs every command it runs.
+    struct Resource {
+        std::atomic<int> refs{ 1 };
+        bool released = false;  // the owner let go; only list references remain
+    };
+
+    struct Command {
+        Pass pass = Pass::DownscaleLeft;
+        Resource* source = nullptr;
+        Resource* target = nullptr;
+        float scalar = 0.0f;
+    };
+
+    struct List {
+        Command command;
+    };
+
+    class FakeContext final : public Recorder {
+    public:
+        std::atomic<int> jobs{ 0 };
+        std::atomic<int> lists{ 0 };
+        std::atomic<int> recordings{ 0 };
+        std::atomic<bool> fail{ false };
+        std::atomic<int> recordDelayUs{ 0 };
+        std::atomic<bool> hold{ false };      // Record waits while set
+        std::atomic<bool> recording{ false };  // inside Record
+        std::vector<Command> executed;  // immediate context, render thread only
+        int staleExecutes = 0;          // commands run against a released resource
+
+        void* NewJob(Pass pass, Resource* source, Resource* target, float scalar) {
+            ++jobs;
+            return new Command{ pass, source, target, scalar };
+        }
+
+        // What the render thread does on a miss
+        void Direct(const Command& c) { Run(c); }
+
+        void* Record(Pass pass, void* job) override {
+            Command* c = static_cast<Command*>(job);
+            CHECK(c->pass == pass);
+            ++recordings;
+            recording = true;
+            while (hold.load()) std::this_thread::yield();
+            if (recordDelayUs.load()) std::this_thread::sleep_for(std::chrono::microseconds(recordDelayUs.load()));
+            List* list = nullptr;
+            if (!fail.load()) {
+                list = new List{ *c };
+                ++list->command.source->refs;
+                ++list->command.target->refs;
+                ++lists;
+            }
+            DropJob(job);
+            recording = false;
+            return list;
+        }
+        void DropJob(void* job) override {
+            delete static_cast<Command*>(job);
+            --jobs;
+        }
+        void Execute(void* list) override { Run(static_cast<List*>(list)->command); }
+        void ReleaseList(void* list) override {
+            List* l = static_cast<List*>(list);
+            --l->command.source->refs;
+            --l->command.target->refs;
+            delete l;
+            --lists;
+        }
+
+    private:
+        void Run(const Command& c) {
+            if (c.source->released || c.target->released) ++staleExecutes;
+            executed.push_back(c);
+        }
+    };
+
+    Key MakeKey(const Resource& source, const Resource& target, float scalar) {
+        Key k;
+        k.source = &source;
+        k.target = &target;
+        k.sourceWidth = 1344;
+        k.sourceHeight = 1494;
+        k.regionWidth = 2016;
+        k.regionHeight = 2240;
+        k.scalar = scalar;
+        return k;
+    }
+
+    // One frame of the manager's pattern: replay, or encode directly and submit
+    void Frame(Cache& cache, FakeContext& ctx, Pass pass, Resource& source, Resource& target, float scalar) {
+        const Key key = MakeKey(source, target, scalar);
+        if (cache.Execute(pass, key)) return;
+        ctx.Direct(Command{ pass, &source, &target, scalar });
+        if (cache.NeedsJob(pass, key)) cache.Submit(pass, key, ctx.NewJob(pass, &source, &target, scalar));
+    }
+
+    bool Same(const Command& a, const Command& b) {
+        return a.pass == b.pass && a.source == b.source && a.target == b.target && a.scalar == b.scalar;
+    }
+
+    // Replayed frames run exactly what direct encoding would have
+    void TestReplayMatchesDirect() {
+        FakeContext ctx;
+        Resource src, dst;
+        {
+            Cache cache(ctx);
+            for (int frame = 0; frame < 10; ++frame) {
+                Frame(cache, ctx, Pass::SharpenLeft, src, dst, 0.3f);
+                cache.RecordPending();
+            }
+            const Stats s = cache.GetStats();
+            CHECK(s.misses == 1 && s.executed == 9 && s.recorded == 1 && s.ready == 1);
+            CHECK(ctx.executed.size() == 10);
+            for (const Command& c : ctx.executed) CHECK(Same(c, ctx.executed[0]));
+            CHECK(src.refs == 2 && dst.refs == 2);  // the list's references
+
+            // A new sharpness misses once, then replays the new list
+            Frame(cache, ctx, Pass::SharpenLeft, src, dst, 0.6f);
+            cache.RecordPending();
+            Frame(cache, ctx, Pass::SharpenLeft, src, dst, 0.6f);
+            CHECK(ctx.executed.back().scalar == 0.6f);
+            CHECK(cache.GetStats().misses == 2);
+            CHECK(ctx.lists == 1);
+        }
+        CHECK(ctx.lists == 0 && ctx.jobs == 0);
+        CHECK(src.refs == 1 && dst.refs == 1);
+        CHECK(ctx.staleExecutes == 0);
+    }
+
+    // A released target: the list is dropped with its references, and the
+    // next frame encodes against the new target
+    void TestInvalidate() {
+        FakeContext ctx;
+        Resource src, oldTarget, newTarget;
+        Cache cache(ctx);
+        Frame(cache, ctx, Pass::DownscaleRight, src, oldTarget, 0.0f);
+        cache.RecordPending();
+        CHECK(oldTarget.refs == 2);
+        // The manager invalidates before releasing the texture
+        cache.Invalidate(Pass::DownscaleRight);
+        oldTarget.released = true;
+        CHECK(oldTarget.refs == 1 && ctx.lists == 0);
+        Frame(cache, ctx, Pass::DownscaleRight, src, newTarget, 0.0f);
+        CHECK(ctx.executed.back().target == &newTarget);
+        // A job queued before an invalidation is dropped, not recorded
+        cache.Invalidate(Pass::DownscaleRight);
+        cache.RecordPending();
+        CHECK(ctx.recordings == 1 && ctx.jobs == 0);
+        CHECK(ctx.staleExecutes == 0);
+        // Other passes are untouched
+        Frame(cache, ctx, Pass::SharpenRight, src, newTarget, 0.5f);
+        cache.RecordPending();
+        cache.Invalidate(Pass::DownscaleLeft);
+        CHECK(cache.GetStats().ready == 1);
+    }
+
+    // A list that cannot be recorded is not retried for the same key
+    void TestFailedRecording() {
+        FakeContext ctx;
+        Resource src, dst;
+        Cache cache(ctx);
+        ctx.fail = true;
+        for (int frame = 0; frame < 5; ++frame) {
+            Frame(cache, ctx, Pass::SharpenLeft, src, dst, 0.5f);
+            cache.RecordPending();
+        }
+        CHECK(ctx.recordings == 1);
+        CHECK(cache.GetStats().failed == 1);
+        CHECK(ctx.executed.size() == 5);  // every frame still ran the pass
+        // After an invalidation (or for another key) it is tried again
+        ctx.fail = false;
+        cache.Invalidate(Pass::SharpenLeft);
+        Frame(cache, ctx, Pass::SharpenLeft, src, dst, 0.5f);
+        cache.RecordPending();
+        CHECK(cache.Execute(Pass::SharpenLeft, MakeKey(src, dst, 0.5f)));
+    }
+
+    // Spins until pred holds; false after a few seconds (a broken cache must fail, not hang)
+    template <typename Pred>
+    bool WaitUntil(Pred pred) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!pred()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    // Invalidated, or given a newer key, while the worker records: the
+    // finished list is discarded, never replayed
+    void TestInvalidateWhileRecording() {
+        FakeContext ctx;
+        Resource src, oldTarget, newTarget;
+        Cache cache(ctx);
+        cache.Start();
+
+        ctx.hold = true;
+        Frame(cache, ctx, Pass::SharpenLeft, src, oldTarget, 0.5f);
+        CHECK(WaitUntil([&]() { return ctx.recording.load(); }));
+        cache.Invalidate(Pass::SharpenLeft);
+        oldTarget.released = true;
+        ctx.hold = false;
+        CHECK(WaitUntil([&]() { return cache.GetStats().stale == 1; }));
+        CHECK(cache.GetStats().ready == 0 && cache.GetStats().recorded == 0);
+        CHECK(ctx.lists == 0 && oldTarget.refs == 1);
+        Frame(cache, ctx, Pass::SharpenLeft, src, newTarget, 0.5f);
+        CHECK(ctx.executed.back().target == &newTarget);
+
+        // A newer key queued during the recording wins
+        CHECK(WaitUntil([&]() { return cache.GetStats().recorded == 1; }));
+        ctx.hold = true;
+        Frame(cache, ctx, Pass::SharpenLeft, src, newTarget, 0.75f);
+        CHECK(WaitUntil([&]() { return ctx.recording.load(); }));
+        Frame(cache, ctx, Pass::SharpenLeft, src, newTarget, 1.0f);
+        ctx.hold = false;
+        CHECK(WaitUntil([&]() { return cache.GetStats().recorded == 2; }));
+        CHECK(!cache.Execute(Pass::SharpenLeft, MakeKey(src, newTarget, 0.75f)));
+        CHECK(cache.Execute(Pass::SharpenLeft, MakeKey(src, newTarget, 1.0f)));
+        CHECK(cache.GetStats().stale == 2);
+        cache.Stop();
+        CHECK(ctx.lists == 0 && ctx.jobs == 0);
+        CHECK(ctx.staleExecutes == 0);
+    }
+
+    // Worker thread with slow recordings while the render thread changes
+    // keys and invalidates: every frame runs the pass exactly once, never a
+    // stale list, and nothing leaks
+    void TestWorker() {
+        FakeContext ctx;
+        ctx.recordDelayUs = 200;
+        Resource src;
+        std::vector<Resource> targets(8);
+        {
+            Cache cache(ctx);
+            cache.Start();
+            CHECK(cache.IsRunning());
+            constexpr int kFrames = 2000;
+            int released = 0;
+            size_t passes = 0;
+            for (int frame = 0; frame < kFrames; ++frame) {
+                Resource& target = targets[frame / 250];
+                const float sharpness = (frame / 40) % 3 * 0.25f;
+                Frame(cache, ctx, Pass::SharpenLeft, src, target, sharpness);
+                Frame(cache, ctx, Pass::SharpenRight, src, target, sharpness);
+                passes += 2;
+                if (frame % 250 == 249) {
+                    // Target recreated: invalidate, then the old one is gone
+                    cache.InvalidateAll();
+                    if (frame + 1 < kFrames) target.released = true;
+                    ++released;
+                }
+                if (frame % 8 == 0) std::this_thread::yield();
+            }
+            // Settle: the last key is eventually replayed
+            Resource& last = targets[(kFrames - 1) / 250];
+            const float lastSharpness = ((kFrames - 1) / 40) % 3 * 0.25f;
+            bool replayed = false;
+            for (int i = 0; i < 2000 && !replayed; ++i) {
+                const uint64_t before = cache.GetStats().executed;
+                Frame(cache, ctx, Pass::SharpenLeft, src, last, lastSharpness);
+                ++passes;
+                replayed = cache.GetStats().executed > before;
+                if (!replayed) std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+            CHECK(replayed);
+            CHECK(ctx.executed.size() == passes);
+            const Stats s = cache.GetStats();
+            CHECK(s.executed + s.misses == passes);
+            CHECK(s.executed > 0 && s.recorded > 0);
+            CHECK(s.invalidations == static_cast<uint64_t>(released) * kPassCount);
+            cache.Stop();
+            CHECK(!cache.IsRunning());
+        }
+        CHECK(ctx.staleExecutes == 0);
+        CHECK(ctx.lists == 0 && ctx.jobs == 0);
+        CHECK(src.refs == 1);
+        for (const Resource& r : targets) CHECK(r.refs == 1);
+    }
+}
+
+int main() {
+    TestReplayMatchesDirect();
+    TestInvalidate();
+    TestFailedRecording();
+    TestInvalidateWhileRecording();
+    TestWorker();
+    return DLSSTest::Result();
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cmath>
+#include <cstdio>
+
+// Minimal check macros for the platform-free dlss_*.h modules. A failed
+// check reports and continues; each test's main() returns DLSSTest::Result().
+namespace DLSSTest {
+
+    inline int& Failures() {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline void Fail(const char* file, int line, const char* expr) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+        ++Failures();
+    }
+
+    inline int Result() {
+        if (Failures()) {
+            std::fprintf(stderr, "%d check(s) failed\n", Failures());
+            return 1;
+        }
+        return 0;
+    }
+}
+
+#define CHECK(expr) \
+    do { \
+        if (!(expr)) DLSSTest::Fail(__FILE__, __LINE__, #expr); \
+    } while (0)
+
+#define CHECK_NEAR(a, b, eps) \
+    do { \
+        if (!(std::fabs(static_cast<double>(a) - static_cast<double>(b)) <= static_cast<double>(eps))) { \
+            std::fprintf(stderr, "  %g vs %g\n", static_cast<double>(a), static_cast<double>(b)); \
+            DLSSTest::Fail(__FILE__, __LINE__, #a " ~= " #b); \
+        } \
+    } while (0)
@@ -0,0 +1,175 @@
+#include "dlss_ctxstate.h"
+#include "test_common.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace DLSSContextState;
+
+namespace {
+    constexpr uintptr_t kImmediate = 0x1000;
+
+    // Facts and pipeline state stay with their context; a finished list
+    // carries its facts into the context that executes it
+    void TestListsMerge() {
+        Table table;
+        const uintptr_t deferred = 0x2000;
+        {
+            Lease d = table.Acquire(deferred);
+            CHECK(d && d->frame == table.Frame());
+            d->flags.sceneActive = true;
+            d->flags.scene.width = 2016;
+            d->flags.clampedViewports = 3;
+            d->redirectBindActive = true;
+        }
+        table.Finish(deferred, 0x9000, false);
+        {
+            Lease d = table.Acquire(deferred);
+            CHECK(!d->flags.sceneActive && d->flags.clampedViewports == 0);
+            CHECK(!d->redirectBindActive);  // not restored: the runtime cleared the pipeline
+            Lease i = table.Acquire(kImmediate);
+            CHECK(!i->flags.sceneActive);
+        }
+        CHECK(table.Execute(kImmediate, 0x9000));
+        CHECK(table.Execute(kImmediate, 0x9000));  // every execution merges
+        CHECK(!table.Execute(kImmediate, 0x9001));
+        {
+            Lease i = table.Acquire(kImmediate);
+            CHECK(i->flags.sceneActive && i->flags.scene.width == 2016);
+            CHECK(i->flags.clampedViewports == 6);
+        }
+        CHECK(table.GetStats().listsMerged == 2);
+
+        // Per-frame facts clear on the next frame; pipeline state stays
+        {
+            Lease i = table.Acquire(kImmediate);
+            i->lastViewportCount = 2;
+        }
+        table.BeginFrame();
+        {
+            Lease i = table.Acquire(kImmediate);
+            CHECK(!i->flags.sceneActive && i->flags.clampedViewports == 0);
+            CHECK(i->lastViewportCount == 2);
+            CHECK(i->clampLogBudget == kClampLogBudget);
+        }
+    }
+
+    // A full table passes new contexts through until a slot has been idle
+    // for kIdleFrames; the new owner starts from a clean State
+    void TestIdleRetire() {
+        Table table;
+        for (uintptr_t c = 1; c <= kMaxContexts; ++c) {
+            Lease l = table.Acquire(c);
+            CHECK(l);
+            l->redirectSmallWidth = static_cast<uint32_t>(c);
+        }
+        CHECK(!table.Acquire(0x999));
+        CHECK(table.GetStats().tableFull == 1);
+        // Context 1 stays busy; the others go quiet
+        for (uint64_t f = 0; f < kIdleFrames; ++f) {
+            table.BeginFrame();
+            table.Acquire(1);
+        }
+        {
+            Lease l = table.Acquire(0x999);
+            CHECK(l);
+            CHECK(l->redirectSmallWidth == 0);
+        }
+        {
+            Lease l = table.Acquire(1);
+            CHECK(l && l->redirectSmallWidth == 1);
+        }
+        CHECK(table.GetStats().retired == 1);
+        CHECK(table.GetStats().contexts == kMaxContexts);
+        CHECK(!table.Acquire(0));
+    }
+
+    // An idle context that is inside a hook call keeps its slot
+    void TestPinnedSlotIsKept() {
+        Table table;
+        Lease held = table.Acquire(1);
+        held->redirectSmallWidth = 1;
+        for (uintptr_t c = 2; c <= kMaxContexts; ++c) table.Acquire(c);
+        for (uint64_t f = 0; f < kIdleFrames; ++f) {
+            table.BeginFrame();
+            for (uintptr_t c = 2; c <= kMaxContexts; ++c) table.Acquire(c);
+        }
+        // Slot 1 is the only idle one, but its lease is live
+        CHECK(!table.Acquire(0x999));
+        CHECK(held->redirectSmallWidth == 1);
+        held = Lease();
+        {
+            Lease l = table.Acquire(0x999);
+            CHECK(l && l->redirectSmallWidth == 0);
+        }
+        CHECK(table.GetStats().retired == 1);
+    }
+
+    // Replay: more contexts than slots on several threads (each context on
+    // one thread, as D3D11 requires), contexts going quiet for a while, and
+    // Present advancing frames meanwhile. Inside a lease the State must be
+    // the context's own: its marker from an earlier call, or a clean State
+    // after a retirement, and never changed by another thread mid-call.
+    void TestThreadedReplay() {
+        Table table;
+        constexpr int kThreads = 4;
+        constexpr int kContextsPerThread = 6;  // 24 contexts for 16 slots
+        constexpr int kCallsPerThread = 20000;
+        std::atomic<bool> stop{ false };
+        std::atomic<int> foreign{ 0 };     // State carried another context's marker
+        std::atomic<int> clobbered{ 0 };   // State changed during a lease
+        std::atomic<int> passedThrough{ 0 };
+
+        std::thread present([&]() {
+            while (!stop.load(std::memory_order_relaxed)) {
+                table.BeginFrame();
+                std::this_thread::yield();
+            }
+        });
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < kThreads; ++t) {
+            workers.emplace_back([&, t]() {
+                uint32_t rng = 0x9E3779B9u * (t + 1);
+                auto next = [&rng]() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; };
+                for (int call = 0; call < kCallsPerThread; ++call) {
+                    // Half of the thread's contexts at a time, so the other half goes idle
+                    const uint32_t half = static_cast<uint32_t>((call / 2000) % 2) * (kContextsPerThread / 2);
+                    const uint32_t id = static_cast<uint32_t>(t * kContextsPerThread) + half + next() % (kContextsPerThread / 2) + 1;
+                    Lease l = table.Acquire(0x10000 + id * 16);
+                    if (!l) {
+                        ++passedThrough;
+                        continue;
+                    }
+                    if (l->redirectSmallWidth != 0 && l->redirectSmallWidth != id) ++foreign;
+                    l->redirectSmallWidth = id;
+                    l->lastViewportCount = id;
+                    // Hook calls take a while, and now and then long enough
+                    // for the context to count as idle while still inside one
+                    const uint32_t spins = (next() % 64 == 0) ? 2 * static_cast<uint32_t>(kIdleFrames) : next() % 4;
+                    for (uint32_t i = 0; i < spins; ++i) std::this_thread::yield();
+                    if (l->redirectSmallWidth != id || l->lastViewportCount != id) ++clobbered;
+                }
+            });
+        }
+        for (std::thread& w : workers) w.join();
+        stop = true;
+        present.join();
+
+        const Stats s = table.GetStats();
+        CHECK(foreign == 0);
+        CHECK(clobbered == 0);
+        CHECK(s.retired > 0);  // the replay did exercise retirement
+        CHECK(s.contexts == kMaxContexts);
+        CHECK(s.tableFull == static_cast<uint64_t>(passedThrough.load()));
+    }
+}
+
+int main() {
+    TestListsMerge();
+    TestIdleRetire();
+    TestPinnedSlotIsKept();
+    TestThreadedReplay();
+    return DLSSTest::Result();
+}
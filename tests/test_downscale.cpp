@@ -0,0 +1,134 @@
+#include "dlss_downscale.h"
+#include "test_common.h"
+
+#include <vector>
+
+using namespace DLSSDownscale;
+
+namespace {
+    const Filter kFilters[] = { Filter::Box, Filter::Bilinear, Filter::CatmullRom, Filter::Lanczos };
+
+    // Every output pixel's taps sum to 1, wherever its centre falls and
+    // whatever the kernel stretch, including clamped edge taps
+    void TestWeightSum() {
+        std::vector<Tap> taps;
+        for (Filter f : kFilters) {
+            for (float ratio : { 0.5f, 1.0f, 1.25f, 1.5f, 2.0f, 2.5f, 3.0f, 4.0f }) {
+                const float scale = KernelScale(f, ratio);
+                for (float center = 0.0f; center < 40.0f; center += 0.137f) {
+                    ComputeTaps(f, center, scale, 0, 31, taps);
+                    CHECK(taps.size() == Taps(f));
+                    float sum = 0.0f;
+                    for (const Tap& t : taps) {
+                        sum += t.weight;
+                        CHECK(t.texel >= 0 && t.texel <= 31);
+                    }
+                    CHECK_NEAR(sum, 1.0f, 1e-5f);
+                }
+            }
+        }
+    }
+
+    // A constant image stays constant (DC gain 1) in every layout and at
+    // every size, and a linear ramp keeps its mean
+    void TestEnergyPreservation() {
+        const uint32_t sizes[][2] = { { 1000, 500 }, { 999, 333 }, { 1000, 1000 }, { 500, 1000 }, { 1024, 410 }, { 2016, 1344 } };
+        for (Filter f : kFilters) {
+            for (const auto& sz : sizes) {
+                const uint32_t srcW = sz[0], dstW = sz[1];
+                std::vector<float> src(srcW * 8, 0.75f), dst(dstW * 4);
+                Resample(f, Layout::Mono, src.data(), srcW, 8, dst.data(), dstW, 4);
+                for (float v : dst) CHECK_NEAR(v, 0.75f, 1e-5f);
+                Resample(f, Layout::Stereo, src.data(), srcW & ~1u, 8, dst.data(), dstW & ~1u, 4);
+                for (uint32_t i = 0; i < (dstW & ~1u); ++i) CHECK_NEAR(dst[i], 0.75f, 1e-5f);
+
+                // Ramp: interior outputs sample it at their own centre, so the
+                // image is not shifted (within a tenth of a source texel)
+                std::vector<float> ramp(srcW * 4), out(dstW * 2);
+                for (uint32_t y = 0; y < 4; ++y) {
+                    for (uint32_t x = 0; x < srcW; ++x) ramp[y * srcW + x] = static_cast<float>(x);
+                }
+                Resample(f, Layout::Mono, ramp.data(), srcW, 4, out.data(), dstW, 2);
+                const float ratio = static_cast<float>(srcW) / static_cast<float>(dstW);
+                for (uint32_t x = 4; x + 4 < dstW; ++x) {
+                    CHECK_NEAR(out[x], (static_cast<float>(x) + 0.5f) * ratio - 0.5f, 0.1f);
+                }
+            }
+        }
+    }
+
+    // Box is an exact area average up to a 3x ratio: every interior source
+    // texel contributes exactly its share. The cubic kernels stay close.
+    void TestCoverage() {
+        std::vector<float> cov;
+        for (const auto& sz : { std::make_pair(1000u, 500u), std::make_pair(999u, 333u), std::make_pair(1000u, 1000u), std::make_pair(900u, 600u) }) {
+            Coverage(Filter::Box, sz.first, sz.second, cov);
+            for (size_t i = 3; i + 3 < cov.size(); ++i) CHECK_NEAR(cov[i], 1.0f, 1e-4f);
+            // Over the whole axis the weight handed out equals the outputs written
+            double total = 0.0;
+            for (float c : cov) total += c;
+            CHECK_NEAR(total / sz.first, 1.0, 1e-4);
+        }
+        for (Filter f : { Filter::CatmullRom, Filter::Lanczos }) {
+            Coverage(f, 1000, 500, cov);
+            for (size_t i = 3; i + 3 < cov.size(); ++i) CHECK(cov[i] > 0.95f && cov[i] < 1.05f);
+        }
+    }
+
+    // The compute path's groupshared indexing reads exactly the pixel
+    // shader's taps, including the partial last tiles of 1344x1494
+    void TestComputeTiles() {
+        const uint32_t sizes[][4] = {
+            { 2016, 2240, 1344, 1494 },   // 1.5x to the render size of a 1344x1494 eye
+            { 336, 374, 336, 374 },       // 1:1, partial tiles on both axes
+            { 672, 748, 336, 374 },       // 2x
+            { 1000, 999, 501, 333 },      // odd sizes, ratio 1.996 / 3
+            { 336, 374, 504, 561 },       // upscale
+        };
+        for (Filter f : kFilters) {
+            for (const auto& sz : sizes) {
+                const TileCheck c = SimulateTiles(f, sz[0], sz[1], sz[2], sz[3]);
+                const bool fits = ComputeFits(f, sz[0], sz[2]) && ComputeFits(f, sz[1], sz[3]);
+                CHECK(c.ok == fits);
+                CHECK(c.groups == TileCount(sz[2]) * TileCount(sz[3]));
+                if (fits) {
+                    CHECK(c.outputs == sz[2] * sz[3]);
+                    CHECK(c.wrongTaps == 0);
+                }
+            }
+        }
+        // 1344x1494 is not a multiple of the tile: the last column and row of
+        // groups are partial and must still write each output once
+        CHECK(1344 % kTileSize == 0 && 1494 % kTileSize != 0);
+        const TileCheck c = SimulateTiles(Filter::CatmullRom, 2016, 2240, 1344, 1494);
+        CHECK(c.ok);
+        CHECK(c.maxSpan <= kTileSource);
+        // Past the block the compute path is refused, and the simulator sees wrong taps
+        const TileCheck wide = SimulateTiles(Filter::Lanczos, 4096, 64, 512, 64);
+        CHECK(!ComputeFits(Filter::Lanczos, 4096, 512));
+        CHECK(!wide.ok);
+        CHECK(wide.maxSpan > kTileSource);
+        CHECK(wide.wrongTaps > 0);
+    }
+
+    // Stereo taps never read across the seam between the eyes
+    void TestStereoSeam() {
+        for (Filter f : kFilters) {
+            std::vector<float> src(200 * 4), dst(100 * 2);
+            for (uint32_t y = 0; y < 4; ++y) {
+                for (uint32_t x = 0; x < 200; ++x) src[y * 200 + x] = x < 100 ? 0.0f : 1.0f;
+            }
+            Resample(f, Layout::Stereo, src.data(), 200, 4, dst.data(), 100, 2);
+            for (uint32_t x = 0; x < 100; ++x) CHECK_NEAR(dst[x], x < 50 ? 0.0f : 1.0f, 1e-6f);
+        }
+    }
+}
+
+int main() {
+    TestWeightSum();
+    TestEnergyPreservation();
+    TestCoverage();
+    TestStereoSeam();
+    TestComputeTiles();
+    return DLSSTest::Result();
+}
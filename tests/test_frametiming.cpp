@@ -0,0 +1,126 @@
+#include "dlss_frametiming.h"
+#include "test_common.h"
+
+using namespace DLSSFrameTiming;
+
+namespace {
+    void TestBuckets() {
+        uint32_t previous = 0;
+        for (uint64_t us = 0; us < 5000000; us += (us < 100 ? 1 : us / 37)) {
+            const uint32_t b = Histogram::BucketOf(us);
+            const uint64_t clamped = us > Histogram::kMaxValueUs ? Histogram::kMaxValueUs : us;
+            CHECK(b < Histogram::kBucketCount);
+            CHECK(b >= previous);
+            CHECK(Histogram::LowerBound(b) <= clamped && clamped <= Histogram::UpperBound(b));
+            if (clamped >= Histogram::kLinearCount) {
+                // <= 6.25% relative bucket width
+                CHECK((Histogram::UpperBound(b) - Histogram::LowerBound(b)) * 16 <= Histogram::LowerBound(b));
+            }
+            previous = b;
+        }
+        // Buckets tile the range without gaps
+        for (uint32_t b = 1; b < Histogram::kBucketCount; ++b) {
+            CHECK(Histogram::LowerBound(b) == Histogram::UpperBound(b - 1) + 1);
+        }
+        CHECK(Histogram::UpperBound(Histogram::kBucketCount - 1) == Histogram::kMaxValueUs);
+    }
+
+    void TestPercentiles() {
+        Histogram h;
+        CHECK(h.PercentileUs(50.0) == 0);
+        for (uint64_t i = 1; i <= 1000; ++i) h.Add(i * 100);
+        CHECK(h.Count() == 1000);
+        CHECK(h.MaxUs() == 100000);
+        CHECK_NEAR(h.MeanUs(), 50050.0, 1e-9);
+        // Upper bucket edge: never below the true value, at most one bucket above
+        const uint64_t p50 = h.PercentileUs(50.0);
+        const uint64_t p99 = h.PercentileUs(99.0);
+        CHECK(p50 >= 50000 && p50 <= 50000 + 50000 / 16);
+        CHECK(p99 >= 99000 && p99 <= 100000);
+        CHECK(h.PercentileUs(100.0) == 100000);
+
+        Histogram other;
+        other.Add(3000000);
+        h.Merge(other);
+        CHECK(h.Count() == 1001);
+        CHECK(h.MaxUs() == 3000000);
+        h.Clear();
+        CHECK(h.Count() == 0 && h.MaxUs() == 0);
+    }
+
+    void TestStream() {
+        Stream s;
+        s.SetBudgetMs(10.0);
+        CHECK(s.Tick(0.0) < 0.0);
+        CHECK_NEAR(s.Tick(10.0), 10.0, 1e-9);
+        CHECK_NEAR(s.Tick(21.5), 11.5, 1e-9);  // over budget with slack
+        CHECK_NEAR(s.Tick(51.5), 30.0, 1e-9);  // hitch: three budgets
+        CHECK(s.Tick(51.5 + kMaxIntervalMs + 1.0) < 0.0);  // pause, not a frame
+        CHECK(s.Session().Count() == 3);
+        CHECK(s.SessionOverBudget() == 2);
+        CHECK(s.SessionHitches() == 1);
+
+        // Per-second rollups, newest first
+        s.Reset();
+        CHECK(s.BudgetMs() == 10.0);
+        double now = 0.0;
+        for (int i = 0; i < 500; ++i) {
+            s.Tick(now);
+            now += (i >= 200 && i < 300) ? 12.0 : 10.0;
+        }
+        CHECK(s.RollupCount() >= 4);
+        CHECK(s.Rollup(0).overBudget == 0);
+        uint32_t over = 0;
+        for (uint32_t age = 0; age < s.RollupCount(); ++age) over += s.Rollup(age).overBudget;
+        CHECK(over == 100);
+        CHECK(s.Rollup(0).frames >= 99 && s.Rollup(0).frames <= 101);
+    }
+
+    void TestHitchAttribution() {
+        Tracker t;
+        t.SetRefreshRate(90.0f);
+        t.SetRefreshRate(5.0f);  // out of range, ignored
+        CHECK(t.RefreshRate() == 90.0f);
+
+        double now = 1000.0;
+        t.OnPresent(now);
+        for (int i = 0; i < 900; ++i) {
+            double dt = 1000.0 / 90.0;
+            if (i == 300) {
+                t.Note(Event::Resize, now + 2.0);
+                dt = 60.0;
+            }
+            if (i == 600) dt = 45.0;
+            now += dt;
+            t.OnPresent(now);
+        }
+        const HitchCorrelator& c = t.Hitches();
+        CHECK(c.HitchCount() == 2);
+        CHECK(c.CauseCount(Event::Resize) == 1);
+        CHECK(c.Unattributed() == 1);
+        CHECK(c.EventCount(Event::Resize) == 1);
+        const Hitch& older = c.RecentHitch(1);
+        CHECK(older.attributed && older.cause == Event::Resize);
+        CHECK_NEAR(older.causeLeadMs, 2.0, 1e-3);
+        CHECK(!c.RecentHitch(0).attributed);
+        CHECK(t.Present().SessionHitches() == 2);
+
+        // An event explains one hitch per stream, not two on the same stream
+        HitchCorrelator corr;
+        corr.Note(Event::ConfigApply, 100.0);
+        CHECK(corr.OnHitch(StreamId::Present, 140.0, 40.0).attributed);
+        CHECK(!corr.OnHitch(StreamId::Present, 180.0, 80.0).attributed);
+        CHECK(corr.OnHitch(StreamId::Submit, 141.0, 40.0).attributed);
+        // Too long before the interval began
+        corr.Note(Event::FeatureCreate, 200.0);
+        CHECK(!corr.OnHitch(StreamId::Present, 300.0, 40.0).attributed);
+    }
+}
+
+int main() {
+    TestBuckets();
+    TestPercentiles();
+    TestStream();
+    TestHitchAttribution();
+    return DLSSTest::Result();
+}
@@ -0,0 +1,224 @@
+#include "dlss_history.h"
+#include "test_common.h"
+
+#include <vector>
+
+using namespace DLSSHistory;
+
+namespace {
+    constexpr uint32_t kW = 320, kH = 180;
+
+    // HMD pose: yaw about +Y, then a translation (row-vector, translation in row 3)
+    DLSSCamera::Float4x4 Pose(float yawDeg, float x, float z = 0.0f) {
+        const float r = yawDeg * 3.14159265f / 180.0f;
+        DLSSCamera::Float4x4 m = DLSSCamera::Identity();
+        m.m[0][0] = std::cos(r); m.m[0][2] = -std::sin(r);
+        m.m[2][0] = std::sin(r); m.m[2][2] = std::cos(r);
+        m.m[3][0] = x;
+        m.m[3][2] = z;
+        return m;
+    }
+
+    // Non-reversed depth of a corridor: a near wall on the left fading into
+    // the distance on the right; 'shift' slides it sideways as the head turns
+    std::vector<float> Corridor(float shift) {
+        std::vector<float> d(kW * kH);
+        for (uint32_t y = 0; y < kH; ++y) {
+            for (uint32_t x = 0; x < kW; ++x) {
+                float u = static_cast<float>(x) / kW + shift;
+                u -= std::floor(u);
+                d[y * kW + x] = 0.90f + 0.095f * u;
+            }
+        }
+        return d;
+    }
+
+    // An open landscape: sky (far plane) above, ground receding below
+    std::vector<float> Landscape() {
+        std::vector<float> d(kW * kH);
+        for (uint32_t y = 0; y < kH; ++y) {
+            const float v = static_cast<float>(y) / kH;
+            for (uint32_t x = 0; x < kW; ++x) d[y * kW + x] = v < 0.5f ? 1.0f : 0.9995f - 0.002f * (v - 0.5f);
+        }
+        return d;
+    }
+
+    struct Bins {
+        uint32_t v[kDepthBins];
+    };
+
+    Bins Histogram(const std::vector<float>& depth, bool inverted = false) {
+        Bins b;
+        BuildDepthHistogram(depth.data(), kW, kH, inverted, b.v);
+        return b;
+    }
+
+    // Drives one eye's tracker at 90 Hz
+    struct Sequence {
+        Tracker tracker;
+        FrameInput in;
+        uint64_t now = 5000;
+
+        Sequence() {
+            in.renderWidth = 1344; in.renderHeight = 1494;
+            in.outputWidth = 2016; in.outputHeight = 2240;
+            in.havePose = true;
+        }
+        Decision Step(const DLSSCamera::Float4x4& pose, const uint32_t* bins = nullptr, uint64_t dtMs = 11) {
+            now += dtMs;
+            in.timeMs = now;
+            in.headToWorld = pose;
+            in.depthBins = bins;
+            return tracker.Update(in);
+        }
+    };
+
+    void TestDepthHistogram() {
+        const Bins a = Histogram(Corridor(0.0f));
+        CHECK(HistogramTotal(a.v) == kDepthGrid * kDepthGrid);
+        CHECK(HistogramDistance(a.v, a.v) == 0.0f);
+        // A head turn slides the corridor: similar distribution
+        const Bins turned = Histogram(Corridor(0.05f));
+        CHECK(HistogramDistance(a.v, turned.v) < 0.2f);
+        // A different scene is a cut
+        const Bins open = Histogram(Landscape());
+        CHECK(HistogramDistance(a.v, open.v) > 0.6f);
+        // Reversed Z of the same scene bins the same
+        std::vector<float> reversed = Corridor(0.0f);
+        for (float& z : reversed) z = 1.0f - z;
+        const Bins r = Histogram(reversed, true);
+        CHECK(HistogramDistance(a.v, r.v) == 0.0f);
+        // Empty histograms compare as unknown
+        const Bins empty{};
+        CHECK(HistogramDistance(a.v, empty.v) < 0.0f);
+        // Bin edges: near plane first, far plane last, one octave per two bins
+        CHECK(DepthBin(0.0f, false) == 0);
+        CHECK(DepthBin(1.0f, false) == kDepthBins - 1);
+        CHECK(DepthBin(0.5f, false) == 2);
+        CHECK(DepthBin(0.5f, true) == 2);
+        CHECK(DepthSampleCoord(0, 1) == 0);
+        CHECK(DepthSampleCoord(kDepthGrid - 1, 10) == 9);
+        CHECK(DepthSampleCoord(kDepthGrid - 1, 4096) < 4096);
+    }
+
+    // Seated play: slow head motion and a drifting depth histogram never reset
+    void TestSmoothMotion() {
+        Sequence s;
+        CHECK(s.Step(Pose(0, 0)).reasons == Reason::ResourceRecreated);
+        for (int i = 1; i <= 900; ++i) {
+            // 10 s: looking around at up to 90 deg/s and leaning half a metre
+            const float t = static_cast<float>(i) / 90.0f;
+            const float yaw = 60.0f * std::sin(t * 1.5f);
+            const float x = 0.25f * std::sin(t * 0.7f);
+            const Bins b = Histogram(Corridor(yaw / 360.0f));
+            const Decision d = s.Step(Pose(yaw, x), (i % 3 == 0) ? b.v : nullptr);
+            CHECK(!d.reset);
+            CHECK(d.rotationDeg < s.tracker.GetThresholds().maxRotationDeg);
+            if (i % 3 == 0 && i > 3) CHECK(d.depthDistance >= 0.0f && d.depthDistance < 0.4f);
+            if (i % 3 != 0) CHECK(d.depthDistance < 0.0f);
+        }
+        CHECK(s.tracker.Frames() == 901);
+        CHECK(s.tracker.Resets() == 1);
+    }
+
+    // Each event resets exactly once, for its own reason
+    void TestEvents() {
+        Sequence s;
+        const Bins corridor = Histogram(Corridor(0.0f));
+        const Bins open = Histogram(Landscape());
+        s.Step(Pose(0, 0), corridor.v);
+        CHECK(!s.Step(Pose(1, 0), corridor.v).reset);
+
+        // Snap turn
+        Decision d = s.Step(Pose(46, 0));
+        CHECK(d.reasons == Reason::PoseJump);
+        CHECK_NEAR(d.rotationDeg, 45.0f, 0.05f);
+        CHECK(!s.Step(Pose(47, 0)).reset);
+
+        // Teleport (3 m)
+        d = s.Step(Pose(47, 3.0f));
+        CHECK(d.reasons == Reason::PoseJump);
+        CHECK_NEAR(d.translation, 3.0f, 1e-4f);
+        CHECK(!s.Step(Pose(47, 3.01f)).reset);
+
+        // Door into the open: the depth histogram two frames later shows the cut
+        CHECK(!s.Step(Pose(47, 3.01f)).reset);
+        d = s.Step(Pose(47, 3.01f), open.v);
+        CHECK(d.reasons == Reason::DepthCut);
+        CHECK(!s.Step(Pose(47, 3.01f), open.v).reset);
+
+        // Loading screen: resets while loading and for the settle frames after
+        s.in.loading = true;
+        CHECK(s.Step(Pose(47, 3.01f)).reasons == Reason::Loading);
+        CHECK(s.Step(Pose(47, 3.01f)).reasons == Reason::Loading);
+        s.in.loading = false;
+        for (uint32_t i = 0; i < s.tracker.GetThresholds().loadingSettleFrames; ++i) {
+            CHECK(s.Step(Pose(47, 3.01f)).reasons == Reason::Loading);
+        }
+        CHECK(!s.Step(Pose(47, 3.01f)).reset);
+
+        // The compositor held the HMD for half a second
+        CHECK(s.Step(Pose(47, 3.01f), nullptr, 500).reasons == Reason::FrameGap);
+        CHECK(!s.Step(Pose(47, 3.01f)).reset);
+
+        // Tracking lost: no pose, no reset; regained at a new spot: reset once
+        s.in.havePose = false;
+        CHECK(!s.Step(Pose(0, 0)).reset);
+        CHECK(!s.Step(Pose(0, 0)).reset);
+        s.in.havePose = true;
+        CHECK(s.Step(Pose(48, 3.02f)).reasons == Reason::PoseJump);
+        CHECK(!s.Step(Pose(48, 3.02f)).reset);
+
+        // Settings change and a size change in the same frame
+        s.tracker.Invalidate(Reason::Settings);
+        s.in.renderWidth = 1152;
+        d = s.Step(Pose(48, 3.02f));
+        CHECK(d.reasons == (Reason::Settings | Reason::SizeChanged));
+        CHECK(!s.Step(Pose(48, 3.02f)).reset);
+
+        CHECK(s.tracker.ResetCount(0) == 1);  // first frame
+        CHECK(s.tracker.ResetCount(1) == 1);  // size
+        CHECK(s.tracker.ResetCount(2) == 3);  // turn, teleport, tracking regained
+        CHECK(s.tracker.ResetCount(3) == 1);  // depth cut
+        CHECK(s.tracker.ResetCount(4) == 2 + s.tracker.GetThresholds().loadingSettleFrames);
+        CHECK(s.tracker.ResetCount(5) == 1);  // gap
+        CHECK(s.tracker.ResetCount(6) == 1);  // settings
+        CHECK(s.tracker.ResetCount(kReasonCount) == 0);
+        CHECK(s.tracker.LastResetReasons() == (Reason::Settings | Reason::SizeChanged));
+    }
+
+    // Thresholds are per frame: the same turn spread over frames is smooth
+    void TestThresholdEdges() {
+        Sequence s;
+        const float maxDeg = s.tracker.GetThresholds().maxRotationDeg;
+        s.Step(Pose(0, 0));
+        CHECK(!s.Step(Pose(maxDeg - 0.5f, 0)).reset);
+        CHECK(s.Step(Pose(2.0f * maxDeg + 0.5f, 0)).reasons == Reason::PoseJump);
+        const float maxMove = s.tracker.GetThresholds().maxTranslation;
+        CHECK(!s.Step(Pose(2.0f * maxDeg + 0.5f, 0, maxMove * 0.9f)).reset);
+        CHECK(s.Step(Pose(2.0f * maxDeg + 0.5f, 0, maxMove * 2.1f)).reasons == Reason::PoseJump);
+
+        // Histograms with too few samples are ignored (and not kept as the reference)
+        Thresholds t;
+        t.depthMinSamples = kDepthGrid * kDepthGrid + 1;
+        s.tracker.SetThresholds(t);
+        const Bins corridor = Histogram(Corridor(0.0f));
+        const Bins open = Histogram(Landscape());
+        CHECK(s.Step(Pose(2.0f * maxDeg + 0.5f, 0, maxMove * 2.1f), corridor.v).depthDistance < 0.0f);
+        t.depthMinSamples = 1024;
+        s.tracker.SetThresholds(t);
+        CHECK(!s.Step(Pose(2.0f * maxDeg + 0.5f, 0, maxMove * 2.1f), open.v).reset);
+
+        // A clock that stepped backwards is not a gap
+        s.now -= 2000;
+        CHECK(!s.Step(Pose(2.0f * maxDeg + 0.5f, 0, maxMove * 2.1f)).reset);
+    }
+}
+
+int main() {
+    TestDepthHistogram();
+    TestSmoothMotion();
+    TestEvents();
+    TestThresholdEdges();
+    return DLSSTest::Result();
+}
@@ -0,0 +1,74 @@
+#include "dlss_init.h"
+#include "test_common.h"
+
+using namespace DLSSInit;
+
+namespace {
+    static_assert(RetryDelay(0) == kRetryFrames && RetryDelay(1) == kRetryFrames, "first retry");
+    static_assert(RetryDelay(2) == 2 * kRetryFrames && RetryDelay(3) == 4 * kRetryFrames, "doubling");
+    static_assert(RetryDelay(6) == kRetryMaxFrames && RetryDelay(1000) == kRetryMaxFrames, "capped");
+
+    struct FakeBackend {
+        int attempt = 0;
+        bool ready = false;
+    };
+
+    // The render thread's side of one attempt: adopt what the worker
+    // prepared, fall back to an inline backend, destroy whatever was replaced
+    void Attempt(FakeBackend*& current, FakeBackend*& prepared, int attempt, bool readyAfterInit, int& destroyed) {
+        if (FakeBackend* stale = AdoptPrepared(current, prepared)) {
+            ++destroyed;
+            delete stale;
+        }
+        if (!current) current = new FakeBackend{ attempt, false };
+        current->ready = readyAfterInit;
+    }
+
+    // Nothing prepared: the current backend stays
+    void TestNothingPrepared() {
+        FakeBackend* current = nullptr;
+        FakeBackend* prepared = nullptr;
+        CHECK(AdoptPrepared(current, prepared) == nullptr && current == nullptr);
+        FakeBackend kept{ 1, true };
+        current = &kept;
+        CHECK(AdoptPrepared(current, prepared) == nullptr && current == &kept);
+    }
+
+    // First attempt prepared on the worker
+    void TestFirstAttempt() {
+        FakeBackend* current = nullptr;
+        FakeBackend* prepared = new FakeBackend{ 1, false };
+        int destroyed = 0;
+        Attempt(current, prepared, 1, true, destroyed);
+        CHECK(current && current->attempt == 1 && current->ready);
+        CHECK(prepared == nullptr && destroyed == 0);
+        delete current;
+    }
+
+    // The first attempt leaves a backend that never became ready; the retry's
+    // freshly prepared backend replaces it instead of sitting unused
+    void TestRetryAfterNotReady() {
+        FakeBackend* current = nullptr;
+        FakeBackend* prepared = new FakeBackend{ 1, false };
+        int destroyed = 0;
+        Attempt(current, prepared, 1, false, destroyed);
+        CHECK(current && current->attempt == 1 && !current->ready);
+
+        prepared = new FakeBackend{ 2, false };
+        Attempt(current, prepared, 2, true, destroyed);
+        CHECK(current && current->attempt == 2 && current->ready);
+        CHECK(prepared == nullptr && destroyed == 1);
+
+        // A retry whose worker could not prepare one keeps the current backend
+        Attempt(current, prepared, 3, true, destroyed);
+        CHECK(current && current->attempt == 2 && destroyed == 1);
+        delete current;
+    }
+}
+
+int main() {
+    TestNothingPrepared();
+    TestFirstAttempt();
+    TestRetryAfterNotReady();
+    return DLSSTest::Result();
+}
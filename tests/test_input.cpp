@@ -0,0 +1,123 @@
+#include "dlss_input.h"
+#include "test_common.h"
+
+#include <thread>
+
+using namespace DLSSInput;
+
+namespace {
+    KeyEvent Key(uint16_t vk, bool down, uint32_t timeMs) {
+        KeyEvent e;
+        e.vk = vk;
+        e.down = down;
+        e.timeMs = timeMs;
+        return e;
+    }
+
+    void TestQueue() {
+        SpscQueue<uint32_t, 8> q;
+        uint32_t v = 0;
+        CHECK(q.Empty() && !q.Pop(v));
+        // One slot is never used
+        for (uint32_t i = 0; i < 7; ++i) CHECK(q.Push(i));
+        CHECK(!q.Push(7));
+        CHECK(q.Dropped() == 1);
+        for (uint32_t i = 0; i < 7; ++i) {
+            CHECK(q.Pop(v));
+            CHECK(v == i);
+        }
+        CHECK(q.Empty());
+        // Indices wrap
+        for (uint32_t round = 0; round < 20; ++round) {
+            CHECK(q.Push(round));
+            CHECK(q.Pop(v) && v == round);
+        }
+        CHECK(q.Dropped() == 1);
+    }
+
+    // Producer and consumer on two threads: every value arrives once, in order
+    void TestQueueThreads() {
+        static SpscQueue<uint32_t, 256> q;
+        constexpr uint32_t kCount = 500000;
+        std::thread producer([]() {
+            for (uint32_t i = 0; i < kCount;) {
+                if (q.Push(i)) ++i;
+                else std::this_thread::yield();
+            }
+        });
+        uint32_t expected = 0;
+        bool ordered = true;
+        while (expected < kCount) {
+            uint32_t v;
+            if (!q.Pop(v)) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (v != expected) ordered = false;
+            ++expected;
+        }
+        producer.join();
+        CHECK(ordered);
+        CHECK(q.Empty());
+    }
+
+    void TestChords() {
+        ChordMatcher m;
+        m.Bind(0, 0x47);
+        m.Bind(1, MakeChord(0x47, ModCtrl));
+        m.Bind(2, MakeChord(Vk::Shift, ModCtrl));
+        CHECK(m.Feed(Key(0x47, true, 0)) == 0);
+        CHECK(m.Feed(Key(0x47, true, 10)) == ChordMatcher::kNoAction);   // auto-repeat
+        CHECK(m.Feed(Key(0x47, false, 20)) == ChordMatcher::kNoAction);
+        CHECK(m.Feed(Key(0x47, true, 50)) == ChordMatcher::kNoAction);   // debounce
+        CHECK(m.Feed(Key(0x47, false, 60)) == ChordMatcher::kNoAction);
+        // Left/right modifiers count as the generic key; modifiers must match exactly
+        CHECK(m.Feed(Key(Vk::LControl, true, 400)) == ChordMatcher::kNoAction);
+        CHECK(m.IsDown(Vk::Control) && m.IsDown(Vk::RControl));
+        CHECK(m.Feed(Key(0x47, true, 410)) == 1);
+        CHECK(m.Feed(Key(Vk::RShift, true, 420)) == 2);
+        CHECK(m.Feed(Key(0x47, false, 425)) == ChordMatcher::kNoAction);
+        CHECK(m.Feed(Key(0x47, true, 900)) == ChordMatcher::kNoAction);  // Ctrl+Shift+G is not bound
+        // Focus lost releases everything
+        CHECK(m.Feed(Key(0, false, 950)) == ChordMatcher::kNoAction);
+        CHECK(!m.IsDown(Vk::Control) && !m.IsDown(0x47));
+        CHECK(m.Feed(Key(0x47, true, 1000)) == 0);
+        // The debounce window survives the millisecond clock wrapping
+        m.Feed(Key(0x47, false, 1010));
+        ChordMatcher w;
+        w.Bind(0, 0x20);
+        CHECK(w.Feed(Key(0x20, true, 0xFFFFFFF0u)) == 0);
+        w.Feed(Key(0x20, false, 0xFFFFFFF8u));
+        CHECK(w.Feed(Key(0x20, true, 0x10)) == ChordMatcher::kNoAction);
+        w.Feed(Key(0x20, false, 0x20));
+        CHECK(w.Feed(Key(0x20, true, 0x200)) == 0);
+        // Out-of-range actions are ignored
+        w.Bind(ChordMatcher::kMaxActions, 0x30);
+        CHECK(w.Feed(Key(0x30, true, 0x400)) == ChordMatcher::kNoAction);
+    }
+
+    void TestChordText() {
+        ChordText t;
+        CHECK(SplitChord("0x47", t) && t.mods == ModNone && t.key == "0x47");
+        CHECK(SplitChord("Ctrl+Shift+0x47", t) && t.mods == (ModCtrl | ModShift) && t.key == "0x47");
+        CHECK(SplitChord(" control + ALT + 71 ", t) && t.mods == (ModCtrl | ModAlt) && t.key == "71");
+        CHECK(SplitChord("Ctrl+", t) && t.mods == ModCtrl && t.key.empty());
+        // Unknown modifiers reject the binding instead of binding the bare key
+        CHECK(!SplitChord("Win+0x47", t) && t.badToken == "Win");
+        CHECK(!SplitChord("Ctrl+Super+0x47", t) && t.badToken == "Super");
+        CHECK(!SplitChord("+0x47", t) && t.badToken.empty());
+        CHECK(ParseModifier("SHIFT") == ModShift);
+        CHECK(ParseModifier("shiftx") == ModNone);
+        CHECK(ParseModifier("") == ModNone);
+        CHECK(ChordKey(MakeChord(0x47, ModCtrl | ModAlt)) == 0x47);
+        CHECK(ChordMods(MakeChord(0x47, ModCtrl | ModAlt)) == (ModCtrl | ModAlt));
+    }
+}
+
+int main() {
+    TestQueue();
+    TestQueueThreads();
+    TestChords();
+    TestChordText();
+    return DLSSTest::Result();
+}
@@ -0,0 +1,169 @@
+#include "dlss_passgraph.h"
+#include "test_common.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace DLSSPassGraph;
+
+namespace {
+    // One recorded frame of hook calls, labelled by hand: what the pass graph
+    // is fed by OMSetRenderTargets/RSSetViewports/PSSetShaderResources/Draw/Clear.
+    enum class Op : uint8_t { Bind, Read, Draw, Clear, Viewport, Copy };
+
+    struct Event {
+        Op op;
+        uintptr_t a;          // Bind: first target index into the trace's target table; Read/Copy: key
+        uint32_t b;           // Bind: target count; Draw: count; Viewport: w; Copy: src key
+        uint32_t c;           // Viewport: h
+        PassClass expected;   // Bind only
+    };
+
+    struct Trace {
+        std::vector<Target> targets;
+        std::vector<Event> events;
+
+        void Bind(std::initializer_list<Target> t, PassClass expected) {
+            events.push_back({ Op::Bind, targets.size(), static_cast<uint32_t>(t.size()), 0, expected });
+            targets.insert(targets.end(), t.begin(), t.end());
+        }
+        void Read(uintptr_t key) { events.push_back({ Op::Read, key, 0, 0, PassClass::Unknown }); }
+        void Draw(uint32_t n) { events.push_back({ Op::Draw, 0, n, 0, PassClass::Unknown }); }
+        void Clear() { events.push_back({ Op::Clear, 0, 0, 0, PassClass::Unknown }); }
+        void Viewport(uint32_t w, uint32_t h) { events.push_back({ Op::Viewport, 0, w, h, PassClass::Unknown }); }
+        void Copy(uintptr_t dst, uintptr_t src) { events.push_back({ Op::Copy, dst, static_cast<uint32_t>(src), 0, PassClass::Unknown }); }
+    };
+
+    Target Color(uintptr_t key, uint32_t w, uint32_t h, uint32_t format = 10) { return Target{ key, w, h, format, false }; }
+    Target Depth(uintptr_t key, uint32_t w, uint32_t h) { return Target{ key, w, h, 40, true }; }
+
+    // A deferred VR frame: both eyes side by side in one scene target
+    Trace MakeFrame() {
+        constexpr uint32_t W = 4032, H = 2240;
+        Trace t;
+        // Shadow cascades: one depth atlas, four viewports
+        for (int i = 0; i < 4; ++i) {
+            t.Bind({ Depth(100, 4096, 4096) }, PassClass::Shadow);
+            t.Viewport(2048, 2048);
+            t.Draw(60);
+        }
+        // Depth prepass, then the G-buffer (3 MRTs + depth)
+        t.Bind({ Depth(10, W, H) }, PassClass::GBuffer);
+        t.Clear();
+        t.Viewport(W, H);
+        t.Draw(300);
+        t.Bind({ Color(11, W, H), Color(12, W, H, 24), Color(13, W, H, 28), Depth(10, W, H) }, PassClass::GBuffer);
+        t.Viewport(W, H);
+        t.Draw(900);
+        // Half-resolution AO from depth
+        t.Bind({ Color(20, W / 2, H / 2, 61) }, PassClass::Lighting);
+        t.Read(10);
+        t.Draw(1);
+        // Deferred lighting into the scene color target
+        t.Bind({ Color(30, W, H) }, PassClass::Lighting);
+        t.Read(11); t.Read(12); t.Read(13); t.Read(20); t.Read(100);
+        t.Draw(40);
+        // Forward transparencies and particles on top of the lit scene: no
+        // texture of this frame is sampled, but the lit target is drawn over
+        t.Bind({ Color(30, W, H), Depth(10, W, H) }, PassClass::Lighting);
+        t.Read(500);  // static texture, not written this frame
+        t.Draw(150);
+        // Bloom chain and tonemap
+        t.Bind({ Color(40, W / 4, H / 4) }, PassClass::Post);
+        t.Read(30);
+        t.Draw(1);
+        t.Bind({ Color(41, W / 8, H / 8) }, PassClass::Post);
+        t.Read(40);
+        t.Draw(1);
+        t.Bind({ Color(50, W, H, 28) }, PassClass::Post);
+        t.Read(30); t.Read(41);
+        t.Draw(1);
+        // Copy of the tonemapped image for the next frame's history
+        t.Copy(51, 50);
+        // Menus and Pip-Boy screen: own targets, cleared, no scene inputs
+        t.Bind({ Color(60, 1024, 1024, 28) }, PassClass::HUD);
+        t.Clear();
+        t.Draw(25);
+        t.Bind({ Color(61, 512, 512, 28) }, PassClass::HUD);
+        t.Clear();
+        t.Draw(12);
+        // A HUD target that reuses a pooled post texture: cleared first, so still HUD
+        t.Bind({ Color(40, W / 4, H / 4) }, PassClass::HUD);
+        t.Clear();
+        t.Draw(8);
+        return t;
+    }
+
+    // Replays one frame; returns the classes BeginPass reported (cached from earlier frames)
+    std::vector<PassClass> Replay(FrameGraph& g, const Trace& t) {
+        std::vector<PassClass> cached;
+        for (const Event& e : t.events) {
+            switch (e.op) {
+                case Op::Bind: cached.push_back(g.BeginPass(&t.targets[e.a], e.b)); break;
+                case Op::Read: g.NoteRead(e.a); break;
+                case Op::Draw: for (uint32_t i = 0; i < e.b; ++i) g.NoteDraw(); break;
+                case Op::Clear: g.NoteClear(); break;
+                case Op::Viewport: g.NoteViewport(e.b, e.c); break;
+                case Op::Copy: g.NoteCopy(e.a, e.b); break;
+            }
+        }
+        return cached;
+    }
+
+    std::vector<PassClass> Expected(const Trace& t) {
+        std::vector<PassClass> out;
+        for (const Event& e : t.events) {
+            if (e.op == Op::Bind) out.push_back(e.expected);
+        }
+        return out;
+    }
+
+    void TestTraceAccuracy() {
+        DLSSArena::FrameArena arena(64 * 1024);
+        FrameGraph g(arena);
+        const Trace trace = MakeFrame();
+        const std::vector<PassClass> expected = Expected(trace);
+        for (int frame = 0; frame < 3; ++frame) {
+            arena.Reset();
+            const std::vector<PassClass> cached = Replay(g, trace);
+            const FrameStats s = g.EndFrame();
+            CHECK(s.passes == expected.size());
+            const std::vector<Pass>& passes = g.PreviousFrame();
+            uint32_t correct = 0;
+            for (size_t i = 0; i < expected.size() && i < passes.size(); ++i) {
+                if (passes[i].cls == expected[i]) {
+                    ++correct;
+                } else {
+                    std::fprintf(stderr, "frame %d pass %zu: %s, expected %s\n", frame, i,
+                                 PassClassName(passes[i].cls), PassClassName(expected[i]));
+                }
+            }
+            CHECK(correct == expected.size());
+            if (frame == 0) {
+                CHECK(s.unmatched == expected.size());
+            } else {
+                // Later frames find every pass at its index, with last frame's class
+                CHECK(s.matchedByIndex == expected.size());
+                CHECK(cached == expected);
+            }
+        }
+    }
+
+    // Without a recognisable scene nothing is classified
+    void TestNoScene() {
+        DLSSArena::FrameArena arena(4096);
+        FrameGraph g(arena);
+        const Target hud = Color(1, 512, 512);
+        g.BeginPass(&hud, 1);
+        g.NoteDraw();
+        g.EndFrame();
+        CHECK(g.PreviousFrame().size() == 1);
+        CHECK(g.PreviousFrame()[0].cls == PassClass::Unknown);
+    }
+}
+
+int main() {
+    TestTraceAccuracy();
+    TestNoScene();
+    return DLSSTest::Result();
+}
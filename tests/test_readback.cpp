@@ -0,0 +1,240 @@
+#include "dlss_readback.h"
+#include "test_common.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+using namespace DLSSReadback;
+
+namespace {
+    // A fake GPU: each committed copy carries one value, and its fence
+    // passes 'lag' frames after the copy was issued
+    class FakeFence final : public Device {
+    public:
+        uint64_t now = 0;
+        uint64_t lag = 1;
+        bool mapFails = false;  // signalled, but Map would have to wait
+
+        void Issue(uint32_t stream, uint32_t slot, uint32_t value) {
+            m_signalAt[stream][slot] = now + lag;
+            m_payload[stream][slot] = value;
+        }
+
+        bool Signaled(uint32_t stream, uint32_t slot) override { return now >= m_signalAt[stream][slot]; }
+        bool Read(uint32_t stream, uint32_t slot, void* dst, uint32_t bytes) override {
+            if (mapFails || bytes < sizeof(uint32_t)) return false;
+            std::memcpy(dst, &m_payload[stream][slot], sizeof(uint32_t));
+            return true;
+        }
+
+    private:
+        uint64_t m_signalAt[kMaxStreams][kMaxSlots] = {};
+        uint32_t m_payload[kMaxStreams][kMaxSlots] = {};
+    };
+
+    struct Delivered {
+        std::vector<uint32_t> values;
+        std::vector<uint32_t> latencies;
+    };
+
+    void OnResult(void* user, const Result& r) {
+        Delivered* d = static_cast<Delivered*>(user);
+        uint32_t value;
+        std::memcpy(&value, r.data, sizeof(value));
+        CHECK(value == r.frame);  // the copy issued in that frame
+        d->values.push_back(value);
+        d->latencies.push_back(r.latency);
+    }
+
+    // One frame of the manager's pattern: collect, then copy into a free slot
+    void Frame(Ring& ring, FakeFence& gpu, uint32_t stream, uint64_t frame) {
+        gpu.now = frame;
+        ring.Collect(frame);
+        const int slot = ring.Acquire(stream, frame);
+        if (slot < 0) return;
+        gpu.Issue(stream, static_cast<uint32_t>(slot), static_cast<uint32_t>(frame));
+        ring.Commit(stream, slot);
+    }
+
+    void TestAddStream() {
+        FakeFence gpu;
+        Ring ring(gpu);
+        Delivered d;
+        CHECK(ring.AddStream("empty", 0, 3, OnResult, &d) == -1);
+        CHECK(ring.AddStream("big", kMaxBytes + 1, 3, OnResult, &d) == -1);
+        CHECK(ring.AddStream("slots", 4, kMaxSlots + 1, OnResult, &d) == -1);
+        CHECK(ring.AddStream("callback", 4, 3, nullptr, &d) == -1);
+        for (uint32_t i = 0; i < kMaxStreams; ++i) CHECK(ring.AddStream("probe", 4, 3, OnResult, &d) == static_cast<int>(i));
+        CHECK(ring.AddStream("full", 4, 3, OnResult, &d) == -1);
+        CHECK(ring.StreamCount() == kMaxStreams);
+        CHECK(ring.Acquire(kMaxStreams, 1) == -1);
+    }
+
+    // A GPU one frame behind: every copy arrives kMinLatency frames later, in order
+    void TestSteadyLatency() {
+        FakeFence gpu;
+        Ring ring(gpu);
+        Delivered d;
+        const uint32_t s = static_cast<uint32_t>(ring.AddStream("probe", 4, 3, OnResult, &d));
+        for (uint64_t f = 1; f <= 20; ++f) Frame(ring, gpu, s, f);
+        CHECK(d.values.size() == 20 - kMinLatency);
+        for (size_t i = 0; i < d.values.size(); ++i) {
+            CHECK(d.values[i] == i + 1);
+            CHECK(d.latencies[i] == kMinLatency);
+        }
+        const StreamStats st = ring.GetStats(s);
+        CHECK(st.issued == 20 && st.delivered == d.values.size() && st.skipped == 0 && st.stale == 0);
+        CHECK(st.inFlight == kMinLatency);
+    }
+
+    // A GPU five frames behind: the ring fills and frames are skipped, but
+    // Collect never waits and results stay in issue order
+    void TestSlowGpu() {
+        FakeFence gpu;
+        gpu.lag = 5;
+        Ring ring(gpu);
+        Delivered d;
+        const uint32_t s = static_cast<uint32_t>(ring.AddStream("probe", 4, 3, OnResult, &d));
+        for (uint64_t f = 1; f <= 60; ++f) Frame(ring, gpu, s, f);
+        const StreamStats st = ring.GetStats(s);
+        CHECK(st.skipped > 0);
+        CHECK(st.issued == st.delivered + st.inFlight);
+        CHECK(!d.values.empty());
+        CHECK(std::is_sorted(d.values.begin(), d.values.end()));
+        CHECK(std::adjacent_find(d.values.begin(), d.values.end()) == d.values.end());
+        for (uint32_t latency : d.latencies) CHECK(latency >= gpu.lag);
+    }
+
+    // A fence that never passes, or a copy that cannot be mapped, is dropped
+    // after kStaleFrames and frees its slot
+    void TestStale() {
+        FakeFence gpu;
+        gpu.lag = 1000;
+        Ring ring(gpu);
+        Delivered d;
+        const uint32_t s = static_cast<uint32_t>(ring.AddStream("probe", 4, 3, OnResult, &d));
+        for (uint64_t f = 1; f <= kStaleFrames + 4; ++f) Frame(ring, gpu, s, f);
+        CHECK(d.values.empty());
+        CHECK(ring.GetStats(s).stale >= 1);
+
+        ring.Reset(s);
+        CHECK(ring.GetStats(s).inFlight == 0);
+        gpu.lag = 0;
+        gpu.mapFails = true;
+        gpu.now = 200;
+        const int slot = ring.Acquire(s, 200);
+        CHECK(slot >= 0);
+        gpu.Issue(s, static_cast<uint32_t>(slot), 200);
+        ring.Commit(s, slot);
+        const uint64_t stale = ring.GetStats(s).stale;
+        ring.Collect(200 + kMinLatency + 1);
+        CHECK(ring.GetStats(s).inFlight == 1);  // signalled but unmappable: wait
+        ring.Collect(200 + kStaleFrames);
+        CHECK(ring.GetStats(s).stale == stale + 1 && ring.GetStats(s).inFlight == 0);
+        CHECK(d.values.empty());
+
+        // A cancelled slot is never committed
+        gpu.mapFails = false;
+        const int cancelled = ring.Acquire(s, 300);
+        ring.Cancel(s, cancelled);
+        ring.Commit(s, cancelled);
+        CHECK(ring.GetStats(s).inFlight == 0);
+    }
+
+    void TestIsFinite() {
+        CHECK(IsFinite(0.0f) && IsFinite(-0.0f) && IsFinite(1.0f));
+        CHECK(IsFinite(std::numeric_limits<float>::max()) && IsFinite(-std::numeric_limits<float>::max()));
+        CHECK(IsFinite(std::numeric_limits<float>::denorm_min()));
+        CHECK(!IsFinite(std::numeric_limits<float>::infinity()) && !IsFinite(-std::numeric_limits<float>::infinity()));
+        CHECK(!IsFinite(std::numeric_limits<float>::quiet_NaN()) && !IsFinite(-std::numeric_limits<float>::quiet_NaN()));
+    }
+
+    // The GPU partials, reduced on the CPU, match a direct pass over the samples
+    void TestProbeReduction() {
+        constexpr uint32_t W = 300, H = 170;
+        std::vector<float> tex(W * H * 4);
+        for (uint32_t i = 0; i < W * H; ++i) {
+            tex[i * 4 + 0] = static_cast<float>(i % 97) * 0.5f - 3.0f;
+            tex[i * 4 + 1] = static_cast<float>(i % 13);
+            tex[i * 4 + 2] = 1.0f;
+            tex[i * 4 + 3] = 1.0f;
+        }
+        tex[(ProbeSampleCoord(3, H) * W + ProbeSampleCoord(9, W)) * 4] = std::numeric_limits<float>::quiet_NaN();
+        tex[(ProbeSampleCoord(40, H) * W + ProbeSampleCoord(2, W)) * 4] = -std::numeric_limits<float>::infinity();
+
+        ProbeParams p{};
+        p.size[0] = W;
+        p.size[1] = H;
+        p.channel = static_cast<uint32_t>(Channel::Red);
+        uint32_t partials[kProbeGroupCount * 4];
+        BuildProbePartials(tex.data(), W, p, partials);
+        const ProbeStats st = ReduceProbe(partials, kProbeBytes);
+
+        double mn = 1e9, mx = -1e9, sum = 0.0;
+        uint32_t finite = 0, bad = 0;
+        for (uint32_t y = 0; y < kProbeGrid; ++y) {
+            for (uint32_t x = 0; x < kProbeGrid; ++x) {
+                const float v = tex[(ProbeSampleCoord(y, H) * W + ProbeSampleCoord(x, W)) * 4];
+                if (!IsFinite(v)) { ++bad; continue; }
+                mn = std::min(mn, static_cast<double>(v));
+                mx = std::max(mx, static_cast<double>(v));
+                sum += v;
+                ++finite;
+            }
+        }
+        CHECK(bad == 2 && st.nonFinite == bad);
+        CHECK(st.samples == finite && st.samples + st.nonFinite == kProbeGrid * kProbeGrid);
+        CHECK(st.minValue == static_cast<float>(mn) && st.maxValue == static_cast<float>(mx));
+        CHECK_NEAR(st.mean, sum / finite, 1e-3);
+
+        // Right half, motion-vector length
+        p.origin[0] = W / 2;
+        p.size[0] = W / 2;
+        p.channel = static_cast<uint32_t>(Channel::Length);
+        BuildProbePartials(tex.data(), W, p, partials);
+        const ProbeStats half = ReduceProbe(partials, kProbeBytes);
+        CHECK(half.samples == kProbeGrid * kProbeGrid && half.minValue >= 0.0f);
+        CHECK(ReduceProbe(partials, 10).samples == 0);
+    }
+
+    // The mean is over the finite samples that were summed: non-finite
+    // samples and groups whose float sum overflowed do not dilute it
+    void TestProbeMean() {
+        uint32_t partials[kProbeGroupCount * 4];
+        auto setGroup = [&partials](uint32_t g, float mn, float mx, float sum, uint32_t bad) {
+            std::memcpy(&partials[g * 4 + 0], &mn, sizeof(float));
+            std::memcpy(&partials[g * 4 + 1], &mx, sizeof(float));
+            std::memcpy(&partials[g * 4 + 2], &sum, sizeof(float));
+            partials[g * 4 + 3] = bad;
+        };
+        constexpr uint32_t kGroupSamples = kProbeGroupSize * kProbeGroupSize;
+        for (uint32_t g = 0; g < kProbeGroupCount; ++g) setGroup(g, 3.4e38f, -3.4e38f, 0.0f, kGroupSamples);
+        // 48 samples of 2.0 and 16 NaNs
+        setGroup(0, 2.0f, 2.0f, 96.0f, 16);
+        // 64 samples near the float maximum: their sum is +Inf
+        setGroup(1, 3.0e38f, 3.0e38f, std::numeric_limits<float>::infinity(), 0);
+        const ProbeStats st = ReduceProbe(partials, kProbeBytes);
+        CHECK(st.samples == 48 + kGroupSamples);
+        CHECK(st.nonFinite == 16 + (kProbeGroupCount - 2) * kGroupSamples);
+        CHECK(st.minValue == 2.0f && st.maxValue == 3.0e38f);
+        CHECK(st.mean == 2.0f);
+
+        // Nothing finite: no mean
+        setGroup(0, 3.4e38f, -3.4e38f, 0.0f, kGroupSamples);
+        setGroup(1, 3.4e38f, -3.4e38f, 0.0f, kGroupSamples);
+        const ProbeStats none = ReduceProbe(partials, kProbeBytes);
+        CHECK(none.samples == 0 && none.mean == 0.0f && none.nonFinite == kProbeGrid * kProbeGrid);
+    }
+}
+
+int main() {
+    TestAddStream();
+    TestSteadyLatency();
+    TestSlowGpu();
+    TestStale();
+    TestIsFinite();
+    TestProbeReduction();
+    TestProbeMean();
+    return DLSSTest::Result();
+}
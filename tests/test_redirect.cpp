@@ -0,0 +1,154 @@
+#include "dlss_redirect.h"
+#include "test_common.h"
+
+using namespace DLSSRedirect;
+
+namespace {
+    constexpr uint32_t kSceneW = 2016, kSceneH = 2240;
+    constexpr uint32_t kSmallW = 1344, kSmallH = 1494;
+
+    Slot MakeSlot(uintptr_t key, Kind kind, uint32_t w = kSceneW, uint32_t h = kSceneH) {
+        Slot s;
+        s.key = key;
+        s.kind = kind;
+        s.width = w;
+        s.height = h;
+        return s;
+    }
+
+    void TestDepthComposite() {
+        DLSSArena::FrameArena arena(4096);
+        BindingTable table(arena);
+        table.BeginFrame();
+        Action actions[kMaxSlots];
+
+        // Color + depth redirected together
+        Slot slots[2] = { MakeSlot(1, Kind::Color), MakeSlot(2, Kind::Depth) };
+        CHECK(table.ResolveBind(slots, 2, kSceneW, kSceneH, kSmallW, kSmallH, true, actions));
+        CHECK(actions[0] == Action::Redirect && actions[1] == Action::Redirect);
+
+        // A full-size pass reusing the depth target: it is composited back, then native
+        Slot later[2] = { MakeSlot(3, Kind::Color, 1024, 1024), MakeSlot(2, Kind::Depth) };
+        CHECK(!table.ResolveBind(later, 2, kSceneW, kSceneH, kSmallW, kSmallH, true, actions));
+        CHECK(actions[0] == Action::Native);
+        CHECK(actions[1] == Action::CompositeThenNative);
+        CHECK(table.IsNative(2));
+        CHECK(table.Stats().composites == 1);
+
+        // Only once per frame
+        CHECK(!table.ResolveBind(later, 2, kSceneW, kSceneH, kSmallW, kSmallH, true, actions));
+        CHECK(actions[1] == Action::Native);
+
+        // A view the hooks cannot redirect (another mip/slice) arrives with size 0
+        Slot slice = MakeSlot(1, Kind::Color, 0, 0);
+        CHECK(!table.ResolveBind(&slice, 1, kSceneW, kSceneH, kSmallW, kSmallH, true, actions));
+        CHECK(actions[0] == Action::CompositeThenNative);
+        CHECK(table.Stats().composites == 2);
+    }
+
+    // MaterializeBig (copy source, SRV bind): the twin was composited, the
+    // resource stays native for the frame and later binds do not composite again
+    void TestMaterialize() {
+        DLSSArena::FrameArena arena(4096);
+        BindingTable table(arena);
+        table.BeginFrame();
+        Action actions[kMaxSlots];
+        Slot slots[2] = { MakeSlot(1, Kind::Color), MakeSlot(2, Kind::Depth) };
+        CHECK(table.ResolveBind(slots, 2, kSceneW, kSceneH, kSmallW, kSmallH, true, actions));
+        table.NoteComposite();
+        table.MarkNative(2);
+        CHECK(table.IsNative(2) && !table.IsRedirected(2));
+        CHECK(!table.ResolveBind(slots, 2, kSceneW, kSceneH, kSmallW, kSmallH, true, actions));
+        CHECK(actions[0] == Action::CompositeThenNative);
+        CHECK(actions[1] == Action::Native);
+        CHECK(table.Stats().composites == 2);
+
+        CHECK(BytesSaved(100, 40) == 60);
+        CHECK(BytesSaved(40, 100) == 0);
+    }
+
+    void TestDepthTwinFormats() {
+        // Typeless and D* formats of one family map to the same twin
+        for (uint32_t f : { 19u, 20u }) {
+            const DepthTwinFormats t = GetDepthTwinFormats(f);
+            CHECK(t.texture == 19 && t.depthView == 21 && t.stencilView == 22);
+        }
+        for (uint32_t f : { 44u, 45u }) {
+            const DepthTwinFormats t = GetDepthTwinFormats(f);
+            CHECK(t.texture == 44 && t.depthView == 46 && t.stencilView == 47);
+        }
+        for (uint32_t f : { 39u, 40u }) {
+            const DepthTwinFormats t = GetDepthTwinFormats(f);
+            CHECK(t.texture == 39 && t.depthView == 41 && t.stencilView == 0);
+        }
+        for (uint32_t f : { 53u, 55u }) {
+            const DepthTwinFormats t = GetDepthTwinFormats(f);
+            CHECK(t.texture == 53 && t.depthView == 56 && t.stencilView == 0);
+        }
+        // Color formats are not depth twins
+        CHECK(GetDepthTwinFormats(28).texture == 0);   // R8G8B8A8_UNORM
+        CHECK(GetDepthTwinFormats(41).texture == 0);   // R32_FLOAT
+        CHECK(GetDepthTwinFormats(0).texture == 0);
+    }
+
+    void TestCompositeSourceTexel() {
+        // Ends of the big target map to the ends of the twin
+        CHECK(CompositeSourceTexel(0, kSmallW, kSceneW) == 0);
+        CHECK(CompositeSourceTexel(kSceneW - 1, kSmallW, kSceneW) == kSmallW - 1);
+        CHECK(CompositeSourceTexel(kSceneH - 1, kSmallH, kSceneH) == kSmallH - 1);
+        // Monotonic, every texel in range, and every twin texel used
+        uint32_t prev = 0, used = 0;
+        for (uint32_t x = 0; x < kSceneW; ++x) {
+            const uint32_t t = CompositeSourceTexel(x, kSmallW, kSceneW);
+            CHECK(t < kSmallW);
+            CHECK(t >= prev);
+            if (x == 0 || t != prev) ++used;
+            prev = t;
+        }
+        CHECK(used == kSmallW);
+        // Equal sizes copy texel for texel
+        for (uint32_t x = 0; x < 64; ++x) CHECK(CompositeSourceTexel(x, 64, 64) == x);
+        CHECK(CompositeSourceTexel(5, 0, 64) == 0);
+        CHECK(CompositeSourceTexel(5, 64, 0) == 0);
+    }
+
+    void TestScaleScissor() {
+        Rect full;
+        full.right = kSceneW;
+        full.bottom = kSceneH;
+        const Rect s = ScaleScissor(full, kSceneW, kSceneH, kSmallW, kSmallH);
+        CHECK(s.left == 0 && s.top == 0 && s.right == (int32_t)kSmallW && s.bottom == (int32_t)kSmallH);
+
+        // Edges round outwards: the scaled rect covers every twin pixel the big rect touches
+        Rect r;
+        r.left = 101; r.top = 77; r.right = 1003; r.bottom = 1999;
+        const Rect t = ScaleScissor(r, kSceneW, kSceneH, kSmallW, kSmallH);
+        CHECK(t.left == 67);      // floor(101 * 2/3)
+        CHECK(t.right == 669);    // ceil(1003 * 2/3)
+        CHECK(t.left * (int64_t)kSceneW <= r.left * (int64_t)kSmallW);
+        CHECK(t.right * (int64_t)kSceneW >= r.right * (int64_t)kSmallW);
+        CHECK(t.top * (int64_t)kSceneH <= r.top * (int64_t)kSmallH);
+        CHECK(t.bottom * (int64_t)kSceneH >= r.bottom * (int64_t)kSmallH);
+
+        // Negative (off-target) edges round outwards too
+        Rect n;
+        n.left = -5; n.top = -1; n.right = 10; n.bottom = 10;
+        const Rect u = ScaleScissor(n, 3, 3, 2, 2);
+        CHECK(u.left == -4 && u.top == -1 && u.right == 7 && u.bottom == 7);
+
+        // Equal sizes and unknown scene sizes leave the rect alone
+        const Rect same = ScaleScissor(r, kSceneW, kSceneH, kSceneW, kSceneH);
+        CHECK(same.left == r.left && same.top == r.top && same.right == r.right && same.bottom == r.bottom);
+        const Rect unknown = ScaleScissor(r, 0, 0, kSmallW, kSmallH);
+        CHECK(unknown.left == r.left && unknown.right == r.right);
+    }
+}
+
+int main() {
+    TestDepthComposite();
+    TestMaterialize();
+    TestDepthTwinFormats();
+    TestCompositeSourceTexel();
+    TestScaleScissor();
+    return DLSSTest::Result();
+}
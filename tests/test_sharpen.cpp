@@ -0,0 +1,114 @@
+#include "dlss_sharpen.h"
+#include "test_common.h"
+
+#include <vector>
+
+using namespace DLSSSharpen;
+
+namespace {
+    struct Size { uint32_t w, h; };
+
+    // Deterministic noise with flat patches, values in [0, 1]
+    std::vector<float> MakeImage(uint32_t w, uint32_t h, uint32_t seed) {
+        std::vector<float> img(static_cast<size_t>(w) * h * 4);
+        uint32_t state = seed;
+        for (uint32_t y = 0; y < h; ++y) {
+            for (uint32_t x = 0; x < w; ++x) {
+                float* t = &img[(static_cast<size_t>(y) * w + x) * 4];
+                for (int ch = 0; ch < 4; ++ch) {
+                    state = state * 1664525u + 1013904223u;
+                    const float noise = static_cast<float>(state >> 8) / 16777216.0f;
+                    t[ch] = ((x / 5 + y / 7) % 3 == 0) ? 0.5f : noise;
+                }
+            }
+        }
+        return img;
+    }
+
+    std::vector<float> Crop(const std::vector<float>& img, uint32_t w, uint32_t x0, uint32_t y0, uint32_t cw, uint32_t ch) {
+        std::vector<float> out(static_cast<size_t>(cw) * ch * 4);
+        for (uint32_t y = 0; y < ch; ++y) {
+            for (uint32_t x = 0; x < cw * 4; ++x) {
+                out[static_cast<size_t>(y) * cw * 4 + x] = img[(static_cast<size_t>(y0) + y) * w * 4 + x0 * 4 + x];
+            }
+        }
+        return out;
+    }
+
+    float MaxDiff(const std::vector<float>& a, const std::vector<float>& b) {
+        float worst = a.size() == b.size() ? 0.0f : 1e30f;
+        for (size_t i = 0; i < a.size() && i < b.size(); ++i) worst = std::fmax(worst, std::fabs(a[i] - b[i]));
+        return worst;
+    }
+
+    // The shader, run group by group over a whole eye (partial groups
+    // included), matches the CPU reference and the SSE version
+    void TestShaderMatchesReference() {
+        for (const Size s : { Size{ 67, 45 }, Size{ 64, 64 }, Size{ 1, 9 }, Size{ 9, 1 } }) {
+            for (float sharpness : { 0.0f, 0.5f, 1.0f }) {
+                const std::vector<float> src = MakeImage(s.w, s.h, s.w * 131 + s.h);
+                std::vector<float> reference(src.size()), shader(src.size(), -1.0f);
+                Sharpen(src.data(), s.w, s.h, sharpness, reference.data());
+                SimulateDispatch(src.data(), s.w, s.h, 0, 0, s.w, s.h, sharpness, shader.data());
+                CHECK_NEAR(MaxDiff(reference, shader), 0.0, 1e-6);
+#if DLSS_SHARPEN_SSE
+                std::vector<float> sse(src.size());
+                SharpenSSE(src.data(), s.w, s.h, sharpness, sse.data());
+                CHECK_NEAR(MaxDiff(sse, shader), 0.0, 1e-6);
+#endif
+            }
+        }
+    }
+
+    // An atlas eye is sharpened as if it were alone: reads clamp to the
+    // region and nothing outside it is written
+    void TestAtlasRegion() {
+        constexpr uint32_t W = 150, H = 70;
+        constexpr uint32_t X0 = 80, Y0 = 3, RW = 61, RH = 59;
+        const std::vector<float> src = MakeImage(W, H, 7);
+        std::vector<float> dst(src.size(), -1.0f);
+        SimulateDispatch(src.data(), W, H, X0, Y0, RW, RH, 0.8f, dst.data());
+
+        const std::vector<float> eye = Crop(src, W, X0, Y0, RW, RH);
+        std::vector<float> reference(eye.size());
+        Sharpen(eye.data(), RW, RH, 0.8f, reference.data());
+        CHECK_NEAR(MaxDiff(Crop(dst, W, X0, Y0, RW, RH), reference), 0.0, 1e-6);
+
+        uint32_t outside = 0;
+        for (uint32_t y = 0; y < H; ++y) {
+            for (uint32_t x = 0; x < W; ++x) {
+                const bool inside = x >= X0 && x < X0 + RW && y >= Y0 && y < Y0 + RH;
+                if (!inside && dst[(static_cast<size_t>(y) * W + x) * 4] != -1.0f) ++outside;
+            }
+        }
+        CHECK(outside == 0);
+    }
+
+    // Flat images pass unchanged, alpha is kept, results never go negative
+    void TestFlatAndAlpha() {
+        constexpr uint32_t W = 20, H = 13;
+        std::vector<float> flat(static_cast<size_t>(W) * H * 4, 0.25f);
+        std::vector<float> out(flat.size());
+        Sharpen(flat.data(), W, H, 1.0f, out.data());
+        CHECK_NEAR(MaxDiff(flat, out), 0.0, 1e-6);
+
+        const std::vector<float> src = MakeImage(W, H, 3);
+        Sharpen(src.data(), W, H, 1.0f, out.data());
+        bool alphaKept = true, nonNegative = true;
+        for (size_t i = 0; i < out.size(); ++i) {
+            if (i % 4 == 3 && out[i] != src[i]) alphaKept = false;
+            if (out[i] < 0.0f) nonNegative = false;
+        }
+        CHECK(alphaKept);
+        CHECK(nonNegative);
+        CHECK(Peak(-1.0f) == Peak(0.0f) && Peak(2.0f) == Peak(1.0f));
+        CHECK(GroupCount(1344) == 168 && GroupCount(1345) == 169);
+    }
+}
+
+int main() {
+    TestShaderMatchesReference();
+    TestAtlasRegion();
+    TestFlatAndAlpha();
+    return DLSSTest::Result();
+}
@@ -0,0 +1,204 @@
+#include "dlss_tagging.h"
+#include "test_common.h"
+
+using namespace DLSSTagging;
+
+namespace {
+    // DXGI formats whose typed UAV stores D3D11 requires at feature level 11_0
+    bool RequiredStore(uint32_t f) {
+        return f == 2 || f == 10 || f == 11 || f == 24 || f == 26 || f == 28;
+    }
+
+    bool IsTypeless(uint32_t f) {
+        return f == 1 || f == 9 || f == 23 || f == 27 || f == 90 || f == 92;
+    }
+
+    // Copy-compatible: the same DXGI typeless family
+    uint32_t Family(uint32_t f) {
+        if (f >= 1 && f <= 4) return 1;
+        if (f >= 9 && f <= 14) return 9;
+        if (f >= 23 && f <= 25) return 23;
+        if (f >= 27 && f <= 32) return 27;
+        if (f == 87 || f == 90 || f == 91) return 90;
+        if (f == 88 || f == 92 || f == 93) return 92;
+        return f;
+    }
+
+    const DeviceCaps kCapsList[2] = { DeviceCaps{ false }, DeviceCaps{ true } };
+
+    bool CanStore(uint32_t f, const DeviceCaps& device) {
+        return RequiredStore(f) || (device.bgraTypedStore && f == 87);
+    }
+
+    // Every DXGI_FORMAT value: the table only offers typed, same-size views
+    // and only claims typed stores the device has
+    void TestFormatTable() {
+        uint32_t colorFormats = 0;
+        for (uint32_t f = 0; f < 256; ++f) {
+            for (const DeviceCaps& device : kCapsList) {
+                const FormatCaps c = GetFormatCaps(f, device);
+                if (c.view == 0) {
+                    CHECK(!c.store && c.storeAs == 0);
+                    continue;
+                }
+                if (device.bgraTypedStore) ++colorFormats;
+                CHECK(!IsTypeless(c.view));
+                CHECK(Family(c.view) == Family(f));
+                CHECK(DLSSVram::SurfaceBytes(c.view, 7, 5) == DLSSVram::SurfaceBytes(f, 7, 5));
+                if (c.store) CHECK(CanStore(c.view, device));
+                if (c.storeAs) {
+                    CHECK(CanStore(c.storeAs, device));
+                    CHECK(Family(c.storeAs) == Family(f));
+                }
+                // Output textures the plugin creates can always take stores
+                const uint32_t out = OutputFormat(f, device);
+                const FormatCaps oc = GetFormatCaps(out, device);
+                CHECK(DLSSVram::SurfaceBytes(out, 7, 5) == DLSSVram::SurfaceBytes(f, 7, 5));
+                if (c.store || c.storeAs) CHECK(oc.store || oc.storeAs);
+            }
+        }
+        CHECK(colorFormats == 18);
+
+        // B8G8R8A8 stores depend on the device
+        CHECK(GetFormatCaps(87, kCapsList[1]).store && !GetFormatCaps(87, kCapsList[0]).store);
+        CHECK(GetFormatCaps(91, kCapsList[1]).storeAs == 87 && GetFormatCaps(91, kCapsList[0]).storeAs == 0);
+        CHECK(OutputFormat(87, kCapsList[0]) == 28 && OutputFormat(90, kCapsList[0]) == 27 && OutputFormat(91, kCapsList[0]) == 29);
+        CHECK(OutputFormat(87, kCapsList[1]) == 87 && OutputFormat(10, kCapsList[0]) == 10);
+    }
+
+    // Every format, role, usage, bind combination and sample count: a
+    // decision is consistent with the format table and the texture
+    void TestDecisions() {
+        const uint32_t usages[] = { Usage::Default, Usage::Immutable, Usage::Dynamic, Usage::Staging };
+        const uint32_t binds[] = { 0, Bind::ShaderResource, Bind::RenderTarget, Bind::UnorderedAccess,
+                                   Bind::ShaderResource | Bind::RenderTarget | Bind::UnorderedAccess };
+        for (uint32_t f = 0; f < 192; ++f) {
+            for (const DeviceCaps& device : kCapsList) {
+                const FormatCaps caps = GetFormatCaps(f, device);
+                for (uint32_t usage : usages) {
+                    for (uint32_t bind : binds) {
+                        for (uint32_t samples : { 1u, 4u }) {
+                            for (Role role : { Role::Input, Role::Output }) {
+                                TextureInfo tex;
+                                tex.format = f;
+                                tex.width = 200;
+                                tex.height = 100;
+                                tex.sampleCount = samples;
+                                tex.usage = usage;
+                                tex.bindFlags = bind;
+                                const Decision d = Analyze(tex, role, Rect{ 10, 20, 150, 70 }, device);
+                                if (caps.view == 0) {
+                                    CHECK(d.action == Action::Unsupported);
+                                    continue;
+                                }
+                                switch (d.action) {
+                                    case Action::Direct:
+                                        CHECK(samples == 1 && d.bytesPerFrame == 0);
+                                        CHECK((d.extent == Rect{ 10, 20, 150, 70 }));
+                                        if (role == Role::Input) CHECK((bind & Bind::ShaderResource) && usage != Usage::Staging);
+                                        else CHECK(caps.store && usage == Usage::Default && (bind & Bind::UnorderedAccess));
+                                        break;
+                                    case Action::Copy:
+                                        CHECK(samples == 1);
+                                        CHECK(d.scratchWidth == 150 && d.scratchHeight == 70);
+                                        CHECK((d.extent == Rect{ 0, 0, 150, 70 }));
+                                        CHECK(d.bytesPerFrame == DLSSVram::SurfaceBytes(d.scratchFormat, 150, 70));
+                                        CHECK(Family(d.scratchFormat) == Family(f));
+                                        if (role == Role::Output) CHECK(CanStore(d.scratchFormat, device));
+                                        break;
+                                    case Action::Resolve:
+                                        CHECK(role == Role::Input && samples > 1);
+                                        CHECK(d.scratchWidth == 200 && d.scratchHeight == 100);
+                                        break;
+                                    case Action::Unsupported:
+                                        CHECK(role == Role::Output);
+                                        CHECK(samples > 1 || usage == Usage::Dynamic || usage == Usage::Immutable || caps.storeAs == 0);
+                                        break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // A B8G8R8A8 output without typed stores is never written directly
+        TextureInfo bgra;
+        bgra.format = 87;
+        bgra.width = bgra.height = 64;
+        bgra.bindFlags = Bind::UnorderedAccess | Bind::ShaderResource;
+        CHECK(Analyze(bgra, Role::Output, Rect{}, kCapsList[1]).action == Action::Direct);
+        CHECK(Analyze(bgra, Role::Output, Rect{}, kCapsList[0]).action == Action::Unsupported);
+        bgra.format = OutputFormat(87, kCapsList[0]);
+        CHECK(Analyze(bgra, Role::Output, Rect{}, kCapsList[0]).action == Action::Direct);
+    }
+
+    void TestClipRect() {
+        TextureInfo tex;
+        tex.width = 100;
+        tex.height = 50;
+        CHECK((ClipRect(tex, Rect{}) == Rect{ 0, 0, 100, 50 }));
+        CHECK((ClipRect(tex, Rect{ 90, 40, 20, 20 }) == Rect{ 90, 40, 10, 10 }));
+        CHECK((ClipRect(tex, Rect{ 100, 0, 5, 5 }) == Rect{}));
+    }
+
+    void TestCache() {
+        DecisionCache cache;
+        TextureInfo tex;
+        tex.format = 87;
+        tex.width = tex.height = 64;
+        tex.bindFlags = Bind::UnorderedAccess;
+        const void* key = &tex;
+        bool analyzed = false;
+        CHECK(cache.Get(key, tex, Role::Output, Rect{}, &analyzed).action == Action::Unsupported && analyzed);
+        CHECK(cache.Get(key, tex, Role::Output, Rect{}, &analyzed).action == Action::Unsupported && !analyzed);
+        CHECK(cache.Hits() == 1 && cache.Misses() == 1);
+        // New device caps drop the cached decisions
+        cache.SetDeviceCaps(kCapsList[1]);
+        CHECK(cache.Get(key, tex, Role::Output, Rect{}, &analyzed).action == Action::Direct && analyzed);
+        cache.SetDeviceCaps(kCapsList[1]);
+        cache.Get(key, tex, Role::Output, Rect{}, &analyzed);
+        CHECK(!analyzed);
+        // A changed description or role misses
+        tex.width = 32;
+        cache.Get(key, tex, Role::Output, Rect{}, &analyzed);
+        CHECK(analyzed);
+        cache.Get(key, tex, Role::Input, Rect{}, &analyzed);
+        CHECK(analyzed);
+        // Least recently used entries are replaced
+        uintptr_t keys[DecisionCache::kEntries + 1];
+        for (int i = 0; i <= DecisionCache::kEntries; ++i) cache.Get(&keys[i], tex, Role::Input, Rect{});
+        cache.Get(&keys[DecisionCache::kEntries], tex, Role::Input, Rect{}, &analyzed);
+        CHECK(!analyzed);
+        cache.Get(&keys[0], tex, Role::Input, Rect{}, &analyzed);
+        CHECK(analyzed);
+    }
+
+    // Persistent tag slots: only a changed texture, serial or size rebuilds
+    void TestSlotKeys() {
+        int a = 0, b = 0;
+        SlotKey slot;
+        CHECK(UpdateSlot(slot, SlotKey{ &a, 1, 1344, 1494 }));
+        CHECK(!UpdateSlot(slot, SlotKey{ &a, 1, 1344, 1494 }));
+        CHECK(UpdateSlot(slot, SlotKey{ &a, 1, 1344, 1400 }));
+        CHECK(UpdateSlot(slot, SlotKey{ &b, 2, 1344, 1400 }));
+        CHECK(!UpdateSlot(slot, SlotKey{ &b, 2, 1344, 1400 }));
+        // ABA: the texture is released and a new one lands at its address
+        CHECK(UpdateSlot(slot, SlotKey{ &b, 3, 1344, 1400 }));
+        CHECK(slot.serial == 3);
+        CHECK(!UpdateSlot(slot, SlotKey{ &b, 3, 1344, 1400 }));
+        // An unbound slot (no depth or motion vectors) is built once, then stays clean
+        SlotKey empty;
+        CHECK(UpdateSlot(empty, SlotKey{ nullptr, 0, 1344, 1494 }));
+        CHECK(!UpdateSlot(empty, SlotKey{ nullptr, 0, 1344, 1494 }));
+    }
+}
+
+int main() {
+    TestFormatTable();
+    TestDecisions();
+    TestClipRect();
+    TestCache();
+    TestSlotKeys();
+    return DLSSTest::Result();
+}
@@ -0,0 +1,135 @@
+#include "dlss_telemetry.h"
+#include "test_common.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace DLSSTelemetry;
+
+namespace {
+    // Every word of the payload derives from the frame number, so a copy
+    // mixing two publishes is detectable anywhere in the block
+    void Fill(Payload& p, uint64_t n) {
+        uint32_t words[kPayloadWords];
+        for (size_t i = 0; i < kPayloadWords; ++i) words[i] = static_cast<uint32_t>(n * 2654435761u) ^ static_cast<uint32_t>(i * 0x9E3779B9u);
+        std::memcpy(&p, words, sizeof(Payload));
+        p.frame = n;
+    }
+
+    bool Consistent(const Payload& p) {
+        Payload expected;
+        Fill(expected, p.frame);
+        return std::memcmp(&expected, &p, sizeof(Payload)) == 0;
+    }
+
+    void TestRoundTrip() {
+        std::unique_ptr<SharedBlock> block(new SharedBlock);
+        Payload p{};
+        CHECK(!IsCompatible(*block) || block->magic.load() != kMagic);
+        InitBlock(*block, 1234);
+        CHECK(IsCompatible(*block));
+        CHECK(block->writerPid == 1234);
+        Fill(p, 42);
+        Publish(*block, p);
+        Payload out{};
+        CHECK(TryRead(*block, out));
+        CHECK(out.frame == 42 && Consistent(out));
+        CHECK(block->sequence.load() == 2);
+
+        // Mid-write (odd sequence): the reader retries
+        block->sequence.store(3);
+        CHECK(!TryRead(*block, out));
+        CHECK(!Read(*block, out, 4));
+        block->sequence.store(4);
+        CHECK(Read(*block, out));
+
+        // Another version or payload size is refused
+        block->version = kVersion + 1;
+        CHECK(!TryRead(*block, out));
+        block->version = kVersion;
+        block->payloadSize = sizeof(Payload) - 4;
+        CHECK(!TryRead(*block, out));
+        block->payloadSize = sizeof(Payload);
+        CHECK(TryRead(*block, out));
+    }
+
+    // One writer publishing as fast as it can, one reader copying: every
+    // successful read is a whole frame and frames never go backwards
+    void TestTornReads() {
+        std::unique_ptr<SharedBlock> block(new SharedBlock);
+        InitBlock(*block, 1);
+        Payload first;
+        Fill(first, 1);
+        Publish(*block, first);
+
+        constexpr uint64_t kFrames = 300000;
+        std::atomic<bool> done{false};
+        std::thread writer([&]() {
+            Payload p;
+            for (uint64_t n = 2; n <= kFrames; ++n) {
+                Fill(p, n);
+                Publish(*block, p);
+                if ((n & 1023) == 0) std::this_thread::yield();
+            }
+            done.store(true, std::memory_order_release);
+        });
+
+        uint64_t reads = 0, torn = 0, backwards = 0, last = 0;
+        for (;;) {
+            const bool finished = done.load(std::memory_order_acquire);
+            Payload p;
+            if (TryRead(*block, p)) {
+                ++reads;
+                if (!Consistent(p)) ++torn;
+                if (p.frame < last) ++backwards;
+                last = p.frame;
+            } else {
+                std::this_thread::yield();
+            }
+            if (finished) break;
+        }
+        writer.join();
+        CHECK(reads > 0);
+        CHECK(torn == 0);
+        CHECK(backwards == 0);
+        Payload final;
+        CHECK(Read(*block, final) && final.frame == kFrames);
+    }
+
+    // The named mapping: a reader sees what the writer publishes
+    void TestChannel() {
+#ifdef _WIN32
+        const std::string name = "Local\\F4SEVR_DLSS_TelemetryTest_" + std::to_string(getpid());
+#else
+        const std::string name = "/f4sevr_dlss_telemetry_test_" + std::to_string(getpid());
+#endif
+        Channel writer;
+        CHECK(writer.Create(name.c_str()));
+        CHECK(writer.IsOwner());
+        Channel reader;
+        CHECK(reader.Open(name.c_str()));
+        if (!writer.Block() || !reader.Block()) return;
+        Payload p;
+        Fill(p, 7);
+        Publish(*writer.Block(), p);
+        Payload out{};
+        CHECK(Read(*reader.Block(), out));
+        CHECK(out.frame == 7 && Consistent(out));
+    }
+}
+
+int main() {
+    TestRoundTrip();
+    TestTornReads();
+    TestChannel();
+    return DLSSTest::Result();
+}
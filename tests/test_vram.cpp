@@ -0,0 +1,134 @@
+#include "dlss_vram.h"
+#include "test_common.h"
+
+using namespace DLSSVram;
+
+namespace {
+    static_assert(TextureBytes(28, 2016, 2240) == 2016ull * 2240 * 4, "R8G8B8A8");
+    static_assert(TextureBytes(10, 4, 4) == 128, "R16G16B16A16_FLOAT");
+    static_assert(TextureBytes(71, 5, 5) == 4 * 8, "BC1 rounds up to whole blocks");
+    static_assert(TextureBytes(98, 256, 256, 0) == 65536 + 16384 + 4096 + 1024 + 256 + 64 + 16 + 16 + 16, "BC7 full chain");
+    static_assert(TextureBytes(103, 1920, 1080) == 1920ull * 1080 * 3 / 2, "NV12");
+    static_assert(TextureBytes(104, 1920, 1080) == 1920ull * 1080 * 3, "P010");
+    static_assert(TextureBytes(110, 8, 2) == 16 + 2 * 2 * 2, "NV11");
+    static_assert(TextureBytes(66, 9, 1) == 2, "R1_UNORM");
+    static_assert(TextureBytes(107, 3, 1) == 8, "YUY2");
+    static_assert(TextureBytes(132, 4, 4) == 48, "V408");
+    static_assert(TextureBytes(0, 4, 4) == 0, "UNKNOWN");
+    static_assert(TextureBytes(41, 4, 4, 1, 6, 4) == 64 * 24, "array and MSAA");
+    static_assert(FullMipCount(1, 1) == 1 && FullMipCount(4096, 1) == 13, "mip chain length");
+
+    // Every DXGI_FORMAT value up to 191 has a size except UNKNOWN, the gaps
+    // in the enum and the sampler-feedback formats (189, 190)
+    void TestFormatTable() {
+        for (uint32_t f = 0; f < 256; ++f) {
+            const bool gap = f == 0 || (f >= 116 && f <= 129) || (f >= 133 && f <= 190) || f > 191;
+            const FormatLayout l = GetFormatLayout(f);
+            if (gap) {
+                CHECK(l.kind == FormatLayout::Kind::Unknown);
+                CHECK(SurfaceBytes(f, 16, 16) == 0);
+            } else {
+                if (l.kind == FormatLayout::Kind::Unknown) std::fprintf(stderr, "format %u has no size\n", f);
+                CHECK(l.kind != FormatLayout::Kind::Unknown);
+                CHECK(SurfaceBytes(f, 16, 16) > 0);
+            }
+        }
+        CHECK(SurfaceBytes(28, 0, 16) == 0);
+    }
+
+    int g_trimCalls = 0;
+    Tracker* g_tracker = nullptr;
+    const void* g_trimResource = nullptr;
+    uint64_t g_trimFrame = 0;
+
+    void Trim(void*, uint64_t frame) {
+        ++g_trimCalls;
+        g_trimFrame = frame;
+        g_tracker->Untrack(g_trimResource);
+    }
+
+    const void* Key(uintptr_t k) { return reinterpret_cast<const void*>(k); }
+
+    void TestTracking() {
+        Tracker t;
+        t.Track(Key(1), Pool::EyeOutput, 100);
+        t.Track(Key(2), Pool::Sharpen, 50);
+        // The same key again replaces the old entry
+        t.Track(Key(2), Pool::Sharpen, 70);
+        Snapshot s = t.Take();
+        CHECK(s.currentBytes == 170 && s.peakBytes == 170);
+        CHECK(s.pools[static_cast<size_t>(Pool::Sharpen)].liveCount == 1);
+        CHECK(s.pools[static_cast<size_t>(Pool::Sharpen)].currentBytes == 70);
+        CHECK(s.pools[static_cast<size_t>(Pool::Sharpen)].allocations == 2);
+
+        // Null keys, bad pools and unknown keys are ignored
+        t.Track(nullptr, Pool::EyeOutput, 5);
+        t.Track(Key(3), Pool::Count, 5);
+        t.Untrack(Key(4));
+        t.Untrack(nullptr);
+        CHECK(t.CurrentBytes() == 170);
+
+        t.Untrack(Key(1));
+        s = t.Take();
+        CHECK(s.currentBytes == 70 && s.peakBytes == 170);
+        CHECK(s.pools[static_cast<size_t>(Pool::EyeOutput)].liveCount == 0);
+        CHECK(s.pools[static_cast<size_t>(Pool::EyeOutput)].peakBytes == 100);
+        t.ResetPeaks();
+        s = t.Take();
+        CHECK(s.peakBytes == 70 && s.pools[static_cast<size_t>(Pool::EyeOutput)].peakBytes == 0);
+    }
+
+    void TestBudget() {
+        Tracker t;
+        g_tracker = &t;
+        g_trimCalls = 0;
+        g_trimResource = Key(1);
+        t.Track(Key(1), Pool::EyeOutput, 100);
+        t.Track(Key(2), Pool::Sharpen, 70);
+        CHECK(t.AddTrimmer(Trim, nullptr));
+        CHECK(t.AddTrimmer(Trim, nullptr));  // already registered
+        // No budget: never trims
+        for (int i = 0; i < 5; ++i) CHECK(!t.EndFrame().ran);
+        CHECK(g_trimCalls == 0);
+
+        t.SetBudgetBytes(100);
+        TrimResult r = t.EndFrame();
+        CHECK(r.ran && r.beforeBytes == 170 && r.afterBytes == 70 && r.budgetBytes == 100);
+        CHECK(g_trimCalls == 1 && g_trimFrame == t.Frame());
+
+        // Over budget again: not before kTrimIntervalFrames have passed
+        t.Track(Key(1), Pool::EyeOutput, 100);
+        uint64_t waited = 1;
+        while (!t.EndFrame().ran) ++waited;
+        CHECK(waited == kTrimIntervalFrames);
+        CHECK(g_trimCalls == 2);
+
+        // Under budget: nothing runs
+        for (uint64_t i = 0; i < kTrimIntervalFrames * 2; ++i) CHECK(!t.EndFrame().ran);
+        const Snapshot s = t.Take();
+        CHECK(s.trims == 2 && s.trimmedBytes == 200 && s.budgetBytes == 100);
+
+        t.RemoveTrimmer(Trim, nullptr);
+        t.Track(Key(1), Pool::EyeOutput, 100);
+        for (uint64_t i = 0; i < kTrimIntervalFrames; ++i) t.EndFrame();
+        CHECK(g_trimCalls == 2);
+        CHECK(t.CurrentBytes() == 170);
+    }
+
+    void TestTrimmerLimit() {
+        Tracker t;
+        auto noop = [](void*, uint64_t) {};
+        int users[Tracker::kMaxTrimmers + 1];
+        for (int i = 0; i < Tracker::kMaxTrimmers; ++i) CHECK(t.AddTrimmer(noop, &users[i]));
+        CHECK(!t.AddTrimmer(noop, &users[Tracker::kMaxTrimmers]));
+        CHECK(!t.AddTrimmer(nullptr, nullptr));
+    }
+}
+
+int main() {
+    TestFormatTable();
+    TestTracking();
+    TestBudget();
+    TestTrimmerLimit();
+    return DLSSTest::Result();
+}
@@ -0,0 +1,150 @@
+// Lists and extracts the plugin's frame captures (.dlsscap).
+//
+//   dlss_capture_reader <file>
+//   dlss_capture_reader <file> --dump <frame> <eye> <color|depth|motion|output> <out>
+//
+// Listing prints one line per eye and frame with its metadata and surfaces.
+// --dump writes one surface: a PPM for 8-bit RGBA/BGRA formats, otherwise the
+// raw rows (width x height, rowBytes each, in the DXGI format listed).
+
+#include "dlss_capture.h"
+#include "dlss_history.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    // DXGI_FORMAT values, without the Windows headers
+    enum : uint32_t {
+        kR8G8B8A8Typeless = 27, kR8G8B8A8Unorm = 28, kR8G8B8A8UnormSrgb = 29,
+        kB8G8R8A8Unorm = 87, kB8G8R8X8Unorm = 88, kB8G8R8A8Typeless = 90, kB8G8R8A8UnormSrgb = 91,
+        kB8G8R8X8Typeless = 92, kB8G8R8X8UnormSrgb = 93
+    };
+
+    const char* QualityName(uint32_t quality) {
+        static const char* const names[] = { "Performance", "Balanced", "Quality", "UltraPerformance", "UltraQuality", "DLAA" };
+        return quality < sizeof(names) / sizeof(names[0]) ? names[quality] : "?";
+    }
+
+    void PrintReasons(uint32_t reasons) {
+        const char* sep = "";
+        for (uint32_t i = 0; i < DLSSHistory::kReasonCount; ++i) {
+            if (!(reasons & (1u << i))) continue;
+            std::printf("%s%s", sep, DLSSHistory::ReasonName(i));
+            sep = ",";
+        }
+    }
+
+    int SurfaceFromName(const char* name) {
+        for (uint32_t i = 0; i < DLSSCapture::kMaxSurfaces; ++i) {
+            if (std::strcmp(name, DLSSCapture::SurfaceName(i)) == 0) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    void Print(const DLSSCapture::Frame& f) {
+        const DLSSCapture::FrameInfo& i = f.info;
+        std::printf("frame %llu  %s eye  %.1f ms  %s  render %ux%u -> %ux%u  jitter %+.3f %+.3f  cpu %.3f gpu %.3f submit %.3f ms",
+            (unsigned long long)i.frame, i.eye == 0 ? "left " : "right", i.timeMs, QualityName(i.quality),
+            i.renderWidth, i.renderHeight, i.outputWidth, i.outputHeight, i.jitterX, i.jitterY,
+            i.processMs, i.gpuMs, i.submitMs);
+        if (i.reset) {
+            std::printf("  reset (");
+            PrintReasons(i.resetReasons);
+            std::printf(")");
+        }
+        if (i.droppedBefore) std::printf("  [%u dropped before]", i.droppedBefore);
+        std::printf("\n");
+        for (uint32_t s = 0; s < i.surfaceCount; ++s) {
+            const DLSSCapture::SurfaceInfo& si = f.surfaces[s];
+            std::printf("    %-6s %ux%u  format %u  %u bytes/row\n", DLSSCapture::SurfaceName(si.surface), si.width, si.height, si.format, si.rowBytes);
+        }
+    }
+
+    bool WriteSurface(const DLSSCapture::SurfaceInfo& s, const std::vector<uint8_t>& pixels, const char* path) {
+        std::FILE* out = std::fopen(path, "wb");
+        if (!out) return false;
+        bool ok = true;
+        const bool rgba = s.format == kR8G8B8A8Typeless || s.format == kR8G8B8A8Unorm || s.format == kR8G8B8A8UnormSrgb;
+        const bool bgra = s.format == kB8G8R8A8Unorm || s.format == kB8G8R8X8Unorm || s.format == kB8G8R8A8Typeless ||
+            s.format == kB8G8R8A8UnormSrgb || s.format == kB8G8R8X8Typeless || s.format == kB8G8R8X8UnormSrgb;
+        if ((rgba || bgra) && s.rowBytes >= s.width * 4) {
+            std::fprintf(out, "P6\n%u %u\n255\n", s.width, s.height);
+            std::vector<uint8_t> row(static_cast<size_t>(s.width) * 3);
+            for (uint32_t y = 0; y < s.height && ok; ++y) {
+                const uint8_t* src = pixels.data() + static_cast<size_t>(y) * s.rowBytes;
+                for (uint32_t x = 0; x < s.width; ++x) {
+                    row[x * 3 + 0] = src[x * 4 + (bgra ? 2 : 0)];
+                    row[x * 3 + 1] = src[x * 4 + 1];
+                    row[x * 3 + 2] = src[x * 4 + (bgra ? 0 : 2)];
+                }
+                ok = std::fwrite(row.data(), row.size(), 1, out) == 1;
+            }
+        } else {
+            ok = pixels.empty() || std::fwrite(pixels.data(), pixels.size(), 1, out) == 1;
+        }
+        return std::fclose(out) == 0 && ok;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    bool dump = false;
+    unsigned long long dumpFrame = 0;
+    uint32_t dumpEye = 0;
+    int dumpSurface = -1;
+    const char* dumpPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--dump") == 0 && i + 4 < argc) {
+            dump = true;
+            dumpFrame = std::strtoull(argv[++i], nullptr, 10);
+            dumpEye = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            dumpSurface = SurfaceFromName(argv[++i]);
+            dumpPath = argv[++i];
+        } else if (!path && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            path = nullptr;
+            break;
+        }
+    }
+    if (!path || (dump && (dumpSurface < 0 || dumpEye > 1))) {
+        std::fprintf(stderr, "usage: %s <file> [--dump <frame> <eye> <color|depth|motion|output> <out>]\n", argv[0]);
+        return 2;
+    }
+
+    DLSSCapture::Reader reader;
+    if (!reader.Open(path)) {
+        std::fprintf(stderr, "%s: not a version %u capture\n", path, DLSSCapture::kVersion);
+        return 1;
+    }
+
+    DLSSCapture::Frame frame;
+    uint64_t frames = 0, dropped = 0;
+    while (reader.Next(frame, dump)) {
+        if (!dump) {
+            Print(frame);
+            ++frames;
+            dropped += frame.info.droppedBefore;
+            continue;
+        }
+        if (frame.info.frame != dumpFrame || frame.info.eye != dumpEye) continue;
+        for (uint32_t s = 0; s < frame.info.surfaceCount; ++s) {
+            if (frame.surfaces[s].surface != static_cast<uint32_t>(dumpSurface)) continue;
+            if (!WriteSurface(frame.surfaces[s], frame.pixels[s], dumpPath)) {
+                std::fprintf(stderr, "cannot write %s\n", dumpPath);
+                return 1;
+            }
+            return 0;
+        }
+        std::fprintf(stderr, "frame %llu has no %s surface\n", dumpFrame, DLSSCapture::SurfaceName(static_cast<uint32_t>(dumpSurface)));
+        return 1;
+    }
+    if (dump) {
+        std::fprintf(stderr, "frame %llu eye %u not found\n", dumpFrame, dumpEye);
+        return 1;
+    }
+    std::printf("%llu eye frames, %llu dropped\n", (unsigned long long)frames, (unsigned long long)dropped);
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Prints the plugin's shared-memory telemetry at 10 Hz.
+//
+//   dlss_telemetry_reader [--once] [--name <channel>]
+//
+// Waits for the game if the channel does not exist yet.
+
+#include "dlss_history.h"
+#include "dlss_telemetry.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace {
+    const char* StateName(uint32_t state) {
+        switch (static_cast<DLSSTelemetry::State>(state)) {
+            case DLSSTelemetry::State::Cold: return "cold";
+            case DLSSTelemetry::State::HaveCompositor: return "compositor";
+            case DLSSTelemetry::State::HaveSwapChain: return "swapchain";
+            case DLSSTelemetry::State::HaveDlss: return "dlss";
+            case DLSSTelemetry::State::Ready: return "ready";
+            default: return "?";
+        }
+    }
+
+    const char* BackendName(uint32_t backend) {
+        switch (static_cast<DLSSTelemetry::Backend>(backend)) {
+            case DLSSTelemetry::Backend::NGX: return "NGX";
+            case DLSSTelemetry::Backend::Streamline: return "Streamline";
+            default: return "none";
+        }
+    }
+
+    const char* QualityName(uint32_t quality) {
+        static const char* const names[] = { "Performance", "Balanced", "Quality", "UltraPerformance", "UltraQuality", "DLAA" };
+        return quality < sizeof(names) / sizeof(names[0]) ? names[quality] : "?";
+    }
+
+    void PrintReasons(uint32_t reasons) {
+        if (reasons == 0) {
+            std::printf("none");
+            return;
+        }
+        const char* sep = "";
+        for (uint32_t i = 0; i < DLSSHistory::kReasonCount; ++i) {
+            if (!(reasons & (1u << i))) continue;
+            std::printf("%s%s", sep, DLSSHistory::ReasonName(i));
+            sep = ", ";
+        }
+    }
+
+    void Print(const DLSSTelemetry::Payload& p) {
+        std::printf("frame %llu  state %s  backend %s  %s  %s\n",
+            (unsigned long long)p.frame, StateName(p.state), BackendName(p.backend),
+            QualityName(p.quality), p.enabled ? "enabled" : "disabled");
+        for (int i = 0; i < 2; ++i) {
+            const DLSSTelemetry::EyePayload& e = p.eyes[i];
+            std::printf("  %s eye: %s  render %ux%u -> output %ux%u  evals %llu  resets %llu  cpu %.3f ms  gpu %.3f ms  submit %.3f ms  copies %u KB\n",
+                i == 0 ? "left " : "right", QualityName(e.quality), e.renderWidth, e.renderHeight, e.outputWidth, e.outputHeight,
+                (unsigned long long)e.evaluations, (unsigned long long)e.resets, e.processMs, e.gpuMs, e.submitMs, e.copiedKB);
+            std::printf("         last reset: ");
+            PrintReasons(e.resetReasons);
+            std::printf("\n");
+        }
+        std::printf("  frame p50 %.2f ms  p99 %.2f ms  over budget %.2f%%  hitches %llu  downscale gpu %.3f ms\n",
+            p.presentP50Ms, p.presentP99Ms, p.overBudgetPercent, (unsigned long long)p.hitches, p.downscaleGpuMs);
+        std::printf("  init load %.1f  resolve %.1f  shaders %.1f  device %.1f ms  textures %llu  features %llu\n",
+            p.initLoadMs, p.initResolveMs, p.initShadersMs, p.initDeviceMs,
+            (unsigned long long)p.textureCreates, (unsigned long long)p.featureCreates);
+        std::printf("  vram %.1f MB  peak %.1f MB  budget %.0f MB\n",
+            p.vramBytes / 1048576.0, p.vramPeakBytes / 1048576.0, p.vramBudgetBytes / 1048576.0);
+        std::fflush(stdout);
+    }
+}
+
+int main(int argc, char** argv) {
+    bool once = false;
+    const char* name = DLSSTelemetry::kChannelName;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--once") == 0) {
+            once = true;
+        } else if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--once] [--name <channel>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    DLSSTelemetry::Channel channel;
+    bool waiting = false;
+    uint64_t lastFrame = ~0ull;
+    for (;;) {
+        if (!channel.Block() && !channel.Open(name)) {
+            if (once) {
+                std::fprintf(stderr, "telemetry channel %s not found\n", name);
+                return 1;
+            }
+            if (!waiting) {
+                std::fprintf(stderr, "waiting for %s ...\n", name);
+                waiting = true;
+            }
+        } else if (channel.Block()) {
+            waiting = false;
+            DLSSTelemetry::Payload payload{};
+            // A block without the magic is still being initialised by the writer
+            const DLSSTelemetry::SharedBlock& block = *channel.Block();
+            if (block.magic.load(std::memory_order_acquire) == DLSSTelemetry::kMagic && !DLSSTelemetry::IsCompatible(block)) {
+                std::fprintf(stderr, "telemetry block version %u, reader expects %u\n",
+                    block.version, DLSSTelemetry::kVersion);
+                return 1;
+            }
+            if (DLSSTelemetry::Read(block, payload)) {
+                if (payload.frame != lastFrame) {
+                    Print(payload);
+                    lastFrame = payload.frame;
+                }
+                if (once) return 0;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}